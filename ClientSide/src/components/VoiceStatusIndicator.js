@@ -3,7 +3,21 @@ import {View, Text, StyleSheet} from 'react-native';
 import {useVoice} from '../context/VoiceContext';
 
 const VoiceStatusIndicator = () => {
-  const {activeVoiceChannel, voiceStatus, isMicrophoneEnabled} = useVoice();
+  const {
+    activeVoiceChannel,
+    voiceStatus,
+    isMicrophoneEnabled,
+    speakerLevels,
+    monitoredChannels,
+  } = useVoice();
+
+  // Levels arrive as native deltas (see onVolumeLevels); the main channel is keyed ''
+  const mainLevels = speakerLevels?.[''] || {};
+  const micLevel = mainLevels[0] || 0;
+  const talkers = Object.keys(mainLevels).filter(uid => uid !== '0').length;
+  const busyRadios = (monitoredChannels || []).filter(
+    id => Object.keys(speakerLevels?.[`radio_channel_${id}`] || {}).some(uid => uid !== '0'),
+  );
 
   if (!activeVoiceChannel) {
     return (
@@ -21,6 +35,13 @@ const VoiceStatusIndicator = () => {
       <Text style={styles.micText}>
         Mic: {isMicrophoneEnabled ? 'ON' : 'OFF'}
       </Text>
+      <View style={styles.levelTrack}>
+        <View style={[styles.levelBar, {width: `${Math.round((micLevel / 255) * 100)}%`}]} />
+      </View>
+      {talkers > 0 && <Text style={styles.micText}>Talking: {talkers}</Text>}
+      {busyRadios.length > 0 && (
+        <Text style={styles.micText}>Radio activity: {busyRadios.join(', ')}</Text>
+      )}
     </View>
   );
 };
@@ -45,6 +66,15 @@ const styles = StyleSheet.create({
     fontSize: 10,
     marginTop: 2,
   },
+  levelTrack: {
+    height: 3,
+    marginTop: 3,
+    backgroundColor: 'rgba(255, 255, 255, 0.2)',
+  },
+  levelBar: {
+    height: 3,
+    backgroundColor: '#4caf50',
+  },
 });
 
 export default VoiceStatusIndicator;
@@ -1,5 +1,6 @@
 import React, {createContext, useContext, useState, useEffect} from 'react';
 import {NativeModules, Alert, DeviceEventEmitter} from 'react-native';
+import {applyAudioState} from '../utils/audioState';
 
 const {AgoraModule} = NativeModules;
 
@@ -10,13 +11,26 @@ if (!AgoraModule.removeListeners) {
 
 const VoiceContext = createContext();
 
+// Push-to-talk floor: a higher priority preempts whoever talks on the radio, equal ones get busy
+export const floorPriorityForRole = role => ({Admin: 2, Operator: 1}[role] ?? 0);
+
+const radioAgoraName = channelId => `radio_channel_${channelId}`;
+
 export const VoiceProvider = ({children}) => {
   // Voice Communication State Management
   const [activeVoiceChannel, setActiveVoiceChannel] = useState(null); // Which channel is currently connected to voice
-  const [voiceStatus, setVoiceStatus] = useState('disconnected'); // 'disconnected', 'connecting', 'connected'
+  const [voiceStatus, setVoiceStatus] = useState('disconnected'); // 'disconnected', 'connecting', 'connected', 'reconnecting'
   const [isMicrophoneEnabled, setIsMicrophoneEnabled] = useState(false); // Is microphone active
   const [isAgoraInitialized, setIsAgoraInitialized] = useState(false); // Is Agora engine ready
  const [selectedChannel, setSelectedChannel] = useState(null);
+  const [monitoredChannels, setMonitoredChannels] = useState([]); // Radios connected in radio-console mode
+  const [talkChannel, setTalkChannel] = useState(null); // Monitored radio that currently has PTT
+  const [speakerLevels, setSpeakerLevels] = useState({}); // { [channel]: { [uid]: 0-255 } }, uid 0 = local mic
+  const [activeSpeakers, setActiveSpeakers] = useState({}); // { [channel]: uid }
+  const [isVoxEnabled, setIsVoxEnabled] = useState(false); // Mic only sent while the VOX gate hears speech
+  const [isTransmitting, setIsTransmitting] = useState(true); // VOX gate state (always true when VOX is off)
+  const [connectionStates, setConnectionStates] = useState({}); // { [agora channel]: 'connected' | 'reconnecting' | 'failed' | ... }
+  const [floorStates, setFloorStates] = useState({}); // { [agora channel]: { state: 'idle' | 'requesting' | 'granted' | 'taken', holder, reason } }
 
   // Race condition prevention
   const [pendingMuteTimeout, setPendingMuteTimeout] = useState(null);
@@ -26,43 +40,156 @@ export const VoiceProvider = ({children}) => {
   useEffect(() => {
     console.log('🎧 Setting up Agora event listeners...');
 
-    // Listen for when a user joins the channel
-    const onUserJoinedListener = DeviceEventEmitter.addListener('onUserJoined', (data) => {
-      console.log('🔥 USER JOINED VOICE CHANNEL:', data);
-      console.log('🎉 You should now be able to hear each other!');
-      console.log('🎤 Both devices can now communicate!');
-      console.log('📊 User data received:', JSON.stringify(data, null, 2));
-      
-      // Show user-friendly notification
+    // Native side batches SDK callbacks: one array per flush, join/leave pairs already cancelled
+    const onAgoraEventsListener = DeviceEventEmitter.addListener('onAgoraEvents', (batch) => {
+      const events = batch?.events || [];
+      if (batch?.dropped || batch?.merged) {
+        console.log(`📦 Agora event batch: ${events.length} events, ${batch.merged} merged, ${batch.dropped} dropped`);
+      }
+
+      const joined = events.filter(e => e.type === 'userJoined');
+      const left = events.filter(e => e.type === 'userOffline');
+      events
+        .filter(e => e.type === 'error')
+        .forEach(e => console.error('💥 Agora error:', e.code, e.channel || ''));
+
+      if (joined.length === 0 && left.length === 0) {
+        return;
+      }
+
+      console.log('🔥 VOICE CHANNEL MEMBERSHIP CHANGED:', JSON.stringify({joined, left}, null, 2));
+
+      // One notification per batch instead of one popup per user
+      const lines = [];
+      if (joined.length === 1) {
+        lines.push(`A user joined the voice channel (UID: ${joined[0].uid}). You can now communicate!`);
+      } else if (joined.length > 1) {
+        lines.push(`${joined.length} users joined the voice channel.`);
+      }
+      if (left.length === 1) {
+        lines.push(`A user left the voice channel (UID: ${left[0].uid}).`);
+      } else if (left.length > 1) {
+        lines.push(`${left.length} users left the voice channel.`);
+      }
+
       Alert.alert(
-        'User Joined',
-        `A user joined the voice channel (UID: ${data.uid}). You can now communicate!`,
+        joined.length > 0 ? 'User Joined' : 'User Left',
+        lines.join('\n'),
         [{text: 'OK'}]
       );
     });
 
-    // Listen for when a user leaves the channel
-    const onUserOfflineListener = DeviceEventEmitter.addListener('onUserOffline', (data) => {
-      console.log('😢 USER LEFT VOICE CHANNEL:', data);
-      console.log('⚠️ Voice communication ended with this user');
-      console.log('📊 User data received:', JSON.stringify(data, null, 2));
-      
-      // Show user-friendly notification
-      Alert.alert(
-        'User Left',
-        `A user left the voice channel (UID: ${data.uid}).`,
-        [{text: 'OK'}]
-      );
+    // Native side sends only the levels that moved since the last interval
+    const onVolumeLevelsListener = DeviceEventEmitter.addListener('onVolumeLevels', (update) => {
+      const channels = update?.channels || [];
+      const levels = update?.levels || [];
+      const speakers = update?.activeSpeakers || [];
+
+      if (levels.length > 0) {
+        setSpeakerLevels(previous => {
+          const next = {...previous};
+          levels.forEach(([channelIndex, uid, level]) => {
+            const channel = channels[channelIndex] ?? '';
+            const channelLevels = {...(next[channel] || {})};
+            if (level > 0) {
+              channelLevels[uid] = level;
+            } else {
+              delete channelLevels[uid];
+            }
+            next[channel] = channelLevels;
+          });
+          return next;
+        });
+      }
+
+      if (speakers.length > 0) {
+        setActiveSpeakers(previous => {
+          const next = {...previous};
+          speakers.forEach(([channelIndex, uid]) => {
+            next[channels[channelIndex] ?? ''] = uid;
+          });
+          return next;
+        });
+      }
+    });
+
+    // Answer-to-audio time for private calls; warm = channel was prepared while ringing
+    const onCallLatencyListener = DeviceEventEmitter.addListener('onCallLatency', (latency) => {
+      console.log(`⏱️ Call ${latency?.channel} ready ${Math.round(latency?.acceptMs ?? 0)} ms after accept (${latency?.warm ? 'warm' : 'cold'})`);
+    });
+
+    // VOX gate transitions - only sent when the native side actually muted/unmuted the uplink
+    const onTalkStateChangedListener = DeviceEventEmitter.addListener('onTalkStateChanged', (state) => {
+      setIsTransmitting(!!state?.talking);
+    });
+
+    // Link state per channel; native code already rejoins and restores mute/role/volume itself
+    const onConnectionStateChangedListener = DeviceEventEmitter.addListener('onConnectionStateChanged', (change) => {
+      if (!change?.channel) {
+        return;
+      }
+      if (change.state === 'reconnecting') {
+        console.log(`📶 ${change.channel} reconnecting (reason ${change.reason}, attempt ${change.attempt}, next in ${change.retryInMs} ms)`);
+      } else if (change.state === 'failed') {
+        console.error(`❌ ${change.channel} connection failed (reason ${change.reason})`);
+      }
+      setConnectionStates(previous => ({...previous, [change.channel]: change.state}));
+    });
+
+    // PTT floor per radio; native code already unmuted on a grant and muted on losing it
+    const onFloorChangedListener = DeviceEventEmitter.addListener('onFloorChanged', (change) => {
+      if (!change?.channelName) {
+        return;
+      }
+      if (change.state === 'granted') {
+        console.log(`🟢 Floor of ${change.channelName} granted after ${change.waitedMs} ms`);
+      } else if (change.reason === 'busy' || change.reason === 'preempted') {
+        console.log(`🚦 ${change.channelName}: ${change.reason}, user ${change.holder || 'nobody'} talks`);
+      } else if (change.reason === 'noAnswer' || change.reason === 'offline') {
+        console.warn(`⚠️ Floor of ${change.channelName} unavailable (${change.reason})`);
+      }
+      setFloorStates(previous => ({
+        ...previous,
+        [change.channelName]: {state: change.state, holder: change.holder, reason: change.reason},
+      }));
     });
 
     // Cleanup event listeners
     return () => {
       console.log('🧹 Cleaning up Agora event listeners...');
-      onUserJoinedListener?.remove();
-      onUserOfflineListener?.remove();
+      onAgoraEventsListener?.remove();
+      onVolumeLevelsListener?.remove();
+      onTalkStateChangedListener?.remove();
+      onCallLatencyListener?.remove();
+      onConnectionStateChangedListener?.remove();
+      onFloorChangedListener?.remove();
     };
   }, []); // Run once on mount
 
+  // The voice channel's own link drives voiceStatus while joined
+  useEffect(() => {
+    if (!activeVoiceChannel) {
+      return;
+    }
+    const state = connectionStates[`radio_channel_${activeVoiceChannel}`];
+    if (state === 'reconnecting') {
+      setVoiceStatus('reconnecting');
+    } else if (state === 'connected') {
+      setVoiceStatus('connected');
+    } else if (state === 'failed') {
+      setVoiceStatus('disconnected');
+    }
+  }, [connectionStates, activeVoiceChannel]);
+
+  // The microphone is open exactly while we hold the floor of the radio we talk on
+  useEffect(() => {
+    const channelId = talkChannel ?? activeVoiceChannel;
+    const floor = channelId == null ? null : floorStates[radioAgoraName(channelId)];
+    if (floor) {
+      setIsMicrophoneEnabled(floor.state === 'granted');
+    }
+  }, [floorStates, talkChannel, activeVoiceChannel]);
+
   // Initialize Agora engine when provider mounts
   useEffect(() => {
     const setupVoiceEngine = async () => {
@@ -105,7 +232,9 @@ export const VoiceProvider = ({children}) => {
         return false;
       }
 
-      AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
+      await AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
+      // Talk-activity lights: one native delta every 200 ms instead of JS polling
+      await AgoraModule.EnableVolumeIndication(200, 3);
       setIsAgoraInitialized(true);
       return true;
     } catch (error) {
@@ -116,10 +245,12 @@ export const VoiceProvider = ({children}) => {
   };
 
   // Join a voice channel for a specific radio channel
+  // ListenAndTalk asks for the radio's floor; the microphone opens once it is granted
   const joinVoiceChannel = async (
     channelId,
     channelName,
     initialState = 'ListenOnly',
+    floorPriority = 0,
   ) => {
     try {
       if (!isAgoraInitialized) {
@@ -134,13 +265,15 @@ export const VoiceProvider = ({children}) => {
         console.log('🔄 Already connected to channel, updating microphone state...');
         
         if (initialState === 'ListenOnly') {
-          AgoraModule.MuteLocalAudio(true);
+          // Back to audience: microphone closed, not a publisher
+          releaseFloor(channelId);
+          AgoraModule.SetListenOnly(true);
           setIsMicrophoneEnabled(false);
-          console.log('🎤 Microphone muted (ListenOnly mode)');
+          console.log('👂 Listen only (audience)');
         } else if (initialState === 'ListenAndTalk') {
-          AgoraModule.MuteLocalAudio(false);
-          setIsMicrophoneEnabled(true);
-          console.log('🎤 Microphone enabled (ListenAndTalk mode)');
+          AgoraModule.SetListenOnly(false);
+          AgoraModule.RequestFloor(radioAgoraName(channelId), floorPriority);
+          console.log('🎤 Floor requested (ListenAndTalk mode)');
         }
         
         return true;
@@ -151,28 +284,29 @@ export const VoiceProvider = ({children}) => {
       // Leave current channel if connected to another
       if (activeVoiceChannel && activeVoiceChannel !== channelId) {
         console.log('🔄 Leaving current channel before joining new one...');
-        AgoraModule.LeaveChannel();
-        // Add small delay to ensure clean disconnect
-        await new Promise(resolve => setTimeout(resolve, 500));
+        // Resolves once the native worker has actually left the channel
+        await AgoraModule.LeaveChannel();
       }
 
-      const agoraChannelName = `radio_channel_${channelId}`;
+      const agoraChannelName = radioAgoraName(channelId);
       console.log('🎤 Joining Agora channel:', agoraChannelName);
       
-      AgoraModule.JoinChannel(agoraChannelName);
+      // ListenOnly joins as audience; toggleMicrophone(true) keys up to broadcaster in-channel.
+      // Floor control first, so the microphone never opens without the floor.
+      const listenOnly = initialState === 'ListenOnly';
+      AgoraModule.SetFloorControl(agoraChannelName, true);
+      AgoraModule.JoinChannel(agoraChannelName, listenOnly);
 
       setActiveVoiceChannel(channelId);
       setVoiceStatus('connected');
 
       // Set initial microphone state based on the channel state
-      if (initialState === 'ListenOnly') {
-        AgoraModule.MuteLocalAudio(true);
+      if (listenOnly) {
         setIsMicrophoneEnabled(false);
-        console.log('🎤 Microphone muted on join (ListenOnly mode)');
+        console.log('👂 Joined as listener (ListenOnly mode)');
       } else if (initialState === 'ListenAndTalk') {
-        AgoraModule.MuteLocalAudio(false);
-        setIsMicrophoneEnabled(true);
-        console.log('🎤 Microphone enabled on join (ListenAndTalk mode)');
+        AgoraModule.RequestFloor(agoraChannelName, floorPriority);
+        console.log('🎤 Floor requested on join (ListenAndTalk mode)');
       }
 
       console.log('✅ Successfully joined voice channel:', agoraChannelName);
@@ -218,10 +352,110 @@ export const VoiceProvider = ({children}) => {
     }
   };
 
-  // Toggle microphone on/off
-  const toggleMicrophone = async enabled => {
+  // The radio console in one native call: exactly these radios monitored, talkId (or null) keyed.
+  // Native works out the leaves, joins and key change and reports what did not take; the state
+  // here follows the report, so a refused join or key-up leaves things as they were.
+  const applyRadioState = async (channelIds, talkId = null) => {
     try {
-      if (!activeVoiceChannel) {
+      if (!isAgoraInitialized) {
+        const initialized = await initializeAgoraEngine();
+        if (!initialized) {
+          throw new Error('Failed to initialize Agora engine');
+        }
+      }
+
+      // Floor control first, so a new radio's microphone never opens without the floor
+      await Promise.all(
+        channelIds
+          .filter(id => !monitoredChannels.includes(id))
+          .map(id => AgoraModule.SetFloorControl(radioAgoraName(id), true)),
+      );
+      const report = await applyAudioState({
+        radios: channelIds.map(radioAgoraName),
+        talkChannel: talkId === null ? '' : radioAgoraName(talkId),
+      });
+
+      const pending = report.pending ?? [];
+      const missed = (step, id) =>
+        pending.some(
+          action => action.step === step && action.channel === radioAgoraName(id),
+        );
+      const monitored = [
+        ...channelIds.filter(id => !missed('joinRadio', id)),
+        ...monitoredChannels.filter(
+          id => !channelIds.includes(id) && missed('leaveRadio', id),
+        ),
+      ];
+      const keyed =
+        talkId === null ||
+        (monitored.includes(talkId) &&
+          !pending.some(action => action.step === 'talkChannel'));
+      setMonitoredChannels(monitored);
+      setTalkChannel(
+        keyed ? talkId : monitored.includes(talkChannel) ? talkChannel : null,
+      );
+      if (!report.ready || pending.length > 0) {
+        throw new Error(`${pending.length} radio step(s) did not take`);
+      }
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to apply radio state:', error);
+      return false;
+    }
+  };
+
+  const monitorRadioChannel = (channelId, talk = false) =>
+    applyRadioState(
+      monitoredChannels.includes(channelId)
+        ? monitoredChannels
+        : [...monitoredChannels, channelId],
+      talk ? channelId : talkChannel,
+    );
+
+  const stopMonitoringRadioChannel = channelId =>
+    applyRadioState(
+      monitoredChannels.filter(id => id !== channelId),
+      talkChannel === channelId ? null : talkChannel,
+    );
+
+  // Moves PTT between monitored radios without rejoining (null = nobody talks)
+  const setTalkRadioChannel = channelId =>
+    applyRadioState(monitoredChannels, channelId);
+
+  // Key up on a radio: granted (or busy) arrives as onFloorChanged
+  const requestFloor = async (channelId, priority = 0) => {
+    try {
+      await AgoraModule.RequestFloor(radioAgoraName(channelId), priority);
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to request floor:', error);
+      return false;
+    }
+  };
+
+  // Key down: muted at once, then the floor is free for the others
+  const releaseFloor = async channelId => {
+    try {
+      await AgoraModule.ReleaseFloor(radioAgoraName(channelId));
+      // Without floor control the key-up was granted locally and no release event follows
+      setFloorStates(previous => {
+        const floor = previous[radioAgoraName(channelId)];
+        return floor?.state === 'granted'
+          ? {...previous, [radioAgoraName(channelId)]: {...floor, state: 'idle', reason: 'released'}}
+          : previous;
+      });
+      setIsMicrophoneEnabled(false);
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to release floor:', error);
+      return false;
+    }
+  };
+
+  // Toggle microphone on/off: through the floor of the radio we talk on
+  const toggleMicrophone = async (enabled, floorPriority = 0) => {
+    try {
+      if (!activeVoiceChannel && !talkChannel) {
         console.log(
           '⚠️ Cannot toggle microphone - not connected to voice channel',
         );
@@ -230,11 +464,15 @@ export const VoiceProvider = ({children}) => {
 
       console.log(`🎤 ${enabled ? 'Enabling' : 'Disabling'} microphone...`);
 
-      AgoraModule.MuteLocalAudio(!enabled);
-      setIsMicrophoneEnabled(enabled);
+      const channelId = talkChannel ?? activeVoiceChannel;
+      if (enabled) {
+        await requestFloor(channelId, floorPriority);
+      } else {
+        await releaseFloor(channelId);
+      }
 
       console.log(
-        `✅ Microphone ${enabled ? 'enabled (unmuted)' : 'disabled (muted)'}`,
+        `✅ Microphone ${enabled ? 'requested (opens on grant)' : 'disabled (muted)'}`,
       );
       return true;
     } catch (error) {
@@ -243,6 +481,46 @@ export const VoiceProvider = ({children}) => {
     }
   };
 
+  // Voice-activated transmit: keeps ListenAndTalk keyed but silent until someone speaks
+  const setVoxMode = async enabled => {
+    try {
+      await AgoraModule.SetVoxMode(enabled);
+      setIsVoxEnabled(enabled);
+      console.log(`🗣️ VOX ${enabled ? 'enabled' : 'disabled'}`);
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to set VOX mode:', error);
+      return false;
+    }
+  };
+
+  // Instant replay: plays the last `seconds` of a monitored radio locally (uid limits it to one talker)
+  const replayRadioChannel = async (channelId, seconds = 10, uid = null) => {
+    try {
+      const channelName = `radio_channel_${channelId}`;
+      if (uid == null) {
+        await AgoraModule.ReplayLast(channelName, seconds);
+      } else {
+        await AgoraModule.ReplayLastFrom(channelName, seconds, uid);
+      }
+      console.log(`⏪ Replaying last ${seconds}s of ${channelName}`);
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to replay radio channel:', error);
+      return false;
+    }
+  };
+
+  const stopReplay = async () => {
+    try {
+      await AgoraModule.StopReplay();
+      return true;
+    } catch (error) {
+      console.error('❌ Failed to stop replay:', error);
+      return false;
+    }
+  };
+
   // Handle voice connection errors gracefully
   const handleVoiceError = (error, operation) => {
     console.error(`❌ Voice ${operation} failed:`, error);
@@ -323,10 +601,27 @@ export const VoiceProvider = ({children}) => {
         pendingUnmuteTimeout,
         selectedChannel,
         setSelectedChannel,
+        monitoredChannels,
+        talkChannel,
+        speakerLevels,
+        activeSpeakers,
+        isVoxEnabled,
+        isTransmitting,
+        connectionStates,
+        floorStates,
         // Actions
         joinVoiceChannel,
         leaveVoiceChannel,
+        applyRadioState,
+        monitorRadioChannel,
+        stopMonitoringRadioChannel,
+        setTalkRadioChannel,
         toggleMicrophone,
+        requestFloor,
+        releaseFloor,
+        setVoxMode,
+        replayRadioChannel,
+        stopReplay,
         clearPendingAudioTimeouts,
         handleVoiceError,
         cleanupVoiceConnection,
@@ -1,21 +1,92 @@
 import {useState, useEffect, useRef, useCallback} from 'react';
+import {NativeModules} from 'react-native';
 import {privateCallApi} from '../utils/apiService';
 import {useAuth} from '../context/AuthContext';
+import {useVoice} from '../context/VoiceContext';
+import {CALL_LOBBY, FALLBACK_POLL_MS, subscribeCallSignals} from '../utils/callSignals';
+
+const {AgoraModule} = NativeModules;
 
 const useIncomingCallListener = (navigation) => {
   console.log('🎣 useIncomingCallListener CALLED'); // Track every call
   
   const {user} = useAuth();
+  const {isAgoraInitialized} = useVoice();
   const [incomingCall, setIncomingCall] = useState(null);
   const [isListening, setIsListening] = useState(false);
   const intervalRef = useRef(null);
   const incomingCallRef = useRef(null); // ✅ FIX: Use ref to avoid infinite loop
+  const isListeningRef = useRef(false);
 
   // Update ref whenever incomingCall changes
   useEffect(() => {
     incomingCallRef.current = incomingCall;
   }, [incomingCall]);
 
+  useEffect(() => {
+    isListeningRef.current = isListening;
+  }, [isListening]);
+
+  // Show the incoming call screen once per invitation, whether pushed or polled
+  const showIncomingCall = useCallback((call) => {
+    const callId = call.Id || call.id; // ✅ FIX: Handle both Id and id
+    const currentCallId = incomingCallRef.current?.Id || incomingCallRef.current?.id;
+
+    if (incomingCallRef.current && String(callId) === String(currentCallId)) {
+      console.log('📞 Same call as before, not navigating');
+      console.log('📞 Current ID:', currentCallId, 'New ID:', callId);
+      return;
+    }
+
+    console.log('🆕 New incoming call detected!');
+    console.log('🆕 Previous call ID:', currentCallId);
+    console.log('🆕 New call ID:', callId);
+
+    incomingCallRef.current = call;
+    setIncomingCall(call);
+
+    // Navigate and stop listening
+    console.log('✅ Navigating to IncomingCall');
+    navigation.navigate('IncomingCall', {
+      callInvitation: call,
+    });
+
+    // Stop current polling
+    isListeningRef.current = false;
+    setIsListening(false);
+    if (intervalRef.current) {
+      clearInterval(intervalRef.current);
+      intervalRef.current = null;
+    }
+  }, [navigation]);
+
+  // Stay in the signaling lobby while signed in: invitations are pushed to us from there
+  useEffect(() => {
+    if (!user?.id || !isAgoraInitialized || !AgoraModule?.StartSignaling) {
+      return undefined;
+    }
+    AgoraModule.StartSignaling(CALL_LOBBY, String(user.id)).catch(error =>
+      console.warn('⚠️ Could not start call signaling:', error),
+    );
+    return () => {
+      AgoraModule.StopSignaling().catch(() => {});
+    };
+  }, [user?.id, isAgoraInitialized]);
+
+  // Pushed invitations; ignored while paused on a call screen, like the polled ones
+  useEffect(() => {
+    return subscribeCallSignals((signal) => {
+      if (signal.type !== 'invite' || !isListeningRef.current) {
+        return;
+      }
+      showIncomingCall({
+        Id: signal.invitationId,
+        CallerName: signal.callerName,
+        CallerId: Number(signal.from) || signal.from,
+      });
+    });
+  }, [showIncomingCall]);
+
   // Check for incoming calls - STABLE function
   const checkForIncomingCalls = useCallback(async () => {
     if (!user?.id) {
@@ -34,34 +105,7 @@ const useIncomingCallListener = (navigation) => {
         const latestCall = incomingCalls[0];
         console.log('📞 Found incoming call:', JSON.stringify(latestCall, null, 2));
         console.log('🔍 Current incomingCallRef:', incomingCallRef.current);
-        
-        // Check if this is a new call using ref
-        const callId = latestCall.Id || latestCall.id; // ✅ FIX: Handle both Id and id
-        const currentCallId = incomingCallRef.current?.Id || incomingCallRef.current?.id;
-        
-        if (!incomingCallRef.current || callId !== currentCallId) {
-          console.log('🆕 New incoming call detected!');
-          console.log('🆕 Previous call ID:', currentCallId);
-          console.log('🆕 New call ID:', callId);
-          
-          setIncomingCall(latestCall);
-          
-          // Navigate and stop listening
-          console.log('✅ Navigating to IncomingCall');
-          navigation.navigate('IncomingCall', {
-            callInvitation: latestCall,
-          });
-          
-          // Stop current polling
-          setIsListening(false);
-          if (intervalRef.current) {
-            clearInterval(intervalRef.current);
-            intervalRef.current = null;
-          }
-        } else {
-          console.log('📞 Same call as before, not navigating');
-          console.log('📞 Current ID:', currentCallId, 'New ID:', callId);
-        }
+        showIncomingCall(latestCall);
       } else {
         console.log('📭 No incoming calls found - Response:', JSON.stringify(response, null, 2));
         console.log('🔍 Checked both IncomingCalls and incomingCalls properties');
@@ -74,7 +118,7 @@ const useIncomingCallListener = (navigation) => {
       console.error('❌ Error checking for incoming calls:', error);
       console.error('❌ Error details:', JSON.stringify(error, null, 2));
     }
-  }, [user?.id, navigation]); // ✅ FIX: Removed incomingCall dependency
+  }, [user?.id, showIncomingCall]); // ✅ FIX: Removed incomingCall dependency
 
   // Start listening - STABLE function
   const startListening = useCallback(() => {
@@ -90,18 +134,19 @@ const useIncomingCallListener = (navigation) => {
     }
     
     console.log('🔔 Starting to listen for incoming calls for user:', user.id);
+    isListeningRef.current = true;
     setIsListening(true);
     
     // Check immediately
     console.log('🔔 Checking immediately...');
     checkForIncomingCalls();
     
-    // Then check every 3 seconds
-    console.log('🔔 Setting up 3-second interval...');
+    // Invitations are pushed over the lobby; the slow poll only catches one that was lost
+    console.log('🔔 Setting up fallback poll interval...');
     intervalRef.current = setInterval(() => {
       console.log('⏰ Interval tick - checking for calls...');
       checkForIncomingCalls();
-    }, 3000);
+    }, FALLBACK_POLL_MS);
     
     console.log('🔔 Interval set with ID:', intervalRef.current);
   }, [user?.id, checkForIncomingCalls]);
@@ -109,6 +154,7 @@ const useIncomingCallListener = (navigation) => {
   // Stop listening - STABLE function
   const stopListening = useCallback(() => {
     console.log('🔕 Stopping incoming call listener...');
+    isListeningRef.current = false;
     setIsListening(false);
     
     if (intervalRef.current) {
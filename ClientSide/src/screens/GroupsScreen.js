@@ -15,6 +15,7 @@ import {groupUsersApi, privateCallApi} from '../utils/apiService';
 import {useSettings} from '../context/SettingsContext';
 import {useDebouncedDimensions} from '../utils/useDebouncedDimensions';
 import {useVoice} from '../context/VoiceContext';
+import {sendCallSignal} from '../utils/callSignals';
 // import useIncomingCallListener from '../hooks/useIncomingCallListener'; // MOVED TO GLOBAL
 
 const GroupsScreen = ({navigation}) => {
@@ -151,6 +152,14 @@ const GroupsScreen = ({navigation}) => {
       if (response.success) {
         // ← Fixed: lowercase 'success'
         console.log('✅ Invitation sent successfully:', response);
+        // Ring them now instead of at their next poll
+        sendCallSignal(
+          'invite',
+          otherUser.id,
+          response.invitationId,
+          response.channelName,
+          user.username,
+        );
         // Navigate to waiting screen with invitation details
         navigation.navigate('WaitingForCall', {
           otherUser,
@@ -16,6 +16,8 @@ import {useSettings} from '../context/SettingsContext';
 import {privateCallApi} from '../utils/apiService';
 import {useDebouncedDimensions} from '../utils/useDebouncedDimensions';
 import {useVoice} from '../context/VoiceContext';
+import {FALLBACK_POLL_MS, sendCallSignal, subscribeCallSignals} from '../utils/callSignals';
+import {TONES, startRinging, stopTone} from '../utils/tones';
 
 const {AgoraModule} = NativeModules; // 🎯 NEW: Import AgoraModule
 
@@ -85,6 +87,9 @@ const IncomingCallScreen = ({route, navigation}) => {
     return () => pulse.stop();
   }, []);
 
+  // 🔔 Ring from native memory while the screen is up; stops on accept, decline or timeout
+  useEffect(() => startRinging(TONES.RING), []);
+
   // Countdown timer
   useEffect(() => {
     console.log('⏱️ Starting 60-second countdown timer');
@@ -119,6 +124,32 @@ const IncomingCallScreen = ({route, navigation}) => {
     };
   }, []);
 
+  // A pushed cancel: confirm it with the server right away instead of at the next poll
+  useEffect(() => {
+    if (!callId) {
+      return undefined;
+    }
+    return subscribeCallSignals((signal) => {
+      if (signal.type === 'cancel') {
+        checkCallStatus();
+      }
+    }, callId);
+  }, [callId]);
+
+  // Warm start: join the call channel silently while ringing so accepting is instant.
+  // Released on unmount unless AcceptCall already took it over (then it's a no-op).
+  useEffect(() => {
+    if (!callId || !AgoraModule?.PrepareChannel) {
+      return undefined;
+    }
+    AgoraModule.PrepareChannel(callId).catch(error =>
+      console.warn('⚠️ Could not prepare call channel:', error),
+    );
+    return () => {
+      AgoraModule.ReleasePreparedChannel(callId).catch(() => {});
+    };
+  }, [callId]);
+
   // Start polling for call status
   const startPollingForStatus = () => {
     console.log('🔄 Starting polling for call status...');
@@ -135,9 +166,10 @@ const IncomingCallScreen = ({route, navigation}) => {
     checkCallStatus();
 
     // Store interval reference so we can clear it later
+    // Only a fallback: a cancel is normally pushed (see subscribeCallSignals above)
     pollIntervalRef.current = setInterval(() => {
       checkCallStatus();
-    }, 3000); // Poll every 3 seconds
+    }, FALLBACK_POLL_MS);
 
     console.log(
       '✅ Call status polling started with interval ID:',
@@ -275,6 +307,7 @@ const IncomingCallScreen = ({route, navigation}) => {
     } catch (error) {
       console.error('❌ Error auto-rejecting call:', error);
     }
+    sendCallSignal('reject', callerId, callId, callId, user.username);
 
     Alert.alert('Call Missed', 'The call invitation has expired.', [
       {
@@ -314,6 +347,8 @@ const IncomingCallScreen = ({route, navigation}) => {
 
       if (response.success) {
         console.log('✅ Call accepted successfully:', response);
+        // The caller is waiting on this: their screen confirms with the server and joins
+        sendCallSignal('accept', callerId, callId, callId, user.username);
 
         // 🎯 FIXED: Create proper channel name without duplication
         const agoraChannelName = callId;
@@ -328,8 +363,9 @@ const IncomingCallScreen = ({route, navigation}) => {
           // Don't re-initialize Agora - it's already initialized by VoiceContext
           // AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
 
-          // 🎯 NEW: Connect immediately - this user creates the channel
-          AgoraModule.JoinChannel(agoraChannelName);
+          // 🎯 NEW: Connect immediately - a publish switch on the channel prepared while ringing
+          stopTone(TONES.RING).catch(() => {});
+          AgoraModule.AcceptCall(agoraChannelName);
 
           console.log(
             '✅ Successfully connected to Agora channel:',
@@ -425,6 +461,7 @@ const IncomingCallScreen = ({route, navigation}) => {
 
     try {
       const response = await privateCallApi.rejectInvitation(callId, user.id);
+      sendCallSignal('reject', callerId, callId, callId, user.username);
 
       if (response.success) {
         console.log('✅ Call rejected successfully');
@@ -13,7 +13,6 @@ import {
   TextInput,
   Button,
   DeviceEventEmitter,
-  NativeModules,
 } from 'react-native';
 import RadioChannel from '../components/RadioChannel';
 import AppLayout from '../components/AppLayout';
@@ -21,9 +20,7 @@ import ChannelParticipantsModal from '../components/ChannelParticipantsModal';
 import {useAuth} from '../context/AuthContext';
 import {radioChannelsApi} from '../utils/apiService';
 import {useSettings} from '../context/SettingsContext';
-import {useVoice} from '../context/VoiceContext';
-
-const {AgoraModule} = NativeModules;
+import {useVoice, floorPriorityForRole} from '../context/VoiceContext';
 
 const MainScreen = ({navigation}) => {
   console.log('MainScreen rendered');
@@ -33,17 +30,15 @@ const MainScreen = ({navigation}) => {
 
   // Get voice context
   const {
-    activeVoiceChannel,
-    voiceStatus,
-    isMicrophoneEnabled,
-    joinVoiceChannel,
-    leaveVoiceChannel,
     clearPendingAudioTimeouts,
-    setPendingMuteTimeout,
-    setPendingUnmuteTimeout,
+    monitoredChannels,
+    talkChannel,
+    applyRadioState,
     emergencyVoiceReset,
     selectedChannel,
     setSelectedChannel,
+    requestFloor,
+    releaseFloor,
   } = useVoice();
 
   // Modal state
@@ -62,54 +57,26 @@ const MainScreen = ({navigation}) => {
   useEffect(() => {
     console.log('🎧 MainScreen: Setting up Agora event listeners...');
 
-    // Listen for when a user joins the channel
-    const onUserJoinedListener = DeviceEventEmitter.addListener(
-      'onUserJoined',
-      data => {
-        console.log('🔥 MainScreen: USER JOINED VOICE CHANNEL:', data);
-        console.log(
-          '🎉 MainScreen: You should now be able to hear each other!',
-        );
-        console.log('🎤 MainScreen: Both devices can now communicate!');
-        console.log(
-          '📊 MainScreen: User data received:',
-          JSON.stringify(data, null, 2),
-        );
-
-        // Show user-friendly notification
-        Alert.alert(
-          'Voice Connected',
-          `A user joined the voice channel (UID: ${data.uid}). You can now communicate!`,
-          [{text: 'OK'}],
-        );
-      },
-    );
-
-    // Listen for when a user leaves the channel
-    const onUserOfflineListener = DeviceEventEmitter.addListener(
-      'onUserOffline',
-      data => {
-        console.log('😢 MainScreen: USER LEFT VOICE CHANNEL:', data);
-        console.log('⚠️ MainScreen: Voice communication ended with this user');
-        console.log(
-          '📊 MainScreen: User data received:',
-          JSON.stringify(data, null, 2),
-        );
-
-        // Show user-friendly notification
-        Alert.alert(
-          'User Left',
-          `A user left the voice channel (UID: ${data.uid}).`,
-          [{text: 'OK'}],
+    // Membership changes arrive batched; VoiceContext shows the user-facing alert
+    const onAgoraEventsListener = DeviceEventEmitter.addListener(
+      'onAgoraEvents',
+      batch => {
+        const events = (batch?.events || []).filter(
+          e => e.type === 'userJoined' || e.type === 'userOffline',
         );
+        if (events.length > 0) {
+          console.log(
+            '📊 MainScreen: Voice channel membership changed:',
+            JSON.stringify(events, null, 2),
+          );
+        }
       },
     );
 
     // Cleanup event listeners
     return () => {
       console.log('🧹 MainScreen: Cleaning up Agora event listeners...');
-      onUserJoinedListener?.remove();
-      onUserOfflineListener?.remove();
+      onAgoraEventsListener?.remove();
     };
   }, []); // Run once on mount
 
@@ -222,19 +189,21 @@ const MainScreen = ({navigation}) => {
         ? getNextState(current.channelState)
         : getPreviousState(current.channelState);
 
-    // Prepare updatedChannels for optimistic update (used for ListenOnly/ListenAndTalk)
-    const updatedChannels =
-      newState === 'ListenOnly' || newState === 'ListenAndTalk'
-        ? radioChannels.map(c =>
-            c.id === channelId
-              ? {...c, channelState: newState}
-              : c.channelState !== 'Idle'
-              ? {...c, channelState: 'Idle'}
-              : c,
+    // Radios are monitored side by side; only the talk radio changes hands. Going to
+    // ListenAndTalk hands the key over, so a previous talk radio drops back to ListenOnly.
+    const previousTalker =
+      newState === 'ListenAndTalk'
+        ? radioChannels.find(
+            c => c.id !== channelId && c.channelState === 'ListenAndTalk',
           )
-        : radioChannels.map(c =>
-            c.id === channelId ? {...c, channelState: newState} : c,
-          );
+        : null;
+    const updatedChannels = radioChannels.map(c =>
+      c.id === channelId
+        ? {...c, channelState: newState}
+        : previousTalker && c.id === previousTalker.id
+        ? {...c, channelState: 'ListenOnly'}
+        : c,
+    );
 
     try {
       clearPendingAudioTimeouts();
@@ -243,128 +212,58 @@ const MainScreen = ({navigation}) => {
       const userId = user?.id;
       if (!userId) throw new Error('User ID not found');
 
-      if (newState === 'Idle') {
-        // For Idle, wait for both backend and voice disconnect before updating UI
+      if (current.channelState !== 'Idle' && newState !== 'Idle') {
+        // Optimistic UI update between Listen and Talk: the radio is already connected
+        setRadioChannels(updatedChannels);
+      }
+      try {
         await radioChannelsApi.updateChannelState(
           userId,
           channelId,
           newState,
           pinCode,
         );
-        await leaveVoiceChannel();
-        setRadioChannels(updatedChannels);
-      } else if (
-        current.channelState === 'Idle' &&
-        (newState === 'ListenOnly' || newState === 'ListenAndTalk')
-      ) {
-        // For Idle -> ListenOnly/ListenAndTalk, wait for both backend and voice join before updating UI
-        try {
-          await radioChannelsApi.updateChannelState(
-            userId,
-            channelId,
-            newState,
-            pinCode,
-          );
-        } catch (err) {
-          if (err && err.response && err.response.status === 401) {
-            throw new Error('Incorrect PIN');
-          }
-          throw err;
+      } catch (err) {
+        if (err && err.response && err.response.status === 401) {
+          throw new Error('Incorrect PIN');
         }
-        let joinSuccess = false;
-        if (activeVoiceChannel === channelId) {
-          // Channel is already connected, just mute/unmute
-          if (newState === 'ListenOnly') {
-            AgoraModule.MuteLocalAudio(true);
-            joinSuccess = true;
-          } else {
-            AgoraModule.MuteLocalAudio(false);
-            joinSuccess = true;
-          }
-        } else {
-          joinSuccess = await joinVoiceChannel(
-            channelId,
-            current.name,
-            newState,
-          );
-          if (joinSuccess) {
-            const timeout = setTimeout(
-              () => {
-                setPendingMuteTimeout(null);
-                setPendingUnmuteTimeout(null);
-              },
-              newState === 'ListenOnly' ? 1500 : 1000,
-            );
-            newState === 'ListenOnly'
-              ? setPendingMuteTimeout(timeout)
-              : setPendingUnmuteTimeout(timeout);
-          }
-        }
-        if (joinSuccess) {
-          setRadioChannels(updatedChannels);
-        } else {
-          throw new Error('Failed to join voice channel');
-        }
-        // Set other channels to Idle if needed
-        const channelsToSetIdle = radioChannels.filter(
-          c => c.id !== channelId && c.channelState !== 'Idle',
-        );
-        await Promise.all(
-          channelsToSetIdle.map(channel =>
-            radioChannelsApi.updateChannelState(userId, channel.id, 'Idle'),
-          ),
+        throw err;
+      }
+
+      // Voice ONLY after backend validation: where the radios should end up, in one native call
+      const radios =
+        newState === 'Idle'
+          ? monitoredChannels.filter(id => id !== channelId)
+          : monitoredChannels.includes(channelId)
+          ? monitoredChannels
+          : [...monitoredChannels, channelId];
+      const talkId =
+        newState === 'ListenAndTalk'
+          ? channelId
+          : talkChannel === channelId
+          ? null
+          : talkChannel;
+      if (talkChannel === channelId && talkId !== channelId) {
+        await releaseFloor(channelId);
+      }
+      let voiceSuccess = await applyRadioState(radios, talkId);
+      if (voiceSuccess && newState === 'ListenAndTalk') {
+        voiceSuccess = await requestFloor(
+          channelId,
+          floorPriorityForRole(user?.role),
         );
-      } else {
-        // Optimistic UI update for other transitions
-        setRadioChannels(updatedChannels);
+      }
+      if (!voiceSuccess) {
+        throw new Error('Failed to update voice channel');
+      }
+      setRadioChannels(updatedChannels);
+
+      if (previousTalker) {
         await radioChannelsApi.updateChannelState(
           userId,
-          channelId,
-          newState,
-          pinCode,
+          previousTalker.id,
+          'ListenOnly',
         );
-        // Handle voice operations ONLY after backend validation
-        switch (newState) {
-          case 'ListenOnly':
-          case 'ListenAndTalk':
-            if (activeVoiceChannel === channelId) {
-              if (newState === 'ListenOnly') {
-                AgoraModule.MuteLocalAudio(true);
-              } else {
-                AgoraModule.MuteLocalAudio(false);
-              }
-            } else {
-              const joinSuccess = await joinVoiceChannel(
-                channelId,
-                current.name,
-                newState,
-              );
-              if (joinSuccess) {
-                const timeout = setTimeout(
-                  () => {
-                    setPendingMuteTimeout(null);
-                    setPendingUnmuteTimeout(null);
-                  },
-                  newState === 'ListenOnly' ? 1500 : 1000,
-                );
-                newState === 'ListenOnly'
-                  ? setPendingMuteTimeout(timeout)
-                  : setPendingUnmuteTimeout(timeout);
-              }
-            }
-            break;
-        }
-        // Set other channels to Idle if needed
-        if (newState === 'ListenOnly' || newState === 'ListenAndTalk') {
-          const channelsToSetIdle = radioChannels.filter(
-            c => c.id !== channelId && c.channelState !== 'Idle',
-          );
-          await Promise.all(
-            channelsToSetIdle.map(channel =>
-              radioChannelsApi.updateChannelState(userId, channel.id, 'Idle'),
-            ),
-          );
-        }
       }
     } catch (error) {
       // Rollback UI state and show error
@@ -581,14 +480,14 @@ const MainScreen = ({navigation}) => {
                     showStatus={showStatus}
                     numberOfChannels={radioChannels.length}
                     // Voice connection props
-                    isVoiceConnected={activeVoiceChannel === channel.id}
+                    isVoiceConnected={monitoredChannels.includes(channel.id)}
                     voiceStatus={
-                      activeVoiceChannel === channel.id
-                        ? voiceStatus
+                      monitoredChannels.includes(channel.id)
+                        ? 'connected'
                         : 'disconnected'
                     }
                     isMicrophoneEnabled={
-                      activeVoiceChannel === channel.id
+                      monitoredChannels.includes(channel.id)
                         ? channel.channelState === 'ListenAndTalk'
                         : false
                     }
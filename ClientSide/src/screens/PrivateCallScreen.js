@@ -13,6 +13,8 @@ import {
 import {useSettings} from '../context/SettingsContext';
 import {privateCallApi} from '../utils/apiService';
 import {useDebouncedDimensions} from '../utils/useDebouncedDimensions';
+import {FALLBACK_POLL_MS, sendCallSignal, subscribeCallSignals} from '../utils/callSignals';
+import {leaveWithAudioReset} from '../utils/audioState';
 import VolumeModal from '../components/VolumeModal'; // 🎵 NEW: Import VolumeModal
 
 const {AgoraModule} = NativeModules; // 🎯 NEW: Import AgoraModule
@@ -135,7 +137,7 @@ const PrivateCallScreen = ({route, navigation}) => {
           // AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
           
           // Join the Agora channel directly
-          AgoraModule.JoinChannel(agoraChannelName);
+          AgoraModule.JoinChannel(agoraChannelName, false);
           setIsAgoraConnected(true);
           console.log('✅ Successfully connected to Agora channel (manual reconnect):', agoraChannelName);
         } catch (error) {
@@ -163,20 +165,23 @@ const PrivateCallScreen = ({route, navigation}) => {
     try {
       console.log('🎤 Disconnecting from Agora channel (FORCE DISCONNECT)...');
       
-      // 🎤 NEW: Reset audio states before disconnecting
+      // 🎤 NEW: Reset audio states and leave in one native call (only what differs runs)
       if (AgoraModule) {
-        try {
-          AgoraModule.MuteLocalAudio(false);
-          AgoraModule.EnableLocalAudio(true);
-          setIsMicMuted(false);
-          setIsHeadphonesMuted(false);
-          console.log('✅ Audio states reset before disconnect');
-        } catch (audioError) {
-          console.error('❌ Error resetting audio states:', audioError);
-        }
-        
-        AgoraModule.LeaveChannel(); // Force disconnect regardless of state
-        console.log('✅ Successfully disconnected from Agora (FORCED)');
+        setIsMicMuted(false);
+        setIsHeadphonesMuted(false);
+        leaveWithAudioReset()
+          .then(report => console.log('✅ Successfully disconnected from Agora, applied:', report.applied.length))
+          .catch(() => {
+            try {
+              AgoraModule.MuteLocalAudio(false);
+              AgoraModule.EnableLocalAudio(true);
+              console.log('✅ Audio states reset before disconnect');
+            } catch (audioError) {
+              console.error('❌ Error resetting audio states:', audioError);
+            }
+            AgoraModule.LeaveChannel(); // Force disconnect regardless of state
+            console.log('✅ Successfully disconnected from Agora (FORCED)');
+          });
       }
       
       // Update state after successful disconnect
@@ -309,14 +314,20 @@ const PrivateCallScreen = ({route, navigation}) => {
     // Check immediately
     checkCallStatus();
     
-    // Then check every 3 seconds
-    intervalId = setInterval(checkCallStatus, 3000);
+    // A hang-up is pushed over the lobby; the slow poll only catches one that was lost
+    const unsubscribeSignals = subscribeCallSignals((signal) => {
+      if (signal.type === 'end' || signal.type === 'cancel') {
+        checkCallStatus();
+      }
+    }, invitationId);
+    intervalId = setInterval(checkCallStatus, FALLBACK_POLL_MS);
     statusCheckRef.current = intervalId;
     console.log('✅ Started polling with interval ID:', intervalId);
 
     return () => {
       console.log('🧹 Cleaning up call status monitoring, interval ID:', intervalId);
       isMonitoring = false; // Stop monitoring on cleanup
+      unsubscribeSignals();
       if (intervalId) {
         clearInterval(intervalId);
         intervalId = null;
@@ -404,6 +415,7 @@ const PrivateCallScreen = ({route, navigation}) => {
     } catch (error) {
       console.error('❌ Error ending call:', error);
     }
+    sendCallSignal('end', otherUser?.id, invitationId, agoraChannelName);
     
     // 🔧 FIX: One more disconnect attempt before leaving
     disconnectFromAgora(); // Final attempt
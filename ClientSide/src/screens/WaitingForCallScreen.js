@@ -15,6 +15,8 @@ import {useAuth} from '../context/AuthContext';
 import {useSettings} from '../context/SettingsContext';
 import {privateCallApi} from '../utils/apiService';
 import {useDebouncedDimensions} from '../utils/useDebouncedDimensions';
+import {FALLBACK_POLL_MS, sendCallSignal, subscribeCallSignals} from '../utils/callSignals';
+import {TONES, startRinging} from '../utils/tones';
 
 const {AgoraModule} = NativeModules; // 🎯 NEW: Import AgoraModule
 
@@ -32,6 +34,7 @@ const WaitingForCallScreen = ({route, navigation}) => {
   const [status, setStatus] = useState('Sending invitation...');
   const [isPolling, setIsPolling] = useState(false);
   const didShowRejectedAlertRef = useRef(false); // Prevent duplicate alert (sync)
+  const didAcceptRef = useRef(false); // A pushed answer and a poll can both see 'accepted'
   
   // Refs for interval management
   const waitingTimerRef = useRef(null);
@@ -68,6 +71,9 @@ const WaitingForCallScreen = ({route, navigation}) => {
     };
   }, []);
 
+  // 🔔 Ringback while we wait for an answer; stops when the screen goes away
+  useEffect(() => startRinging(TONES.RINGBACK), []);
+
   // Pulse animation for the calling indicator
   useEffect(() => {
     const pulseAnimation = Animated.loop(
@@ -109,6 +115,18 @@ const WaitingForCallScreen = ({route, navigation}) => {
     };
   }, [invitationId]);
 
+  // Their answer is pushed over the lobby: confirm it with the server right away
+  useEffect(() => {
+    if (!invitationId) {
+      return undefined;
+    }
+    return subscribeCallSignals((signal) => {
+      if (signal.type === 'accept' || signal.type === 'reject') {
+        checkCallStatus();
+      }
+    }, invitationId);
+  }, [invitationId]);
+
   // Handle back button
   useEffect(() => {
     const backHandler = BackHandler.addEventListener('hardwareBackPress', () => {
@@ -141,6 +159,8 @@ const WaitingForCallScreen = ({route, navigation}) => {
         console.log('⚠️ Server timeout cancel failed (probably already changed status):', error.message);
         // This is OK - the call might already be accepted/expired/etc
       }
+      // After the server has it, so their status check finds it cancelled
+      sendCallSignal('cancel', otherUser.id, invitationId, channelName);
     }
     
     // Show timeout message and navigate back
@@ -171,9 +191,10 @@ const WaitingForCallScreen = ({route, navigation}) => {
     checkCallStatus();
     
     // Store interval reference so we can clear it later
+    // Only a fallback: the answer is normally pushed (see subscribeCallSignals above)
     pollIntervalRef.current = setInterval(() => {
       checkCallStatus();
-    }, 2000); // Poll every 2 seconds
+    }, FALLBACK_POLL_MS);
     
     console.log('✅ Polling started with interval ID:', pollIntervalRef.current);
   };
@@ -204,6 +225,10 @@ const WaitingForCallScreen = ({route, navigation}) => {
         console.log(`🎯 Current status: "${currentStatus}"`);  // ← Added detailed logging
         
                   if (currentStatus === 'accepted') {
+            if (didAcceptRef.current) {
+              return;
+            }
+            didAcceptRef.current = true;
             console.log('✅ Call accepted! Navigating to private call...');
             
             // Stop all polling immediately to prevent loops
@@ -214,32 +239,27 @@ const WaitingForCallScreen = ({route, navigation}) => {
             const agoraChannelName = invitationId;
             console.log('🎤 Connecting to Agora channel:', agoraChannelName);
             
-            // 🎯 NEW: Add delay to ensure channel is created by the other user
-            console.log('⏰ Waiting 2 seconds for channel to be created by the other user...');
-            
-            setTimeout(() => {
-              try {
-                // Same initialization as MainScreen
-                if (!AgoraModule) {
-                  throw new Error('AgoraModule not available');
-                }
-                
-                // Don't re-initialize Agora - it's already initialized by VoiceContext
-                // AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
-                
-                // Join the Agora channel directly
-                AgoraModule.JoinChannel(agoraChannelName);
-                
-                console.log('✅ Successfully connected to Agora channel:', agoraChannelName);
-              } catch (agoraError) {
-                console.error('❌ Failed to connect to Agora:', agoraError);
-                Alert.alert(
-                  'Voice Connection Failed',
-                  'Call accepted but voice connection failed. You can still communicate via text.',
-                  [{text: 'OK'}]
-                );
+            // Agora channels need no creation step, so join right away (timed natively, see onCallLatency)
+            try {
+              // Same initialization as MainScreen
+              if (!AgoraModule) {
+                throw new Error('AgoraModule not available');
               }
-            }, 2000); // 🎯 2 second delay
+              
+              // Don't re-initialize Agora - it's already initialized by VoiceContext
+              // AgoraModule.InitializeAgoraEngine('e5631d55e8a24b08b067bb73f8797fe3');
+              
+              AgoraModule.AcceptCall(agoraChannelName);
+              
+              console.log('✅ Successfully connected to Agora channel:', agoraChannelName);
+            } catch (agoraError) {
+              console.error('❌ Failed to connect to Agora:', agoraError);
+              Alert.alert(
+                'Voice Connection Failed',
+                'Call accepted but voice connection failed. You can still communicate via text.',
+                [{text: 'OK'}]
+              );
+            }
             
             // Navigate to private call screen
             navigation.reset({
@@ -370,6 +390,8 @@ const WaitingForCallScreen = ({route, navigation}) => {
         console.log('⚠️ Server cancel failed (probably already changed status):', error.message);
         // This is OK - the call might already be accepted/expired/etc
       }
+      // After the server has it, so their status check finds it cancelled
+      sendCallSignal('cancel', otherUser.id, invitationId, channelName);
     }
     
     // Always navigate back successfully - user wants to leave
@@ -0,0 +1,41 @@
+import {NativeModules, DeviceEventEmitter} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native audio device registry (DeviceRegistry): the lists are cached on the native side and
+// kept current from device plug/unplug events, so reading them is cheap. Preferences are device
+// ids or name fragments ('Jabra'), most wanted first; the engine moves to the first one present
+// without restarting or leaving the channel. An empty list goes back to the system default.
+export const DEVICE_KINDS = ['recording', 'playback'];
+
+// {kind, devices: [{id, name}], activeId, preferred}
+export const getAudioDevices = (kind = 'recording') =>
+  new Promise(resolve => {
+    if (!AgoraModule?.GetAudioDevices) {
+      resolve({kind, devices: [], activeId: '', preferred: []});
+      return;
+    }
+    AgoraModule.GetAudioDevices(kind, resolve);
+  });
+
+export const setPreferredDevices = (kind, preferred) => {
+  if (!AgoraModule?.SetPreferredDevices) {
+    return Promise.reject(new Error('Audio devices not available'));
+  }
+  return AgoraModule.SetPreferredDevices(kind, preferred);
+};
+
+// Picking one device from the list is a preference of just that device
+export const selectAudioDevice = (kind, deviceId) => setPreferredDevices(kind, deviceId ? [deviceId] : []);
+
+export const refreshAudioDevices = () => AgoraModule?.RefreshAudioDevices?.();
+
+// Called with the new list of one kind whenever a device comes, goes or is switched to;
+// returns the unsubscribe function
+export const onAudioDevicesChanged = listener => {
+  const subscription = DeviceEventEmitter.addListener('onAudioDevicesChanged', list => {
+    console.log(`🎧 ${list.kind} devices: ${list.devices.length}, active ${list.activeId || 'default'}`);
+    listener(list);
+  });
+  return () => subscription.remove();
+};
@@ -0,0 +1,24 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Desired-state audio: say where the audio should end up and the native side diffs it against
+// what it has, runs only the SDK calls that change something (mute before leaving, joins after
+// leaves, unmute last) and reports back. One bridge call instead of a burst of mute / enable /
+// leave / join / volume calls. Every field is optional; a missing one is left as it is.
+//   channel: '' = leave          listenOnly: bool         radios: [names], exactly these
+//   talkChannel: '' = nobody     muted: bool              localAudioEnabled: bool
+//   recordingVolume / playbackVolume: 0-400               clientRole: 1 host, 2 audience
+//   noiseSuppressionMode: -1 off, 0-2 AINS                scenario: AUDIO_SCENARIO_TYPE
+// Resolves {ready, applied: [{step, channel, value}], unchanged, pending}; pending lists what
+// the engine refused (or everything when it is not ready).
+export const applyAudioState = state => {
+  if (!AgoraModule?.ApplyAudioState) {
+    return Promise.reject(new Error('Audio state API not available'));
+  }
+  return AgoraModule.ApplyAudioState(state);
+};
+
+// Leave the call with the microphone reset for whoever joins next
+export const leaveWithAudioReset = () =>
+  applyAudioState({channel: '', muted: false, localAudioEnabled: true});
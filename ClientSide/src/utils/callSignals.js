@@ -0,0 +1,37 @@
+import {NativeModules, DeviceEventEmitter} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Every signed-in client keeps this Agora channel open to push call invitations and answers
+// to each other (native CallSignaling). The server stays the record of every invitation.
+export const CALL_LOBBY = 'call_lobby';
+
+// Signals arrive in tens of milliseconds; polling the server is only the fallback now
+export const FALLBACK_POLL_MS = 15000;
+
+// Fire and forget: the server call that goes with each signal is what counts, and the
+// other side's fallback poll picks up one that never arrives
+export const sendCallSignal = (type, toUserId, invitationId, channelName, callerName) => {
+  if (!AgoraModule?.SendCallSignal || toUserId == null || !invitationId) {
+    return;
+  }
+  AgoraModule.SendCallSignal(
+    type,
+    String(toUserId),
+    String(invitationId),
+    String(channelName || ''),
+    String(callerName || ''),
+  ).catch(error => console.warn(`⚠️ Could not send ${type} signal:`, error));
+};
+
+// handler(signal) for signals about one invitation (or all, without one); returns unsubscribe
+export const subscribeCallSignals = (handler, invitationId) => {
+  const subscription = DeviceEventEmitter.addListener('onCallSignal', signal => {
+    if (invitationId != null && signal.invitationId !== String(invitationId)) {
+      return;
+    }
+    console.log('📨 Call signal:', signal.type, 'from', signal.from, 'for', signal.invitationId);
+    handler(signal);
+  });
+  return () => subscription.remove();
+};
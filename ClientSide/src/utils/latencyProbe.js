@@ -0,0 +1,34 @@
+import {NativeModules, DeviceEventEmitter} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native latency probe (LatencyProbe): 'device' times speaker to microphone, 'channel' times
+// our audio out over the talk channel and back, which needs something on the far side that
+// loops it (knownDelayMs is subtracted). Run it once per audio scenario / AINS mode to compare.
+export const PROBE_PATHS = ['device', 'channel'];
+export const PROBE_SIGNALS = ['chirp', 'mls'];
+
+// Resolves with the report ({p50Ms, p95Ms, jitterMs, found, probes, latenciesMs, ...}) once every
+// probe went out; a stopped run resolves with cancelled set
+export const runLatencyProbe = (path = 'device', signal = 'chirp', probes = 10, knownDelayMs = 0) => {
+  if (!AgoraModule?.StartLatencyProbe) {
+    return Promise.reject(new Error('Latency probe not available'));
+  }
+  return new Promise((resolve, reject) => {
+    const subscription = DeviceEventEmitter.addListener('onLatencyProbeFinished', report => {
+      subscription.remove();
+      console.log(
+        `📏 Latency (${report.path}, scenario ${report.audioScenario}, AINS ${report.noiseSuppressionMode}):`,
+        `p50 ${report.p50Ms.toFixed(1)} ms, p95 ${report.p95Ms.toFixed(1)} ms,`,
+        `${report.found}/${report.probes} heard`,
+      );
+      resolve(report);
+    });
+    AgoraModule.StartLatencyProbe(path, signal, probes, knownDelayMs).catch(error => {
+      subscription.remove();
+      reject(error);
+    });
+  });
+};
+
+export const stopLatencyProbe = () => AgoraModule?.StopLatencyProbe?.();
@@ -0,0 +1,28 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native link profile (LinkProfile): before joining, a last-mile probe picks the audio profile,
+// bitrate, FEC and jitter buffer for the link, and the choice is cached per network so rejoining
+// on the same Wi-Fi doesn't probe again. Joins never wait for a probe.
+export const LINK_TIERS = ['unknown', 'good', 'fair', 'poor'];
+
+// {networkId, tier, probing, fromCache, audioProfile, bitrateKbps, fec, jitterBufferMs, rttMs, loss, measuredAtMs}
+export const getLinkProfile = () =>
+  new Promise(resolve => {
+    if (!AgoraModule?.GetLinkProfile) {
+      resolve({networkId: '', tier: 'unknown', probing: false, fromCache: false});
+      return;
+    }
+    AgoraModule.GetLinkProfile(resolve);
+  });
+
+// Measures the current network again (about 30 s); ignored while in a channel
+export const probeLink = () => {
+  if (!AgoraModule?.StartLastmileProbe) {
+    return Promise.reject(new Error('Last-mile probe not available'));
+  }
+  return AgoraModule.StartLastmileProbe();
+};
+
+export const setLinkProfileTtl = minutes => AgoraModule?.SetLinkProfileTtl?.(minutes);
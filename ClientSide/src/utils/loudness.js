@@ -0,0 +1,38 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native loudness levelling (LoudnessNormalizer): every remote user is measured (EBU R128
+// K-weighting) and turned up or down towards one target, so a field unit shouting into its
+// handset and one whispering sound alike without touching the volume slider. Loud speakers are
+// caught within tens of milliseconds, quiet ones are raised over a couple of seconds, pauses
+// hold the gain. Off until enabled; the settings outlive the engine.
+export const DEFAULT_LOUDNESS = {
+  enabled: true,
+  targetLufs: -20,
+  maxBoostDb: 15,
+  maxCutDb: 15,
+  gateLufs: -55,
+  attackMs: 40,
+  releaseMs: 2000,
+};
+
+// Missing fields keep their defaults
+export const configureLoudness = settings => {
+  if (!AgoraModule?.ConfigureLoudness) {
+    return Promise.reject(new Error('Loudness levelling not available'));
+  }
+  return AgoraModule.ConfigureLoudness(settings);
+};
+
+export const enableLoudness = (enabled = true) => configureLoudness({...DEFAULT_LOUDNESS, enabled});
+
+// [{channelName, uid, loudnessLufs, gainDb, speaking}] for everyone heard in the last 2 s
+export const getLoudnessStats = () =>
+  new Promise(resolve => {
+    if (!AgoraModule?.GetLoudnessStats) {
+      resolve([]);
+      return;
+    }
+    AgoraModule.GetLoudnessStats(resolve);
+  });
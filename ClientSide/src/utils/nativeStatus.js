@@ -0,0 +1,54 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Hot status reads through global.AgoraNative, the JSI host object the Windows module installs:
+// synchronous, straight from native memory, cheap enough to call on every render or animation
+// frame. Without JSI (remote debugging, other platforms) the sync reads return null / [] and the
+// async ones fall back to the bridge methods.
+const host = () => global.AgoraNative;
+
+export const hasNativeStatus = () => host() != null;
+
+// {muted, listenOnly, engineReady, channel, talkChannel, replaying, voxOpen}, or null without JSI
+export const readAudioStatus = () => {
+  const native = host();
+  if (!native) {
+    return null;
+  }
+  return {
+    muted: native.muted,
+    listenOnly: native.listenOnly,
+    engineReady: native.engineReady,
+    channel: native.channel,
+    talkChannel: native.talkChannel,
+    replaying: native.replaying,
+    voxOpen: native.voxOpen,
+  };
+};
+
+// 'connected' | 'connecting' | 'reconnecting' | 'failed' | 'disconnected'; '' = default channel
+export const readConnectionState = (channel = '') => host()?.connectionState(channel) ?? null;
+
+// [[uid, level 0-255]] of everyone heard on the channel right now (uid 0 = us)
+export const readLevels = (channel = '') => host()?.levels(channel) ?? [];
+
+// e.g. 'join.p50Us', 'reconnect.count', 'mixer.dropped'; undefined for unknown names
+export const readCounter = name => host()?.counter(name);
+
+export const counterNames = () => host()?.counterNames() ?? [];
+
+// Mute state either way: the host object when there is one, the bridge callback otherwise
+export const isLocalAudioMuted = () => {
+  const native = host();
+  if (native) {
+    return Promise.resolve(native.muted);
+  }
+  return new Promise(resolve => {
+    if (!AgoraModule?.IsLocalAudioMuted) {
+      resolve(false);
+      return;
+    }
+    AgoraModule.IsLocalAudioMuted(resolve);
+  });
+};
@@ -0,0 +1,38 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native radio mixer (RadioMixer): playback is rebuilt from each user's audio with a gain and
+// stereo pan per radio and per user, so radios can sit left and right of the operator. While
+// someone talks on a radio with a higher priority, every radio below it is ducked by duckDb.
+// All changes ramp without clicks. Off until enabled; the settings outlive the engine.
+export const PAN_LEFT = -1;
+export const PAN_CENTRE = 0;
+export const PAN_RIGHT = 1;
+export const MUTED_DB = -60;
+
+// {enabled, duckDb, activityDb, duckHoldMs, rampMs}; missing fields keep their defaults
+export const configureRadioMixer = settings => {
+  if (!AgoraModule?.ConfigureRadioMixer) {
+    return Promise.reject(new Error('Radio mixer not available'));
+  }
+  return AgoraModule.ConfigureRadioMixer(settings);
+};
+
+// Priority 0..9: higher ducks lower while someone talks on it
+export const setRadioMix = (channelName, {gainDb = 0, pan = PAN_CENTRE, priority = 0} = {}) =>
+  AgoraModule?.SetRadioMix?.(channelName, gainDb, pan, priority);
+
+// One user on a radio: the gain adds to the radio's, the pan replaces it
+export const setUserMix = (channelName, uid, {gainDb = 0, pan = PAN_CENTRE} = {}) =>
+  AgoraModule?.SetUserMix?.(channelName, uid, gainDb, pan);
+
+// {enabled, duckDb, activityDb, duckHoldMs, rampMs, mixes: [{channelName, uid, gainDb, pan, priority}]}
+export const getRadioMixer = () =>
+  new Promise(resolve => {
+    if (!AgoraModule?.GetRadioMixer) {
+      resolve({enabled: false, mixes: []});
+      return;
+    }
+    AgoraModule.GetRadioMixer(resolve);
+  });
@@ -0,0 +1,55 @@
+import {NativeModules} from 'react-native';
+
+const {AgoraModule} = NativeModules;
+
+// Native cue tones, synthesized once at startup and mixed straight into the audio frames: a cue
+// starts within 10 ms of the trigger. Through global.AgoraNative (JSI) a trigger is synchronous
+// and skips the bridge queue; the bridge methods are the fallback.
+//   talkStart / talkEnd: key-up and key-down chirps      roger: end-of-transmission beep
+//   ring: incoming call (repeats)                        ringback: our call is ringing (repeats)
+export const TONES = {
+  TALK_START: 'talkStart',
+  TALK_END: 'talkEnd',
+  ROGER: 'roger',
+  RING: 'ring',
+  RINGBACK: 'ringback',
+};
+
+// uplink: also send the cue out on the talk channel (while the microphone is open)
+export const playTone = (cue, {uplink = false} = {}) => {
+  if (global.AgoraNative?.playTone) {
+    global.AgoraNative.playTone(cue, uplink);
+    return Promise.resolve();
+  }
+  if (!AgoraModule?.PlayTone) {
+    return Promise.reject(new Error('Cue tones not available'));
+  }
+  return AgoraModule.PlayTone(cue, uplink);
+};
+
+export const stopTone = cue => {
+  if (global.AgoraNative?.stopTone) {
+    global.AgoraNative.stopTone(cue);
+    return Promise.resolve();
+  }
+  if (!AgoraModule?.StopTone) {
+    return Promise.resolve();
+  }
+  return AgoraModule.StopTone(cue);
+};
+
+// {levelDb: -40..0, talkChirps: bool}; missing fields keep their current values
+export const configureTones = settings => {
+  if (!AgoraModule?.ConfigureTones) {
+    return Promise.reject(new Error('Cue tones not available'));
+  }
+  return AgoraModule.ConfigureTones(settings);
+};
+
+// Rings for as long as the calling component wants it; returns the stop function
+export const startRinging = (cue = TONES.RING) => {
+  playTone(cue).catch(() => {});
+  return () => {
+    stopTone(cue).catch(() => {});
+  };
+};
@@ -0,0 +1,2816 @@
+#include "AgoraCore.h"
+#include "Logging.h"
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+namespace winrt::FinalProject::implementation
+{
+    static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static uint64_t SteadyNowMs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // 0=Default, 3=Game_Streaming, 5=Chatroom, 8=Meeting; anything else falls back to meeting
+    static int AppliedScenario(int scenario)
+    {
+        bool known = scenario == AgoraCore::kScenarioDefault || scenario == 3 || scenario == 5 || scenario == AgoraCore::kScenarioMeeting;
+        return known ? scenario : AgoraCore::kScenarioMeeting;
+    }
+
+    // 0=Balanced, 1=Aggressive, 2=UltraLowLatency; anything else falls back to balanced
+    static int AppliedNoiseSuppressionMode(int mode)
+    {
+        return mode >= 0 && mode <= 2 ? mode : 0;
+    }
+
+    // Floor retries, hellos and leases are timed from this
+    static constexpr int kFloorTickMs = 50;
+
+    // A probe's window is checked this long after it should be full, then every poll until
+    // the frames have had a second more
+    static constexpr int kProbeSlackMs = 100;
+    static constexpr int kProbePollMs = 50;
+    static constexpr int kProbeGraceMs = 1000;
+    static constexpr int kMaxProbes = 100;
+
+    // Last-mile probe: expected bitrates (the SDK takes 100 kbps to 5 Mbps; the downlink carries
+    // several radios), and how long to wait for a result that normally comes after ~30 s
+    static constexpr int kLastmileUplinkKbps = 100;
+    static constexpr int kLastmileDownlinkKbps = 500;
+    static constexpr int kLastmileTimeoutMs = 45000;
+    // A probe a join put off runs once nothing was joined for this long (channel hops don't count)
+    static constexpr int kLastmileIdleMs = 10000;
+
+    // AgoraEventHandler implementation
+    void AgoraEventHandler::onJoinChannelSuccess(const char* channel, uint32_t uid, int elapsed)
+    {
+        AGORA_LOG_INFO("🎉 Joined channel {} as uid {} in {} ms", channel, uid, elapsed);
+
+        // elapsed runs from the join call, so this is the SDK's share of the join
+        if (m_metrics) m_metrics->RecordLatency(MetricOp::JoinToSuccess, static_cast<uint64_t>(std::max(0, elapsed)) * 1000);
+
+        Publish(AgoraEventType::JoinChannelSuccess, channel, uid, elapsed);
+    }
+
+    void AgoraEventHandler::onLeaveChannel(const ChannelStatsSample& stats)
+    {
+        AGORA_LOG_INFO("👋 Left channel {} after {} s ({} kbps up, {} kbps down, {} users)", m_channelName,
+                       stats.durationS, stats.txKbps, stats.rxKbps, stats.userCount);
+
+        // Final totals for the connection
+        onRtcStats(stats);
+
+        Publish(AgoraEventType::LeaveChannel, m_channelName.c_str(), 0, static_cast<int>(stats.durationS));
+    }
+
+    void AgoraEventHandler::onUserJoined(uint32_t uid, int elapsed)
+    {
+        AGORA_LOG_INFO("🔥 Remote user {} joined {} ({} ms)", uid, m_channelName, elapsed);
+
+        // Bridge to JS (batched, see EventBatcher)
+        Publish(AgoraEventType::UserJoined, m_channelName.c_str(), uid, elapsed);
+    }
+
+    void AgoraEventHandler::onUserOffline(uint32_t uid, int reason)
+    {
+        // reason: 0 = QUIT, 1 = DROPPED, 2 = BECOME_AUDIENCE
+        AGORA_LOG_INFO("😢 Remote user {} left {} (reason {})", uid, m_channelName, reason);
+
+        if (m_metrics) m_metrics->ForgetUid(m_metricsChannel, uid);
+
+        // Bridge to JS (batched, see EventBatcher)
+        Publish(AgoraEventType::UserOffline, m_channelName.c_str(), uid, reason);
+    }
+
+    void AgoraEventHandler::onError(int err, const char* msg)
+    {
+        AGORA_LOG_ERROR("💥 Agora error {} on {}: {}", err, m_channelName, msg ? msg : "Unknown error");
+
+        Publish(AgoraEventType::Error, m_channelName.c_str(), 0, err);
+    }
+
+    void AgoraEventHandler::onAudioVolumeIndication(const VolumeSample* speakers, unsigned int speakerNumber, int totalVolume)
+    {
+        (void)totalVolume;
+        if (!m_volumeMeter || !speakers) return;
+
+        // Hot path (every interval, every connection): table writes only, no logging
+        for (unsigned int i = 0; i < speakerNumber; ++i) {
+            m_volumeMeter->Report(m_volumeChannel, speakers[i].uid, speakers[i].volume);
+        }
+    }
+
+    void AgoraEventHandler::onActiveSpeaker(uint32_t uid)
+    {
+        AGORA_LOG_DEBUG("🗣️ Active speaker on {} is uid {}", m_channelName, uid);
+
+        if (m_volumeMeter) m_volumeMeter->ReportActiveSpeaker(m_volumeChannel, uid);
+    }
+
+    // Stats callbacks arrive every 2 s per connection (and per remote user): slot writes only
+    void AgoraEventHandler::onRtcStats(const ChannelStatsSample& stats)
+    {
+        if (m_metrics) m_metrics->RecordChannelStats(m_metricsChannel, stats);
+    }
+
+    void AgoraEventHandler::onNetworkQuality(uint32_t uid, int txQuality, int rxQuality)
+    {
+        if (m_metrics) m_metrics->RecordNetworkQuality(m_metricsChannel, uid, txQuality, rxQuality);
+    }
+
+    void AgoraEventHandler::onRemoteAudioStats(uint32_t uid, const RemoteAudioSample& stats)
+    {
+        if (m_metrics) m_metrics->RecordRemoteAudio(m_metricsChannel, uid, stats);
+    }
+
+    // Connection callbacks carry this handler's channel name ("" = default channel), which is
+    // the key the core's connection monitor uses; recovery itself runs on the worker
+    void AgoraEventHandler::onConnectionStateChanged(int state, int reason)
+    {
+        AGORA_LOG_INFO("📶 Connection {} state {} (reason {})", m_channelName, state, reason);
+
+        Publish(AgoraEventType::ConnectionStateChanged, m_channelName.c_str(), static_cast<uint32_t>(reason), state);
+    }
+
+    void AgoraEventHandler::onConnectionLost()
+    {
+        AGORA_LOG_WARN("📵 Connection {} lost", m_channelName);
+
+        Publish(AgoraEventType::ConnectionLost, m_channelName.c_str(), 0, 0);
+    }
+
+    void AgoraEventHandler::onRejoinChannelSuccess(const char* channel, uint32_t uid, int elapsed)
+    {
+        AGORA_LOG_INFO("🔁 Rejoined channel {} as uid {} in {} ms", channel, uid, elapsed);
+
+        Publish(AgoraEventType::RejoinChannelSuccess, m_channelName.c_str(), uid, elapsed);
+    }
+
+    // Only the signaling lobby has a sink; the worker logs what a message means, not this thread
+    void AgoraEventHandler::onStreamMessage(uint32_t uid, int streamId, const char* data, size_t length)
+    {
+        (void)streamId;
+        if (m_streamSink && data && length > 0) m_streamSink(uid, data, length);
+    }
+
+    void AgoraEventHandler::onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState)
+    {
+        AGORA_LOG_INFO("🎧 Audio device {} (type {}) state {}", deviceId ? deviceId : "", deviceType, deviceState);
+
+        if (m_deviceSink && deviceId) m_deviceSink(deviceId, deviceType, deviceState);
+    }
+
+    void AgoraEventHandler::onLastmileProbeResult(const LastmileProbeResult& result)
+    {
+        AGORA_LOG_DEBUG("📶 Last-mile probe result, state {}", result.state);
+
+        if (m_lastmileSink) m_lastmileSink(result);
+    }
+
+    void AgoraEventHandler::Publish(AgoraEventType type, const char* channel, uint32_t uid, int value)
+    {
+        if (!m_eventBatcher) return;
+
+        AgoraEvent event;
+        event.type = type;
+        event.uid = uid;
+        event.value = value;
+        event.SetChannel(channel);
+        m_eventBatcher->Push(event);
+    }
+
+    // AgoraCore implementation
+    AgoraCore::AgoraCore(EngineFactory engineFactory) : m_engineFactory(std::move(engineFactory))
+    {
+        m_capturePipeline.SetGateListener(&AgoraCore::OnVoxGateChanged, this);
+        m_radioMixer.SetNext(&m_replayRecorder);
+        m_radioMixer.SetNormalizer(&m_loudness);
+        // Link states go into the snapshot so any thread can ask without touching the worker's map
+        m_connectionMonitor.SetObserver([this](const std::string& key, ConnectionState state, bool tracked) {
+            m_state.Update([&key, state, tracked](AgoraState& current) {
+                if (tracked) {
+                    current.connections[key] = state;
+                } else {
+                    current.connections.erase(key);
+                }
+            });
+        });
+        m_playbackPipeline.SetFrameSource(&RadioMixer::RenderInto, &m_radioMixer);
+        m_playbackPipeline.AddMixSource(&ReplayPlayer::MixInto, &m_replayPlayer);
+        m_capturePipeline.AddMixSource(&LatencyProbe::MixCapture, &m_latencyProbe);
+        m_playbackPipeline.AddMixSource(&LatencyProbe::MixPlayback, &m_latencyProbe);
+        m_playbackPipeline.AddMixSource(&ToneEngine::MixPlayback, &m_tones);
+        m_capturePipeline.AddMixSource(&ToneEngine::MixCapture, &m_tones);
+        m_commandQueue.Start();
+    }
+
+    AgoraCore::~AgoraCore()
+    {
+        m_commandQueue.Stop();
+        m_eventBatcher.Stop();
+        m_volumeMeter.Stop();
+        ReleaseEngine();
+    }
+
+    void AgoraCore::InitializeEngine(const std::string& appId)
+    {
+        try {
+            AGORA_LOG_INFO("🚀 InitializeEngine - app id {}", appId);
+            auto start = Clock::now();
+
+            // Warm start already created and configured this engine at launch - keep it
+            if (IsReady() && m_state.Read([&appId](const AgoraState& state) { return state.appId == appId; })) {
+                double initCallMs = MillisecondsSince(start);
+                m_state.Update([initCallMs](AgoraState& state) { state.callLatency.initCallMs = initCallMs; });
+                AGORA_LOG_INFO("♻️ Engine already warm, nothing to do");
+                return;
+            }
+
+            // Clean up existing engine
+            if (m_engine) {
+                AGORA_LOG_DEBUG("🧹 Cleaning up existing engine");
+                if (m_latencyProbe.IsRunning()) FinishLatencyProbe(true);
+                m_externalAudio.Stop();
+                LeaveFloors();
+                m_radioSession.LeaveAll();
+                m_engine->LeaveChannel();
+                m_engine->SetAudioProcessors(nullptr, nullptr, nullptr);
+                m_engine->Release();
+                m_engine.reset();
+                m_connectionHandlers.clear();
+                m_preparedChannel.clear();
+                m_callConnection.clear();
+                m_pendingAccept.clear();
+                m_replayPlayer.Stop();
+                m_tones.StopAll();
+                m_replayRecorder.Clear();
+                // Levels and per-connection stats belonged to the old engine's uids. The meter keeps
+                // running (the interval survives) and keeps its channel names, so AttachChannelSlots
+                // below gets the default channel's old slot back instead of a second one.
+                m_volumeMeter.Reset();
+                m_metrics.ResetConnections();
+                m_voxTalking = true; // a fresh engine starts unmuted; the gate re-reports on its next frame
+                m_connectionMonitor.Clear();
+                m_deviceRegistry.Clear();
+                m_devicePinned[0] = m_devicePinned[1] = false;
+                m_lastmileProbing = false;
+                ++m_lastmileRun;
+                m_recordingVolume = -1;
+                m_playbackVolume = -1;
+                m_clientRole = -1;
+                m_signalingStream = -1; // the lobby is joined again on the new engine below
+            }
+
+            // Create event handler
+            m_eventHandler = std::make_unique<AgoraEventHandler>();
+            m_eventHandler->SetEventBatcher(&m_eventBatcher);
+            m_eventHandler->SetDeviceSink([this](const char* deviceId, int deviceType, int deviceState) {
+                std::string id = deviceId;
+                Clock::time_point at = Clock::now();
+                Post(Command{ "", [this, id, deviceType, deviceState, at]() {
+                    OnAudioDeviceStateChanged(id, deviceType, deviceState, at);
+                }, nullptr });
+            });
+            m_eventHandler->SetLastmileSink([this](const LastmileProbeResult& result) {
+                Post(Command{ "", [this, result]() { OnLastmileProbeResult(result); }, nullptr });
+            });
+            AttachChannelSlots(*m_eventHandler, "");
+
+            // Create engine (with Ex connections so radios can run in parallel)
+            m_engine = m_engineFactory ? m_engineFactory() : nullptr;
+            if (!m_engine) {
+                AGORA_LOG_ERROR("❌ Failed to create RTC engine");
+                m_metrics.RecordFailure(MetricOp::Init);
+                return;
+            }
+
+            int result = m_engine->Initialize(appId, m_eventHandler.get());
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to initialize engine, error: {}", result);
+                m_metrics.RecordLatency(MetricOp::Init, static_cast<uint64_t>(MillisecondsSince(start) * 1000), false);
+                m_engine->Release();
+                m_engine.reset();
+                m_state.Update([](AgoraState& state) { state.isEngineCreated = false; state.isInitialized = false; });
+                return;
+            }
+
+            // Enable AI Noise Suppression for better audio quality
+            result = m_engine->SetNoiseSuppression(true, kNoiseSuppressionAggressive);
+            AGORA_LOG_DEBUG("🤖 AI Noise Suppression (aggressive) result: {}", result);
+
+            // Set audio scenario for communication (optimizes for voice)
+            result = m_engine->SetAudioScenario(kScenarioMeeting);
+            AGORA_LOG_DEBUG("🎤 Audio scenario (meeting) result: {}", result);
+
+            // Set client role
+            result = m_engine->SetClientRole(kRoleBroadcaster);
+            AGORA_LOG_DEBUG("🔧 setClientRole result: {}", result);
+
+            RegisterAudioProcessors();
+            ApplyVoiceTuning(); // pre-applied so the first join doesn't have to
+            m_appliedLinkProfile = AudioLinkProfile{}; // a new engine starts on SDK defaults
+
+            // Volume indication survives a re-initialize
+            if (m_volumeIntervalMs > 0) {
+                m_engine->EnableVolumeIndication(m_volumeIntervalMs, m_volumeSmooth);
+            }
+
+            // Every radio connection uses the same local uid; the channel name keeps them apart
+            std::random_device randomDevice;
+            m_localUid = static_cast<uint32_t>(1 + randomDevice() % 0x7FFFFFFE);
+
+            // Mark as initialized
+            double engineInitMs = MillisecondsSince(start);
+            m_metrics.RecordLatency(MetricOp::Init, static_cast<uint64_t>(engineInitMs * 1000));
+            m_state.Update([&appId, engineInitMs](AgoraState& state) {
+                state = AgoraState{ state.version };
+                state.isEngineCreated = true;
+                state.isInitialized = true;
+                state.appId = appId;
+                state.audioScenario = kScenarioMeeting;
+                state.noiseSuppressionMode = kNoiseSuppressionAggressive;
+                state.callLatency.engineInitMs = engineInitMs;
+                state.callLatency.initCallMs = engineInitMs;
+            });
+            AGORA_LOG_INFO("✅ InitializeEngine completed in {} ms, local uid {}", engineInitMs, m_localUid);
+
+            // The new engine's uplink starts open; VOX closes it again if the gate still hears silence
+            ApplyVoxTransition(!m_voxMode || IsVoxGateOpen());
+
+            // The one enumeration per engine; preferences set before it apply now
+            for (AudioDeviceKind kind : { AudioDeviceKind::Recording, AudioDeviceKind::Playback }) {
+                if (EnumerateAudioDevices(kind)) ApplyDevicePolicy(kind, Clock::now());
+                PublishAudioDevices(kind);
+            }
+
+            // Cached profile for this network, or a probe in the background to find one
+            ResolveLinkProfile(false);
+
+            // Signed in before the re-initialize: stay reachable
+            if (!m_signalingChannel.empty()) {
+                result = JoinSignalingConnection();
+                if (result == 0) {
+                    m_connectionMonitor.Track(m_signalingChannel);
+                } else {
+                    AGORA_LOG_ERROR("❌ Failed to rejoin signaling lobby {}, error: {}", m_signalingChannel, result);
+                }
+            }
+
+        } catch (const std::exception& e) {
+            AGORA_LOG_ERROR("❌ Exception in InitializeEngine: {}", e.what());
+            m_metrics.RecordFailure(MetricOp::Init);
+            m_state.Update([](AgoraState& state) { state.isInitialized = false; });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Unknown exception in InitializeEngine");
+            m_metrics.RecordFailure(MetricOp::Init);
+            m_state.Update([](AgoraState& state) { state.isInitialized = false; });
+        }
+    }
+
+    // App launch: same as InitializeEngine, but queued so App::App never waits on the SDK
+    void AgoraCore::WarmStart(const std::string& appId)
+    {
+        Post(Command{ "", [this, appId]() {
+            AGORA_LOG_INFO("🔥 Warm start");
+            InitializeEngine(appId);
+        }, nullptr });
+    }
+
+    void AgoraCore::StartEchoTest()
+    {
+        try {
+            AGORA_LOG_INFO("🎤 StartEchoTest");
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot start echo test");
+                return;
+            }
+
+            if (IsEchoTestRunning()) {
+                AGORA_LOG_WARN("⚠️ Echo test already running");
+                return;
+            }
+
+            // Audio device loopback, 1 second interval
+            int result = m_engine->StartEchoTest(1000);
+
+            if (result == 0) {
+                m_state.Update([](AgoraState& state) { state.isEchoTestRunning = true; });
+                AGORA_LOG_INFO("✅ Audio device loopback test started");
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to start audio device loopback test, error: {}", result);
+            }
+
+        } catch (const std::exception& e) {
+            AGORA_LOG_ERROR("❌ Exception in StartEchoTest: {}", e.what());
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Unknown exception in StartEchoTest");
+        }
+    }
+
+    void AgoraCore::StopEchoTest()
+    {
+        try {
+            if (!m_engine || !IsEchoTestRunning()) return;
+
+            int result = m_engine->StopEchoTest();
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to stop audio device loopback test, error: {}", result);
+            }
+
+            m_state.Update([](AgoraState& state) { state.isEchoTestRunning = false; });
+            AGORA_LOG_INFO("✅ Echo test stopped");
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StopEchoTest");
+        }
+    }
+
+    void AgoraCore::StartLatencyProbe(const LatencyProbeConfig& config)
+    {
+        try {
+            AGORA_LOG_INFO("📏 StartLatencyProbe - {} path, {} signal, {} probes", ProbePathName(config.path),
+                           ProbeSignalName(config.signal), config.probes);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot start latency probe");
+                return;
+            }
+            if (m_latencyProbe.IsRunning()) {
+                AGORA_LOG_WARN("⚠️ Latency probe already running, starting over");
+                FinishLatencyProbe(true);
+            }
+
+            if (config.path == ProbePath::Channel) {
+                // The signal goes out with our microphone; something on the far side has to send it back
+                if (TalkTarget().empty() || IsLocalAudioMuted()) {
+                    AGORA_LOG_WARN("⚠️ Channel probe needs a joined channel with the microphone open");
+                    return;
+                }
+                if (m_voxMode) {
+                    AGORA_LOG_WARN("⚠️ VOX is on - probes go out only while the gate is open");
+                }
+            } else if (GetCurrentChannel().empty() && m_radioSession.GetChannels().empty() && !IsEchoTestRunning()) {
+                // Outside a channel only the loopback test keeps the devices running. It also plays
+                // the microphone back, so a weaker second copy follows each probe; the stronger wins.
+                StartEchoTest();
+                if (!IsEchoTestRunning()) return;
+                m_probeLoopback = true;
+            }
+
+            LatencyProbeConfig applied = config;
+            applied.probes = std::clamp(config.probes, 1, kMaxProbes);
+            applied.gapMs = std::max(0, config.gapMs);
+            m_latencyProbe.Start(applied);
+
+            AgoraState state = m_state.Load();
+            m_probeReport = LatencyReport{};
+            m_probeReport.path = applied.path;
+            m_probeReport.signal = applied.signal;
+            m_probeReport.audioScenario = state.audioScenario;
+            m_probeReport.noiseSuppressionMode = state.noiseSuppressionMode;
+            m_probeReport.samples.reserve(static_cast<size_t>(applied.probes));
+
+            ArmLatencyProbe(++m_probeRun, 1);
+        } catch (const std::exception& e) {
+            AGORA_LOG_ERROR("❌ Exception in StartLatencyProbe: {}", e.what());
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Unknown exception in StartLatencyProbe");
+        }
+    }
+
+    void AgoraCore::StopLatencyProbe()
+    {
+        try {
+            if (!m_latencyProbe.IsRunning()) return;
+            AGORA_LOG_INFO("📏 StopLatencyProbe");
+            FinishLatencyProbe(true);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StopLatencyProbe");
+        }
+    }
+
+    void AgoraCore::SetExternalAudio(bool enabled, const ExternalAudioConfig& config)
+    {
+        try {
+            AGORA_LOG_INFO("🔌 SetExternalAudio - {} ({} Hz, capture {} ch, playback {} ch)",
+                           enabled, config.sampleRate, config.captureChannels, config.playbackChannels);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot switch external audio");
+                return;
+            }
+
+            // The audio source of a joined connection is fixed at join time
+            if (!GetCurrentChannel().empty() || !m_radioSession.GetChannels().empty() || !m_preparedChannel.empty()) {
+                AGORA_LOG_WARN("⚠️ Leave every channel before switching external audio");
+                return;
+            }
+
+            m_externalAudio.Stop();
+            if (!enabled) {
+                m_engine->SetExternalAudio(false, 0, 0, 0);
+                RegisterAudioProcessors();
+                m_state.Update([](AgoraState& state) { state.isExternalAudio = false; });
+                AGORA_LOG_INFO("✅ External audio off, back on the SDK's devices");
+                return;
+            }
+
+            m_externalAudio.Configure(config);
+            const ExternalAudioConfig& applied = m_externalAudio.GetConfig();
+            int result = m_engine->SetExternalAudio(true, applied.sampleRate, applied.captureChannels, applied.playbackChannels);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to enable external audio, error: {}", result);
+                return;
+            }
+
+            // The pump runs the pipelines now; the observer keeps staging per-user frames only
+            m_engine->SetAudioProcessors(nullptr, nullptr, &m_radioMixer);
+            m_externalAudio.Start(m_engine.get(), &m_capturePipeline, &m_playbackPipeline);
+            m_state.Update([](AgoraState& state) { state.isExternalAudio = true; });
+            AGORA_LOG_INFO("✅ External audio on, {} ms of ring each way", applied.ringFrames * ExternalAudio::kFrameMs);
+        } catch (const std::exception& e) {
+            AGORA_LOG_ERROR("❌ Exception in SetExternalAudio: {}", e.what());
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Unknown exception in SetExternalAudio");
+        }
+    }
+
+    void AgoraCore::SetPreferredDevices(AudioDeviceKind kind, const std::vector<std::string>& preferred)
+    {
+        try {
+            AGORA_LOG_INFO("🎧 SetPreferredDevices - {}: {} entries", AudioDeviceKindName(kind), preferred.size());
+
+            m_deviceRegistry.SetPreferences(kind, preferred);
+            // Without an engine the policy waits for the next InitializeEngine
+            if (IsReady() && (m_deviceRegistry.IsEnumerated(kind) || EnumerateAudioDevices(kind))) {
+                ApplyDevicePolicy(kind, Clock::now());
+            }
+            PublishAudioDevices(kind);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetPreferredDevices");
+        }
+    }
+
+    void AgoraCore::RefreshAudioDevices()
+    {
+        try {
+            AGORA_LOG_INFO("🎧 RefreshAudioDevices");
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot enumerate audio devices");
+                return;
+            }
+
+            for (AudioDeviceKind kind : { AudioDeviceKind::Recording, AudioDeviceKind::Playback }) {
+                if (EnumerateAudioDevices(kind)) ApplyDevicePolicy(kind, Clock::now());
+                PublishAudioDevices(kind);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in RefreshAudioDevices");
+        }
+    }
+
+    AudioDeviceList AgoraCore::GetAudioDevices(AudioDeviceKind kind) const
+    {
+        return m_state.Read([kind](const AgoraState& state) {
+            return kind == AudioDeviceKind::Playback ? state.playbackDevices : state.recordingDevices;
+        });
+    }
+
+    void AgoraCore::OnAudioDeviceStateChanged(const std::string& deviceId, int deviceType, int deviceState, Clock::time_point at)
+    {
+        try {
+            if (!IsReady() || deviceId.empty()) return;
+            if (deviceType != static_cast<int>(AudioDeviceKind::Playback) && deviceType != static_cast<int>(AudioDeviceKind::Recording)) return;
+            const AudioDeviceKind kind = static_cast<AudioDeviceKind>(deviceType);
+            const size_t slot = static_cast<size_t>(kind);
+
+            if (deviceState == DeviceRegistry::kStateActive) {
+                if (m_deviceRegistry.Contains(kind, deviceId)) return;
+                // The event carries no name: list this kind again, the other stays cached
+                AGORA_LOG_INFO("🎧 New {} device {}", AudioDeviceKindName(kind), deviceId);
+                if (!EnumerateAudioDevices(kind)) return;
+            } else if (deviceState == DeviceRegistry::kStateDisabled || deviceState == DeviceRegistry::kStateNotPresent ||
+                       deviceState == DeviceRegistry::kStateUnplugged) {
+                bool wasActive = m_deviceRegistry.GetActive(kind) == deviceId;
+                if (!m_deviceRegistry.Remove(kind, deviceId)) return;
+                AGORA_LOG_INFO("🎧 {} device {} gone{}", AudioDeviceKindName(kind), deviceId, wasActive ? " (in use)" : "");
+                if (wasActive) {
+                    // The SDK already fell back to the system default; see which one that is
+                    m_devicePinned[slot] = false;
+                    std::string active;
+                    if (m_engine->GetAudioDevice(kind, active) == 0) m_deviceRegistry.SetActive(kind, active);
+                }
+            } else {
+                return;
+            }
+
+            ApplyDevicePolicy(kind, at);
+            PublishAudioDevices(kind);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in OnAudioDeviceStateChanged");
+        }
+    }
+
+    bool AgoraCore::EnumerateAudioDevices(AudioDeviceKind kind)
+    {
+        std::vector<AudioDeviceInfo> devices;
+        int result = m_engine->EnumerateAudioDevices(kind, devices);
+        if (result != 0) {
+            AGORA_LOG_ERROR("❌ Failed to enumerate {} devices, error: {}", AudioDeviceKindName(kind), result);
+            return false;
+        }
+        AGORA_LOG_DEBUG("🎧 {} {} devices", devices.size(), AudioDeviceKindName(kind));
+        m_deviceRegistry.SetDevices(kind, std::move(devices));
+
+        std::string active;
+        if (m_engine->GetAudioDevice(kind, active) == 0) m_deviceRegistry.SetActive(kind, active);
+        return true;
+    }
+
+    void AgoraCore::ApplyDevicePolicy(AudioDeviceKind kind, Clock::time_point since)
+    {
+        const size_t slot = static_cast<size_t>(kind);
+        std::string wanted = m_deviceRegistry.Choose(kind);
+
+        // Nothing preferred is plugged in: follow the system default, which is where an unpinned engine already is
+        if (wanted.empty() && !m_devicePinned[slot]) return;
+        if (!wanted.empty() && m_devicePinned[slot] && wanted == m_deviceRegistry.GetActive(kind)) return;
+
+        int result = m_engine->SetAudioDevice(kind, wanted);
+        double switchMs = MillisecondsSince(since);
+        m_metrics.RecordLatency(MetricOp::DeviceSwitch, static_cast<uint64_t>(switchMs * 1000), result == 0);
+        if (result != 0) {
+            AGORA_LOG_ERROR("❌ Failed to switch {} device to {}, error: {}", AudioDeviceKindName(kind),
+                            wanted.empty() ? "the system default" : wanted.c_str(), result);
+            return;
+        }
+
+        m_devicePinned[slot] = !wanted.empty();
+        std::string active = wanted;
+        m_engine->GetAudioDevice(kind, active);
+        m_deviceRegistry.SetActive(kind, active);
+        AGORA_LOG_INFO("✅ {} device now {} ({} ms)", AudioDeviceKindName(kind),
+                       wanted.empty() ? "the system default" : active.c_str(), switchMs);
+    }
+
+    void AgoraCore::PublishAudioDevices(AudioDeviceKind kind)
+    {
+        AudioDeviceList list = m_deviceRegistry.GetList(kind);
+        m_state.Update([&list](AgoraState& state) {
+            (list.kind == AudioDeviceKind::Playback ? state.playbackDevices : state.recordingDevices) = list;
+        });
+        if (IAgoraCoreListener* listener = m_listener.load()) {
+            listener->OnAudioDevicesChanged(list);
+        }
+    }
+
+    void AgoraCore::SetNetworkIdentity(const std::string& networkId)
+    {
+        try {
+            if (networkId == m_networkId) return;
+            AGORA_LOG_INFO("📶 Network now {}", networkId.empty() ? "UNKNOWN" : networkId.c_str());
+
+            m_networkId = networkId;
+            // Whatever was being measured belongs to the old network
+            EndLastmileProbe();
+            // Without an engine the decision waits for the next InitializeEngine
+            if (IsReady()) ResolveLinkProfile(false);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetNetworkIdentity");
+        }
+    }
+
+    void AgoraCore::StartLastmileProbe()
+    {
+        try {
+            AGORA_LOG_INFO("📶 StartLastmileProbe");
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot probe the last mile");
+                return;
+            }
+            if (m_lastmileProbing) {
+                AGORA_LOG_WARN("⚠️ Last-mile probe already running");
+                return;
+            }
+            ResolveLinkProfile(true);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StartLastmileProbe");
+        }
+    }
+
+    void AgoraCore::SetLinkProfileTtl(int minutes)
+    {
+        m_linkCache.SetTtl(static_cast<uint64_t>(std::max(1, minutes)) * 60 * 1000);
+        AGORA_LOG_INFO("📶 Link profiles cached for {} min", std::max(1, minutes));
+    }
+
+    LinkDecision AgoraCore::GetLinkProfile() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.link; });
+    }
+
+    // The probe's own traffic would disturb a call and the SDK only probes outside channels;
+    // the signaling lobby carries no audio and doesn't count
+    bool AgoraCore::InAudioChannel() const
+    {
+        return !GetCurrentChannel().empty() || !m_radioSession.GetChannels().empty() || !m_preparedChannel.empty();
+    }
+
+    void AgoraCore::ResolveLinkProfile(bool forceProbe)
+    {
+        LinkDecision cached;
+        bool fresh = m_linkCache.Lookup(m_networkId, SteadyNowMs(), cached);
+        if (fresh) {
+            m_linkDecision = cached;
+            AGORA_LOG_INFO("♻️ Link profile for {} from cache: {}", m_networkId.empty() ? "UNKNOWN" : m_networkId.c_str(),
+                           LinkTierName(cached.profile.tier));
+        } else if (m_linkDecision.networkId != m_networkId || m_linkDecision.profile.tier != LinkTier::Unknown) {
+            // Not measured here, or too long ago: SDK defaults until the probe says otherwise
+            m_linkDecision = LinkDecision{};
+            m_linkDecision.networkId = m_networkId;
+        }
+
+        bool probe = forceProbe || !fresh;
+        if (!probe) m_lastmileWanted = false; // a put-off probe was for another network
+        if (probe && (InAudioChannel() || IsEchoTestRunning() || m_latencyProbe.IsRunning())) {
+            AGORA_LOG_DEBUG("📶 Last-mile probe put off until the channels are left");
+            m_lastmileWanted = true;
+            PublishLinkProfile();
+            return;
+        }
+
+        if (!InAudioChannel()) ApplyLinkProfile();
+        if (probe && !m_lastmileProbing) BeginLastmileProbe();
+        PublishLinkProfile();
+    }
+
+    void AgoraCore::BeginLastmileProbe()
+    {
+        int result = m_engine->StartLastmileProbe(kLastmileUplinkKbps, kLastmileDownlinkKbps);
+        if (result != 0) {
+            AGORA_LOG_ERROR("❌ Failed to start last-mile probe, error: {}", result);
+            m_metrics.RecordFailure(MetricOp::LastmileProbe);
+            return;
+        }
+
+        m_lastmileProbing = true;
+        m_lastmileWanted = false;
+        m_lastmileStart = Clock::now();
+        uint64_t run = ++m_lastmileRun;
+        AGORA_LOG_INFO("📶 Last-mile probe started");
+
+        m_commandQueue.PostAfter(kLastmileTimeoutMs, Command{ "", [this, run]() {
+            if (run != m_lastmileRun || !m_lastmileProbing) return;
+            AGORA_LOG_WARN("⚠️ No last-mile probe result after {} ms, keeping the {} profile", kLastmileTimeoutMs,
+                           LinkTierName(m_linkDecision.profile.tier));
+            EndLastmileProbe();
+            m_metrics.RecordFailure(MetricOp::LastmileProbe);
+            PublishLinkProfile();
+        }, nullptr });
+    }
+
+    void AgoraCore::ScheduleLastmileRetry()
+    {
+        m_commandQueue.PostAfter(kLastmileIdleMs, Command{ "", [this]() {
+            if (!m_lastmileWanted || !IsReady() || InAudioChannel()) return;
+            ResolveLinkProfile(false);
+        }, nullptr });
+    }
+
+    void AgoraCore::EndLastmileProbe()
+    {
+        if (!m_lastmileProbing) return;
+        m_lastmileProbing = false;
+        ++m_lastmileRun;
+        if (m_engine) m_engine->StopLastmileProbe();
+    }
+
+    void AgoraCore::OnLastmileProbeResult(const LastmileProbeResult& result)
+    {
+        try {
+            if (!m_lastmileProbing) return;
+
+            double probeMs = MillisecondsSince(m_lastmileStart);
+            EndLastmileProbe();
+            bool usable = result.state == LastmileProbeResult::kComplete || result.state == LastmileProbeResult::kIncompleteNoBwe;
+            m_metrics.RecordLatency(MetricOp::LastmileProbe, static_cast<uint64_t>(probeMs * 1000), usable);
+            if (!usable) {
+                AGORA_LOG_WARN("⚠️ Last-mile probe unavailable, keeping the {} profile", LinkTierName(m_linkDecision.profile.tier));
+                PublishLinkProfile();
+                return;
+            }
+
+            m_linkDecision = m_linkCache.Store(m_networkId, result, SteadyNowMs());
+            const AudioLinkProfile& profile = m_linkDecision.profile;
+            AGORA_LOG_INFO("📶 Last mile: rtt {} ms, loss {}%/{}%, jitter {}/{} ms, {}/{} kbps -> {} link",
+                           result.rttMs, result.uplink.packetLossRate, result.downlink.packetLossRate,
+                           result.uplink.jitterMs, result.downlink.jitterMs, result.uplink.availableBandwidthKbps,
+                           result.downlink.availableBandwidthKbps, LinkTierName(profile.tier));
+
+            // A call already under way keeps its settings; the next join picks these up
+            if (!InAudioChannel()) ApplyLinkProfile();
+            PublishLinkProfile();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in OnLastmileProbeResult");
+        }
+    }
+
+    // Joins don't wait for a probe: the cached (or default) profile goes in first
+    void AgoraCore::PrepareLinkForJoin()
+    {
+        if (m_lastmileProbing) {
+            AGORA_LOG_WARN("⚠️ Joining during the last-mile probe - stopping it, {} profile", LinkTierName(m_linkDecision.profile.tier));
+            EndLastmileProbe();
+            m_lastmileWanted = true;
+            PublishLinkProfile();
+        }
+        if (!InAudioChannel()) ApplyLinkProfile();
+    }
+
+    void AgoraCore::ApplyLinkProfile()
+    {
+        const AudioLinkProfile& wanted = m_linkDecision.profile;
+        if (wanted.SameSettings(m_appliedLinkProfile)) return;
+
+        int result = m_engine->SetAudioProfile(wanted.audioProfile);
+        if (result != 0) {
+            AGORA_LOG_ERROR("❌ Failed to set audio profile {}, error: {}", wanted.audioProfile, result);
+            return;
+        }
+        // Bitrate, FEC and jitter buffer are private parameters; a build that doesn't know one
+        // ignores it, the profile above still applies
+        result = m_engine->SetParameters(LinkProfileParameters(wanted));
+        if (result != 0) {
+            AGORA_LOG_WARN("⚠️ Link parameters not taken, error: {}", result);
+        }
+
+        m_appliedLinkProfile = wanted;
+        AGORA_LOG_INFO("📶 {} link profile: audio profile {}, {} kbps, FEC {}, jitter buffer {} ms",
+                       LinkTierName(wanted.tier), wanted.audioProfile, wanted.bitrateKbps, wanted.fec ? "on" : "off",
+                       wanted.jitterBufferMs);
+    }
+
+    void AgoraCore::PublishLinkProfile()
+    {
+        LinkDecision decision = m_linkDecision;
+        bool probing = m_lastmileProbing;
+        m_state.Update([&decision, probing](AgoraState& state) {
+            state.link = decision;
+            state.isLastmileProbing = probing;
+        });
+    }
+
+    void AgoraCore::ArmLatencyProbe(uint64_t run, uint32_t probe)
+    {
+        if (run != m_probeRun || !m_latencyProbe.IsRunning()) return;
+
+        m_latencyProbe.Arm(probe);
+        int windowMs = m_latencyProbe.GetConfig().windowMs;
+        uint64_t deadlineMs = SteadyNowMs() + static_cast<uint64_t>(windowMs + kProbeGraceMs);
+        m_commandQueue.PostAfter(windowMs + kProbeSlackMs, Command{ "", [this, run, probe, deadlineMs]() {
+            CheckLatencyProbe(run, probe, deadlineMs);
+        }, nullptr });
+    }
+
+    void AgoraCore::CheckLatencyProbe(uint64_t run, uint32_t probe, uint64_t deadlineMs)
+    {
+        try {
+            if (run != m_probeRun || !m_latencyProbe.IsRunning()) return;
+
+            bool captured = m_latencyProbe.IsCaptured(probe);
+            if (!captured && SteadyNowMs() < deadlineMs) {
+                m_commandQueue.PostAfter(kProbePollMs, Command{ "", [this, run, probe, deadlineMs]() {
+                    CheckLatencyProbe(run, probe, deadlineMs);
+                }, nullptr });
+                return;
+            }
+
+            // Not captured in time: no frames on one side (devices closed, nobody publishing)
+            const LatencyProbeConfig& config = m_latencyProbe.GetConfig();
+            LatencySample sample = captured ? m_latencyProbe.Analyze(probe) : LatencySample{};
+            MetricOp op = config.path == ProbePath::Channel ? MetricOp::ProbeChannel : MetricOp::ProbeDevice;
+            if (sample.found) {
+                m_metrics.RecordLatency(op, static_cast<uint64_t>(std::max(0.0, sample.latencyMs) * 1000));
+                AGORA_LOG_DEBUG("📏 Probe {}: {} ms (score {})", probe, sample.latencyMs, sample.score);
+            } else {
+                m_metrics.RecordFailure(op);
+                AGORA_LOG_DEBUG("📏 Probe {}: {} (score {})", probe, captured ? "not heard" : "no frames", sample.score);
+            }
+            m_probeReport.samples.push_back(sample);
+
+            if (static_cast<int>(probe) >= config.probes) {
+                FinishLatencyProbe(false);
+                return;
+            }
+            m_commandQueue.PostAfter(config.gapMs, Command{ "", [this, run, probe]() {
+                ArmLatencyProbe(run, probe + 1);
+            }, nullptr });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in CheckLatencyProbe");
+        }
+    }
+
+    void AgoraCore::FinishLatencyProbe(bool cancelled)
+    {
+        m_latencyProbe.Stop();
+        ++m_probeRun;
+        if (m_probeLoopback) {
+            m_probeLoopback = false;
+            StopEchoTest();
+        }
+
+        m_probeReport.cancelled = cancelled;
+        SummarizeLatency(m_probeReport);
+        AGORA_LOG_INFO("📏 Latency probe ({}{}): {}/{} heard, p50 {} ms, p95 {} ms, jitter {} ms",
+                       ProbePathName(m_probeReport.path), cancelled ? ", cancelled" : "", m_probeReport.found,
+                       m_probeReport.probes, m_probeReport.p50Ms, m_probeReport.p95Ms, m_probeReport.jitterMs);
+
+        if (IAgoraCoreListener* listener = m_listener.load()) {
+            listener->OnLatencyProbeFinished(m_probeReport);
+        }
+    }
+
+    void AgoraCore::JoinChannel(const std::string& channelName, bool listenOnly)
+    {
+        ScopedLatency timing(m_metrics, MetricOp::Join);
+        try {
+            AGORA_LOG_INFO("🚀 JoinChannel - {}{}", channelName, listenOnly ? " (listen only)" : "");
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot join channel");
+                timing.Fail();
+                return;
+            }
+
+            // Stop echo test if running (critical requirement)
+            if (IsEchoTestRunning()) {
+                AGORA_LOG_WARN("⚠️ Stopping echo test before joining channel");
+                StopEchoTest();
+            }
+
+            // Leave current channel if in one
+            std::string currentChannel = GetCurrentChannel();
+            if (!currentChannel.empty()) {
+                AGORA_LOG_WARN("⚠️ Already in channel {}, leaving it first", currentChannel);
+                LeaveCurrentChannel();
+                m_state.Update([](AgoraState& state) { state.currentChannel.clear(); });
+            }
+
+            ConnectionOptions options;
+            options.publishMicrophone = true;   // 🎤 PUBLISH YOUR VOICE (app can mute later)
+            options.autoSubscribeAudio = true;  // 👂 HEAR OTHERS
+            options.audience = listenOnly;      // 👂 Listen only: no microphone until keyed up
+
+            PrepareLinkForJoin();
+            ApplyVoiceTuning();
+
+            // New project in testing mode - no token required
+            int result = m_engine->JoinChannel(channelName, 0, options);
+
+            if (result == 0) {
+                m_state.Update([&channelName, listenOnly](AgoraState& state) {
+                    state.currentChannel = channelName;
+                    state.isListenOnly = listenOnly;
+                    state.isLocalAudioMuted = listenOnly;  // Talkers start unmuted, app will mute if needed
+                });
+                m_connectionMonitor.Track("");
+                SyncFloorChannels();
+                AGORA_LOG_INFO("✅ Join initiated for {}, waiting for onJoinChannelSuccess", channelName);
+            } else {
+                // -2 invalid channel name, -7 SDK not initialized, -8 echo test running, -17 already in channel
+                AGORA_LOG_ERROR("💥 Failed to join channel {}, error: {}", channelName, result);
+                timing.Fail();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("💥 Exception in JoinChannel");
+            timing.Fail();
+        }
+    }
+
+    void AgoraCore::LeaveChannel()
+    {
+        try {
+            if (!m_engine || GetCurrentChannel().empty()) return;
+
+            ScopedLatency timing(m_metrics, MetricOp::Leave);
+            LeaveCurrentChannel();
+            m_state.Update([](AgoraState& state) {
+                state.currentChannel.clear();
+                state.isListenOnly = false;
+                state.isLocalAudioMuted = false;  // Reset mute state when leaving channel
+            });
+            SyncFloorChannels();
+            AGORA_LOG_INFO("✅ Left channel, mute state reset to unmuted");
+            if (m_lastmileWanted) ScheduleLastmileRetry();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in LeaveChannel");
+            m_metrics.RecordFailure(MetricOp::Leave);
+        }
+    }
+
+    // An accepted private call may live on a prepared Ex connection rather than the default channel
+    void AgoraCore::LeaveCurrentChannel()
+    {
+        if (!m_callConnection.empty() && m_callConnection == GetCurrentChannel()) {
+            LeaveConnection(m_callConnection);
+            m_connectionMonitor.Forget(m_callConnection);
+            m_callConnection.clear();
+        } else {
+            m_engine->LeaveChannel();
+            m_connectionMonitor.Forget("");
+        }
+        m_pendingAccept.clear();
+    }
+
+    void AgoraCore::PrepareChannel(const std::string& channelName)
+    {
+        try {
+            AGORA_LOG_INFO("🔥 PrepareChannel - {}", channelName);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot prepare channel");
+                return;
+            }
+            if (channelName == m_preparedChannel || channelName == GetCurrentChannel()) return;
+            if (!m_preparedChannel.empty()) {
+                ReleasePreparedChannel(m_preparedChannel);
+            }
+
+            auto start = Clock::now();
+
+            // Joined, but neither sending nor receiving until AcceptCall
+            ConnectionOptions options;
+            options.publishMicrophone = false;
+            options.autoSubscribeAudio = false;
+
+            PrepareLinkForJoin();
+            int result = m_engine->JoinConnection(channelName, m_localUid, options, &GetConnectionHandler(channelName));
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to prepare channel {}, error: {}", channelName, result);
+                return;
+            }
+
+            m_preparedChannel = channelName;
+            m_preparedJoined = false;
+            double prepareMs = MillisecondsSince(start);
+            m_state.Update([&channelName, prepareMs](AgoraState& state) {
+                state.preparedChannel = channelName;
+                state.callLatency.prepareMs = prepareMs;
+            });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in PrepareChannel");
+        }
+    }
+
+    void AgoraCore::ReleasePreparedChannel(const std::string& channelName)
+    {
+        try {
+            if (!m_engine || channelName.empty() || channelName != m_preparedChannel) return;
+
+            AGORA_LOG_INFO("🧊 ReleasePreparedChannel - {}", channelName);
+            LeaveConnection(channelName);
+            m_preparedChannel.clear();
+            m_preparedJoined = false;
+            m_state.Update([](AgoraState& state) { state.preparedChannel.clear(); });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ReleasePreparedChannel");
+        }
+    }
+
+    void AgoraCore::AcceptCall(const std::string& channelName)
+    {
+        try {
+            auto start = Clock::now();
+            bool warm = !channelName.empty() && channelName == m_preparedChannel;
+            AGORA_LOG_INFO("📞 AcceptCall - {} ({})", channelName, warm ? "warm" : "cold");
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot accept call");
+                return;
+            }
+
+            if (!warm) {
+                // Nothing prepared: the full join is on the critical path
+                JoinChannel(channelName);
+                if (GetCurrentChannel() == channelName) {
+                    m_pendingAccept = channelName;
+                    m_pendingAcceptWarm = false;
+                    m_acceptStart = start;
+                    m_acceptJoinCallMs = MillisecondsSince(start);
+                }
+                return;
+            }
+
+            if (IsEchoTestRunning()) {
+                StopEchoTest();
+            }
+            std::string currentChannel = GetCurrentChannel();
+            if (!currentChannel.empty()) {
+                AGORA_LOG_WARN("⚠️ Already in channel {}, leaving it first", currentChannel);
+                LeaveCurrentChannel();
+            }
+
+            ConnectionOptions options;
+            options.publishMicrophone = true;
+            options.autoSubscribeAudio = true;
+
+            ApplyVoiceTuning();
+            int result = m_engine->UpdateConnection(channelName, m_localUid, options);
+            if (result != 0) {
+                AGORA_LOG_ERROR("💥 Failed to switch prepared channel {} to publishing, error: {}", channelName, result);
+                return;
+            }
+            if (m_voxMode && !m_voxTalking) {
+                m_engine->MuteConnectionAudio(channelName, m_localUid, true);
+            }
+
+            bool joined = m_preparedJoined;
+            m_callConnection = channelName;
+            m_connectionMonitor.Track(channelName, joined ? ConnectionState::Connected : ConnectionState::Connecting);
+            m_preparedChannel.clear();
+            m_preparedJoined = false;
+            m_state.Update([&channelName](AgoraState& state) {
+                state.currentChannel = channelName;
+                state.preparedChannel.clear();
+                state.isLocalAudioMuted = false;
+            });
+
+            if (joined) {
+                FinishAccept(channelName, true, MillisecondsSince(start));
+            } else {
+                // Answered before the prepared join completed; the rest arrives with onJoinChannelSuccess
+                m_pendingAccept = channelName;
+                m_pendingAcceptWarm = true;
+                m_acceptStart = start;
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("💥 Exception in AcceptCall");
+        }
+    }
+
+    void AgoraCore::OnJoinSucceeded(const std::string& channelName, int elapsedMs)
+    {
+        if (channelName == m_preparedChannel) {
+            m_preparedJoined = true;
+        }
+        if (!m_signalingChannel.empty() && channelName == m_signalingChannel) {
+            OnSignalingJoined();
+            return;
+        }
+        if (m_pendingAccept.empty() || channelName != m_pendingAccept) return;
+
+        // Cold: our joinChannel call plus the SDK's own join time (elapsed is measured from that call)
+        double acceptMs = m_pendingAcceptWarm ? MillisecondsSince(m_acceptStart) : m_acceptJoinCallMs + elapsedMs;
+        FinishAccept(channelName, m_pendingAcceptWarm, acceptMs);
+        m_pendingAccept.clear();
+    }
+
+    void AgoraCore::FinishAccept(const std::string& channelName, bool warm, double acceptMs)
+    {
+        m_metrics.RecordLatency(MetricOp::AcceptCall, static_cast<uint64_t>(acceptMs * 1000));
+        m_state.Update([&channelName, warm, acceptMs](AgoraState& state) {
+            state.callLatency.acceptMs = acceptMs;
+            state.callLatency.acceptWarm = warm;
+            state.callLatency.acceptChannel = channelName;
+        });
+        AGORA_LOG_INFO("⏱️ Call {} ready {} ms after accept ({})", channelName, acceptMs, warm ? "warm" : "cold");
+
+        if (IAgoraCoreListener* listener = m_listener.load()) {
+            listener->OnCallLatency(channelName, warm, acceptMs);
+        }
+    }
+
+    CallLatency AgoraCore::GetCallLatency() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.callLatency; });
+    }
+
+    void AgoraCore::SetListenOnly(bool listenOnly)
+    {
+        try {
+            AGORA_LOG_INFO("👂 SetListenOnly - {}", listenOnly);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            // Mute before dropping the broadcaster role, so leaving listen-only starts muted too
+            int result = MuteUplink(true);
+            if (result == 0) result = SetDefaultChannelAudience(listenOnly);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to switch listen-only mode, error: {}", result);
+                return;
+            }
+            m_state.Update([listenOnly](AgoraState& state) {
+                state.isListenOnly = listenOnly;
+                state.isLocalAudioMuted = true;
+            });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetListenOnly");
+        }
+    }
+
+    // Role switch on the default channel only; radios and accepted calls manage their own
+    int AgoraCore::SetDefaultChannelAudience(bool audience)
+    {
+        std::string currentChannel = GetCurrentChannel();
+        if (currentChannel.empty() || currentChannel == m_callConnection) return 0;
+
+        ConnectionOptions options;
+        options.publishMicrophone = true;
+        options.autoSubscribeAudio = true;
+        options.audience = audience;
+        return m_engine->UpdateChannel(options);
+    }
+
+    void AgoraCore::MuteLocalAudio(bool mute)
+    {
+        ScopedLatency timing(m_metrics, MetricOp::Mute);
+        try {
+            AGORA_LOG_DEBUG("🎤 MuteLocalAudio - mute {}", mute);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                timing.Fail();
+                return;
+            }
+            if (!mute && TalkNeedsFloor()) {
+                AGORA_LOG_WARN("🚦 {} has floor control - key up with RequestFloor", TalkTarget());
+                timing.Fail();
+                return;
+            }
+
+            // Listen only: key up becomes a broadcaster before unmuting, key down mutes first
+            bool listenOnly = m_state.Read([](const AgoraState& state) { return state.isListenOnly; });
+            int result = 0;
+            if (listenOnly && !mute) result = SetDefaultChannelAudience(false);
+
+            // In VOX mode an unmute only takes effect while the gate is open
+            if (result == 0) result = MuteUplink(mute || !m_voxTalking);
+            if (result == 0 && listenOnly && mute) result = SetDefaultChannelAudience(true);
+            if (result == 0) {
+                bool wasMuted = IsLocalAudioMuted();
+                m_state.Update([mute](AgoraState& state) { state.isLocalAudioMuted = mute; });
+                if (wasMuted != mute && m_tones.GetConfig().talkChirps) {
+                    m_tones.Play(mute ? ToneCue::TalkEnd : ToneCue::TalkStart);
+                }
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to mute/unmute, error: {}", result);
+                timing.Fail();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in MuteLocalAudio");
+            timing.Fail();
+        }
+    }
+
+    void AgoraCore::EnableLocalAudio(bool enabled)
+    {
+        try {
+            AGORA_LOG_DEBUG("🎤 EnableLocalAudio - enabled {}", enabled);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int result = m_engine->EnableLocalAudio(enabled);
+            if (result == 0) {
+                m_state.Update([enabled](AgoraState& state) { state.isLocalAudioEnabled = enabled; });
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to enable/disable audio, error: {}", result);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in EnableLocalAudio");
+        }
+    }
+
+    void AgoraCore::AdjustRecordingVolume(int volume)
+    {
+        try {
+            AGORA_LOG_DEBUG("🔊 AdjustRecordingVolume - {}", volume);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int clampedVolume = std::max(0, std::min(400, volume));
+            int result = m_engine->SetRecordingVolume(clampedVolume);
+            if (result == 0) {
+                m_recordingVolume = clampedVolume;
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to adjust recording volume, error: {}", result);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in AdjustRecordingVolume");
+        }
+    }
+
+    // Playback volume for all remote users
+    void AgoraCore::AdjustPlaybackVolume(int volume)
+    {
+        try {
+            AGORA_LOG_DEBUG("🔊 AdjustPlaybackVolume - {}", volume);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int clampedVolume = std::max(0, std::min(400, volume));
+            int result = m_engine->SetPlaybackVolume(clampedVolume);
+            if (result == 0) {
+                m_playbackVolume = clampedVolume;
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to adjust playback volume, error: {}", result);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in AdjustPlaybackVolume");
+        }
+    }
+
+    void AgoraCore::SetClientRole(int role)
+    {
+        try {
+            AGORA_LOG_DEBUG("👤 SetClientRole - {}", role);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int result = m_engine->SetClientRole(role);
+            if (result == 0) {
+                m_clientRole = role;
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to set client role, error: {}", result);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetClientRole");
+        }
+    }
+
+    void AgoraCore::EnableNoiseSuppressionMode(bool enabled, int mode)
+    {
+        try {
+            AGORA_LOG_DEBUG("🤖 EnableNoiseSuppressionMode - enabled {}, mode {}", enabled, mode);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int applied = AppliedNoiseSuppressionMode(mode);
+            int result = m_engine->SetNoiseSuppression(enabled, applied);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to set noise suppression, error: {}", result);
+                return;
+            }
+            m_state.Update([enabled, applied](AgoraState& state) { state.noiseSuppressionMode = enabled ? applied : -1; });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in EnableNoiseSuppressionMode");
+        }
+    }
+
+    void AgoraCore::SetAudioScenario(int scenario)
+    {
+        try {
+            AGORA_LOG_DEBUG("🎵 SetAudioScenario - {}", scenario);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            int applied = AppliedScenario(scenario);
+            int result = m_engine->SetAudioScenario(applied);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to set audio scenario, error: {}", result);
+                return;
+            }
+            m_state.Update([applied](AgoraState& state) { state.audioScenario = applied; });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetAudioScenario");
+        }
+    }
+
+    AudioStateReport AgoraCore::ApplyAudioState(const DesiredAudioState& desired)
+    {
+        AudioStateReport report;
+        try {
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot apply audio state");
+                return report;
+            }
+            report.ready = true;
+
+            // Compare what the setters would actually apply, so a repeat is a no-op
+            DesiredAudioState target = desired;
+            if (target.scenario) target.scenario = AppliedScenario(*target.scenario);
+            if (target.noiseSuppressionMode && *target.noiseSuppressionMode >= 0) {
+                target.noiseSuppressionMode = AppliedNoiseSuppressionMode(*target.noiseSuppressionMode);
+            } else if (target.noiseSuppressionMode) {
+                target.noiseSuppressionMode = -1;
+            }
+            if (target.recordingVolume) target.recordingVolume = std::max(0, std::min(400, *target.recordingVolume));
+            if (target.playbackVolume) target.playbackVolume = std::max(0, std::min(400, *target.playbackVolume));
+
+            AudioPlan plan = PlanAudioState(CaptureAudioState(), target);
+            AGORA_LOG_INFO("🧭 ApplyAudioState - {} step(s), {} already in place", plan.actions.size(), plan.unchanged);
+            for (const AudioAction& action : plan.actions) RunAudioAction(action);
+
+            report.applied = std::move(plan.actions);
+            report.unchanged = plan.unchanged;
+            // Whatever still differs did not take: a refused join, the floor holding the key-up
+            report.pending = PlanAudioState(CaptureAudioState(), target).actions;
+            if (!report.pending.empty()) {
+                AGORA_LOG_WARN("⚠️ ApplyAudioState - {} step(s) did not take, first: {}", report.pending.size(),
+                               AudioStepName(report.pending.front().step));
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ApplyAudioState");
+        }
+        return report;
+    }
+
+    CurrentAudioState AgoraCore::CaptureAudioState() const
+    {
+        CurrentAudioState current = m_state.Read([](const AgoraState& state) {
+            CurrentAudioState snapshot;
+            snapshot.channel = state.currentChannel;
+            snapshot.listenOnly = state.isListenOnly;
+            snapshot.radios = state.radioChannels;
+            snapshot.talkChannel = state.talkChannel;
+            snapshot.muted = state.isLocalAudioMuted;
+            snapshot.localAudioEnabled = state.isLocalAudioEnabled;
+            snapshot.noiseSuppressionMode = state.noiseSuppressionMode;
+            snapshot.scenario = state.audioScenario;
+            return snapshot;
+        });
+        current.recordingVolume = m_recordingVolume;
+        current.playbackVolume = m_playbackVolume;
+        current.clientRole = m_clientRole;
+        return current;
+    }
+
+    // The same methods the bridge calls one by one, so every rule they enforce still holds
+    void AgoraCore::RunAudioAction(const AudioAction& action)
+    {
+        AGORA_LOG_DEBUG("🧭 {} {} {}", AudioStepName(action.step), action.channel, action.value);
+        switch (action.step) {
+            case AudioStep::Mute: MuteLocalAudio(action.value != 0); break;
+            case AudioStep::SetScenario: SetAudioScenario(action.value); break;
+            case AudioStep::SetNoiseSuppression: EnableNoiseSuppressionMode(action.value >= 0, action.value); break;
+            case AudioStep::LeaveRadio: LeaveRadioChannel(action.channel); break;
+            case AudioStep::LeaveChannel: LeaveChannel(); break;
+            case AudioStep::JoinChannel: JoinChannel(action.channel, action.value != 0); break;
+            case AudioStep::JoinRadio: JoinRadioChannel(action.channel, action.value != 0); break;
+            case AudioStep::SetTalkChannel: SetTalkChannel(action.channel); break;
+            case AudioStep::SetListenOnly: SetListenOnly(action.value != 0); break;
+            case AudioStep::SetClientRole: SetClientRole(action.value); break;
+            case AudioStep::EnableLocalAudio: EnableLocalAudio(action.value != 0); break;
+            case AudioStep::RecordingVolume: AdjustRecordingVolume(action.value); break;
+            case AudioStep::PlaybackVolume: AdjustPlaybackVolume(action.value); break;
+        }
+    }
+
+    void AgoraCore::ConfigureAudioProcessing(const AudioPipelineConfig& capture, const AudioPipelineConfig& playback)
+    {
+        try {
+            AGORA_LOG_INFO("🎛️ ConfigureAudioProcessing - enabled {}, gain {} dB, high-pass {} Hz, limiter {} dB, vox {}",
+                           capture.enabled, capture.gainDb, capture.highPassHz, capture.limiterThresholdDb, capture.voxEnabled);
+
+            // Pipelines pick the new settings up at their next frame, no need to touch the engine
+            m_capturePipeline.SetConfig(capture);
+            m_playbackPipeline.SetConfig(playback);
+
+            if (m_voxMode != capture.voxEnabled) {
+                m_voxMode = capture.voxEnabled;
+                ApplyVoxTransition(!m_voxMode || IsVoxGateOpen());
+            }
+
+            if (m_audioProcessingEnabled != capture.enabled) {
+                m_audioProcessingEnabled = capture.enabled;
+                if (IsReady()) ApplyVoiceTuning();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ConfigureAudioProcessing");
+        }
+    }
+
+    void AgoraCore::ConfigureRadioMixer(const RadioMixerConfig& settings)
+    {
+        try {
+            AGORA_LOG_INFO("🎚️ ConfigureRadioMixer - enabled {}, duck {} dB, hold {} ms, ramp {} ms",
+                           settings.enabled, settings.duckDb, settings.duckHoldMs, settings.rampMs);
+
+            // The mixer picks it up at its next frame; the per-radio settings stay
+            RadioMixerConfig config = m_radioMixer.GetConfig();
+            config.enabled = settings.enabled;
+            config.duckDb = settings.duckDb;
+            config.activityDb = settings.activityDb;
+            config.duckHoldMs = settings.duckHoldMs;
+            config.rampMs = settings.rampMs;
+            m_radioMixer.SetConfig(config);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ConfigureRadioMixer");
+        }
+    }
+
+    void AgoraCore::SetRadioMix(const std::string& channelName, float gainDb, float pan, int priority)
+    {
+        try {
+            AGORA_LOG_INFO("🎚️ SetRadioMix - {}: gain {} dB, pan {}, priority {}", channelName, gainDb, pan, priority);
+            if (channelName.empty()) {
+                AGORA_LOG_ERROR("❌ Radio mix needs a channel name");
+                return;
+            }
+
+            RadioMix mix;
+            mix.channelName = channelName;
+            mix.gainDb = gainDb;
+            mix.pan = pan;
+            mix.priority = priority;
+            m_radioMixer.SetMix(mix);
+            if (!m_radioMixer.GetConfig().enabled) {
+                AGORA_LOG_DEBUG("🎚️ Radio mixer off - {} takes effect once it is enabled", channelName);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetRadioMix");
+        }
+    }
+
+    void AgoraCore::SetUserMix(const std::string& channelName, uint32_t uid, float gainDb, float pan)
+    {
+        try {
+            AGORA_LOG_INFO("🎚️ SetUserMix - {} uid {}: gain {} dB, pan {}", channelName, uid, gainDb, pan);
+            if (channelName.empty() || uid == 0) {
+                AGORA_LOG_ERROR("❌ User mix needs a channel name and a uid");
+                return;
+            }
+
+            RadioMix mix;
+            mix.channelName = channelName;
+            mix.uid = uid;
+            mix.gainDb = gainDb;
+            mix.pan = pan;
+            m_radioMixer.SetMix(mix);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetUserMix");
+        }
+    }
+
+    void AgoraCore::ConfigureLoudness(const LoudnessConfig& settings)
+    {
+        try {
+            AGORA_LOG_INFO("🔊 ConfigureLoudness - enabled {}, target {} LUFS, boost {} dB, cut {} dB, attack {} ms, release {} ms",
+                           settings.enabled, settings.targetLufs, settings.maxBoostDb, settings.maxCutDb,
+                           settings.attackMs, settings.releaseMs);
+            m_loudness.SetConfig(settings);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ConfigureLoudness");
+        }
+    }
+
+    void AgoraCore::ConfigureTones(const ToneConfig& settings)
+    {
+        try {
+            AGORA_LOG_INFO("🔔 ConfigureTones - level {} dBFS, talk chirps {}", settings.levelDb, settings.talkChirps);
+            m_tones.SetConfig(settings);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ConfigureTones");
+        }
+    }
+
+    std::vector<LoudnessStats> AgoraCore::GetLoudnessStats() const
+    {
+        std::vector<LoudnessStats> stats = m_loudness.GetStats();
+        if (stats.empty()) return stats;
+
+        // The leveller only keeps a hash of each channel; match it against the ones we are in
+        std::vector<std::string> channels = m_state.Read([](const AgoraState& state) {
+            std::vector<std::string> names = state.radioChannels;
+            if (!state.currentChannel.empty()) names.push_back(state.currentChannel);
+            return names;
+        });
+        for (auto& entry : stats) {
+            for (const auto& channel : channels) {
+                if (LoudnessNormalizer::ChannelKey(channel.c_str()) == entry.channelKey) {
+                    entry.channelName = channel;
+                    break;
+                }
+            }
+        }
+        return stats;
+    }
+
+    bool AgoraCore::IsVoxGateOpen() const
+    {
+        return m_capturePipeline.IsGateOpen();
+    }
+
+    void AgoraCore::SetVoxMode(bool enabled)
+    {
+        try {
+            AGORA_LOG_INFO("🗣️ SetVoxMode - enabled {}", enabled);
+
+            auto config = m_capturePipeline.GetConfig();
+            config.voxEnabled = enabled;
+            m_capturePipeline.SetConfig(config);
+
+            m_voxMode = enabled;
+            // Start from the gate's current state; later changes arrive as transitions
+            ApplyVoxTransition(!enabled || IsVoxGateOpen());
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetVoxMode");
+        }
+    }
+
+    // Audio thread: hand the transition to the event flusher, never call the engine from here
+    void AgoraCore::OnVoxGateChanged(void* context, bool open)
+    {
+        AgoraEvent event;
+        event.type = AgoraEventType::TalkStateChanged;
+        event.value = open ? 1 : 0;
+        static_cast<AgoraCore*>(context)->m_eventBatcher.Push(event);
+    }
+
+    void AgoraCore::ApplyVoxTransition(bool talking)
+    {
+        talking = talking || !m_voxMode;
+        if (talking == m_voxTalking) return;
+        m_voxTalking = talking;
+
+        if (IsReady() && !IsLocalAudioMuted()) {
+            int result = MuteUplink(!talking);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ VOX failed to {} uplink, error: {}", talking ? "open" : "close", result);
+            }
+        }
+        AGORA_LOG_DEBUG("🗣️ VOX {}", talking ? "talking" : "quiet");
+
+        if (IAgoraCoreListener* listener = m_listener.load()) {
+            listener->OnTalkStateChanged(talking, m_voxMode);
+        }
+    }
+
+    // Mutes the default channel plus the talk radio's and an accepted call's connections
+    int AgoraCore::MuteUplink(bool mute)
+    {
+        int result = m_engine->MuteLocalAudio(mute);
+
+        for (const std::string& channelName : { m_radioSession.GetTalkChannel(), m_callConnection }) {
+            if (channelName.empty()) continue;
+            int exResult = m_engine->MuteConnectionAudio(channelName, m_localUid, mute);
+            if (result == 0) result = exResult;
+        }
+        return result;
+    }
+
+    bool AgoraCore::IsLocalAudioMuted() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.isLocalAudioMuted; });
+    }
+
+    bool AgoraCore::IsReady() const
+    {
+        return m_engine && m_state.Read([](const AgoraState& state) { return state.isInitialized; });
+    }
+
+    bool AgoraCore::IsEchoTestRunning() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.isEchoTestRunning; });
+    }
+
+    std::string AgoraCore::GetCurrentChannel() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.currentChannel; });
+    }
+
+    void AgoraCore::PublishRadioState()
+    {
+        auto radioChannels = m_radioSession.GetChannels();
+        auto talkChannel = m_radioSession.GetTalkChannel();
+        m_state.Update([&](AgoraState& state) {
+            state.radioChannels = std::move(radioChannels);
+            state.talkChannel = std::move(talkChannel);
+        });
+    }
+
+    void AgoraCore::MuteRemoteAudioStream(unsigned int uid, bool mute)
+    {
+        try {
+            AGORA_LOG_DEBUG("🔊 MuteRemoteAudioStream - uid {}, mute {}", uid, mute);
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+            int result = m_engine->MuteRemoteAudio(uid, mute);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to mute/unmute remote audio for uid {}, error: {}", uid, result);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in MuteRemoteAudioStream");
+        }
+    }
+
+    void AgoraCore::RegisterAudioProcessors()
+    {
+        int result = m_engine->SetAudioProcessors(&m_capturePipeline, &m_playbackPipeline, &m_radioMixer);
+        if (result != 0) {
+            AGORA_LOG_ERROR("❌ Audio frame hook unavailable - native audio processing disabled, error: {}", result);
+            return;
+        }
+        AGORA_LOG_INFO("🎛️ Audio processors registered ({} kernels)", DspIsaName(m_capturePipeline.GetIsa()));
+    }
+
+    void AgoraCore::ApplyVoiceTuning()
+    {
+        if (m_audioProcessingEnabled) {
+            // Gain and high-pass run in our own pipeline; keep the SDK stages neutral so they don't stack
+            m_engine->SetRecordingVolume(100);
+            m_engine->SetVoiceEqualization(kEqBand125, 0);
+            m_engine->SetVoiceEqualization(kEqBand250, 0);
+            AGORA_LOG_DEBUG("🎚️ Voice tuning handled by native pipeline");
+        } else {
+            // Set recording volume to optimal level (reduce background noise pickup)
+            m_engine->SetRecordingVolume(80); // Slightly reduce from default 100
+
+            // Enable local voice effects for cleaner sound (reduce low frequency noise)
+            m_engine->SetVoiceEqualization(kEqBand125, -15);
+            m_engine->SetVoiceEqualization(kEqBand250, -10);
+            AGORA_LOG_DEBUG("🎚️ Voice tuning applied (recording volume 80, -15 dB @125 Hz, -10 dB @250 Hz)");
+        }
+
+        // A volume the app set wins over the tuning's, so m_recordingVolume stays what the engine has
+        if (m_recordingVolume >= 0) m_engine->SetRecordingVolume(m_recordingVolume);
+    }
+
+    int AgoraCore::JoinConnection(const std::string& channelName, bool publishMicrophone)
+    {
+        ConnectionOptions options;
+        options.publishMicrophone = publishMicrophone; // 🎤 Only the talk radio publishes
+        options.autoSubscribeAudio = true;
+        options.audience = !publishMicrophone;         // 👂 the rest just listen
+
+        int result = m_engine->JoinConnection(channelName, m_localUid, options, &GetConnectionHandler(channelName));
+        if (result == 0 && m_volumeIntervalMs > 0) {
+            m_engine->EnableConnectionVolumeIndication(channelName, m_localUid, m_volumeIntervalMs, m_volumeSmooth);
+        }
+        return result;
+    }
+
+    // Handlers must outlive the connection (leave callbacks arrive later), so they are kept until release
+    AgoraEventHandler& AgoraCore::GetConnectionHandler(const std::string& channelName)
+    {
+        auto& handler = m_connectionHandlers[channelName];
+        if (!handler) {
+            handler = std::make_unique<AgoraEventHandler>();
+            handler->SetChannelName(channelName);
+            handler->SetEventBatcher(&m_eventBatcher);
+            AttachChannelSlots(*handler, channelName);
+        }
+        return *handler;
+    }
+
+    int AgoraCore::UpdateConnection(const std::string& channelName, bool publishMicrophone)
+    {
+        ConnectionOptions options;
+        options.publishMicrophone = publishMicrophone;
+        options.autoSubscribeAudio = true;
+        options.audience = !publishMicrophone;
+
+        return m_engine->UpdateConnection(channelName, m_localUid, options);
+    }
+
+    int AgoraCore::LeaveConnection(const std::string& channelName)
+    {
+        return m_engine->LeaveConnection(channelName, m_localUid);
+    }
+
+    void AgoraCore::JoinRadioChannel(const std::string& channelName, bool talk)
+    {
+        ScopedLatency timing(m_metrics, MetricOp::RadioJoin);
+        try {
+            AGORA_LOG_INFO("📻 JoinRadioChannel - {}, talk {}", channelName, talk);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                timing.Fail();
+                return;
+            }
+
+            if (IsEchoTestRunning()) {
+                AGORA_LOG_WARN("⚠️ Stopping echo test before joining radio");
+                StopEchoTest();
+            }
+
+            // Tuning is engine-wide, apply it once for the first radio
+            if (m_radioSession.GetConnectionCount() == 0) {
+                PrepareLinkForJoin();
+                ApplyVoiceTuning();
+            }
+
+            int result = m_radioSession.Join(channelName, talk);
+            PublishRadioState();
+            if (result == 0) {
+                AGORA_LOG_INFO("✅ Monitoring {} radio(s)", m_radioSession.GetConnectionCount());
+                StartReplayRing(channelName);
+                if (!m_connectionMonitor.IsTracked(channelName)) m_connectionMonitor.Track(channelName);
+                SyncFloorChannels();
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to join radio channel {}, error: {}", channelName, result);
+                timing.Fail();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in JoinRadioChannel");
+            timing.Fail();
+        }
+    }
+
+    void AgoraCore::LeaveRadioChannel(const std::string& channelName)
+    {
+        try {
+            if (!m_engine) return;
+
+            ScopedLatency timing(m_metrics, MetricOp::RadioLeave);
+            int result = m_radioSession.Leave(channelName);
+            PublishRadioState();
+            m_replayRecorder.Remove(channelName);
+            m_connectionMonitor.Forget(channelName);
+            SyncFloorChannels();
+            if (result == 0) {
+                AGORA_LOG_INFO("✅ Left radio channel {}", channelName);
+                if (m_lastmileWanted) ScheduleLastmileRetry();
+            } else {
+                AGORA_LOG_ERROR("❌ Failed to leave radio channel {}, error: {}", channelName, result);
+                timing.Fail();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in LeaveRadioChannel");
+            m_metrics.RecordFailure(MetricOp::RadioLeave);
+        }
+    }
+
+    void AgoraCore::SetTalkChannel(const std::string& channelName)
+    {
+        ScopedLatency timing(m_metrics, MetricOp::TalkSwitch);
+        try {
+            AGORA_LOG_INFO("🎙️ SetTalkChannel - {}", channelName.empty() ? "NONE" : channelName.c_str());
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                timing.Fail();
+                return;
+            }
+
+            // Publish switch only - every monitored radio stays connected
+            int result = m_radioSession.SetTalkChannel(channelName);
+            PublishRadioState();
+            EnforceFloor(); // the new talk radio may be someone else's floor
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to switch talk channel, error: {}", result);
+                timing.Fail();
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetTalkChannel");
+            timing.Fail();
+        }
+    }
+
+    void AgoraCore::SetListener(IAgoraCoreListener* listener)
+    {
+        m_listener.store(listener);
+        if (!listener) return;
+
+        m_eventBatcher.Start([this](const std::vector<AgoraEvent>& events, const EventBatchStats& stats) {
+            // Only the last VOX transition in a batch matters; mute/unmute runs on the worker
+            for (auto it = events.rbegin(); it != events.rend(); ++it) {
+                if (it->type == AgoraEventType::TalkStateChanged) {
+                    bool talking = it->value != 0;
+                    Post(Command{ "VoxTransition", [this, talking]() { ApplyVoxTransition(talking); }, nullptr });
+                    break;
+                }
+            }
+            // Joins complete prepared connections and close out accept timings; connection
+            // events drive recovery. Posted in callback order, the monitor depends on it.
+            for (const auto& event : events) {
+                if (event.type == AgoraEventType::JoinChannelSuccess) {
+                    std::string channelName = event.channel;
+                    int elapsedMs = event.value;
+                    Post(Command{ "", [this, channelName, elapsedMs]() { OnJoinSucceeded(channelName, elapsedMs); }, nullptr });
+                } else if (event.type == AgoraEventType::ConnectionStateChanged || event.type == AgoraEventType::ConnectionLost ||
+                           event.type == AgoraEventType::RejoinChannelSuccess) {
+                    Post(Command{ "", [this, event]() { OnConnectionEvent(event); }, nullptr });
+                }
+            }
+            if (IAgoraCoreListener* current = m_listener.load()) {
+                current->OnEventBatch(events, stats);
+            }
+        });
+    }
+
+    void AgoraCore::SetEventFlushInterval(int intervalMs)
+    {
+        m_eventBatcher.SetFlushInterval(intervalMs);
+    }
+
+    void AgoraCore::SetReconnectPolicy(const ReconnectPolicy& policy)
+    {
+        try {
+            AGORA_LOG_INFO("🔄 SetReconnectPolicy - base {} ms, max {} ms, jitter {}, max attempts {}",
+                           policy.baseDelayMs, policy.maxDelayMs, policy.jitter, policy.maxAttempts);
+            m_connectionMonitor.SetPolicy(policy);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetReconnectPolicy");
+        }
+    }
+
+    void AgoraCore::OnConnectionEvent(const AgoraEvent& event)
+    {
+        try {
+            std::string key = event.channel;
+            uint64_t nowMs = SteadyNowMs();
+            ConnectionTransition transition;
+            switch (event.type) {
+                case AgoraEventType::ConnectionStateChanged:
+                    transition = m_connectionMonitor.OnStateChanged(key, event.value, static_cast<int>(event.uid), nowMs);
+                    break;
+                case AgoraEventType::ConnectionLost:
+                    transition = m_connectionMonitor.OnConnectionLost(key, nowMs);
+                    break;
+                case AgoraEventType::RejoinChannelSuccess:
+                    transition = m_connectionMonitor.OnRejoined(key, nowMs);
+                    break;
+                default:
+                    return;
+            }
+            ApplyConnectionTransition(key, transition);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in OnConnectionEvent");
+        }
+    }
+
+    void AgoraCore::ApplyConnectionTransition(const std::string& key, const ConnectionTransition& transition)
+    {
+        std::string channelName = ConnectionChannelName(key);
+
+        if (transition.restore) {
+            AGORA_LOG_INFO("✅ {} back after {} ms, restoring session state", channelName, transition.outageMs);
+            m_metrics.RecordLatency(MetricOp::Reconnect, transition.outageMs * 1000);
+            RestoreSession(key);
+        }
+
+        if (transition.retry) {
+            AGORA_LOG_WARN("🔄 {} down (reason {}), rejoin {} in {} ms", channelName, transition.reason,
+                           transition.attempt, transition.retryDelayMs);
+            uint64_t generation = transition.generation;
+            m_commandQueue.PostAfter(transition.retryDelayMs,
+                Command{ "", [this, key, generation]() { RetryConnection(key, generation); }, nullptr });
+        } else if (transition.notify && transition.state == ConnectionState::Failed) {
+            AGORA_LOG_ERROR("❌ {} failed for good (reason {}), giving up", channelName, transition.reason);
+            m_metrics.RecordFailure(MetricOp::Reconnect);
+        }
+
+        if (!transition.notify) return;
+        if (IAgoraCoreListener* listener = m_listener.load()) {
+            listener->OnConnectionStateChanged(channelName, transition);
+        }
+    }
+
+    void AgoraCore::RetryConnection(const std::string& key, uint64_t generation)
+    {
+        try {
+            // Left, reconnected by the SDK or superseded by a newer failure since this was scheduled
+            if (!IsReady() || !m_connectionMonitor.BeginRetry(key, generation)) return;
+
+            AGORA_LOG_INFO("🔄 Rejoining {} (attempt {})", ConnectionChannelName(key), m_connectionMonitor.GetAttempts(key));
+            int result = RejoinConnection(key);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Rejoin of {} refused, error: {}", ConnectionChannelName(key), result);
+                ApplyConnectionTransition(key, m_connectionMonitor.OnRetryFailed(key, SteadyNowMs()));
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in RetryConnection");
+        }
+    }
+
+    // Leave + join with the options the connection has now; the rest comes back in RestoreSession
+    int AgoraCore::RejoinConnection(const std::string& key)
+    {
+        ConnectionOptions options;
+        options.publishMicrophone = true;
+        options.autoSubscribeAudio = true;
+
+        if (key.empty()) {
+            std::string channelName = GetCurrentChannel();
+            if (!channelName.empty() && channelName != m_callConnection) {
+                // Listen only comes back as audience unless keyed up right now
+                options.audience = m_state.Read([](const AgoraState& state) { return state.isListenOnly && state.isLocalAudioMuted; });
+                m_engine->LeaveChannel();
+                return m_engine->JoinChannel(channelName, 0, options);
+            }
+        } else if (m_radioSession.IsJoined(key)) {
+            LeaveConnection(key);
+            return JoinConnection(key, key == m_radioSession.GetTalkChannel());
+        } else if (key == m_callConnection) {
+            LeaveConnection(key);
+            return m_engine->JoinConnection(key, m_localUid, options, &GetConnectionHandler(key));
+        } else if (key == m_signalingChannel) {
+            LeaveConnection(key);
+            return JoinSignalingConnection(); // the new stream is opened once it is joined
+        }
+
+        // Nothing of ours lives there any more
+        m_connectionMonitor.Forget(key);
+        return 0;
+    }
+
+    // A rejoined connection is back on its join-time options; bring it in line with the app again
+    void AgoraCore::RestoreSession(const std::string& key)
+    {
+        bool muted = IsLocalAudioMuted();
+        bool muteUplink = muted || !m_voxTalking;
+
+        if (key.empty()) {
+            m_engine->MuteLocalAudio(muteUplink);
+            bool listenOnly = m_state.Read([](const AgoraState& state) { return state.isListenOnly; });
+            SetDefaultChannelAudience(listenOnly && muted);
+            if (m_volumeIntervalMs > 0) m_engine->EnableVolumeIndication(m_volumeIntervalMs, m_volumeSmooth);
+        } else if (m_radioSession.IsJoined(key)) {
+            bool talk = key == m_radioSession.GetTalkChannel();
+            UpdateConnection(key, talk);
+            if (talk) m_engine->MuteConnectionAudio(key, m_localUid, muteUplink);
+            if (m_volumeIntervalMs > 0) {
+                m_engine->EnableConnectionVolumeIndication(key, m_localUid, m_volumeIntervalMs, m_volumeSmooth);
+            }
+        } else if (key == m_callConnection) {
+            UpdateConnection(key, true);
+            m_engine->MuteConnectionAudio(key, m_localUid, muteUplink);
+        } else if (key == m_signalingChannel) {
+            // Same stream after an SDK rejoin: what was lost meanwhile goes out now, not at its next retry
+            for (const auto& message : m_callSignaling.PendingMessages()) SendSignalingMessage(message);
+            return;
+        }
+
+        // Engine-wide and idempotent: the SDK EQ stages and recording volume, then the playback volume
+        ApplyVoiceTuning();
+        if (m_playbackVolume >= 0) m_engine->SetPlaybackVolume(m_playbackVolume);
+    }
+
+    std::string AgoraCore::ConnectionChannelName(const std::string& key) const
+    {
+        return key.empty() ? GetCurrentChannel() : key;
+    }
+
+    void AgoraCore::StartSignaling(const std::string& lobbyChannel, const std::string& userId)
+    {
+        try {
+            AGORA_LOG_INFO("📨 StartSignaling - lobby {}, user {}", lobbyChannel, userId);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized - cannot start signaling");
+                return;
+            }
+            if (lobbyChannel.empty() || userId.empty()) {
+                AGORA_LOG_ERROR("❌ Signaling needs a lobby channel and a user id");
+                return;
+            }
+            if (lobbyChannel == m_signalingChannel && userId == m_callSignaling.GetLocalUser()) return;
+            if (m_radioSession.IsJoined(lobbyChannel) || lobbyChannel == GetCurrentChannel() || lobbyChannel == m_preparedChannel) {
+                AGORA_LOG_ERROR("❌ {} is already in use as a voice channel", lobbyChannel);
+                return;
+            }
+
+            // Another user signed in, or another lobby: the old one goes, with whatever it had pending
+            StopSignaling();
+
+            m_signalingChannel = lobbyChannel;
+            m_callSignaling.SetLocalUser(userId);
+            int result = JoinSignalingConnection();
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to join signaling lobby {}, error: {}", lobbyChannel, result);
+                m_signalingChannel.clear();
+                m_callSignaling.SetLocalUser("");
+                return;
+            }
+            m_connectionMonitor.Track(lobbyChannel);
+            AGORA_LOG_INFO("✅ Signaling join initiated, waiting for onJoinChannelSuccess");
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StartSignaling");
+        }
+    }
+
+    void AgoraCore::StopSignaling()
+    {
+        try {
+            if (m_signalingChannel.empty()) return;
+
+            AGORA_LOG_INFO("📪 StopSignaling - {}", m_signalingChannel);
+            LeaveFloors(); // byes out while the stream is still up
+            if (m_engine) LeaveConnection(m_signalingChannel);
+            m_connectionMonitor.Forget(m_signalingChannel);
+            m_signalingChannel.clear();
+            m_signalingStream = -1;
+            m_callSignaling.SetLocalUser(""); // queued retries find nothing left to send
+            EnforceFloor();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StopSignaling");
+        }
+    }
+
+    void AgoraCore::SendCallSignal(CallSignal signal)
+    {
+        try {
+            AGORA_LOG_INFO("📨 SendCallSignal - {} to {} ({})", CallSignalTypeName(signal.type), signal.toUser, signal.invitationId);
+
+            if (m_signalingChannel.empty()) {
+                AGORA_LOG_WARN("⚠️ Signaling not started - the other side has to poll for it");
+                return;
+            }
+
+            uint32_t seq = m_callSignaling.Enqueue(signal, SteadyNowMs());
+            if (seq == 0) {
+                AGORA_LOG_ERROR("❌ Call signal has no addressee or is over {} bytes", CallSignaling::kMaxMessageBytes);
+                m_metrics.RecordFailure(MetricOp::CallSignal);
+                return;
+            }
+            PumpCallSignal(seq);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SendCallSignal");
+        }
+    }
+
+    // Broadcaster so it may send, but nothing published or subscribed: no audio, no microphone.
+    // No volume or metrics slot either, those are for channels with voice.
+    int AgoraCore::JoinSignalingConnection()
+    {
+        auto& handler = m_connectionHandlers[m_signalingChannel];
+        if (!handler) {
+            handler = std::make_unique<AgoraEventHandler>();
+            handler->SetChannelName(m_signalingChannel);
+            handler->SetEventBatcher(&m_eventBatcher);
+        }
+        // Set before the join, so no callback races it. Messages are rare and small: one copy
+        // per message onto the worker is fine on the SDK thread.
+        handler->SetStreamSink([this](uint32_t uid, const char* data, size_t length) {
+            (void)uid;
+            std::string message(data, length);
+            Post(Command{ "", [this, message]() { OnSignalingMessage(message); }, nullptr });
+        });
+
+        ConnectionOptions options;
+        options.publishMicrophone = false;
+        options.autoSubscribeAudio = false;
+
+        m_signalingStream = -1;
+        SyncFloorChannels(); // the floor needs the stream: every radio is let go until it is back
+        return m_engine->JoinConnection(m_signalingChannel, m_localUid, options, handler.get());
+    }
+
+    void AgoraCore::OnSignalingJoined()
+    {
+        try {
+            int streamId = -1;
+            int result = m_engine->CreateDataStream(m_signalingChannel, m_localUid, &streamId);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to open the signaling stream on {}, error: {}", m_signalingChannel, result);
+                return;
+            }
+            m_signalingStream = streamId;
+            AGORA_LOG_INFO("📨 Signaling ready on {} as user {}", m_signalingChannel, m_callSignaling.GetLocalUser());
+
+            // Sent while joining: out now instead of at the next retry
+            for (const auto& message : m_callSignaling.PendingMessages()) SendSignalingMessage(message);
+            SyncFloorChannels();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in OnSignalingJoined");
+        }
+    }
+
+    void AgoraCore::OnSignalingMessage(const std::string& data)
+    {
+        try {
+            if (FloorControl::IsFloorMessage(data.data(), data.size())) {
+                FloorOutput out;
+                m_floorControl.OnMessage(data.data(), data.size(), SteadyNowMs(), out);
+                ApplyFloorOutput(out);
+                return;
+            }
+
+            SignalReceive received = m_callSignaling.OnMessage(data.data(), data.size(), SteadyNowMs());
+            if (!received.ack.empty()) SendSignalingMessage(received.ack);
+
+            IAgoraCoreListener* listener = m_listener.load();
+            if (received.acked) {
+                const CallSignal& signal = received.ackedSignal;
+                AGORA_LOG_INFO("📬 {} to {} delivered in {} ms", CallSignalTypeName(signal.type), signal.toUser, received.ackedAfterMs);
+                m_metrics.RecordLatency(MetricOp::CallSignal, received.ackedAfterMs * 1000);
+                if (listener) listener->OnCallSignalStatus(signal, true);
+            }
+            if (received.deliver) {
+                const CallSignal& signal = received.signal;
+                AGORA_LOG_INFO("📨 {} from {} ({})", CallSignalTypeName(signal.type), signal.fromUser, signal.invitationId);
+                if (listener) listener->OnCallSignal(signal);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in OnSignalingMessage");
+        }
+    }
+
+    // First send and every retry of one signal; the timer chain ends once it is acked or expires
+    void AgoraCore::PumpCallSignal(uint32_t seq)
+    {
+        try {
+            SignalSend step = m_callSignaling.Poll(seq, SteadyNowMs());
+            if (step.expired) {
+                AGORA_LOG_WARN("📭 {} to {} never acked, giving up", CallSignalTypeName(step.signal.type), step.signal.toUser);
+                m_metrics.RecordFailure(MetricOp::CallSignal);
+                if (IAgoraCoreListener* listener = m_listener.load()) listener->OnCallSignalStatus(step.signal, false);
+                return;
+            }
+            if (!step.send) return;
+
+            SendSignalingMessage(step.message);
+            m_commandQueue.PostAfter(step.nextCheckMs, Command{ "", [this, seq]() { PumpCallSignal(seq); }, nullptr });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in PumpCallSignal");
+        }
+    }
+
+    bool AgoraCore::SendSignalingMessage(const std::string& message)
+    {
+        // Still joining or rejoining: OnSignalingJoined or the retry timer sends it later
+        if (!m_engine || m_signalingStream < 0) return false;
+
+        int result = m_engine->SendStreamMessage(m_signalingChannel, m_localUid, m_signalingStream, message.data(), message.size());
+        if (result != 0) {
+            AGORA_LOG_WARN("⚠️ Signaling send on {} failed, error: {}", m_signalingChannel, result);
+            return false;
+        }
+        return true;
+    }
+
+    void AgoraCore::SetFloorControl(const std::string& channelName, bool enabled)
+    {
+        try {
+            AGORA_LOG_INFO("🚦 SetFloorControl - {}, enabled {}", channelName, enabled);
+
+            if (channelName.empty()) {
+                AGORA_LOG_ERROR("❌ Floor control needs a channel name");
+                return;
+            }
+            if (enabled) {
+                m_floorChannels.insert(channelName);
+            } else {
+                m_floorChannels.erase(channelName);
+            }
+            SyncFloorChannels();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetFloorControl");
+        }
+    }
+
+    void AgoraCore::RequestFloor(const std::string& channelName, int priority)
+    {
+        try {
+            AGORA_LOG_INFO("🚦 RequestFloor - {}, priority {}", channelName, priority);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            // Nobody to arbitrate with: a plain key-up, granted here and now
+            if (!FloorApplies(channelName)) {
+                if (channelName == TalkTarget()) MuteLocalAudio(false);
+                FloorChange change;
+                change.channelName = channelName;
+                change.state = FloorState::Granted;
+                change.reason = FloorReason::Granted;
+                if (IAgoraCoreListener* listener = m_listener.load()) listener->OnFloorChanged(change);
+                return;
+            }
+
+            if (!m_floorControl.IsJoined(channelName)) {
+                AGORA_LOG_WARN("⚠️ Floor of {} unreachable - lobby not connected or channel not joined", channelName);
+                m_metrics.RecordFailure(MetricOp::FloorGrant);
+                FloorChange change;
+                change.channelName = channelName;
+                change.reason = FloorReason::Offline;
+                if (IAgoraCoreListener* listener = m_listener.load()) listener->OnFloorChanged(change);
+                return;
+            }
+
+            FloorOutput out;
+            m_floorControl.Request(channelName, priority, SteadyNowMs(), out);
+            ApplyFloorOutput(out);
+            ScheduleFloorTick();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in RequestFloor");
+            m_metrics.RecordFailure(MetricOp::FloorGrant);
+        }
+    }
+
+    void AgoraCore::ReleaseFloor(const std::string& channelName)
+    {
+        try {
+            AGORA_LOG_INFO("🚦 ReleaseFloor - {}", channelName);
+
+            // Muted before the floor goes, so the next talker never overlaps us
+            if (IsReady() && channelName == TalkTarget()) MuteLocalAudio(true);
+
+            FloorOutput out;
+            m_floorControl.Release(channelName, SteadyNowMs(), out);
+            ApplyFloorOutput(out);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ReleaseFloor");
+        }
+    }
+
+    bool AgoraCore::FloorApplies(const std::string& channelName) const
+    {
+        return !m_signalingChannel.empty() && m_floorChannels.count(channelName) != 0;
+    }
+
+    // Floor channels we are in, joined on the lobby while its stream is up; everything else let go
+    void AgoraCore::SyncFloorChannels()
+    {
+        if (!IsSignalingConnected()) {
+            LeaveFloors();
+            EnforceFloor();
+            return;
+        }
+
+        uint64_t nowMs = SteadyNowMs();
+        std::string currentChannel = GetCurrentChannel();
+        auto inChannel = [&](const std::string& channelName) {
+            return channelName == currentChannel || m_radioSession.IsJoined(channelName);
+        };
+
+        FloorOutput out;
+        m_floorControl.SetLocalUser(m_callSignaling.GetLocalUser(), nowMs, out);
+        for (const std::string& channelName : m_floorControl.GetChannels()) {
+            if (!m_floorChannels.count(channelName) || !inChannel(channelName)) m_floorControl.Leave(channelName, nowMs, out);
+        }
+        for (const std::string& channelName : m_floorChannels) {
+            if (inChannel(channelName)) m_floorControl.Join(channelName, nowMs, out);
+        }
+        ApplyFloorOutput(out);
+        ScheduleFloorTick();
+        EnforceFloor();
+    }
+
+    void AgoraCore::LeaveFloors()
+    {
+        if (m_floorControl.GetChannels().empty()) return;
+
+        FloorOutput out;
+        m_floorControl.LeaveAll(SteadyNowMs(), out);
+        ApplyFloorOutput(out);
+    }
+
+    void AgoraCore::ScheduleFloorTick()
+    {
+        if (m_floorTickScheduled || m_floorControl.GetChannels().empty()) return;
+
+        m_floorTickScheduled = true;
+        m_commandQueue.PostAfter(kFloorTickMs, Command{ "", [this]() { FloorTick(); }, nullptr });
+    }
+
+    void AgoraCore::FloorTick()
+    {
+        try {
+            m_floorTickScheduled = false;
+            FloorOutput out;
+            m_floorControl.Tick(SteadyNowMs(), out);
+            ApplyFloorOutput(out);
+            ScheduleFloorTick();
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in FloorTick");
+        }
+    }
+
+    void AgoraCore::ApplyFloorOutput(const FloorOutput& out)
+    {
+        for (const auto& message : out.messages) SendSignalingMessage(message);
+        for (const auto& change : out.changes) OnFloorChanged(change);
+    }
+
+    void AgoraCore::OnFloorChanged(const FloorChange& change)
+    {
+        AGORA_LOG_INFO("🚦 Floor of {}: {} ({}), holder {}", change.channelName, FloorStateName(change.state),
+                       FloorReasonName(change.reason), change.holder.empty() ? "NONE" : change.holder.c_str());
+
+        if (change.state == FloorState::Granted) {
+            m_metrics.RecordLatency(MetricOp::FloorGrant, change.waitedMs * 1000);
+            // Keyed on a monitored radio: that one carries the microphone now
+            if (m_radioSession.IsJoined(change.channelName) && m_radioSession.GetTalkChannel() != change.channelName) {
+                SetTalkChannel(change.channelName);
+            }
+            if (IsReady() && change.channelName == TalkTarget()) MuteLocalAudio(false);
+        } else if (change.reason == FloorReason::Busy || change.reason == FloorReason::NoAnswer) {
+            m_metrics.RecordFailure(MetricOp::FloorGrant);
+        }
+        EnforceFloor();
+
+        if (IAgoraCoreListener* listener = m_listener.load()) listener->OnFloorChanged(change);
+    }
+
+    // Where an unmute would send our voice: the talk radio, otherwise the current channel
+    std::string AgoraCore::TalkTarget() const
+    {
+        std::string talkChannel = m_radioSession.GetTalkChannel();
+        return talkChannel.empty() ? GetCurrentChannel() : talkChannel;
+    }
+
+    bool AgoraCore::TalkNeedsFloor() const
+    {
+        std::string target = TalkTarget();
+        return !target.empty() && FloorApplies(target) && !m_floorControl.Holds(target);
+    }
+
+    void AgoraCore::EnforceFloor()
+    {
+        if (!IsReady() || !TalkNeedsFloor() || IsLocalAudioMuted()) return;
+
+        AGORA_LOG_INFO("🚦 Floor of {} is not ours - muting", TalkTarget());
+        MuteLocalAudio(true);
+    }
+
+    // Volume table and metrics share the connection's channel index
+    void AgoraCore::AttachChannelSlots(AgoraEventHandler& handler, const std::string& channelName)
+    {
+        static_assert(Metrics::kMaxChannels >= VolumeMeter::kMaxChannels, "every volume channel needs a metrics slot");
+
+        uint8_t channelIndex = m_volumeMeter.RegisterChannel(channelName);
+        if (channelIndex == VolumeMeter::kNoChannel) {
+            AGORA_LOG_WARN("⚠️ No volume slot left for {}", channelName);
+        }
+        handler.SetVolumeMeter(&m_volumeMeter, channelIndex);
+
+        m_metrics.SetChannelName(channelIndex, channelName);
+        handler.SetMetrics(&m_metrics, channelIndex); // kNoChannel is ignored by both
+    }
+
+    void AgoraCore::EnableVolumeIndication(int intervalMs, int smooth)
+    {
+        try {
+            AGORA_LOG_INFO("📊 EnableVolumeIndication - interval {} ms, smooth {}", intervalMs, smooth);
+
+            if (!IsReady()) {
+                AGORA_LOG_ERROR("❌ Engine not initialized");
+                return;
+            }
+
+            // SDK minimum is 100 ms; anything lower (or negative) switches indication off
+            m_volumeIntervalMs = intervalMs >= 100 ? intervalMs : 0;
+            m_volumeSmooth = std::max(0, std::min(10, smooth));
+            int sdkInterval = m_volumeIntervalMs > 0 ? m_volumeIntervalMs : -1;
+
+            int result = m_engine->EnableVolumeIndication(sdkInterval, m_volumeSmooth);
+            if (result != 0) {
+                AGORA_LOG_ERROR("❌ Failed to enable volume indication, error: {}", result);
+            }
+            for (const auto& channelName : m_radioSession.GetChannels()) {
+                m_engine->EnableConnectionVolumeIndication(channelName, m_localUid, sdkInterval, m_volumeSmooth);
+            }
+
+            if (m_volumeIntervalMs == 0) {
+                m_volumeMeter.Stop();
+                m_volumeMeter.Reset();
+                return;
+            }
+
+            m_volumeMeter.Start(m_volumeIntervalMs, [this](const VolumeUpdate& update) {
+                if (IAgoraCoreListener* listener = m_listener.load()) listener->OnVolumeUpdate(update);
+            });
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in EnableVolumeIndication");
+        }
+    }
+
+    std::vector<std::string> AgoraCore::GetRadioChannels() const
+    {
+        return m_state.Read([](const AgoraState& state) { return state.radioChannels; });
+    }
+
+    void AgoraCore::ReleaseEngine()
+    {
+        try {
+            if (m_engine) {
+                if (m_latencyProbe.IsRunning()) FinishLatencyProbe(true);
+                m_externalAudio.Stop();
+                LeaveFloors();
+                if (!m_signalingChannel.empty()) LeaveConnection(m_signalingChannel);
+                m_radioSession.LeaveAll();
+                ReleasePreparedChannel(m_preparedChannel);
+                if (!GetCurrentChannel().empty()) {
+                    LeaveCurrentChannel();
+                }
+                m_engine->SetAudioProcessors(nullptr, nullptr, nullptr);
+                m_engine->Release();
+                m_engine.reset();
+            }
+            // No audio thread left: drop the rings and whatever was replaying or ringing
+            m_replayPlayer.Stop();
+            m_tones.StopAll();
+            m_replayRecorder.Clear();
+            m_volumeMeter.Stop();
+            m_volumeMeter.Reset();
+            m_metrics.ResetConnections(); // indices are handed out again; op latencies survive
+            m_voxTalking = true; // a fresh engine starts unmuted; the gate re-reports on its next frame
+            m_volumeIntervalMs = 0;
+            m_recordingVolume = -1;
+            m_playbackVolume = -1;
+            m_clientRole = -1;
+            m_connectionMonitor.Clear();
+            m_deviceRegistry.Clear();
+            m_devicePinned[0] = m_devicePinned[1] = false;
+            m_lastmileProbing = false; // went with the engine
+            m_lastmileWanted = false;
+            ++m_lastmileRun;
+            m_signalingChannel.clear();
+            m_signalingStream = -1;
+            m_callSignaling.SetLocalUser("");
+            m_floorChannels.clear();
+            m_preparedChannel.clear();
+            m_callConnection.clear();
+            m_pendingAccept.clear();
+            m_connectionHandlers.clear();
+            m_eventHandler.reset();
+            // Back to defaults; only the version keeps counting
+            m_state.Update([](AgoraState& state) { state = AgoraState{ state.version }; });
+            PublishAudioDevices(AudioDeviceKind::Recording); // no devices left, preferences kept
+            PublishAudioDevices(AudioDeviceKind::Playback);
+            PublishLinkProfile(); // the decision stays for the next engine on this network
+            AGORA_LOG_INFO("✅ Engine released");
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ReleaseEngine");
+        }
+    }
+
+    void AgoraCore::StartReplayRing(const std::string& channelName)
+    {
+        auto it = m_replaySeconds.find(channelName);
+        int seconds = it != m_replaySeconds.end() ? it->second : m_defaultReplaySeconds;
+        if (!m_replayRecorder.SetCapacity(channelName, seconds)) {
+            AGORA_LOG_WARN("⚠️ No replay slot left for {}", channelName);
+        }
+    }
+
+    void AgoraCore::SetReplayBuffer(const std::string& channelName, int seconds)
+    {
+        try {
+            seconds = std::max(0, std::min(ReplayRecorder::kMaxSeconds, seconds));
+            AGORA_LOG_INFO("⏪ SetReplayBuffer - {}: {} s ({} KB)", channelName.empty() ? "DEFAULT" : channelName.c_str(),
+                           seconds, seconds * ReplayRecorder::BytesPerSecond() / 1024);
+
+            // Empty channel = every radio without its own setting, including those already monitored
+            if (channelName.empty()) {
+                m_defaultReplaySeconds = seconds;
+                for (const auto& radio : m_radioSession.GetChannels()) {
+                    if (m_replaySeconds.count(radio) == 0) StartReplayRing(radio);
+                }
+                return;
+            }
+
+            m_replaySeconds[channelName] = seconds;
+            if (m_radioSession.IsJoined(channelName)) {
+                StartReplayRing(channelName);
+            }
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in SetReplayBuffer");
+        }
+    }
+
+    void AgoraCore::ReplayLast(const std::string& channelName, int seconds, uint32_t uid)
+    {
+        ScopedLatency timing(m_metrics, MetricOp::Replay);
+        try {
+            AGORA_LOG_INFO("⏪ ReplayLast - {}, {} s, uid {}", channelName, seconds, uid);
+
+            std::vector<int16_t> pcm;
+            if (!m_replayRecorder.BuildClip(channelName, seconds, uid, ReplayRecorder::NowMs(), pcm)) {
+                AGORA_LOG_WARN("⚠️ Nothing to replay on {}", channelName);
+                timing.Fail();
+                return;
+            }
+
+            AGORA_LOG_INFO("▶️ Replaying {} ms from {}", pcm.size() / (ReplayBlock::kSampleRate / 1000), channelName);
+            m_replayPlayer.Play(std::move(pcm), ReplayBlock::kSampleRate);
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in ReplayLast");
+            timing.Fail();
+        }
+    }
+
+    void AgoraCore::StopReplay()
+    {
+        try {
+            m_replayPlayer.Stop();
+            AGORA_LOG_INFO("⏹️ Replay stopped");
+        } catch (...) {
+            AGORA_LOG_ERROR("❌ Exception in StopReplay");
+        }
+    }
+
+    // [[uid, msAgo, durationMs], ...] oldest first
+    std::string AgoraCore::GetReplayIndex(const std::string& channelName, int seconds) const
+    {
+        uint64_t nowMs = ReplayRecorder::NowMs();
+        std::string json = "[";
+        for (const auto& spurt : m_replayRecorder.GetIndex(channelName, seconds, nowMs)) {
+            if (json.size() > 1) json += ",";
+            json += "[" + std::to_string(spurt.uid) + "," + std::to_string(nowMs - std::min(nowMs, spurt.startMs)) + "," +
+                    std::to_string(spurt.endMs - spurt.startMs) + "]";
+        }
+        return json + "]";
+    }
+
+    std::string AgoraCore::GetMetrics() const
+    {
+        return m_metrics.SnapshotJson();
+    }
+
+    ConnectionState AgoraCore::GetConnectionState(const std::string& channelName) const
+    {
+        return m_state.Read([&channelName](const AgoraState& state) {
+            // The default channel is tracked under "", Ex connections under their own name
+            auto it = state.connections.find(channelName);
+            if (it == state.connections.end() && channelName == state.currentChannel) it = state.connections.find("");
+            return it != state.connections.end() ? it->second : ConnectionState::Disconnected;
+        });
+    }
+
+    size_t AgoraCore::ReadLevels(const std::string& channelName, VolumeChange* out, size_t capacity) const
+    {
+        // Same naming as GetConnectionState: the default channel's slot is registered as ""
+        uint8_t channel = m_volumeMeter.FindChannel(channelName);
+        if (channel == VolumeMeter::kNoChannel && channelName == GetCurrentChannel()) channel = m_volumeMeter.FindChannel("");
+        return channel != VolumeMeter::kNoChannel ? m_volumeMeter.ReadLevels(channel, out, capacity) : 0;
+    }
+
+    const std::vector<AgoraCore::Counter>& AgoraCore::Counters()
+    {
+        // Built once; every reader is a few relaxed atomic loads (a histogram scan for percentiles)
+        static const std::vector<Counter> counters = []() {
+            std::vector<Counter> table{
+                { "commands.executed", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_commandQueue.GetExecutedCount()); } },
+                { "commands.coalesced", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_commandQueue.GetCoalescedCount()); } },
+                { "events.dropped", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_eventBatcher.GetDroppedCount()); } },
+                { "events.merged", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_eventBatcher.GetMergedCount()); } },
+                { "volume.overflow", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_volumeMeter.GetOverflowCount()); } },
+                { "metrics.uidOverflow", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_metrics.GetUidOverflowCount()); } },
+                { "capture.frames", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_capturePipeline.GetProcessedFrames()); } },
+                { "playback.frames", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_playbackPipeline.GetProcessedFrames()); } },
+                { "mixer.streams", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_radioMixer.GetActiveStreams()); } },
+                { "mixer.rendered", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_radioMixer.GetRenderedFrames()); } },
+                { "mixer.ducked", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_radioMixer.GetDuckedFrames()); } },
+                { "mixer.dropped", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_radioMixer.GetDroppedFrames()); } },
+                { "loudness.overflow", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_loudness.GetOverflowCount()); } },
+                { "tones.started", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_tones.GetStarted()); } },
+                { "tones.lastStartUs", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_tones.GetLastStartUs()); } },
+                { "tones.maxStartUs", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_tones.GetMaxStartUs()); } },
+                { "tones.unsupported", [](const AgoraCore& core, size_t) { return static_cast<double>(core.m_tones.GetUnsupportedFrames()); } },
+            };
+
+            // "<op>.count", "<op>.failures", "<op>.p50Us" and "<op>.p99Us" for every timed operation
+            for (size_t op = 0; op < static_cast<size_t>(MetricOp::Count); ++op) {
+                std::string prefix = MetricOpName(static_cast<MetricOp>(op));
+                table.push_back({ prefix + ".count", [](const AgoraCore& core, size_t arg) {
+                    return static_cast<double>(core.m_metrics.GetSummary(static_cast<MetricOp>(arg)).count); }, op });
+                table.push_back({ prefix + ".failures", [](const AgoraCore& core, size_t arg) {
+                    return static_cast<double>(core.m_metrics.GetFailures(static_cast<MetricOp>(arg))); }, op });
+                table.push_back({ prefix + ".p50Us", [](const AgoraCore& core, size_t arg) {
+                    return static_cast<double>(core.m_metrics.GetSummary(static_cast<MetricOp>(arg)).p50Us); }, op });
+                table.push_back({ prefix + ".p99Us", [](const AgoraCore& core, size_t arg) {
+                    return static_cast<double>(core.m_metrics.GetSummary(static_cast<MetricOp>(arg)).p99Us); }, op });
+            }
+            return table;
+        }();
+        return counters;
+    }
+
+    const std::vector<std::string>& AgoraCore::GetCounterNames()
+    {
+        static const std::vector<std::string> names = []() {
+            std::vector<std::string> list;
+            for (const Counter& counter : Counters()) list.push_back(counter.name);
+            return list;
+        }();
+        return names;
+    }
+
+    int AgoraCore::FindCounter(const std::string& name)
+    {
+        static const std::unordered_map<std::string, int> index = []() {
+            std::unordered_map<std::string, int> names;
+            const auto& counters = Counters();
+            for (size_t i = 0; i < counters.size(); ++i) names.emplace(counters[i].name, static_cast<int>(i));
+            return names;
+        }();
+        auto it = index.find(name);
+        return it != index.end() ? it->second : -1;
+    }
+
+    double AgoraCore::ReadCounter(int counter) const
+    {
+        const auto& counters = Counters();
+        if (counter < 0 || static_cast<size_t>(counter) >= counters.size()) return 0.0;
+        return counters[counter].read(*this, counters[counter].arg);
+    }
+
+    std::string AgoraCore::GetStatus() const
+    {
+        // One consistent snapshot, no locks - safe from the JS thread while the worker runs
+        return m_state.Read([this](const AgoraState& state) {
+            std::string status = "🔧 AGORA MANAGER STATUS:\n\n";
+
+            if (state.isEngineCreated) {
+                status += "✅ RTC Engine: CREATED\n";
+            } else {
+                status += "❌ RTC Engine: NOT CREATED\n";
+            }
+
+            if (state.isInitialized) {
+                status += "✅ Engine Status: INITIALIZED\n";
+                status += "📱 App ID: " + state.appId + "\n";
+            } else {
+                status += "❌ Engine Status: NOT INITIALIZED\n";
+            }
+
+            if (!state.currentChannel.empty()) {
+                status += "🔗 Current Channel: " + state.currentChannel + "\n";
+                if (state.isListenOnly) status += "👂 Role: AUDIENCE until keyed\n";
+            } else {
+                status += "⭕ Current Channel: NONE\n";
+            }
+
+            if (!state.radioChannels.empty()) {
+                status += "📻 Monitored Radios: " + std::to_string(state.radioChannels.size()) + "\n";
+                for (const auto& radio : state.radioChannels) {
+                    status += "   - " + radio + "\n";
+                }
+                status += "🎙️ Talk Channel: " + (state.talkChannel.empty() ? std::string("NONE") : state.talkChannel) + "\n";
+            }
+
+            if (!state.preparedChannel.empty()) {
+                status += "🔥 Prepared Call Channel: " + state.preparedChannel + "\n";
+            }
+            if (!state.callLatency.acceptChannel.empty()) {
+                status += "⏱️ Last Accept: " + std::to_string(static_cast<int>(state.callLatency.acceptMs)) + " ms (" +
+                          (state.callLatency.acceptWarm ? "warm" : "cold") + ")\n";
+            }
+
+            if (state.isExternalAudio) {
+                status += "🔌 Audio Devices: EXTERNAL\n";
+            }
+            for (const AudioDeviceList* list : { &state.recordingDevices, &state.playbackDevices }) {
+                if (list->devices.empty()) continue;
+                auto active = std::find_if(list->devices.begin(), list->devices.end(),
+                                           [list](const AudioDeviceInfo& device) { return device.id == list->activeId; });
+                status += std::string(list->kind == AudioDeviceKind::Playback ? "🔈 Playback" : "🎙️ Recording") + " Device: " +
+                          (active != list->devices.end() ? active->name : std::string("UNKNOWN")) + " (" +
+                          std::to_string(list->devices.size()) + " available)\n";
+            }
+            if (state.isLastmileProbing) {
+                status += "📶 Link: PROBING\n";
+            } else if (state.link.profile.tier != LinkTier::Unknown) {
+                status += "📶 Link: " + std::string(LinkTierName(state.link.profile.tier)) +
+                          (state.link.fromCache ? " (cached)" : "") + "\n";
+            }
+            if (m_radioMixer.GetConfig().enabled) {
+                status += "🎚️ Radio Mixer: ON (" + std::to_string(m_radioMixer.GetActiveStreams()) + " streams)\n";
+            }
+            if (m_loudness.GetConfig().enabled) {
+                status += "🔊 Loudness: ON (" + std::to_string(m_loudness.GetStats().size()) + " speakers)\n";
+            }
+
+            if (state.isEchoTestRunning) {
+                status += "🎤 Echo Test: RUNNING\n";
+            } else {
+                status += "⭕ Echo Test: STOPPED\n";
+            }
+
+            if (state.isInitialized && state.isEngineCreated) {
+                status += "\n🎉 STATUS: READY FOR VOICE COMMUNICATION!";
+            } else {
+                status += "\n⚠️ STATUS: NEEDS INITIALIZATION";
+            }
+
+            return status;
+        });
+    }
+}
@@ -0,0 +1,508 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AgoraState.h"
+#include "AudioPipeline.h"
+#include "AudioStatePlanner.h"
+#include "CallSignaling.h"
+#include "CommandQueue.h"
+#include "ConnectionMonitor.h"
+#include "DeviceRegistry.h"
+#include "EventBatcher.h"
+#include "ExternalAudio.h"
+#include "FloorControl.h"
+#include "LatencyProbe.h"
+#include "LinkProfile.h"
+#include "LoudnessNormalizer.h"
+#include "Metrics.h"
+#include "MultiChannelSession.h"
+#include "RadioMixer.h"
+#include "ReplayBuffer.h"
+#include "ToneEngine.h"
+#include "VoiceEngine.h"
+#include "VolumeMeter.h"
+
+// Everything AgoraManager decides - join/leave, mute and VOX, radios, private calls,
+// volume levels, metrics - written against IVoiceEngine and free of Agora SDK and WinRT
+// types. AgoraManager adds the React Native bridge and the real engine on top; tests
+// and benchmarks run the same code on Linux against FakeVoiceEngine.
+namespace winrt::FinalProject::implementation
+{
+    // Event handler for one connection: callbacks only touch the batcher, volume table and metrics
+    class AgoraEventHandler : public IVoiceEngineEvents
+    {
+    public:
+        AgoraEventHandler() = default;
+        virtual ~AgoraEventHandler() = default;
+
+        // Callbacks only enqueue into the batcher; it crosses the bridge once per flush
+        void SetEventBatcher(EventBatcher* batcher) {
+            m_eventBatcher = batcher;
+        }
+
+        // Radio connections get their own handler so JS events carry the channel name
+        void SetChannelName(const std::string& channelName) {
+            m_channelName = channelName;
+        }
+
+        // Volume callbacks land in the shared table under this handler's channel slot
+        void SetVolumeMeter(VolumeMeter* meter, uint8_t channelIndex) {
+            m_volumeMeter = meter;
+            m_volumeChannel = channelIndex;
+        }
+
+        // Stats callbacks land in the shared metrics under the same channel slot
+        void SetMetrics(Metrics* metrics, uint8_t channelIndex) {
+            m_metrics = metrics;
+            m_metricsChannel = channelIndex;
+        }
+
+        // Data stream messages skip the batcher (they carry a payload); the sink must copy it
+        using StreamSink = std::function<void(uint32_t uid, const char* data, size_t length)>;
+        void SetStreamSink(StreamSink sink) {
+            m_streamSink = std::move(sink);
+        }
+
+        // So do device hot-plug events (ids are longer than a channel slot); same rule
+        using DeviceSink = std::function<void(const char* deviceId, int deviceType, int deviceState)>;
+        void SetDeviceSink(DeviceSink sink) {
+            m_deviceSink = std::move(sink);
+        }
+
+        // And the last-mile probe result, which has no channel at all
+        using LastmileSink = std::function<void(const LastmileProbeResult& result)>;
+        void SetLastmileSink(LastmileSink sink) {
+            m_lastmileSink = std::move(sink);
+        }
+
+        void onJoinChannelSuccess(const char* channel, uint32_t uid, int elapsed) override;
+        void onLeaveChannel(const ChannelStatsSample& stats) override;
+        void onUserJoined(uint32_t uid, int elapsed) override;
+        void onUserOffline(uint32_t uid, int reason) override;
+        void onError(int err, const char* msg) override;
+        void onAudioVolumeIndication(const VolumeSample* speakers, unsigned int speakerNumber, int totalVolume) override;
+        void onActiveSpeaker(uint32_t uid) override;
+        void onRtcStats(const ChannelStatsSample& stats) override;
+        void onNetworkQuality(uint32_t uid, int txQuality, int rxQuality) override;
+        void onRemoteAudioStats(uint32_t uid, const RemoteAudioSample& stats) override;
+        void onConnectionStateChanged(int state, int reason) override;
+        void onConnectionLost() override;
+        void onRejoinChannelSuccess(const char* channel, uint32_t uid, int elapsed) override;
+        void onStreamMessage(uint32_t uid, int streamId, const char* data, size_t length) override;
+        void onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState) override;
+        void onLastmileProbeResult(const LastmileProbeResult& result) override;
+    private:
+        void Publish(AgoraEventType type, const char* channel, uint32_t uid, int value);
+
+        EventBatcher* m_eventBatcher = nullptr;
+        std::string m_channelName;
+        VolumeMeter* m_volumeMeter = nullptr;
+        uint8_t m_volumeChannel = VolumeMeter::kNoChannel;
+        Metrics* m_metrics = nullptr;
+        uint8_t m_metricsChannel = Metrics::kNoChannel;
+        StreamSink m_streamSink;
+        DeviceSink m_deviceSink;
+        LastmileSink m_lastmileSink;
+    };
+
+    // What one ApplyAudioState call did
+    struct AudioStateReport
+    {
+        bool ready = false;                // false: no engine, nothing was tried
+        std::vector<AudioAction> applied;  // in the order they ran
+        int unchanged = 0;                 // settings asked for that were already in place
+        std::vector<AudioAction> pending;  // still differing afterwards (refused, floor control)
+    };
+
+    // Where the core's results go. Batches come from the flusher thread, volume updates from
+    // the volume reporter, everything else from the command worker.
+    class IAgoraCoreListener
+    {
+    public:
+        virtual ~IAgoraCoreListener() = default;
+
+        virtual void OnEventBatch(const std::vector<AgoraEvent>& events, const EventBatchStats& stats) = 0;
+        virtual void OnVolumeUpdate(const VolumeUpdate& update) = 0;
+        virtual void OnTalkStateChanged(bool talking, bool vox) = 0;
+        virtual void OnCallLatency(const std::string& channelName, bool warm, double acceptMs) = 0;
+        // One call per state change of a joined channel or radio, retries included
+        virtual void OnConnectionStateChanged(const std::string& channelName, const ConnectionTransition& transition) = 0;
+        // A call signal addressed to this user, once per signal however often it was resent
+        virtual void OnCallSignal(const CallSignal& signal) = 0;
+        // One of ours was acked by the addressee (delivered) or gave up after every retry
+        virtual void OnCallSignalStatus(const CallSignal& signal, bool delivered) = 0;
+        // The push-to-talk floor of a radio with floor control: ours, someone else's, or free
+        virtual void OnFloorChanged(const FloorChange& change) = 0;
+        // A latency probe run ended: every probe went out, or it was stopped (cancelled)
+        virtual void OnLatencyProbeFinished(const LatencyReport& report) = 0;
+        // A device list, the device in use or the preferences changed
+        virtual void OnAudioDevicesChanged(const AudioDeviceList& list) = 0;
+    };
+
+    class AgoraCore : private IConnectionEngine
+    {
+    public:
+        // Called by InitializeEngine for every fresh engine
+        using EngineFactory = std::function<std::unique_ptr<IVoiceEngine>()>;
+
+        // SDK enum values the core asks for by number
+        static constexpr int kRoleBroadcaster = 1;     // CLIENT_ROLE_BROADCASTER
+        static constexpr int kScenarioDefault = 0;     // AUDIO_SCENARIO_DEFAULT
+        static constexpr int kScenarioMeeting = 8;     // AUDIO_SCENARIO_MEETING
+        static constexpr int kNoiseSuppressionAggressive = 1;
+        static constexpr int kEqBand125 = 2;           // AUDIO_EQUALIZATION_BAND_125
+        static constexpr int kEqBand250 = 3;           // AUDIO_EQUALIZATION_BAND_250
+
+        explicit AgoraCore(EngineFactory engineFactory);
+        virtual ~AgoraCore();
+
+        AgoraCore(const AgoraCore&) = delete;
+        AgoraCore& operator=(const AgoraCore&) = delete;
+
+        // Everything below except the const readers runs on the command worker (see Post)
+        void InitializeEngine(const std::string& appId);
+        void WarmStart(const std::string& appId);
+        void StartEchoTest();
+        void StopEchoTest();
+        void JoinChannel(const std::string& channelName, bool listenOnly = false);
+        void LeaveChannel();
+
+        // Private calls: PrepareChannel while ringing, then AcceptCall (falls back to a cold join)
+        void PrepareChannel(const std::string& channelName);
+        void ReleasePreparedChannel(const std::string& channelName);
+        void AcceptCall(const std::string& channelName);
+        CallLatency GetCallLatency() const;
+        void ReleaseEngine();
+        std::string GetStatus() const;
+
+        // Voice communication. In listen-only mode unmuting is the key-up: the default channel
+        // turns broadcaster while keyed and goes back to audience on mute.
+        void SetListenOnly(bool listenOnly);
+        void MuteLocalAudio(bool mute);
+        void EnableLocalAudio(bool enabled);
+        void AdjustRecordingVolume(int volume);
+        void AdjustPlaybackVolume(int volume);
+        void SetClientRole(int role);
+        void MuteRemoteAudioStream(unsigned int uid, bool mute);
+
+        // Multi-channel monitoring (radio-console mode)
+        void JoinRadioChannel(const std::string& channelName, bool talk);
+        void LeaveRadioChannel(const std::string& channelName);
+        void SetTalkChannel(const std::string& channelName);
+        std::vector<std::string> GetRadioChannels() const;
+
+        // Call signaling: a lobby connection every signed-in client keeps open while the app runs.
+        // Invitations and answers arrive as OnCallSignal within the lobby's latency instead of
+        // the next poll; the server still records every call.
+        void StartSignaling(const std::string& lobbyChannel, const std::string& userId);
+        void StopSignaling();
+        void SendCallSignal(CallSignal signal);
+        bool IsSignalingConnected() const { return m_signalingStream >= 0; } // worker thread only
+
+        // Push-to-talk floor, arbitrated over the signaling lobby. While signaling runs, a channel
+        // or radio with floor control only opens the microphone for the client holding its floor:
+        // RequestFloor is the key-up (the grant unmutes), ReleaseFloor the key-down.
+        void SetFloorControl(const std::string& channelName, bool enabled);
+        void RequestFloor(const std::string& channelName, int priority);
+        void ReleaseFloor(const std::string& channelName);
+
+        // Instant replay of monitored radios (local playback only)
+        void SetReplayBuffer(const std::string& channelName, int seconds); // "" = default for every radio
+        void ReplayLast(const std::string& channelName, int seconds, uint32_t uid = 0);
+        void StopReplay();
+        bool IsReplaying() const { return m_replayPlayer.IsPlaying(); }
+        std::string GetReplayIndex(const std::string& channelName, int seconds) const;
+
+        // Radio mixer: a gain and stereo pan per radio and per user, and ducking of every radio
+        // below the highest priority one someone talks on. Playback is rebuilt natively from
+        // each user's frames; off until enabled, and the settings outlive the engine.
+        void ConfigureRadioMixer(const RadioMixerConfig& settings); // the settings' mixes are kept as they are
+        void SetRadioMix(const std::string& channelName, float gainDb, float pan, int priority);
+        void SetUserMix(const std::string& channelName, uint32_t uid, float gainDb, float pan);
+        RadioMixerConfig GetRadioMixer() const { return m_radioMixer.GetConfig(); } // any thread
+
+        // Loudness leveller: brings every remote user towards one target level. Rebuilds playback
+        // through the radio mixer even with its pans off; settings outlive the engine.
+        void ConfigureLoudness(const LoudnessConfig& settings);
+        LoudnessConfig GetLoudnessConfig() const { return m_loudness.GetConfig(); }
+        std::vector<LoudnessStats> GetLoudnessStats() const; // any thread, channel names filled in
+
+        // Latency numbers instead of listening to the echo test: probes through the audio devices
+        // (the loopback test keeps them open outside a channel) or out over the talk channel and
+        // back through whatever loops it, reported by OnLatencyProbeFinished
+        void StartLatencyProbe(const LatencyProbeConfig& config);
+        void StopLatencyProbe();
+        bool IsLatencyProbeRunning() const { return m_latencyProbe.IsRunning(); }
+
+        // Cue tones (talk chirps, roger beep, ringing) played from memory. Any thread, lock-free:
+        // the cue starts with the next audio frame, also on the talk channel when uplink is set.
+        // With talkChirps on, every key-up and key-down plays its chirp locally.
+        void PlayTone(ToneCue cue, bool uplink = false) { m_tones.Play(cue, uplink); }
+        void StopTone(ToneCue cue) { m_tones.Stop(cue); }
+        void ConfigureTones(const ToneConfig& settings);
+        ToneConfig GetToneConfig() const { return m_tones.GetConfig(); }
+        bool IsTonePlaying(ToneCue cue) const { return m_tones.IsPlaying(cue); }
+
+        // External audio: our own capture device and renderer instead of the SDK's, fed through
+        // GetExternalAudio() (WriteCapture / ReadPlayback). Switched only outside every channel.
+        void SetExternalAudio(bool enabled, const ExternalAudioConfig& config = {});
+        ExternalAudio& GetExternalAudio() { return m_externalAudio; }
+
+        // Audio devices, switched in-session without restarting the engine. Lists are enumerated
+        // once per engine and kept current from hot-plug events; the preference policy picks the
+        // device whenever one comes or goes. Changes go out as OnAudioDevicesChanged.
+        void SetPreferredDevices(AudioDeviceKind kind, const std::vector<std::string>& preferred);
+        void RefreshAudioDevices(); // re-enumerates both kinds; events normally make this unnecessary
+        AudioDeviceList GetAudioDevices(AudioDeviceKind kind) const; // any thread, from the snapshot
+
+        // Link profile: a last-mile probe runs in the background after InitializeEngine and when
+        // the network changes, while no audio channel is joined. The profile it picks (codec,
+        // bitrate, FEC, jitter buffer) is cached per network and applied before joins, so a
+        // rejoin on the same network costs nothing. A join never waits: it stops a running probe
+        // and goes with the cached profile, or SDK defaults on a network not measured yet.
+        void SetNetworkIdentity(const std::string& networkId); // "" = not known
+        void StartLastmileProbe(); // probes now even if the cached profile is still fresh
+        void SetLinkProfileTtl(int minutes);
+        LinkDecision GetLinkProfile() const; // any thread, from the snapshot
+
+        // Desired state in one call: channels, talk radio, mute, volumes, role, AINS and scenario.
+        // Diffs it against the core's state and runs only the setters that change something,
+        // in a safe order (see PlanAudioState); unset fields are left alone.
+        AudioStateReport ApplyAudioState(const DesiredAudioState& desired);
+
+        // Audio quality
+        void EnableNoiseSuppressionMode(bool enabled, int mode);
+        void SetAudioScenario(int scenario);
+        void ConfigureAudioProcessing(const AudioPipelineConfig& capture, const AudioPipelineConfig& playback);
+        bool IsVoxGateOpen() const;
+        void SetVoxMode(bool enabled);
+
+        // Debug and status
+        bool IsLocalAudioMuted() const;
+        std::string GetMetrics() const;
+        AgoraState GetState() const { return m_state.Load(); }
+
+        // Hot reads for polling callers (the JSI host object): any thread, straight from the
+        // snapshot and the lock-free tables, no queue hop, no string building, no JSON
+        template <typename Fn>
+        auto ReadState(Fn&& fn) const { return m_state.Read(std::forward<Fn>(fn)); }
+        ConnectionState GetConnectionState(const std::string& channelName) const; // "" = default channel
+        size_t ReadLevels(const std::string& channelName, VolumeChange* out, size_t capacity) const;
+        // Named counters: resolve a name once, then read it by index; -1 = no such counter
+        static const std::vector<std::string>& GetCounterNames();
+        static int FindCounter(const std::string& name);
+        double ReadCounter(int counter) const;
+
+        // Starts event delivery; the listener must outlive the core (nullptr = keep events native)
+        void SetListener(IAgoraCoreListener* listener);
+        void SetEventFlushInterval(int intervalMs);
+        void SetReconnectPolicy(const ReconnectPolicy& policy);
+        void EnableVolumeIndication(int intervalMs, int smooth);
+
+        // Hands batched events to the listener now instead of at the next flush tick
+        void FlushEvents() { m_eventBatcher.Flush(); }
+
+        AudioPipeline& GetCapturePipeline() { return m_capturePipeline; }
+        AudioPipeline& GetPlaybackPipeline() { return m_playbackPipeline; }
+        const CommandQueue& GetCommandQueue() const { return m_commandQueue; }
+
+        void Post(Command command) {
+            m_commandQueue.Post(std::move(command));
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static void OnVoxGateChanged(void* context, bool open);
+
+        struct Counter
+        {
+            std::string name;
+            double (*read)(const AgoraCore& core, size_t arg);
+            size_t arg = 0; // e.g. the MetricOp of a per-operation counter
+        };
+        static const std::vector<Counter>& Counters();
+
+        void ApplyVoiceTuning();
+        void RegisterAudioProcessors();
+        void AttachChannelSlots(AgoraEventHandler& handler, const std::string& channelName);
+        bool IsReady() const;
+        bool IsEchoTestRunning() const;
+        std::string GetCurrentChannel() const;
+        void PublishRadioState();
+        CurrentAudioState CaptureAudioState() const; // worker thread only (volumes and role)
+        void RunAudioAction(const AudioAction& action);
+        void ApplyVoxTransition(bool talking);
+        int MuteUplink(bool mute);
+        int SetDefaultChannelAudience(bool audience);
+        AgoraEventHandler& GetConnectionHandler(const std::string& channelName);
+        void LeaveCurrentChannel();
+        void OnJoinSucceeded(const std::string& channelName, int elapsedMs);
+        void FinishAccept(const std::string& channelName, bool warm, double acceptMs);
+        void StartReplayRing(const std::string& channelName);
+
+        // Connection recovery, driven by the monitor; keys are "" for the default channel,
+        // otherwise the Ex connection's channel name (radios, an accepted call)
+        void OnConnectionEvent(const AgoraEvent& event);
+        void ApplyConnectionTransition(const std::string& key, const ConnectionTransition& transition);
+        void RetryConnection(const std::string& key, uint64_t generation);
+        int RejoinConnection(const std::string& key);
+        void RestoreSession(const std::string& key);
+        std::string ConnectionChannelName(const std::string& key) const;
+
+        // Lobby connection for call signaling; messages are decoded and answered on the worker
+        int JoinSignalingConnection();
+        void OnSignalingJoined();
+        void OnSignalingMessage(const std::string& data);
+        void PumpCallSignal(uint32_t seq);
+        bool SendSignalingMessage(const std::string& message);
+
+        // Floor control: joined on the lobby for every floor channel we are in (worker thread only)
+        bool FloorApplies(const std::string& channelName) const;
+        void SyncFloorChannels();
+        void LeaveFloors();
+        void ScheduleFloorTick();
+        void FloorTick();
+        void ApplyFloorOutput(const FloorOutput& out);
+        void OnFloorChanged(const FloorChange& change);
+        std::string TalkTarget() const;
+        bool TalkNeedsFloor() const;
+        void EnforceFloor();
+
+        // Latency probe cycle, one probe at a time on worker timers (worker thread only)
+        void ArmLatencyProbe(uint64_t run, uint32_t probe);
+        void CheckLatencyProbe(uint64_t run, uint32_t probe, uint64_t deadlineMs);
+        void FinishLatencyProbe(bool cancelled);
+        void OnAudioDeviceStateChanged(const std::string& deviceId, int deviceType, int deviceState, Clock::time_point at);
+        bool EnumerateAudioDevices(AudioDeviceKind kind);
+        // Switches to the device the policy wants, if that isn't the one in use; the metric runs from since
+        void ApplyDevicePolicy(AudioDeviceKind kind, Clock::time_point since);
+        void PublishAudioDevices(AudioDeviceKind kind);
+
+        // Link profile (worker thread only)
+        bool InAudioChannel() const;
+        void ResolveLinkProfile(bool forceProbe);
+        void BeginLastmileProbe();
+        void ScheduleLastmileRetry();
+        void EndLastmileProbe();
+        void OnLastmileProbeResult(const LastmileProbeResult& result);
+        void PrepareLinkForJoin();
+        void ApplyLinkProfile(); // no engine call when the engine already has it
+        void PublishLinkProfile();
+
+        // IConnectionEngine over IVoiceEngine
+        int JoinConnection(const std::string& channelName, bool publishMicrophone) override;
+        int UpdateConnection(const std::string& channelName, bool publishMicrophone) override;
+        int LeaveConnection(const std::string& channelName) override;
+
+        // Engine and handlers are only touched on the command worker thread
+        EngineFactory m_engineFactory;
+        std::unique_ptr<IVoiceEngine> m_engine;
+        std::unique_ptr<AgoraEventHandler> m_eventHandler;
+        std::atomic<IAgoraCoreListener*> m_listener{ nullptr };
+
+        // Everything other threads may ask about, published as immutable snapshots
+        SnapshotCell<AgoraState> m_state;
+
+        // Radio-console mode: one connection per monitored radio
+        uint32_t m_localUid = 0;
+        MultiChannelSession m_radioSession{ *this };
+        std::map<std::string, std::unique_ptr<AgoraEventHandler>> m_connectionHandlers;
+
+        // Single native worker that runs every engine call posted from the module
+        CommandQueue m_commandQueue;
+
+        // Engine callbacks -> one listener batch per flush
+        EventBatcher m_eventBatcher;
+
+        // Our own DSP on recorded and playback PCM (run by the engine's audio thread)
+        AudioPipeline m_capturePipeline;  // microphone before encoding
+        AudioPipeline m_playbackPipeline; // everything we hear, after mixing all radios
+        bool m_audioProcessingEnabled = true;
+
+        // VOX: the capture gate decides when the mic is actually sent (worker thread only)
+        bool m_voxMode = false;
+        bool m_voxTalking = true;
+
+        // Warm start for private calls: a connection joined silently while the call rings,
+        // so accepting it is one publish switch instead of a full join (worker thread only)
+        std::string m_preparedChannel;
+        bool m_preparedJoined = false;
+        std::string m_callConnection;   // Ex connection carrying the current call; empty = default channel
+        std::string m_pendingAccept;    // accepted, waiting for onJoinChannelSuccess
+        bool m_pendingAcceptWarm = false;
+        Clock::time_point m_acceptStart;
+        double m_acceptJoinCallMs = 0.0;
+
+        // Talk-activity levels -> one listener update per interval (0 = off)
+        VolumeMeter m_volumeMeter;
+        int m_volumeIntervalMs = 0;
+        int m_volumeSmooth = 3;
+
+        // Link state per connection and the retries it asks for (worker thread only)
+        ConnectionMonitor m_connectionMonitor;
+        // Last volumes the app set, reapplied after a reconnect, and its role (-1 = never set)
+        int m_recordingVolume = -1;
+        int m_playbackVolume = -1;
+        int m_clientRole = -1;
+
+        // Call signaling (worker thread only): the lobby connection and its data stream (-1 = not yet)
+        std::string m_signalingChannel;
+        int m_signalingStream = -1;
+        CallSignaling m_callSignaling;
+
+        // Push-to-talk floor per channel, over the lobby stream (worker thread only)
+        FloorControl m_floorControl;
+        std::set<std::string> m_floorChannels; // floor control on, joined or not
+        bool m_floorTickScheduled = false;
+
+        // Operation latencies and the latest engine stats, always on and lock-free
+        Metrics m_metrics;
+
+        // Instant replay: per-radio rings filled on the audio thread, clips mixed into playback
+        ReplayRecorder m_replayRecorder;
+        ReplayPlayer m_replayPlayer;
+        std::map<std::string, int> m_replaySeconds; // per-radio ring length (worker thread only)
+        int m_defaultReplaySeconds = ReplayRecorder::kDefaultSeconds;
+
+        // Per-user frames land here first, then go on to the replay rings; renders playback.
+        // The leveller is called from its staging, so it goes first.
+        LoudnessNormalizer m_loudness;
+        RadioMixer m_radioMixer;
+
+        // Latency probe: mixed into both pipelines, driven from the worker
+        LatencyProbe m_latencyProbe;
+        LatencyReport m_probeReport;      // worker thread only
+        uint64_t m_probeRun = 0;          // bumped per run, so a stopped run's timers do nothing
+        bool m_probeLoopback = false;     // the probe started the loopback test and stops it
+
+        // Cue tones: synthesized once here, mixed into both pipelines
+        ToneEngine m_tones;
+
+        // External audio: the pump runs both pipelines in place of the SDK's frame observer
+        ExternalAudio m_externalAudio;
+
+        // Audio devices (worker thread only). Pinned: we chose the device, instead of following
+        // the system default.
+        DeviceRegistry m_deviceRegistry;
+        bool m_devicePinned[2] = {};
+
+        // Link profile per network (worker thread only); the cache outlives engines
+        std::string m_networkId;
+        LinkProfileCache m_linkCache;
+        LinkDecision m_linkDecision;           // for m_networkId; defaults until measured
+        AudioLinkProfile m_appliedLinkProfile; // what the engine has (a new one has the defaults)
+        bool m_lastmileProbing = false;
+        bool m_lastmileWanted = false;         // a probe was put off by a channel; run it once idle
+        uint64_t m_lastmileRun = 0;            // bumped per probe, so an ended probe's timeout does nothing
+        Clock::time_point m_lastmileStart;
+    };
+}
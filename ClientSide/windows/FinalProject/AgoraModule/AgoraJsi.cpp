@@ -0,0 +1,131 @@
+#include "pch.h"
+#include "AgoraJsi.h"
+#include <memory>
+#include <string>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace jsi = facebook::jsi;
+
+    namespace
+    {
+        const char* const kPropertyNames[] = {
+            "muted", "listenOnly", "engineReady", "channel", "talkChannel", "replaying", "voxOpen",
+            "connectionState", "levels", "counter", "counterNames", "playTone", "stopTone",
+        };
+
+        // Missing or not a string: "" (the default channel)
+        std::string StringArg(jsi::Runtime& runtime, const jsi::Value* args, size_t count, size_t index)
+        {
+            return index < count && args[index].isString() ? args[index].getString(runtime).utf8(runtime) : std::string();
+        }
+
+        jsi::Value MakeFunction(jsi::Runtime& runtime, const char* name, unsigned int params, jsi::HostFunctionType body)
+        {
+            return jsi::Value(jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forAscii(runtime, name), params, std::move(body)));
+        }
+    }
+
+    void AgoraJsiHost::Install(jsi::Runtime& runtime, AgoraCore& core)
+    {
+        runtime.global().setProperty(runtime, "AgoraNative", jsi::Object::createFromHostObject(runtime, std::make_shared<AgoraJsiHost>(core)));
+    }
+
+    jsi::Value AgoraJsiHost::get(jsi::Runtime& runtime, const jsi::PropNameID& name)
+    {
+        const std::string property = name.utf8(runtime);
+        AgoraCore* core = &m_core;
+
+        // Flags and names: one snapshot read each, strings built straight from the snapshot
+        if (property == "muted") {
+            return jsi::Value(m_core.ReadState([](const AgoraState& state) { return state.isLocalAudioMuted; }));
+        }
+        if (property == "listenOnly") {
+            return jsi::Value(m_core.ReadState([](const AgoraState& state) { return state.isListenOnly; }));
+        }
+        if (property == "engineReady") {
+            return jsi::Value(m_core.ReadState([](const AgoraState& state) { return state.isEngineCreated && state.isInitialized; }));
+        }
+        if (property == "channel") {
+            return m_core.ReadState([&runtime](const AgoraState& state) {
+                return jsi::Value(jsi::String::createFromUtf8(runtime, state.currentChannel));
+            });
+        }
+        if (property == "talkChannel") {
+            return m_core.ReadState([&runtime](const AgoraState& state) {
+                return jsi::Value(jsi::String::createFromUtf8(runtime, state.talkChannel));
+            });
+        }
+        if (property == "replaying") return jsi::Value(m_core.IsReplaying());
+        if (property == "voxOpen") return jsi::Value(m_core.IsVoxGateOpen());
+
+        if (property == "connectionState") {
+            return MakeFunction(runtime, "connectionState", 1,
+                [core](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    ConnectionState state = core->GetConnectionState(StringArg(rt, args, count, 0));
+                    return jsi::Value(jsi::String::createFromAscii(rt, ConnectionStateName(state)));
+                });
+        }
+        if (property == "levels") {
+            return MakeFunction(runtime, "levels", 1,
+                [core](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    // [uid, level] pairs, like the onVolumeLevels triples without the channel index
+                    VolumeChange levels[VolumeMeter::kSlots];
+                    size_t found = core->ReadLevels(StringArg(rt, args, count, 0), levels, VolumeMeter::kSlots);
+                    jsi::Array result(rt, found);
+                    for (size_t i = 0; i < found; ++i) {
+                        jsi::Array pair(rt, 2);
+                        pair.setValueAtIndex(rt, 0, jsi::Value(static_cast<double>(levels[i].uid)));
+                        pair.setValueAtIndex(rt, 1, jsi::Value(static_cast<int>(levels[i].level)));
+                        result.setValueAtIndex(rt, i, std::move(pair));
+                    }
+                    return jsi::Value(std::move(result));
+                });
+        }
+        if (property == "counter") {
+            return MakeFunction(runtime, "counter", 1,
+                [core](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    int counter = AgoraCore::FindCounter(StringArg(rt, args, count, 0));
+                    return counter >= 0 ? jsi::Value(core->ReadCounter(counter)) : jsi::Value::undefined();
+                });
+        }
+        if (property == "counterNames") {
+            return MakeFunction(runtime, "counterNames", 0,
+                [](jsi::Runtime& rt, const jsi::Value&, const jsi::Value*, size_t) {
+                    const auto& names = AgoraCore::GetCounterNames();
+                    jsi::Array result(rt, names.size());
+                    for (size_t i = 0; i < names.size(); ++i) {
+                        result.setValueAtIndex(rt, i, jsi::String::createFromAscii(rt, names[i]));
+                    }
+                    return jsi::Value(std::move(result));
+                });
+        }
+        // Cue triggers: one atomic store, so they are as cheap from here as the reads
+        if (property == "playTone") {
+            return MakeFunction(runtime, "playTone", 2,
+                [core](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    ToneCue cue = ToneCue::TalkStart;
+                    if (!ParseToneCue(StringArg(rt, args, count, 0).c_str(), cue)) return jsi::Value(false);
+                    core->PlayTone(cue, count > 1 && args[1].isBool() && args[1].getBool());
+                    return jsi::Value(true);
+                });
+        }
+        if (property == "stopTone") {
+            return MakeFunction(runtime, "stopTone", 1,
+                [core](jsi::Runtime& rt, const jsi::Value&, const jsi::Value* args, size_t count) {
+                    ToneCue cue = ToneCue::TalkStart;
+                    if (!ParseToneCue(StringArg(rt, args, count, 0).c_str(), cue)) return jsi::Value(false);
+                    core->StopTone(cue);
+                    return jsi::Value(true);
+                });
+        }
+        return jsi::Value::undefined();
+    }
+
+    std::vector<jsi::PropNameID> AgoraJsiHost::getPropertyNames(jsi::Runtime& runtime)
+    {
+        std::vector<jsi::PropNameID> names;
+        for (const char* name : kPropertyNames) names.push_back(jsi::PropNameID::forAscii(runtime, name));
+        return names;
+    }
+}
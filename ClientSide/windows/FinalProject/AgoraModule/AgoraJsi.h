@@ -0,0 +1,34 @@
+#pragma once
+#include <jsi/jsi.h>
+#include <vector>
+
+#include "AgoraCore.h"
+
+// global.AgoraNative: a JSI host object over AgoraCore's hot reads. Every property and
+// function runs synchronously on the JS thread and answers from the published snapshot or
+// the lock-free tables - no bridge queue, no callback, no JSON - so a screen can poll mute,
+// link state, talk levels and counters every frame. The cue tone triggers live here too, being
+// a single atomic store. AgoraModule's methods stay as they are for everything else that
+// changes state, and as the fallback where JSI is not available.
+namespace winrt::FinalProject::implementation
+{
+    class AgoraJsiHost : public facebook::jsi::HostObject
+    {
+    public:
+        // The core must outlive the runtime (AgoraManager is never destroyed)
+        explicit AgoraJsiHost(AgoraCore& core) : m_core(core) {}
+
+        // Sets global.AgoraNative; called on the JS thread whenever a runtime is (re)created
+        static void Install(facebook::jsi::Runtime& runtime, AgoraCore& core);
+
+        // Properties: muted, listenOnly, engineReady, channel, talkChannel, replaying, voxOpen
+        // Functions: connectionState(channel = ""), levels(channel = "") -> [[uid, level]],
+        // counter(name) -> number or undefined, counterNames(), playTone(cue, uplink = false)
+        // and stopTone(cue) -> false for an unknown cue
+        facebook::jsi::Value get(facebook::jsi::Runtime& runtime, const facebook::jsi::PropNameID& name) override;
+        std::vector<facebook::jsi::PropNameID> getPropertyNames(facebook::jsi::Runtime& runtime) override;
+
+    private:
+        AgoraCore& m_core;
+    };
+}
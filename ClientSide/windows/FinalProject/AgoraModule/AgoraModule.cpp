@@ -1,638 +1,313 @@
 #include "pch.h"
 #include "AgoraModule.h"
+#include "AgoraRtcEngine.h"
+#include "Logging.h"
 #include <windows.h>
-#include <string>
+#include <winrt/Windows.Networking.Connectivity.h>
+#include <winrt/Windows.Storage.h>
 #include <memory>
-#include <mutex>
+#include <string>
 
 namespace winrt::FinalProject::implementation
 {
-    // Use Agora namespace for convenience
-    using namespace agora::rtc;
-
-
-    
-    // Initialize singleton
-    AgoraManager* AgoraManager::instance = nullptr;
-    std::mutex AgoraManager::mutex_;
-    
-
-    
-    // AgoraEventHandler implementation
-    void AgoraEventHandler::onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed)
+    // Converts one flushed batch into a single onAgoraEvents bridge crossing
+    static void EmitEventBatch(winrt::Microsoft::ReactNative::ReactContext const& context,
+                               const std::vector<AgoraEvent>& events, const EventBatchStats& stats)
     {
-        std::string msg = std::string("🎉 SUCCESSFULLY JOINED CHANNEL!") + 
-                         std::string("\n  📺 Channel: ") + std::string(channel) + 
-                         std::string("\n  👤 My UID: ") + std::to_string(uid) + 
-                         std::string("\n  ⏱️ Time: ") + std::to_string(elapsed) + std::string("ms") +
-                         std::string("\n  🎤 Ready to publish microphone!") +
-                         std::string("\n  👂 Ready to receive remote audio!");
-        OutputDebugStringA(("AgoraEventHandler::onJoinChannelSuccess - " + msg + "\n").c_str());
-        
-        // Log additional connection info
-        OutputDebugStringA(("🔗 Connection established to channel: " + std::string(channel) + "\n").c_str());
-        OutputDebugStringA(("👤 My user ID in this channel: " + std::to_string(uid) + "\n").c_str());
-        OutputDebugStringA("🎤 Microphone is ready to transmit\n");
-        OutputDebugStringA("👂 Ready to receive audio from other users\n");
-        OutputDebugStringA("⏳ Waiting for other users to join...\n");
+        using winrt::Microsoft::ReactNative::JSValueArray;
+        using winrt::Microsoft::ReactNative::JSValueObject;
+
+        JSValueArray items;
+        for (const auto& event : events) {
+            JSValueObject item;
+            switch (event.type) {
+                case AgoraEventType::JoinChannelSuccess: item["type"] = "joinChannelSuccess"; item["elapsed"] = event.value; break;
+                case AgoraEventType::LeaveChannel: item["type"] = "leaveChannel"; item["duration"] = event.value; break;
+                case AgoraEventType::UserJoined: item["type"] = "userJoined"; item["elapsed"] = event.value; break;
+                case AgoraEventType::UserOffline: item["type"] = "userOffline"; item["reason"] = event.value; break;
+                case AgoraEventType::Error: item["type"] = "error"; item["code"] = event.value; break;
+                case AgoraEventType::TalkStateChanged: continue; // applied by the manager, reported as onTalkStateChanged
+                case AgoraEventType::ConnectionStateChanged:
+                case AgoraEventType::ConnectionLost:
+                case AgoraEventType::RejoinChannelSuccess: continue; // recovery runs natively, reported as onConnectionStateChanged
+            }
+            item["uid"] = static_cast<int64_t>(event.uid);
+            if (event.channel[0] != '\0') {
+                item["channel"] = std::string(event.channel);
+            }
+            items.push_back(std::move(item));
+        }
+        if (items.empty() && stats.dropped == 0 && stats.merged == 0) return;
+
+        context.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onAgoraEvents",
+            JSValueArray{
+                JSValueObject{
+                    {"events", std::move(items)},
+                    {"dropped", static_cast<int>(stats.dropped)},
+                    {"merged", static_cast<int>(stats.merged)}
+                }
+            }
+        );
     }
 
-    void AgoraEventHandler::onLeaveChannel(const RtcStats& stats)
+    // One onVolumeLevels crossing per interval carrying only the levels that moved
+    static void EmitVolumeUpdate(winrt::Microsoft::ReactNative::ReactContext const& context, const VolumeUpdate& update)
     {
-        std::string msg = std::string("👋 LEFT CHANNEL SUCCESSFULLY!") +
-                         std::string("\n  ⏱️ Duration: ") + std::to_string(stats.duration) + std::string("s");
-        OutputDebugStringA(("AgoraEventHandler::onLeaveChannel - " + msg + "\n").c_str());
-    }
+        using winrt::Microsoft::ReactNative::JSValueArray;
+        using winrt::Microsoft::ReactNative::JSValueObject;
 
-    void AgoraEventHandler::onUserJoined(uid_t uid, int elapsed)
-    {
-        std::string msg = std::string("🔥 REMOTE USER JOINED! THIS IS CRUCIAL!") +
-                         std::string("\n  👤 Remote UID: ") + std::to_string(uid) + 
-                         std::string("\n  ⏱️ Elapsed: ") + std::to_string(elapsed) + std::string("ms") +
-                         std::string("\n  🎉 You should now be able to hear each other!") +
-                         std::string("\n  🎤 Both devices can now communicate!");
-        OutputDebugStringA(("AgoraEventHandler::onUserJoined - " + msg + "\n").c_str());
-        
-        // Bridge to JS
-        if (m_reactContext) {
-            OutputDebugStringA("📡 Sending onUserJoined event to React Native...\n");
-            m_reactContext.EmitJSEvent(
-                L"RCTDeviceEventEmitter",
-                L"onUserJoined",
-                winrt::Microsoft::ReactNative::JSValueArray{
-                    winrt::Microsoft::ReactNative::JSValueObject{
-                        {"uid", static_cast<int>(uid)}
-                    }
-                }
-            );
-            OutputDebugStringA("✅ onUserJoined event sent to React Native successfully\n");
-        } else {
-            OutputDebugStringA("❌ ReactContext is null - cannot send onUserJoined event to JS\n");
+        JSValueArray channels;
+        for (const auto& channel : update.channels) {
+            channels.push_back(channel);
         }
-    }
 
-    void AgoraEventHandler::onUserOffline(uid_t uid, USER_OFFLINE_REASON_TYPE reason)
-    {
-        std::string reasonStr = (reason == USER_OFFLINE_QUIT) ? "QUIT" : 
-                               (reason == USER_OFFLINE_DROPPED) ? "DROPPED" : "BECOME_AUDIENCE";
-        std::string msg = std::string("😢 REMOTE USER LEFT!") +
-                         std::string("\n  👤 UID: ") + std::to_string(uid) + 
-                         std::string("\n  📝 Reason: ") + reasonStr +
-                         std::string("\n  ⚠️ Voice communication ended with this user");
-        OutputDebugStringA(("AgoraEventHandler::onUserOffline - " + msg + "\n").c_str());
-        
-        // Bridge to JS
-        if (m_reactContext) {
-            OutputDebugStringA("📡 Sending onUserOffline event to React Native...\n");
-            m_reactContext.EmitJSEvent(
-                L"RCTDeviceEventEmitter",
-                L"onUserOffline",
-                winrt::Microsoft::ReactNative::JSValueArray{
-                    winrt::Microsoft::ReactNative::JSValueObject{
-                        {"uid", static_cast<int>(uid)}
-                    }
-                }
-            );
-            OutputDebugStringA("✅ onUserOffline event sent to React Native successfully\n");
-        } else {
-            OutputDebugStringA("❌ ReactContext is null - cannot send onUserOffline event to JS\n");
+        // [channelIndex, uid, level] triples keep the payload small
+        JSValueArray levels;
+        for (const auto& change : update.levels) {
+            levels.push_back(JSValueArray{ static_cast<int>(change.channel), static_cast<int64_t>(change.uid), static_cast<int>(change.level) });
         }
-    }
 
-    void AgoraEventHandler::onError(int err, const char* msg)
-    {
-        std::string errorMsg = std::string("💥 CRITICAL AGORA ERROR!") +
-                              std::string("\n  🔢 Error Code: ") + std::to_string(err) + 
-                              std::string("\n  📝 Message: ") + std::string(msg ? msg : "Unknown error") +
-                              std::string("\n  ⚠️ This may prevent voice communication!");
-        OutputDebugStringA(("AgoraEventHandler::onError - " + errorMsg + "\n").c_str());
-    }
-
-    // AgoraManager implementation
-    void AgoraManager::InitializeEngine(const std::string& appId)
-    {
-        try {
-            OutputDebugStringA("🚀 AgoraManager::InitializeEngine - Starting\n");
-            OutputDebugStringA(("📱 App ID: " + appId + "\n").c_str());
-
-            // Clean up existing engine
-            if (m_rtcEngine) {
-                OutputDebugStringA("🧹 Cleaning up existing engine\n");
-                m_rtcEngine->leaveChannel();
-                m_rtcEngine->release();
-                m_rtcEngine = nullptr;
-                OutputDebugStringA("✅ Existing engine cleaned\n");
-            }
-
-            m_appId = appId;
-            OutputDebugStringA("✅ App ID stored\n");
+        JSValueArray activeSpeakers;
+        for (const auto& change : update.activeSpeakers) {
+            activeSpeakers.push_back(JSValueArray{ static_cast<int>(change.channel), static_cast<int64_t>(change.uid) });
+        }
 
-            // Create event handler
-            OutputDebugStringA("🔧 Creating event handler...\n");
-            m_eventHandler = std::make_unique<AgoraEventHandler>();
-            if (!m_eventHandler) {
-                OutputDebugStringA("❌ Failed to create event handler\n");
-                return;
-            }
-            OutputDebugStringA("✅ Event handler created\n");
-
-            // Create engine
-            OutputDebugStringA("🔧 Creating RTC engine...\n");
-            m_rtcEngine = createAgoraRtcEngine();
-            if (!m_rtcEngine) {
-                OutputDebugStringA("❌ Failed to create RTC engine\n");
-                return;
-            }
-            OutputDebugStringA("✅ RTC engine created successfully\n");
-
-            // Initialize
-            OutputDebugStringA("🔧 Initializing engine with context...\n");
-            RtcEngineContext context;
-            context.appId = m_appId.c_str();
-            context.eventHandler = m_eventHandler.get();
-            context.channelProfile = agora::CHANNEL_PROFILE_COMMUNICATION;
-            context.audioScenario = AUDIO_SCENARIO_DEFAULT;
-
-            int result = m_rtcEngine->initialize(context);
-            OutputDebugStringA(("🔍 Initialize result: " + std::to_string(result) + "\n").c_str());
-            
-            if (result != 0) {
-                OutputDebugStringA(("❌ Failed to initialize, error: " + std::to_string(result) + "\n").c_str());
-                m_rtcEngine->release();
-                m_rtcEngine = nullptr;
-                m_isInitialized = false;
-                return;
+        context.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onVolumeLevels",
+            JSValueArray{
+                JSValueObject{
+                    {"channels", std::move(channels)},
+                    {"levels", std::move(levels)},
+                    {"activeSpeakers", std::move(activeSpeakers)}
+                }
             }
-            OutputDebugStringA("✅ Engine initialized successfully\n");
-
-            // Enable audio
-            OutputDebugStringA("🔧 Enabling audio...\n");
-            result = m_rtcEngine->enableAudio();
-            OutputDebugStringA(("🔍 EnableAudio result: " + std::to_string(result) + "\n").c_str());
-
-            // Enable AI Noise Suppression for better audio quality
-            OutputDebugStringA("🤖 Enabling AI Noise Suppression (Aggressive mode)...\n");
-            result = m_rtcEngine->setAINSMode(true, agora::rtc::AINS_MODE_AGGRESSIVE);
-            OutputDebugStringA(("🔍 AI Noise Suppression result: " + std::to_string(result) + "\n").c_str());
-
-            // Set audio scenario for communication (optimizes for voice)
-            OutputDebugStringA("🎤 Setting audio scenario for meeting/voice communication...\n");
-            result = m_rtcEngine->setAudioScenario(agora::rtc::AUDIO_SCENARIO_MEETING);
-            OutputDebugStringA(("🔍 Audio scenario result: " + std::to_string(result) + "\n").c_str());
-
-            // Set client role
-            OutputDebugStringA("🔧 Setting client role...\n");
-            result = m_rtcEngine->setClientRole(CLIENT_ROLE_BROADCASTER);
-            OutputDebugStringA(("🔍 SetClientRole result: " + std::to_string(result) + "\n").c_str());
-
-            // Mark as initialized
-            m_isInitialized = true;
-            OutputDebugStringA("✅ AgoraManager::InitializeEngine - COMPLETED SUCCESSFULLY!\n");
-            OutputDebugStringA(("✅ m_isInitialized = " + std::string(m_isInitialized ? "true" : "false") + "\n").c_str());
-
-        } catch (const std::exception& e) {
-            OutputDebugStringA(("❌ Exception in InitializeEngine: " + std::string(e.what()) + "\n").c_str());
-            m_isInitialized = false;
-        } catch (...) {
-            OutputDebugStringA("❌ Unknown exception in InitializeEngine\n");
-            m_isInitialized = false;
-        }
+        );
     }
 
-    void AgoraManager::StartEchoTest()
+    // AgoraManager implementation
+    AgoraManager::AgoraManager() : AgoraCore([]() { return std::make_unique<AgoraRtcEngine>(); })
     {
-        try {
-            OutputDebugStringA("🎤 AgoraManager::StartEchoTest - Starting Audio Device Loopback Test\n");
-            OutputDebugStringA(("🔍 m_isInitialized = " + std::string(m_isInitialized ? "true" : "false") + "\n").c_str());
-            OutputDebugStringA(("🔍 m_rtcEngine = " + std::string(m_rtcEngine ? "NOT NULL" : "NULL") + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized - CANNOT START ECHO TEST\n");
-                return;
-            }
-
-            if (m_isEchoTestRunning) {
-                OutputDebugStringA("⚠️ Echo test already running\n");
-                return;
-            }
-
-            // Use AAudioDeviceManager class for Windows SDK
-            OutputDebugStringA("🔧 Creating AAudioDeviceManager...\n");
-            agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
-            if (!audioDeviceManager) {
-                OutputDebugStringA("❌ Failed to create audio device manager\n");
-                return;
-            }
-
-            // Start audio device loopback test (perfect for Windows!)
-            OutputDebugStringA("🔧 Starting audio device loopback test...\n");
-            int result = audioDeviceManager->startAudioDeviceLoopbackTest(1000); // 1 second interval
-            
-            if (result == 0) {
-                m_isEchoTestRunning = true;
-                OutputDebugStringA("✅ Audio device loopback test started successfully!\n");
-                OutputDebugStringA("🔊 You should hear yourself through the loopback test!\n");
-                OutputDebugStringA("🎧 This is a direct device-level audio loopback!\n");
-            } else {
-                OutputDebugStringA(("❌ Failed to start audio device loopback test, error: " + std::to_string(result) + "\n").c_str());
-            }
-
-        } catch (const std::exception& e) {
-            OutputDebugStringA(("❌ Exception in StartEchoTest: " + std::string(e.what()) + "\n").c_str());
-        } catch (...) {
-            OutputDebugStringA("❌ Unknown exception in StartEchoTest\n");
-        }
+        StartLogging();
+        WatchNetwork();
     }
 
-    void AgoraManager::StopEchoTest()
+    void AgoraManager::StartLogging()
     {
+        LogConfig config;
         try {
-            if (!m_rtcEngine || !m_isEchoTestRunning) return;
-            
-            OutputDebugStringA("🔧 Stopping audio device loopback test...\n");
-            
-            // Use AAudioDeviceManager class for Windows SDK
-            agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
-            if (!audioDeviceManager) {
-                OutputDebugStringA("❌ Failed to create audio device manager\n");
-                return;
-            }
-            
-            // Stop the audio device loopback test
-            int result = audioDeviceManager->stopAudioDeviceLoopbackTest();
-            if (result == 0) {
-                OutputDebugStringA("✅ Audio device loopback test stopped successfully\n");
-            } else {
-                OutputDebugStringA(("❌ Failed to stop audio device loopback test, error: " + std::to_string(result) + "\n").c_str());
-            }
-            
-            m_isEchoTestRunning = false;
-            OutputDebugStringA("✅ Echo test stopped\n");
+            // Packaged app: the only writable place is the app's local folder
+            std::wstring folder{ winrt::Windows::Storage::ApplicationData::Current().LocalFolder().Path() };
+            config.filePath = winrt::to_string(folder) + "\\agora.log";
         } catch (...) {
-            OutputDebugStringA("❌ Exception in StopEchoTest\n");
+            config.filePath.clear();
         }
+#if defined(_DEBUG)
+        config.mirror = [](const char* line) { OutputDebugStringA(line); };
+#endif
+        Log::Start(std::move(config));
     }
 
-    void AgoraManager::JoinChannel(const std::string& channelName)
+    std::string AgoraManager::CurrentNetworkId()
     {
+        using namespace winrt::Windows::Networking::Connectivity;
         try {
-            OutputDebugStringA(("🚀 ATTEMPTING TO JOIN CHANNEL: " + channelName + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized - CANNOT JOIN CHANNEL\n");
-                return;
-            }
-
-            // Stop echo test if running (critical requirement)
-            if (m_isEchoTestRunning) {
-                OutputDebugStringA("⚠️ Stopping echo test before joining channel\n");
-                StopEchoTest();
-            }
-
-            // Leave current channel if in one
-            if (!m_currentChannel.empty()) {
-                OutputDebugStringA("⚠️ Already in channel, leaving current channel first\n");
-                m_rtcEngine->leaveChannel();
-                m_currentChannel.clear();
-            }
-
-            OutputDebugStringA("🔧 CONFIGURING CHANNEL OPTIONS FOR VOICE COMMUNICATION...\n");
-            ChannelMediaOptions options;
-            options.publishMicrophoneTrack = true;          // 🎤 PUBLISH YOUR VOICE (app can mute later)
-            options.autoSubscribeAudio = true;             // 👂 HEAR OTHERS
-            options.autoSubscribeVideo = false;            // ❌ NO VIDEO
-            options.enableAudioRecordingOrPlayout = true;  // 🔊 ENABLE AUDIO
-            options.clientRoleType = CLIENT_ROLE_BROADCASTER; // 📡 BROADCASTER ROLE
-
-            OutputDebugStringA("✅ Channel options configured:\n");
-            OutputDebugStringA("  🎤 Publishing microphone: YES\n");
-            OutputDebugStringA("  👂 Auto-subscribe to remote audio: YES\n");
-            OutputDebugStringA("  👤 Client role: BROADCASTER\n");
-
-            // Optimize audio quality before joining channel
-            OutputDebugStringA("🎵 Optimizing audio quality for voice communication...\n");
-            
-            // Set recording volume to optimal level (reduce background noise pickup)
-            m_rtcEngine->adjustRecordingSignalVolume(80); // Slightly reduce from default 100
-            OutputDebugStringA("🔊 Recording volume set to 80 (reduces background noise)\n");
-            
-            // Enable local voice effects for cleaner sound (reduce low frequency noise)
-            m_rtcEngine->setLocalVoiceEqualization(agora::rtc::AUDIO_EQUALIZATION_BAND_125, -15);
-            m_rtcEngine->setLocalVoiceEqualization(agora::rtc::AUDIO_EQUALIZATION_BAND_250, -10);
-            OutputDebugStringA("🎚️ Voice equalization applied (reduced 125Hz & 250Hz for less noise)\n");
-
-            OutputDebugStringA("🔗 CALLING joinChannel()...\n");
-            // New project in testing mode - no token required
-            OutputDebugStringA("🆓 Using testing mode (no token required) for new Agora project\n");
-            int result = m_rtcEngine->joinChannel(nullptr, channelName.c_str(), 0, options);
-            
-            OutputDebugStringA(("🔍 joinChannel() result: " + std::to_string(result) + "\n").c_str());
-            
-            if (result == 0) {
-                m_currentChannel = channelName;
-                m_isLocalAudioMuted = false;  // Always start unmuted, app will mute if needed
-                OutputDebugStringA(("🎉 SUCCESS! Initiated join to channel: " + channelName + "\n").c_str());
-                OutputDebugStringA("🔓 Microphone starts UNMUTED (app will control mute for ListenOnly)\n");
-                OutputDebugStringA("⏳ Waiting for onJoinChannelSuccess callback...\n");
-                OutputDebugStringA("👀 Watch for onUserJoined when other device connects!\n");
-            } else {
-                OutputDebugStringA(("💥 FAILED TO JOIN CHANNEL! Error: " + std::to_string(result) + "\n").c_str());
-                
-                switch (result) {
-                    case -2:
-                        OutputDebugStringA("❌ Invalid parameter - check channel name\n");
-                        break;
-                    case -7:
-                        OutputDebugStringA("❌ SDK not initialized\n");
-                        break;
-                    case -8:
-                        OutputDebugStringA("❌ Echo test still running - this prevents joining!\n");
-                        break;
-                    case -17:
-                        OutputDebugStringA("❌ Request rejected - already in channel?\n");
-                        break;
-                    default:
-                        OutputDebugStringA(("❌ Unknown error: " + std::to_string(result) + "\n").c_str());
-                        break;
-                }
-            }
+            ConnectionProfile profile = NetworkInformation::GetInternetConnectionProfile();
+            if (!profile) return {};
+            // The profile name tells Wi-Fi networks apart, the adapter a dock's Ethernet from the laptop's
+            std::string id = winrt::to_string(profile.ProfileName());
+            if (NetworkAdapter adapter = profile.NetworkAdapter()) {
+                id += "|" + winrt::to_string(winrt::to_hstring(adapter.NetworkAdapterId()));
+            }
+            return id;
         } catch (...) {
-            OutputDebugStringA("💥 EXCEPTION in JoinChannel!\n");
+            return {};
         }
     }
 
-    void AgoraManager::LeaveChannel()
+    void AgoraManager::WatchNetwork()
     {
+        using namespace winrt::Windows::Networking::Connectivity;
+        Post(Command{ "", [this, networkId = CurrentNetworkId()]() { SetNetworkIdentity(networkId); }, nullptr });
         try {
-            if (!m_rtcEngine || m_currentChannel.empty()) return;
-            
-            m_rtcEngine->leaveChannel();
-            m_currentChannel.clear();
-            m_isLocalAudioMuted = false;  // Reset mute state when leaving channel
-            OutputDebugStringA("✅ Left channel\n");
-            OutputDebugStringA("🔄 Mute state reset to UNMUTED\n");
+            // Raised on a system thread; the manager is never destroyed, so the handler is never removed
+            NetworkInformation::NetworkStatusChanged([this](winrt::Windows::Foundation::IInspectable const&) {
+                Post(Command{ "", [this, networkId = CurrentNetworkId()]() { SetNetworkIdentity(networkId); }, nullptr });
+            });
         } catch (...) {
-            OutputDebugStringA("❌ Exception in LeaveChannel\n");
+            AGORA_LOG_WARN("⚠️ Network changes not watched - link profiles stay on the first network");
         }
     }
 
-    void AgoraManager::MuteLocalAudio(bool mute)
+    void AgoraManager::SetReactContext(winrt::Microsoft::ReactNative::ReactContext const& context)
     {
-        try {
-            OutputDebugStringA(("🎤 MuteLocalAudio - " + std::string(mute ? "MUTING" : "UNMUTING") + " microphone\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized\n");
-                return;
-            }
-
-            int result = m_rtcEngine->muteLocalAudioStream(mute);
-            if (result == 0) {
-                m_isLocalAudioMuted = mute;  // Track the mute state internally
-                OutputDebugStringA(("✅ Microphone " + std::string(mute ? "MUTED" : "UNMUTED") + " successfully\n").c_str());
-                OutputDebugStringA(("📊 Internal mute state updated to: " + std::string(mute ? "MUTED" : "UNMUTED") + "\n").c_str());
-            } else {
-                OutputDebugStringA(("❌ Failed to mute/unmute, error: " + std::to_string(result) + "\n").c_str());
-            }
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in MuteLocalAudio\n");
-        }
+        m_reactContext = context;
+        SetListener(context ? this : nullptr);
     }
 
-    void AgoraManager::EnableLocalAudio(bool enabled)
+    void AgoraManager::OnEventBatch(const std::vector<AgoraEvent>& events, const EventBatchStats& stats)
     {
-        try {
-            OutputDebugStringA(("🎤 EnableLocalAudio - " + std::string(enabled ? "ENABLING" : "DISABLING") + " audio capture\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized\n");
-                return;
-            }
-
-            int result = m_rtcEngine->enableLocalAudio(enabled);
-            if (result == 0) {
-                OutputDebugStringA(("✅ Audio capture " + std::string(enabled ? "ENABLED" : "DISABLED") + " successfully\n").c_str());
-            } else {
-                OutputDebugStringA(("❌ Failed to enable/disable audio, error: " + std::to_string(result) + "\n").c_str());
-            }
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in EnableLocalAudio\n");
-        }
+        if (m_reactContext) EmitEventBatch(m_reactContext, events, stats);
     }
 
-    void AgoraManager::AdjustRecordingVolume(int volume)
+    void AgoraManager::OnVolumeUpdate(const VolumeUpdate& update)
     {
-        try {
-            OutputDebugStringA(("\xF0\x9F\x94\x8A AdjustRecordingVolume - Setting to " + std::to_string(volume) + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("\xE2\x9D\x8C Engine not initialized\n");
-                return;
-            }
-
-            int clampedVolume = std::max(0, std::min(400, volume));
-            int result = m_rtcEngine->adjustRecordingSignalVolume(clampedVolume);
-            if (result == 0) {
-                OutputDebugStringA(("\xE2\x9C\x85 Recording volume set to " + std::to_string(clampedVolume) + "\n").c_str());
-            } else {
-                OutputDebugStringA(("\xE2\x9D\x8C Failed to adjust volume, error: " + std::to_string(result) + "\n").c_str());
-            }
-        } catch (...) {
-            OutputDebugStringA("\xE2\x9D\x8C Exception in AdjustRecordingVolume\n");
-        }
+        if (m_reactContext) EmitVolumeUpdate(m_reactContext, update);
     }
 
-    // Add AdjustPlaybackVolume implementation
-    void AgoraManager::AdjustPlaybackVolume(int volume)
+    void AgoraManager::OnTalkStateChanged(bool talking, bool vox)
     {
-        try {
-            OutputDebugStringA(("\xF0\x9F\x94\x8A AdjustPlaybackVolume - Setting to " + std::to_string(volume) + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("\xE2\x9D\x8C Engine not initialized\n");
-                return;
-            }
-
-            int clampedVolume = std::max(0, std::min(400, volume));
-            int result = m_rtcEngine->adjustPlaybackSignalVolume(clampedVolume);
-            if (result == 0) {
-                OutputDebugStringA(("\xE2\x9C\x85 Playback volume set to " + std::to_string(clampedVolume) + "\n").c_str());
-            } else {
-                OutputDebugStringA(("\xE2\x9D\x8C Failed to adjust playback volume, error: " + std::to_string(result) + "\n").c_str());
+        if (!m_reactContext) return;
+
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onTalkStateChanged",
+            winrt::Microsoft::ReactNative::JSValueArray{
+                winrt::Microsoft::ReactNative::JSValueObject{
+                    {"talking", talking},
+                    {"vox", vox}
+                }
             }
-        } catch (...) {
-            OutputDebugStringA("\xE2\x9D\x8C Exception in AdjustPlaybackVolume\n");
-        }
+        );
     }
 
-    void AgoraManager::SetClientRole(int role)
+    void AgoraManager::OnCallLatency(const std::string& channelName, bool warm, double acceptMs)
     {
-        try {
-            OutputDebugStringA(("👤 SetClientRole - Setting to " + std::to_string(role) + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized\n");
-                return;
-            }
-
-            CLIENT_ROLE_TYPE clientRole = static_cast<CLIENT_ROLE_TYPE>(role);
-            int result = m_rtcEngine->setClientRole(clientRole);
-            if (result == 0) {
-                OutputDebugStringA("✅ Client role set successfully\n");
-            } else {
-                OutputDebugStringA(("❌ Failed to set client role, error: " + std::to_string(result) + "\n").c_str());
+        if (!m_reactContext) return;
+
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onCallLatency",
+            winrt::Microsoft::ReactNative::JSValueArray{
+                winrt::Microsoft::ReactNative::JSValueObject{
+                    {"channel", channelName},
+                    {"warm", warm},
+                    {"acceptMs", acceptMs}
+                }
             }
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in SetClientRole\n");
-        }
+        );
     }
 
-    void AgoraManager::EnableNoiseSuppressionMode(bool enabled, int mode)
+    void AgoraManager::OnConnectionStateChanged(const std::string& channelName, const ConnectionTransition& transition)
     {
-        try {
-            OutputDebugStringA(("🤖 EnableNoiseSuppressionMode - " + std::string(enabled ? "ENABLING" : "DISABLING") + " mode: " + std::to_string(mode) + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized\n");
-                return;
-            }
-
-            // Convert int to proper enum (0=Balanced, 1=Aggressive, 2=UltraLowLatency)
-            agora::rtc::AUDIO_AINS_MODE ainsMode;
-            switch (mode) {
-                case 0: ainsMode = agora::rtc::AINS_MODE_BALANCED; break;
-                case 1: ainsMode = agora::rtc::AINS_MODE_AGGRESSIVE; break;
-                case 2: ainsMode = agora::rtc::AINS_MODE_ULTRALOWLATENCY; break;
-                default: ainsMode = agora::rtc::AINS_MODE_BALANCED; break;
-            }
-            
-            int result = m_rtcEngine->setAINSMode(enabled, ainsMode);
-            if (result == 0) {
-                OutputDebugStringA(("✅ Noise suppression " + std::string(enabled ? "ENABLED" : "DISABLED") + " successfully\n").c_str());
-            } else {
-                OutputDebugStringA(("❌ Failed to set noise suppression, error: " + std::to_string(result) + "\n").c_str());
+        if (!m_reactContext) return;
+
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onConnectionStateChanged",
+            winrt::Microsoft::ReactNative::JSValueArray{
+                winrt::Microsoft::ReactNative::JSValueObject{
+                    {"channel", channelName},
+                    {"state", ConnectionStateName(transition.state)},
+                    {"reason", transition.reason},
+                    {"attempt", transition.attempt},
+                    {"retryInMs", transition.retry ? transition.retryDelayMs : 0}
+                }
             }
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in EnableNoiseSuppressionMode\n");
-        }
+        );
     }
 
-    void AgoraManager::SetAudioScenario(int scenario)
+    static winrt::Microsoft::ReactNative::JSValueObject ToJSValue(const CallSignal& signal)
     {
-        try {
-            OutputDebugStringA(("🎵 SetAudioScenario - Setting to " + std::to_string(scenario) + "\n").c_str());
-            
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("❌ Engine not initialized\n");
-                return;
-            }
-
-            // Convert int to proper enum (0=Default, 3=Game_Streaming, 5=Chatroom, 8=Meeting)
-            agora::rtc::AUDIO_SCENARIO_TYPE audioScenario;
-            switch (scenario) {
-                case 0: audioScenario = agora::rtc::AUDIO_SCENARIO_DEFAULT; break;
-                case 3: audioScenario = agora::rtc::AUDIO_SCENARIO_GAME_STREAMING; break;
-                case 5: audioScenario = agora::rtc::AUDIO_SCENARIO_CHATROOM; break;
-                case 8: audioScenario = agora::rtc::AUDIO_SCENARIO_MEETING; break;
-                default: audioScenario = agora::rtc::AUDIO_SCENARIO_MEETING; break;
-            }
-            
-            int result = m_rtcEngine->setAudioScenario(audioScenario);
-            if (result == 0) {
-                OutputDebugStringA("✅ Audio scenario set successfully\n");
-            } else {
-                OutputDebugStringA(("❌ Failed to set audio scenario, error: " + std::to_string(result) + "\n").c_str());
-            }
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in SetAudioScenario\n");
-        }
+        return winrt::Microsoft::ReactNative::JSValueObject{
+            {"type", CallSignalTypeName(signal.type)},
+            {"from", signal.fromUser},
+            {"to", signal.toUser},
+            {"invitationId", signal.invitationId},
+            {"channelName", signal.channelName},
+            {"callerName", signal.callerName}
+        };
     }
 
-    bool AgoraManager::IsLocalAudioMuted()
+    void AgoraManager::OnCallSignal(const CallSignal& signal)
     {
-        try {
-            OutputDebugStringA(("🔍 IsLocalAudioMuted - Checking mute status: " + std::string(m_isLocalAudioMuted ? "MUTED" : "UNMUTED") + "\n").c_str());
-            return m_isLocalAudioMuted;
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in IsLocalAudioMuted\n");
-            return false;
-        }
+        if (!m_reactContext) return;
+
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onCallSignal",
+            winrt::Microsoft::ReactNative::JSValueArray{ ToJSValue(signal) }
+        );
     }
 
-    void AgoraManager::MuteRemoteAudioStream(unsigned int uid, bool mute)
+    void AgoraManager::OnCallSignalStatus(const CallSignal& signal, bool delivered)
     {
-        try {
-            OutputDebugStringA((std::string("\xF0\x9F\x94\x8A MuteRemoteAudioStream - UID: ") + std::to_string(uid) + (mute ? " MUTE" : " UNMUTE") + "\n").c_str());
-            if (!m_isInitialized || !m_rtcEngine) {
-                OutputDebugStringA("\xE2\x9D\x8C Engine not initialized\n");
-                return;
-            }
-            int result = m_rtcEngine->muteRemoteAudioStream(uid, mute);
-            if (result == 0) {
-                OutputDebugStringA((std::string("\xE2\x9C\x85 Remote audio ") + (mute ? "muted" : "unmuted") + " for UID: " + std::to_string(uid) + "\n").c_str());
-            } else {
-                OutputDebugStringA((std::string("\xE2\x9D\x8C Failed to mute/unmute remote audio, error: ") + std::to_string(result) + "\n").c_str());
-            }
-        } catch (...) {
-            OutputDebugStringA("\xE2\x9D\x8C Exception in MuteRemoteAudioStream\n");
-        }
+        if (!m_reactContext) return;
+
+        auto status = ToJSValue(signal);
+        status["delivered"] = delivered;
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onCallSignalStatus",
+            winrt::Microsoft::ReactNative::JSValueArray{ std::move(status) }
+        );
     }
 
-    void AgoraManager::ReleaseEngine()
+    void AgoraManager::OnFloorChanged(const FloorChange& change)
     {
-        try {
-            if (m_rtcEngine) {
-                if (!m_currentChannel.empty()) {
-                    m_rtcEngine->leaveChannel();
-                    m_currentChannel.clear();
+        if (!m_reactContext) return;
+
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onFloorChanged",
+            winrt::Microsoft::ReactNative::JSValueArray{
+                winrt::Microsoft::ReactNative::JSValueObject{
+                    {"channelName", change.channelName},
+                    {"state", FloorStateName(change.state)},
+                    {"reason", FloorReasonName(change.reason)},
+                    {"holder", change.holder},
+                    {"priority", change.priority},
+                    {"waitedMs", static_cast<int64_t>(change.waitedMs)}
                 }
-                m_rtcEngine->release();
-                m_rtcEngine = nullptr;
             }
-            m_eventHandler.reset();
-            m_isInitialized = false;
-            m_isEchoTestRunning = false;
-            OutputDebugStringA("✅ Engine released\n");
-        } catch (...) {
-            OutputDebugStringA("❌ Exception in ReleaseEngine\n");
-        }
+        );
     }
 
-    std::string AgoraManager::GetStatus()
+    void AgoraManager::OnLatencyProbeFinished(const LatencyReport& report)
     {
-        std::string status = "🔧 AGORA MANAGER STATUS:\n\n";
-        
-        if (m_rtcEngine) {
-            status += "✅ RTC Engine: CREATED\n";
-        } else {
-            status += "❌ RTC Engine: NOT CREATED\n";
-        }
-
-        if (m_isInitialized) {
-            status += "✅ Engine Status: INITIALIZED\n";
-            status += "📱 App ID: " + m_appId + "\n";
-        } else {
-            status += "❌ Engine Status: NOT INITIALIZED\n";
-        }
+        if (!m_reactContext) return;
 
-        if (!m_currentChannel.empty()) {
-            status += "🔗 Current Channel: " + m_currentChannel + "\n";
-        } else {
-            status += "⭕ Current Channel: NONE\n";
+        // Misses are left out; probes - found says how many
+        winrt::Microsoft::ReactNative::JSValueArray latencies;
+        for (const auto& sample : report.samples) {
+            if (sample.found) latencies.push_back(sample.latencyMs);
         }
 
-        if (m_isEchoTestRunning) {
-            status += "🎤 Echo Test: RUNNING\n";
-        } else {
-            status += "⭕ Echo Test: STOPPED\n";
-        }
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onLatencyProbeFinished",
+            winrt::Microsoft::ReactNative::JSValueArray{
+                winrt::Microsoft::ReactNative::JSValueObject{
+                    {"path", ProbePathName(report.path)},
+                    {"signal", ProbeSignalName(report.signal)},
+                    {"audioScenario", report.audioScenario},
+                    {"noiseSuppressionMode", report.noiseSuppressionMode},
+                    {"probes", report.probes},
+                    {"found", report.found},
+                    {"minMs", report.minMs},
+                    {"p50Ms", report.p50Ms},
+                    {"p95Ms", report.p95Ms},
+                    {"maxMs", report.maxMs},
+                    {"meanMs", report.meanMs},
+                    {"jitterMs", report.jitterMs},
+                    {"meanScore", static_cast<double>(report.meanScore)},
+                    {"cancelled", report.cancelled},
+                    {"latenciesMs", std::move(latencies)}
+                }
+            }
+        );
+    }
 
-        if (m_isInitialized && m_rtcEngine) {
-            status += "\n🎉 STATUS: READY FOR VOICE COMMUNICATION!";
-        } else {
-            status += "\n⚠️ STATUS: NEEDS INITIALIZATION";
-        }
+    void AgoraManager::OnAudioDevicesChanged(const AudioDeviceList& list)
+    {
+        if (!m_reactContext) return;
 
-        return status;
+        m_reactContext.EmitJSEvent(
+            L"RCTDeviceEventEmitter",
+            L"onAudioDevicesChanged",
+            winrt::Microsoft::ReactNative::JSValueArray{ AudioDeviceListToJs(list) }
+        );
     }
-}
\ No newline at end of file
+}
@@ -1,152 +1,188 @@
 #pragma once
 #include <winrt/Microsoft.ReactNative.h>
 #include "NativeModules.h"
-#include <string>
+#include "JSI/JsiApiContext.h"
+#include <algorithm>
 #include <functional>
-#include <mutex>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
-// Include Agora SDK headers properly
-#include "IAgoraRtcEngine.h"
-#include "AgoraBase.h"
-#include "AgoraMediaBase.h"
+#include "AgoraCore.h"
+#include "AgoraJsi.h"
 
 namespace winrt::FinalProject::implementation
 {
-    // Forward declarations
-    using namespace agora::rtc;
-    
-    // Event handler for Agora callbacks
-    class AgoraEventHandler : public IRtcEngineEventHandler
+    // Same shape for the onAudioDevicesChanged event and the GetAudioDevices read
+    inline winrt::Microsoft::ReactNative::JSValueObject AudioDeviceListToJs(const AudioDeviceList& list)
     {
-    public:
-        AgoraEventHandler() = default;
-        virtual ~AgoraEventHandler() = default;
+        winrt::Microsoft::ReactNative::JSValueArray devices;
+        for (const auto& device : list.devices) {
+            devices.push_back(winrt::Microsoft::ReactNative::JSValueObject{ {"id", device.id}, {"name", device.name} });
+        }
+        winrt::Microsoft::ReactNative::JSValueArray preferred;
+        for (const auto& entry : list.preferred) preferred.push_back(entry);
+
+        return winrt::Microsoft::ReactNative::JSValueObject{
+            {"kind", AudioDeviceKindName(list.kind)},
+            {"devices", std::move(devices)},
+            {"activeId", list.activeId},
+            {"preferred", std::move(preferred)}
+        };
+    }
 
-        // Add ReactContext setter
-        void SetReactContext(winrt::Microsoft::ReactNative::ReactContext const& context) {
-            m_reactContext = context;
+    // [{step, channel, value}] for ApplyAudioState's report
+    inline winrt::Microsoft::ReactNative::JSValueArray AudioActionsToJs(const std::vector<AudioAction>& actions)
+    {
+        winrt::Microsoft::ReactNative::JSValueArray items;
+        for (const auto& action : actions) {
+            items.push_back(winrt::Microsoft::ReactNative::JSValueObject{
+                {"step", AudioStepName(action.step)},
+                {"channel", action.channel},
+                {"value", action.value}
+            });
         }
+        return items;
+    }
 
-        // Override key event methods
-        void onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed) override;
-        void onLeaveChannel(const RtcStats& stats) override;
-        void onUserJoined(uid_t uid, int elapsed) override;
-        void onUserOffline(uid_t uid, USER_OFFLINE_REASON_TYPE reason) override;
-        void onError(int err, const char* msg) override;
+    // Global singleton: the portable core on the real Agora engine, bridged to React Native
+    class AgoraManager : public AgoraCore, private IAgoraCoreListener
+    {
     private:
         winrt::Microsoft::ReactNative::ReactContext m_reactContext{ nullptr };
-    };
 
-    // Global singleton class for Agora management
-    class AgoraManager
-    {
-    private:
-        static AgoraManager* instance;
-        static std::mutex mutex_;
-        
-        IRtcEngine* m_rtcEngine = nullptr;
-        std::unique_ptr<AgoraEventHandler> m_eventHandler;
-        std::string m_appId;
-        std::string m_currentChannel;
-        bool m_isInitialized = false;
-        bool m_isEchoTestRunning = false;
-        
-        // New state tracking variables
-        bool m_isLocalAudioMuted = false;
-        bool m_isLocalAudioEnabled = true;
-        int m_recordingVolume = 100;
-
-        AgoraManager() = default;
+        AgoraManager();
+
+        static void StartLogging();
+
+        // "<connection profile>|<adapter guid>" of the internet connection, "" when offline;
+        // keys the per-network link profile cache
+        static std::string CurrentNetworkId();
+        void WatchNetwork();
+
+        // IAgoraCoreListener -> RCTDeviceEventEmitter
+        void OnEventBatch(const std::vector<AgoraEvent>& events, const EventBatchStats& stats) override;
+        void OnVolumeUpdate(const VolumeUpdate& update) override;
+        void OnTalkStateChanged(bool talking, bool vox) override;
+        void OnCallLatency(const std::string& channelName, bool warm, double acceptMs) override;
+        void OnConnectionStateChanged(const std::string& channelName, const ConnectionTransition& transition) override;
+        void OnCallSignal(const CallSignal& signal) override;
+        void OnCallSignalStatus(const CallSignal& signal, bool delivered) override;
+        void OnFloorChanged(const FloorChange& change) override;
+        void OnLatencyProbeFinished(const LatencyReport& report) override;
+        void OnAudioDevicesChanged(const AudioDeviceList& list) override;
 
     public:
+        // Magic static: initialized once thread-safely, afterwards a plain load with no lock.
+        // Intentionally leaked so SDK threads never see a destroyed manager at shutdown.
         static AgoraManager* GetInstance() {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (instance == nullptr) {
-                instance = new AgoraManager();
-            }
+            static AgoraManager* const instance = new AgoraManager();
             return instance;
         }
 
-        void InitializeEngine(const std::string& appId);
-        void StartEchoTest();
-        void StopEchoTest();
-        void JoinChannel(const std::string& channelName);
-        void LeaveChannel();
-        void ReleaseEngine();
-        std::string GetStatus();
-        
-        // New voice communication methods
-        void MuteLocalAudio(bool mute);
-        void EnableLocalAudio(bool enabled);
-        void AdjustRecordingVolume(int volume);
-        void AdjustPlaybackVolume(int volume);
-        void SetClientRole(int role);
-        void MuteRemoteAudioStream(unsigned int uid, bool mute); // NEW
-        
-        // Audio quality methods
-        void EnableNoiseSuppressionMode(bool enabled, int mode);
-        void SetAudioScenario(int scenario);
-        
-        // Debug and status methods
-        bool IsLocalAudioMuted();
-
-        void SetReactContext(winrt::Microsoft::ReactNative::ReactContext const& context) {
-            if (m_eventHandler) {
-                m_eventHandler->SetReactContext(context);
-            }
-        }
-
-        ~AgoraManager() {
-            ReleaseEngine();
-        }
+        void SetReactContext(winrt::Microsoft::ReactNative::ReactContext const& context);
     };
 
     REACT_MODULE(AgoraModule)
     struct AgoraModule
     {
+        using VoidPromise = winrt::Microsoft::ReactNative::ReactPromise<void>;
+
         REACT_INIT(Initialize)
         void Initialize(winrt::Microsoft::ReactNative::ReactContext const& reactContext) noexcept
         {
             m_reactContext = reactContext;
-            AgoraManager::GetInstance()->SetReactContext(reactContext);
+            Enqueue("", [reactContext]() { AgoraManager::GetInstance()->SetReactContext(reactContext); });
+
+            // Hot status reads as global.AgoraNative, synchronous on the JS thread (see AgoraJsi.h)
+            winrt::Microsoft::ReactNative::ExecuteJsi(reactContext, [](facebook::jsi::Runtime& runtime) {
+                AgoraJsiHost::Install(runtime, *AgoraManager::GetInstance());
+            });
         }
 
+        // Every method below only posts to the AgoraManager worker thread and returns;
+        // the promise resolves once the SDK call has actually run.
         REACT_METHOD(InitializeAgoraEngine)
-        void InitializeAgoraEngine(std::string appId) noexcept
+        void InitializeAgoraEngine(std::string appId, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->InitializeEngine(appId);
+            Enqueue("", [appId]() { AgoraManager::GetInstance()->InitializeEngine(appId); }, promise);
         }
 
         REACT_METHOD(StartEchoTest)
-        void StartEchoTest() noexcept
+        void StartEchoTest(VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->StartEchoTest();
+            Enqueue("", []() { AgoraManager::GetInstance()->StartEchoTest(); }, promise);
         }
 
         REACT_METHOD(StopEchoTest)
-        void StopEchoTest() noexcept
+        void StopEchoTest(VoidPromise promise) noexcept
+        {
+            Enqueue("", []() { AgoraManager::GetInstance()->StopEchoTest(); }, promise);
+        }
+
+        // path "device" (speaker to microphone) or "channel" (out and back over the talk channel),
+        // signal "chirp" or "mls"; knownDelayMs is subtracted (a repeater's hold). The numbers
+        // arrive as onLatencyProbeFinished.
+        REACT_METHOD(StartLatencyProbe)
+        void StartLatencyProbe(std::string path, std::string signal, int probes, int knownDelayMs, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->StopEchoTest();
+            LatencyProbeConfig config;
+            ParseProbePath(path.c_str(), config.path);
+            ParseProbeSignal(signal.c_str(), config.signal);
+            config.probes = probes;
+            config.knownDelayMs = knownDelayMs;
+            Enqueue("", [config]() { AgoraManager::GetInstance()->StartLatencyProbe(config); }, promise);
         }
 
+        REACT_METHOD(StopLatencyProbe)
+        void StopLatencyProbe(VoidPromise promise) noexcept
+        {
+            Enqueue("", []() { AgoraManager::GetInstance()->StopLatencyProbe(); }, promise);
+        }
+
+        // listenOnly joins as audience: no microphone and no publisher slot until the user keys up
         REACT_METHOD(JoinChannel)
-        void JoinChannel(std::string channelName) noexcept
+        void JoinChannel(std::string channelName, bool listenOnly, VoidPromise promise) noexcept
+        {
+            Enqueue("", [channelName, listenOnly]() { AgoraManager::GetInstance()->JoinChannel(channelName, listenOnly); }, promise);
+        }
+
+        // Called as soon as a private call starts ringing; the connection joins without publishing
+        REACT_METHOD(PrepareChannel)
+        void PrepareChannel(std::string channelName, VoidPromise promise) noexcept
+        {
+            Enqueue("", [channelName]() { AgoraManager::GetInstance()->PrepareChannel(channelName); }, promise);
+        }
+
+        // Declined, missed or cancelled: drop the prepared connection (no-op after AcceptCall)
+        REACT_METHOD(ReleasePreparedChannel)
+        void ReleasePreparedChannel(std::string channelName, VoidPromise promise) noexcept
+        {
+            Enqueue("", [channelName]() { AgoraManager::GetInstance()->ReleasePreparedChannel(channelName); }, promise);
+        }
+
+        // Joins the private call channel, as a publish switch when it was prepared
+        REACT_METHOD(AcceptCall)
+        void AcceptCall(std::string channelName, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->JoinChannel(channelName);
+            Enqueue("", [channelName]() { AgoraManager::GetInstance()->AcceptCall(channelName); }, promise);
         }
 
         REACT_METHOD(LeaveChannel)
-        void LeaveChannel() noexcept
+        void LeaveChannel(VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->LeaveChannel();
+            Enqueue("", []() { AgoraManager::GetInstance()->LeaveChannel(); }, promise);
         }
 
         REACT_METHOD(ReleaseEngine)
-        void ReleaseEngine() noexcept
+        void ReleaseEngine(VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->ReleaseEngine();
+            Enqueue("", []() { AgoraManager::GetInstance()->ReleaseEngine(); }, promise);
         }
 
+        // Status reads come straight from the published snapshot, no queue hop or lock.
+        // Still a bridge callback each; pollers use global.AgoraNative instead.
         REACT_METHOD(GetFunctionLoadingStatus)
         void GetFunctionLoadingStatus(std::function<void(std::string)> const& callback) noexcept
         {
@@ -155,54 +191,478 @@ namespace winrt::FinalProject::implementation
 
         // New React Native voice communication methods
         REACT_METHOD(MuteLocalAudio)
-        void MuteLocalAudio(bool mute) noexcept
+        void MuteLocalAudio(bool mute, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->MuteLocalAudio(mute);
+            Enqueue("MuteLocalAudio", [mute]() { AgoraManager::GetInstance()->MuteLocalAudio(mute); }, promise);
+        }
+
+        // Not coalesced: a later mute must not drop a pending role switch
+        REACT_METHOD(SetListenOnly)
+        void SetListenOnly(bool listenOnly, VoidPromise promise) noexcept
+        {
+            Enqueue("", [listenOnly]() { AgoraManager::GetInstance()->SetListenOnly(listenOnly); }, promise);
         }
 
         REACT_METHOD(EnableLocalAudio)
-        void EnableLocalAudio(bool enabled) noexcept
+        void EnableLocalAudio(bool enabled, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->EnableLocalAudio(enabled);
+            Enqueue("EnableLocalAudio", [enabled]() { AgoraManager::GetInstance()->EnableLocalAudio(enabled); }, promise);
         }
 
         REACT_METHOD(AdjustRecordingVolume)
-        void AdjustRecordingVolume(int volume) noexcept
+        void AdjustRecordingVolume(int volume, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->AdjustRecordingVolume(volume);
+            Enqueue("AdjustRecordingVolume", [volume]() { AgoraManager::GetInstance()->AdjustRecordingVolume(volume); }, promise);
         }
 
         // Add playback volume adjustment for all remote users
         REACT_METHOD(AdjustPlaybackVolume)
-        void AdjustPlaybackVolume(int volume) noexcept
+        void AdjustPlaybackVolume(int volume, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->AdjustPlaybackVolume(volume);
+            Enqueue("AdjustPlaybackVolume", [volume]() { AgoraManager::GetInstance()->AdjustPlaybackVolume(volume); }, promise);
         }
 
         // Add muteRemoteAudioStream for muting remote user playback
         REACT_METHOD(MuteRemoteAudioStream)
-        void MuteRemoteAudioStream(unsigned int uid, bool mute) noexcept
+        void MuteRemoteAudioStream(unsigned int uid, bool mute, VoidPromise promise) noexcept
+        {
+            Enqueue("MuteRemoteAudioStream:" + std::to_string(uid),
+                [uid, mute]() { AgoraManager::GetInstance()->MuteRemoteAudioStream(uid, mute); }, promise);
+        }
+
+        // Radio-console mode: monitor several radios at once, PTT on at most one
+        REACT_METHOD(JoinRadioChannel)
+        void JoinRadioChannel(std::string channelName, bool talk, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->MuteRemoteAudioStream(uid, mute);
+            EnqueueChecked("", [channelName, talk]() { AgoraManager::GetInstance()->JoinRadioChannel(channelName, talk); },
+                [channelName, talk]() {
+                    return AgoraManager::GetInstance()->ReadState([&](const AgoraState& state) {
+                        bool joined = std::find(state.radioChannels.begin(), state.radioChannels.end(), channelName) != state.radioChannels.end();
+                        return joined && (!talk || state.talkChannel == channelName);
+                    });
+                }, "Radio channel join failed", promise);
+        }
+
+        REACT_METHOD(LeaveRadioChannel)
+        void LeaveRadioChannel(std::string channelName, VoidPromise promise) noexcept
+        {
+            Enqueue("", [channelName]() { AgoraManager::GetInstance()->LeaveRadioChannel(channelName); }, promise);
+        }
+
+        REACT_METHOD(SetTalkChannel)
+        void SetTalkChannel(std::string channelName, VoidPromise promise) noexcept
+        {
+            EnqueueChecked("SetTalkChannel", [channelName]() { AgoraManager::GetInstance()->SetTalkChannel(channelName); },
+                [channelName]() {
+                    return AgoraManager::GetInstance()->ReadState([&](const AgoraState& state) { return state.talkChannel == channelName; });
+                }, "Talk channel switch failed", promise);
+        }
+
+        REACT_METHOD(GetRadioChannels)
+        void GetRadioChannels(std::function<void(std::vector<std::string>)> const& callback) noexcept
+        {
+            callback(AgoraManager::GetInstance()->GetRadioChannels());
+        }
+
+        // Private-call signaling: join the lobby once signed in, leave it on sign-out. Invites and
+        // answers then arrive as onCallSignal events instead of through polling.
+        REACT_METHOD(StartSignaling)
+        void StartSignaling(std::string lobbyChannel, std::string userId, VoidPromise promise) noexcept
+        {
+            Enqueue("Signaling", [lobbyChannel, userId]() { AgoraManager::GetInstance()->StartSignaling(lobbyChannel, userId); }, promise);
+        }
+
+        REACT_METHOD(StopSignaling)
+        void StopSignaling(VoidPromise promise) noexcept
+        {
+            Enqueue("Signaling", []() { AgoraManager::GetInstance()->StopSignaling(); }, promise);
+        }
+
+        // type: invite, accept, reject, cancel or end; never coalesced, every signal counts
+        REACT_METHOD(SendCallSignal)
+        void SendCallSignal(std::string type, std::string toUser, std::string invitationId, std::string channelName,
+                            std::string callerName, VoidPromise promise) noexcept
+        {
+            CallSignal signal;
+            if (!ParseCallSignalType(type, signal.type) || signal.type == CallSignalType::Ack) {
+                promise.Reject("Unknown call signal type");
+                return;
+            }
+            signal.toUser = std::move(toUser);
+            signal.invitationId = std::move(invitationId);
+            signal.channelName = std::move(channelName);
+            signal.callerName = std::move(callerName);
+            Enqueue("", [signal]() { AgoraManager::GetInstance()->SendCallSignal(signal); }, promise);
+        }
+
+        // Push-to-talk floor over the signaling lobby. Turn floor control on before joining the
+        // radio; then key up with RequestFloor and wait for onFloorChanged (granted unmutes).
+        // Request and release coalesce per radio: a quick tap ends released.
+        REACT_METHOD(SetFloorControl)
+        void SetFloorControl(std::string channelName, bool enabled, VoidPromise promise) noexcept
+        {
+            Enqueue("", [channelName, enabled]() { AgoraManager::GetInstance()->SetFloorControl(channelName, enabled); }, promise);
+        }
+
+        REACT_METHOD(RequestFloor)
+        void RequestFloor(std::string channelName, int priority, VoidPromise promise) noexcept
+        {
+            Enqueue("Floor:" + channelName,
+                [channelName, priority]() { AgoraManager::GetInstance()->RequestFloor(channelName, priority); }, promise);
+        }
+
+        REACT_METHOD(ReleaseFloor)
+        void ReleaseFloor(std::string channelName, VoidPromise promise) noexcept
+        {
+            Enqueue("Floor:" + channelName, [channelName]() { AgoraManager::GetInstance()->ReleaseFloor(channelName); }, promise);
+        }
+
+        // Instant replay: the last N seconds of a monitored radio, played locally only
+        REACT_METHOD(SetReplayBuffer)
+        void SetReplayBuffer(std::string channelName, int seconds, VoidPromise promise) noexcept
+        {
+            Enqueue("SetReplayBuffer:" + channelName,
+                [channelName, seconds]() { AgoraManager::GetInstance()->SetReplayBuffer(channelName, seconds); }, promise);
+        }
+
+        REACT_METHOD(ReplayLast)
+        void ReplayLast(std::string channelName, int seconds, VoidPromise promise) noexcept
+        {
+            Enqueue("Replay", [channelName, seconds]() { AgoraManager::GetInstance()->ReplayLast(channelName, seconds); }, promise);
+        }
+
+        REACT_METHOD(ReplayLastFrom)
+        void ReplayLastFrom(std::string channelName, int seconds, unsigned int uid, VoidPromise promise) noexcept
+        {
+            Enqueue("Replay", [channelName, seconds, uid]() { AgoraManager::GetInstance()->ReplayLast(channelName, seconds, uid); }, promise);
+        }
+
+        REACT_METHOD(StopReplay)
+        void StopReplay(VoidPromise promise) noexcept
+        {
+            Enqueue("Replay", []() { AgoraManager::GetInstance()->StopReplay(); }, promise);
+        }
+
+        // [[uid, msAgo, durationMs], ...] talk spurts, read straight from the rings
+        REACT_METHOD(GetReplayIndex)
+        void GetReplayIndex(std::string channelName, int seconds, std::function<void(std::string)> const& callback) noexcept
+        {
+            callback(AgoraManager::GetInstance()->GetReplayIndex(channelName, seconds));
+        }
+
+        // Radio mixer: { enabled, duckDb, activityDb, duckHoldMs, rampMs }. Missing fields keep
+        // their defaults; the per-radio and per-user mixes set below are kept.
+        REACT_METHOD(ConfigureRadioMixer)
+        void ConfigureRadioMixer(winrt::Microsoft::ReactNative::JSValueObject&& settings, VoidPromise promise) noexcept
+        {
+            RadioMixerConfig config;
+            config.enabled = ReadBool(settings, "enabled", config.enabled);
+            config.duckDb = ReadFloat(settings, "duckDb", config.duckDb);
+            config.activityDb = ReadFloat(settings, "activityDb", config.activityDb);
+            config.duckHoldMs = static_cast<int>(ReadFloat(settings, "duckHoldMs", static_cast<float>(config.duckHoldMs)));
+            config.rampMs = static_cast<int>(ReadFloat(settings, "rampMs", static_cast<float>(config.rampMs)));
+            Enqueue("ConfigureRadioMixer", [config]() { AgoraManager::GetInstance()->ConfigureRadioMixer(config); }, promise);
+        }
+
+        // pan -1 (left) .. +1 (right); gainDb -60 is off; priority 0..9, higher ducks lower
+        REACT_METHOD(SetRadioMix)
+        void SetRadioMix(std::string channelName, double gainDb, double pan, int priority, VoidPromise promise) noexcept
+        {
+            Enqueue("SetRadioMix:" + channelName, [channelName, gainDb, pan, priority]() {
+                AgoraManager::GetInstance()->SetRadioMix(channelName, static_cast<float>(gainDb), static_cast<float>(pan), priority);
+            }, promise);
+        }
+
+        // One user on a radio: the gain adds to the radio's, the pan replaces it
+        REACT_METHOD(SetUserMix)
+        void SetUserMix(std::string channelName, unsigned int uid, double gainDb, double pan, VoidPromise promise) noexcept
+        {
+            Enqueue("SetUserMix:" + channelName + ":" + std::to_string(uid), [channelName, uid, gainDb, pan]() {
+                AgoraManager::GetInstance()->SetUserMix(channelName, uid, static_cast<float>(gainDb), static_cast<float>(pan));
+            }, promise);
+        }
+
+        // { enabled, duckDb, activityDb, duckHoldMs, rampMs, mixes: [{ channelName, uid, gainDb, pan, priority }] }
+        REACT_METHOD(GetRadioMixer)
+        void GetRadioMixer(std::function<void(winrt::Microsoft::ReactNative::JSValueObject)> const& callback) noexcept
+        {
+            RadioMixerConfig config = AgoraManager::GetInstance()->GetRadioMixer();
+            winrt::Microsoft::ReactNative::JSValueArray mixes;
+            for (const auto& mix : config.mixes) {
+                mixes.push_back(winrt::Microsoft::ReactNative::JSValueObject{
+                    {"channelName", mix.channelName},
+                    {"uid", static_cast<int64_t>(mix.uid)},
+                    {"gainDb", static_cast<double>(mix.gainDb)},
+                    {"pan", static_cast<double>(mix.pan)},
+                    {"priority", mix.priority}
+                });
+            }
+            callback(winrt::Microsoft::ReactNative::JSValueObject{
+                {"enabled", config.enabled},
+                {"duckDb", static_cast<double>(config.duckDb)},
+                {"activityDb", static_cast<double>(config.activityDb)},
+                {"duckHoldMs", config.duckHoldMs},
+                {"rampMs", config.rampMs},
+                {"mixes", std::move(mixes)}
+            });
+        }
+
+        // Loudness per remote user: { enabled, targetLufs, maxBoostDb, maxCutDb, gateLufs, attackMs, releaseMs }.
+        // Missing fields keep their defaults.
+        REACT_METHOD(ConfigureLoudness)
+        void ConfigureLoudness(winrt::Microsoft::ReactNative::JSValueObject&& settings, VoidPromise promise) noexcept
+        {
+            LoudnessConfig config;
+            config.enabled = ReadBool(settings, "enabled", config.enabled);
+            config.targetLufs = ReadFloat(settings, "targetLufs", config.targetLufs);
+            config.maxBoostDb = ReadFloat(settings, "maxBoostDb", config.maxBoostDb);
+            config.maxCutDb = ReadFloat(settings, "maxCutDb", config.maxCutDb);
+            config.gateLufs = ReadFloat(settings, "gateLufs", config.gateLufs);
+            config.attackMs = static_cast<int>(ReadFloat(settings, "attackMs", static_cast<float>(config.attackMs)));
+            config.releaseMs = static_cast<int>(ReadFloat(settings, "releaseMs", static_cast<float>(config.releaseMs)));
+            Enqueue("ConfigureLoudness", [config]() { AgoraManager::GetInstance()->ConfigureLoudness(config); }, promise);
+        }
+
+        // Cue tones: "talkStart", "talkEnd", "roger", "ring", "ringback". Not queued - a trigger is
+        // one atomic store, so it never waits behind a join on the worker.
+        REACT_METHOD(PlayTone)
+        void PlayTone(std::string cue, bool uplink, VoidPromise promise) noexcept
+        {
+            ToneCue parsed = ToneCue::TalkStart;
+            if (!ParseToneCue(cue.c_str(), parsed)) {
+                promise.Reject("Unknown tone");
+                return;
+            }
+            AgoraManager::GetInstance()->PlayTone(parsed, uplink);
+            promise.Resolve();
+        }
+
+        REACT_METHOD(StopTone)
+        void StopTone(std::string cue, VoidPromise promise) noexcept
+        {
+            ToneCue parsed = ToneCue::TalkStart;
+            if (!ParseToneCue(cue.c_str(), parsed)) {
+                promise.Reject("Unknown tone");
+                return;
+            }
+            AgoraManager::GetInstance()->StopTone(parsed);
+            promise.Resolve();
+        }
+
+        REACT_METHOD(ConfigureTones)
+        void ConfigureTones(winrt::Microsoft::ReactNative::JSValueObject&& settings, VoidPromise promise) noexcept
+        {
+            std::optional<float> levelDb;
+            std::optional<bool> talkChirps;
+            if (auto value = ReadField(settings, "levelDb")) levelDb = static_cast<float>(value->AsDouble());
+            if (auto value = ReadField(settings, "talkChirps")) talkChirps = value->AsBoolean();
+
+            // Merged on the worker, in order with the other commands. Only a call that sets the
+            // same fields may replace a queued one, so no partial update is lost to coalescing.
+            std::string key = std::string("ConfigureTones:") + (levelDb ? "level" : "") + (talkChirps ? "chirps" : "");
+            Enqueue(std::move(key), [levelDb, talkChirps]() {
+                ToneConfig config = AgoraManager::GetInstance()->GetToneConfig();
+                if (levelDb) config.levelDb = *levelDb;
+                if (talkChirps) config.talkChirps = *talkChirps;
+                AgoraManager::GetInstance()->ConfigureTones(config);
+            }, promise);
+        }
+
+        // [{ channelName, uid, loudnessLufs, gainDb, speaking }] for everyone heard in the last 2 s
+        REACT_METHOD(GetLoudnessStats)
+        void GetLoudnessStats(std::function<void(winrt::Microsoft::ReactNative::JSValueArray)> const& callback) noexcept
+        {
+            winrt::Microsoft::ReactNative::JSValueArray speakers;
+            for (const auto& entry : AgoraManager::GetInstance()->GetLoudnessStats()) {
+                speakers.push_back(winrt::Microsoft::ReactNative::JSValueObject{
+                    {"channelName", entry.channelName},
+                    {"uid", static_cast<int64_t>(entry.uid)},
+                    {"loudnessLufs", static_cast<double>(entry.loudnessLufs)},
+                    {"gainDb", static_cast<double>(entry.gainDb)},
+                    {"speaking", entry.speaking}
+                });
+            }
+            callback(std::move(speakers));
+        }
+
+        // Audio devices, kind "recording" or "playback". The list is cached natively and kept
+        // current from device events; preferences are ids or name fragments, most wanted first,
+        // and the engine switches in place (no restart, no rejoin) when one comes or goes.
+        REACT_METHOD(GetAudioDevices)
+        void GetAudioDevices(std::string kind, std::function<void(winrt::Microsoft::ReactNative::JSValueObject)> const& callback) noexcept
+        {
+            AudioDeviceKind parsed = AudioDeviceKind::Recording;
+            ParseAudioDeviceKind(kind.c_str(), parsed);
+            callback(AudioDeviceListToJs(AgoraManager::GetInstance()->GetAudioDevices(parsed)));
+        }
+
+        REACT_METHOD(SetPreferredDevices)
+        void SetPreferredDevices(std::string kind, std::vector<std::string> preferred, VoidPromise promise) noexcept
+        {
+            AudioDeviceKind parsed = AudioDeviceKind::Recording;
+            if (!ParseAudioDeviceKind(kind.c_str(), parsed)) {
+                promise.Reject("Unknown audio device kind");
+                return;
+            }
+            Enqueue(std::string("SetPreferredDevices:") + AudioDeviceKindName(parsed),
+                [parsed, preferred]() { AgoraManager::GetInstance()->SetPreferredDevices(parsed, preferred); }, promise);
+        }
+
+        REACT_METHOD(RefreshAudioDevices)
+        void RefreshAudioDevices(VoidPromise promise) noexcept
+        {
+            Enqueue("RefreshAudioDevices", []() { AgoraManager::GetInstance()->RefreshAudioDevices(); }, promise);
+        }
+
+        // The audio profile picked from the last-mile probe for the current network:
+        // { networkId, tier, probing, fromCache, audioProfile, bitrateKbps, fec, jitterBufferMs, rttMs, loss, measuredAtMs }
+        REACT_METHOD(GetLinkProfile)
+        void GetLinkProfile(std::function<void(winrt::Microsoft::ReactNative::JSValueObject)> const& callback) noexcept
+        {
+            AgoraManager* manager = AgoraManager::GetInstance();
+            LinkDecision decision = manager->GetLinkProfile();
+            const LastmileProbeResult& measured = decision.measured;
+            callback(winrt::Microsoft::ReactNative::JSValueObject{
+                {"networkId", decision.networkId},
+                {"tier", LinkTierName(decision.profile.tier)},
+                {"probing", manager->GetState().isLastmileProbing},
+                {"fromCache", decision.fromCache},
+                {"audioProfile", decision.profile.audioProfile},
+                {"bitrateKbps", decision.profile.bitrateKbps},
+                {"fec", decision.profile.fec},
+                {"jitterBufferMs", decision.profile.jitterBufferMs},
+                {"rttMs", static_cast<int64_t>(measured.rttMs)},
+                {"loss", static_cast<int64_t>(std::max(measured.uplink.packetLossRate, measured.downlink.packetLossRate))},
+                {"measuredAtMs", static_cast<int64_t>(decision.measuredAtMs)}
+            });
+        }
+
+        // Probes again now (about 30 s) even if this network's profile is cached; only outside channels
+        REACT_METHOD(StartLastmileProbe)
+        void StartLastmileProbe(VoidPromise promise) noexcept
+        {
+            Enqueue("LastmileProbe", []() { AgoraManager::GetInstance()->StartLastmileProbe(); }, promise);
+        }
+
+        REACT_METHOD(SetLinkProfileTtl)
+        void SetLinkProfileTtl(int minutes, VoidPromise promise) noexcept
+        {
+            Enqueue("", [minutes]() { AgoraManager::GetInstance()->SetLinkProfileTtl(minutes); }, promise);
         }
 
         REACT_METHOD(SetClientRole)
-        void SetClientRole(int role) noexcept
+        void SetClientRole(int role, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->SetClientRole(role);
+            Enqueue("SetClientRole", [role]() { AgoraManager::GetInstance()->SetClientRole(role); }, promise);
         }
 
         // Audio quality React Native methods
         REACT_METHOD(EnableNoiseSuppressionMode)
-        void EnableNoiseSuppressionMode(bool enabled, int mode) noexcept
+        void EnableNoiseSuppressionMode(bool enabled, int mode, VoidPromise promise) noexcept
+        {
+            Enqueue("EnableNoiseSuppressionMode",
+                [enabled, mode]() { AgoraManager::GetInstance()->EnableNoiseSuppressionMode(enabled, mode); }, promise);
+        }
+
+        // Native PCM pipeline: { enabled, gainDb, highPassHz, limiterDb, vox, voxThresholdDb, voxAttackMs, voxHangoverMs, playbackGainDb }
+        // Missing fields keep their defaults; enabled=false hands control back to the SDK knobs.
+        REACT_METHOD(ConfigureAudioProcessing)
+        void ConfigureAudioProcessing(winrt::Microsoft::ReactNative::JSValueObject&& settings, VoidPromise promise) noexcept
+        {
+            AudioPipelineConfig capture;
+            capture.enabled = ReadBool(settings, "enabled", capture.enabled);
+            capture.gainDb = ReadFloat(settings, "gainDb", capture.gainDb);
+            capture.highPassHz = ReadFloat(settings, "highPassHz", capture.highPassHz);
+            capture.highPassEnabled = capture.highPassHz > 0.0f;
+            capture.limiterThresholdDb = ReadFloat(settings, "limiterDb", capture.limiterThresholdDb);
+            capture.voxEnabled = ReadBool(settings, "vox", capture.voxEnabled);
+            capture.voxThresholdDb = ReadFloat(settings, "voxThresholdDb", capture.voxThresholdDb);
+            capture.voxAttackMs = static_cast<int>(ReadFloat(settings, "voxAttackMs", static_cast<float>(capture.voxAttackMs)));
+            capture.voxHangoverMs = static_cast<int>(ReadFloat(settings, "voxHangoverMs", static_cast<float>(capture.voxHangoverMs)));
+
+            // Playback: same filter/limiter, its own gain, never gated
+            AudioPipelineConfig playback = capture;
+            playback.gainDb = ReadFloat(settings, "playbackGainDb", 0.0f);
+            playback.voxEnabled = false;
+
+            Enqueue("ConfigureAudioProcessing", [capture, playback]() { AgoraManager::GetInstance()->ConfigureAudioProcessing(capture, playback); }, promise);
+        }
+
+        // The whole audio setup in one crossing: every field optional (missing or null = keep),
+        // only what differs reaches the SDK. Resolves with {ready, applied, unchanged, pending}.
+        REACT_METHOD(ApplyAudioState)
+        void ApplyAudioState(winrt::Microsoft::ReactNative::JSValueObject state,
+                             winrt::Microsoft::ReactNative::ReactPromise<winrt::Microsoft::ReactNative::JSValueObject> promise) noexcept
         {
-            AgoraManager::GetInstance()->EnableNoiseSuppressionMode(enabled, mode);
+            DesiredAudioState desired;
+            if (auto value = ReadField(state, "channel")) desired.channel = value->AsString();
+            if (auto value = ReadField(state, "listenOnly")) desired.listenOnly = value->AsBoolean();
+            if (auto value = ReadField(state, "radios")) {
+                std::vector<std::string> radios;
+                for (const auto& radio : value->AsArray()) radios.push_back(radio.AsString());
+                desired.radios = std::move(radios);
+            }
+            if (auto value = ReadField(state, "talkChannel")) desired.talkChannel = value->AsString();
+            if (auto value = ReadField(state, "muted")) desired.muted = value->AsBoolean();
+            if (auto value = ReadField(state, "localAudioEnabled")) desired.localAudioEnabled = value->AsBoolean();
+            if (auto value = ReadField(state, "recordingVolume")) desired.recordingVolume = static_cast<int>(value->AsInt64());
+            if (auto value = ReadField(state, "playbackVolume")) desired.playbackVolume = static_cast<int>(value->AsInt64());
+            if (auto value = ReadField(state, "clientRole")) desired.clientRole = static_cast<int>(value->AsInt64());
+            if (auto value = ReadField(state, "noiseSuppressionMode")) desired.noiseSuppressionMode = static_cast<int>(value->AsInt64());
+            if (auto value = ReadField(state, "scenario")) desired.scenario = static_cast<int>(value->AsInt64());
+
+            // A barrier like join and leave; the report travels from the worker to the resolve
+            auto report = std::make_shared<AudioStateReport>();
+            AgoraManager::GetInstance()->Post(Command{
+                "",
+                [desired, report]() { *report = AgoraManager::GetInstance()->ApplyAudioState(desired); },
+                [promise, report]() {
+                    promise.Resolve(winrt::Microsoft::ReactNative::JSValueObject{
+                        {"ready", report->ready},
+                        {"applied", AudioActionsToJs(report->applied)},
+                        {"unchanged", report->unchanged},
+                        {"pending", AudioActionsToJs(report->pending)}
+                    });
+                }
+            });
         }
 
         REACT_METHOD(SetAudioScenario)
-        void SetAudioScenario(int scenario) noexcept
+        void SetAudioScenario(int scenario, VoidPromise promise) noexcept
+        {
+            Enqueue("SetAudioScenario", [scenario]() { AgoraManager::GetInstance()->SetAudioScenario(scenario); }, promise);
+        }
+
+        // ListenAndTalk without holding the key: the mic is only sent while the VOX gate is open
+        REACT_METHOD(SetVoxMode)
+        void SetVoxMode(bool enabled, VoidPromise promise) noexcept
         {
-            AgoraManager::GetInstance()->SetAudioScenario(scenario);
+            Enqueue("SetVoxMode", [enabled]() { AgoraManager::GetInstance()->SetVoxMode(enabled); }, promise);
+        }
+
+        // Per-uid talk levels pushed as deltas every intervalMs; 0 turns them off
+        REACT_METHOD(EnableVolumeIndication)
+        void EnableVolumeIndication(int intervalMs, int smooth, VoidPromise promise) noexcept
+        {
+            Enqueue("EnableVolumeIndication", [intervalMs, smooth]() { AgoraManager::GetInstance()->EnableVolumeIndication(intervalMs, smooth); }, promise);
+        }
+
+        // How often batched SDK events are flushed to JS (default one frame)
+        REACT_METHOD(SetEventFlushInterval)
+        void SetEventFlushInterval(int intervalMs) noexcept
+        {
+            AgoraManager::GetInstance()->SetEventFlushInterval(intervalMs);
+        }
+
+        // Backoff for rejoining channels the SDK gave up on (maxAttempts 0 = until left)
+        REACT_METHOD(SetReconnectPolicy)
+        void SetReconnectPolicy(int baseDelayMs, int maxDelayMs, int maxAttempts, VoidPromise promise) noexcept
+        {
+            ReconnectPolicy policy;
+            policy.baseDelayMs = baseDelayMs;
+            policy.maxDelayMs = maxDelayMs;
+            policy.maxAttempts = maxAttempts;
+            Enqueue("SetReconnectPolicy", [policy]() { AgoraManager::GetInstance()->SetReconnectPolicy(policy); }, promise);
         }
 
         // Debug and status React Native methods
@@ -212,7 +672,76 @@ namespace winrt::FinalProject::implementation
             callback(AgoraManager::GetInstance()->IsLocalAudioMuted());
         }
 
+        // Startup/answer timings, lock-free like GetStatus
+        REACT_METHOD(GetCallLatency)
+        void GetCallLatency(std::function<void(winrt::Microsoft::ReactNative::JSValueObject)> const& callback) noexcept
+        {
+            CallLatency latency = AgoraManager::GetInstance()->GetCallLatency();
+            callback(winrt::Microsoft::ReactNative::JSValueObject{
+                {"engineInitMs", latency.engineInitMs},
+                {"initCallMs", latency.initCallMs},
+                {"prepareMs", latency.prepareMs},
+                {"acceptMs", latency.acceptMs},
+                {"acceptWarm", latency.acceptWarm},
+                {"acceptChannel", latency.acceptChannel}
+            });
+        }
+
+        // Latency histograms and last SDK stats as one JSON string, read without a queue hop
+        REACT_METHOD(GetMetrics)
+        void GetMetrics(std::function<void(std::string)> const& callback) noexcept
+        {
+            callback(AgoraManager::GetInstance()->GetMetrics());
+        }
+
     private:
+        // nullptr when the key is missing or null
+        static const winrt::Microsoft::ReactNative::JSValue* ReadField(winrt::Microsoft::ReactNative::JSValueObject const& settings, const char* key) noexcept
+        {
+            auto it = settings.find(key);
+            return it != settings.end() && !it->second.IsNull() ? &it->second : nullptr;
+        }
+
+        static float ReadFloat(winrt::Microsoft::ReactNative::JSValueObject const& settings, const char* key, float fallback) noexcept
+        {
+            auto it = settings.find(key);
+            return it != settings.end() && !it->second.IsNull() ? static_cast<float>(it->second.AsDouble()) : fallback;
+        }
+
+        static bool ReadBool(winrt::Microsoft::ReactNative::JSValueObject const& settings, const char* key, bool fallback) noexcept
+        {
+            auto it = settings.find(key);
+            return it != settings.end() && !it->second.IsNull() ? it->second.AsBoolean() : fallback;
+        }
+
+        static void Enqueue(std::string coalesceKey, std::function<void()> work) noexcept
+        {
+            AgoraManager::GetInstance()->Post(Command{ std::move(coalesceKey), std::move(work), nullptr });
+        }
+
+        static void Enqueue(std::string coalesceKey, std::function<void()> work, VoidPromise const& promise) noexcept
+        {
+            AgoraManager::GetInstance()->Post(Command{ std::move(coalesceKey), std::move(work), [promise]() { promise.Resolve(); } });
+        }
+
+        // Like Enqueue, but the promise is rejected unless reached() holds once the command is done.
+        // reached() runs on the worker after work(), or after the command that superseded this
+        // one ran, so a coalesced-away call is judged by its own target, not by the later one's.
+        static void EnqueueChecked(std::string coalesceKey, std::function<void()> work, std::function<bool()> reached,
+                                   const char* failure, VoidPromise const& promise) noexcept
+        {
+            AgoraManager::GetInstance()->Post(Command{
+                std::move(coalesceKey),
+                std::move(work),
+                [promise, reached = std::move(reached), failure]() {
+                    if (reached()) {
+                        promise.Resolve();
+                    } else {
+                        promise.Reject(failure);
+                    }
+                } });
+        }
+
         winrt::Microsoft::ReactNative::ReactContext m_reactContext{ nullptr };
     };
 }
\ No newline at end of file
@@ -0,0 +1,584 @@
+#include "pch.h"
+#include "AgoraRtcEngine.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    // AgoraEventBridge implementation - SDK threads, convert and forward only
+    ChannelStatsSample AgoraEventBridge::ToSample(const RtcStats& stats)
+    {
+        ChannelStatsSample sample;
+        sample.durationS = stats.duration;
+        sample.txKbps = stats.txKBitRate;
+        sample.rxKbps = stats.rxKBitRate;
+        sample.lastmileDelayMs = stats.lastmileDelay;
+        sample.txLossPercent = static_cast<uint32_t>(std::max(0, stats.txPacketLossRate));
+        sample.rxLossPercent = static_cast<uint32_t>(std::max(0, stats.rxPacketLossRate));
+        sample.userCount = stats.userCount;
+        sample.cpuAppPercent = static_cast<uint32_t>(std::max(0.0, stats.cpuAppUsage));
+        return sample;
+    }
+
+    void AgoraEventBridge::onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed)
+    {
+        m_events->onJoinChannelSuccess(channel, uid, elapsed);
+    }
+
+    void AgoraEventBridge::onLeaveChannel(const RtcStats& stats)
+    {
+        m_events->onLeaveChannel(ToSample(stats));
+    }
+
+    void AgoraEventBridge::onUserJoined(uid_t uid, int elapsed)
+    {
+        m_events->onUserJoined(uid, elapsed);
+    }
+
+    void AgoraEventBridge::onUserOffline(uid_t uid, USER_OFFLINE_REASON_TYPE reason)
+    {
+        m_events->onUserOffline(uid, static_cast<int>(reason));
+    }
+
+    void AgoraEventBridge::onError(int err, const char* msg)
+    {
+        m_events->onError(err, msg);
+    }
+
+    void AgoraEventBridge::onAudioVolumeIndication(const AudioVolumeInfo* speakers, unsigned int speakerNumber, int totalVolume)
+    {
+        if (!speakers) return;
+
+        // At most a handful of speakers per callback; a stack copy keeps this allocation free
+        constexpr unsigned int kMaxSpeakers = 32;
+        VolumeSample samples[kMaxSpeakers];
+        unsigned int count = std::min(speakerNumber, kMaxSpeakers);
+        for (unsigned int i = 0; i < count; ++i) {
+            samples[i].uid = speakers[i].uid;
+            samples[i].volume = static_cast<uint8_t>(std::max(0, std::min(255, static_cast<int>(speakers[i].volume))));
+        }
+        m_events->onAudioVolumeIndication(samples, count, totalVolume);
+    }
+
+    void AgoraEventBridge::onActiveSpeaker(uid_t uid)
+    {
+        m_events->onActiveSpeaker(uid);
+    }
+
+    void AgoraEventBridge::onRtcStats(const RtcStats& stats)
+    {
+        m_events->onRtcStats(ToSample(stats));
+    }
+
+    void AgoraEventBridge::onNetworkQuality(uid_t uid, int txQuality, int rxQuality)
+    {
+        m_events->onNetworkQuality(uid, txQuality, rxQuality);
+    }
+
+    void AgoraEventBridge::onRemoteAudioStats(const RemoteAudioStats& stats)
+    {
+        RemoteAudioSample sample;
+        sample.quality = stats.quality;
+        sample.networkDelayMs = stats.networkTransportDelay;
+        sample.jitterBufferDelayMs = stats.jitterBufferDelay;
+        sample.lossPercent = stats.audioLossRate;
+        sample.receivedKbps = stats.receivedBitrate;
+        sample.frozenPercent = stats.frozenRate;
+        sample.mos = stats.mosValue;
+        m_events->onRemoteAudioStats(stats.uid, sample);
+    }
+
+    void AgoraEventBridge::onConnectionStateChanged(CONNECTION_STATE_TYPE state, CONNECTION_CHANGED_REASON_TYPE reason)
+    {
+        m_events->onConnectionStateChanged(static_cast<int>(state), static_cast<int>(reason));
+    }
+
+    void AgoraEventBridge::onConnectionLost()
+    {
+        m_events->onConnectionLost();
+    }
+
+    void AgoraEventBridge::onRejoinChannelSuccess(const char* channel, uid_t uid, int elapsed)
+    {
+        m_events->onRejoinChannelSuccess(channel, uid, elapsed);
+    }
+
+    void AgoraEventBridge::onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState)
+    {
+        m_events->onAudioDeviceStateChanged(deviceId, deviceType, deviceState);
+    }
+
+    void AgoraEventBridge::onLastmileProbeResult(const agora::rtc::LastmileProbeResult& result)
+    {
+        LastmileProbeResult sample;
+        sample.state = static_cast<int>(result.state);
+        sample.uplink = { result.uplinkReport.packetLossRate, result.uplinkReport.jitter, result.uplinkReport.availableBandwidth };
+        sample.downlink = { result.downlinkReport.packetLossRate, result.downlinkReport.jitter, result.downlinkReport.availableBandwidth };
+        sample.rttMs = result.rtt;
+        m_events->onLastmileProbeResult(sample);
+    }
+
+    void AgoraEventBridge::onStreamMessage(uid_t userId, int streamId, const char* data, size_t length, uint64_t sentTs)
+    {
+        (void)sentTs;
+        m_events->onStreamMessage(userId, streamId, data, length);
+    }
+
+    // AgoraAudioFrameObserver implementation - SDK audio thread, keep it allocation and log free
+    bool AgoraAudioFrameObserver::Run(AudioPipeline* pipeline, AudioFrame& audioFrame)
+    {
+        if (!pipeline || audioFrame.type != FRAME_TYPE_PCM16 || audioFrame.bytesPerSample != TWO_BYTES_PER_SAMPLE || !audioFrame.buffer) {
+            return true;
+        }
+        pipeline->Process(static_cast<int16_t*>(audioFrame.buffer), audioFrame.samplesPerChannel,
+                          audioFrame.channels, audioFrame.samplesPerSec);
+        return true;
+    }
+
+    bool AgoraAudioFrameObserver::onRecordAudioFrame(const char* channelId, AudioFrame& audioFrame)
+    {
+        (void)channelId;
+        return Run(m_capture, audioFrame);
+    }
+
+    bool AgoraAudioFrameObserver::onPlaybackAudioFrame(const char* channelId, AudioFrame& audioFrame)
+    {
+        (void)channelId;
+        return Run(m_playback, audioFrame);
+    }
+
+    bool AgoraAudioFrameObserver::onPublishAudioFrame(const char*, AudioFrame&) { return true; }
+    bool AgoraAudioFrameObserver::onMixedAudioFrame(const char*, AudioFrame&) { return true; }
+    bool AgoraAudioFrameObserver::onEarMonitoringAudioFrame(AudioFrame&) { return true; }
+
+    bool AgoraAudioFrameObserver::onPlaybackAudioFrameBeforeMixing(const char* channelId, uid_t uid, AudioFrame& audioFrame)
+    {
+        if (!m_remote || !channelId || audioFrame.type != FRAME_TYPE_PCM16 ||
+            audioFrame.bytesPerSample != TWO_BYTES_PER_SAMPLE || !audioFrame.buffer) {
+            return true;
+        }
+        m_remote->OnRemoteAudioFrame(channelId, uid, static_cast<const int16_t*>(audioFrame.buffer),
+                                     audioFrame.samplesPerChannel, audioFrame.channels, audioFrame.samplesPerSec);
+        return true;
+    }
+
+    int AgoraAudioFrameObserver::getObservedAudioFramePosition()
+    {
+        int positions = AUDIO_FRAME_POSITION_RECORD | AUDIO_FRAME_POSITION_PLAYBACK;
+        if (m_remote) positions |= AUDIO_FRAME_POSITION_BEFORE_MIXING;
+        return positions;
+    }
+
+    AgoraAudioFrameObserver::AudioParams AgoraAudioFrameObserver::getRecordAudioParams()
+    {
+        return AudioParams(kSampleRate, kRecordChannels, RAW_AUDIO_FRAME_OP_MODE_READ_WRITE, kSamplesPerChannel * kRecordChannels);
+    }
+
+    AgoraAudioFrameObserver::AudioParams AgoraAudioFrameObserver::getPlaybackAudioParams()
+    {
+        return AudioParams(kSampleRate, kPlaybackChannels, RAW_AUDIO_FRAME_OP_MODE_READ_WRITE, kSamplesPerChannel * kPlaybackChannels);
+    }
+
+    AgoraAudioFrameObserver::AudioParams AgoraAudioFrameObserver::getMixedAudioParams()
+    {
+        return AudioParams(kSampleRate, kPlaybackChannels, RAW_AUDIO_FRAME_OP_MODE_READ_ONLY, kSamplesPerChannel * kPlaybackChannels);
+    }
+
+    AgoraAudioFrameObserver::AudioParams AgoraAudioFrameObserver::getEarMonitoringAudioParams()
+    {
+        return AudioParams(kSampleRate, kRecordChannels, RAW_AUDIO_FRAME_OP_MODE_READ_ONLY, kSamplesPerChannel * kRecordChannels);
+    }
+
+    // AgoraRtcEngine implementation
+    // Audience never publishes; the SDK then keeps the microphone closed for this connection
+    void AgoraRtcEngine::ApplyRole(const ConnectionOptions& options, ChannelMediaOptions& mediaOptions)
+    {
+        if (options.audience) {
+            mediaOptions.clientRoleType = CLIENT_ROLE_AUDIENCE;
+            mediaOptions.audienceLatencyLevel = static_cast<AUDIENCE_LATENCY_LEVEL_TYPE>(options.audienceLatency);
+            mediaOptions.publishMicrophoneTrack = false;
+        } else {
+            mediaOptions.clientRoleType = CLIENT_ROLE_BROADCASTER;
+        }
+    }
+
+    void AgoraRtcEngine::ApplyAudioSource(ChannelMediaOptions& mediaOptions) const
+    {
+        if (!m_externalAudio) return;
+        mediaOptions.publishCustomAudioTrack = mediaOptions.publishMicrophoneTrack.value_or(false);
+        mediaOptions.publishCustomAudioTrackId = static_cast<int>(m_customTrack);
+        mediaOptions.publishMicrophoneTrack = false;
+    }
+
+    ChannelMediaOptions AgoraRtcEngine::ToMediaOptions(const ConnectionOptions& options) const
+    {
+        ChannelMediaOptions mediaOptions;
+        mediaOptions.publishMicrophoneTrack = options.publishMicrophone;
+        mediaOptions.autoSubscribeAudio = options.autoSubscribeAudio;
+        mediaOptions.autoSubscribeVideo = false;            // ❌ NO VIDEO
+        mediaOptions.enableAudioRecordingOrPlayout = true;  // 🔊 ENABLE AUDIO
+        mediaOptions.channelProfile = agora::CHANNEL_PROFILE_LIVE_BROADCASTING;
+        ApplyRole(options, mediaOptions);
+        ApplyAudioSource(mediaOptions);
+        return mediaOptions;
+    }
+
+    RtcConnection AgoraRtcEngine::ToConnection(const std::string& channelName, uint32_t uid)
+    {
+        // channelId points into channelName, which outlives every call below
+        RtcConnection connection;
+        connection.channelId = channelName.c_str();
+        connection.localUid = uid;
+        return connection;
+    }
+
+    int AgoraRtcEngine::Initialize(const std::string& appId, IVoiceEngineEvents* events)
+    {
+        Release();
+
+        // Ex interface so radios can run as parallel RtcConnections
+        m_rtcEngine = createAgoraRtcEngineEx();
+        if (!m_rtcEngine) return -1;
+
+        m_eventBridge = std::make_unique<AgoraEventBridge>(events);
+
+        RtcEngineContext context;
+        context.appId = appId.c_str();
+        context.eventHandler = m_eventBridge.get();
+        // Live broadcasting, so listeners can join as audience (roles are ignored in communication)
+        context.channelProfile = agora::CHANNEL_PROFILE_LIVE_BROADCASTING;
+        context.audioScenario = AUDIO_SCENARIO_DEFAULT;
+
+        int result = m_rtcEngine->initialize(context);
+        if (result != 0) {
+            Release();
+            return result;
+        }
+        return m_rtcEngine->enableAudio();
+    }
+
+    void AgoraRtcEngine::Release()
+    {
+        if (!m_rtcEngine) return;
+
+        SetAudioProcessors(nullptr, nullptr, nullptr);
+        SetExternalAudio(false, 0, 0, 0);
+        m_mediaEngine.reset();
+        m_rtcEngine->release(); // synchronous: no callback runs after this returns
+        m_rtcEngine = nullptr;
+        m_connectionBridges.clear();
+        m_eventBridge.reset();
+    }
+
+    int AgoraRtcEngine::SetAudioProcessors(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote)
+    {
+        if (!m_rtcEngine) return -7;
+
+        agora::util::AutoPtr<agora::media::IMediaEngine> mediaEngine;
+        mediaEngine.queryInterface(m_rtcEngine, AGORA_IID_MEDIA_ENGINE);
+        if (!mediaEngine) return -4;
+
+        if (m_observerRegistered) {
+            mediaEngine->registerAudioFrameObserver(nullptr);
+            m_observerRegistered = false;
+        }
+        m_audioFrameObserver.SetPipelines(capture, playback, remote);
+        if (!capture && !playback && !remote) return 0;
+
+        // Read-write 10 ms frames in the format the pipelines are tuned for
+        m_rtcEngine->setRecordingAudioFrameParameters(AgoraAudioFrameObserver::kSampleRate, AgoraAudioFrameObserver::kRecordChannels,
+            RAW_AUDIO_FRAME_OP_MODE_READ_WRITE, AgoraAudioFrameObserver::kSamplesPerChannel * AgoraAudioFrameObserver::kRecordChannels);
+        m_rtcEngine->setPlaybackAudioFrameParameters(AgoraAudioFrameObserver::kSampleRate, AgoraAudioFrameObserver::kPlaybackChannels,
+            RAW_AUDIO_FRAME_OP_MODE_READ_WRITE, AgoraAudioFrameObserver::kSamplesPerChannel * AgoraAudioFrameObserver::kPlaybackChannels);
+        if (remote) {
+            // Full band mono: the radio mixer rebuilds playback from these, recorders decimate
+            m_rtcEngine->setPlaybackAudioFrameBeforeMixingParameters(kRemoteSampleRate, AgoraAudioFrameObserver::kRemoteChannels);
+        }
+
+        int result = mediaEngine->registerAudioFrameObserver(&m_audioFrameObserver);
+        m_observerRegistered = result == 0;
+        return result;
+    }
+
+    int AgoraRtcEngine::JoinChannel(const std::string& channelName, uint32_t uid, const ConnectionOptions& options)
+    {
+        return m_rtcEngine->joinChannel(nullptr, channelName.c_str(), uid, ToMediaOptions(options));
+    }
+
+    int AgoraRtcEngine::UpdateChannel(const ConnectionOptions& options)
+    {
+        ChannelMediaOptions mediaOptions;
+        mediaOptions.publishMicrophoneTrack = options.publishMicrophone;
+        mediaOptions.autoSubscribeAudio = options.autoSubscribeAudio;
+        ApplyRole(options, mediaOptions);
+        ApplyAudioSource(mediaOptions);
+        return m_rtcEngine->updateChannelMediaOptions(mediaOptions);
+    }
+
+    int AgoraRtcEngine::LeaveChannel()
+    {
+        return m_rtcEngine->leaveChannel();
+    }
+
+    int AgoraRtcEngine::MuteLocalAudio(bool mute)
+    {
+        return m_rtcEngine->muteLocalAudioStream(mute);
+    }
+
+    int AgoraRtcEngine::EnableVolumeIndication(int intervalMs, int smooth)
+    {
+        return m_rtcEngine->enableAudioVolumeIndication(intervalMs > 0 ? intervalMs : -1, smooth, true);
+    }
+
+    int AgoraRtcEngine::JoinConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options,
+                                       IVoiceEngineEvents* events)
+    {
+        // The core keeps one handler per channel, so a rejoin reuses the bridge it already has
+        auto& bridge = m_connectionBridges[channelName];
+        if (!bridge) {
+            bridge = std::make_unique<AgoraEventBridge>(events);
+        }
+        return m_rtcEngine->joinChannelEx(nullptr, ToConnection(channelName, uid), ToMediaOptions(options), bridge.get());
+    }
+
+    int AgoraRtcEngine::UpdateConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options)
+    {
+        ChannelMediaOptions mediaOptions;
+        mediaOptions.publishMicrophoneTrack = options.publishMicrophone;
+        mediaOptions.autoSubscribeAudio = options.autoSubscribeAudio;
+        ApplyRole(options, mediaOptions);
+        ApplyAudioSource(mediaOptions);
+        return m_rtcEngine->updateChannelMediaOptionsEx(mediaOptions, ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::LeaveConnection(const std::string& channelName, uint32_t uid)
+    {
+        return m_rtcEngine->leaveChannelEx(ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::MuteConnectionAudio(const std::string& channelName, uint32_t uid, bool mute)
+    {
+        return m_rtcEngine->muteLocalAudioStreamEx(mute, ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::EnableConnectionVolumeIndication(const std::string& channelName, uint32_t uid, int intervalMs, int smooth)
+    {
+        return m_rtcEngine->enableAudioVolumeIndicationEx(intervalMs > 0 ? intervalMs : -1, smooth, true, ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::CreateDataStream(const std::string& channelName, uint32_t uid, int* streamId)
+    {
+        DataStreamConfig config;
+        config.syncWithAudio = false; // signaling, not lip sync: deliver as soon as it arrives
+        config.ordered = true;
+        return m_rtcEngine->createDataStreamEx(streamId, config, ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::SendStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const char* data, size_t length)
+    {
+        return m_rtcEngine->sendStreamMessageEx(streamId, data, length, ToConnection(channelName, uid));
+    }
+
+    int AgoraRtcEngine::EnableLocalAudio(bool enabled)
+    {
+        return m_rtcEngine->enableLocalAudio(enabled);
+    }
+
+    int AgoraRtcEngine::MuteRemoteAudio(uint32_t uid, bool mute)
+    {
+        return m_rtcEngine->muteRemoteAudioStream(uid, mute);
+    }
+
+    int AgoraRtcEngine::SetRecordingVolume(int volume)
+    {
+        return m_rtcEngine->adjustRecordingSignalVolume(volume);
+    }
+
+    int AgoraRtcEngine::SetPlaybackVolume(int volume)
+    {
+        return m_rtcEngine->adjustPlaybackSignalVolume(volume);
+    }
+
+    int AgoraRtcEngine::SetVoiceEqualization(int band, int gainDb)
+    {
+        return m_rtcEngine->setLocalVoiceEqualization(static_cast<AUDIO_EQUALIZATION_BAND_FREQUENCY>(band), gainDb);
+    }
+
+    int AgoraRtcEngine::SetNoiseSuppression(bool enabled, int mode)
+    {
+        AUDIO_AINS_MODE ainsMode;
+        switch (mode) {
+            case 1: ainsMode = AINS_MODE_AGGRESSIVE; break;
+            case 2: ainsMode = AINS_MODE_ULTRALOWLATENCY; break;
+            default: ainsMode = AINS_MODE_BALANCED; break;
+        }
+        return m_rtcEngine->setAINSMode(enabled, ainsMode);
+    }
+
+    int AgoraRtcEngine::SetAudioScenario(int scenario)
+    {
+        return m_rtcEngine->setAudioScenario(static_cast<AUDIO_SCENARIO_TYPE>(scenario));
+    }
+
+    int AgoraRtcEngine::SetClientRole(int role)
+    {
+        return m_rtcEngine->setClientRole(static_cast<CLIENT_ROLE_TYPE>(role));
+    }
+
+    int AgoraRtcEngine::SetAudioProfile(int profile)
+    {
+        return m_rtcEngine->setAudioProfile(static_cast<AUDIO_PROFILE_TYPE>(profile));
+    }
+
+    int AgoraRtcEngine::SetParameters(const std::string& json)
+    {
+        return m_rtcEngine->setParameters(json.c_str());
+    }
+
+    int AgoraRtcEngine::StartEchoTest(int intervalMs)
+    {
+        // Use AAudioDeviceManager class for Windows SDK
+        agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
+        if (!audioDeviceManager) return -1;
+        return audioDeviceManager->startAudioDeviceLoopbackTest(intervalMs);
+    }
+
+    int AgoraRtcEngine::StopEchoTest()
+    {
+        agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
+        if (!audioDeviceManager) return -1;
+        return audioDeviceManager->stopAudioDeviceLoopbackTest();
+    }
+
+    int AgoraRtcEngine::StartLastmileProbe(int expectedUplinkKbps, int expectedDownlinkKbps)
+    {
+        LastmileProbeConfig config;
+        config.probeUplink = true;
+        config.probeDownlink = true;
+        config.expectedUplinkBitrate = static_cast<unsigned int>(expectedUplinkKbps) * 1000;
+        config.expectedDownlinkBitrate = static_cast<unsigned int>(expectedDownlinkKbps) * 1000;
+        return m_rtcEngine->startLastmileProbeTest(config);
+    }
+
+    int AgoraRtcEngine::StopLastmileProbe()
+    {
+        return m_rtcEngine->stopLastmileProbeTest();
+    }
+
+    int AgoraRtcEngine::SetExternalAudio(bool enabled, int sampleRate, int captureChannels, int playbackChannels)
+    {
+        if (!m_rtcEngine) return -7;
+        if (!m_mediaEngine) {
+            m_mediaEngine.queryInterface(m_rtcEngine, AGORA_IID_MEDIA_ENGINE);
+            if (!m_mediaEngine) return -4;
+        }
+
+        if (!enabled) {
+            if (!m_externalAudio) return 0;
+            m_externalAudio = false;
+            m_mediaEngine->setExternalAudioSink(false, 0, 0);
+            m_mediaEngine->destroyCustomAudioTrack(m_customTrack);
+            m_customTrack = 0;
+            return 0;
+        }
+
+        // Direct track: pushed frames go to the encoder as they are, without the SDK's 3A,
+        // and are not played locally
+        AudioTrackConfig trackConfig;
+        trackConfig.enableLocalPlayback = false;
+        track_id_t track = m_mediaEngine->createCustomAudioTrack(AUDIO_TRACK_DIRECT, trackConfig);
+        if (static_cast<int>(track) < 0) return static_cast<int>(track);
+
+        int result = m_mediaEngine->setExternalAudioSink(true, sampleRate, playbackChannels);
+        if (result != 0) {
+            m_mediaEngine->destroyCustomAudioTrack(track);
+            return result;
+        }
+        (void)captureChannels; // carried by every pushed frame
+        m_customTrack = track;
+        m_externalAudio = true;
+        return 0;
+    }
+
+    // Pump thread: the SDK copies the buffer before returning
+    int AgoraRtcEngine::PushAudioFrame(const int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        if (!m_externalAudio) return -7;
+
+        agora::media::IAudioFrameObserverBase::AudioFrame frame;
+        frame.type = agora::media::IAudioFrameObserverBase::FRAME_TYPE_PCM16;
+        frame.samplesPerChannel = framesPerChannel;
+        frame.bytesPerSample = agora::rtc::TWO_BYTES_PER_SAMPLE;
+        frame.channels = channels;
+        frame.samplesPerSec = sampleRate;
+        frame.buffer = const_cast<int16_t*>(samples);
+        return m_mediaEngine->pushAudioFrame(&frame, m_customTrack);
+    }
+
+    int AgoraRtcEngine::PullAudioFrame(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        if (!m_externalAudio) return -7;
+
+        agora::media::IAudioFrameObserverBase::AudioFrame frame;
+        frame.type = agora::media::IAudioFrameObserverBase::FRAME_TYPE_PCM16;
+        frame.samplesPerChannel = framesPerChannel;
+        frame.bytesPerSample = agora::rtc::TWO_BYTES_PER_SAMPLE;
+        frame.channels = channels;
+        frame.samplesPerSec = sampleRate;
+        frame.buffer = samples;
+        return m_mediaEngine->pullAudioFrame(&frame);
+    }
+
+    int AgoraRtcEngine::EnumerateAudioDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo>& devices)
+    {
+        agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
+        if (!audioDeviceManager) return -1;
+
+        IAudioDeviceCollection* collection = kind == AudioDeviceKind::Playback
+            ? audioDeviceManager->enumeratePlaybackDevices()
+            : audioDeviceManager->enumerateRecordingDevices();
+        if (!collection) return -1;
+
+        devices.clear();
+        int count = collection->getCount();
+        devices.reserve(static_cast<size_t>(std::max(0, count)));
+        for (int i = 0; i < count; ++i) {
+            char name[MAX_DEVICE_ID_LENGTH] = {};
+            char id[MAX_DEVICE_ID_LENGTH] = {};
+            if (collection->getDevice(i, name, id) == 0) {
+                devices.push_back(AudioDeviceInfo{ id, name });
+            }
+        }
+        collection->release();
+        return 0;
+    }
+
+    int AgoraRtcEngine::GetAudioDevice(AudioDeviceKind kind, std::string& deviceId)
+    {
+        agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
+        if (!audioDeviceManager) return -1;
+
+        char id[MAX_DEVICE_ID_LENGTH] = {};
+        int result = kind == AudioDeviceKind::Playback ? audioDeviceManager->getPlaybackDevice(id)
+                                                       : audioDeviceManager->getRecordingDevice(id);
+        if (result == 0) deviceId = id;
+        return result;
+    }
+
+    // A device we pick pins it; an empty id hands the choice back to Windows' default device
+    int AgoraRtcEngine::SetAudioDevice(AudioDeviceKind kind, const std::string& deviceId)
+    {
+        agora::rtc::AAudioDeviceManager audioDeviceManager(m_rtcEngine);
+        if (!audioDeviceManager) return -1;
+        if (deviceId.size() >= MAX_DEVICE_ID_LENGTH) return -2;
+
+        const bool follow = deviceId.empty();
+        if (kind == AudioDeviceKind::Playback) {
+            int result = audioDeviceManager->followSystemPlaybackDevice(follow);
+            if (result != 0 || follow) return result;
+            return audioDeviceManager->setPlaybackDevice(deviceId.c_str());
+        }
+        int result = audioDeviceManager->followSystemRecordingDevice(follow);
+        if (result != 0 || follow) return result;
+        return audioDeviceManager->setRecordingDevice(deviceId.c_str());
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+
+// Include Agora SDK headers properly
+#include "IAgoraRtcEngine.h"
+#include "IAgoraRtcEngineEx.h"
+#include "AgoraBase.h"
+#include "AgoraMediaBase.h"
+#include "IAgoraMediaEngine.h"
+
+#include "AudioPipeline.h"
+#include "VoiceEngine.h"
+
+// IVoiceEngine over the Agora Windows SDK. Every call maps to one IRtcEngineEx call;
+// SDK callbacks are converted to plain types and forwarded to the core's handlers.
+namespace winrt::FinalProject::implementation
+{
+    using namespace agora::rtc;
+
+    // SDK event handler for one connection, forwarding to the core's IVoiceEngineEvents
+    class AgoraEventBridge : public IRtcEngineEventHandler
+    {
+    public:
+        explicit AgoraEventBridge(IVoiceEngineEvents* events) : m_events(events) {}
+
+        void onJoinChannelSuccess(const char* channel, uid_t uid, int elapsed) override;
+        void onLeaveChannel(const RtcStats& stats) override;
+        void onUserJoined(uid_t uid, int elapsed) override;
+        void onUserOffline(uid_t uid, USER_OFFLINE_REASON_TYPE reason) override;
+        void onError(int err, const char* msg) override;
+        void onAudioVolumeIndication(const AudioVolumeInfo* speakers, unsigned int speakerNumber, int totalVolume) override;
+        void onActiveSpeaker(uid_t uid) override;
+        void onRtcStats(const RtcStats& stats) override;
+        void onNetworkQuality(uid_t uid, int txQuality, int rxQuality) override;
+        void onRemoteAudioStats(const RemoteAudioStats& stats) override;
+        void onConnectionStateChanged(CONNECTION_STATE_TYPE state, CONNECTION_CHANGED_REASON_TYPE reason) override;
+        void onConnectionLost() override;
+        void onRejoinChannelSuccess(const char* channel, uid_t uid, int elapsed) override;
+        void onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState) override;
+        void onLastmileProbeResult(const agora::rtc::LastmileProbeResult& result) override;
+        void onStreamMessage(uid_t userId, int streamId, const char* data, size_t length, uint64_t sentTs) override;
+
+    private:
+        static ChannelStatsSample ToSample(const RtcStats& stats);
+
+        IVoiceEngineEvents* m_events;
+    };
+
+    // Raw PCM hook: runs the core's pipelines on the SDK audio thread (10 ms, 48 kHz frames)
+    class AgoraAudioFrameObserver : public agora::media::IAudioFrameObserver
+    {
+    public:
+        static constexpr int kSampleRate = 48000;
+        static constexpr int kRecordChannels = 1;
+        static constexpr int kPlaybackChannels = 2;
+        static constexpr int kSamplesPerChannel = kSampleRate / 100;
+        static constexpr int kRemoteChannels = 1;
+
+        // Set while the observer is unregistered, so the audio thread never sees a change
+        void SetPipelines(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote)
+        {
+            m_capture = capture;
+            m_playback = playback;
+            m_remote = remote;
+        }
+
+        bool onRecordAudioFrame(const char* channelId, AudioFrame& audioFrame) override;
+        bool onPublishAudioFrame(const char* channelId, AudioFrame& audioFrame) override;
+        bool onPlaybackAudioFrame(const char* channelId, AudioFrame& audioFrame) override;
+        bool onMixedAudioFrame(const char* channelId, AudioFrame& audioFrame) override;
+        bool onEarMonitoringAudioFrame(AudioFrame& audioFrame) override;
+        bool onPlaybackAudioFrameBeforeMixing(const char* channelId, uid_t uid, AudioFrame& audioFrame) override;
+        int getObservedAudioFramePosition() override;
+        AudioParams getPlaybackAudioParams() override;
+        AudioParams getRecordAudioParams() override;
+        AudioParams getMixedAudioParams() override;
+        AudioParams getEarMonitoringAudioParams() override;
+
+    private:
+        static bool Run(AudioPipeline* pipeline, AudioFrame& audioFrame);
+
+        AudioPipeline* m_capture = nullptr;  // microphone before encoding
+        AudioPipeline* m_playback = nullptr; // everything we hear, after mixing all radios
+        IRemoteAudioSink* m_remote = nullptr; // every remote user on every connection, before mixing
+    };
+
+    class AgoraRtcEngine : public IVoiceEngine
+    {
+    public:
+        AgoraRtcEngine() = default;
+        ~AgoraRtcEngine() override { Release(); }
+
+        AgoraRtcEngine(const AgoraRtcEngine&) = delete;
+        AgoraRtcEngine& operator=(const AgoraRtcEngine&) = delete;
+
+        int Initialize(const std::string& appId, IVoiceEngineEvents* events) override;
+        void Release() override;
+        int SetAudioProcessors(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote) override;
+
+        int JoinChannel(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) override;
+        int UpdateChannel(const ConnectionOptions& options) override;
+        int LeaveChannel() override;
+        int MuteLocalAudio(bool mute) override;
+        int EnableVolumeIndication(int intervalMs, int smooth) override;
+
+        int JoinConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options,
+                           IVoiceEngineEvents* events) override;
+        int UpdateConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) override;
+        int LeaveConnection(const std::string& channelName, uint32_t uid) override;
+        int MuteConnectionAudio(const std::string& channelName, uint32_t uid, bool mute) override;
+        int EnableConnectionVolumeIndication(const std::string& channelName, uint32_t uid, int intervalMs, int smooth) override;
+        int CreateDataStream(const std::string& channelName, uint32_t uid, int* streamId) override;
+        int SendStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const char* data, size_t length) override;
+
+        int EnableLocalAudio(bool enabled) override;
+        int MuteRemoteAudio(uint32_t uid, bool mute) override;
+        int SetRecordingVolume(int volume) override;
+        int SetPlaybackVolume(int volume) override;
+        int SetVoiceEqualization(int band, int gainDb) override;
+        int SetNoiseSuppression(bool enabled, int mode) override;
+        int SetAudioScenario(int scenario) override;
+        int SetClientRole(int role) override;
+        int SetAudioProfile(int profile) override;
+        int SetParameters(const std::string& json) override;
+        int StartEchoTest(int intervalMs) override;
+        int StopEchoTest() override;
+        int StartLastmileProbe(int expectedUplinkKbps, int expectedDownlinkKbps) override;
+        int StopLastmileProbe() override;
+        int SetExternalAudio(bool enabled, int sampleRate, int captureChannels, int playbackChannels) override;
+        int PushAudioFrame(const int16_t* samples, int framesPerChannel, int channels, int sampleRate) override;
+        int PullAudioFrame(int16_t* samples, int framesPerChannel, int channels, int sampleRate) override;
+        int EnumerateAudioDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo>& devices) override;
+        int GetAudioDevice(AudioDeviceKind kind, std::string& deviceId) override;
+        int SetAudioDevice(AudioDeviceKind kind, const std::string& deviceId) override;
+
+    private:
+        static void ApplyRole(const ConnectionOptions& options, ChannelMediaOptions& mediaOptions);
+        // External audio publishes the custom track wherever the microphone would have been
+        void ApplyAudioSource(ChannelMediaOptions& mediaOptions) const;
+        ChannelMediaOptions ToMediaOptions(const ConnectionOptions& options) const;
+        static RtcConnection ToConnection(const std::string& channelName, uint32_t uid);
+
+        IRtcEngineEx* m_rtcEngine = nullptr;
+        std::unique_ptr<AgoraEventBridge> m_eventBridge;
+        // Kept until release: leave callbacks arrive after leaveChannelEx returns
+        std::map<std::string, std::unique_ptr<AgoraEventBridge>> m_connectionBridges;
+        AgoraAudioFrameObserver m_audioFrameObserver;
+        bool m_observerRegistered = false;
+
+        // External audio: the media engine is cached for the pump's per-frame push and pull
+        agora::util::AutoPtr<agora::media::IMediaEngine> m_mediaEngine;
+        bool m_externalAudio = false;
+        track_id_t m_customTrack = 0;
+    };
+}
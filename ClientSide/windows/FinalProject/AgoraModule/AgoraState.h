@@ -0,0 +1,160 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ConnectionMonitor.h"
+#include "DeviceRegistry.h"
+#include "LinkProfile.h"
+
+// RCU-style publication of AgoraManager state. Writers (the command worker, and
+// rarely SDK callbacks) copy the current snapshot, modify the copy and publish it
+// with one atomic exchange. Readers on any thread get a consistent, immutable
+// snapshot without taking a lock.
+namespace winrt::FinalProject::implementation
+{
+    // Where the time goes between "answer" and hearing the other side (milliseconds)
+    struct CallLatency
+    {
+        double engineInitMs = 0.0;  // last real create + initialize + audio profile
+        double initCallMs = 0.0;    // last InitializeEngine call as seen by JS (~0 when warm)
+        double prepareMs = 0.0;     // PrepareChannel: silent joinChannelEx request
+        double acceptMs = 0.0;      // AcceptCall until the call connection is joined and publishing
+        bool acceptWarm = false;    // accept used a prepared connection
+        std::string acceptChannel;
+    };
+
+    struct AgoraState
+    {
+        uint64_t version = 0;
+        bool isEngineCreated = false;
+        bool isInitialized = false;
+        bool isEchoTestRunning = false;
+        bool isLocalAudioMuted = false;
+        bool isLocalAudioEnabled = true;
+        bool isListenOnly = false;  // default channel joined as audience; a key-up switches to broadcaster
+        bool isExternalAudio = false; // our own capture and renderer instead of the SDK's devices
+        int audioScenario = -1;         // AUDIO_SCENARIO_TYPE last applied (-1 = none yet)
+        int noiseSuppressionMode = -1;  // AINS mode last applied (-1 = off)
+        std::string appId;
+        std::string currentChannel;
+        std::vector<std::string> radioChannels;
+        std::string talkChannel;
+        std::string preparedChannel;
+        CallLatency callLatency;
+        AudioDeviceList recordingDevices{ AudioDeviceKind::Recording };
+        AudioDeviceList playbackDevices{ AudioDeviceKind::Playback };
+        LinkDecision link;              // audio profile for the current network
+        bool isLastmileProbing = false;
+        std::map<std::string, ConnectionState> connections; // tracked links by monitor key ("" = default channel)
+    };
+
+    template <typename T>
+    class SnapshotCell
+    {
+    public:
+        SnapshotCell() : m_current(new T()) {}
+
+        ~SnapshotCell()
+        {
+            delete m_current.load();
+            for (const Retired& retired : m_retired) delete retired.snapshot;
+        }
+
+        SnapshotCell(const SnapshotCell&) = delete;
+        SnapshotCell& operator=(const SnapshotCell&) = delete;
+
+        // Lock-free: fn sees one snapshot for its whole duration
+        template <typename Fn>
+        auto Read(Fn&& fn) const
+        {
+            ReadGuard guard(*this);
+            const T* snapshot = m_current.load();
+            return fn(*snapshot);
+        }
+
+        T Load() const
+        {
+            return Read([](const T& snapshot) { return snapshot; });
+        }
+
+        // Copy-modify-publish. Writers serialize among themselves only.
+        template <typename Fn>
+        void Update(Fn&& mutate)
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+
+            T next = *m_current.load();
+            mutate(next);
+            ++next.version;
+
+            const T* previous = m_current.exchange(new T(std::move(next)));
+            m_retired.push_back({ previous, m_epoch.load() });
+            Reclaim();
+        }
+
+        size_t GetRetiredCount() const
+        {
+            std::lock_guard<std::mutex> lock(m_writeMutex);
+            return m_retired.size();
+        }
+
+    private:
+        struct Retired
+        {
+            const T* snapshot;
+            uint64_t epoch; // epoch when it was replaced
+        };
+
+        // Counts the reader in the epoch it started in. Backs out if the epoch moved on
+        // before the count was visible, so a writer never misses a reader it must wait for.
+        struct ReadGuard
+        {
+            explicit ReadGuard(const SnapshotCell& cell)
+            {
+                for (;;) {
+                    uint64_t epoch = cell.m_epoch.load();
+                    m_readers = &cell.m_readers[epoch & 1];
+                    m_readers->fetch_add(1);
+                    if (cell.m_epoch.load() == epoch) return;
+                    m_readers->fetch_sub(1);
+                }
+            }
+            ~ReadGuard() { m_readers->fetch_sub(1); }
+            std::atomic<uint32_t>* m_readers;
+        };
+
+        // Grace period per generation: the epoch only advances once the readers of the epoch
+        // before it are gone, so readers are only ever in the current epoch or the one before.
+        // A snapshot replaced in epoch e is then unreachable once the epoch is e + 2, however
+        // many reads overlap the writes. Runs under m_writeMutex; never blocks on readers.
+        void Reclaim()
+        {
+            for (int step = 0; step < 2; ++step) {
+                uint64_t epoch = m_epoch.load();
+                if (m_readers[(epoch + 1) & 1].load() != 0) break;
+                m_epoch.store(epoch + 1);
+            }
+
+            uint64_t epoch = m_epoch.load();
+            size_t kept = 0;
+            for (const Retired& retired : m_retired) {
+                if (retired.epoch + 2 <= epoch) {
+                    delete retired.snapshot;
+                } else {
+                    m_retired[kept++] = retired;
+                }
+            }
+            m_retired.resize(kept);
+        }
+
+        std::atomic<const T*> m_current;
+        std::atomic<uint64_t> m_epoch{ 0 };
+        mutable std::atomic<uint32_t> m_readers[2] = {}; // by epoch parity
+        mutable std::mutex m_writeMutex;
+        std::vector<Retired> m_retired;
+    };
+}
@@ -0,0 +1,408 @@
+#include "AudioDsp.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(AGORA_DSP_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AGORA_TARGET_AVX2
+#else
+#define AGORA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        inline int16_t Saturate16(int32_t value)
+        {
+            return static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+        }
+
+        // ---- Scalar (reference, and every non-x86 build) ----
+
+        void ApplyGainScalar(int16_t* samples, size_t count, int32_t gainQ12)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                samples[i] = Saturate16((samples[i] * gainQ12 + 2048) >> 12);
+            }
+        }
+
+        int32_t PeakAbsScalar(const int16_t* samples, size_t count)
+        {
+            int32_t peak = 0;
+            for (size_t i = 0; i < count; ++i) {
+                peak = std::max(peak, std::abs(static_cast<int32_t>(samples[i])));
+            }
+            return std::min(peak, 32767);
+        }
+
+        float SumSquaresScalar(const int16_t* samples, size_t count)
+        {
+            double sum = 0.0;
+            for (size_t i = 0; i < count; ++i) {
+                int32_t value = std::max<int32_t>(samples[i], -32767);
+                sum += static_cast<double>(value * value);
+            }
+            return static_cast<float>(sum);
+        }
+
+        uint32_t ZeroCrossingsScalar(const int16_t* samples, size_t count)
+        {
+            uint32_t crossings = 0;
+            for (size_t i = 1; i < count; ++i) {
+                crossings += (samples[i - 1] ^ samples[i]) < 0 ? 1u : 0u;
+            }
+            return crossings;
+        }
+
+        void MixRampScalar(float* acc, const int16_t* samples, size_t count, float gain, float step)
+        {
+            for (size_t i = 0; i < count; ++i) {
+                acc[i] += static_cast<float>(samples[i]) * (gain + step * static_cast<float>(i));
+            }
+        }
+
+        inline int16_t RoundSaturate(float value)
+        {
+            return static_cast<int16_t>(std::lrint(std::max(-32768.0f, std::min(32767.0f, value))));
+        }
+
+        void StoreMixScalar(int16_t* out, const float* left, const float* right, size_t frames)
+        {
+            if (!right) {
+                for (size_t i = 0; i < frames; ++i) out[i] = RoundSaturate(left[i]);
+                return;
+            }
+            for (size_t i = 0; i < frames; ++i) {
+                out[2 * i] = RoundSaturate(left[i]);
+                out[2 * i + 1] = RoundSaturate(right[i]);
+            }
+        }
+
+#if defined(AGORA_DSP_X86)
+        // ---- SSE2, 8 samples per step ----
+
+        void ApplyGainSse2(int16_t* samples, size_t count, int32_t gainQ12)
+        {
+            const __m128i gain = _mm_set1_epi16(static_cast<short>(gainQ12));
+            const __m128i rounding = _mm_set1_epi32(1 << 11);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                // 16x16 -> 32 bit products from the low and high halves
+                __m128i lo = _mm_mullo_epi16(x, gain);
+                __m128i hi = _mm_mulhi_epi16(x, gain);
+                __m128i p0 = _mm_srai_epi32(_mm_add_epi32(_mm_unpacklo_epi16(lo, hi), rounding), 12);
+                __m128i p1 = _mm_srai_epi32(_mm_add_epi32(_mm_unpackhi_epi16(lo, hi), rounding), 12);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(samples + i), _mm_packs_epi32(p0, p1));
+            }
+            ApplyGainScalar(samples + i, count - i, gainQ12);
+        }
+
+        int32_t PeakAbsSse2(const int16_t* samples, size_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            __m128i peak = zero;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                // Saturating negate turns -32768 into 32767
+                peak = _mm_max_epi16(peak, _mm_max_epi16(x, _mm_subs_epi16(zero, x)));
+            }
+            peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 8));
+            peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 4));
+            peak = _mm_max_epi16(peak, _mm_srli_si128(peak, 2));
+            int32_t result = static_cast<int16_t>(_mm_cvtsi128_si32(peak));
+            return std::max(result, PeakAbsScalar(samples + i, count - i));
+        }
+
+        float SumSquaresSse2(const int16_t* samples, size_t count)
+        {
+            const __m128i floor = _mm_set1_epi16(-32767);
+            __m128 sum = _mm_setzero_ps();
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i x = _mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i)), floor);
+                sum = _mm_add_ps(sum, _mm_cvtepi32_ps(_mm_madd_epi16(x, x)));
+            }
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, sum);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumSquaresScalar(samples + i, count - i);
+        }
+
+        // Same float operations in the same order as the scalar loop, so the results match it
+        void MixRampSse2(float* acc, const int16_t* samples, size_t count, float gain, float step)
+        {
+            const __m128 steps = _mm_set1_ps(step);
+            const __m128 base = _mm_set1_ps(gain);
+            __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            const __m128 four = _mm_set1_ps(4.0f);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                // Sign-extend to 32 bits: duplicate each sample into the high half and shift it down
+                __m128 s0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+                __m128 s1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+                __m128 g0 = _mm_add_ps(base, _mm_mul_ps(steps, index));
+                index = _mm_add_ps(index, four);
+                __m128 g1 = _mm_add_ps(base, _mm_mul_ps(steps, index));
+                index = _mm_add_ps(index, four);
+                _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(s0, g0)));
+                _mm_storeu_ps(acc + i + 4, _mm_add_ps(_mm_loadu_ps(acc + i + 4), _mm_mul_ps(s1, g1)));
+            }
+            for (; i < count; ++i) {
+                acc[i] += static_cast<float>(samples[i]) * (gain + step * static_cast<float>(i));
+            }
+        }
+
+        // Clamped first: cvtps_epi32 turns anything past int32 into INT_MIN, which would pack to -32768
+        inline __m128i RoundSaturateSse2(__m128 value)
+        {
+            const __m128 low = _mm_set1_ps(-32768.0f);
+            const __m128 high = _mm_set1_ps(32767.0f);
+            return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(value, low), high));
+        }
+
+        // Also serves AVX2: it is bound by the stores, and 256-bit unpacks would scramble the pairs
+        void StoreMixSse2(int16_t* out, const float* left, const float* right, size_t frames)
+        {
+            size_t i = 0;
+            if (!right) {
+                for (; i + 8 <= frames; i += 8) {
+                    __m128i a = RoundSaturateSse2(_mm_loadu_ps(left + i));
+                    __m128i b = RoundSaturateSse2(_mm_loadu_ps(left + i + 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(a, b));
+                }
+                StoreMixScalar(out + i, left + i, nullptr, frames - i);
+                return;
+            }
+            for (; i + 4 <= frames; i += 4) {
+                __m128 l = _mm_loadu_ps(left + i);
+                __m128 r = _mm_loadu_ps(right + i);
+                __m128i a = RoundSaturateSse2(_mm_unpacklo_ps(l, r)); // l0 r0 l1 r1
+                __m128i b = RoundSaturateSse2(_mm_unpackhi_ps(l, r)); // l2 r2 l3 r3
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i), _mm_packs_epi32(a, b));
+            }
+            StoreMixScalar(out + 2 * i, left + i, right + i, frames - i);
+        }
+
+        uint32_t ZeroCrossingsSse2(const int16_t* samples, size_t count)
+        {
+            // Per-lane counters; 16-bit lanes are drained every 16k steps so they cannot wrap
+            const __m128i ones = _mm_set1_epi16(1);
+            __m128i total = _mm_setzero_si128();
+            size_t i = 0;
+            while (i + 9 <= count) {
+                __m128i lanes = _mm_setzero_si128();
+                for (int step = 0; step < 16384 && i + 9 <= count; ++step, i += 8) {
+                    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i + 1));
+                    // Sign bit of a ^ b marks a crossing; arithmetic shift makes it -1
+                    lanes = _mm_sub_epi16(lanes, _mm_srai_epi16(_mm_xor_si128(a, b), 15));
+                }
+                total = _mm_add_epi32(total, _mm_madd_epi16(lanes, ones));
+            }
+            alignas(16) int32_t sums[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(sums), total);
+            uint32_t crossings = static_cast<uint32_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+            // Tail starts at the last sample already compared so no pair is counted twice
+            return crossings + (i < count ? ZeroCrossingsScalar(samples + i, count - i) : 0u);
+        }
+
+        // ---- AVX2, 16 samples per step (unpack/pack are per 128-bit lane, so order is kept).
+        // Tails go to the scalar code after vzeroupper to avoid AVX/SSE transition stalls. ----
+
+        AGORA_TARGET_AVX2 void ApplyGainAvx2(int16_t* samples, size_t count, int32_t gainQ12)
+        {
+            const __m256i gain = _mm256_set1_epi16(static_cast<short>(gainQ12));
+            const __m256i rounding = _mm256_set1_epi32(1 << 11);
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+                __m256i lo = _mm256_mullo_epi16(x, gain);
+                __m256i hi = _mm256_mulhi_epi16(x, gain);
+                __m256i p0 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpacklo_epi16(lo, hi), rounding), 12);
+                __m256i p1 = _mm256_srai_epi32(_mm256_add_epi32(_mm256_unpackhi_epi16(lo, hi), rounding), 12);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(samples + i), _mm256_packs_epi32(p0, p1));
+            }
+            _mm256_zeroupper();
+            ApplyGainScalar(samples + i, count - i, gainQ12);
+        }
+
+        AGORA_TARGET_AVX2 int32_t PeakAbsAvx2(const int16_t* samples, size_t count)
+        {
+            __m256i peak = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+                // abs(-32768) stays 0x8000, which the unsigned max reads as 32768
+                peak = _mm256_max_epu16(peak, _mm256_abs_epi16(x));
+            }
+            __m128i folded = _mm_max_epu16(_mm256_castsi256_si128(peak), _mm256_extracti128_si256(peak, 1));
+            folded = _mm_max_epu16(folded, _mm_srli_si128(folded, 8));
+            folded = _mm_max_epu16(folded, _mm_srli_si128(folded, 4));
+            folded = _mm_max_epu16(folded, _mm_srli_si128(folded, 2));
+            int32_t result = std::min(_mm_cvtsi128_si32(folded) & 0xFFFF, 32767);
+            _mm256_zeroupper();
+            return std::max(result, PeakAbsScalar(samples + i, count - i));
+        }
+
+        AGORA_TARGET_AVX2 float SumSquaresAvx2(const int16_t* samples, size_t count)
+        {
+            const __m256i floor = _mm256_set1_epi16(-32767);
+            __m256 sum = _mm256_setzero_ps();
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m256i x = _mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i)), floor);
+                sum = _mm256_add_ps(sum, _mm256_cvtepi32_ps(_mm256_madd_epi16(x, x)));
+            }
+            __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, half);
+            _mm256_zeroupper();
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumSquaresScalar(samples + i, count - i);
+        }
+
+        AGORA_TARGET_AVX2 void MixRampAvx2(float* acc, const int16_t* samples, size_t count, float gain, float step)
+        {
+            const __m256 steps = _mm256_set1_ps(step);
+            const __m256 base = _mm256_set1_ps(gain);
+            __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+            const __m256 eight = _mm256_set1_ps(8.0f);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(samples + i));
+                __m256 s = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x));
+                // No FMA: a fused multiply-add would round differently from the scalar code
+                __m256 g = _mm256_add_ps(base, _mm256_mul_ps(steps, index));
+                index = _mm256_add_ps(index, eight);
+                _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(s, g)));
+            }
+            _mm256_zeroupper();
+            for (; i < count; ++i) {
+                acc[i] += static_cast<float>(samples[i]) * (gain + step * static_cast<float>(i));
+            }
+        }
+
+        AGORA_TARGET_AVX2 uint32_t ZeroCrossingsAvx2(const int16_t* samples, size_t count)
+        {
+            const __m256i ones = _mm256_set1_epi16(1);
+            __m256i total = _mm256_setzero_si256();
+            size_t i = 0;
+            while (i + 17 <= count) {
+                __m256i lanes = _mm256_setzero_si256();
+                for (int step = 0; step < 16384 && i + 17 <= count; ++step, i += 16) {
+                    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i));
+                    __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(samples + i + 1));
+                    lanes = _mm256_sub_epi16(lanes, _mm256_srai_epi16(_mm256_xor_si256(a, b), 15));
+                }
+                total = _mm256_add_epi32(total, _mm256_madd_epi16(lanes, ones));
+            }
+            __m128i half = _mm_add_epi32(_mm256_castsi256_si128(total), _mm256_extracti128_si256(total, 1));
+            alignas(16) int32_t sums[4];
+            _mm_store_si128(reinterpret_cast<__m128i*>(sums), half);
+            _mm256_zeroupper();
+            uint32_t crossings = static_cast<uint32_t>(sums[0] + sums[1] + sums[2] + sums[3]);
+            return crossings + (i < count ? ZeroCrossingsScalar(samples + i, count - i) : 0u);
+        }
+
+        bool CpuHasAvx2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx) return false;
+            // OS must save the YMM registers on context switch
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        DspKernels MakeKernels(DspIsa isa)
+        {
+            DspKernels kernels;
+            kernels.isa = DspIsa::Scalar;
+            kernels.applyGain = ApplyGainScalar;
+            kernels.peakAbs = PeakAbsScalar;
+            kernels.sumSquares = SumSquaresScalar;
+            kernels.zeroCrossings = ZeroCrossingsScalar;
+            kernels.mixRamp = MixRampScalar;
+            kernels.storeMix = StoreMixScalar;
+#if defined(AGORA_DSP_X86)
+            if (isa == DspIsa::Sse2) {
+                kernels.isa = DspIsa::Sse2;
+                kernels.applyGain = ApplyGainSse2;
+                kernels.peakAbs = PeakAbsSse2;
+                kernels.sumSquares = SumSquaresSse2;
+                kernels.zeroCrossings = ZeroCrossingsSse2;
+                kernels.mixRamp = MixRampSse2;
+                kernels.storeMix = StoreMixSse2;
+            } else if (isa == DspIsa::Avx2) {
+                kernels.isa = DspIsa::Avx2;
+                kernels.applyGain = ApplyGainAvx2;
+                kernels.peakAbs = PeakAbsAvx2;
+                kernels.sumSquares = SumSquaresAvx2;
+                kernels.zeroCrossings = ZeroCrossingsAvx2;
+                kernels.mixRamp = MixRampAvx2;
+                kernels.storeMix = StoreMixSse2;
+            }
+#else
+            (void)isa;
+#endif
+            return kernels;
+        }
+    }
+
+    const char* DspIsaName(DspIsa isa)
+    {
+        switch (isa) {
+            case DspIsa::Scalar: return "scalar";
+            case DspIsa::Sse2: return "sse2";
+            case DspIsa::Avx2: return "avx2";
+        }
+        return "?";
+    }
+
+    DspIsa DetectDspIsa()
+    {
+#if defined(AGORA_DSP_X86)
+        // SSE2 is baseline on every x86 target we build for
+        static const DspIsa detected = CpuHasAvx2() ? DspIsa::Avx2 : DspIsa::Sse2;
+        return detected;
+#else
+        return DspIsa::Scalar;
+#endif
+    }
+
+    const DspKernels& GetDspKernels(DspIsa isa)
+    {
+        static const DspKernels scalar = MakeKernels(DspIsa::Scalar);
+        static const DspKernels sse2 = MakeKernels(DspIsa::Sse2);
+        static const DspKernels avx2 = MakeKernels(DspIsa::Avx2);
+
+        DspIsa supported = DetectDspIsa();
+        DspIsa chosen = static_cast<uint8_t>(isa) <= static_cast<uint8_t>(supported) ? isa : supported;
+        switch (chosen) {
+            case DspIsa::Avx2: return avx2;
+            case DspIsa::Sse2: return sse2;
+            default: return scalar;
+        }
+    }
+
+    const DspKernels& GetDspKernels()
+    {
+        return GetDspKernels(DetectDspIsa());
+    }
+}
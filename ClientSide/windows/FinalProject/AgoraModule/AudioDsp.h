@@ -0,0 +1,65 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// int16 PCM kernels for the native audio pipeline. Each kernel has a scalar
+// version plus SSE2/AVX2 versions on x86; the best one the CPU supports is picked
+// once at runtime. Define AGORA_DSP_FORCE_SCALAR to build the scalar path only.
+#if !defined(AGORA_DSP_FORCE_SCALAR) && \
+    (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__))
+#define AGORA_DSP_X86 1
+#endif
+
+namespace winrt::FinalProject::implementation
+{
+    enum class DspIsa : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    struct DspKernels
+    {
+        DspIsa isa = DspIsa::Scalar;
+
+        // samples = saturate(round(samples * gainQ12 / 4096)), gainQ12 in [0, 32767] (up to +18 dB)
+        void (*applyGain)(int16_t* samples, size_t count, int32_t gainQ12) = nullptr;
+
+        // Largest |sample|; -32768 counts as 32767
+        int32_t (*peakAbs)(const int16_t* samples, size_t count) = nullptr;
+
+        // Sum of squares (-32768 counts as -32767 so SIMD lanes cannot overflow)
+        float (*sumSquares)(const int16_t* samples, size_t count) = nullptr;
+
+        // Sign changes between neighbouring samples (0 counts as positive)
+        uint32_t (*zeroCrossings)(const int16_t* samples, size_t count) = nullptr;
+
+        // acc[i] += samples[i] * (gain + step * i): one stream into a float mix bus with a
+        // linear gain ramp (step 0 = constant gain)
+        void (*mixRamp)(float* acc, const int16_t* samples, size_t count, float gain, float step) = nullptr;
+
+        // Mix bus back to int16, rounded to nearest and saturated. right == nullptr writes
+        // frames mono samples, otherwise frames left/right pairs.
+        void (*storeMix)(int16_t* out, const float* left, const float* right, size_t frames) = nullptr;
+    };
+
+    const char* DspIsaName(DspIsa isa);
+
+    // What this CPU (and OS) can run
+    DspIsa DetectDspIsa();
+
+    // Kernels for the requested ISA, or the best supported one below it
+    const DspKernels& GetDspKernels(DspIsa isa);
+
+    // Best kernels for this machine, detected once
+    const DspKernels& GetDspKernels();
+
+    inline int32_t GainDbToQ12(float gainDb)
+    {
+        float linear = std::pow(10.0f, gainDb / 20.0f);
+        long q12 = std::lround(linear * 4096.0f);
+        return static_cast<int32_t>(q12 < 0 ? 0 : (q12 > 32767 ? 32767 : q12));
+    }
+}
@@ -0,0 +1,84 @@
+#include "AudioFrameRing.h"
+
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    AudioFrameRing::AudioFrameRing(size_t capacityFrames, size_t samplesPerFrame)
+        : m_capacity(std::max<size_t>(1, capacityFrames)),
+          m_samplesPerFrame(std::max<size_t>(1, samplesPerFrame)),
+          m_samples(m_capacity * m_samplesPerFrame, 0)
+    {
+    }
+
+    int16_t* AudioFrameRing::BeginWrite()
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tailCache >= m_capacity) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tailCache >= m_capacity) {
+                m_overruns.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return Slot(head);
+    }
+
+    void AudioFrameRing::CommitWrite()
+    {
+        m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool AudioFrameRing::Write(const int16_t* samples)
+    {
+        int16_t* slot = BeginWrite();
+        if (!slot) return false;
+        std::copy(samples, samples + m_samplesPerFrame, slot);
+        CommitWrite();
+        return true;
+    }
+
+    const int16_t* AudioFrameRing::BeginRead()
+    {
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_headCache) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail == m_headCache) {
+                m_underruns.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return Slot(tail);
+    }
+
+    void AudioFrameRing::ReleaseRead()
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool AudioFrameRing::Read(int16_t* samples)
+    {
+        const int16_t* slot = BeginRead();
+        if (!slot) return false;
+        std::copy(slot, slot + m_samplesPerFrame, samples);
+        ReleaseRead();
+        return true;
+    }
+
+    size_t AudioFrameRing::GetFill() const
+    {
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        return head > tail ? static_cast<size_t>(head - tail) : 0;
+    }
+
+    void AudioFrameRing::Reset()
+    {
+        m_head.store(0);
+        m_tail.store(0);
+        m_tailCache = 0;
+        m_headCache = 0;
+        m_overruns.store(0);
+        m_underruns.store(0);
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Single-producer single-consumer ring of fixed-size PCM frames, allocated once up front.
+// The producer and the consumer may each be a different thread; neither side ever blocks,
+// allocates or locks. A full ring refuses the write and an empty one the read, and both are
+// counted, so an audio device running a little faster or slower than the other end shows up
+// as overruns or underruns instead of a stall.
+namespace winrt::FinalProject::implementation
+{
+    class AudioFrameRing
+    {
+    public:
+        AudioFrameRing(size_t capacityFrames, size_t samplesPerFrame);
+
+        AudioFrameRing(const AudioFrameRing&) = delete;
+        AudioFrameRing& operator=(const AudioFrameRing&) = delete;
+
+        size_t GetCapacity() const { return m_capacity; }
+        size_t GetSamplesPerFrame() const { return m_samplesPerFrame; }
+
+        // Producer: the next free frame to fill in place, then Commit to hand it over;
+        // nullptr when the ring is full (counted as an overrun)
+        int16_t* BeginWrite();
+        void CommitWrite();
+        bool Write(const int16_t* samples); // one whole frame
+
+        // Consumer: the oldest frame, valid until Release; nullptr when empty (an underrun)
+        const int16_t* BeginRead();
+        void ReleaseRead();
+        bool Read(int16_t* samples);        // one whole frame
+
+        // Any thread; a snapshot that may already be stale
+        size_t GetFill() const;
+        uint64_t GetWritten() const { return m_head.load(std::memory_order_relaxed); }
+        uint64_t GetOverruns() const { return m_overruns.load(std::memory_order_relaxed); }
+        uint64_t GetUnderruns() const { return m_underruns.load(std::memory_order_relaxed); }
+
+        // Empties the ring and clears the counters; only while neither side runs
+        void Reset();
+
+    private:
+        int16_t* Slot(uint64_t index) { return m_samples.data() + (index % m_capacity) * m_samplesPerFrame; }
+
+        const size_t m_capacity;
+        const size_t m_samplesPerFrame;
+        std::vector<int16_t> m_samples;
+
+        // Each side owns one index and caches the other's, so the shared line is only read
+        // when the cached value says full or empty
+        alignas(64) std::atomic<uint64_t> m_head{ 0 }; // next frame to write
+        uint64_t m_tailCache = 0;                      // producer's view of m_tail
+        alignas(64) std::atomic<uint64_t> m_tail{ 0 }; // next frame to read
+        uint64_t m_headCache = 0;                      // consumer's view of m_head
+
+        alignas(64) std::atomic<uint64_t> m_overruns{ 0 };
+        std::atomic<uint64_t> m_underruns{ 0 };
+    };
+}
@@ -0,0 +1,192 @@
+#include "AudioPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr float kPi = 3.14159265358979f;
+        constexpr float kFullScale = 32767.0f;
+    }
+
+    AudioPipeline::AudioPipeline(const DspKernels& kernels) : m_kernels(kernels), m_vad(kernels)
+    {
+    }
+
+    bool AudioPipeline::AddMixSource(MixSource source, void* context)
+    {
+        if (!source || m_mixSourceCount >= kMaxMixSources) return false;
+        m_mixSources[m_mixSourceCount++] = MixSlot{ source, context };
+        return true;
+    }
+
+    void AudioPipeline::SetConfig(const AudioPipelineConfig& config)
+    {
+        m_config.Update([&config](AudioPipelineConfig& current) {
+            uint64_t version = current.version;
+            current = config;
+            current.version = version; // Update() bumps it
+        });
+    }
+
+    bool AudioPipeline::Process(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        if (!samples || framesPerChannel <= 0 || channels < 1 || channels > kMaxChannels || sampleRate <= 0) {
+            return false;
+        }
+
+        // Cheap when nothing changed: one reader count and a version compare
+        m_config.Read([&](const AudioPipelineConfig& config) {
+            if (config.version != m_preparedVersion || channels != m_preparedChannels || sampleRate != m_preparedSampleRate) {
+                Prepare(config, channels, sampleRate);
+            }
+        });
+        bool sourced = m_frameSource && m_frameSource(m_frameSourceContext, samples, framesPerChannel, channels, sampleRate);
+        if (!m_active.enabled) {
+            bool mixed = Mix(samples, framesPerChannel, channels, sampleRate);
+            return sourced || mixed;
+        }
+
+        if (m_active.highPassEnabled) {
+            HighPass(samples, framesPerChannel, channels);
+        }
+        if (m_gainQ12 != 4096) {
+            m_kernels.applyGain(samples, static_cast<size_t>(framesPerChannel) * channels, m_gainQ12);
+        }
+        if (m_active.voxEnabled && channels == 1) {
+            Gate(samples, framesPerChannel);
+        }
+        // Local audio goes in before the limiter, so a replay over live traffic can't clip
+        Mix(samples, framesPerChannel, channels, sampleRate);
+        if (m_active.limiterEnabled && m_gateOpen) {
+            Limit(samples, framesPerChannel, channels);
+        }
+
+        m_processedFrames.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void AudioPipeline::Prepare(const AudioPipelineConfig& config, int channels, int sampleRate)
+    {
+        if (channels != m_preparedChannels || sampleRate != m_preparedSampleRate) {
+            // Filter history from another format is meaningless
+            std::fill(std::begin(m_x1), std::end(m_x1), 0.0f);
+            std::fill(std::begin(m_x2), std::end(m_x2), 0.0f);
+            std::fill(std::begin(m_y1), std::end(m_y1), 0.0f);
+            std::fill(std::begin(m_y2), std::end(m_y2), 0.0f);
+            m_limiterGain = 1.0f;
+        }
+
+        m_active = config;
+        m_preparedVersion = config.version;
+        m_preparedChannels = channels;
+        m_preparedSampleRate = sampleRate;
+
+        // RBJ cookbook high-pass, Q = 1/sqrt(2)
+        float cutoff = std::max(10.0f, std::min(config.highPassHz, sampleRate * 0.45f));
+        float w0 = 2.0f * kPi * cutoff / static_cast<float>(sampleRate);
+        float cosW0 = std::cos(w0);
+        float alpha = std::sin(w0) / (2.0f * 0.70710678f);
+        float a0 = 1.0f + alpha;
+        m_highPass.b0 = (1.0f + cosW0) * 0.5f / a0;
+        m_highPass.b1 = -(1.0f + cosW0) / a0;
+        m_highPass.b2 = m_highPass.b0;
+        m_highPass.a1 = -2.0f * cosW0 / a0;
+        m_highPass.a2 = (1.0f - alpha) / a0;
+
+        m_gainQ12 = GainDbToQ12(config.gainDb);
+
+        VadConfig vad;
+        vad.thresholdDb = config.voxThresholdDb;
+        vad.attackMs = std::max(0, config.voxAttackMs);
+        vad.hangoverMs = std::max(0, config.voxHangoverMs);
+        m_vad.Configure(vad, sampleRate);
+
+        float blockSeconds = static_cast<float>(kBlockFrames) / static_cast<float>(sampleRate);
+
+        float limiterAmplitude = kFullScale * std::pow(10.0f, std::min(0.0f, config.limiterThresholdDb) / 20.0f);
+        m_limiterThreshold = static_cast<int32_t>(limiterAmplitude);
+        float releaseSeconds = std::max(1.0f, config.limiterReleaseMs) / 1000.0f;
+        m_limiterReleaseCoeff = 1.0f - std::exp(-blockSeconds / releaseSeconds);
+
+        if (!config.voxEnabled || channels != 1) {
+            m_vad.Reset();
+            if (!m_gateOpen) {
+                m_gateOpen = true;
+                m_gateOpenFlag.store(true, std::memory_order_relaxed);
+                if (m_gateListener) m_gateListener(m_gateListenerContext, true);
+            }
+        }
+    }
+
+    bool AudioPipeline::Mix(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        bool mixed = false;
+        for (int i = 0; i < m_mixSourceCount; ++i) {
+            mixed |= m_mixSources[i].source(m_mixSources[i].context, samples, framesPerChannel, channels, sampleRate);
+        }
+        return mixed;
+    }
+
+    void AudioPipeline::HighPass(int16_t* samples, int framesPerChannel, int channels)
+    {
+        // Recursive, so it runs sample by sample; channels are independent
+        const Biquad f = m_highPass;
+        for (int channel = 0; channel < channels; ++channel) {
+            float x1 = m_x1[channel], x2 = m_x2[channel];
+            float y1 = m_y1[channel], y2 = m_y2[channel];
+            int16_t* sample = samples + channel;
+            for (int frame = 0; frame < framesPerChannel; ++frame, sample += channels) {
+                float x = static_cast<float>(*sample);
+                float y = f.b0 * x + f.b1 * x1 + f.b2 * x2 - f.a1 * y1 - f.a2 * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                float clamped = std::max(-32768.0f, std::min(32767.0f, y));
+                *sample = static_cast<int16_t>(std::lrint(clamped));
+            }
+            // Keep decaying silence out of the denormal range
+            if (std::fabs(y1) < 1e-12f) y1 = 0.0f;
+            if (std::fabs(y2) < 1e-12f) y2 = 0.0f;
+            m_x1[channel] = x1; m_x2[channel] = x2;
+            m_y1[channel] = y1; m_y2[channel] = y2;
+        }
+    }
+
+    void AudioPipeline::Gate(int16_t* samples, int framesPerChannel)
+    {
+        bool open = m_vad.Process(samples, framesPerChannel);
+        if (open != m_gateOpen) {
+            m_gateOpen = open;
+            m_gateOpenFlag.store(open, std::memory_order_relaxed);
+            if (m_gateListener) m_gateListener(m_gateListenerContext, open);
+        }
+        if (!open) {
+            std::memset(samples, 0, static_cast<size_t>(framesPerChannel) * sizeof(int16_t));
+        }
+    }
+
+    void AudioPipeline::Limit(int16_t* samples, int framesPerChannel, int channels)
+    {
+        for (int start = 0; start < framesPerChannel; start += kBlockFrames) {
+            int frames = std::min(kBlockFrames, framesPerChannel - start);
+            size_t count = static_cast<size_t>(frames) * channels;
+            int16_t* block = samples + static_cast<size_t>(start) * channels;
+
+            int32_t peak = m_kernels.peakAbs(block, count);
+            float target = peak > m_limiterThreshold ? static_cast<float>(m_limiterThreshold) / peak : 1.0f;
+            // Instant attack, exponential release; gain never exceeds target so peaks never overshoot
+            if (target < m_limiterGain) {
+                m_limiterGain = target;
+            } else {
+                m_limiterGain += (target - m_limiterGain) * m_limiterReleaseCoeff;
+            }
+            if (m_limiterGain < 0.9999f) {
+                m_kernels.applyGain(block, count, static_cast<int32_t>(m_limiterGain * 4096.0f));
+            }
+        }
+    }
+}
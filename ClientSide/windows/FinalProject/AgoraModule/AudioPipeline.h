@@ -0,0 +1,133 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "AgoraState.h"
+#include "AudioDsp.h"
+#include "VoiceActivityDetector.h"
+
+// Our own processing on 10 ms int16 frames from the SDK audio observer:
+// [frame source] -> high-pass -> gain -> VOX gate -> mix sources -> limiter. Runs on the SDK
+// audio thread, so Process() never allocates, locks or logs. Settings are published from any
+// thread as immutable snapshots and picked up at the next frame.
+namespace winrt::FinalProject::implementation
+{
+    struct AudioPipelineConfig
+    {
+        uint64_t version = 0; // bumped by SnapshotCell
+
+        bool enabled = true;
+        float gainDb = -2.0f;            // about the old adjustRecordingSignalVolume(80)
+        bool highPassEnabled = true;
+        float highPassHz = 150.0f;       // replaces the 125/250 Hz equalizer cuts
+        bool limiterEnabled = true;
+        float limiterThresholdDb = -1.0f; // dBFS
+        float limiterReleaseMs = 80.0f;
+        bool voxEnabled = false;         // mono frames only
+        float voxThresholdDb = -45.0f;   // dBFS RMS that opens the gate
+        int voxAttackMs = 30;            // ignore sounds shorter than this
+        int voxHangoverMs = 400;         // keep open this long after speech
+    };
+
+    class AudioPipeline
+    {
+    public:
+        static constexpr int kMaxChannels = 2;
+        static constexpr int kBlockFrames = 32; // limiter decision granularity
+        static constexpr int kMaxMixSources = 4;
+
+        // Called on the audio thread when the VOX gate opens or closes; must not block
+        using GateListener = void (*)(void* context, bool open);
+
+        // Adds local-only audio (replays, tones) into the frame on the audio thread; returns
+        // true if it wrote anything. Must not block or allocate.
+        using MixSource = bool (*)(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        // Rebuilds the whole frame before any processing (the radio mixer); returns true if it
+        // wrote the frame. Same rules as a mix source.
+        using FrameSource = bool (*)(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        explicit AudioPipeline(const DspKernels& kernels = GetDspKernels());
+
+        AudioPipeline(const AudioPipeline&) = delete;
+        AudioPipeline& operator=(const AudioPipeline&) = delete;
+
+        // Set once before frames start flowing
+        void SetGateListener(GateListener listener, void* context)
+        {
+            m_gateListener = listener;
+            m_gateListenerContext = context;
+        }
+
+        // Set once before frames start flowing; false when every slot is taken
+        bool AddMixSource(MixSource source, void* context);
+
+        // Set once before frames start flowing
+        void SetFrameSource(FrameSource source, void* context)
+        {
+            m_frameSource = source;
+            m_frameSourceContext = context;
+        }
+
+        // Any thread
+        void SetConfig(const AudioPipelineConfig& config);
+        AudioPipelineConfig GetConfig() const { return m_config.Load(); }
+
+        // Audio thread. Interleaved samples; returns false if the frame was left untouched.
+        // The frame source and mix sources run even when processing is disabled.
+        bool Process(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        bool IsGateOpen() const { return m_gateOpenFlag.load(std::memory_order_relaxed); }
+        uint64_t GetProcessedFrames() const { return m_processedFrames.load(std::memory_order_relaxed); }
+        DspIsa GetIsa() const { return m_kernels.isa; }
+
+    private:
+        struct Biquad
+        {
+            float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        };
+
+        void Prepare(const AudioPipelineConfig& config, int channels, int sampleRate);
+        void HighPass(int16_t* samples, int framesPerChannel, int channels);
+        void Gate(int16_t* samples, int framesPerChannel);
+        void Limit(int16_t* samples, int framesPerChannel, int channels);
+        bool Mix(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        const DspKernels& m_kernels;
+        SnapshotCell<AudioPipelineConfig> m_config;
+
+        // Audio-thread state
+        AudioPipelineConfig m_active;
+        uint64_t m_preparedVersion = ~0ull;
+        int m_preparedChannels = 0;
+        int m_preparedSampleRate = 0;
+
+        Biquad m_highPass;
+        float m_x1[kMaxChannels] = {}, m_x2[kMaxChannels] = {};
+        float m_y1[kMaxChannels] = {}, m_y2[kMaxChannels] = {};
+
+        int32_t m_gainQ12 = 4096;
+
+        VoiceActivityDetector m_vad;
+        bool m_gateOpen = true;
+        GateListener m_gateListener = nullptr;
+        void* m_gateListenerContext = nullptr;
+
+        struct MixSlot
+        {
+            MixSource source = nullptr;
+            void* context = nullptr;
+        };
+        MixSlot m_mixSources[kMaxMixSources];
+        int m_mixSourceCount = 0;
+        FrameSource m_frameSource = nullptr;
+        void* m_frameSourceContext = nullptr;
+
+        int32_t m_limiterThreshold = 32767;
+        float m_limiterReleaseCoeff = 0.0f;
+        float m_limiterGain = 1.0f;
+
+        std::atomic<bool> m_gateOpenFlag{ true };
+        std::atomic<uint64_t> m_processedFrames{ 0 };
+    };
+}
@@ -0,0 +1,165 @@
+#include "AudioStatePlanner.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    const char* AudioStepName(AudioStep step)
+    {
+        switch (step) {
+            case AudioStep::Mute: return "mute";
+            case AudioStep::SetScenario: return "scenario";
+            case AudioStep::SetNoiseSuppression: return "noiseSuppression";
+            case AudioStep::LeaveRadio: return "leaveRadio";
+            case AudioStep::LeaveChannel: return "leaveChannel";
+            case AudioStep::JoinChannel: return "joinChannel";
+            case AudioStep::JoinRadio: return "joinRadio";
+            case AudioStep::SetTalkChannel: return "talkChannel";
+            case AudioStep::SetListenOnly: return "listenOnly";
+            case AudioStep::SetClientRole: return "clientRole";
+            case AudioStep::EnableLocalAudio: return "localAudio";
+            case AudioStep::RecordingVolume: return "recordingVolume";
+            case AudioStep::PlaybackVolume: return "playbackVolume";
+        }
+        return "unknown";
+    }
+
+    namespace
+    {
+        bool Contains(const std::vector<std::string>& channels, const std::string& channel)
+        {
+            return std::find(channels.begin(), channels.end(), channel) != channels.end();
+        }
+
+        // Appends the action and applies what the core's method does to its state
+        class PlanBuilder
+        {
+        public:
+            explicit PlanBuilder(const CurrentAudioState& current) : m_state(current) {}
+
+            const CurrentAudioState& State() const { return m_state; }
+
+            void Add(AudioStep step, const std::string& channel = {}, int value = 0)
+            {
+                switch (step) {
+                    case AudioStep::Mute: m_state.muted = value != 0; break;
+                    case AudioStep::SetScenario: m_state.scenario = value; break;
+                    case AudioStep::SetNoiseSuppression: m_state.noiseSuppressionMode = value; break;
+                    case AudioStep::LeaveRadio:
+                        m_state.radios.erase(std::remove(m_state.radios.begin(), m_state.radios.end(), channel), m_state.radios.end());
+                        if (m_state.talkChannel == channel) m_state.talkChannel.clear();
+                        break;
+                    case AudioStep::LeaveChannel:
+                        m_state.channel.clear();
+                        m_state.listenOnly = false;
+                        m_state.muted = false;
+                        break;
+                    case AudioStep::JoinChannel:
+                        // Talkers join unmuted, listeners muted (AgoraCore::JoinChannel)
+                        m_state.channel = channel;
+                        m_state.listenOnly = value != 0;
+                        m_state.muted = value != 0;
+                        break;
+                    case AudioStep::JoinRadio:
+                        m_state.radios.push_back(channel);
+                        if (value != 0) m_state.talkChannel = channel;
+                        break;
+                    case AudioStep::SetTalkChannel: m_state.talkChannel = channel; break;
+                    case AudioStep::SetListenOnly:
+                        m_state.listenOnly = value != 0;
+                        m_state.muted = true; // either way the switch ends keyed down
+                        break;
+                    case AudioStep::SetClientRole: m_state.clientRole = value; break;
+                    case AudioStep::EnableLocalAudio: m_state.localAudioEnabled = value != 0; break;
+                    case AudioStep::RecordingVolume: m_state.recordingVolume = value; break;
+                    case AudioStep::PlaybackVolume: m_state.playbackVolume = value; break;
+                }
+                m_plan.actions.push_back({ step, channel, value });
+            }
+
+            // One desired setting: an action if it differs, otherwise counted as unchanged
+            template <typename T>
+            void Reconcile(const std::optional<T>& desired, const T& current, AudioStep step)
+            {
+                if (!desired) return;
+                if (*desired == current) {
+                    ++m_plan.unchanged;
+                    return;
+                }
+                Add(step, {}, static_cast<int>(*desired));
+            }
+
+            void Unchanged() { ++m_plan.unchanged; }
+
+            AudioPlan Take() { return std::move(m_plan); }
+
+        private:
+            CurrentAudioState m_state;
+            AudioPlan m_plan;
+        };
+    }
+
+    AudioPlan PlanAudioState(const CurrentAudioState& current, const DesiredAudioState& desired)
+    {
+        PlanBuilder plan(current);
+
+        // Where the channels end up: the talk radio is always monitored
+        const std::string channel = desired.channel.value_or(current.channel);
+        const bool listenOnly = desired.listenOnly.value_or(current.listenOnly);
+        const std::string talk = desired.talkChannel.value_or(current.talkChannel);
+        std::vector<std::string> radios = desired.radios.value_or(current.radios);
+        if (!talk.empty() && !Contains(radios, talk)) radios.push_back(talk);
+
+        const bool channelChanges = channel != current.channel;
+        const bool talkChanges = talk != current.talkChannel;
+        const bool radiosChange = radios.size() != current.radios.size() ||
+            std::any_of(radios.begin(), radios.end(), [&current](const std::string& radio) { return !Contains(current.radios, radio); });
+
+        // Key down before anything moves, so the microphone never opens on a channel it is leaving
+        const bool muteFirst = desired.muted.value_or(false) && !current.muted && (channelChanges || radiosChange || talkChanges);
+        if (muteFirst) plan.Add(AudioStep::Mute, {}, 1);
+
+        // Engine-wide settings the joins below should already have
+        plan.Reconcile(desired.scenario, current.scenario, AudioStep::SetScenario);
+        plan.Reconcile(desired.noiseSuppressionMode, current.noiseSuppressionMode, AudioStep::SetNoiseSuppression);
+
+        // Leaves before joins: fewer connections at once, and the talk radio is unpublished first
+        for (const std::string& radio : current.radios) {
+            if (!Contains(radios, radio)) plan.Add(AudioStep::LeaveRadio, radio);
+        }
+        if (channelChanges && !current.channel.empty()) plan.Add(AudioStep::LeaveChannel);
+        if (channelChanges && !channel.empty()) plan.Add(AudioStep::JoinChannel, channel, listenOnly ? 1 : 0);
+        for (const std::string& radio : radios) {
+            if (!Contains(plan.State().radios, radio)) plan.Add(AudioStep::JoinRadio, radio, radio == talk ? 1 : 0);
+        }
+        if (plan.State().talkChannel != talk) plan.Add(AudioStep::SetTalkChannel, talk);
+
+        if (desired.channel && !channelChanges) plan.Unchanged();
+        if (desired.radios && !radiosChange) plan.Unchanged();
+        if (desired.talkChannel && !talkChanges) plan.Unchanged();
+
+        // Listen-only only means something in a channel, and a join above already took it
+        if (desired.listenOnly && !plan.State().channel.empty() && !channelChanges) {
+            if (current.listenOnly != listenOnly) {
+                plan.Add(AudioStep::SetListenOnly, {}, listenOnly ? 1 : 0);
+            } else {
+                plan.Unchanged();
+            }
+        }
+
+        plan.Reconcile(desired.clientRole, current.clientRole, AudioStep::SetClientRole);
+        plan.Reconcile(desired.localAudioEnabled, current.localAudioEnabled, AudioStep::EnableLocalAudio);
+        plan.Reconcile(desired.recordingVolume, current.recordingVolume, AudioStep::RecordingVolume);
+        plan.Reconcile(desired.playbackVolume, current.playbackVolume, AudioStep::PlaybackVolume);
+
+        // Mute last as well: joins and listen-only switches reset it, and an unmute waits for
+        // everything else to be in place
+        if (desired.muted) {
+            if (plan.State().muted != *desired.muted) {
+                plan.Add(AudioStep::Mute, {}, *desired.muted ? 1 : 0);
+            } else if (!muteFirst && current.muted == *desired.muted) {
+                plan.Unchanged();
+            }
+        }
+        return plan.Take();
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Desired-state audio configuration: the app says where it wants to be (channels, talk radio,
+// mute, volumes, role, noise suppression, scenario) and the planner works out the fewest core
+// operations that get there from where the core is, in an order that never opens the microphone
+// on the wrong channel. Pure logic like ConnectionMonitor; the core runs the plan on its worker.
+namespace winrt::FinalProject::implementation
+{
+    // Every field is optional: unset means "leave it as it is"
+    struct DesiredAudioState
+    {
+        std::optional<std::string> channel;             // default channel, "" = none
+        std::optional<bool> listenOnly;                 // default channel as audience until keyed
+        std::optional<std::vector<std::string>> radios; // exactly these radios monitored
+        std::optional<std::string> talkChannel;         // radio that publishes, "" = none
+        std::optional<bool> muted;
+        std::optional<bool> localAudioEnabled;
+        std::optional<int> recordingVolume;             // 0-400
+        std::optional<int> playbackVolume;              // 0-400
+        std::optional<int> clientRole;                  // CLIENT_ROLE_TYPE
+        std::optional<int> noiseSuppressionMode;        // -1 = off, else the AINS mode
+        std::optional<int> scenario;                    // AUDIO_SCENARIO_TYPE
+    };
+
+    // What the core has now; -1 = never set (volumes, role) or not applied yet (scenario, AINS)
+    struct CurrentAudioState
+    {
+        std::string channel;
+        bool listenOnly = false;
+        std::vector<std::string> radios;
+        std::string talkChannel;
+        bool muted = false;
+        bool localAudioEnabled = true;
+        int recordingVolume = -1;
+        int playbackVolume = -1;
+        int clientRole = -1;
+        int noiseSuppressionMode = -1;
+        int scenario = -1;
+    };
+
+    enum class AudioStep : uint8_t
+    {
+        Mute,                // value 1 = mute, 0 = unmute
+        SetScenario,
+        SetNoiseSuppression, // value -1 = off
+        LeaveRadio,
+        LeaveChannel,
+        JoinChannel,         // value 1 = listen only
+        JoinRadio,           // value 1 = talk
+        SetTalkChannel,
+        SetListenOnly,
+        SetClientRole,
+        EnableLocalAudio,
+        RecordingVolume,
+        PlaybackVolume,
+    };
+
+    const char* AudioStepName(AudioStep step);
+
+    struct AudioAction
+    {
+        AudioStep step = AudioStep::Mute;
+        std::string channel;
+        int value = 0;
+    };
+
+    struct AudioPlan
+    {
+        std::vector<AudioAction> actions;
+        int unchanged = 0; // fields asked for that already matched
+    };
+
+    // Order: a mute that is wanted goes first, then scenario and AINS (before any join), leaves,
+    // joins, talk radio, listen-only, role, local audio and volumes; an unmute goes last. Each
+    // step's side effects on the core (a join resets mute, a leave clears the talk radio) are
+    // simulated, so only what still differs afterwards becomes an action.
+    AudioPlan PlanAudioState(const CurrentAudioState& current, const DesiredAudioState& desired);
+}
@@ -0,0 +1,236 @@
+#include "CallSignaling.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    static constexpr const char* kVersion = "cs1";
+    static constexpr size_t kFieldCount = 8;
+
+    const char* CallSignalTypeName(CallSignalType type)
+    {
+        switch (type) {
+            case CallSignalType::Invite: return "invite";
+            case CallSignalType::Accept: return "accept";
+            case CallSignalType::Reject: return "reject";
+            case CallSignalType::Cancel: return "cancel";
+            case CallSignalType::End: return "end";
+            case CallSignalType::Ack: return "ack";
+        }
+        return "unknown";
+    }
+
+    bool ParseCallSignalType(const std::string& name, CallSignalType& type)
+    {
+        for (CallSignalType candidate : { CallSignalType::Invite, CallSignalType::Accept, CallSignalType::Reject,
+                                          CallSignalType::Cancel, CallSignalType::End, CallSignalType::Ack }) {
+            if (name == CallSignalTypeName(candidate)) {
+                type = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // '|' separates fields, so it and the escape character itself are sent as %7C and %25
+    void AppendSignalField(std::string& out, const std::string& field)
+    {
+        for (char c : field) {
+            if (c == '%') out += "%25";
+            else if (c == '|') out += "%7C";
+            else out += c;
+        }
+    }
+
+    bool UnescapeSignalField(const std::string& field, std::string& out)
+    {
+        out.clear();
+        for (size_t i = 0; i < field.size(); ++i) {
+            if (field[i] != '%') {
+                out += field[i];
+                continue;
+            }
+            if (field.compare(i, 3, "%25") == 0) out += '%';
+            else if (field.compare(i, 3, "%7C") == 0) out += '|';
+            else return false;
+            i += 2;
+        }
+        return true;
+    }
+
+    void SplitSignalFields(const char* data, size_t length, std::vector<std::string>& fields)
+    {
+        fields.clear();
+        size_t start = 0;
+        for (size_t i = 0; i <= length; ++i) {
+            if (i == length || data[i] == '|') {
+                fields.emplace_back(data + start, i - start);
+                start = i + 1;
+            }
+        }
+    }
+
+    static bool ParseSeq(const std::string& field, uint32_t& seq)
+    {
+        if (field.empty() || field.size() > 10) return false;
+        uint64_t value = 0;
+        for (char c : field) {
+            if (c < '0' || c > '9') return false;
+            value = value * 10 + static_cast<uint64_t>(c - '0');
+        }
+        if (value == 0 || value > 0xFFFFFFFFull) return false;
+        seq = static_cast<uint32_t>(value);
+        return true;
+    }
+
+    CallSignaling::CallSignaling(uint32_t seed)
+    {
+        // A restarted client must not reuse numbers the others still remember
+        std::mt19937 random(seed);
+        m_nextSeq = std::max<uint32_t>(1, random() & 0x7FFFFFFF);
+    }
+
+    void CallSignaling::SetLocalUser(const std::string& userId)
+    {
+        if (userId == m_localUser) return;
+        m_localUser = userId;
+        m_pending.clear();
+    }
+
+    uint32_t CallSignaling::Enqueue(CallSignal& signal, uint64_t nowMs)
+    {
+        if (m_localUser.empty() || signal.toUser.empty() || signal.type == CallSignalType::Ack) return 0;
+
+        signal.fromUser = m_localUser;
+        signal.seq = m_nextSeq;
+        std::string message = Encode(signal);
+        if (message.size() > kMaxMessageBytes) return 0;
+
+        m_nextSeq = m_nextSeq == 0xFFFFFFFFu ? 1 : m_nextSeq + 1;
+        Pending& pending = m_pending[signal.seq];
+        pending.signal = signal;
+        pending.message = std::move(message);
+        pending.firstSentMs = nowMs;
+        return signal.seq;
+    }
+
+    SignalSend CallSignaling::Poll(uint32_t seq, uint64_t nowMs)
+    {
+        (void)nowMs;
+        SignalSend step;
+        auto it = m_pending.find(seq);
+        if (it == m_pending.end()) return step; // acked, or the user signed out
+
+        Pending& pending = it->second;
+        if (pending.sends >= kMaxSends) {
+            step.expired = true;
+            step.signal = pending.signal;
+            m_pending.erase(it);
+            return step;
+        }
+
+        ++pending.sends;
+        step.send = true;
+        step.message = pending.message;
+        step.nextCheckMs = std::min(kMaxRetryMs, kFirstRetryMs << std::min(pending.sends - 1, 16));
+        return step;
+    }
+
+    std::vector<std::string> CallSignaling::PendingMessages() const
+    {
+        std::vector<std::pair<uint64_t, const std::string*>> ordered;
+        ordered.reserve(m_pending.size());
+        for (const auto& entry : m_pending) {
+            ordered.emplace_back(entry.second.firstSentMs, &entry.second.message);
+        }
+        std::stable_sort(ordered.begin(), ordered.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::vector<std::string> messages;
+        messages.reserve(ordered.size());
+        for (const auto& entry : ordered) messages.push_back(*entry.second);
+        return messages;
+    }
+
+    void CallSignaling::Clear()
+    {
+        m_pending.clear();
+    }
+
+    SignalReceive CallSignaling::OnMessage(const char* data, size_t length, uint64_t nowMs)
+    {
+        SignalReceive result;
+        CallSignal signal;
+        if (m_localUser.empty() || !Decode(data, length, signal) || signal.toUser != m_localUser) return result;
+
+        if (signal.type == CallSignalType::Ack) {
+            auto it = m_pending.find(signal.seq);
+            if (it == m_pending.end() || it->second.signal.toUser != signal.fromUser) return result;
+            result.acked = true;
+            result.ackedSignal = it->second.signal;
+            result.ackedAfterMs = nowMs - std::min(nowMs, it->second.firstSentMs);
+            m_pending.erase(it);
+            return result;
+        }
+
+        CallSignal ack;
+        ack.type = CallSignalType::Ack;
+        ack.seq = signal.seq;
+        ack.fromUser = m_localUser;
+        ack.toUser = signal.fromUser;
+        result.ack = Encode(ack);
+
+        result.deliver = Remember(signal.fromUser, signal.seq);
+        result.signal = std::move(signal);
+        return result;
+    }
+
+    bool CallSignaling::Remember(const std::string& fromUser, uint32_t seq)
+    {
+        auto key = std::make_pair(fromUser, seq);
+        if (!m_seen.insert(key).second) return false;
+
+        m_seenOrder.push_back(std::move(key));
+        if (m_seenOrder.size() > kRecentMessages) {
+            m_seen.erase(m_seenOrder.front());
+            m_seenOrder.pop_front();
+        }
+        return true;
+    }
+
+    std::string CallSignaling::Encode(const CallSignal& signal)
+    {
+        std::string message = kVersion;
+        message += '|';
+        message += CallSignalTypeName(signal.type);
+        message += '|';
+        message += std::to_string(signal.seq);
+        for (const std::string* field : { &signal.fromUser, &signal.toUser, &signal.invitationId,
+                                          &signal.channelName, &signal.callerName }) {
+            message += '|';
+            AppendSignalField(message, *field);
+        }
+        return message;
+    }
+
+    bool CallSignaling::Decode(const char* data, size_t length, CallSignal& signal)
+    {
+        if (!data || length == 0 || length > kMaxMessageBytes) return false;
+
+        std::vector<std::string> fields;
+        fields.reserve(kFieldCount);
+        SplitSignalFields(data, length, fields);
+        if (fields.size() != kFieldCount || fields[0] != kVersion) return false;
+
+        CallSignal decoded;
+        if (!ParseCallSignalType(fields[1], decoded.type) || !ParseSeq(fields[2], decoded.seq)) return false;
+        if (!UnescapeSignalField(fields[3], decoded.fromUser) || !UnescapeSignalField(fields[4], decoded.toUser) ||
+            !UnescapeSignalField(fields[5], decoded.invitationId) || !UnescapeSignalField(fields[6], decoded.channelName) ||
+            !UnescapeSignalField(fields[7], decoded.callerName)) {
+            return false;
+        }
+        if (decoded.fromUser.empty() || decoded.toUser.empty()) return false;
+
+        signal = std::move(decoded);
+        return true;
+    }
+}
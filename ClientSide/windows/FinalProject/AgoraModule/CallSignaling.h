@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Private-call invitations pushed over an SDK data stream on a lobby connection that every
+// signed-in client keeps open, instead of each client polling the server every few seconds.
+// The server stays the record of every invitation; these messages only tell the other side
+// that something changed. Lobby members see every message, so each one carries the app user
+// it is for, and the addressee acks it. Unacked messages go out again with backoff until
+// they expire, which also covers the lobby being down or reconnecting. Pure logic with no
+// engine calls; the core owns it on the command worker and does the sending.
+namespace winrt::FinalProject::implementation
+{
+    enum class CallSignalType : uint8_t
+    {
+        Invite = 1,
+        Accept,
+        Reject,
+        Cancel,   // the caller gave up before an answer
+        End,      // either side hung up
+        Ack,      // transport only, never reported to the app
+    };
+
+    const char* CallSignalTypeName(CallSignalType type);
+    bool ParseCallSignalType(const std::string& name, CallSignalType& type);
+
+    // Lobby message fields, shared with FloorControl: '|' separated, '%' and '|' %-escaped
+    void AppendSignalField(std::string& out, const std::string& field);
+    bool UnescapeSignalField(const std::string& field, std::string& out);
+    void SplitSignalFields(const char* data, size_t length, std::vector<std::string>& fields); // still escaped
+
+    struct CallSignal
+    {
+        CallSignalType type = CallSignalType::Invite;
+        uint32_t seq = 0;          // per-sender message number; an ack carries the one it acknowledges
+        std::string fromUser;      // app user ids, not Agora uids
+        std::string toUser;
+        std::string invitationId;  // the server's invitation, also the call's channel
+        std::string channelName;
+        std::string callerName;    // shown on the incoming call screen before the server is asked
+    };
+
+    // What the core does with one sent signal once its retry timer fires
+    struct SignalSend
+    {
+        bool send = false;         // put message on the stream again
+        std::string message;
+        int nextCheckMs = 0;       // when to fire again
+        bool expired = false;      // no ack after kMaxSends: report it undelivered
+        CallSignal signal;         // set when expired
+    };
+
+    // What one received message means
+    struct SignalReceive
+    {
+        bool deliver = false;      // new signal for us: hand it to the app
+        CallSignal signal;
+        std::string ack;           // encoded ack to send back (also for duplicates, the first ack may be lost)
+        bool acked = false;        // an ack for one of ours: delivered
+        CallSignal ackedSignal;
+        uint64_t ackedAfterMs = 0; // first send to ack
+    };
+
+    class CallSignaling
+    {
+    public:
+        static constexpr size_t kMaxMessageBytes = 1024; // one data stream packet
+        static constexpr int kFirstRetryMs = 200;        // doubles per send
+        static constexpr int kMaxRetryMs = 1600;
+        static constexpr int kMaxSends = 8;              // ~8 s of retries, well inside the ring time
+        static constexpr size_t kRecentMessages = 256;   // remembered for duplicate detection
+
+        explicit CallSignaling(uint32_t seed = std::random_device{}());
+
+        // Signals for other users are ignored; "" stops everything
+        void SetLocalUser(const std::string& userId);
+        const std::string& GetLocalUser() const { return m_localUser; }
+
+        // Fills seq and fromUser and keeps the signal until it is acked or expires.
+        // 0 when there is no local user or the encoded message would not fit one packet.
+        uint32_t Enqueue(CallSignal& signal, uint64_t nowMs);
+        // Retry timer for seq: counts a send and says when to look again
+        SignalSend Poll(uint32_t seq, uint64_t nowMs);
+        // Everything not yet acked, oldest first: sent again at once when the stream comes back
+        std::vector<std::string> PendingMessages() const;
+        size_t GetPendingCount() const { return m_pending.size(); }
+        void Clear();
+
+        SignalReceive OnMessage(const char* data, size_t length, uint64_t nowMs);
+
+        // cs1|type|seq|from|to|invitation|channel|caller, fields %-escaped
+        static std::string Encode(const CallSignal& signal);
+        static bool Decode(const char* data, size_t length, CallSignal& signal);
+
+    private:
+        struct Pending
+        {
+            CallSignal signal;
+            std::string message;
+            int sends = 0;
+            uint64_t firstSentMs = 0;
+        };
+
+        bool Remember(const std::string& fromUser, uint32_t seq);
+
+        std::string m_localUser;
+        uint32_t m_nextSeq;
+        std::map<uint32_t, Pending> m_pending;
+        std::set<std::pair<std::string, uint32_t>> m_seen;
+        std::deque<std::pair<std::string, uint32_t>> m_seenOrder;
+    };
+}
@@ -0,0 +1,203 @@
+#include "CommandQueue.h"
+#include <vector>
+
+namespace winrt::FinalProject::implementation
+{
+    CommandQueue::CommandQueue()
+        : m_head(&m_stub), m_tail(&m_stub)
+    {
+    }
+
+    CommandQueue::~CommandQueue()
+    {
+        Stop();
+    }
+
+    void CommandQueue::Start()
+    {
+        if (m_running.exchange(true)) return;
+        m_worker = std::thread([this]() { WorkerLoop(); });
+    }
+
+    void CommandQueue::Stop()
+    {
+        if (!m_running.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_idle.store(false);
+        }
+        m_wake.notify_one();
+        if (m_worker.joinable()) {
+            if (IsWorkerThread()) {
+                m_worker.detach();
+            } else {
+                m_worker.join();
+            }
+        }
+        m_workerId.store(std::thread::id());
+    }
+
+    void CommandQueue::Post(Command command)
+    {
+        Node* node = new Node();
+        node->command = std::move(command);
+        Push(node);
+
+        // Only touch the mutex when the worker actually went to sleep
+        if (m_idle.exchange(false)) {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_wake.notify_one();
+        }
+    }
+
+    void CommandQueue::PostAfter(int delayMs, Command command)
+    {
+        auto due = std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs > 0 ? delayMs : 0);
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_timers.emplace(due, std::move(command));
+            m_timerCount.store(m_timers.size());
+            // Even a sleeping worker with an earlier deadline has to look at the new one
+            m_idle.store(false);
+        }
+        m_wake.notify_one();
+    }
+
+    void CommandQueue::PromoteDueTimers()
+    {
+        // Keeps the drain loop lock-free while no timer is armed
+        if (m_timerCount.load() == 0) return;
+
+        std::vector<Command> due;
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            auto now = std::chrono::steady_clock::now();
+            while (!m_timers.empty() && m_timers.begin()->first <= now) {
+                due.push_back(std::move(m_timers.begin()->second));
+                m_timers.erase(m_timers.begin());
+            }
+            m_timerCount.store(m_timers.size());
+        }
+        // Due timers join the queue like any post, in deadline order
+        for (auto& command : due) {
+            Node* node = new Node();
+            node->command = std::move(command);
+            Push(node);
+        }
+    }
+
+    void CommandQueue::Push(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    CommandQueue::Node* CommandQueue::Pop()
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (next == nullptr) return nullptr;
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+
+        // A producer swapped m_head but has not linked its node yet - try again later
+        if (tail != m_head.load(std::memory_order_acquire)) return nullptr;
+
+        Push(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr) {
+            m_tail = next;
+            return tail;
+        }
+        return nullptr;
+    }
+
+    bool CommandQueue::IsEmpty() const
+    {
+        return m_tail == &m_stub && m_stub.next.load(std::memory_order_acquire) == nullptr;
+    }
+
+    void CommandQueue::WorkerLoop()
+    {
+        // Before the first command, so IsWorkerThread() holds inside every one of them
+        m_workerId.store(std::this_thread::get_id());
+        while (m_running.load()) {
+            PromoteDueTimers();
+            if (DrainBatch()) continue;
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_idle.store(true);
+            if (!IsEmpty() || !m_running.load()) {
+                m_idle.store(false);
+                continue;
+            }
+            auto awake = [this]() { return !m_idle.load() || !m_running.load(); };
+            if (m_timers.empty()) {
+                m_wake.wait(lock, awake);
+            } else {
+                m_wake.wait_until(lock, m_timers.begin()->first, awake);
+                m_idle.store(false);
+            }
+        }
+
+        // Let pending promises resolve before the worker goes away; timers are not waited for
+        while (DrainBatch()) {
+        }
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_timers.clear();
+        m_timerCount.store(0);
+    }
+
+    bool CommandQueue::DrainBatch()
+    {
+        std::vector<Node*> batch;
+        while (Node* node = Pop()) {
+            batch.push_back(node);
+        }
+        if (batch.empty()) return false;
+
+        // superseded[i] = index of the next command when it has the same key and replaces command i.
+        // Only neighbours merge: anything in between, keyed or not, keeps both and their order
+        // (SetTalkChannel, unmute, SetTalkChannel must not unmute before the first switch).
+        std::vector<size_t> superseded(batch.size(), SIZE_MAX);
+        for (size_t i = 1; i < batch.size(); ++i) {
+            const std::string& key = batch[i]->command.coalesceKey;
+            if (!key.empty() && key == batch[i - 1]->command.coalesceKey) superseded[i - 1] = i;
+        }
+
+        std::vector<std::vector<std::function<void()>>> deferred(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            Command& command = batch[i]->command;
+
+            if (superseded[i] != SIZE_MAX) {
+                auto& target = deferred[superseded[i]];
+                if (command.complete) target.push_back(std::move(command.complete));
+                for (auto& complete : deferred[i]) target.push_back(std::move(complete));
+                m_coalesced.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                try {
+                    if (command.run) command.run();
+                } catch (...) {
+                    // AgoraManager reports its own failures; the worker must survive
+                }
+                m_executed.fetch_add(1, std::memory_order_relaxed);
+
+                if (command.complete) command.complete();
+                for (auto& complete : deferred[i]) complete();
+            }
+
+            delete batch[i];
+        }
+        return true;
+    }
+}
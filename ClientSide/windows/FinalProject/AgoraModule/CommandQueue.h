@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Serializes AgoraManager calls onto one native worker thread so REACT_METHODs
+// return immediately. Producers (JS thread, UI thread, SDK callbacks) never take
+// a lock: commands go through an intrusive lock-free MPSC queue (Vyukov style).
+namespace winrt::FinalProject::implementation
+{
+    struct Command
+    {
+        // Commands with the same non-empty key replace each other when they are
+        // queued back to back, with nothing in between (volume drags, mute followed
+        // by unmute, ...). Any other command, keyed or not, keeps both. An empty key
+        // marks a barrier (join, leave, init) that is never coalesced.
+        std::string coalesceKey;
+        std::function<void()> run;
+        // Called after run(), or after the command that superseded this one ran
+        std::function<void()> complete;
+    };
+
+    class CommandQueue
+    {
+    public:
+        CommandQueue();
+        ~CommandQueue();
+
+        CommandQueue(const CommandQueue&) = delete;
+        CommandQueue& operator=(const CommandQueue&) = delete;
+
+        void Start();
+        // Runs whatever is still queued, then joins the worker
+        void Stop();
+
+        void Post(Command command);
+        // Queues the command once delayMs has passed (retries, backoff). Timers take the wake
+        // mutex, so keep them off hot paths; any still pending at Stop() are dropped unrun.
+        void PostAfter(int delayMs, Command command);
+
+        bool IsWorkerThread() const { return std::this_thread::get_id() == m_workerId.load(); }
+
+        uint64_t GetExecutedCount() const { return m_executed.load(std::memory_order_relaxed); }
+        uint64_t GetCoalescedCount() const { return m_coalesced.load(std::memory_order_relaxed); }
+
+    private:
+        struct Node
+        {
+            std::atomic<Node*> next{ nullptr };
+            Command command;
+        };
+
+        void Push(Node* node);
+        Node* Pop();
+        bool IsEmpty() const;
+        void WorkerLoop();
+        // Moves timers whose deadline passed into the queue
+        void PromoteDueTimers();
+        // Pops everything currently queued and runs it with coalescing applied
+        bool DrainBatch();
+
+        // Producers exchange m_head, the consumer owns m_tail
+        std::atomic<Node*> m_head;
+        Node* m_tail;
+        Node m_stub;
+
+        std::atomic<bool> m_running{ false };
+        std::atomic<bool> m_idle{ false };
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wake;
+        std::multimap<std::chrono::steady_clock::time_point, Command> m_timers; // guarded by m_wakeMutex
+        std::atomic<size_t> m_timerCount{ 0 };
+        std::thread m_worker;
+        std::atomic<std::thread::id> m_workerId{};
+
+        std::atomic<uint64_t> m_executed{ 0 };
+        std::atomic<uint64_t> m_coalesced{ 0 };
+    };
+}
@@ -0,0 +1,207 @@
+#include "ConnectionMonitor.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    const char* ConnectionStateName(ConnectionState state)
+    {
+        switch (state) {
+            case ConnectionState::Disconnected: return "disconnected";
+            case ConnectionState::Connecting: return "connecting";
+            case ConnectionState::Connected: return "connected";
+            case ConnectionState::Reconnecting: return "reconnecting";
+            case ConnectionState::Failed: return "failed";
+        }
+        return "unknown";
+    }
+
+    ConnectionMonitor::ConnectionMonitor(uint32_t seed) : m_random(seed)
+    {
+    }
+
+    bool ConnectionMonitor::IsFatalReason(int reason)
+    {
+        switch (reason) {
+            case 3:  // BANNED_BY_SERVER
+            case 6:  // INVALID_APP_ID
+            case 7:  // INVALID_CHANNEL_NAME
+            case 8:  // INVALID_TOKEN
+            case 9:  // TOKEN_EXPIRED
+            case 10: // REJECTED_BY_SERVER
+            case 19: // SAME_UID_LOGIN - a retry would only kick the other session out
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void ConnectionMonitor::Track(const std::string& key, ConnectionState state)
+    {
+        Link link;
+        link.state = state;
+        link.generation = m_nextGeneration++;
+        m_links[key] = link;
+        if (m_observer) m_observer(key, state, true);
+    }
+
+    void ConnectionMonitor::Forget(const std::string& key)
+    {
+        if (m_links.erase(key) != 0 && m_observer) m_observer(key, ConnectionState::Disconnected, false);
+    }
+
+    void ConnectionMonitor::Clear()
+    {
+        std::map<std::string, Link> links;
+        links.swap(m_links);
+        if (!m_observer) return;
+        for (const auto& entry : links) m_observer(entry.first, ConnectionState::Disconnected, false);
+    }
+
+    ConnectionTransition ConnectionMonitor::OnStateChanged(const std::string& key, int state, int reason, uint64_t nowMs)
+    {
+        auto it = m_links.find(key);
+        // Our own leaves (deliberate, or the first half of a retry) are not outages
+        if (it == m_links.end() || reason == kReasonLeaveChannel) return {};
+        Link& link = it->second;
+
+        switch (static_cast<ConnectionState>(state)) {
+            case ConnectionState::Connected: {
+                bool restore = link.down;
+                uint64_t outageMs = restore ? nowMs - std::min(nowMs, link.downSinceMs) : 0;
+                int attempts = link.attempts;
+                bool changed = link.state != ConnectionState::Connected;
+
+                link.down = false;
+                link.downSinceMs = 0;
+                link.attempts = 0;
+                link.retryPending = false;
+                link.generation = m_nextGeneration++; // whatever retry is still queued is moot now
+
+                ConnectionTransition transition = Report(key, link, ConnectionState::Connected, reason, changed);
+                transition.attempt = attempts;
+                transition.restore = restore;
+                transition.outageMs = outageMs;
+                return transition;
+            }
+            case ConnectionState::Connecting: {
+                // A retry's join is still the same outage as far as the app is concerned
+                ConnectionState reported = link.down ? ConnectionState::Reconnecting : ConnectionState::Connecting;
+                return Report(key, link, reported, reason, link.state != reported);
+            }
+            case ConnectionState::Reconnecting:
+                MarkDown(link, nowMs);
+                return Report(key, link, ConnectionState::Reconnecting, reason, link.state != ConnectionState::Reconnecting);
+            case ConnectionState::Failed:
+                if (IsFatalReason(reason)) {
+                    link.retryPending = false;
+                    link.generation = m_nextGeneration++;
+                    return Report(key, link, ConnectionState::Failed, reason, link.state != ConnectionState::Failed);
+                }
+                return ScheduleRetry(key, link, reason, nowMs);
+            case ConnectionState::Disconnected:
+                // Not a leave of ours: the SDK dropped the connection and will not bring it back
+                return ScheduleRetry(key, link, reason, nowMs);
+        }
+        return {};
+    }
+
+    ConnectionTransition ConnectionMonitor::OnConnectionLost(const std::string& key, uint64_t nowMs)
+    {
+        auto it = m_links.find(key);
+        if (it == m_links.end()) return {};
+
+        // The SDK has been retrying in place for 10 s; a fresh join picks a new edge server
+        return ScheduleRetry(key, it->second, kReasonLost, nowMs);
+    }
+
+    ConnectionTransition ConnectionMonitor::OnRejoined(const std::string& key, uint64_t nowMs)
+    {
+        return OnStateChanged(key, static_cast<int>(ConnectionState::Connected), kReasonRejoinSuccess, nowMs);
+    }
+
+    bool ConnectionMonitor::BeginRetry(const std::string& key, uint64_t generation)
+    {
+        auto it = m_links.find(key);
+        if (it == m_links.end()) return false;
+        Link& link = it->second;
+        if (!link.retryPending || link.generation != generation) return false;
+        link.retryPending = false;
+        return true;
+    }
+
+    ConnectionTransition ConnectionMonitor::OnRetryFailed(const std::string& key, uint64_t nowMs)
+    {
+        auto it = m_links.find(key);
+        if (it == m_links.end()) return {};
+        return ScheduleRetry(key, it->second, it->second.reason, nowMs);
+    }
+
+    ConnectionState ConnectionMonitor::GetState(const std::string& key) const
+    {
+        auto it = m_links.find(key);
+        return it != m_links.end() ? it->second.state : ConnectionState::Disconnected;
+    }
+
+    int ConnectionMonitor::GetAttempts(const std::string& key) const
+    {
+        auto it = m_links.find(key);
+        return it != m_links.end() ? it->second.attempts : 0;
+    }
+
+    int ConnectionMonitor::RetryDelayMs(int attempt)
+    {
+        double delay = std::max(0, m_policy.baseDelayMs);
+        double maxDelay = std::max(m_policy.baseDelayMs, m_policy.maxDelayMs);
+        for (int i = 1; i < attempt && delay < maxDelay; ++i) delay *= 2.0;
+        delay = std::min(delay, maxDelay);
+
+        // Equal jitter: never below (1 - jitter) of the backoff, so retries still spread out
+        double jitter = std::max(0.0, std::min(1.0, m_policy.jitter));
+        double random = std::uniform_real_distribution<double>(0.0, 1.0)(m_random);
+        return static_cast<int>(delay * (1.0 - jitter) + delay * jitter * random);
+    }
+
+    ConnectionTransition ConnectionMonitor::Report(const std::string& key, Link& link, ConnectionState state, int reason, bool changed)
+    {
+        bool moved = link.state != state;
+        link.state = state;
+        link.reason = reason;
+
+        ConnectionTransition transition;
+        transition.state = state;
+        transition.reason = reason;
+        transition.attempt = link.attempts;
+        transition.notify = changed;
+        transition.generation = link.generation;
+        if (moved && m_observer) m_observer(key, state, true);
+        return transition;
+    }
+
+    ConnectionTransition ConnectionMonitor::ScheduleRetry(const std::string& key, Link& link, int reason, uint64_t nowMs)
+    {
+        MarkDown(link, nowMs);
+        // One retry in flight per connection; FAILED, DISCONNECTED and lost often come together
+        if (link.retryPending) return {};
+
+        if (m_policy.maxAttempts > 0 && link.attempts >= m_policy.maxAttempts) {
+            link.generation = m_nextGeneration++;
+            return Report(key, link, ConnectionState::Failed, reason, link.state != ConnectionState::Failed);
+        }
+
+        ++link.attempts;
+        link.retryPending = true;
+        link.generation = m_nextGeneration++;
+
+        ConnectionTransition transition = Report(key, link, ConnectionState::Reconnecting, reason, true);
+        transition.retry = true;
+        transition.retryDelayMs = RetryDelayMs(link.attempts);
+        return transition;
+    }
+
+    void ConnectionMonitor::MarkDown(Link& link, uint64_t nowMs)
+    {
+        if (link.down) return;
+        link.down = true;
+        link.downSinceMs = nowMs;
+    }
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+
+// Per-connection link state built from the SDK's connection callbacks, and the recovery
+// decisions that go with it. The SDK repairs short interruptions itself (RECONNECTING, then
+// onRejoinChannelSuccess); it gives up on FAILED, on an unexpected DISCONNECTED and after
+// onConnectionLost, and then only a fresh leave + join brings the channel back. The monitor
+// says when to restore session state and when to retry, with jittered exponential backoff.
+// Pure logic, no engine calls: the core owns it on the command worker.
+namespace winrt::FinalProject::implementation
+{
+    // CONNECTION_STATE_TYPE values
+    enum class ConnectionState : uint8_t
+    {
+        Disconnected = 1,
+        Connecting = 2,
+        Connected = 3,
+        Reconnecting = 4,
+        Failed = 5,
+    };
+
+    const char* ConnectionStateName(ConnectionState state);
+
+    struct ReconnectPolicy
+    {
+        int baseDelayMs = 500;    // first retry; doubles per attempt
+        int maxDelayMs = 30000;
+        double jitter = 0.5;      // the last this fraction of each delay is random, so clients don't retry in step
+        int maxAttempts = 0;      // 0 = keep trying until the channel is left
+    };
+
+    // What one callback means for the connection
+    struct ConnectionTransition
+    {
+        ConnectionState state = ConnectionState::Disconnected;
+        int reason = 0;           // CONNECTION_CHANGED_REASON_TYPE
+        int attempt = 0;          // retries so far in this outage
+        bool notify = false;      // state (or retry) changed: tell the app
+        bool restore = false;     // back after an outage: reapply mute, volume, role and EQ
+        bool retry = false;       // leave + join again after retryDelayMs
+        int retryDelayMs = 0;
+        uint64_t generation = 0;  // hand back to BeginRetry; a newer event makes it stale
+        uint64_t outageMs = 0;    // on restore: how long the link was down
+    };
+
+    class ConnectionMonitor
+    {
+    public:
+        // CONNECTION_CHANGED_REASON_TYPE values the monitor acts on
+        static constexpr int kReasonInterrupted = 2;
+        static constexpr int kReasonJoinFailed = 4;
+        static constexpr int kReasonLeaveChannel = 5;
+        static constexpr int kReasonRejoinSuccess = 15;
+        static constexpr int kReasonLost = 16;
+
+        // Every change of a tracked connection's state, and tracked = false once it is forgotten
+        using Observer = std::function<void(const std::string& key, ConnectionState state, bool tracked)>;
+
+        explicit ConnectionMonitor(uint32_t seed = std::random_device{}());
+
+        void SetObserver(Observer observer) { m_observer = std::move(observer); }
+
+        void SetPolicy(const ReconnectPolicy& policy) { m_policy = policy; }
+        const ReconnectPolicy& GetPolicy() const { return m_policy; }
+
+        // Banned, bad app id / channel / token, rejected: retrying cannot help
+        static bool IsFatalReason(int reason);
+
+        // A join was issued for key (the core's connection key); callbacks for untracked keys are ignored
+        void Track(const std::string& key, ConnectionState state = ConnectionState::Connecting);
+        // Deliberate leave: stops recovery, pending retries go stale
+        void Forget(const std::string& key);
+        void Clear();
+        bool IsTracked(const std::string& key) const { return m_links.count(key) != 0; }
+
+        ConnectionTransition OnStateChanged(const std::string& key, int state, int reason, uint64_t nowMs);
+        ConnectionTransition OnConnectionLost(const std::string& key, uint64_t nowMs);
+        ConnectionTransition OnRejoined(const std::string& key, uint64_t nowMs);
+
+        // The retry timer fired: true when it is still wanted (same outage, channel still tracked)
+        bool BeginRetry(const std::string& key, uint64_t generation);
+        // The retry's join call was refused outright: schedule the next one
+        ConnectionTransition OnRetryFailed(const std::string& key, uint64_t nowMs);
+
+        ConnectionState GetState(const std::string& key) const;
+        int GetAttempts(const std::string& key) const;
+
+        // Backoff before retry number attempt (1-based), jitter applied
+        int RetryDelayMs(int attempt);
+
+    private:
+        struct Link
+        {
+            ConnectionState state = ConnectionState::Connecting;
+            int reason = 0;
+            int attempts = 0;
+            uint64_t downSinceMs = 0;  // 0 = link up (or never came up)
+            bool down = false;
+            bool retryPending = false;
+            uint64_t generation = 0;
+        };
+
+        ConnectionTransition Report(const std::string& key, Link& link, ConnectionState state, int reason, bool changed);
+        ConnectionTransition ScheduleRetry(const std::string& key, Link& link, int reason, uint64_t nowMs);
+        void MarkDown(Link& link, uint64_t nowMs);
+
+        ReconnectPolicy m_policy;
+        std::mt19937 m_random;
+        uint64_t m_nextGeneration = 1;
+        std::map<std::string, Link> m_links;
+        Observer m_observer;
+    };
+}
@@ -0,0 +1,102 @@
+#include "DeviceRegistry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace winrt::FinalProject::implementation
+{
+    const char* AudioDeviceKindName(AudioDeviceKind kind)
+    {
+        return kind == AudioDeviceKind::Playback ? "playback" : "recording";
+    }
+
+    bool ParseAudioDeviceKind(const char* name, AudioDeviceKind& kind)
+    {
+        if (!name) return false;
+        if (std::strcmp(name, "recording") == 0) {
+            kind = AudioDeviceKind::Recording;
+            return true;
+        }
+        if (std::strcmp(name, "playback") == 0) {
+            kind = AudioDeviceKind::Playback;
+            return true;
+        }
+        return false;
+    }
+
+    // Case-insensitive: device names differ in case between drivers and Windows versions
+    static bool NameContains(const std::string& name, const std::string& fragment)
+    {
+        auto it = std::search(name.begin(), name.end(), fragment.begin(), fragment.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        });
+        return it != name.end();
+    }
+
+    void DeviceRegistry::SetDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo> devices)
+    {
+        KindSlot& slot = Slot(kind);
+        slot.devices = std::move(devices);
+        slot.enumerated = true;
+        if (!Contains(kind, slot.activeId)) slot.activeId.clear();
+    }
+
+    bool DeviceRegistry::Contains(AudioDeviceKind kind, const std::string& deviceId) const
+    {
+        if (deviceId.empty()) return false;
+        const auto& devices = Slot(kind).devices;
+        return std::any_of(devices.begin(), devices.end(), [&deviceId](const AudioDeviceInfo& device) { return device.id == deviceId; });
+    }
+
+    bool DeviceRegistry::Remove(AudioDeviceKind kind, const std::string& deviceId)
+    {
+        KindSlot& slot = Slot(kind);
+        auto it = std::find_if(slot.devices.begin(), slot.devices.end(),
+                               [&deviceId](const AudioDeviceInfo& device) { return device.id == deviceId; });
+        if (it == slot.devices.end()) return false;
+        slot.devices.erase(it);
+        if (slot.activeId == deviceId) slot.activeId.clear();
+        return true;
+    }
+
+    void DeviceRegistry::SetPreferences(AudioDeviceKind kind, std::vector<std::string> preferred)
+    {
+        preferred.erase(std::remove(preferred.begin(), preferred.end(), std::string()), preferred.end());
+        if (preferred.size() > kMaxPreferences) preferred.resize(kMaxPreferences);
+        Slot(kind).preferred = std::move(preferred);
+    }
+
+    std::string DeviceRegistry::Choose(AudioDeviceKind kind) const
+    {
+        const KindSlot& slot = Slot(kind);
+        // Exact ids first within each preference, so "Headset" can't steal a device named by id
+        for (const auto& preference : slot.preferred) {
+            if (Contains(kind, preference)) return preference;
+            for (const auto& device : slot.devices) {
+                if (NameContains(device.name, preference)) return device.id;
+            }
+        }
+        return {};
+    }
+
+    AudioDeviceList DeviceRegistry::GetList(AudioDeviceKind kind) const
+    {
+        const KindSlot& slot = Slot(kind);
+        AudioDeviceList list;
+        list.kind = kind;
+        list.devices = slot.devices;
+        list.activeId = slot.activeId;
+        list.preferred = slot.preferred;
+        return list;
+    }
+
+    void DeviceRegistry::Clear()
+    {
+        for (KindSlot* slot : { &m_recording, &m_playback }) {
+            slot->devices.clear();
+            slot->activeId.clear();
+            slot->enumerated = false;
+        }
+    }
+}
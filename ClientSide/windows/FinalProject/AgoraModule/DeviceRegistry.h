@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "VoiceEngine.h"
+
+// Recording and playback devices as the engine last reported them, so the app never has to
+// walk the OS device list (slow, and it used to mean re-initializing the engine) to see what
+// is plugged in. Enumerated once per engine, then kept current from onAudioDeviceStateChanged:
+// a removal only drops the entry, an arrival re-enumerates that one kind.
+// The policy is an ordered preference list per kind; each entry matches a device id exactly
+// or a name fragment ("Jabra"), and the first one present wins. With none present the engine
+// stays on whatever it uses, normally the system default. The registry only holds the lists and
+// picks the device; the core enumerates, switches devices and forwards the SDK callbacks to it.
+namespace winrt::FinalProject::implementation
+{
+    const char* AudioDeviceKindName(AudioDeviceKind kind);
+    bool ParseAudioDeviceKind(const char* name, AudioDeviceKind& kind); // "recording" / "playback"
+
+    // One kind as the app sees it
+    struct AudioDeviceList
+    {
+        AudioDeviceKind kind = AudioDeviceKind::Recording;
+        std::vector<AudioDeviceInfo> devices;
+        std::string activeId;                // "" until known
+        std::vector<std::string> preferred;  // the policy, most wanted first
+    };
+
+    class DeviceRegistry
+    {
+    public:
+        // MEDIA_DEVICE_STATE_TYPE values
+        static constexpr int kStateActive = 1;
+        static constexpr int kStateDisabled = 2;
+        static constexpr int kStateNotPresent = 4;
+        static constexpr int kStateUnplugged = 8;
+        static constexpr size_t kMaxPreferences = 8;
+
+        // A full enumeration replaces the cache for that kind
+        void SetDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo> devices);
+        bool IsEnumerated(AudioDeviceKind kind) const { return Slot(kind).enumerated; }
+        bool Contains(AudioDeviceKind kind, const std::string& deviceId) const;
+        // Returns true if the device was cached; the active id is cleared with it
+        bool Remove(AudioDeviceKind kind, const std::string& deviceId);
+
+        void SetActive(AudioDeviceKind kind, const std::string& deviceId) { Slot(kind).activeId = deviceId; }
+        const std::string& GetActive(AudioDeviceKind kind) const { return Slot(kind).activeId; }
+
+        // Kept across engines, unlike the devices
+        void SetPreferences(AudioDeviceKind kind, std::vector<std::string> preferred);
+
+        // The present device the policy wants, "" when no preference matches one
+        std::string Choose(AudioDeviceKind kind) const;
+
+        AudioDeviceList GetList(AudioDeviceKind kind) const;
+
+        // Engine released: devices and active ids go, preferences stay
+        void Clear();
+
+    private:
+        struct KindSlot
+        {
+            std::vector<AudioDeviceInfo> devices;
+            std::string activeId;
+            std::vector<std::string> preferred;
+            bool enumerated = false;
+        };
+
+        KindSlot& Slot(AudioDeviceKind kind) { return kind == AudioDeviceKind::Playback ? m_playback : m_recording; }
+        const KindSlot& Slot(AudioDeviceKind kind) const { return kind == AudioDeviceKind::Playback ? m_playback : m_recording; }
+
+        KindSlot m_recording;
+        KindSlot m_playback;
+    };
+}
@@ -0,0 +1,168 @@
+#include "EventBatcher.h"
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+namespace winrt::FinalProject::implementation
+{
+    void AgoraEvent::SetChannel(const char* name)
+    {
+        if (!name) {
+            channel[0] = '\0';
+            return;
+        }
+        size_t length = std::min(std::strlen(name), kMaxChannelName - 1);
+        std::memcpy(channel, name, length);
+        channel[length] = '\0';
+    }
+
+    EventBatcher::EventBatcher()
+    {
+        for (size_t i = 0; i < kCapacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_batch.reserve(kCapacity);
+    }
+
+    EventBatcher::~EventBatcher()
+    {
+        Stop();
+    }
+
+    void EventBatcher::Start(Sink sink)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_flushMutex);
+            m_sink = std::move(sink);
+        }
+        if (m_running.exchange(true)) return;
+        m_flusher = std::thread([this]() { FlushLoop(); });
+    }
+
+    void EventBatcher::Stop()
+    {
+        if (!m_running.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+        }
+        m_timer.notify_one();
+        if (m_flusher.joinable()) m_flusher.join();
+    }
+
+    void EventBatcher::SetFlushInterval(int intervalMs)
+    {
+        m_flushIntervalMs.store(std::max(1, std::min(1000, intervalMs)));
+    }
+
+    void EventBatcher::Push(const AgoraEvent& event)
+    {
+        size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[position & (kCapacity - 1)];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0) {
+                if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.event = event;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return;
+                }
+            } else if (difference < 0) {
+                // Full: the flusher is behind, count it instead of blocking the SDK thread
+                m_pendingDropped.fetch_add(1, std::memory_order_relaxed);
+                m_totalDropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool EventBatcher::TryPop(AgoraEvent& event)
+    {
+        Slot& slot = m_slots[m_dequeuePos & (kCapacity - 1)];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != m_dequeuePos + 1) return false;
+
+        event = slot.event;
+        slot.sequence.store(m_dequeuePos + kCapacity, std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    void EventBatcher::Flush()
+    {
+        std::lock_guard<std::mutex> lock(m_flushMutex);
+
+        m_batch.clear();
+        AgoraEvent event;
+        while (TryPop(event)) {
+            m_batch.push_back(event);
+        }
+
+        EventBatchStats stats;
+        stats.dropped = m_pendingDropped.exchange(0, std::memory_order_relaxed);
+        if (m_batch.empty() && stats.dropped == 0) return;
+
+        stats.merged = Coalesce(m_batch);
+        m_totalMerged.fetch_add(stats.merged, std::memory_order_relaxed);
+
+        if (m_batch.empty() && stats.dropped == 0) return;
+        if (m_sink) m_sink(m_batch, stats);
+    }
+
+    uint32_t EventBatcher::Coalesce(std::vector<AgoraEvent>& events)
+    {
+        // Index of the last surviving joined/offline event per channel + uid
+        std::unordered_map<std::string, size_t> lastPresence;
+        std::vector<bool> removed(events.size(), false);
+        uint32_t merged = 0;
+
+        for (size_t i = 0; i < events.size(); ++i) {
+            const AgoraEvent& current = events[i];
+            if (current.type != AgoraEventType::UserJoined && current.type != AgoraEventType::UserOffline) continue;
+
+            std::string key = std::string(current.channel) + '#' + std::to_string(current.uid);
+            auto it = lastPresence.find(key);
+            if (it == lastPresence.end()) {
+                lastPresence.emplace(std::move(key), i);
+                continue;
+            }
+
+            if (events[it->second].type == current.type) {
+                // Duplicate join (or offline) - the first one already says it
+                removed[i] = true;
+                merged += 1;
+            } else {
+                // Joined then left (or left then came back) - net change is nothing
+                removed[it->second] = true;
+                removed[i] = true;
+                merged += 2;
+                lastPresence.erase(it);
+            }
+        }
+
+        if (merged > 0) {
+            size_t write = 0;
+            for (size_t read = 0; read < events.size(); ++read) {
+                if (!removed[read]) events[write++] = events[read];
+            }
+            events.resize(write);
+        }
+        return merged;
+    }
+
+    void EventBatcher::FlushLoop()
+    {
+        while (m_running.load()) {
+            {
+                std::unique_lock<std::mutex> lock(m_timerMutex);
+                m_timer.wait_for(lock, std::chrono::milliseconds(m_flushIntervalMs.load()),
+                    [this]() { return !m_running.load(); });
+            }
+            Flush();
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Collects SDK callback events in a fixed-size lock-free ring and hands them to
+// JS as one batch per flush interval instead of one bridge crossing per callback.
+// Joined/offline pairs for the same uid inside a batch cancel out.
+namespace winrt::FinalProject::implementation
+{
+    enum class AgoraEventType : uint8_t
+    {
+        JoinChannelSuccess,
+        LeaveChannel,
+        UserJoined,
+        UserOffline,
+        Error,
+        TalkStateChanged, // VOX gate transition from the audio thread, value = 1 when open
+        ConnectionStateChanged, // value = CONNECTION_STATE_TYPE, uid = reason
+        ConnectionLost,
+        RejoinChannelSuccess,   // value = elapsed ms
+    };
+
+    struct AgoraEvent
+    {
+        static constexpr size_t kMaxChannelName = 65; // Agora channel names are at most 64 bytes
+
+        AgoraEventType type = AgoraEventType::Error;
+        uint32_t uid = 0;
+        int32_t value = 0; // elapsed ms, offline reason, duration, error code or connection state
+        char channel[kMaxChannelName] = {};
+
+        void SetChannel(const char* name);
+    };
+
+    struct EventBatchStats
+    {
+        uint32_t dropped = 0; // ring was full, event lost
+        uint32_t merged = 0;  // cancelled or duplicate join/offline events
+    };
+
+    class EventBatcher
+    {
+    public:
+        static constexpr size_t kCapacity = 1024; // power of two
+        static constexpr int kDefaultFlushIntervalMs = 16; // about one UI frame
+
+        using Sink = std::function<void(const std::vector<AgoraEvent>&, const EventBatchStats&)>;
+
+        EventBatcher();
+        ~EventBatcher();
+
+        EventBatcher(const EventBatcher&) = delete;
+        EventBatcher& operator=(const EventBatcher&) = delete;
+
+        void Start(Sink sink);
+        void Stop();
+        void SetFlushInterval(int intervalMs);
+
+        // Safe from any SDK thread, never blocks or allocates
+        void Push(const AgoraEvent& event);
+
+        // Drains the ring and delivers one batch to the sink (no-op when empty)
+        void Flush();
+
+        uint64_t GetDroppedCount() const { return m_totalDropped.load(std::memory_order_relaxed); }
+        uint64_t GetMergedCount() const { return m_totalMerged.load(std::memory_order_relaxed); }
+
+        // Applies join/offline cancellation in place, returns how many events were merged away
+        static uint32_t Coalesce(std::vector<AgoraEvent>& events);
+
+    private:
+        struct Slot
+        {
+            std::atomic<size_t> sequence{ 0 };
+            AgoraEvent event;
+        };
+
+        bool TryPop(AgoraEvent& event);
+        void FlushLoop();
+
+        std::array<Slot, kCapacity> m_slots;
+        alignas(64) std::atomic<size_t> m_enqueuePos{ 0 };
+        alignas(64) size_t m_dequeuePos = 0;
+
+        std::atomic<uint32_t> m_pendingDropped{ 0 };
+        std::atomic<uint64_t> m_totalDropped{ 0 };
+        std::atomic<uint64_t> m_totalMerged{ 0 };
+
+        std::mutex m_flushMutex; // serializes Flush() callers, never taken by producers
+        std::vector<AgoraEvent> m_batch;
+        Sink m_sink;
+
+        std::atomic<int> m_flushIntervalMs{ kDefaultFlushIntervalMs };
+        std::atomic<bool> m_running{ false };
+        std::mutex m_timerMutex;
+        std::condition_variable m_timer;
+        std::thread m_flusher;
+    };
+}
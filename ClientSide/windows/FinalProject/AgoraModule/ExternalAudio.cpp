@@ -0,0 +1,181 @@
+#include "ExternalAudio.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "AudioPipeline.h"
+#include "VoiceEngine.h"
+
+namespace winrt::FinalProject::implementation
+{
+    void ExternalAudio::Configure(const ExternalAudioConfig& config)
+    {
+        Stop();
+        m_configured.store(false, std::memory_order_release);
+
+        m_config = config;
+        m_config.sampleRate = std::clamp(config.sampleRate, 8000, 48000);
+        m_config.captureChannels = std::clamp(config.captureChannels, 1, 2);
+        m_config.playbackChannels = std::clamp(config.playbackChannels, 1, 2);
+        m_config.ringFrames = std::clamp(config.ringFrames, 2, 100);
+
+        const size_t frames = static_cast<size_t>(GetFramesPerChannel());
+        m_captureRing = std::make_unique<AudioFrameRing>(m_config.ringFrames, frames * m_config.captureChannels);
+        m_playbackRing = std::make_unique<AudioFrameRing>(m_config.ringFrames, frames * m_config.playbackChannels);
+        m_uplinkFrame.assign(frames * m_config.captureChannels, 0);
+        m_downlinkFrame.assign(frames * m_config.playbackChannels, 0);
+        m_captureSlot = nullptr;
+        m_captureFill = 0;
+        m_playbackSlot = nullptr;
+        m_playbackPosition = 0;
+        m_pushed.store(0);
+        m_pulled.store(0);
+        m_late.store(0);
+
+        m_configured.store(true, std::memory_order_release);
+    }
+
+    void ExternalAudio::Start(IVoiceEngine* engine, AudioPipeline* capture, AudioPipeline* playback)
+    {
+        Stop();
+        if (!engine || !m_configured.load(std::memory_order_acquire)) return;
+
+        m_engine = engine;
+        m_capture = capture;
+        m_playback = playback;
+        m_running.store(true, std::memory_order_release);
+        if (m_config.paced) {
+            m_thread = std::thread(&ExternalAudio::PumpLoop, this);
+        }
+    }
+
+    void ExternalAudio::Stop()
+    {
+        m_running.store(false, std::memory_order_release);
+        if (m_thread.joinable()) m_thread.join();
+        m_engine = nullptr;
+        m_capture = nullptr;
+        m_playback = nullptr;
+    }
+
+    void ExternalAudio::PumpLoop()
+    {
+        using Clock = std::chrono::steady_clock;
+        const auto period = std::chrono::milliseconds(kFrameMs);
+
+        auto next = Clock::now();
+        while (m_running.load(std::memory_order_acquire)) {
+            Pump();
+            next += period;
+
+            // Behind by a whole frame (a descheduled thread): start over from now instead of
+            // bursting frames at the SDK to catch up
+            auto now = Clock::now();
+            if (now > next + period) {
+                m_late.fetch_add(1, std::memory_order_relaxed);
+                next = now;
+            }
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void ExternalAudio::Pump()
+    {
+        if (!m_running.load(std::memory_order_relaxed) || !m_engine) return;
+
+        const int frames = GetFramesPerChannel();
+        const int rate = m_config.sampleRate;
+
+        // Uplink: a frame that never arrived goes out as silence, like a quiet microphone
+        if (!m_captureRing->Read(m_uplinkFrame.data())) {
+            std::fill(m_uplinkFrame.begin(), m_uplinkFrame.end(), static_cast<int16_t>(0));
+        }
+        if (m_capture) m_capture->Process(m_uplinkFrame.data(), frames, m_config.captureChannels, rate);
+        if (m_engine->PushAudioFrame(m_uplinkFrame.data(), frames, m_config.captureChannels, rate) == 0) {
+            m_pushed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Downlink: processed straight into the renderer's ring
+        int16_t* slot = m_playbackRing->BeginWrite();
+        int16_t* out = slot ? slot : m_downlinkFrame.data();
+        if (m_engine->PullAudioFrame(out, frames, m_config.playbackChannels, rate) != 0) return;
+        m_pulled.fetch_add(1, std::memory_order_relaxed);
+        if (m_playback) m_playback->Process(out, frames, m_config.playbackChannels, rate);
+        if (slot) m_playbackRing->CommitWrite();
+    }
+
+    int ExternalAudio::WriteCapture(const int16_t* samples, int framesPerChannel)
+    {
+        if (!samples || framesPerChannel <= 0 || !m_configured.load(std::memory_order_acquire)) return 0;
+
+        const size_t channels = static_cast<size_t>(m_config.captureChannels);
+        const size_t frameSamples = m_captureRing->GetSamplesPerFrame();
+        size_t remaining = static_cast<size_t>(framesPerChannel) * channels;
+        size_t taken = 0;
+        while (remaining > 0) {
+            if (!m_captureSlot) {
+                m_captureSlot = m_captureRing->BeginWrite();
+                m_captureFill = 0;
+                if (!m_captureSlot) break; // full: the rest of this chunk is lost
+            }
+            size_t count = std::min(remaining, frameSamples - m_captureFill);
+            std::copy(samples + taken, samples + taken + count, m_captureSlot + m_captureFill);
+            m_captureFill += count;
+            taken += count;
+            remaining -= count;
+            if (m_captureFill == frameSamples) {
+                m_captureRing->CommitWrite();
+                m_captureSlot = nullptr;
+            }
+        }
+        return static_cast<int>(taken / channels);
+    }
+
+    int ExternalAudio::ReadPlayback(int16_t* samples, int framesPerChannel)
+    {
+        if (!samples || framesPerChannel <= 0) return 0;
+
+        const size_t channels = static_cast<size_t>(m_config.playbackChannels);
+        size_t remaining = static_cast<size_t>(framesPerChannel) * channels;
+        if (!m_configured.load(std::memory_order_acquire)) {
+            std::fill(samples, samples + remaining, static_cast<int16_t>(0));
+            return 0;
+        }
+
+        const size_t frameSamples = m_playbackRing->GetSamplesPerFrame();
+        size_t given = 0;
+        while (remaining > 0) {
+            if (!m_playbackSlot) {
+                m_playbackSlot = m_playbackRing->BeginRead();
+                m_playbackPosition = 0;
+                if (!m_playbackSlot) break;
+            }
+            size_t count = std::min(remaining, frameSamples - m_playbackPosition);
+            std::copy(m_playbackSlot + m_playbackPosition, m_playbackSlot + m_playbackPosition + count, samples + given);
+            m_playbackPosition += count;
+            given += count;
+            remaining -= count;
+            if (m_playbackPosition == frameSamples) {
+                m_playbackRing->ReleaseRead();
+                m_playbackSlot = nullptr;
+            }
+        }
+        std::fill(samples + given, samples + given + remaining, static_cast<int16_t>(0));
+        return static_cast<int>(given / channels);
+    }
+
+    ExternalAudioStats ExternalAudio::GetStats() const
+    {
+        ExternalAudioStats stats;
+        stats.pushedFrames = m_pushed.load(std::memory_order_relaxed);
+        stats.pulledFrames = m_pulled.load(std::memory_order_relaxed);
+        stats.latePumps = m_late.load(std::memory_order_relaxed);
+        if (m_configured.load(std::memory_order_acquire)) {
+            stats.captureOverruns = m_captureRing->GetOverruns();
+            stats.captureUnderruns = m_captureRing->GetUnderruns();
+            stats.playbackOverruns = m_playbackRing->GetOverruns();
+            stats.playbackUnderruns = m_playbackRing->GetUnderruns();
+        }
+        return stats;
+    }
+}
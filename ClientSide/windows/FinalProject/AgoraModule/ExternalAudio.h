@@ -0,0 +1,106 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "AudioFrameRing.h"
+
+// External audio mode: our own capture device and renderer instead of the SDK's, so a console
+// position can run on its own sound card, and a WAV file can stand in for both on Linux.
+//
+//   our capture device -> WriteCapture -> [ring] -> pump: capture pipeline -> IVoiceEngine::PushAudioFrame
+//   IVoiceEngine::PullAudioFrame -> pump: playback pipeline -> [ring] -> ReadPlayback -> our renderer
+//
+// Each ring has one producer and one consumer thread and preallocated 10 ms frames; the device
+// sides take and give any number of samples. The pump steps every 10 ms on its own thread, or
+// whenever the caller says (tests, benchmarks). Nothing allocates once Configure has run.
+namespace winrt::FinalProject::implementation
+{
+    class AudioPipeline;
+    class IVoiceEngine;
+
+    struct ExternalAudioConfig
+    {
+        int sampleRate = 48000;
+        int captureChannels = 1;   // what our capture device delivers
+        int playbackChannels = 2;  // what our renderer plays
+        int ringFrames = 8;        // 80 ms each way: how far the devices may drift before a drop
+        bool paced = true;         // false: no pump thread, the caller steps Pump()
+    };
+
+    struct ExternalAudioStats
+    {
+        uint64_t pushedFrames = 0;
+        uint64_t pulledFrames = 0;
+        uint64_t captureOverruns = 0;   // the capture device ran ahead: its samples were dropped
+        uint64_t captureUnderruns = 0;  // nothing captured in time: silence went out instead
+        uint64_t playbackOverruns = 0;  // the renderer fell behind: pulled frames were dropped
+        uint64_t playbackUnderruns = 0; // nothing pulled in time: the renderer got silence
+        uint64_t latePumps = 0;         // pump steps that started a whole frame late
+    };
+
+    class ExternalAudio
+    {
+    public:
+        static constexpr int kFrameMs = 10;
+
+        ExternalAudio() = default;
+        ~ExternalAudio() { Stop(); }
+
+        ExternalAudio(const ExternalAudio&) = delete;
+        ExternalAudio& operator=(const ExternalAudio&) = delete;
+
+        // Worker thread, before either device starts: sizes the rings (the only allocation)
+        void Configure(const ExternalAudioConfig& config);
+        const ExternalAudioConfig& GetConfig() const { return m_config; }
+        int GetFramesPerChannel() const { return m_config.sampleRate * kFrameMs / 1000; }
+
+        // Worker thread. The engine and pipelines must outlive Stop.
+        void Start(IVoiceEngine* engine, AudioPipeline* capture, AudioPipeline* playback);
+        void Stop();
+        bool IsRunning() const { return m_running.load(std::memory_order_acquire); }
+
+        // Pump thread (or the caller when not paced): one 10 ms step in both directions
+        void Pump();
+
+        // Our capture device, one thread: interleaved samples at the configured format.
+        // Returns the frames per channel taken; the rest was dropped because the ring was full.
+        int WriteCapture(const int16_t* samples, int framesPerChannel);
+
+        // Our renderer, one thread: always fills framesPerChannel, with silence where nothing
+        // was pulled in time. Returns the frames per channel that carried pulled audio.
+        int ReadPlayback(int16_t* samples, int framesPerChannel);
+
+        ExternalAudioStats GetStats() const;
+
+    private:
+        void PumpLoop();
+
+        ExternalAudioConfig m_config;
+        std::unique_ptr<AudioFrameRing> m_captureRing;
+        std::unique_ptr<AudioFrameRing> m_playbackRing;
+        std::atomic<bool> m_configured{ false };
+
+        // Pump side
+        IVoiceEngine* m_engine = nullptr;
+        AudioPipeline* m_capture = nullptr;
+        AudioPipeline* m_playback = nullptr;
+        std::vector<int16_t> m_uplinkFrame;
+        std::vector<int16_t> m_downlinkFrame;
+        std::thread m_thread;
+        std::atomic<bool> m_running{ false };
+        std::atomic<uint64_t> m_pushed{ 0 };
+        std::atomic<uint64_t> m_pulled{ 0 };
+        std::atomic<uint64_t> m_late{ 0 };
+
+        // Capture device side: the frame being filled
+        int16_t* m_captureSlot = nullptr;
+        size_t m_captureFill = 0;
+
+        // Renderer side: the frame being played out
+        const int16_t* m_playbackSlot = nullptr;
+        size_t m_playbackPosition = 0;
+    };
+}
@@ -0,0 +1,1236 @@
+#include "FakeVoiceEngine.h"
+#include "AudioPipeline.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    FakeStreamRelay::FakeStreamRelay(int latencyMs, double lossRate, uint32_t seed)
+        : m_latencyMs(std::max(0, latencyMs)), m_lossRate(lossRate), m_random(seed)
+    {
+    }
+
+    void FakeStreamRelay::SetLatency(int latencyMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_latencyMs = std::max(0, latencyMs);
+    }
+
+    void FakeStreamRelay::SetLossRate(double lossRate)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lossRate = lossRate;
+    }
+
+    void FakeStreamRelay::Attach(FakeVoiceEngine* engine)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_engines.push_back(engine);
+    }
+
+    void FakeStreamRelay::Detach(FakeVoiceEngine* engine)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_engines.erase(std::remove(m_engines.begin(), m_engines.end(), engine), m_engines.end());
+    }
+
+    // Lock order is relay, then receiver; senders call in without holding their own lock
+    void FakeStreamRelay::Send(FakeVoiceEngine* sender, const std::string& channelName, uint32_t uid, int streamId,
+                               const std::string& data)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_sent.fetch_add(1, std::memory_order_relaxed);
+        for (FakeVoiceEngine* engine : m_engines) {
+            if (engine == sender) continue;
+            if (m_lossRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_lossRate) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            engine->ReceiveStreamMessage(channelName, uid, streamId, data, m_latencyMs);
+        }
+    }
+
+    FakeVoiceEngine::FakeVoiceEngine(FakeEngineConfig config)
+        : m_config(config),
+          m_joinDelayMs(std::max(0, config.joinDelayMs)),
+          m_failureRate(config.failureRate),
+          m_random(config.seed)
+    {
+        for (auto& count : m_calls) count.store(0, std::memory_order_relaxed);
+        m_devices[static_cast<size_t>(AudioDeviceKind::Playback)] = { { "{0.0.0.00000000}.{realtek-speakers}", "Speakers (Realtek(R) Audio)" } };
+        m_devices[static_cast<size_t>(AudioDeviceKind::Recording)] = { { "{0.0.1.00000000}.{realtek-microphone}", "Microphone Array (Realtek(R) Audio)" } };
+        for (size_t kind = 0; kind < m_devices.size(); ++kind) m_activeDevices[kind] = m_devices[kind].front().id;
+
+        m_lastmileLink.state = LastmileProbeResult::kComplete;
+        m_lastmileLink.uplink = { 0, 2, 20000 };
+        m_lastmileLink.downlink = { 0, 2, 50000 };
+        m_lastmileLink.rttMs = 12;
+
+        if (!m_config.manualClock) {
+            m_callbackThread = std::thread([this]() { CallbackLoop(); });
+        }
+        if (m_config.relay) m_config.relay->Attach(this);
+    }
+
+    FakeVoiceEngine::~FakeVoiceEngine()
+    {
+        // First, so no message can be scheduled on an engine that is going away
+        if (m_config.relay) m_config.relay->Detach(this);
+        Release();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_callbackThread.joinable()) m_callbackThread.join();
+    }
+
+    int FakeVoiceEngine::Enter(FakeCall call)
+    {
+        m_calls[static_cast<size_t>(call)].fetch_add(1, std::memory_order_relaxed);
+
+        if (m_config.callCostUs > 0) {
+            auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(m_config.callCostUs);
+            while (std::chrono::steady_clock::now() < until) {
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& queued = m_failNext[static_cast<size_t>(call)];
+        int error = 0;
+        if (!queued.empty()) {
+            error = queued.front();
+            queued.erase(queued.begin());
+        } else if (m_failureRate > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < m_failureRate) {
+            error = kErrFailed;
+        }
+        if (error != 0) m_injectedFailures.fetch_add(1, std::memory_order_relaxed);
+        return error;
+    }
+
+    int64_t FakeVoiceEngine::NowLocked() const
+    {
+        if (m_config.manualClock) return m_manualNowMs;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+    int64_t FakeVoiceEngine::NowMs() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return NowLocked();
+    }
+
+    void FakeVoiceEngine::Schedule(int delayMs, std::function<void()> fire)
+    {
+        int64_t dueMs = NowLocked() + std::max(0, delayMs);
+        m_timeline.emplace(std::make_pair(dueMs, m_sequence++), std::move(fire));
+        m_wake.notify_one();
+    }
+
+    FakeVoiceEngine::Connection* FakeVoiceEngine::Find(const std::string& channelName)
+    {
+        auto it = m_connections.find(channelName);
+        if (it != m_connections.end()) return &it->second;
+        if (m_defaultActive && m_default.info.channelName == channelName) return &m_default;
+        return nullptr;
+    }
+
+    const FakeVoiceEngine::Connection* FakeVoiceEngine::Find(const std::string& channelName) const
+    {
+        return const_cast<FakeVoiceEngine*>(this)->Find(channelName);
+    }
+
+    void FakeVoiceEngine::ScheduleJoinSuccess(const std::string& channelName, uint64_t session, int delayMs)
+    {
+        Schedule(delayMs, [this, channelName, session, delayMs]() {
+            IVoiceEngineEvents* events = nullptr;
+            uint32_t uid = 0;
+            bool failed = false;
+            std::vector<uint32_t> remoteUsers;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Connection* connection = Find(channelName);
+                // Left (or left and joined again) before the SDK got there
+                if (!m_initialized || !connection || connection->session != session) return;
+                failed = m_networkDown;
+                connection->info.joined = !failed;
+                connection->info.state = failed ? kStateFailed : kStateConnected;
+                events = connection->events;
+                uid = connection->info.uid;
+                auto users = m_remoteUsers.find(channelName);
+                if (users != m_remoteUsers.end()) remoteUsers = users->second;
+            }
+            if (!events) return;
+            if (failed) {
+                events->onConnectionStateChanged(kStateFailed, kReasonJoinFailed);
+                return;
+            }
+            events->onConnectionStateChanged(kStateConnected, kReasonJoinSuccess);
+            events->onJoinChannelSuccess(channelName.c_str(), uid, delayMs);
+            // Everyone already in the channel is announced right after the join
+            for (uint32_t remoteUid : remoteUsers) {
+                events->onUserJoined(remoteUid, 0);
+            }
+        });
+    }
+
+    void FakeVoiceEngine::ScheduleLeave(IVoiceEngineEvents* events, ChannelStatsSample stats)
+    {
+        Schedule(m_config.leaveDelayMs, [this, events, stats]() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_initialized) return;
+            }
+            if (!events) return;
+            events->onConnectionStateChanged(kStateDisconnected, kReasonLeaveChannel);
+            events->onLeaveChannel(stats);
+        });
+    }
+
+    void FakeVoiceEngine::ScheduleForConnection(const std::string& channelName, int delayMs,
+                                                std::function<void(IVoiceEngineEvents&)> fire)
+    {
+        Schedule(delayMs, [this, channelName, fire = std::move(fire)]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const Connection* connection = Find(channelName);
+                if (!m_initialized || !connection || !connection->info.joined) return;
+                events = connection->events;
+            }
+            if (events) fire(*events);
+        });
+    }
+
+    ChannelStatsSample FakeVoiceEngine::LeaveStats(const Connection& connection) const
+    {
+        ChannelStatsSample stats;
+        stats.durationS = static_cast<uint32_t>(std::max<int64_t>(0, NowLocked() - connection.joinedAtMs) / 1000);
+        auto users = m_remoteUsers.find(connection.info.channelName);
+        stats.userCount = 1 + (users != m_remoteUsers.end() ? static_cast<uint32_t>(users->second.size()) : 0);
+        return stats;
+    }
+
+    int FakeVoiceEngine::Initialize(const std::string& appId, IVoiceEngineEvents* events)
+    {
+        int result = Enter(FakeCall::Initialize);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (appId.empty() || !events) return kErrInvalidArgument;
+        m_events = events;
+        m_default = Connection{};
+        m_default.events = events;
+        m_initialized = true;
+        return 0;
+    }
+
+    void FakeVoiceEngine::Release()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_initialized = false;
+            m_timeline.clear();
+            m_connections.clear();
+            m_defaultActive = false;
+            m_default = Connection{};
+            m_events = nullptr;
+            m_echoTestRunning = false;
+            m_lastmileSession = 0;
+        }
+        m_externalRate.store(0, std::memory_order_release);
+        m_capture.store(nullptr);
+        m_playback.store(nullptr);
+        m_remote.store(nullptr);
+        // A callback already taken off the timeline finishes before the handlers may go away
+        std::lock_guard<std::mutex> fireLock(m_fireMutex);
+    }
+
+    int FakeVoiceEngine::SetAudioProcessors(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        m_capture.store(capture);
+        m_playback.store(playback);
+        m_remote.store(remote);
+        return 0;
+    }
+
+    int FakeVoiceEngine::JoinChannel(const std::string& channelName, uint32_t uid, const ConnectionOptions& options)
+    {
+        int result = Enter(FakeCall::JoinChannel);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (channelName.empty()) return kErrInvalidArgument;
+        if (m_defaultActive) return kErrAlreadyJoined;
+
+        // Mute and volume indication are engine settings, they carry over between joins
+        m_default.info.channelName = channelName;
+        m_default.info.uid = uid != 0 ? uid : m_nextUid++;
+        m_default.info.joined = false;
+        m_default.info.publishing = options.publishMicrophone && !options.audience;
+        m_default.info.subscribed = options.autoSubscribeAudio;
+        m_default.info.audience = options.audience;
+        m_default.info.audienceLatency = options.audience ? options.audienceLatency : 0;
+        m_default.info.state = kStateConnecting;
+        m_default.options = options;
+        m_default.session = m_nextSession++;
+        m_default.joinedAtMs = NowLocked();
+        m_defaultActive = true;
+        ScheduleJoinSuccess(channelName, m_default.session, m_joinDelayMs);
+        return 0;
+    }
+
+    int FakeVoiceEngine::UpdateChannel(const ConnectionOptions& options)
+    {
+        int result = Enter(FakeCall::UpdateChannel);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (!m_defaultActive) return kErrFailed;
+        m_default.info.publishing = options.publishMicrophone && !options.audience;
+        m_default.info.subscribed = options.autoSubscribeAudio;
+        m_default.info.audience = options.audience;
+        m_default.info.audienceLatency = options.audience ? options.audienceLatency : 0;
+        return 0;
+    }
+
+    int FakeVoiceEngine::LeaveChannel()
+    {
+        int result = Enter(FakeCall::LeaveChannel);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (!m_defaultActive) return 0;
+
+        ScheduleLeave(m_default.events, LeaveStats(m_default));
+        m_defaultActive = false;
+        m_default.info.joined = false;
+        m_default.info.state = kStateDisconnected;
+        m_default.session = 0;
+        return 0;
+    }
+
+    int FakeVoiceEngine::MuteLocalAudio(bool mute)
+    {
+        int result = Enter(FakeCall::MuteLocalAudio);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_default.info.muted = mute;
+        return 0;
+    }
+
+    int FakeVoiceEngine::EnableVolumeIndication(int intervalMs, int smooth)
+    {
+        (void)smooth;
+        int result = Enter(FakeCall::EnableVolumeIndication);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_default.info.volumeIntervalMs = std::max(0, intervalMs);
+        return 0;
+    }
+
+    int FakeVoiceEngine::JoinConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options,
+                                        IVoiceEngineEvents* events)
+    {
+        int result = Enter(FakeCall::JoinConnection);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (channelName.empty() || !events) return kErrInvalidArgument;
+        if (m_connections.count(channelName) != 0) return kErrAlreadyJoined;
+
+        Connection& connection = m_connections[channelName];
+        connection.info.channelName = channelName;
+        connection.info.uid = uid;
+        connection.info.publishing = options.publishMicrophone && !options.audience;
+        connection.info.subscribed = options.autoSubscribeAudio;
+        connection.info.audience = options.audience;
+        connection.info.audienceLatency = options.audience ? options.audienceLatency : 0;
+        connection.info.state = kStateConnecting;
+        connection.options = options;
+        connection.events = events;
+        connection.session = m_nextSession++;
+        connection.joinedAtMs = NowLocked();
+        ScheduleJoinSuccess(channelName, connection.session, m_joinDelayMs);
+        return 0;
+    }
+
+    int FakeVoiceEngine::UpdateConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options)
+    {
+        (void)uid;
+        int result = Enter(FakeCall::UpdateConnection);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        auto it = m_connections.find(channelName);
+        if (it == m_connections.end()) return kErrFailed;
+        it->second.info.publishing = options.publishMicrophone && !options.audience;
+        it->second.info.subscribed = options.autoSubscribeAudio;
+        it->second.info.audience = options.audience;
+        it->second.info.audienceLatency = options.audience ? options.audienceLatency : 0;
+        return 0;
+    }
+
+    int FakeVoiceEngine::LeaveConnection(const std::string& channelName, uint32_t uid)
+    {
+        (void)uid;
+        int result = Enter(FakeCall::LeaveConnection);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        auto it = m_connections.find(channelName);
+        if (it == m_connections.end()) return 0;
+
+        ScheduleLeave(it->second.events, LeaveStats(it->second));
+        m_connections.erase(it);
+        return 0;
+    }
+
+    int FakeVoiceEngine::MuteConnectionAudio(const std::string& channelName, uint32_t uid, bool mute)
+    {
+        (void)uid;
+        int result = Enter(FakeCall::MuteConnectionAudio);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        auto it = m_connections.find(channelName);
+        if (it == m_connections.end()) return kErrFailed;
+        it->second.info.muted = mute;
+        return 0;
+    }
+
+    int FakeVoiceEngine::EnableConnectionVolumeIndication(const std::string& channelName, uint32_t uid, int intervalMs, int smooth)
+    {
+        (void)uid;
+        (void)smooth;
+        int result = Enter(FakeCall::EnableConnectionVolumeIndication);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        auto it = m_connections.find(channelName);
+        if (it == m_connections.end()) return kErrFailed;
+        it->second.info.volumeIntervalMs = std::max(0, intervalMs);
+        return 0;
+    }
+
+    int FakeVoiceEngine::CreateDataStream(const std::string& channelName, uint32_t uid, int* streamId)
+    {
+        (void)uid;
+        int result = Enter(FakeCall::CreateDataStream);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (!streamId) return kErrInvalidArgument;
+        auto it = m_connections.find(channelName);
+        if (it == m_connections.end() || it->second.dataStreams >= kMaxDataStreams) return kErrFailed;
+        *streamId = ++it->second.dataStreams;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SendStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const char* data, size_t length)
+    {
+        int result = Enter(FakeCall::SendStreamMessage);
+        if (result != 0) return result;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_initialized) return kErrNotInitialized;
+            if (!data || length == 0 || length > kMaxStreamMessageBytes) return kErrInvalidArgument;
+            auto it = m_connections.find(channelName);
+            if (it == m_connections.end() || streamId < 1 || streamId > it->second.dataStreams) return kErrFailed;
+            if (it->second.info.audience) return kErrFailed; // audience may not send
+            // The SDK takes it and loses it while the link is down
+            if (!it->second.info.joined || m_networkDown) return 0;
+        }
+        if (m_config.relay) m_config.relay->Send(this, channelName, uid, streamId, std::string(data, length));
+        return 0;
+    }
+
+    void FakeVoiceEngine::ReceiveStreamMessage(const std::string& channelName, uint32_t uid, int streamId,
+                                               const std::string& data, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return;
+        Schedule(delayMs, [this, channelName, uid, streamId, data]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_connections.find(channelName);
+                if (!m_initialized || it == m_connections.end() || !it->second.info.joined || m_networkDown) return;
+                events = it->second.events;
+            }
+            if (!events) return;
+            m_streamMessagesReceived.fetch_add(1, std::memory_order_relaxed);
+            events->onStreamMessage(uid, streamId, data.data(), data.size());
+        });
+    }
+
+    int FakeVoiceEngine::EnableLocalAudio(bool enabled)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_localAudioEnabled = enabled;
+        return 0;
+    }
+
+    int FakeVoiceEngine::MuteRemoteAudio(uint32_t uid, bool mute)
+    {
+        (void)uid;
+        (void)mute;
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_initialized ? 0 : kErrNotInitialized;
+    }
+
+    int FakeVoiceEngine::SetRecordingVolume(int volume)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (volume < 0 || volume > 400) return kErrInvalidArgument;
+        m_recordingVolume = volume;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetPlaybackVolume(int volume)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (volume < 0 || volume > 400) return kErrInvalidArgument;
+        m_playbackVolume = volume;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetVoiceEqualization(int band, int gainDb)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        return band < 0 || band > 9 || gainDb < -15 || gainDb > 15 ? kErrInvalidArgument : 0;
+    }
+
+    int FakeVoiceEngine::SetNoiseSuppression(bool enabled, int mode)
+    {
+        (void)enabled;
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        return mode < 0 || mode > 2 ? kErrInvalidArgument : 0;
+    }
+
+    int FakeVoiceEngine::SetAudioScenario(int scenario)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_audioScenario = scenario;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetClientRole(int role)
+    {
+        int result = Enter(FakeCall::SetClientRole);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_clientRole = role;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetAudioProfile(int profile)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (profile < 0 || profile > 6) return kErrInvalidArgument;
+        m_audioProfile = profile;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetParameters(const std::string& json)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (json.size() < 2 || json.front() != '{' || json.back() != '}') return kErrInvalidArgument;
+        m_parameters = json;
+        return 0;
+    }
+
+    int FakeVoiceEngine::StartEchoTest(int intervalMs)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (intervalMs <= 0) return kErrInvalidArgument;
+        m_echoTestRunning = true;
+        return 0;
+    }
+
+    int FakeVoiceEngine::StopEchoTest()
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        m_echoTestRunning = false;
+        return 0;
+    }
+
+    int FakeVoiceEngine::StartLastmileProbe(int expectedUplinkKbps, int expectedDownlinkKbps)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (m_defaultActive) return kErrAlreadyJoined;
+        // The SDK takes 100 kbps to 5 Mbps
+        if (expectedUplinkKbps < 100 || expectedUplinkKbps > 5000 || expectedDownlinkKbps < 100 || expectedDownlinkKbps > 5000) {
+            return kErrInvalidArgument;
+        }
+
+        uint64_t session = ++m_nextSession;
+        m_lastmileSession = session;
+        m_lastmileProbes.fetch_add(1, std::memory_order_relaxed);
+        m_lastmileDue = std::make_pair(NowLocked() + std::max(0, m_config.lastmileProbeMs), m_sequence);
+        Schedule(m_config.lastmileProbeMs, [this, session]() {
+            IVoiceEngineEvents* events = nullptr;
+            LastmileProbeResult measured;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_initialized || m_lastmileSession != session) return;
+                events = m_events;
+                if (m_networkDown) {
+                    measured.state = LastmileProbeResult::kUnavailable;
+                } else {
+                    measured = m_lastmileLink;
+                }
+            }
+            if (events) events->onLastmileProbeResult(measured);
+        });
+        return 0;
+    }
+
+    int FakeVoiceEngine::StopLastmileProbe()
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        // Stopped probes report nothing, and leave nothing pending
+        if (m_lastmileSession != 0) m_timeline.erase(m_lastmileDue);
+        m_lastmileSession = 0;
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetExternalAudio(bool enabled, int sampleRate, int captureChannels, int playbackChannels)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        if (!enabled) {
+            m_externalRate.store(0, std::memory_order_release);
+            return 0;
+        }
+        if (sampleRate < 8000 || sampleRate > 48000 || captureChannels < 1 || captureChannels > 2 ||
+            playbackChannels < 1 || playbackChannels > 2) {
+            return kErrInvalidArgument;
+        }
+
+        m_externalRate.store(0, std::memory_order_release);
+        const size_t frames = static_cast<size_t>(sampleRate / 100);
+        m_loopback = std::make_unique<AudioFrameRing>(8, frames * 2);
+        m_externalCaptureChannels.store(captureChannels, std::memory_order_relaxed);
+        m_externalPlaybackChannels.store(playbackChannels, std::memory_order_relaxed);
+        m_externalRate.store(sampleRate, std::memory_order_release);
+        return 0;
+    }
+
+    int FakeVoiceEngine::PushAudioFrame(const int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        const int rate = m_externalRate.load(std::memory_order_acquire);
+        if (rate == 0) return kErrNotInitialized;
+        if (!samples || sampleRate != rate || framesPerChannel != rate / 100 ||
+            channels != m_externalCaptureChannels.load(std::memory_order_relaxed)) {
+            return kErrInvalidArgument;
+        }
+
+        // Kept as stereo so Pull can hand it back in either layout
+        if (m_config.externalLoopback) {
+            if (int16_t* slot = m_loopback->BeginWrite()) {
+                for (int i = 0; i < framesPerChannel; ++i) {
+                    slot[2 * i] = samples[i * channels];
+                    slot[2 * i + 1] = samples[i * channels + channels - 1];
+                }
+                m_loopback->CommitWrite();
+            }
+        }
+        m_pushedFrames.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    int FakeVoiceEngine::PullAudioFrame(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        const int rate = m_externalRate.load(std::memory_order_acquire);
+        if (rate == 0) return kErrNotInitialized;
+        if (!samples || sampleRate != rate || framesPerChannel != rate / 100 ||
+            channels != m_externalPlaybackChannels.load(std::memory_order_relaxed)) {
+            return kErrInvalidArgument;
+        }
+
+        const int16_t* frame = m_config.externalLoopback ? m_loopback->BeginRead() : nullptr;
+        if (!frame) {
+            std::fill(samples, samples + framesPerChannel * channels, static_cast<int16_t>(0));
+        } else if (channels == 2) {
+            std::copy(frame, frame + framesPerChannel * 2, samples);
+        } else {
+            for (int i = 0; i < framesPerChannel; ++i) {
+                samples[i] = static_cast<int16_t>((frame[2 * i] + frame[2 * i + 1]) / 2);
+            }
+        }
+        if (frame) m_loopback->ReleaseRead();
+        m_pulledFrames.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    int FakeVoiceEngine::EnumerateAudioDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo>& devices)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        devices = m_devices[static_cast<size_t>(kind)];
+        m_enumerations.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    int FakeVoiceEngine::GetAudioDevice(AudioDeviceKind kind, std::string& deviceId)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        deviceId = m_activeDevices[static_cast<size_t>(kind)];
+        return 0;
+    }
+
+    int FakeVoiceEngine::SetAudioDevice(AudioDeviceKind kind, const std::string& deviceId)
+    {
+        int result = Enter(FakeCall::Other);
+        if (result != 0) return result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized) return kErrNotInitialized;
+        const auto& devices = m_devices[static_cast<size_t>(kind)];
+        if (deviceId.empty()) {
+            m_activeDevices[static_cast<size_t>(kind)] = devices.empty() ? std::string() : devices.front().id;
+            return 0;
+        }
+        bool present = std::any_of(devices.begin(), devices.end(), [&deviceId](const AudioDeviceInfo& device) { return device.id == deviceId; });
+        if (!present) return kErrInvalidArgument;
+        m_activeDevices[static_cast<size_t>(kind)] = deviceId;
+        return 0;
+    }
+
+    void FakeVoiceEngine::FailNext(FakeCall call, int error, int times)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& queued = m_failNext[static_cast<size_t>(call)];
+        for (int i = 0; i < times; ++i) queued.push_back(error);
+    }
+
+    void FakeVoiceEngine::SetJoinDelay(int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_joinDelayMs = std::max(0, delayMs);
+    }
+
+    void FakeVoiceEngine::SetFailureRate(double failureRate)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failureRate = failureRate;
+    }
+
+    void FakeVoiceEngine::AddRemoteUser(const std::string& channelName, uint32_t uid, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Schedule(delayMs, [this, channelName, uid]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& users = m_remoteUsers[channelName];
+                if (std::find(users.begin(), users.end(), uid) != users.end()) return;
+                users.push_back(uid);
+                const Connection* connection = Find(channelName);
+                if (m_initialized && connection && connection->info.joined) events = connection->events;
+            }
+            if (events) events->onUserJoined(uid, 0);
+        });
+    }
+
+    void FakeVoiceEngine::RemoveRemoteUser(const std::string& channelName, uint32_t uid, int reason, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Schedule(delayMs, [this, channelName, uid, reason]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto& users = m_remoteUsers[channelName];
+                auto it = std::find(users.begin(), users.end(), uid);
+                if (it == users.end()) return;
+                users.erase(it);
+                const Connection* connection = Find(channelName);
+                if (m_initialized && connection && connection->info.joined) events = connection->events;
+            }
+            if (events) events->onUserOffline(uid, reason);
+        });
+    }
+
+    void FakeVoiceEngine::ReportVolumes(const std::string& channelName, const std::vector<VolumeSample>& speakers, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Schedule(delayMs, [this, channelName, speakers]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                const Connection* connection = Find(channelName);
+                // The SDK only reports volumes where indication is on
+                if (!m_initialized || !connection || !connection->info.joined || connection->info.volumeIntervalMs <= 0) return;
+                events = connection->events;
+            }
+            int totalVolume = 0;
+            for (const auto& speaker : speakers) totalVolume = std::max<int>(totalVolume, speaker.volume);
+            events->onAudioVolumeIndication(speakers.data(), static_cast<unsigned int>(speakers.size()), totalVolume);
+        });
+    }
+
+    void FakeVoiceEngine::ReportStats(const std::string& channelName, const ChannelStatsSample& stats, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ScheduleForConnection(channelName, delayMs, [stats](IVoiceEngineEvents& events) { events.onRtcStats(stats); });
+    }
+
+    void FakeVoiceEngine::ReportRemoteAudio(const std::string& channelName, uint32_t uid, const RemoteAudioSample& stats, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ScheduleForConnection(channelName, delayMs, [uid, stats](IVoiceEngineEvents& events) { events.onRemoteAudioStats(uid, stats); });
+    }
+
+    void FakeVoiceEngine::RaiseError(const std::string& channelName, int error, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!channelName.empty()) {
+            ScheduleForConnection(channelName, delayMs, [error](IVoiceEngineEvents& events) { events.onError(error, "injected fault"); });
+            return;
+        }
+        // Engine-wide errors go to the default handler whether or not a channel is joined
+        Schedule(delayMs, [this, error]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_initialized) events = m_events;
+            }
+            if (events) events->onError(error, "injected fault");
+        });
+    }
+
+    void FakeVoiceEngine::PlugAudioDevice(AudioDeviceKind kind, const AudioDeviceInfo& device, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_devices[static_cast<size_t>(kind)].push_back(device);
+        ScheduleDeviceState(kind, device.id, kDeviceActive, delayMs);
+    }
+
+    void FakeVoiceEngine::UnplugAudioDevice(AudioDeviceKind kind, const std::string& deviceId, int delayMs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& devices = m_devices[static_cast<size_t>(kind)];
+        devices.erase(std::remove_if(devices.begin(), devices.end(),
+                                     [&deviceId](const AudioDeviceInfo& device) { return device.id == deviceId; }),
+                      devices.end());
+        std::string& active = m_activeDevices[static_cast<size_t>(kind)];
+        if (active == deviceId) active = devices.empty() ? std::string() : devices.front().id;
+        ScheduleDeviceState(kind, deviceId, kDeviceUnplugged, delayMs);
+    }
+
+    void FakeVoiceEngine::ScheduleDeviceState(AudioDeviceKind kind, const std::string& deviceId, int state, int delayMs)
+    {
+        Schedule(delayMs, [this, kind, deviceId, state]() {
+            IVoiceEngineEvents* events = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_initialized) events = m_events;
+            }
+            if (events) events->onAudioDeviceStateChanged(deviceId.c_str(), static_cast<int>(kind), state);
+        });
+    }
+
+    std::string FakeVoiceEngine::GetActiveAudioDevice(AudioDeviceKind kind) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_activeDevices[static_cast<size_t>(kind)];
+    }
+
+    void FakeVoiceEngine::ScheduleLinkFault(const std::string& channelName, int delayMs, std::function<bool(Connection&)> apply,
+                                            std::function<void(IVoiceEngineEvents&, const Connection&)> fire)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        Schedule(delayMs, [this, channelName, apply = std::move(apply), fire = std::move(fire)]() {
+            Connection snapshot;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                Connection* connection = Find(channelName);
+                if (!m_initialized || !connection || !connection->events || !apply(*connection)) return;
+                snapshot = *connection;
+            }
+            fire(*snapshot.events, snapshot);
+        });
+    }
+
+    void FakeVoiceEngine::DropConnection(const std::string& channelName, int delayMs)
+    {
+        ScheduleLinkFault(channelName, delayMs,
+            [](Connection& connection) {
+                if (connection.info.state != kStateConnected) return false;
+                connection.info.joined = false;
+                connection.info.state = kStateReconnecting;
+                return true;
+            },
+            [](IVoiceEngineEvents& events, const Connection&) { events.onConnectionStateChanged(kStateReconnecting, kReasonInterrupted); });
+    }
+
+    void FakeVoiceEngine::RestoreConnection(const std::string& channelName, int delayMs)
+    {
+        ScheduleLinkFault(channelName, delayMs,
+            [](Connection& connection) {
+                if (connection.info.state != kStateReconnecting) return false;
+                const ConnectionOptions& options = connection.options;
+                connection.info.joined = true;
+                connection.info.state = kStateConnected;
+                connection.info.publishing = options.publishMicrophone && !options.audience;
+                connection.info.subscribed = options.autoSubscribeAudio;
+                connection.info.audience = options.audience;
+                connection.info.audienceLatency = options.audience ? options.audienceLatency : 0;
+                connection.info.muted = false;
+                return true;
+            },
+            [channelName](IVoiceEngineEvents& events, const Connection& connection) {
+                events.onConnectionStateChanged(kStateConnected, kReasonRejoinSuccess);
+                events.onRejoinChannelSuccess(channelName.c_str(), connection.info.uid, 0);
+            });
+    }
+
+    void FakeVoiceEngine::LoseConnection(const std::string& channelName, int delayMs)
+    {
+        ScheduleLinkFault(channelName, delayMs,
+            [](Connection& connection) { return connection.info.state == kStateReconnecting; },
+            [](IVoiceEngineEvents& events, const Connection&) { events.onConnectionLost(); });
+    }
+
+    void FakeVoiceEngine::FailConnection(const std::string& channelName, int reason, int delayMs)
+    {
+        ScheduleLinkFault(channelName, delayMs,
+            [](Connection& connection) {
+                if (connection.info.state == kStateFailed) return false;
+                connection.info.joined = false;
+                connection.info.state = kStateFailed;
+                return true;
+            },
+            [reason](IVoiceEngineEvents& events, const Connection&) { events.onConnectionStateChanged(kStateFailed, reason); });
+    }
+
+    void FakeVoiceEngine::SetNetworkDown(bool down)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_networkDown = down;
+    }
+
+    void FakeVoiceEngine::SetLastmileLink(const LastmileProbeResult& link)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastmileLink = link;
+    }
+
+    // Muted publishers still count: muting stops the stream, not the host slot or the microphone
+    bool FakeVoiceEngine::IsPublisherLocked(const Connection& connection) const
+    {
+        return !connection.info.audience && connection.info.publishing;
+    }
+
+    int FakeVoiceEngine::UplinkKbpsLocked() const
+    {
+        auto rate = [this](const Connection& connection) {
+            if (!IsPublisherLocked(connection)) return m_config.listenerKbps;
+            return connection.info.muted || !m_localAudioEnabled ? m_config.mutedKbps : m_config.voiceKbps;
+        };
+        int kbps = m_defaultActive ? rate(m_default) : 0;
+        for (const auto& entry : m_connections) kbps += rate(entry.second);
+        return kbps;
+    }
+
+    int FakeVoiceEngine::GetPublisherCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        int count = m_defaultActive && IsPublisherLocked(m_default) ? 1 : 0;
+        for (const auto& entry : m_connections) {
+            if (IsPublisherLocked(entry.second)) ++count;
+        }
+        return count;
+    }
+
+    bool FakeVoiceEngine::IsCapturing() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_initialized || !m_localAudioEnabled || IsExternalAudio()) return false;
+        if (m_defaultActive && IsPublisherLocked(m_default)) return true;
+        return std::any_of(m_connections.begin(), m_connections.end(),
+                           [this](const auto& entry) { return IsPublisherLocked(entry.second); });
+    }
+
+    bool FakeVoiceEngine::IsLocalAudioEnabled() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_localAudioEnabled;
+    }
+
+    int FakeVoiceEngine::PumpAudio(int milliseconds)
+    {
+        constexpr int kRate = 48000;
+        constexpr int kFrame = kRate / 100;
+        int16_t frame[kFrame];
+        int captured = 0;
+
+        for (int elapsed = 0; elapsed < milliseconds; elapsed += 10) {
+            int kbps;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                kbps = m_initialized ? UplinkKbpsLocked() : 0;
+            }
+            m_uplinkBits.fetch_add(static_cast<uint64_t>(kbps) * 10, std::memory_order_relaxed);
+            if (!IsCapturing()) continue;
+
+            if (m_config.captureCostUs > 0) {
+                auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(m_config.captureCostUs);
+                while (std::chrono::steady_clock::now() < until) {
+                }
+            }
+            for (auto& sample : frame) {
+                m_noise = m_noise * 1664525u + 1013904223u;
+                sample = static_cast<int16_t>(static_cast<int32_t>(m_noise >> 24) - 128); // about -48 dBFS
+            }
+            ProcessCapture(frame, kFrame, 1, kRate);
+            ++captured;
+        }
+        m_capturedFrames.fetch_add(static_cast<uint64_t>(captured), std::memory_order_relaxed);
+        return captured;
+    }
+
+    bool FakeVoiceEngine::ProcessCapture(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        AudioPipeline* pipeline = m_capture.load();
+        if (!pipeline) return false;
+        pipeline->Process(samples, framesPerChannel, channels, sampleRate);
+        return true;
+    }
+
+    bool FakeVoiceEngine::ProcessPlayback(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        AudioPipeline* pipeline = m_playback.load();
+        if (!pipeline) return false;
+        pipeline->Process(samples, framesPerChannel, channels, sampleRate);
+        return true;
+    }
+
+    bool FakeVoiceEngine::ProcessRemote(const std::string& channelName, uint32_t uid, const int16_t* samples,
+                                        int framesPerChannel, int channels, int sampleRate)
+    {
+        IRemoteAudioSink* sink = m_remote.load();
+        if (!sink) return false;
+        sink->OnRemoteAudioFrame(channelName.c_str(), uid, samples, framesPerChannel, channels, sampleRate);
+        return true;
+    }
+
+    void FakeVoiceEngine::Fire(std::function<void()>& fire)
+    {
+        std::lock_guard<std::mutex> fireLock(m_fireMutex);
+        fire();
+    }
+
+    void FakeVoiceEngine::AdvanceBy(int milliseconds)
+    {
+        if (!m_config.manualClock) return;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        int64_t targetMs = m_manualNowMs + std::max(0, milliseconds);
+        // Callbacks may schedule more callbacks; anything due by the target fires in this call
+        while (!m_timeline.empty() && m_timeline.begin()->first.first <= targetMs) {
+            auto entry = m_timeline.begin();
+            m_manualNowMs = std::max(m_manualNowMs, entry->first.first);
+            std::function<void()> fire = std::move(entry->second);
+            m_timeline.erase(entry);
+
+            lock.unlock();
+            Fire(fire);
+            lock.lock();
+        }
+        m_manualNowMs = targetMs;
+    }
+
+    void FakeVoiceEngine::CallbackLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_running) {
+            if (m_timeline.empty()) {
+                m_wake.wait(lock);
+                continue;
+            }
+            int64_t waitMs = m_timeline.begin()->first.first - NowLocked();
+            if (waitMs > 0) {
+                m_wake.wait_for(lock, std::chrono::milliseconds(waitMs));
+                continue;
+            }
+
+            auto entry = m_timeline.begin();
+            std::function<void()> fire = std::move(entry->second);
+            m_timeline.erase(entry);
+
+            lock.unlock();
+            Fire(fire);
+            lock.lock();
+        }
+    }
+
+    bool FakeVoiceEngine::IsInitialized() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_initialized;
+    }
+
+    size_t FakeVoiceEngine::GetPendingCallbackCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_timeline.size();
+    }
+
+    bool FakeVoiceEngine::FindConnection(const std::string& channelName, ConnectionInfo& info) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const Connection* connection = Find(channelName);
+        if (!connection) return false;
+        info = connection->info;
+        return true;
+    }
+
+    std::vector<std::string> FakeVoiceEngine::GetConnectionNames() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::vector<std::string> names;
+        names.reserve(m_connections.size());
+        for (const auto& entry : m_connections) names.push_back(entry.first);
+        return names;
+    }
+
+    bool FakeVoiceEngine::IsLocalAudioMuted() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_default.info.muted;
+    }
+
+    int FakeVoiceEngine::GetClientRole() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_clientRole;
+    }
+
+    int FakeVoiceEngine::GetAudioScenario() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_audioScenario;
+    }
+
+    int FakeVoiceEngine::GetRecordingVolume() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_recordingVolume;
+    }
+
+    int FakeVoiceEngine::GetPlaybackVolume() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_playbackVolume;
+    }
+
+    int FakeVoiceEngine::GetAudioProfile() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_audioProfile;
+    }
+
+    std::string FakeVoiceEngine::GetParameters() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_parameters;
+    }
+
+    bool FakeVoiceEngine::IsLastmileProbing() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_lastmileSession != 0;
+    }
+
+    bool FakeVoiceEngine::IsEchoTestRunning() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_echoTestRunning;
+    }
+
+    bool FakeVoiceEngine::HasAudioProcessors() const
+    {
+        return m_capture.load() != nullptr && m_playback.load() != nullptr;
+    }
+}
@@ -0,0 +1,382 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AudioFrameRing.h"
+#include "VoiceEngine.h"
+
+// In-process IVoiceEngine for tests and benchmarks. Calls change a small model of the SDK
+// (connections, publish/mute flags, volume indication) and schedule the callbacks the
+// SDK would send, after configurable delays. With manualClock the callbacks only fire
+// from AdvanceBy() on the caller's thread, so a test sees the exact same sequence on
+// every run; otherwise a callback thread delivers them in real time like the SDK does.
+// Faults: FailNext() for a specific call, failureRate for seeded random failures, and
+// Drop/Restore/Lose/FailConnection plus SetNetworkDown for the link itself. Data stream
+// messages travel between fakes that share a FakeStreamRelay.
+namespace winrt::FinalProject::implementation
+{
+    class FakeVoiceEngine;
+
+    // Stand-in for the SDK's servers between fake engines in one process: a stream message sent
+    // on a channel reaches every other attached engine joined to it after latencyMs, unless
+    // lossRate drops it. Engines attach through FakeEngineConfig::relay for their lifetime.
+    class FakeStreamRelay
+    {
+    public:
+        explicit FakeStreamRelay(int latencyMs = 20, double lossRate = 0.0, uint32_t seed = 1);
+
+        FakeStreamRelay(const FakeStreamRelay&) = delete;
+        FakeStreamRelay& operator=(const FakeStreamRelay&) = delete;
+
+        void SetLatency(int latencyMs);
+        void SetLossRate(double lossRate);
+
+        uint64_t GetSentCount() const { return m_sent.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    private:
+        friend class FakeVoiceEngine;
+
+        void Attach(FakeVoiceEngine* engine);
+        void Detach(FakeVoiceEngine* engine);
+        void Send(FakeVoiceEngine* sender, const std::string& channelName, uint32_t uid, int streamId, const std::string& data);
+
+        mutable std::mutex m_mutex; // held while handing a message to receivers; engines detach under it
+        std::vector<FakeVoiceEngine*> m_engines;
+        int m_latencyMs;
+        double m_lossRate;
+        std::mt19937 m_random;
+        std::atomic<uint64_t> m_sent{ 0 };
+        std::atomic<uint64_t> m_dropped{ 0 };
+    };
+
+    enum class FakeCall : uint8_t
+    {
+        Initialize,
+        JoinChannel,
+        UpdateChannel,
+        LeaveChannel,
+        MuteLocalAudio,
+        EnableVolumeIndication,
+        JoinConnection,
+        UpdateConnection,
+        LeaveConnection,
+        MuteConnectionAudio,
+        EnableConnectionVolumeIndication,
+        CreateDataStream,
+        SendStreamMessage,
+        SetClientRole,
+        Other, // audio settings, echo test, remote mute
+        Count,
+    };
+
+    struct FakeEngineConfig
+    {
+        int joinDelayMs = 30;         // join call -> onJoinChannelSuccess
+        int leaveDelayMs = 5;         // leave call -> onLeaveChannel
+        int callCostUs = 0;           // busy time inside every call, to model SDK call cost
+        bool manualClock = false;     // true: callbacks only fire from AdvanceBy()
+        uint32_t seed = 1;
+        double failureRate = 0.0;     // probability that any call returns kErrFailed
+
+        // Audio model for PumpAudio - assumed figures, not measurements. captureCostUs is busy
+        // time per captured 10 ms frame standing in for the SDK's own capture and 3A work.
+        int captureCostUs = 0;
+        int voiceKbps = 40;           // unmuted publisher: 24 kbps Opus + RTP/UDP/IP at 50 packets/s
+        int mutedKbps = 8;            // muted publisher: silence frames and RTCP keep flowing
+        int listenerKbps = 1;         // audience or non-publishing: RTCP receiver reports only
+
+        FakeStreamRelay* relay = nullptr; // data stream peers; must outlive the engine
+
+        int lastmileProbeMs = 30000;  // StartLastmileProbe -> onLastmileProbeResult
+
+        // External audio: pulled frames replay what was pushed (ringFrames later at most, channels
+        // converted) like a far side that loops us back; false pulls silence
+        bool externalLoopback = true;
+    };
+
+    class FakeVoiceEngine : public IVoiceEngine
+    {
+    public:
+        static constexpr int kErrFailed = -1;
+        static constexpr int kErrInvalidArgument = -2;
+        static constexpr int kErrNotInitialized = -7;
+        static constexpr int kErrAlreadyJoined = -17;
+        static constexpr int kMaxDataStreams = 5;       // per connection, as in the SDK
+        static constexpr size_t kMaxStreamMessageBytes = 1024;
+
+        // CONNECTION_STATE_TYPE and CONNECTION_CHANGED_REASON_TYPE values the fake reports
+        static constexpr int kStateDisconnected = 1;
+        static constexpr int kStateConnecting = 2;
+        static constexpr int kStateConnected = 3;
+        static constexpr int kStateReconnecting = 4;
+        static constexpr int kStateFailed = 5;
+        // MEDIA_DEVICE_STATE_TYPE values the fake reports
+        static constexpr int kDeviceActive = 1;
+        static constexpr int kDeviceUnplugged = 8;
+        static constexpr int kReasonJoinSuccess = 1;
+        static constexpr int kReasonInterrupted = 2;
+        static constexpr int kReasonJoinFailed = 4;
+        static constexpr int kReasonLeaveChannel = 5;
+        static constexpr int kReasonRejoinSuccess = 15;
+
+        // Snapshot of one connection for assertions
+        struct ConnectionInfo
+        {
+            std::string channelName;
+            uint32_t uid = 0;
+            bool joined = false;            // onJoinChannelSuccess delivered
+            bool publishing = false;
+            bool subscribed = false;
+            bool muted = false;
+            bool audience = false;          // client role, from ConnectionOptions
+            int audienceLatency = 0;
+            int volumeIntervalMs = 0;
+            int state = kStateDisconnected; // CONNECTION_STATE_TYPE
+        };
+
+        explicit FakeVoiceEngine(FakeEngineConfig config = {});
+        ~FakeVoiceEngine() override;
+
+        FakeVoiceEngine(const FakeVoiceEngine&) = delete;
+        FakeVoiceEngine& operator=(const FakeVoiceEngine&) = delete;
+
+        // IVoiceEngine
+        int Initialize(const std::string& appId, IVoiceEngineEvents* events) override;
+        void Release() override;
+        int SetAudioProcessors(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote) override;
+        int JoinChannel(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) override;
+        int UpdateChannel(const ConnectionOptions& options) override;
+        int LeaveChannel() override;
+        int MuteLocalAudio(bool mute) override;
+        int EnableVolumeIndication(int intervalMs, int smooth) override;
+        int JoinConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options,
+                           IVoiceEngineEvents* events) override;
+        int UpdateConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) override;
+        int LeaveConnection(const std::string& channelName, uint32_t uid) override;
+        int MuteConnectionAudio(const std::string& channelName, uint32_t uid, bool mute) override;
+        int EnableConnectionVolumeIndication(const std::string& channelName, uint32_t uid, int intervalMs, int smooth) override;
+        int CreateDataStream(const std::string& channelName, uint32_t uid, int* streamId) override;
+        int SendStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const char* data, size_t length) override;
+        int EnableLocalAudio(bool enabled) override;
+        int MuteRemoteAudio(uint32_t uid, bool mute) override;
+        int SetRecordingVolume(int volume) override;
+        int SetPlaybackVolume(int volume) override;
+        int SetVoiceEqualization(int band, int gainDb) override;
+        int SetNoiseSuppression(bool enabled, int mode) override;
+        int SetAudioScenario(int scenario) override;
+        int SetClientRole(int role) override;
+        int SetAudioProfile(int profile) override;
+        int SetParameters(const std::string& json) override;
+        int StartEchoTest(int intervalMs) override;
+        int StopEchoTest() override;
+        int StartLastmileProbe(int expectedUplinkKbps, int expectedDownlinkKbps) override;
+        int StopLastmileProbe() override;
+        int SetExternalAudio(bool enabled, int sampleRate, int captureChannels, int playbackChannels) override;
+        int PushAudioFrame(const int16_t* samples, int framesPerChannel, int channels, int sampleRate) override;
+        int PullAudioFrame(int16_t* samples, int framesPerChannel, int channels, int sampleRate) override;
+        int EnumerateAudioDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo>& devices) override;
+        int GetAudioDevice(AudioDeviceKind kind, std::string& deviceId) override;
+        int SetAudioDevice(AudioDeviceKind kind, const std::string& deviceId) override;
+
+        // Faults
+        void FailNext(FakeCall call, int error, int times = 1);
+        void SetJoinDelay(int delayMs);
+        void SetFailureRate(double failureRate);
+
+        // The far side, delivered like SDK callbacks once delayMs has passed. Users stay in
+        // their channel, so joining it later reports them too; volumes, stats and errors
+        // only reach connections that are joined (volumes: with indication enabled).
+        void AddRemoteUser(const std::string& channelName, uint32_t uid, int delayMs = 0);
+        void RemoveRemoteUser(const std::string& channelName, uint32_t uid, int reason = 0, int delayMs = 0);
+        void ReportVolumes(const std::string& channelName, const std::vector<VolumeSample>& speakers, int delayMs = 0);
+        void ReportStats(const std::string& channelName, const ChannelStatsSample& stats, int delayMs = 0);
+        void ReportRemoteAudio(const std::string& channelName, uint32_t uid, const RemoteAudioSample& stats, int delayMs = 0);
+        void RaiseError(const std::string& channelName, int error, int delayMs = 0);
+
+        // Link faults on a joined connection, by channel name (the default channel too).
+        // Drop: RECONNECTING, the SDK retries in place. Restore: the SDK's rejoin, CONNECTED and
+        // onRejoinChannelSuccess; the connection comes back the way it was joined (join options,
+        // unmuted), the worst case the app has to repair. Lose: onConnectionLost. Fail: FAILED
+        // with reason, the SDK gives up and the connection is dead until left.
+        void DropConnection(const std::string& channelName, int delayMs = 0);
+        void RestoreConnection(const std::string& channelName, int delayMs = 0);
+        void LoseConnection(const std::string& channelName, int delayMs = 0);
+        void FailConnection(const std::string& channelName, int reason, int delayMs = 0);
+        // While down, joins end in FAILED (JOIN_FAILED) instead of onJoinChannelSuccess, and
+        // stream messages are lost both ways
+        void SetNetworkDown(bool down);
+
+        // Hot-plug: the device list changes at once, onAudioDeviceStateChanged reaches the default
+        // handler after delayMs. Every kind starts with one built-in device, the system default;
+        // unplugging the device in use falls back to the first one left, as Windows does, and so
+        // does SetAudioDevice with an empty id.
+        void PlugAudioDevice(AudioDeviceKind kind, const AudioDeviceInfo& device, int delayMs = 0);
+        void UnplugAudioDevice(AudioDeviceKind kind, const std::string& deviceId, int delayMs = 0);
+
+        // What the next last-mile probe measures (a clean fibre link until set). With the network
+        // down the probe ends unavailable. Refused while the default channel is joined.
+        void SetLastmileLink(const LastmileProbeResult& link);
+
+        // Runs the registered pipelines on a frame, as the SDK audio thread would
+        bool ProcessCapture(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        bool ProcessPlayback(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        // One remote user's frame before mixing, as received on channelName
+        bool ProcessRemote(const std::string& channelName, uint32_t uid, const int16_t* samples,
+                           int framesPerChannel, int channels, int sampleRate);
+
+        // Runs milliseconds of the audio device: while any connection publishes as broadcaster
+        // the microphone is open and every 10 ms frame (low room noise) goes through the
+        // capture pipeline; uplink grows by the model rate of every joined connection.
+        // Returns the frames captured. Audio thread time, independent of the callback clock.
+        int PumpAudio(int milliseconds);
+
+        // Manual clock: moves time forward and fires everything that became due, in order
+        void AdvanceBy(int milliseconds);
+        int64_t NowMs() const;
+
+        // Inspection
+        bool IsInitialized() const;
+        uint64_t GetCallCount(FakeCall call) const { return m_calls[static_cast<size_t>(call)].load(std::memory_order_relaxed); }
+        uint64_t GetInjectedFailureCount() const { return m_injectedFailures.load(std::memory_order_relaxed); }
+        size_t GetPendingCallbackCount() const;
+        bool FindConnection(const std::string& channelName, ConnectionInfo& info) const;
+        std::vector<std::string> GetConnectionNames() const; // Ex connections only
+        bool IsLocalAudioMuted() const;
+        int GetClientRole() const;
+        int GetAudioScenario() const;
+        int GetRecordingVolume() const;
+        int GetPlaybackVolume() const;
+        int GetAudioProfile() const;
+        std::string GetParameters() const;  // last SetParameters JSON
+        bool IsLastmileProbing() const;
+        uint64_t GetLastmileProbeCount() const { return m_lastmileProbes.load(std::memory_order_relaxed); }
+        bool IsEchoTestRunning() const;
+        bool HasAudioProcessors() const;
+        bool IsLocalAudioEnabled() const;
+        bool IsCapturing() const;           // microphone open (see PumpAudio); never in external audio
+        bool IsExternalAudio() const { return m_externalRate.load(std::memory_order_acquire) != 0; }
+        std::string GetActiveAudioDevice(AudioDeviceKind kind) const;
+        uint64_t GetEnumerationCount() const { return m_enumerations.load(std::memory_order_relaxed); }
+        uint64_t GetPushedFrames() const { return m_pushedFrames.load(std::memory_order_relaxed); }
+        uint64_t GetPulledFrames() const { return m_pulledFrames.load(std::memory_order_relaxed); }
+        int GetPublisherCount() const;      // connections that count as a publisher on the server
+        uint64_t GetCapturedFrames() const { return m_capturedFrames.load(std::memory_order_relaxed); }
+        uint64_t GetUplinkBytes() const { return m_uplinkBits.load(std::memory_order_relaxed) / 8; }
+        uint64_t GetStreamMessagesReceived() const { return m_streamMessagesReceived.load(std::memory_order_relaxed); }
+
+    private:
+        friend class FakeStreamRelay;
+
+        struct Connection
+        {
+            ConnectionInfo info;
+            IVoiceEngineEvents* events = nullptr;
+            ConnectionOptions options;     // as joined, what a rejoin comes back with
+            uint64_t session = 0;          // callbacks scheduled for an older session are dropped
+            int dataStreams = 0;           // stream ids 1..dataStreams are valid until the connection is left
+            int64_t joinedAtMs = 0;        // join call time, for the leave stats
+        };
+
+        // Counts the call, burns callCostUs and applies FailNext/failureRate; returns 0 or the error
+        int Enter(FakeCall call);
+        int64_t NowLocked() const;
+        // Callers hold m_mutex
+        void Schedule(int delayMs, std::function<void()> fire);
+        void ScheduleJoinSuccess(const std::string& channelName, uint64_t session, int delayMs);
+        void ScheduleLeave(IVoiceEngineEvents* events, ChannelStatsSample stats);
+        // Runs fire with the connection's handler once it is due, if the connection is joined by then
+        void ScheduleForConnection(const std::string& channelName, int delayMs,
+                                   std::function<void(IVoiceEngineEvents&)> fire);
+        Connection* Find(const std::string& channelName);
+        const Connection* Find(const std::string& channelName) const;
+        ChannelStatsSample LeaveStats(const Connection& connection) const;
+        // Callers hold m_mutex
+        bool IsPublisherLocked(const Connection& connection) const;
+        int UplinkKbpsLocked() const;
+        // Once due, apply changes the connection under m_mutex; when it returns true fire delivers
+        // the callbacks outside the lock, with a copy of the connection as it is then
+        void ScheduleLinkFault(const std::string& channelName, int delayMs,
+                               std::function<bool(Connection&)> apply, std::function<void(IVoiceEngineEvents&, const Connection&)> fire);
+        // Callers hold m_mutex; onAudioDeviceStateChanged to the default handler once due
+        void ScheduleDeviceState(AudioDeviceKind kind, const std::string& deviceId, int state, int delayMs);
+        // From the relay: one message from uid on channelName, delivered after delayMs if still joined
+        void ReceiveStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const std::string& data, int delayMs);
+        void Fire(std::function<void()>& fire);
+        void CallbackLoop();
+
+        const FakeEngineConfig m_config;
+        const std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+        mutable std::mutex m_mutex;
+        bool m_initialized = false;
+        IVoiceEngineEvents* m_events = nullptr;
+        Connection m_default;
+        bool m_defaultActive = false;
+        std::map<std::string, Connection> m_connections;
+        std::map<std::string, std::vector<uint32_t>> m_remoteUsers;
+        uint64_t m_nextSession = 1;
+        uint32_t m_nextUid = 1000;
+        int m_joinDelayMs;
+        double m_failureRate;
+        std::mt19937 m_random;
+        std::array<std::vector<int>, static_cast<size_t>(FakeCall::Count)> m_failNext;
+        int m_clientRole = 0;
+        int m_audioScenario = 0;
+        int m_recordingVolume = 100;
+        int m_playbackVolume = 100;
+        bool m_echoTestRunning = false;
+        bool m_localAudioEnabled = true;
+        bool m_networkDown = false;
+        int m_audioProfile = 0;
+        std::string m_parameters;
+        LastmileProbeResult m_lastmileLink;
+        uint64_t m_lastmileSession = 0;              // 0 = no probe running
+        std::pair<int64_t, uint64_t> m_lastmileDue;  // its result on the timeline
+        uint32_t m_noise = 1;                        // room-noise generator, PumpAudio only
+        std::array<std::vector<AudioDeviceInfo>, 2> m_devices; // by AudioDeviceKind
+        std::array<std::string, 2> m_activeDevices;
+
+        std::atomic<AudioPipeline*> m_capture{ nullptr };
+        std::atomic<AudioPipeline*> m_playback{ nullptr };
+        std::atomic<IRemoteAudioSink*> m_remote{ nullptr };
+
+        std::array<std::atomic<uint64_t>, static_cast<size_t>(FakeCall::Count)> m_calls;
+        std::atomic<uint64_t> m_injectedFailures{ 0 };
+        std::atomic<uint64_t> m_capturedFrames{ 0 };
+        std::atomic<uint64_t> m_uplinkBits{ 0 };
+        std::atomic<uint64_t> m_streamMessagesReceived{ 0 };
+        std::atomic<uint64_t> m_enumerations{ 0 };
+        std::atomic<uint64_t> m_lastmileProbes{ 0 };
+
+        // External audio format, 0 rate while off; Push and Pull run on the pump thread without
+        // m_mutex, the loopback ring is only replaced while the pump is stopped
+        std::atomic<int> m_externalRate{ 0 };
+        std::atomic<int> m_externalCaptureChannels{ 0 };
+        std::atomic<int> m_externalPlaybackChannels{ 0 };
+        std::unique_ptr<AudioFrameRing> m_loopback;
+        std::atomic<uint64_t> m_pushedFrames{ 0 };
+        std::atomic<uint64_t> m_pulledFrames{ 0 };
+
+        // Timeline of callbacks, ordered by due time then scheduling order
+        std::multimap<std::pair<int64_t, uint64_t>, std::function<void()>> m_timeline;
+        uint64_t m_sequence = 0;
+        int64_t m_manualNowMs = 0;
+
+        std::mutex m_fireMutex; // held while a callback runs; Release() waits on it
+        std::condition_variable m_wake;
+        bool m_running = true;
+        std::thread m_callbackThread;
+    };
+}
@@ -0,0 +1,627 @@
+#include "FloorControl.h"
+#include "CallSignaling.h"
+#include <algorithm>
+#include <cstring>
+
+namespace winrt::FinalProject::implementation
+{
+    static constexpr const char* kVersion = "fl1";
+    static constexpr size_t kFieldCount = 9;
+
+    const char* FloorStateName(FloorState state)
+    {
+        switch (state) {
+            case FloorState::Idle: return "idle";
+            case FloorState::Requesting: return "requesting";
+            case FloorState::Granted: return "granted";
+            case FloorState::Taken: return "taken";
+        }
+        return "unknown";
+    }
+
+    const char* FloorReasonName(FloorReason reason)
+    {
+        switch (reason) {
+            case FloorReason::None: return "none";
+            case FloorReason::Granted: return "granted";
+            case FloorReason::Released: return "released";
+            case FloorReason::Busy: return "busy";
+            case FloorReason::Preempted: return "preempted";
+            case FloorReason::Expired: return "expired";
+            case FloorReason::NoAnswer: return "noAnswer";
+            case FloorReason::HolderLost: return "holderLost";
+            case FloorReason::Offline: return "offline";
+        }
+        return "unknown";
+    }
+
+    static const char* MessageTypeName(FloorMessageType type)
+    {
+        switch (type) {
+            case FloorMessageType::Hello: return "hello";
+            case FloorMessageType::Request: return "request";
+            case FloorMessageType::Grant: return "grant";
+            case FloorMessageType::Deny: return "deny";
+            case FloorMessageType::Revoke: return "revoke";
+            case FloorMessageType::Release: return "release";
+            case FloorMessageType::Bye: return "bye";
+        }
+        return "unknown";
+    }
+
+    static bool ParseMessageType(const std::string& name, FloorMessageType& type)
+    {
+        for (FloorMessageType candidate : { FloorMessageType::Hello, FloorMessageType::Request, FloorMessageType::Grant,
+                                            FloorMessageType::Deny, FloorMessageType::Revoke, FloorMessageType::Release,
+                                            FloorMessageType::Bye }) {
+            if (name == MessageTypeName(candidate)) {
+                type = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool ParseNumber(const std::string& field, uint64_t max, uint64_t& value)
+    {
+        if (field.empty() || field.size() > 20) return false;
+        uint64_t result = 0;
+        for (char c : field) {
+            if (c < '0' || c > '9') return false;
+            uint64_t digit = static_cast<uint64_t>(c - '0');
+            if (result > (max - digit) / 10) return false;
+            result = result * 10 + digit;
+        }
+        value = result;
+        return true;
+    }
+
+    void FloorControl::SetLocalUser(const std::string& userId, uint64_t nowMs, FloorOutput& out)
+    {
+        if (userId == m_localUser) return;
+        LeaveAll(nowMs, out);
+        m_localUser = userId;
+    }
+
+    void FloorControl::Join(const std::string& channelName, uint64_t nowMs, FloorOutput& out)
+    {
+        if (m_localUser.empty() || channelName.empty() || IsJoined(channelName)) return;
+
+        Channel& channel = m_channels[channelName];
+        channel.name = channelName;
+        channel.joinedMs = nowMs;
+        SendHello(channel, true, nowMs, out);
+    }
+
+    void FloorControl::Leave(const std::string& channelName, uint64_t nowMs, FloorOutput& out)
+    {
+        (void)nowMs;
+        auto it = m_channels.find(channelName);
+        if (it == m_channels.end()) return;
+
+        Channel& channel = it->second;
+        FloorMessage message;
+        message.channelName = channelName;
+        message.fromUser = m_localUser;
+        bool held = channel.holder == m_localUser;
+        if (held) {
+            // The others may key at once instead of after a member timeout
+            message.type = FloorMessageType::Release;
+            message.holder = m_localUser;
+            message.epoch = channel.epoch;
+            out.messages.push_back(Encode(message));
+        }
+        message.type = FloorMessageType::Bye;
+        message.holder.clear();
+        message.epoch = 0;
+        out.messages.push_back(Encode(message));
+
+        if (channel.reportedState != FloorState::Idle) {
+            FloorChange change;
+            change.channelName = channelName;
+            change.reason = held ? FloorReason::Released : FloorReason::None;
+            out.changes.push_back(change);
+        }
+        m_channels.erase(it);
+    }
+
+    void FloorControl::LeaveAll(uint64_t nowMs, FloorOutput& out)
+    {
+        for (const std::string& channelName : GetChannels()) Leave(channelName, nowMs, out);
+    }
+
+    std::vector<std::string> FloorControl::GetChannels() const
+    {
+        std::vector<std::string> channels;
+        channels.reserve(m_channels.size());
+        for (const auto& entry : m_channels) channels.push_back(entry.first);
+        return channels;
+    }
+
+    void FloorControl::Request(const std::string& channelName, int priority, uint64_t nowMs, FloorOutput& out)
+    {
+        auto it = m_channels.find(channelName);
+        if (it == m_channels.end()) return;
+
+        Channel& channel = it->second;
+        if (channel.holder == m_localUser) {
+            Report(channel, FloorReason::Granted, true, 0, out);
+            return;
+        }
+        if (channel.requesting) return; // a second press while the first is out
+
+        channel.requesting = true;
+        channel.requestId = m_nextRequestId++;
+        if (m_nextRequestId == 0) m_nextRequestId = 1;
+        channel.requestPriority = std::max(0, std::min(kMaxPriority, priority));
+        channel.requestedMs = nowMs;
+        Report(channel, FloorReason::None, false, 0, out);
+        SendRequest(channel, nowMs, out);
+    }
+
+    void FloorControl::Release(const std::string& channelName, uint64_t nowMs, FloorOutput& out)
+    {
+        auto it = m_channels.find(channelName);
+        if (it == m_channels.end()) return;
+
+        Channel& channel = it->second;
+        bool wasRequesting = channel.requesting;
+        channel.requesting = false;
+        if (channel.waitingUser == m_localUser) channel.waitingUser.clear();
+
+        if (channel.holder == m_localUser) {
+            FloorMessage release;
+            release.type = FloorMessageType::Release;
+            release.holder = m_localUser;
+            release.epoch = channel.epoch;
+            Send(channel, release, nowMs, out);
+        } else if (wasRequesting) {
+            // A grant still on its way is handed straight back (see ApplyGrant)
+            Report(channel, FloorReason::None, false, 0, out);
+        }
+    }
+
+    bool FloorControl::Holds(const std::string& channelName) const
+    {
+        auto it = m_channels.find(channelName);
+        return it != m_channels.end() && !m_localUser.empty() && it->second.holder == m_localUser;
+    }
+
+    FloorState FloorControl::GetState(const std::string& channelName) const
+    {
+        auto it = m_channels.find(channelName);
+        return it == m_channels.end() ? FloorState::Idle : StateOf(it->second);
+    }
+
+    std::string FloorControl::GetHolder(const std::string& channelName) const
+    {
+        auto it = m_channels.find(channelName);
+        return it == m_channels.end() ? std::string() : it->second.holder;
+    }
+
+    std::string FloorControl::GetArbiter(const std::string& channelName) const
+    {
+        auto it = m_channels.find(channelName);
+        return it == m_channels.end() ? std::string() : ArbiterOf(it->second);
+    }
+
+    void FloorControl::OnMessage(const char* data, size_t length, uint64_t nowMs, FloorOutput& out)
+    {
+        FloorMessage message;
+        if (m_localUser.empty() || !Decode(data, length, message) || message.fromUser == m_localUser) return;
+        Handle(message, nowMs, out);
+    }
+
+    void FloorControl::Tick(uint64_t nowMs, FloorOutput& out)
+    {
+        for (auto& entry : m_channels) {
+            Channel& channel = entry.second;
+
+            if (nowMs - channel.lastHelloMs >= static_cast<uint64_t>(m_policy.helloMs)) {
+                SendHello(channel, false, nowMs, out);
+            }
+
+            for (auto it = channel.members.begin(); it != channel.members.end();) {
+                if (nowMs - it->second < static_cast<uint64_t>(m_policy.memberTimeoutMs)) {
+                    ++it;
+                    continue;
+                }
+                std::string user = it->first;
+                it = channel.members.erase(it);
+                if (channel.waitingUser == user) channel.waitingUser.clear();
+                if (channel.holder == user) ClearHolder(channel, FloorReason::HolderLost, out);
+            }
+
+            // Leases: the holder stops itself; the others give it a little longer before they stop waiting
+            if (!channel.holder.empty()) {
+                uint64_t heldMs = nowMs - channel.heldSinceMs;
+                if (channel.holder == m_localUser && heldMs >= static_cast<uint64_t>(m_policy.maxTalkMs)) {
+                    FloorMessage release;
+                    release.type = FloorMessageType::Release;
+                    release.channelName = channel.name;
+                    release.fromUser = m_localUser;
+                    release.holder = m_localUser;
+                    release.epoch = channel.epoch;
+                    out.messages.push_back(Encode(release));
+                    ClearHolder(channel, FloorReason::Expired, out);
+                } else if (channel.holder != m_localUser &&
+                           heldMs >= static_cast<uint64_t>(m_policy.maxTalkMs + m_policy.leaseGraceMs)) {
+                    ClearHolder(channel, FloorReason::Expired, out);
+                }
+            }
+
+            if (!channel.waitingUser.empty() && IsArbiter(channel, nowMs)) {
+                if (nowMs - channel.revokedMs >= static_cast<uint64_t>(m_policy.revokeTimeoutMs)) {
+                    // The revoked holder never answered: gone, or its release was lost. The higher
+                    // epoch silences it wherever it still talks.
+                    Grant(channel, channel.waitingUser, channel.waitingPriority, channel.waitingRequest, nowMs, out);
+                } else if (channel.holder.empty()) {
+                    Grant(channel, channel.waitingUser, channel.waitingPriority, channel.waitingRequest, nowMs, out);
+                }
+            }
+
+            if (channel.requesting) {
+                if (nowMs - channel.requestedMs >= static_cast<uint64_t>(m_policy.requestTimeoutMs)) {
+                    channel.requesting = false;
+                    Report(channel, FloorReason::NoAnswer, true, 0, out);
+                } else if (nowMs - channel.lastSentMs >= static_cast<uint64_t>(m_policy.retryMs) || IsArbiter(channel, nowMs)) {
+                    SendRequest(channel, nowMs, out);
+                }
+            }
+        }
+    }
+
+    bool FloorControl::IsArbiter(const Channel& channel, uint64_t nowMs) const
+    {
+        return nowMs - channel.joinedMs >= static_cast<uint64_t>(m_policy.settleMs) && ArbiterOf(channel) == m_localUser;
+    }
+
+    std::string FloorControl::ArbiterOf(const Channel& channel) const
+    {
+        std::string arbiter = m_localUser;
+        for (const auto& member : channel.members) {
+            if (member.first < arbiter) arbiter = member.first;
+        }
+        return arbiter;
+    }
+
+    FloorState FloorControl::StateOf(const Channel& channel) const
+    {
+        if (!channel.holder.empty() && channel.holder == m_localUser) return FloorState::Granted;
+        if (channel.requesting) return FloorState::Requesting;
+        return channel.holder.empty() ? FloorState::Idle : FloorState::Taken;
+    }
+
+    // Remote messages, and our own that concern us (a grant we gave, a release we sent)
+    void FloorControl::Handle(const FloorMessage& message, uint64_t nowMs, FloorOutput& out)
+    {
+        auto it = m_channels.find(message.channelName);
+        if (it == m_channels.end()) return;
+
+        Channel& channel = it->second;
+        if (message.fromUser != m_localUser) {
+            if (message.type == FloorMessageType::Bye) {
+                channel.members.erase(message.fromUser);
+                if (channel.waitingUser == message.fromUser) channel.waitingUser.clear();
+                if (channel.holder == message.fromUser) ClearHolder(channel, FloorReason::HolderLost, out);
+                return;
+            }
+            channel.members[message.fromUser] = nowMs;
+        }
+
+        switch (message.type) {
+            case FloorMessageType::Hello:
+                if (message.requestId != 0) SendHello(channel, false, nowMs, out);
+                // Catch up on a grant or a release we missed
+                if (message.epoch > channel.epoch && !message.holder.empty()) {
+                    FloorMessage grant = message;
+                    grant.type = FloorMessageType::Grant;
+                    ApplyGrant(channel, grant, nowMs, out);
+                } else if (message.epoch >= channel.epoch && message.holder.empty() && channel.holder == message.fromUser) {
+                    channel.epoch = message.epoch;
+                    ClearHolder(channel, FloorReason::Released, out);
+                }
+                break;
+
+            case FloorMessageType::Request:
+                // Sent to whoever the requester thinks arbitrates; it asks again until someone answers
+                if (message.toUser == m_localUser && IsArbiter(channel, nowMs)) {
+                    Arbitrate(channel, message.fromUser, std::max(0, std::min(kMaxPriority, message.priority)),
+                              message.requestId, nowMs, out);
+                }
+                break;
+
+            case FloorMessageType::Grant:
+                ApplyGrant(channel, message, nowMs, out);
+                break;
+
+            case FloorMessageType::Deny:
+                if (message.toUser != m_localUser || !channel.requesting || message.requestId != channel.requestId) break;
+                channel.requesting = false;
+                if (message.epoch > channel.epoch && !message.holder.empty()) {
+                    FloorMessage grant = message;
+                    grant.type = FloorMessageType::Grant;
+                    ApplyGrant(channel, grant, nowMs, out);
+                }
+                Report(channel, FloorReason::Busy, true, 0, out);
+                break;
+
+            case FloorMessageType::Revoke: {
+                if (message.toUser != m_localUser) break;
+                // Answered even when we already let go: the arbiter waits for this release
+                FloorMessage release;
+                release.type = FloorMessageType::Release;
+                release.channelName = channel.name;
+                release.fromUser = m_localUser;
+                release.holder = m_localUser;
+                release.epoch = message.epoch;
+                out.messages.push_back(Encode(release));
+                if (channel.holder == m_localUser && channel.epoch == message.epoch) {
+                    ClearHolder(channel, FloorReason::Preempted, out);
+                }
+                break;
+            }
+
+            case FloorMessageType::Release:
+                if (!channel.holder.empty() && message.holder == channel.holder && message.epoch == channel.epoch) {
+                    ClearHolder(channel, FloorReason::Released, out);
+                }
+                if (channel.holder.empty() && !channel.waitingUser.empty() && IsArbiter(channel, nowMs)) {
+                    Grant(channel, channel.waitingUser, channel.waitingPriority, channel.waitingRequest, nowMs, out);
+                }
+                break;
+
+            case FloorMessageType::Bye:
+                break;
+        }
+    }
+
+    void FloorControl::Arbitrate(Channel& channel, const std::string& user, int priority, uint32_t requestId,
+                                 uint64_t nowMs, FloorOutput& out)
+    {
+        FloorMessage answer;
+        answer.toUser = user;
+        answer.requestId = requestId;
+
+        if (channel.holder == user) {
+            // A resend: our grant was lost or is still on its way
+            answer.type = FloorMessageType::Grant;
+            answer.toUser.clear();
+            answer.holder = user;
+            answer.priority = channel.holderPriority;
+            answer.epoch = channel.epoch;
+            Send(channel, answer, nowMs, out);
+            return;
+        }
+
+        if (!channel.waitingUser.empty()) {
+            if (channel.waitingUser == user) return; // already revoking for it
+            if (priority > channel.waitingPriority) {
+                // Outranks the preemption in progress: that one is told busy, this one waits instead
+                std::swap(answer.toUser, channel.waitingUser);
+                std::swap(answer.requestId, channel.waitingRequest);
+                channel.waitingPriority = priority;
+            }
+            answer.type = FloorMessageType::Deny;
+            answer.holder = channel.holder;
+            answer.priority = channel.holderPriority;
+            answer.epoch = channel.epoch;
+            Send(channel, answer, nowMs, out);
+            return;
+        }
+
+        if (channel.holder.empty()) {
+            Grant(channel, user, priority, requestId, nowMs, out);
+            return;
+        }
+
+        if (priority > channel.holderPriority) {
+            if (channel.holder == m_localUser) {
+                // We talk and arbitrate: stop here, then hand it over
+                FloorMessage release;
+                release.type = FloorMessageType::Release;
+                release.channelName = channel.name;
+                release.fromUser = m_localUser;
+                release.holder = m_localUser;
+                release.epoch = channel.epoch;
+                out.messages.push_back(Encode(release));
+                ClearHolder(channel, FloorReason::Preempted, out);
+                Grant(channel, user, priority, requestId, nowMs, out);
+                return;
+            }
+
+            // The old talker is silenced first; the grant follows its release (or the revoke timeout)
+            channel.waitingUser = user;
+            channel.waitingPriority = priority;
+            channel.waitingRequest = requestId;
+            channel.revokedMs = nowMs;
+            answer.type = FloorMessageType::Revoke;
+            answer.toUser = channel.holder;
+            answer.holder = channel.holder;
+            answer.priority = channel.holderPriority;
+            answer.epoch = channel.epoch;
+            Send(channel, answer, nowMs, out);
+            return;
+        }
+
+        answer.type = FloorMessageType::Deny;
+        answer.holder = channel.holder;
+        answer.priority = channel.holderPriority;
+        answer.epoch = channel.epoch;
+        Send(channel, answer, nowMs, out);
+    }
+
+    void FloorControl::Grant(Channel& channel, const std::string& user, int priority, uint32_t requestId,
+                             uint64_t nowMs, FloorOutput& out)
+    {
+        FloorMessage grant;
+        grant.type = FloorMessageType::Grant;
+        grant.holder = user; // before the clear: user may be the waiting one itself
+        channel.waitingUser.clear();
+        grant.priority = priority;
+        grant.epoch = channel.epoch + 1;
+        grant.requestId = requestId;
+        Send(channel, grant, nowMs, out);
+    }
+
+    void FloorControl::ApplyGrant(Channel& channel, const FloorMessage& message, uint64_t nowMs, FloorOutput& out)
+    {
+        if (message.epoch < channel.epoch) return;
+        if (message.epoch == channel.epoch) {
+            if (message.holder == channel.holder) return;
+            if (!channel.holder.empty()) {
+                // Two arbiters (members still learning about each other) gave out the same epoch:
+                // the higher priority, then the lower user id keeps it - the same call on every client
+                bool keep = channel.holderPriority > message.priority ||
+                            (channel.holderPriority == message.priority && channel.holder < message.holder);
+                if (keep) return;
+            }
+        }
+
+        bool wasOurs = channel.holder == m_localUser;
+        channel.holder = message.holder;
+        channel.holderPriority = message.priority;
+        channel.epoch = message.epoch;
+        channel.heldSinceMs = nowMs;
+
+        if (message.holder != m_localUser) {
+            Report(channel, wasOurs ? FloorReason::Preempted : FloorReason::None, wasOurs, 0, out);
+            return;
+        }
+
+        if (!channel.requesting) {
+            // The request crossed our key-down: hand it straight back
+            FloorMessage release;
+            release.type = FloorMessageType::Release;
+            release.holder = m_localUser;
+            release.epoch = channel.epoch;
+            Send(channel, release, nowMs, out);
+            return;
+        }
+        channel.requesting = false;
+        Report(channel, FloorReason::Granted, true, nowMs - channel.requestedMs, out);
+    }
+
+    void FloorControl::ClearHolder(Channel& channel, FloorReason reason, FloorOutput& out)
+    {
+        channel.holder.clear();
+        channel.holderPriority = 0;
+        Report(channel, reason, false, 0, out);
+    }
+
+    void FloorControl::SendRequest(Channel& channel, uint64_t nowMs, FloorOutput& out)
+    {
+        channel.lastSentMs = nowMs;
+        if (IsArbiter(channel, nowMs)) {
+            Arbitrate(channel, m_localUser, channel.requestPriority, channel.requestId, nowMs, out);
+            return;
+        }
+
+        std::string arbiter = ArbiterOf(channel);
+        if (arbiter == m_localUser) return; // ours once settled; Tick asks again
+
+        FloorMessage request;
+        request.type = FloorMessageType::Request;
+        request.toUser = arbiter;
+        request.priority = channel.requestPriority;
+        request.requestId = channel.requestId;
+        Send(channel, request, nowMs, out);
+    }
+
+    void FloorControl::SendHello(Channel& channel, bool wantReply, uint64_t nowMs, FloorOutput& out)
+    {
+        channel.lastHelloMs = nowMs;
+
+        FloorMessage hello;
+        hello.type = FloorMessageType::Hello;
+        hello.holder = channel.holder;
+        hello.priority = channel.holderPriority;
+        hello.epoch = channel.epoch;
+        hello.requestId = wantReply ? 1 : 0;
+        Send(channel, hello, nowMs, out);
+    }
+
+    // To the lobby unless it is for us alone; grants, releases and answers to us are applied here too,
+    // the stream never hands us our own messages
+    void FloorControl::Send(Channel& channel, FloorMessage message, uint64_t nowMs, FloorOutput& out)
+    {
+        message.channelName = channel.name;
+        message.fromUser = m_localUser;
+        if (message.toUser != m_localUser) out.messages.push_back(Encode(message));
+
+        bool forUs = message.toUser.empty() || message.toUser == m_localUser;
+        if (forUs && message.type != FloorMessageType::Hello && message.type != FloorMessageType::Bye) {
+            Handle(message, nowMs, out);
+        }
+    }
+
+    void FloorControl::Report(Channel& channel, FloorReason reason, bool always, uint64_t waitedMs, FloorOutput& out)
+    {
+        FloorState state = StateOf(channel);
+        if (!always && state == channel.reportedState && channel.holder == channel.reportedHolder) return;
+
+        channel.reportedState = state;
+        channel.reportedHolder = channel.holder;
+
+        FloorChange change;
+        change.channelName = channel.name;
+        change.state = state;
+        change.reason = reason;
+        change.holder = channel.holder;
+        change.priority = channel.holderPriority;
+        change.waitedMs = waitedMs;
+        out.changes.push_back(std::move(change));
+    }
+
+    bool FloorControl::IsFloorMessage(const char* data, size_t length)
+    {
+        return data && length > 4 && std::memcmp(data, "fl1|", 4) == 0;
+    }
+
+    std::string FloorControl::Encode(const FloorMessage& message)
+    {
+        std::string encoded = kVersion;
+        encoded += '|';
+        encoded += MessageTypeName(message.type);
+        for (const std::string* field : { &message.channelName, &message.fromUser, &message.toUser, &message.holder }) {
+            encoded += '|';
+            AppendSignalField(encoded, *field);
+        }
+        encoded += '|';
+        encoded += std::to_string(message.priority);
+        encoded += '|';
+        encoded += std::to_string(message.epoch);
+        encoded += '|';
+        encoded += std::to_string(message.requestId);
+        return encoded;
+    }
+
+    bool FloorControl::Decode(const char* data, size_t length, FloorMessage& message)
+    {
+        if (!data || length == 0 || length > kMaxMessageBytes) return false;
+
+        std::vector<std::string> fields;
+        fields.reserve(kFieldCount);
+        SplitSignalFields(data, length, fields);
+        if (fields.size() != kFieldCount || fields[0] != kVersion) return false;
+
+        FloorMessage decoded;
+        uint64_t priority = 0;
+        uint64_t requestId = 0;
+        if (!ParseMessageType(fields[1], decoded.type)) return false;
+        if (!UnescapeSignalField(fields[2], decoded.channelName) || !UnescapeSignalField(fields[3], decoded.fromUser) ||
+            !UnescapeSignalField(fields[4], decoded.toUser) || !UnescapeSignalField(fields[5], decoded.holder)) {
+            return false;
+        }
+        if (!ParseNumber(fields[6], kMaxPriority, priority) || !ParseNumber(fields[7], UINT64_MAX, decoded.epoch) ||
+            !ParseNumber(fields[8], 0xFFFFFFFFull, requestId)) {
+            return false;
+        }
+        if (decoded.channelName.empty() || decoded.fromUser.empty()) return false;
+
+        decoded.priority = static_cast<int>(priority);
+        decoded.requestId = static_cast<uint32_t>(requestId);
+        message = std::move(decoded);
+        return true;
+    }
+}
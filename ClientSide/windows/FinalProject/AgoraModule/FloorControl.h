@@ -0,0 +1,186 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// Push-to-talk floor arbitration, so two operators never key the same radio at once.
+// Messages ride the signaling lobby's ordered data stream (see CallSignaling.h): a radio's own
+// connection is audience for everyone listening and may not send stream messages, the lobby may.
+// Every client with floor control on a radio says hello there periodically, and the member
+// with the lowest user id arbitrates that radio. Requests go to the arbiter, which grants,
+// denies (busy), or preempts a lower priority holder - revoking it first, so the old talker
+// is muted before the new one is keyed. Grants carry an epoch; a holder gives the floor up at
+// the end of its lease and the members drop a holder that goes quiet. Pure logic with the time
+// passed in; the core runs it on the command worker and sends what it produces.
+namespace winrt::FinalProject::implementation
+{
+    enum class FloorMessageType : uint8_t
+    {
+        Hello = 1,  // membership and the floor as the sender sees it; periodic
+        Request,    // to the arbiter
+        Grant,      // from the arbiter, to everyone
+        Deny,       // from the arbiter, to the requester
+        Revoke,     // from the arbiter, to a holder being preempted
+        Release,    // from the holder (or for it), to everyone
+        Bye,        // left the radio
+    };
+
+    enum class FloorState : uint8_t
+    {
+        Idle,        // nobody talks
+        Requesting,  // we asked the arbiter
+        Granted,     // we hold the floor: the microphone may open
+        Taken,       // someone else holds it
+    };
+
+    enum class FloorReason : uint8_t
+    {
+        None,
+        Granted,
+        Released,    // the holder let go
+        Busy,        // denied: someone with the same or a higher priority talks
+        Preempted,   // revoked for a higher priority request
+        Expired,     // the lease ran out
+        NoAnswer,    // the arbiter never answered
+        HolderLost,  // the holder left or went quiet
+        Offline,     // not connected to the lobby (reported by the core)
+    };
+
+    const char* FloorStateName(FloorState state);
+    const char* FloorReasonName(FloorReason reason);
+
+    struct FloorMessage
+    {
+        FloorMessageType type = FloorMessageType::Hello;
+        std::string channelName;
+        std::string fromUser;
+        std::string toUser;        // "" = everyone
+        std::string holder;        // grant, release, deny, hello: whose floor it is about
+        int priority = 0;          // request: the requester's; otherwise the holder's
+        uint64_t epoch = 0;        // grant number on this radio
+        uint32_t requestId = 0;    // request, grant, deny; hello: 1 = please say hello back
+    };
+
+    // Every client on a radio must use the same values
+    struct FloorPolicy
+    {
+        int maxTalkMs = 60000;       // lease: the holder lets go after this long
+        int leaseGraceMs = 1000;     // the others drop a holder this long after its lease
+        int retryMs = 150;           // an unanswered request goes out again
+        int requestTimeoutMs = 1500; // and is given up after this
+        int revokeTimeoutMs = 500;   // preempting: a holder that never lets go is overridden
+        int helloMs = 1000;
+        int memberTimeoutMs = 3500;  // a member heard from for this long is gone
+        int settleMs = 300;          // after joining: hear the others before arbitrating
+    };
+
+    struct FloorChange
+    {
+        std::string channelName;
+        FloorState state = FloorState::Idle;
+        FloorReason reason = FloorReason::None;
+        std::string holder;          // "" when idle
+        int priority = 0;            // the holder's
+        uint64_t waitedMs = 0;       // request to grant, when granted
+    };
+
+    // What one call produced: messages for the lobby, changes for the app
+    struct FloorOutput
+    {
+        std::vector<std::string> messages;
+        std::vector<FloorChange> changes;
+    };
+
+    class FloorControl
+    {
+    public:
+        static constexpr size_t kMaxMessageBytes = 512;
+        static constexpr int kMaxPriority = 9;
+
+        void SetPolicy(const FloorPolicy& policy) { m_policy = policy; }
+        const FloorPolicy& GetPolicy() const { return m_policy; }
+
+        // A different user leaves every radio first
+        void SetLocalUser(const std::string& userId, uint64_t nowMs, FloorOutput& out);
+        const std::string& GetLocalUser() const { return m_localUser; }
+
+        void Join(const std::string& channelName, uint64_t nowMs, FloorOutput& out);
+        void Leave(const std::string& channelName, uint64_t nowMs, FloorOutput& out);
+        void LeaveAll(uint64_t nowMs, FloorOutput& out);
+        bool IsJoined(const std::string& channelName) const { return m_channels.count(channelName) != 0; }
+        std::vector<std::string> GetChannels() const;
+
+        // Key up and down. Granted (or not) arrives as a change, at once when we arbitrate.
+        void Request(const std::string& channelName, int priority, uint64_t nowMs, FloorOutput& out);
+        void Release(const std::string& channelName, uint64_t nowMs, FloorOutput& out);
+
+        bool Holds(const std::string& channelName) const;
+        FloorState GetState(const std::string& channelName) const;
+        std::string GetHolder(const std::string& channelName) const;
+        std::string GetArbiter(const std::string& channelName) const;
+
+        void OnMessage(const char* data, size_t length, uint64_t nowMs, FloorOutput& out);
+        // Hellos, retries, leases and timeouts; every few tens of milliseconds while joined
+        void Tick(uint64_t nowMs, FloorOutput& out);
+
+        // fl1|type|channel|from|to|holder|priority|epoch|request, fields %-escaped
+        static bool IsFloorMessage(const char* data, size_t length);
+        static std::string Encode(const FloorMessage& message);
+        static bool Decode(const char* data, size_t length, FloorMessage& message);
+
+    private:
+        struct Channel
+        {
+            std::string name;
+            uint64_t joinedMs = 0;
+            uint64_t lastHelloMs = 0;
+            std::map<std::string, uint64_t> members; // the others -> last heard
+
+            // The floor as we know it
+            std::string holder;
+            int holderPriority = 0;
+            uint64_t epoch = 0;
+            uint64_t heldSinceMs = 0;  // when we saw the grant
+
+            // Our request
+            bool requesting = false;
+            uint32_t requestId = 0;
+            int requestPriority = 0;
+            uint64_t requestedMs = 0;
+            uint64_t lastSentMs = 0;
+
+            // Arbiter: a preemption waiting for the old holder to let go
+            std::string waitingUser;
+            int waitingPriority = 0;
+            uint32_t waitingRequest = 0;
+            uint64_t revokedMs = 0;
+
+            // What the app was last told
+            FloorState reportedState = FloorState::Idle;
+            std::string reportedHolder;
+        };
+
+        bool IsArbiter(const Channel& channel, uint64_t nowMs) const;
+        std::string ArbiterOf(const Channel& channel) const;
+        FloorState StateOf(const Channel& channel) const;
+
+        void Handle(const FloorMessage& message, uint64_t nowMs, FloorOutput& out);
+        void Arbitrate(Channel& channel, const std::string& user, int priority, uint32_t requestId,
+                       uint64_t nowMs, FloorOutput& out);
+        void Grant(Channel& channel, const std::string& user, int priority, uint32_t requestId,
+                   uint64_t nowMs, FloorOutput& out);
+        void ApplyGrant(Channel& channel, const FloorMessage& message, uint64_t nowMs, FloorOutput& out);
+        void ClearHolder(Channel& channel, FloorReason reason, FloorOutput& out);
+        void SendRequest(Channel& channel, uint64_t nowMs, FloorOutput& out);
+        void SendHello(Channel& channel, bool wantReply, uint64_t nowMs, FloorOutput& out);
+        void Send(Channel& channel, FloorMessage message, uint64_t nowMs, FloorOutput& out);
+        void Report(Channel& channel, FloorReason reason, bool always, uint64_t waitedMs, FloorOutput& out);
+
+        FloorPolicy m_policy;
+        std::string m_localUser;
+        uint32_t m_nextRequestId = 1;
+        std::map<std::string, Channel> m_channels;
+    };
+}
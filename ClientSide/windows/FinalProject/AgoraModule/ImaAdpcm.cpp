@@ -0,0 +1,76 @@
+#include "ImaAdpcm.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr int16_t kStepTable[89] = {
+            7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+            50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+            337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+            2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+            15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767,
+        };
+
+        constexpr int8_t kIndexTable[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+
+        // Applies one 4-bit code to the state, returns the reconstructed sample
+        inline int16_t Step(uint8_t code, int& predictor, int& index)
+        {
+            int step = kStepTable[index];
+            int diff = step >> 3;
+            if (code & 4) diff += step;
+            if (code & 2) diff += step >> 1;
+            if (code & 1) diff += step >> 2;
+            predictor += (code & 8) ? -diff : diff;
+            predictor = std::max(-32768, std::min(32767, predictor));
+            index = std::max(0, std::min(88, index + kIndexTable[code]));
+            return static_cast<int16_t>(predictor);
+        }
+
+        inline uint8_t Encode(int sample, int& predictor, int& index)
+        {
+            int step = kStepTable[index];
+            int diff = sample - predictor;
+            uint8_t code = 0;
+            if (diff < 0) {
+                code = 8;
+                diff = -diff;
+            }
+            if (diff >= step) { code |= 4; diff -= step; }
+            step >>= 1;
+            if (diff >= step) { code |= 2; diff -= step; }
+            step >>= 1;
+            if (diff >= step) { code |= 1; }
+            // Track exactly what the decoder will see
+            Step(code, predictor, index);
+            return code;
+        }
+    }
+
+    void AdpcmEncode(const int16_t* samples, size_t count, uint8_t* out, AdpcmState& state)
+    {
+        int predictor = state.predictor;
+        int index = state.stepIndex;
+        for (size_t i = 0; i < count; i += 2) {
+            uint8_t low = Encode(samples[i], predictor, index);
+            uint8_t high = i + 1 < count ? Encode(samples[i + 1], predictor, index) : 0;
+            out[i / 2] = static_cast<uint8_t>(low | (high << 4));
+        }
+        state.predictor = static_cast<int16_t>(predictor);
+        state.stepIndex = static_cast<uint8_t>(index);
+    }
+
+    void AdpcmDecode(const uint8_t* in, size_t count, int16_t* samples, AdpcmState& state)
+    {
+        int predictor = state.predictor;
+        int index = std::min<int>(88, state.stepIndex);
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t code = (i & 1) ? static_cast<uint8_t>(in[i / 2] >> 4) : static_cast<uint8_t>(in[i / 2] & 0x0F);
+            samples[i] = Step(code, predictor, index);
+        }
+        state.predictor = static_cast<int16_t>(predictor);
+        state.stepIndex = static_cast<uint8_t>(index);
+    }
+}
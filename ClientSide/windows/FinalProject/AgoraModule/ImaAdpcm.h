@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// IMA ADPCM, 4 bits per sample (4:1 against int16). Plain integer code with no tables to
+// build, so it is cheap enough to run on the audio thread for every remote speaker. The
+// state is carried across calls; store it next to each block to decode blocks on their own.
+namespace winrt::FinalProject::implementation
+{
+    struct AdpcmState
+    {
+        int16_t predictor = 0;
+        uint8_t stepIndex = 0; // 0-88
+    };
+
+    // count samples -> (count + 1) / 2 bytes, low nibble first
+    void AdpcmEncode(const int16_t* samples, size_t count, uint8_t* out, AdpcmState& state);
+    void AdpcmDecode(const uint8_t* in, size_t count, int16_t* samples, AdpcmState& state);
+
+    constexpr size_t AdpcmBytes(size_t samples) { return (samples + 1) / 2; }
+}
@@ -0,0 +1,394 @@
+#include "LatencyProbe.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+
+        constexpr int kChirpMs = 100;
+        constexpr float kChirpStartHz = 300.0f;
+        constexpr float kChirpEndHz = 3400.0f;
+        constexpr int kChirpTaperMs = 5;
+        constexpr int kMlsOrder = 10;
+        constexpr int kMlsSamplesPerChip = 2; // 8 kchip/s: the energy stays inside a wideband codec
+
+        inline int16_t Saturate(int32_t value)
+        {
+            return static_cast<int16_t>(std::clamp(value, -32768, 32767));
+        }
+
+        // Primitive polynomials: x^order + ... + 1, terms listed by exponent
+        const std::vector<int>& MlsTaps(int order)
+        {
+            static const std::vector<int> taps[] = {
+                {}, {}, { 2, 1 }, { 3, 2 }, { 4, 3 }, { 5, 3 }, { 6, 5 }, { 7, 6 }, { 8, 6, 5, 4 },
+                { 9, 5 }, { 10, 7 }, { 11, 9 }, { 12, 11, 10, 4 }, { 13, 12, 11, 8 }, { 14, 13, 12, 2 },
+                { 15, 14 }, { 16, 15, 13, 4 },
+            };
+            return taps[order];
+        }
+
+        // Eight partial sums so the compiler can keep the loop in vector registers
+        double Dot(const float* a, const float* b, size_t length)
+        {
+            float sums[8] = {};
+            size_t i = 0;
+            for (; i + 8 <= length; i += 8) {
+                for (int lane = 0; lane < 8; ++lane) sums[lane] += a[i + lane] * b[i + lane];
+            }
+            double total = 0.0;
+            for (float sum : sums) total += sum;
+            for (; i < length; ++i) total += static_cast<double>(a[i]) * b[i];
+            return total;
+        }
+
+        double Percentile(const std::vector<double>& sorted, double fraction)
+        {
+            // Nearest rank
+            size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(sorted.size())));
+            return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+        }
+    }
+
+    const char* ProbePathName(ProbePath path)
+    {
+        return path == ProbePath::Channel ? "channel" : "device";
+    }
+
+    const char* ProbeSignalName(ProbeSignal signal)
+    {
+        return signal == ProbeSignal::Mls ? "mls" : "chirp";
+    }
+
+    bool ParseProbePath(const char* name, ProbePath& path)
+    {
+        if (!name) return false;
+        if (std::strcmp(name, "device") == 0) path = ProbePath::Device;
+        else if (std::strcmp(name, "channel") == 0) path = ProbePath::Channel;
+        else return false;
+        return true;
+    }
+
+    bool ParseProbeSignal(const char* name, ProbeSignal& signal)
+    {
+        if (!name) return false;
+        if (std::strcmp(name, "chirp") == 0) signal = ProbeSignal::Chirp;
+        else if (std::strcmp(name, "mls") == 0) signal = ProbeSignal::Mls;
+        else return false;
+        return true;
+    }
+
+    // CorrelationDetector
+
+    CorrelationDetector::CorrelationDetector(std::vector<float> reference) : m_reference(std::move(reference))
+    {
+        m_referenceEnergy = Dot(m_reference.data(), m_reference.data(), m_reference.size());
+    }
+
+    CorrelationDetector::Match CorrelationDetector::Find(const float* recording, size_t length, float minScore,
+                                                         float minPeakToSidelobe) const
+    {
+        Match match;
+        const size_t referenceLength = m_reference.size();
+        if (!recording || referenceLength == 0 || length < referenceLength || m_referenceEnergy <= 0.0) {
+            return match;
+        }
+
+        // Energy of every window of the recording, from running sums of squares
+        std::vector<double> energy(length + 1, 0.0);
+        for (size_t i = 0; i < length; ++i) {
+            energy[i + 1] = energy[i] + static_cast<double>(recording[i]) * recording[i];
+        }
+
+        const size_t lags = length - referenceLength + 1;
+        std::vector<float> scores(lags, 0.0f);
+        size_t peak = 0;
+        for (size_t lag = 0; lag < lags; ++lag) {
+            double windowEnergy = energy[lag + referenceLength] - energy[lag];
+            if (windowEnergy <= 1e-12) continue; // digital silence
+            double dot = Dot(m_reference.data(), recording + lag, referenceLength);
+            scores[lag] = static_cast<float>(std::fabs(dot) / std::sqrt(m_referenceEnergy * windowEnergy));
+            if (scores[lag] > scores[peak]) peak = lag;
+        }
+
+        float sidelobe = 0.0f;
+        for (size_t lag = 0; lag < lags; ++lag) {
+            size_t distance = lag > peak ? lag - peak : peak - lag;
+            if (distance > static_cast<size_t>(kGuardSamples)) sidelobe = std::max(sidelobe, scores[lag]);
+        }
+
+        // Parabola through the peak and its neighbours for the sub-sample position
+        double offset = static_cast<double>(peak);
+        if (peak > 0 && peak + 1 < lags) {
+            double left = scores[peak - 1], center = scores[peak], right = scores[peak + 1];
+            double curvature = left - 2.0 * center + right;
+            if (curvature < 0.0) offset += std::clamp(0.5 * (left - right) / curvature, -0.5, 0.5);
+        }
+
+        match.offset = offset;
+        match.score = scores[peak];
+        match.peakToSidelobe = sidelobe > 0.0f ? match.score / sidelobe : 1000.0f;
+        match.found = match.score >= minScore && match.peakToSidelobe >= minPeakToSidelobe;
+        return match;
+    }
+
+    std::vector<float> CorrelationDetector::MakeChirp(int durationMs, float startHz, float endHz)
+    {
+        const size_t length = static_cast<size_t>(std::max(1, durationMs)) * kSampleRate / 1000;
+        const double duration = static_cast<double>(length) / kSampleRate;
+        const size_t taper = std::min(length / 2, static_cast<size_t>(kChirpTaperMs * kSampleRate / 1000));
+
+        std::vector<float> chirp(length);
+        for (size_t i = 0; i < length; ++i) {
+            double t = static_cast<double>(i) / kSampleRate;
+            double phase = 2.0 * kPi * (startHz * t + (endHz - startHz) * t * t / (2.0 * duration));
+            double window = 1.0;
+            size_t edge = std::min(i, length - 1 - i);
+            if (edge < taper) window = 0.5 - 0.5 * std::cos(kPi * static_cast<double>(edge) / taper);
+            chirp[i] = static_cast<float>(std::sin(phase) * window);
+        }
+        return chirp;
+    }
+
+    std::vector<float> CorrelationDetector::MakeMls(int order, int samplesPerChip)
+    {
+        order = std::clamp(order, 2, 16);
+        samplesPerChip = std::max(1, samplesPerChip);
+        const std::vector<int>& taps = MlsTaps(order);
+        const uint32_t chips = (1u << order) - 1;
+
+        // Fibonacci LFSR: the feedback is the XOR of the tapped stages
+        std::vector<float> sequence;
+        sequence.reserve(static_cast<size_t>(chips) * samplesPerChip);
+        uint32_t state = 1;
+        for (uint32_t chip = 0; chip < chips; ++chip) {
+            float value = (state & 1u) ? 1.0f : -1.0f;
+            sequence.insert(sequence.end(), static_cast<size_t>(samplesPerChip), value);
+            uint32_t feedback = 0;
+            for (int tap : taps) feedback ^= state >> (order - tap);
+            state = (state >> 1) | ((feedback & 1u) << (order - 1));
+        }
+        return sequence;
+    }
+
+    void SummarizeLatency(LatencyReport& report)
+    {
+        std::vector<double> latencies;
+        double scoreSum = 0.0;
+        for (const LatencySample& sample : report.samples) {
+            if (!sample.found) continue;
+            latencies.push_back(sample.latencyMs);
+            scoreSum += sample.score;
+        }
+        report.probes = static_cast<int>(report.samples.size());
+        report.found = static_cast<int>(latencies.size());
+        report.minMs = report.p50Ms = report.p95Ms = report.maxMs = report.meanMs = report.jitterMs = 0.0;
+        report.meanScore = 0.0f;
+        if (latencies.empty()) return;
+
+        std::sort(latencies.begin(), latencies.end());
+        double sum = 0.0;
+        for (double latency : latencies) sum += latency;
+        double mean = sum / static_cast<double>(latencies.size());
+        double variance = 0.0;
+        for (double latency : latencies) variance += (latency - mean) * (latency - mean);
+
+        report.minMs = latencies.front();
+        report.maxMs = latencies.back();
+        report.p50Ms = Percentile(latencies, 0.50);
+        report.p95Ms = Percentile(latencies, 0.95);
+        report.meanMs = mean;
+        report.jitterMs = std::sqrt(variance / static_cast<double>(latencies.size()));
+        report.meanScore = static_cast<float>(scoreSum / static_cast<double>(latencies.size()));
+    }
+
+    // LatencyProbe
+
+    uint64_t LatencyProbe::SteadyClockUs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    LatencyProbe::~LatencyProbe()
+    {
+        Replace(nullptr);
+    }
+
+    void LatencyProbe::Start(const LatencyProbeConfig& config)
+    {
+        auto run = std::make_unique<Run>();
+        run->config = config;
+
+        std::vector<float> reference = config.signal == ProbeSignal::Mls
+            ? CorrelationDetector::MakeMls(kMlsOrder, kMlsSamplesPerChip)
+            : CorrelationDetector::MakeChirp(kChirpMs, kChirpStartHz, kChirpEndHz);
+
+        float scale = 32767.0f * std::pow(10.0f, std::min(0.0f, config.levelDb) / 20.0f);
+        run->signal.resize(reference.size());
+        for (size_t i = 0; i < reference.size(); ++i) {
+            run->signal[i] = Saturate(static_cast<int32_t>(std::lround(reference[i] * scale)));
+        }
+
+        // The window has to hold the whole signal on top of the latency
+        int signalMs = static_cast<int>(reference.size() * 1000 / CorrelationDetector::kSampleRate);
+        int windowMs = std::clamp(config.windowMs, std::max(kMinWindowMs, signalMs + 50), kMaxWindowMs);
+        run->config.windowMs = windowMs;
+        run->heard.assign(static_cast<size_t>(windowMs) * CorrelationDetector::kSampleRate / 1000, 0.0f);
+        run->detector = std::make_unique<CorrelationDetector>(std::move(reference));
+
+        m_config = run->config;
+        Replace(run.release());
+    }
+
+    void LatencyProbe::Stop()
+    {
+        Replace(nullptr);
+    }
+
+    void LatencyProbe::Replace(Run* next)
+    {
+        Run* previous = m_run.exchange(next);
+        if (!previous) return;
+
+        // A callback that saw the old run counted itself in before loading it; once the count
+        // has been zero after the exchange, nobody can still hold it. That is a frame at most.
+        while (m_inside.load() != 0) std::this_thread::yield();
+        delete previous;
+    }
+
+    void LatencyProbe::Arm(uint32_t probe)
+    {
+        if (Run* run = m_run.load(std::memory_order_acquire)) {
+            run->armed.store(probe, std::memory_order_release);
+        }
+    }
+
+    bool LatencyProbe::IsCaptured(uint32_t probe) const
+    {
+        Run* run = m_run.load(std::memory_order_acquire);
+        return run && run->captured.load(std::memory_order_acquire) == probe;
+    }
+
+    LatencySample LatencyProbe::Analyze(uint32_t probe) const
+    {
+        LatencySample sample;
+        Run* run = m_run.load(std::memory_order_acquire);
+        if (!run || run->captured.load(std::memory_order_acquire) != probe) return sample;
+
+        CorrelationDetector::Match match = run->detector->Find(run->heard.data(), run->heard.size());
+        sample.found = match.found;
+        sample.score = match.score;
+        if (match.found) {
+            double listenStartMs = static_cast<double>(run->heardStartUs - run->sentUs) / 1000.0;
+            double offsetMs = match.offset * 1000.0 / CorrelationDetector::kSampleRate;
+            sample.latencyMs = listenStartMs + offsetMs - run->config.knownDelayMs;
+        }
+        return sample;
+    }
+
+    bool LatencyProbe::MixCapture(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        return static_cast<LatencyProbe*>(context)->Mix(true, samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool LatencyProbe::MixPlayback(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        return static_cast<LatencyProbe*>(context)->Mix(false, samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool LatencyProbe::Mix(bool capture, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        // Idle costs one atomic load
+        if (!m_run.load(std::memory_order_relaxed) || sampleRate <= 0 || channels < 1) return false;
+
+        m_inside.fetch_add(1);
+        bool wrote = false;
+        if (Run* run = m_run.load()) {
+            bool injectSide = capture == (run->config.path == ProbePath::Channel);
+            if (injectSide) {
+                wrote = Inject(*run, samples, framesPerChannel, channels, sampleRate);
+            } else {
+                Listen(*run, samples, framesPerChannel, channels, sampleRate);
+            }
+        }
+        m_inside.fetch_sub(1);
+        return wrote;
+    }
+
+    bool LatencyProbe::Inject(Run& run, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        uint32_t armed = run.armed.load(std::memory_order_acquire);
+        if (armed != 0 && armed != run.injecting) {
+            run.injecting = armed;
+            run.injectQ16 = 0;
+            run.sentUs = m_clock();
+            run.sent.store(armed, std::memory_order_release);
+        }
+        if (run.injecting == 0) return false;
+
+        bool wrote = false;
+        const size_t count = run.signal.size();
+        const uint64_t step = (static_cast<uint64_t>(CorrelationDetector::kSampleRate) << 16) / static_cast<uint64_t>(sampleRate);
+        for (int frame = 0; frame < framesPerChannel; ++frame) {
+            size_t index = static_cast<size_t>(run.injectQ16 >> 16);
+            if (index >= count) break;
+            int32_t a = run.signal[index];
+            int32_t b = index + 1 < count ? run.signal[index + 1] : 0;
+            int32_t fraction = static_cast<int32_t>(run.injectQ16 & 0xFFFF);
+            int32_t value = a + static_cast<int32_t>((static_cast<int64_t>(b - a) * fraction) >> 16);
+
+            int16_t* out = samples + static_cast<size_t>(frame) * channels;
+            for (int channel = 0; channel < channels; ++channel) {
+                out[channel] = Saturate(out[channel] + value);
+            }
+            run.injectQ16 += step;
+            wrote = true;
+        }
+        return wrote;
+    }
+
+    void LatencyProbe::Listen(Run& run, const int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        uint32_t sent = run.sent.load(std::memory_order_acquire);
+        if (sent != run.listening) {
+            run.listening = sent;
+            run.heardCount = 0;
+            run.heardStartUs = m_clock();
+            run.listenQ16 = 0;
+            run.listenSum = 0;
+            run.listenCount = 0;
+        }
+        const size_t capacity = run.heard.size();
+        if (run.listening == 0 || run.heardCount >= capacity) return;
+
+        // Mono, boxcar-averaged down to the detector's rate (exact for 32 and 48 kHz)
+        const uint64_t step = (static_cast<uint64_t>(sampleRate) << 16) / CorrelationDetector::kSampleRate;
+        float last = 0.0f;
+        for (int frame = 0; frame < framesPerChannel && run.heardCount < capacity; ++frame) {
+            const int16_t* in = samples + static_cast<size_t>(frame) * channels;
+            int32_t mono = 0;
+            for (int channel = 0; channel < channels; ++channel) mono += in[channel];
+            run.listenSum += mono / channels;
+            ++run.listenCount;
+            run.listenQ16 += 1u << 16;
+            while (run.listenQ16 >= step && run.heardCount < capacity) {
+                if (run.listenCount > 0) last = static_cast<float>(run.listenSum) / (32768.0f * run.listenCount);
+                run.heard[run.heardCount++] = last;
+                run.listenQ16 -= step;
+                run.listenSum = 0;
+                run.listenCount = 0;
+            }
+        }
+        if (run.heardCount >= capacity) {
+            run.captured.store(run.listening, std::memory_order_release);
+        }
+    }
+}
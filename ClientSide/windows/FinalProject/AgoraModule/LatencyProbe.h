@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Latency measurement with a known test signal, a chirp or a maximum-length sequence, mixed
+// into one side of the audio path and found again on the other by normalized cross-correlation:
+//   Device:  playback -> speaker -> air -> microphone -> capture (the audio devices alone)
+//   Channel: capture -> encoder -> network -> whatever loops it back -> playback (round trip)
+// Both sides are AudioPipeline mix sources. The audio threads only mix the signal in and record
+// what comes back, each frame stamped with the time of its callback; the correlation runs on the
+// command worker once a probe's listening window is full.
+namespace winrt::FinalProject::implementation
+{
+    enum class ProbePath : uint8_t
+    {
+        Device,   // inject into playback, listen on capture
+        Channel,  // inject into capture, listen on playback
+    };
+
+    enum class ProbeSignal : uint8_t
+    {
+        Chirp,    // 300 Hz -> 3.4 kHz sweep, 100 ms
+        Mls,      // 1023-chip maximum-length sequence, 128 ms
+    };
+
+    const char* ProbePathName(ProbePath path);
+    const char* ProbeSignalName(ProbeSignal signal);
+    bool ParseProbePath(const char* name, ProbePath& path);
+    bool ParseProbeSignal(const char* name, ProbeSignal& signal);
+
+    // Finds a reference signal in a recording, both at kSampleRate. No threads, no clock.
+    class CorrelationDetector
+    {
+    public:
+        static constexpr int kSampleRate = 16000;
+
+        struct Match
+        {
+            bool found = false;
+            double offset = 0.0;        // samples into the recording where the reference starts
+            float score = 0.0f;         // normalized correlation at the peak, 1 = exact copy
+            float peakToSidelobe = 0.0f; // peak over the best alignment away from it
+        };
+
+        explicit CorrelationDetector(std::vector<float> reference);
+
+        // Best alignment of the reference in the recording. Found when the normalized correlation
+        // reaches minScore and stands out of every alignment further than kGuardSamples away by
+        // minPeakToSidelobe; an inverted copy counts (some devices flip the polarity).
+        Match Find(const float* recording, size_t length, float minScore = 0.35f, float minPeakToSidelobe = 1.4f) const;
+
+        const std::vector<float>& GetReference() const { return m_reference; }
+
+        static std::vector<float> MakeChirp(int durationMs, float startHz, float endHz);
+        // order 2..16; each chip lasts samplesPerChip samples
+        static std::vector<float> MakeMls(int order, int samplesPerChip);
+
+        // Peaks of a chirp's autocorrelation are about a millisecond wide; reflections that
+        // arrive within this window are treated as the same arrival
+        static constexpr int kGuardSamples = kSampleRate * 3 / 1000;
+
+    private:
+        std::vector<float> m_reference;
+        double m_referenceEnergy = 0.0;
+    };
+
+    struct LatencyProbeConfig
+    {
+        ProbePath path = ProbePath::Device;
+        ProbeSignal signal = ProbeSignal::Chirp;
+        int probes = 10;
+        int windowMs = 1000;       // listening time per probe: the longest latency it can see
+        int gapMs = 300;           // between probes, so one probe's echoes die down before the next
+        int knownDelayMs = 0;      // a fixed delay inside the loop (a repeater's hold), subtracted
+        float levelDb = -12.0f;    // dBFS peak of the injected signal
+    };
+
+    struct LatencySample
+    {
+        bool found = false;
+        double latencyMs = 0.0;
+        float score = 0.0f;
+    };
+
+    struct LatencyReport
+    {
+        ProbePath path = ProbePath::Device;
+        ProbeSignal signal = ProbeSignal::Chirp;
+        int audioScenario = -1;       // what the engine ran with, for comparing runs
+        int noiseSuppressionMode = -1;
+        int probes = 0;
+        int found = 0;
+        double minMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double maxMs = 0.0;
+        double meanMs = 0.0;
+        double jitterMs = 0.0;        // standard deviation
+        float meanScore = 0.0f;
+        bool cancelled = false;
+        std::vector<LatencySample> samples;
+    };
+
+    // Fills in the distribution from report.samples
+    void SummarizeLatency(LatencyReport& report);
+
+    class LatencyProbe
+    {
+    public:
+        // Microseconds on a steady clock; both audio threads and the worker read it
+        using ClockUs = uint64_t (*)();
+        static uint64_t SteadyClockUs();
+
+        static constexpr int kMinWindowMs = 200;
+        static constexpr int kMaxWindowMs = 3000;
+
+        explicit LatencyProbe(ClockUs clock = &SteadyClockUs) : m_clock(clock) {}
+        ~LatencyProbe();
+
+        LatencyProbe(const LatencyProbe&) = delete;
+        LatencyProbe& operator=(const LatencyProbe&) = delete;
+
+        // Worker thread. Start allocates the run (signal, window) and replaces any other;
+        // Stop waits until the audio threads let go of it. Nothing is injected until Arm.
+        void Start(const LatencyProbeConfig& config);
+        void Stop();
+        bool IsRunning() const { return m_run.load(std::memory_order_acquire) != nullptr; }
+        const LatencyProbeConfig& GetConfig() const { return m_config; }
+
+        // Worker thread: probe number `probe` (from 1) goes out with the next frame on the inject
+        // side, and the listen side records a window from then on
+        void Arm(uint32_t probe);
+        bool IsCaptured(uint32_t probe) const;
+        // Correlates the captured window of `probe`
+        LatencySample Analyze(uint32_t probe) const;
+
+        // Mix sources, one per pipeline; the path decides which of them injects and which listens
+        static bool MixCapture(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        static bool MixPlayback(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+    private:
+        struct Run
+        {
+            LatencyProbeConfig config;
+            std::vector<int16_t> signal;   // kSampleRate, at the configured level
+            std::vector<float> heard;      // kSampleRate, one window
+            std::unique_ptr<CorrelationDetector> detector;
+
+            std::atomic<uint32_t> armed{ 0 };    // worker: the probe to send
+            std::atomic<uint32_t> sent{ 0 };     // inject side: the probe it started
+            std::atomic<uint32_t> captured{ 0 }; // listen side: the probe whose window is full
+            uint64_t sentUs = 0;                 // written before sent, read after captured
+
+            // Inject side
+            uint32_t injecting = 0;
+            uint64_t injectQ16 = 0;
+
+            // Listen side
+            uint32_t listening = 0;
+            size_t heardCount = 0;
+            uint64_t heardStartUs = 0;
+            uint64_t listenQ16 = 0;
+            int32_t listenSum = 0;
+            int listenCount = 0;
+        };
+
+        bool Mix(bool capture, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        bool Inject(Run& run, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        void Listen(Run& run, const int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        // Swaps the run and waits until no audio thread is inside a mix callback
+        void Replace(Run* next);
+
+        ClockUs m_clock;
+        LatencyProbeConfig m_config;              // worker thread only
+        std::atomic<Run*> m_run{ nullptr };
+        std::atomic<int> m_inside{ 0 };           // audio threads currently in a callback
+    };
+}
@@ -0,0 +1,111 @@
+#include "LinkProfile.h"
+
+#include <algorithm>
+#include <string>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        // Fair above any of these, Poor above the second set. Voice holds up well to ~3% loss
+        // and 30 ms jitter on Opus alone; past that FEC and buffering pay for their latency.
+        struct TierLimits
+        {
+            uint32_t lossPercent;
+            uint32_t jitterMs;
+            uint32_t rttMs;
+            uint32_t minBandwidthKbps;
+        };
+        constexpr TierLimits kGoodLimits{ 3, 30, 200, 128 };
+        constexpr TierLimits kFairLimits{ 10, 80, 400, 48 };
+
+        bool Within(const LastmileProbeResult& result, const TierLimits& limits)
+        {
+            uint32_t loss = std::max(result.uplink.packetLossRate, result.downlink.packetLossRate);
+            uint32_t jitter = std::max(result.uplink.jitterMs, result.downlink.jitterMs);
+            if (loss > limits.lossPercent || jitter > limits.jitterMs || result.rttMs > limits.rttMs) return false;
+            // Without a bandwidth estimate only loss, jitter and RTT count
+            if (result.state != LastmileProbeResult::kComplete) return true;
+            uint32_t bandwidth = std::min(result.uplink.availableBandwidthKbps, result.downlink.availableBandwidthKbps);
+            return bandwidth >= limits.minBandwidthKbps;
+        }
+    }
+
+    const char* LinkTierName(LinkTier tier)
+    {
+        switch (tier) {
+            case LinkTier::Unknown: return "unknown";
+            case LinkTier::Good: return "good";
+            case LinkTier::Fair: return "fair";
+            case LinkTier::Poor: return "poor";
+        }
+        return "unknown";
+    }
+
+    AudioLinkProfile ChooseLinkProfile(const LastmileProbeResult& result)
+    {
+        AudioLinkProfile profile;
+        if (result.state != LastmileProbeResult::kComplete && result.state != LastmileProbeResult::kIncompleteNoBwe) {
+            return profile;
+        }
+
+        if (Within(result, kGoodLimits)) {
+            profile.tier = LinkTier::Good;
+            return profile;
+        }
+
+        // Speech profile at a fixed low bitrate leaves room for the FEC copy of each packet
+        profile.audioProfile = AudioLinkProfile::kProfileSpeechStandard;
+        profile.fec = true;
+        if (Within(result, kFairLimits)) {
+            profile.tier = LinkTier::Fair;
+            profile.bitrateKbps = 24;
+            profile.jitterBufferMs = 80;
+        } else {
+            profile.tier = LinkTier::Poor;
+            profile.bitrateKbps = 16;
+            profile.jitterBufferMs = 160;
+        }
+        return profile;
+    }
+
+    std::string LinkProfileParameters(const AudioLinkProfile& profile)
+    {
+        // Private parameters; setAudioProfile resets the bitrate, so 0 leaves it out
+        std::string json = "{";
+        if (profile.bitrateKbps > 0) {
+            json += "\"che.audio.custom_bitrate\":" + std::to_string(profile.bitrateKbps * 1000) + ",";
+        }
+        json += "\"che.audio.enable.fec\":";
+        json += profile.fec ? "true" : "false";
+        json += ",\"che.audio.neteq.min_delay\":" + std::to_string(profile.jitterBufferMs) + "}";
+        return json;
+    }
+
+    LinkDecision LinkProfileCache::Store(const std::string& networkId, const LastmileProbeResult& result, uint64_t nowMs)
+    {
+        LinkDecision decision;
+        decision.networkId = networkId;
+        decision.profile = ChooseLinkProfile(result);
+        decision.measured = result;
+        decision.measuredAtMs = nowMs;
+
+        if (m_entries.size() >= kMaxNetworks && m_entries.count(networkId) == 0) {
+            auto oldest = std::min_element(m_entries.begin(), m_entries.end(), [](const auto& a, const auto& b) {
+                return a.second.measuredAtMs < b.second.measuredAtMs;
+            });
+            m_entries.erase(oldest);
+        }
+        m_entries[networkId] = decision;
+        return decision;
+    }
+
+    bool LinkProfileCache::Lookup(const std::string& networkId, uint64_t nowMs, LinkDecision& decision) const
+    {
+        auto it = m_entries.find(networkId);
+        if (it == m_entries.end() || nowMs - it->second.measuredAtMs >= m_ttlMs) return false;
+        decision = it->second;
+        decision.fromCache = true;
+        return true;
+    }
+}
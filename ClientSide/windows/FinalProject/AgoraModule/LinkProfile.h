@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "VoiceEngine.h"
+
+// Audio settings chosen from the last-mile probe before joining, so a bad link starts the call
+// with a lean codec, FEC and a deeper jitter buffer instead of renegotiating mid-call. The probe
+// takes about 30 s, so its decision is cached per network (Wi-Fi profile and adapter) for a
+// while: rejoining on the same network reuses it without probing again. The cache only maps a
+// probe result to a tier and its settings and expires them by the time it is given; the core
+// runs the probe, applies the decision and keeps the cache on its worker.
+namespace winrt::FinalProject::implementation
+{
+    enum class LinkTier : uint8_t
+    {
+        Unknown, // not probed: SDK defaults
+        Good,
+        Fair,
+        Poor,
+    };
+
+    const char* LinkTierName(LinkTier tier);
+
+    struct AudioLinkProfile
+    {
+        static constexpr int kProfileDefault = 0;        // AUDIO_PROFILE_DEFAULT
+        static constexpr int kProfileSpeechStandard = 1; // AUDIO_PROFILE_SPEECH_STANDARD: 32 kHz mono
+
+        LinkTier tier = LinkTier::Unknown;
+        int audioProfile = kProfileDefault;
+        int bitrateKbps = 0;    // 0 = what the profile picks
+        bool fec = false;       // Opus in-band FEC
+        int jitterBufferMs = 0; // minimum playout delay; 0 = the SDK's adaptive default
+
+        // Same engine settings; the tier alone doesn't need a call
+        bool SameSettings(const AudioLinkProfile& other) const
+        {
+            return audioProfile == other.audioProfile && bitrateKbps == other.bitrateKbps &&
+                   fec == other.fec && jitterBufferMs == other.jitterBufferMs;
+        }
+    };
+
+    // The worse direction decides; an unavailable probe gives Unknown (SDK defaults)
+    AudioLinkProfile ChooseLinkProfile(const LastmileProbeResult& result);
+
+    // The setParameters JSON for the bitrate, FEC and jitter buffer of a profile
+    std::string LinkProfileParameters(const AudioLinkProfile& profile);
+
+    // The profile in use and where it came from
+    struct LinkDecision
+    {
+        std::string networkId;
+        AudioLinkProfile profile;
+        LastmileProbeResult measured;
+        uint64_t measuredAtMs = 0;
+        bool fromCache = false; // reused without probing
+    };
+
+    class LinkProfileCache
+    {
+    public:
+        static constexpr uint64_t kDefaultTtlMs = 30ull * 60 * 1000;
+        static constexpr size_t kMaxNetworks = 16;
+
+        void SetTtl(uint64_t ttlMs) { m_ttlMs = ttlMs; }
+        uint64_t GetTtl() const { return m_ttlMs; }
+
+        // A usable probe result for networkId; replaces what was there. The oldest network goes
+        // when the cache is full. Returns the decision for it.
+        LinkDecision Store(const std::string& networkId, const LastmileProbeResult& result, uint64_t nowMs);
+
+        // The decision for networkId if it is younger than the TTL
+        bool Lookup(const std::string& networkId, uint64_t nowMs, LinkDecision& decision) const;
+        size_t GetSize() const { return m_entries.size(); }
+        void Clear() { m_entries.clear(); }
+
+    private:
+        std::map<std::string, LinkDecision> m_entries;
+        uint64_t m_ttlMs = kDefaultTtlMs;
+    };
+}
@@ -0,0 +1,333 @@
+#include "Logging.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace winrt::FinalProject::implementation
+{
+    void LogRecord::AddText(const char* value, size_t length)
+    {
+        if (argCount >= kMaxArgs) return;
+
+        // Truncate instead of allocating when the inline buffer runs out
+        size_t available = kTextBytes - textUsed;
+        length = std::min(length, available);
+        std::memcpy(text + textUsed, value, length);
+
+        Arg& arg = args[argCount++];
+        arg.kind = Arg::Kind::Text;
+        arg.text.offset = textUsed;
+        arg.text.length = static_cast<uint16_t>(length);
+        textUsed = static_cast<uint16_t>(textUsed + length);
+    }
+
+    namespace
+    {
+        // Single-producer (owning thread) / single-consumer (drain thread) ring
+        struct LogRing
+        {
+            explicit LogRing(uint32_t id) : threadId(id), records(new LogRecord[Log::kRingCapacity]) {}
+
+            uint32_t threadId;
+            std::unique_ptr<LogRecord[]> records;
+            alignas(64) std::atomic<size_t> head{ 0 }; // next slot to write
+            alignas(64) std::atomic<size_t> tail{ 0 }; // next slot to read
+            std::atomic<bool> orphaned{ false };       // owning thread has exited
+        };
+
+        // Keeps a thread's ring registered until the drain thread has emptied it
+        struct ThreadRing
+        {
+            std::shared_ptr<LogRing> ring;
+            ~ThreadRing()
+            {
+                if (ring) ring->orphaned.store(true, std::memory_order_release);
+            }
+        };
+
+        class RotatingFileSink
+        {
+        public:
+            bool Open(const std::string& path, size_t maxBytes, int maxFiles)
+            {
+                m_path = path;
+                m_maxBytes = maxBytes;
+                m_maxFiles = std::max(1, maxFiles);
+                return Reopen();
+            }
+
+            void Write(const std::string& line)
+            {
+                if (!m_file) return;
+                if (m_written + line.size() > m_maxBytes) Rotate();
+                if (!m_file) return;
+                std::fwrite(line.data(), 1, line.size(), m_file);
+                m_written += line.size();
+            }
+
+            void Flush()
+            {
+                if (m_file) std::fflush(m_file);
+            }
+
+            void Close()
+            {
+                if (m_file) std::fclose(m_file);
+                m_file = nullptr;
+            }
+
+        private:
+            bool Reopen()
+            {
+                m_file = std::fopen(m_path.c_str(), "ab");
+                if (!m_file) return false;
+                std::fseek(m_file, 0, SEEK_END);
+                long position = std::ftell(m_file);
+                m_written = position > 0 ? static_cast<size_t>(position) : 0;
+                return true;
+            }
+
+            void Rotate()
+            {
+                Close();
+                // agora.log.(n-2) -> agora.log.(n-1) ... agora.log -> agora.log.1
+                for (int index = m_maxFiles - 1; index >= 1; --index) {
+                    std::string from = index == 1 ? m_path : m_path + "." + std::to_string(index - 1);
+                    std::string to = m_path + "." + std::to_string(index);
+                    std::remove(to.c_str());
+                    std::rename(from.c_str(), to.c_str());
+                }
+                if (m_maxFiles == 1) std::remove(m_path.c_str());
+                Reopen();
+            }
+
+            std::string m_path;
+            size_t m_maxBytes = 0;
+            int m_maxFiles = 1;
+            size_t m_written = 0;
+            std::FILE* m_file = nullptr;
+        };
+
+        std::atomic<bool> g_running{ false };
+        std::atomic<uint64_t> g_dropped{ 0 };
+        std::atomic<uint32_t> g_nextThreadId{ 1 };
+
+        std::mutex g_registryMutex; // taken once per thread, and by the drain thread
+        std::vector<std::shared_ptr<LogRing>> g_rings;
+
+        std::mutex g_drainMutex; // serializes draining (background thread vs. Flush/Stop)
+        LogConfig g_config;
+        RotatingFileSink g_sink;
+
+        std::mutex g_wakeMutex;
+        std::condition_variable g_wake;
+        std::thread g_drainThread;
+
+        thread_local ThreadRing t_ring;
+
+        LogRing* GetThreadRing()
+        {
+            if (!t_ring.ring) {
+                t_ring.ring = std::make_shared<LogRing>(g_nextThreadId.fetch_add(1, std::memory_order_relaxed));
+                std::lock_guard<std::mutex> lock(g_registryMutex);
+                g_rings.push_back(t_ring.ring);
+            }
+            return t_ring.ring.get();
+        }
+
+        const char* LevelName(LogLevel level)
+        {
+            switch (level) {
+                case LogLevel::Trace: return "TRACE";
+                case LogLevel::Debug: return "DEBUG";
+                case LogLevel::Info: return "INFO ";
+                case LogLevel::Warn: return "WARN ";
+                case LogLevel::Error: return "ERROR";
+            }
+            return "?????";
+        }
+
+        std::string FormatLine(const LogRecord& record)
+        {
+            std::time_t seconds = static_cast<std::time_t>(record.timestampNs / 1000000000ull);
+            unsigned milliseconds = static_cast<unsigned>((record.timestampNs / 1000000ull) % 1000ull);
+            std::tm utc{};
+#if defined(_WIN32)
+            gmtime_s(&utc, &seconds);
+#else
+            gmtime_r(&seconds, &utc);
+#endif
+            char prefix[64];
+            std::snprintf(prefix, sizeof(prefix), "%04d-%02d-%02dT%02d:%02d:%02d.%03uZ [%s] [%u] ",
+                utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec,
+                milliseconds, LevelName(record.level), record.threadId);
+
+            std::string line(prefix);
+            line += Log::Format(record);
+            line += '\n';
+            return line;
+        }
+
+        // Caller holds g_drainMutex
+        void DrainLocked()
+        {
+            std::vector<std::shared_ptr<LogRing>> rings;
+            {
+                std::lock_guard<std::mutex> lock(g_registryMutex);
+                rings = g_rings;
+            }
+
+            for (const auto& ring : rings) {
+                size_t tail = ring->tail.load(std::memory_order_relaxed);
+                size_t head = ring->head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail) {
+                    std::string line = FormatLine(ring->records[tail % Log::kRingCapacity]);
+                    g_sink.Write(line);
+                    if (g_config.mirror) g_config.mirror(line.c_str());
+                }
+                ring->tail.store(tail, std::memory_order_release);
+            }
+            g_sink.Flush();
+
+            // Forget rings whose thread is gone and which are now empty
+            std::lock_guard<std::mutex> lock(g_registryMutex);
+            g_rings.erase(std::remove_if(g_rings.begin(), g_rings.end(), [](const std::shared_ptr<LogRing>& ring) {
+                return ring->orphaned.load(std::memory_order_acquire) &&
+                       ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+            }), g_rings.end());
+        }
+
+        void DrainLoop()
+        {
+            while (g_running.load()) {
+                {
+                    std::unique_lock<std::mutex> lock(g_wakeMutex);
+                    g_wake.wait_for(lock, std::chrono::milliseconds(g_config.drainIntervalMs),
+                        []() { return !g_running.load(); });
+                }
+                std::lock_guard<std::mutex> lock(g_drainMutex);
+                DrainLocked();
+            }
+        }
+    }
+
+    void Log::Start(LogConfig config)
+    {
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        if (g_running.load()) return;
+
+        g_config = std::move(config);
+        g_config.drainIntervalMs = std::max(1, g_config.drainIntervalMs);
+        if (!g_config.filePath.empty()) {
+            g_sink.Open(g_config.filePath, g_config.maxFileBytes, g_config.maxFiles);
+        }
+
+        g_running.store(true);
+        g_drainThread = std::thread(DrainLoop);
+    }
+
+    void Log::Stop()
+    {
+        if (!g_running.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(g_wakeMutex);
+        }
+        g_wake.notify_one();
+        if (g_drainThread.joinable()) g_drainThread.join();
+
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        DrainLocked();
+        g_sink.Close();
+    }
+
+    bool Log::IsRunning()
+    {
+        return g_running.load(std::memory_order_relaxed);
+    }
+
+    void Log::Flush()
+    {
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        DrainLocked();
+    }
+
+    uint64_t Log::GetDroppedCount()
+    {
+        return g_dropped.load(std::memory_order_relaxed);
+    }
+
+    LogRecord* Log::BeginRecord()
+    {
+        LogRing* ring = GetThreadRing();
+        size_t head = ring->head.load(std::memory_order_relaxed);
+        if (head - ring->tail.load(std::memory_order_acquire) >= kRingCapacity) {
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        LogRecord* record = &ring->records[head % kRingCapacity];
+        record->timestampNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        record->threadId = ring->threadId;
+        record->argCount = 0;
+        record->textUsed = 0;
+        return record;
+    }
+
+    void Log::CommitRecord()
+    {
+        LogRing* ring = t_ring.ring.get();
+        ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::string Log::Format(const LogRecord& record)
+    {
+        std::string out;
+        if (!record.format) return out;
+        out.reserve(128);
+
+        size_t argIndex = 0;
+        for (const char* p = record.format; *p; ++p) {
+            if (p[0] != '{' || p[1] != '}') {
+                out += *p;
+                continue;
+            }
+            ++p;
+            if (argIndex >= record.argCount) {
+                out += "{}";
+                continue;
+            }
+
+            const LogRecord::Arg& arg = record.args[argIndex++];
+            char number[32];
+            switch (arg.kind) {
+                case LogRecord::Arg::Kind::Int:
+                    std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(arg.i));
+                    out += number;
+                    break;
+                case LogRecord::Arg::Kind::UInt:
+                    std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(arg.u));
+                    out += number;
+                    break;
+                case LogRecord::Arg::Kind::Double:
+                    std::snprintf(number, sizeof(number), "%.3f", arg.d);
+                    out += number;
+                    break;
+                case LogRecord::Arg::Kind::Bool:
+                    out += arg.u ? "true" : "false";
+                    break;
+                case LogRecord::Arg::Kind::Text:
+                    out.append(record.text + arg.text.offset, arg.text.length);
+                    break;
+            }
+        }
+        return out;
+    }
+}
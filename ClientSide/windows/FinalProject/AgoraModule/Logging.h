@@ -0,0 +1,196 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Structured logging for the Agora module.
+//
+//   AGORA_LOG_INFO("Joined {} as uid {} in {} ms", channel, uid, elapsed);
+//
+// Levels below AGORA_LOG_LEVEL are removed by the preprocessor, arguments included.
+// Enabled calls only copy the raw arguments into a preallocated per-thread ring;
+// "{}" formatting and file I/O happen later on the logger's background thread.
+// Portable C++17: the rotating file sink works the same on Windows and Linux.
+
+#define AGORA_LOG_LEVEL_TRACE 0
+#define AGORA_LOG_LEVEL_DEBUG 1
+#define AGORA_LOG_LEVEL_INFO 2
+#define AGORA_LOG_LEVEL_WARN 3
+#define AGORA_LOG_LEVEL_ERROR 4
+#define AGORA_LOG_LEVEL_OFF 5
+
+#ifndef AGORA_LOG_LEVEL
+#if defined(_DEBUG)
+#define AGORA_LOG_LEVEL AGORA_LOG_LEVEL_DEBUG
+#else
+#define AGORA_LOG_LEVEL AGORA_LOG_LEVEL_INFO
+#endif
+#endif
+
+#define AGORA_LOG_WRITE(level, ...) ::winrt::FinalProject::implementation::Log::Write(level, __VA_ARGS__)
+
+#if AGORA_LOG_LEVEL <= AGORA_LOG_LEVEL_TRACE
+#define AGORA_LOG_TRACE(...) AGORA_LOG_WRITE(::winrt::FinalProject::implementation::LogLevel::Trace, __VA_ARGS__)
+#else
+#define AGORA_LOG_TRACE(...) ((void)0)
+#endif
+
+#if AGORA_LOG_LEVEL <= AGORA_LOG_LEVEL_DEBUG
+#define AGORA_LOG_DEBUG(...) AGORA_LOG_WRITE(::winrt::FinalProject::implementation::LogLevel::Debug, __VA_ARGS__)
+#else
+#define AGORA_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if AGORA_LOG_LEVEL <= AGORA_LOG_LEVEL_INFO
+#define AGORA_LOG_INFO(...) AGORA_LOG_WRITE(::winrt::FinalProject::implementation::LogLevel::Info, __VA_ARGS__)
+#else
+#define AGORA_LOG_INFO(...) ((void)0)
+#endif
+
+#if AGORA_LOG_LEVEL <= AGORA_LOG_LEVEL_WARN
+#define AGORA_LOG_WARN(...) AGORA_LOG_WRITE(::winrt::FinalProject::implementation::LogLevel::Warn, __VA_ARGS__)
+#else
+#define AGORA_LOG_WARN(...) ((void)0)
+#endif
+
+#if AGORA_LOG_LEVEL <= AGORA_LOG_LEVEL_ERROR
+#define AGORA_LOG_ERROR(...) AGORA_LOG_WRITE(::winrt::FinalProject::implementation::LogLevel::Error, __VA_ARGS__)
+#else
+#define AGORA_LOG_ERROR(...) ((void)0)
+#endif
+
+namespace winrt::FinalProject::implementation
+{
+    enum class LogLevel : uint8_t
+    {
+        Trace = AGORA_LOG_LEVEL_TRACE,
+        Debug = AGORA_LOG_LEVEL_DEBUG,
+        Info = AGORA_LOG_LEVEL_INFO,
+        Warn = AGORA_LOG_LEVEL_WARN,
+        Error = AGORA_LOG_LEVEL_ERROR,
+    };
+
+    // One unformatted log call. Fixed size so rings never allocate.
+    struct LogRecord
+    {
+        static constexpr size_t kMaxArgs = 8;
+        static constexpr size_t kTextBytes = 192; // inline copies of string arguments
+
+        struct Arg
+        {
+            enum class Kind : uint8_t { Int, UInt, Double, Bool, Text };
+
+            Kind kind = Kind::Int;
+            union
+            {
+                int64_t i;
+                uint64_t u;
+                double d;
+                struct { uint16_t offset; uint16_t length; } text;
+            };
+
+            Arg() : i(0) {}
+        };
+
+        uint64_t timestampNs = 0;
+        const char* format = nullptr; // must be a string literal
+        LogLevel level = LogLevel::Info;
+        uint8_t argCount = 0;
+        uint16_t textUsed = 0;
+        uint32_t threadId = 0;
+        Arg args[kMaxArgs];
+        char text[kTextBytes];
+
+        void AddText(const char* value, size_t length);
+
+        template <typename T>
+        void Add(const T& value)
+        {
+            if (argCount >= kMaxArgs) return;
+            Arg& arg = args[argCount];
+
+            using U = std::decay_t<T>;
+            if constexpr (std::is_same_v<U, bool>) {
+                arg.kind = Arg::Kind::Bool;
+                arg.u = value ? 1 : 0;
+            } else if constexpr (std::is_enum_v<U>) {
+                arg.kind = Arg::Kind::Int;
+                arg.i = static_cast<int64_t>(value);
+            } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                arg.kind = Arg::Kind::Int;
+                arg.i = static_cast<int64_t>(value);
+            } else if constexpr (std::is_integral_v<U>) {
+                arg.kind = Arg::Kind::UInt;
+                arg.u = static_cast<uint64_t>(value);
+            } else if constexpr (std::is_floating_point_v<U>) {
+                arg.kind = Arg::Kind::Double;
+                arg.d = static_cast<double>(value);
+            } else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+                AddText(value.data(), value.size());
+                return;
+            } else if constexpr (std::is_array_v<std::remove_reference_t<T>>) {
+                // String literals and char buffers: never null
+                AddText(value, std::strlen(value));
+                return;
+            } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+                const char* text = value ? value : "(null)";
+                AddText(text, std::strlen(text));
+                return;
+            } else {
+                static_assert(std::is_pointer_v<U>, "Unsupported log argument type");
+                arg.kind = Arg::Kind::UInt;
+                arg.u = reinterpret_cast<uintptr_t>(value);
+            }
+            ++argCount;
+        }
+    };
+
+    struct LogConfig
+    {
+        std::string filePath;                  // empty = no file sink
+        size_t maxFileBytes = 2 * 1024 * 1024; // rotate after this many bytes
+        int maxFiles = 3;                      // agora.log, agora.log.1, agora.log.2
+        int drainIntervalMs = 100;
+        // Optional extra sink for formatted lines (OutputDebugStringA on Windows debug builds)
+        std::function<void(const char*)> mirror;
+    };
+
+    class Log
+    {
+    public:
+        static constexpr size_t kRingCapacity = 256; // records per thread
+
+        static void Start(LogConfig config);
+        // Drains every ring one last time and closes the file
+        static void Stop();
+        static bool IsRunning();
+
+        template <typename... Args>
+        static void Write(LogLevel level, const char* format, const Args&... args)
+        {
+            if (!IsRunning()) return;
+            LogRecord* record = BeginRecord();
+            if (!record) return;
+            record->level = level;
+            record->format = format;
+            (record->Add(args), ...);
+            CommitRecord();
+        }
+
+        // Synchronously formats and writes everything queued so far (tests, shutdown)
+        static void Flush();
+
+        static uint64_t GetDroppedCount();
+
+        // "{}" substitution used by the drain thread; exposed for tests
+        static std::string Format(const LogRecord& record);
+
+    private:
+        static LogRecord* BeginRecord();
+        static void CommitRecord();
+    };
+}
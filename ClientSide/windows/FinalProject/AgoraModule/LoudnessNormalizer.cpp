@@ -0,0 +1,221 @@
+#include "LoudnessNormalizer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr double kFullScaleSquare = 32768.0 * 32768.0;
+
+        void ClampConfig(LoudnessConfig& config)
+        {
+            config.targetLufs = std::max(-40.0f, std::min(-6.0f, config.targetLufs));
+            config.maxBoostDb = std::max(0.0f, std::min(30.0f, config.maxBoostDb));
+            config.maxCutDb = std::max(0.0f, std::min(30.0f, config.maxCutDb));
+            config.gateLufs = std::max(-80.0f, std::min(-20.0f, config.gateLufs));
+            config.attackMs = std::max(1, std::min(2000, config.attackMs));
+            config.releaseMs = std::max(10, std::min(20000, config.releaseMs));
+        }
+
+        // BS.1770: mono loudness of a K-weighted mean square (full scale = 1)
+        float ToLufs(float meanSquare)
+        {
+            if (meanSquare <= 1e-12f) return LoudnessNormalizer::kSilenceLufs;
+            return -0.691f + 10.0f * std::log10(meanSquare);
+        }
+    }
+
+    LoudnessNormalizer::LoudnessNormalizer()
+    {
+        for (size_t i = 0; i < kSlots; ++i) {
+            m_keys[i].store(0, std::memory_order_relaxed);
+            m_lastSeen[i].store(0, std::memory_order_relaxed);
+            m_loudness[i].store(kSilenceLufs, std::memory_order_relaxed);
+            m_gainDb[i].store(0.0f, std::memory_order_relaxed);
+            m_speaking[i].store(false, std::memory_order_relaxed);
+        }
+    }
+
+    uint32_t LoudnessNormalizer::ChannelKey(const char* channel)
+    {
+        uint32_t hash = 2166136261u;
+        for (const char* c = channel; c && *c; ++c) {
+            hash ^= static_cast<uint8_t>(*c);
+            hash *= 16777619u;
+        }
+        return hash != 0 ? hash : 1;
+    }
+
+    void LoudnessNormalizer::SetConfig(const LoudnessConfig& config)
+    {
+        LoudnessConfig clamped = config;
+        ClampConfig(clamped);
+        m_config.Update([&clamped](LoudnessConfig& current) {
+            uint64_t version = current.version;
+            current = clamped;
+            current.version = version; // Update() bumps it
+        });
+    }
+
+    bool LoudnessNormalizer::Prepare()
+    {
+        m_config.Read([this](const LoudnessConfig& config) {
+            if (config.version == m_preparedVersion) return;
+            m_preparedVersion = config.version;
+            m_enabled = config.enabled;
+            m_targetLufs = config.targetLufs;
+            m_maxBoostDb = config.maxBoostDb;
+            m_maxCutDb = config.maxCutDb;
+            m_gateLufs = config.gateLufs;
+            m_attackMs = config.attackMs;
+            m_releaseMs = config.releaseMs;
+            m_timedFrames = 0; // smoothing factors again at the next frame
+        });
+        // Only this thread moves the clock
+        m_tick.store(m_tick.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return m_enabled;
+    }
+
+    void LoudnessNormalizer::Design(int sampleRate)
+    {
+        // BS.1770 pre-filter (high shelf, +4 dB above ~1.7 kHz) and RLB high-pass, for any rate
+        double k = std::tan(kPi * 1681.974450955533 / sampleRate);
+        double q = 0.7071752369554196;
+        double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+        double vb = std::pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+        m_shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        m_shelf.b1 = 2.0 * (k * k - vh) / a0;
+        m_shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        m_shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+        k = std::tan(kPi * 38.13547087602444 / sampleRate);
+        q = 0.5003270373238773;
+        a0 = 1.0 + k / q + k * k;
+        m_highPass.b0 = 1.0;
+        m_highPass.b1 = -2.0;
+        m_highPass.b2 = 1.0;
+        m_highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        m_highPass.a2 = (1.0 - k / q + k * k) / a0;
+
+        // Filter state from another rate means nothing
+        for (Slot& slot : m_slots) std::fill(slot.filter, slot.filter + 4, 0.0);
+        m_designedRate = sampleRate;
+    }
+
+    void LoudnessNormalizer::Retime(int frames, int sampleRate)
+    {
+        // One-pole smoothing per frame, so the time constants hold whatever the frame length
+        double frameMs = 1000.0 * frames / sampleRate;
+        m_attack = static_cast<float>(1.0 - std::exp(-frameMs / m_attackMs));
+        m_release = static_cast<float>(1.0 - std::exp(-frameMs / m_releaseMs));
+        m_timedFrames = frames;
+        m_timedRate = sampleRate;
+    }
+
+    int LoudnessNormalizer::FindSlot(uint64_t key)
+    {
+        const uint32_t tick = m_tick.load(std::memory_order_relaxed);
+        int reusable = -1;
+        for (size_t i = 0; i < kSlots; ++i) {
+            uint64_t current = m_keys[i].load(std::memory_order_relaxed);
+            if (current == key) return static_cast<int>(i);
+            if (reusable >= 0) continue;
+            if (current == 0 || tick - m_lastSeen[i].load(std::memory_order_relaxed) > kIdleFrames) {
+                reusable = static_cast<int>(i);
+            }
+        }
+        if (reusable < 0) return -1;
+
+        m_slots[reusable] = Slot{};
+        m_keys[reusable].store(key, std::memory_order_release);
+        return reusable;
+    }
+
+    LoudnessGain LoudnessNormalizer::Process(const char* channel, uint32_t uid, const int16_t* samples, int frames, int sampleRate)
+    {
+        LoudnessGain level;
+        if (!m_enabled || !channel || !samples || frames <= 0 || sampleRate <= 0) return level;
+        if (sampleRate != m_designedRate) Design(sampleRate);
+        if (frames != m_timedFrames || sampleRate != m_timedRate) Retime(frames, sampleRate);
+
+        const uint64_t key = (static_cast<uint64_t>(ChannelKey(channel)) << 32) | uid;
+        int index = FindSlot(key);
+        if (index < 0) {
+            m_overflow.fetch_add(1, std::memory_order_relaxed);
+            return level;
+        }
+        Slot& slot = m_slots[index];
+
+        // K-weighted energy of the frame: the recursions are serial, so one scalar pass
+        const Biquad& s = m_shelf;
+        const Biquad& h = m_highPass;
+        double z0 = slot.filter[0], z1 = slot.filter[1], z2 = slot.filter[2], z3 = slot.filter[3];
+        double energy = 0.0;
+        for (int i = 0; i < frames; ++i) {
+            double x = samples[i];
+            double shelved = s.b0 * x + z0;
+            z0 = s.b1 * x - s.a1 * shelved + z1;
+            z1 = s.b2 * x - s.a2 * shelved;
+            double weighted = shelved + z2;
+            z2 = h.b1 * shelved - h.a1 * weighted + z3;
+            z3 = shelved - h.a2 * weighted;
+            energy += weighted * weighted;
+        }
+        slot.filter[0] = z0;
+        slot.filter[1] = z1;
+        slot.filter[2] = z2;
+        slot.filter[3] = z3;
+
+        float frameLufs = ToLufs(static_cast<float>(energy / frames / kFullScaleSquare));
+        bool speaking = frameLufs >= m_gateLufs;
+        if (speaking) {
+            if (!slot.measured) {
+                // A new talker is levelled from their first word, not faded towards it
+                slot.loudness = frameLufs;
+                slot.measured = true;
+            } else {
+                // Smoothed in dB, so a release takes as long after a 20 dB drop as after a 3 dB one
+                float factor = frameLufs > slot.loudness ? m_attack : m_release;
+                slot.loudness += factor * (frameLufs - slot.loudness);
+            }
+        }
+
+        level.from = slot.gain;
+        float loudness = slot.measured ? slot.loudness : kSilenceLufs;
+        float gainDb = 0.0f;
+        if (slot.measured) {
+            gainDb = std::max(-m_maxCutDb, std::min(m_maxBoostDb, m_targetLufs - loudness));
+            slot.gain = std::pow(10.0f, gainDb / 20.0f);
+        }
+        level.to = slot.gain;
+
+        m_loudness[index].store(loudness, std::memory_order_relaxed);
+        m_gainDb[index].store(gainDb, std::memory_order_relaxed);
+        m_speaking[index].store(speaking, std::memory_order_relaxed);
+        m_lastSeen[index].store(m_tick.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return level;
+    }
+
+    std::vector<LoudnessStats> LoudnessNormalizer::GetStats() const
+    {
+        std::vector<LoudnessStats> stats;
+        const uint32_t tick = m_tick.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < kSlots; ++i) {
+            uint64_t key = m_keys[i].load(std::memory_order_acquire);
+            if (key == 0 || tick - m_lastSeen[i].load(std::memory_order_relaxed) > kIdleFrames) continue;
+
+            LoudnessStats entry;
+            entry.channelKey = static_cast<uint32_t>(key >> 32);
+            entry.uid = static_cast<uint32_t>(key);
+            entry.loudnessLufs = m_loudness[i].load(std::memory_order_relaxed);
+            entry.gainDb = m_gainDb[i].load(std::memory_order_relaxed);
+            entry.speaking = m_speaking[i].load(std::memory_order_relaxed);
+            stats.push_back(entry);
+        }
+        return stats;
+    }
+}
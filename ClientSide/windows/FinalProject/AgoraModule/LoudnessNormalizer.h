@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AgoraState.h"
+
+// Playback loudness leveller per remote user. Field units come in at very different levels;
+// each user's loudness is measured with the BS.1770 / EBU R128 K-weighting and tracked with a
+// fast attack and a slow release, and their gain brings them towards one target level.
+// Frames quieter than the gate are not speech: the estimate and the gain hold through them.
+//
+// Process runs on the playback thread (from the radio mixer's staging) and neither allocates
+// nor locks; the state is one compact slot per channel and uid in a fixed table, the stats are
+// atomics any thread can read. The gain is returned rather than applied so the mixer can ramp
+// it in float along with its own gains, without clipping a boosted user in int16.
+namespace winrt::FinalProject::implementation
+{
+    struct LoudnessConfig
+    {
+        uint64_t version = 0; // bumped by SnapshotCell
+
+        bool enabled = false;
+        float targetLufs = -20.0f; // where every speaker is brought to
+        float maxBoostDb = 15.0f;  // most a quiet unit is turned up
+        float maxCutDb = 15.0f;    // most a loud one is turned down
+        float gateLufs = -55.0f;   // quieter frames are not speech
+        int attackMs = 40;         // estimate rising: a shouting unit is caught quickly
+        int releaseMs = 2000;      // estimate falling: no pumping between words
+    };
+
+    // The gain over one frame: ramps from one to the other, sample by sample
+    struct LoudnessGain
+    {
+        float from = 1.0f;
+        float to = 1.0f;
+    };
+
+    struct LoudnessStats
+    {
+        std::string channelName;  // filled in by whoever knows the channel names
+        uint32_t channelKey = 0;  // LoudnessNormalizer::ChannelKey of the channel
+        uint32_t uid = 0;
+        float loudnessLufs = 0.0f; // short-term estimate, before the gain
+        float gainDb = 0.0f;
+        bool speaking = false;     // the last frame was above the gate
+    };
+
+    class LoudnessNormalizer
+    {
+    public:
+        static constexpr size_t kSlots = 32;       // 16 speakers with room to spare
+        static constexpr uint32_t kIdleFrames = 200; // 2 s of playback frames unheard: slot is free
+        static constexpr float kSilenceLufs = -120.0f;
+
+        LoudnessNormalizer();
+
+        LoudnessNormalizer(const LoudnessNormalizer&) = delete;
+        LoudnessNormalizer& operator=(const LoudnessNormalizer&) = delete;
+
+        // Any thread; values are clamped
+        void SetConfig(const LoudnessConfig& config);
+        LoudnessConfig GetConfig() const { return m_config.Load(); }
+
+        // Audio thread, once per playback frame: picks the settings up and moves the idle clock
+        // on. True while enabled.
+        bool Prepare();
+
+        // Audio thread: measures one user's mono frame and returns the gain to play it at
+        LoudnessGain Process(const char* channel, uint32_t uid, const int16_t* samples, int frames, int sampleRate);
+
+        // Any thread: the users heard in the last kIdleFrames, channelName left empty
+        std::vector<LoudnessStats> GetStats() const;
+        uint64_t GetOverflowCount() const { return m_overflow.load(std::memory_order_relaxed); }
+
+        // 32-bit FNV-1a of the name, never 0
+        static uint32_t ChannelKey(const char* channel);
+
+    private:
+        // Audio thread only
+        struct Slot
+        {
+            double filter[4] = {};     // K-weighting: shelf then high-pass, transposed direct form II
+            float loudness = 0.0f;     // short-term estimate, LUFS
+            float gain = 1.0f;         // linear, where the last frame ended
+            bool measured = false;     // has had a frame above the gate
+        };
+
+        struct Biquad
+        {
+            double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        };
+
+        int FindSlot(uint64_t key);
+        void Design(int sampleRate);
+        void Retime(int frames, int sampleRate);
+
+        SnapshotCell<LoudnessConfig> m_config;
+
+        // Audio-thread settings, copied out of the snapshot when its version moves
+        uint64_t m_preparedVersion = ~0ull;
+        bool m_enabled = false;
+        float m_targetLufs = 0.0f;
+        float m_maxBoostDb = 0.0f;
+        float m_maxCutDb = 0.0f;
+        float m_gateLufs = 0.0f;
+        int m_attackMs = 1;
+        int m_releaseMs = 1;
+
+        // K-weighting for the rate frames come in at, smoothing for their length
+        int m_designedRate = 0;
+        Biquad m_shelf;
+        Biquad m_highPass;
+        int m_timedFrames = 0;
+        int m_timedRate = 0;
+        float m_attack = 1.0f;  // per-frame smoothing factors
+        float m_release = 1.0f;
+
+        // Structure of arrays: keys, stats and clock are read by other threads
+        std::array<Slot, kSlots> m_slots{};
+        std::array<std::atomic<uint64_t>, kSlots> m_keys;     // channel key << 32 | uid, 0 = free
+        std::array<std::atomic<uint32_t>, kSlots> m_lastSeen;
+        std::array<std::atomic<float>, kSlots> m_loudness;
+        std::array<std::atomic<float>, kSlots> m_gainDb;
+        std::array<std::atomic<bool>, kSlots> m_speaking;
+        std::atomic<uint32_t> m_tick{ 0 };
+        std::atomic<uint64_t> m_overflow{ 0 };
+    };
+}
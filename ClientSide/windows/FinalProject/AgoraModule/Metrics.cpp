@@ -0,0 +1,359 @@
+#include "Metrics.h"
+#include <algorithm>
+#include <cstdio>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        int HighestBit(uint64_t value)
+        {
+#if defined(_MSC_VER)
+            unsigned long index = 0;
+            _BitScanReverse64(&index, value);
+            return static_cast<int>(index);
+#else
+            return 63 - __builtin_clzll(value);
+#endif
+        }
+
+        void AtomicMax(std::atomic<uint64_t>& target, uint64_t value)
+        {
+            uint64_t current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+            }
+        }
+
+        void AppendNumber(std::string& out, const char* key, uint64_t value)
+        {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), "\"%s\":%llu,", key, static_cast<unsigned long long>(value));
+            out += buffer;
+        }
+
+        void AppendQuoted(std::string& out, const std::string& text)
+        {
+            out += '"';
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    out += '\\';
+                    out += c;
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    out += buffer;
+                } else {
+                    out += c;
+                }
+            }
+            out += '"';
+        }
+
+        void TrimComma(std::string& out)
+        {
+            if (!out.empty() && out.back() == ',') out.pop_back();
+        }
+    }
+
+    const char* MetricOpName(MetricOp op)
+    {
+        switch (op) {
+            case MetricOp::Init: return "init";
+            case MetricOp::Join: return "join";
+            case MetricOp::JoinToSuccess: return "joinToSuccess";
+            case MetricOp::Leave: return "leave";
+            case MetricOp::Mute: return "mute";
+            case MetricOp::RadioJoin: return "radioJoin";
+            case MetricOp::RadioLeave: return "radioLeave";
+            case MetricOp::TalkSwitch: return "talkSwitch";
+            case MetricOp::AcceptCall: return "acceptCall";
+            case MetricOp::Replay: return "replay";
+            case MetricOp::Reconnect: return "reconnect";
+            case MetricOp::CallSignal: return "callSignal";
+            case MetricOp::FloorGrant: return "floorGrant";
+            case MetricOp::ProbeDevice: return "probeDevice";
+            case MetricOp::ProbeChannel: return "probeChannel";
+            case MetricOp::DeviceSwitch: return "deviceSwitch";
+            case MetricOp::LastmileProbe: return "lastmileProbe";
+            case MetricOp::Count: break;
+        }
+        return "unknown";
+    }
+
+    LatencyHistogram::LatencyHistogram()
+    {
+        Reset();
+    }
+
+    size_t LatencyHistogram::BucketIndex(uint64_t micros)
+    {
+        if (micros < 16) return static_cast<size_t>(micros);
+
+        int exponent = HighestBit(micros);
+        if (exponent > kMaxExponent) return kBuckets - 1;
+        uint64_t mantissa = (micros >> (exponent - 3)) & (kSubBuckets - 1); // 3 bits below the top one
+        return 16 + static_cast<size_t>(exponent - 4) * kSubBuckets + static_cast<size_t>(mantissa);
+    }
+
+    uint64_t LatencyHistogram::BucketUpperBound(size_t index)
+    {
+        if (index < 16) return index;
+
+        int exponent = 4 + static_cast<int>((index - 16) / kSubBuckets);
+        uint64_t mantissa = kSubBuckets + (index - 16) % kSubBuckets;
+        return ((mantissa + 1) << (exponent - 3)) - 1;
+    }
+
+    void LatencyHistogram::Record(uint64_t micros)
+    {
+        m_counts[BucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumUs.fetch_add(micros, std::memory_order_relaxed);
+        AtomicMax(m_maxUs, micros);
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::Summarize() const
+    {
+        // Copy first so every percentile comes from the same counts
+        std::array<uint32_t, kBuckets> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            counts[i] = m_counts[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        Summary summary;
+        summary.count = total;
+        if (total == 0) return summary;
+
+        summary.maxUs = m_maxUs.load(std::memory_order_relaxed);
+        summary.meanUs = m_sumUs.load(std::memory_order_relaxed) / std::max<uint64_t>(1, m_count.load(std::memory_order_relaxed));
+
+        // Nearest-rank percentiles, reported as the bucket's upper edge (never above the max seen)
+        uint64_t* targets[] = { &summary.p50Us, &summary.p90Us, &summary.p99Us };
+        const uint64_t ranks[] = { (total * 50 + 99) / 100, (total * 90 + 99) / 100, (total * 99 + 99) / 100 };
+        uint64_t seen = 0;
+        size_t next = 0;
+        for (size_t i = 0; i < kBuckets && next < 3; ++i) {
+            seen += counts[i];
+            while (next < 3 && seen >= ranks[next]) {
+                *targets[next++] = std::min(BucketUpperBound(i), summary.maxUs);
+            }
+        }
+        return summary;
+    }
+
+    void LatencyHistogram::Reset()
+    {
+        for (auto& count : m_counts) count.store(0, std::memory_order_relaxed);
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumUs.store(0, std::memory_order_relaxed);
+        m_maxUs.store(0, std::memory_order_relaxed);
+    }
+
+    Metrics::Metrics()
+    {
+        Reset();
+    }
+
+    void Metrics::RecordLatency(MetricOp op, uint64_t micros, bool succeeded)
+    {
+        if (op >= MetricOp::Count) return;
+        OpMetrics& metrics = m_ops[static_cast<size_t>(op)];
+        metrics.latency.Record(micros);
+        if (!succeeded) metrics.failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Metrics::RecordFailure(MetricOp op)
+    {
+        if (op >= MetricOp::Count) return;
+        m_ops[static_cast<size_t>(op)].failures.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Metrics::RecordChannelStats(uint8_t channel, const ChannelStatsSample& sample)
+    {
+        if (channel >= kMaxChannels) return;
+        auto& fields = m_channels[channel];
+        fields[Duration].store(sample.durationS, std::memory_order_relaxed);
+        fields[TxKbps].store(sample.txKbps, std::memory_order_relaxed);
+        fields[RxKbps].store(sample.rxKbps, std::memory_order_relaxed);
+        fields[LastmileDelay].store(sample.lastmileDelayMs, std::memory_order_relaxed);
+        fields[TxLoss].store(sample.txLossPercent, std::memory_order_relaxed);
+        fields[RxLoss].store(sample.rxLossPercent, std::memory_order_relaxed);
+        fields[Users].store(sample.userCount, std::memory_order_relaxed);
+        fields[CpuApp].store(sample.cpuAppPercent, std::memory_order_relaxed);
+        m_channelUpdates[channel].fetch_add(1, std::memory_order_release);
+    }
+
+    void Metrics::RecordRemoteAudio(uint8_t channel, uint32_t uid, const RemoteAudioSample& sample)
+    {
+        UidSlot* slot = FindOrClaim(channel, uid);
+        if (!slot) return;
+        slot->fields[Quality].store(sample.quality, std::memory_order_relaxed);
+        slot->fields[NetworkDelay].store(sample.networkDelayMs, std::memory_order_relaxed);
+        slot->fields[JitterBufferDelay].store(sample.jitterBufferDelayMs, std::memory_order_relaxed);
+        slot->fields[Loss].store(sample.lossPercent, std::memory_order_relaxed);
+        slot->fields[ReceivedKbps].store(sample.receivedKbps, std::memory_order_relaxed);
+        slot->fields[Frozen].store(sample.frozenPercent, std::memory_order_relaxed);
+        slot->fields[Mos].store(sample.mos, std::memory_order_relaxed);
+    }
+
+    void Metrics::RecordNetworkQuality(uint8_t channel, uint32_t uid, int txQuality, int rxQuality)
+    {
+        UidSlot* slot = FindOrClaim(channel, uid);
+        if (!slot) return;
+        slot->fields[TxQuality].store(txQuality, std::memory_order_relaxed);
+        slot->fields[RxQuality].store(rxQuality, std::memory_order_relaxed);
+    }
+
+    void Metrics::ForgetUid(uint8_t channel, uint32_t uid)
+    {
+        if (channel >= kMaxChannels) return;
+        const uint64_t key = MakeKey(channel, uid);
+        for (auto& slot : m_uids) {
+            uint64_t expected = key;
+            if (slot.key.compare_exchange_strong(expected, kTombstone, std::memory_order_acq_rel)) return;
+        }
+    }
+
+    // Same scheme as VolumeMeter: a key is only written by its own connection's callbacks,
+    // so only claiming a free slot races with other keys
+    Metrics::UidSlot* Metrics::FindOrClaim(uint8_t channel, uint32_t uid)
+    {
+        if (channel >= kMaxChannels) return nullptr;
+
+        const uint64_t key = MakeKey(channel, uid);
+        const size_t start = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 58) & (kUidSlots - 1);
+
+        size_t freeSlot = kUidSlots;
+        for (size_t probe = 0; probe < kUidSlots; ++probe) {
+            size_t index = (start + probe) & (kUidSlots - 1);
+            uint64_t current = m_uids[index].key.load(std::memory_order_acquire);
+            if (current == key) return &m_uids[index];
+            if (current == kTombstone && freeSlot == kUidSlots) freeSlot = index;
+            if (current == kEmpty) {
+                if (freeSlot == kUidSlots) freeSlot = index;
+                break;
+            }
+        }
+
+        for (size_t probe = 0; probe < kUidSlots; ++probe) {
+            size_t index = (freeSlot + probe) & (kUidSlots - 1);
+            uint64_t current = m_uids[index].key.load(std::memory_order_acquire);
+            if (current != kEmpty && current != kTombstone) continue;
+            if (m_uids[index].key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                for (auto& field : m_uids[index].fields) field.store(0, std::memory_order_relaxed);
+                return &m_uids[index];
+            }
+        }
+
+        m_uidOverflow.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void Metrics::SetChannelName(uint8_t channel, const std::string& channelName)
+    {
+        if (channel >= kMaxChannels) return;
+        std::lock_guard<std::mutex> lock(m_nameMutex);
+        m_channelNames[channel] = channelName;
+    }
+
+    void Metrics::ResetConnections()
+    {
+        for (size_t channel = 0; channel < kMaxChannels; ++channel) {
+            for (auto& field : m_channels[channel]) field.store(0, std::memory_order_relaxed);
+            m_channelUpdates[channel].store(0, std::memory_order_relaxed);
+        }
+        for (auto& slot : m_uids) {
+            slot.key.store(kEmpty, std::memory_order_relaxed);
+            for (auto& field : slot.fields) field.store(0, std::memory_order_relaxed);
+        }
+        m_uidOverflow.store(0, std::memory_order_relaxed);
+    }
+
+    void Metrics::Reset()
+    {
+        for (auto& op : m_ops) {
+            op.latency.Reset();
+            op.failures.store(0, std::memory_order_relaxed);
+        }
+        ResetConnections();
+    }
+
+    std::string Metrics::SnapshotJson() const
+    {
+        std::string out;
+        out.reserve(4096);
+        out += '{';
+        AppendNumber(out, "uptimeMs", static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                          std::chrono::steady_clock::now() - m_start).count()));
+
+        // Operations: count, failures and latency percentiles in microseconds; idle ones are skipped
+        out += "\"ops\":{";
+        for (size_t i = 0; i < m_ops.size(); ++i) {
+            LatencyHistogram::Summary summary = m_ops[i].latency.Summarize();
+            uint64_t failures = m_ops[i].failures.load(std::memory_order_relaxed);
+            if (summary.count == 0 && failures == 0) continue;
+
+            out += '"';
+            out += MetricOpName(static_cast<MetricOp>(i));
+            out += "\":{";
+            AppendNumber(out, "n", summary.count);
+            AppendNumber(out, "fail", failures);
+            AppendNumber(out, "mean", summary.meanUs);
+            AppendNumber(out, "p50", summary.p50Us);
+            AppendNumber(out, "p90", summary.p90Us);
+            AppendNumber(out, "p99", summary.p99Us);
+            AppendNumber(out, "max", summary.maxUs);
+            TrimComma(out);
+            out += "},";
+        }
+        TrimComma(out);
+        out += "},";
+
+        // Connections: [name, durationS, txKbps, rxKbps, lastmileMs, txLoss%, rxLoss%, users, cpuApp%]
+        out += "\"channels\":[";
+        {
+            std::lock_guard<std::mutex> lock(m_nameMutex);
+            for (size_t channel = 0; channel < kMaxChannels; ++channel) {
+                if (m_channelUpdates[channel].load(std::memory_order_acquire) == 0) continue;
+                out += '[';
+                AppendQuoted(out, m_channelNames[channel]);
+                for (const auto& field : m_channels[channel]) {
+                    out += ',';
+                    out += std::to_string(field.load(std::memory_order_relaxed));
+                }
+                out += "],";
+            }
+        }
+        TrimComma(out);
+        out += "],";
+
+        // Remote users: [channel, uid, quality, delayMs, jitterMs, loss%, kbps, frozen%, mos, txQuality, rxQuality]
+        out += "\"uids\":[";
+        for (const auto& slot : m_uids) {
+            uint64_t key = slot.key.load(std::memory_order_acquire);
+            if (key == kEmpty || key == kTombstone) continue;
+            out += '[';
+            out += std::to_string((key >> 32) & 0xFF);
+            out += ',';
+            out += std::to_string(static_cast<uint32_t>(key));
+            for (const auto& field : slot.fields) {
+                out += ',';
+                out += std::to_string(field.load(std::memory_order_relaxed));
+            }
+            out += "],";
+        }
+        TrimComma(out);
+        out += "],";
+
+        AppendNumber(out, "uidOverflow", m_uidOverflow.load(std::memory_order_relaxed));
+        TrimComma(out);
+        out += '}';
+        return out;
+    }
+}
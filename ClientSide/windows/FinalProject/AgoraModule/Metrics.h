@@ -0,0 +1,220 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Always-on production metrics for AgoraManager. Every write is a handful of relaxed
+// atomic operations on preallocated storage (no locks, no allocation), so recording
+// is safe from SDK callback threads and the command worker alike. Readers build a
+// JSON snapshot on demand; individual fields are atomic, a snapshot as a whole is not.
+namespace winrt::FinalProject::implementation
+{
+    enum class MetricOp : uint8_t
+    {
+        Init,          // InitializeEngine (create + initialize + audio profile)
+        Join,          // JoinChannel call
+        JoinToSuccess, // joinChannel until onJoinChannelSuccess (SDK elapsed)
+        Leave,
+        Mute,
+        RadioJoin,
+        RadioLeave,
+        TalkSwitch,
+        AcceptCall,    // AcceptCall until the call connection is publishing
+        Replay,        // ReplayLast: ring snapshot + decode, until the clip is handed to playback
+        Reconnect,     // link lost until connected again (SDK rejoin or our own retry)
+        CallSignal,    // call signal sent until the addressee's ack arrived
+        FloorGrant,    // push-to-talk floor requested until granted
+        ProbeDevice,   // latency probe: playback -> speaker -> microphone -> capture
+        ProbeChannel,  // latency probe: capture -> channel -> back into playback
+        DeviceSwitch,  // audio device change: hot-plug event (or SetAudioDevice call) until the engine switched
+        LastmileProbe, // last-mile probe start until its result
+        Count,
+    };
+
+    const char* MetricOpName(MetricOp op);
+
+    // HDR-style log-linear histogram over microseconds: exact below 16 us, then 8 buckets
+    // per power of two (<= 12.5% error) up to 2^41 us; larger values land in the top bucket.
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int kSubBuckets = 8;
+        static constexpr int kMaxExponent = 40;
+        static constexpr size_t kBuckets = 16 + kSubBuckets * (kMaxExponent - 3);
+
+        struct Summary
+        {
+            uint64_t count = 0;
+            uint64_t meanUs = 0;
+            uint64_t p50Us = 0;
+            uint64_t p90Us = 0;
+            uint64_t p99Us = 0;
+            uint64_t maxUs = 0;
+        };
+
+        LatencyHistogram();
+
+        void Record(uint64_t micros);
+        Summary Summarize() const;
+        void Reset();
+
+        static size_t BucketIndex(uint64_t micros);
+        static uint64_t BucketUpperBound(size_t index);
+
+    private:
+        std::array<std::atomic<uint32_t>, kBuckets> m_counts;
+        std::atomic<uint64_t> m_count{ 0 };
+        std::atomic<uint64_t> m_sumUs{ 0 };
+        std::atomic<uint64_t> m_maxUs{ 0 };
+    };
+
+    // Last onRtcStats per connection
+    struct ChannelStatsSample
+    {
+        uint32_t durationS = 0;
+        uint32_t txKbps = 0;
+        uint32_t rxKbps = 0;
+        uint32_t lastmileDelayMs = 0;
+        uint32_t txLossPercent = 0;
+        uint32_t rxLossPercent = 0;
+        uint32_t userCount = 0;
+        uint32_t cpuAppPercent = 0;
+    };
+
+    // Last onRemoteAudioStats for a uid (uid 0 = local), plus its onNetworkQuality
+    struct RemoteAudioSample
+    {
+        int32_t quality = 0;           // agora::rtc::QUALITY_TYPE
+        int32_t networkDelayMs = 0;
+        int32_t jitterBufferDelayMs = 0;
+        int32_t lossPercent = 0;
+        int32_t receivedKbps = 0;
+        int32_t frozenPercent = 0;
+        int32_t mos = 0;               // mosValue, x100
+    };
+
+    class Metrics
+    {
+    public:
+        static constexpr size_t kMaxChannels = 16;
+        static constexpr size_t kUidSlots = 64; // power of two
+        static constexpr uint8_t kNoChannel = 0xFF;
+
+        Metrics();
+
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        // Any thread, lock-free
+        void RecordLatency(MetricOp op, uint64_t micros, bool succeeded = true);
+        void RecordFailure(MetricOp op);
+        void RecordChannelStats(uint8_t channel, const ChannelStatsSample& sample);
+        void RecordRemoteAudio(uint8_t channel, uint32_t uid, const RemoteAudioSample& sample);
+        void RecordNetworkQuality(uint8_t channel, uint32_t uid, int txQuality, int rxQuality);
+        void ForgetUid(uint8_t channel, uint32_t uid);
+
+        // Command worker: names channel indices for the snapshot (indices come from the caller)
+        void SetChannelName(uint8_t channel, const std::string& channelName);
+
+        // Drops per-connection stats and uid slots (engine release); latency history is kept
+        void ResetConnections();
+
+        // Drops everything
+        void Reset();
+
+        // One compact JSON document with every counter, histogram summary and stats slot
+        std::string SnapshotJson() const;
+
+        LatencyHistogram::Summary GetSummary(MetricOp op) const { return m_ops[static_cast<size_t>(op)].latency.Summarize(); }
+        uint64_t GetFailures(MetricOp op) const { return m_ops[static_cast<size_t>(op)].failures.load(std::memory_order_relaxed); }
+        uint64_t GetUidOverflowCount() const { return m_uidOverflow.load(std::memory_order_relaxed); }
+
+    private:
+        enum UidField : size_t
+        {
+            Quality,
+            NetworkDelay,
+            JitterBufferDelay,
+            Loss,
+            ReceivedKbps,
+            Frozen,
+            Mos,
+            TxQuality,
+            RxQuality,
+            UidFieldCount,
+        };
+
+        enum ChannelField : size_t
+        {
+            Duration,
+            TxKbps,
+            RxKbps,
+            LastmileDelay,
+            TxLoss,
+            RxLoss,
+            Users,
+            CpuApp,
+            ChannelFieldCount,
+        };
+
+        struct OpMetrics
+        {
+            LatencyHistogram latency;
+            std::atomic<uint64_t> failures{ 0 };
+        };
+
+        struct UidSlot
+        {
+            std::atomic<uint64_t> key{ 0 };
+            std::array<std::atomic<int32_t>, UidFieldCount> fields;
+        };
+
+        static constexpr uint64_t kEmpty = 0;
+        static constexpr uint64_t kTombstone = 1;
+
+        static uint64_t MakeKey(uint8_t channel, uint32_t uid)
+        {
+            return (1ull << 40) | (static_cast<uint64_t>(channel) << 32) | uid;
+        }
+
+        UidSlot* FindOrClaim(uint8_t channel, uint32_t uid);
+
+        std::array<OpMetrics, static_cast<size_t>(MetricOp::Count)> m_ops;
+        std::array<std::array<std::atomic<uint32_t>, ChannelFieldCount>, kMaxChannels> m_channels;
+        std::array<std::atomic<uint32_t>, kMaxChannels> m_channelUpdates;
+        std::array<UidSlot, kUidSlots> m_uids;
+        std::atomic<uint64_t> m_uidOverflow{ 0 };
+
+        mutable std::mutex m_nameMutex; // names only; never taken by recorders
+        std::array<std::string, kMaxChannels> m_channelNames;
+
+        std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    };
+
+    // Times one manager operation into the histogram; Fail() marks it as failed
+    class ScopedLatency
+    {
+    public:
+        ScopedLatency(Metrics& metrics, MetricOp op) : m_metrics(metrics), m_op(op), m_start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedLatency()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_metrics.RecordLatency(m_op, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()), !m_failed);
+        }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+        void Fail() { m_failed = true; }
+
+    private:
+        Metrics& m_metrics;
+        MetricOp m_op;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_failed = false;
+    };
+}
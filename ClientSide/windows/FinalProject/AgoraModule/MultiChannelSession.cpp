@@ -0,0 +1,122 @@
+#include "MultiChannelSession.h"
+#include <algorithm>
+
+namespace winrt::FinalProject::implementation
+{
+    int MultiChannelSession::Join(const std::string& channelName, bool talk)
+    {
+        if (channelName.empty()) return kErrInvalidArgument;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Already monitoring this radio - never rejoin, at most move the talk key here
+        if (IsJoinedLocked(channelName)) {
+            return talk ? SetTalkChannelLocked(channelName) : 0;
+        }
+
+        if (m_channels.size() >= kMaxConnections) return kErrTooManyConnections;
+
+        // Un-publish the previous talker first so two radios never transmit together
+        const std::string previous = talk ? m_talkChannel : std::string();
+        if (!previous.empty()) {
+            int result = m_engine.UpdateConnection(previous, false);
+            if (result != 0) return result;
+        }
+
+        int result = m_engine.JoinConnection(channelName, talk);
+        if (result != 0) {
+            // Nothing joined: the previous talker keeps the key
+            if (!previous.empty() && m_engine.UpdateConnection(previous, true) != 0) m_talkChannel.clear();
+            return result;
+        }
+
+        m_channels.push_back(channelName);
+        if (talk) m_talkChannel = channelName;
+        return 0;
+    }
+
+    int MultiChannelSession::Leave(const std::string& channelName)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = std::find(m_channels.begin(), m_channels.end(), channelName);
+        if (it == m_channels.end()) return 0;
+
+        // Forget the connection even if the engine reports an error - it is gone either way
+        int result = m_engine.LeaveConnection(channelName);
+        m_channels.erase(it);
+        if (m_talkChannel == channelName) m_talkChannel.clear();
+        return result;
+    }
+
+    int MultiChannelSession::SetTalkChannel(const std::string& channelName)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return SetTalkChannelLocked(channelName);
+    }
+
+    void MultiChannelSession::LeaveAll()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& channelName : m_channels) {
+            m_engine.LeaveConnection(channelName);
+        }
+        m_channels.clear();
+        m_talkChannel.clear();
+    }
+
+    bool MultiChannelSession::IsJoined(const std::string& channelName) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return IsJoinedLocked(channelName);
+    }
+
+    std::string MultiChannelSession::GetTalkChannel() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_talkChannel;
+    }
+
+    std::vector<std::string> MultiChannelSession::GetChannels() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_channels;
+    }
+
+    size_t MultiChannelSession::GetConnectionCount() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_channels.size();
+    }
+
+    bool MultiChannelSession::IsJoinedLocked(const std::string& channelName) const
+    {
+        return std::find(m_channels.begin(), m_channels.end(), channelName) != m_channels.end();
+    }
+
+    int MultiChannelSession::SetTalkChannelLocked(const std::string& channelName)
+    {
+        if (channelName == m_talkChannel) return 0;
+        if (!channelName.empty() && !IsJoinedLocked(channelName)) return kErrInvalidArgument;
+
+        // Release the old talk channel before keying the new one
+        const std::string previous = m_talkChannel;
+        if (!previous.empty()) {
+            int result = m_engine.UpdateConnection(previous, false);
+            if (result != 0) return result;
+            m_talkChannel.clear();
+        }
+
+        if (channelName.empty()) return 0;
+
+        int result = m_engine.UpdateConnection(channelName, true);
+        if (result != 0) {
+            // Key the previous talker again rather than leave every radio silent
+            if (!previous.empty() && m_engine.UpdateConnection(previous, true) == 0) m_talkChannel = previous;
+            return result;
+        }
+
+        m_talkChannel = channelName;
+        return 0;
+    }
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Radio-console mode: one engine connection per monitored radio, at most one of
+// them publishing the microphone. This file has no Agora/WinRT dependencies so
+// it can be exercised headless against a fake engine.
+namespace winrt::FinalProject::implementation
+{
+    // Connection-level operations the session needs from the engine.
+    // AgoraManager implements this on top of IRtcEngineEx/RtcConnection.
+    class IConnectionEngine
+    {
+    public:
+        virtual ~IConnectionEngine() = default;
+
+        virtual int JoinConnection(const std::string& channelName, bool publishMicrophone) = 0;
+        virtual int UpdateConnection(const std::string& channelName, bool publishMicrophone) = 0;
+        virtual int LeaveConnection(const std::string& channelName) = 0;
+    };
+
+    class MultiChannelSession
+    {
+    public:
+        // Operators monitor 4-8 radios; anything beyond that is a caller bug.
+        static constexpr size_t kMaxConnections = 8;
+
+        // Return codes follow the SDK convention (0 = success, negative = error)
+        static constexpr int kErrInvalidArgument = -2;
+        static constexpr int kErrTooManyConnections = -17;
+
+        explicit MultiChannelSession(IConnectionEngine& engine) : m_engine(engine) {}
+
+        // Joins (or keeps) a connection for the radio. When talk is true the radio also
+        // becomes the talk channel; an already-joined radio is never rejoined. When the new
+        // talker can't be keyed, the previous one is keyed again and the error returned.
+        int Join(const std::string& channelName, bool talk);
+        int Leave(const std::string& channelName);
+
+        // Moves push-to-talk to another joined radio (empty name = nobody talks).
+        // Only media options are updated, the connections themselves stay up.
+        int SetTalkChannel(const std::string& channelName);
+        void LeaveAll();
+
+        bool IsJoined(const std::string& channelName) const;
+        std::string GetTalkChannel() const;
+        std::vector<std::string> GetChannels() const;
+        size_t GetConnectionCount() const;
+
+    private:
+        bool IsJoinedLocked(const std::string& channelName) const;
+        int SetTalkChannelLocked(const std::string& channelName);
+
+        IConnectionEngine& m_engine;
+        mutable std::mutex m_mutex;
+        std::vector<std::string> m_channels;
+        std::string m_talkChannel;
+    };
+}
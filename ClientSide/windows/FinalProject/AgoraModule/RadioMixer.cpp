@@ -0,0 +1,304 @@
+#include "RadioMixer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr float kFullScale = 32767.0f;
+
+        void ClampMix(RadioMix& mix)
+        {
+            mix.gainDb = std::max(RadioMixer::kMinGainDb, std::min(RadioMixer::kMaxGainDb, mix.gainDb));
+            mix.pan = std::max(-1.0f, std::min(1.0f, mix.pan));
+            mix.priority = std::max(0, std::min(RadioMixer::kMaxPriority, mix.priority));
+            if (mix.uid != 0) mix.priority = 0;
+        }
+
+        void ClampConfig(RadioMixerConfig& config)
+        {
+            config.duckDb = std::max(RadioMixer::kMinGainDb, std::min(0.0f, config.duckDb));
+            config.activityDb = std::max(-90.0f, std::min(0.0f, config.activityDb));
+            config.duckHoldMs = std::max(0, std::min(5000, config.duckHoldMs));
+            config.rampMs = std::max(1, std::min(500, config.rampMs));
+            for (auto& mix : config.mixes) ClampMix(mix);
+        }
+
+        // The bottom of the range is off rather than -60 dB
+        float DbToGain(float gainDb)
+        {
+            return gainDb <= RadioMixer::kMinGainDb ? 0.0f : std::pow(10.0f, gainDb / 20.0f);
+        }
+    }
+
+    RadioMixer::RadioMixer(const DspKernels& kernels) : m_kernels(kernels)
+    {
+    }
+
+    void RadioMixer::SetConfig(const RadioMixerConfig& config)
+    {
+        RadioMixerConfig clamped = config;
+        ClampConfig(clamped);
+        m_config.Update([&clamped](RadioMixerConfig& current) {
+            uint64_t version = current.version;
+            current = clamped;
+            current.version = version; // Update() bumps it
+        });
+    }
+
+    void RadioMixer::SetMix(const RadioMix& mix)
+    {
+        RadioMix clamped = mix;
+        ClampMix(clamped);
+        m_config.Update([&clamped](RadioMixerConfig& current) {
+            auto it = std::find_if(current.mixes.begin(), current.mixes.end(), [&clamped](const RadioMix& entry) {
+                return entry.channelName == clamped.channelName && entry.uid == clamped.uid;
+            });
+            // Back to neutral: nothing left to remember
+            bool neutral = clamped.gainDb == 0.0f && clamped.pan == 0.0f && clamped.priority == 0;
+            if (it != current.mixes.end()) {
+                if (neutral) {
+                    current.mixes.erase(it);
+                } else {
+                    *it = clamped;
+                }
+            } else if (!neutral) {
+                current.mixes.push_back(clamped);
+            }
+        });
+    }
+
+    RadioMixer::Stream* RadioMixer::FindStream(const char* channel, uint32_t uid)
+    {
+        for (Stream& stream : m_streams) {
+            if (stream.used && stream.uid == uid && std::strncmp(stream.channel, channel, kMaxChannelName - 1) == 0) {
+                return &stream;
+            }
+        }
+        return nullptr;
+    }
+
+    RadioMixer::Stream* RadioMixer::ClaimStream(const char* channel, uint32_t uid)
+    {
+        for (Stream& stream : m_streams) {
+            if (stream.used) continue;
+            stream.used = true;
+            std::strncpy(stream.channel, channel, kMaxChannelName - 1);
+            stream.channel[kMaxChannelName - 1] = '\0';
+            stream.uid = uid;
+            stream.fresh = false;
+            stream.idleFrames = 0;
+            stream.activeFrames = 0;
+            stream.resolvedVersion = ~0ull;
+            stream.rampLeft = 0;
+            stream.started = false;
+            return &stream;
+        }
+        return nullptr;
+    }
+
+    void RadioMixer::OnRemoteAudioFrame(const char* channel, uint32_t uid, const int16_t* samples,
+                                        int framesPerChannel, int channels, int sampleRate)
+    {
+        if (m_rebuild && channel && samples && sampleRate > 0) {
+            Stream* stream = FindStream(channel, uid);
+            if (!stream) stream = ClaimStream(channel, uid);
+            if (!stream || framesPerChannel <= 0 || framesPerChannel > kMaxFrames || channels < 1 || channels > 2) {
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                if (channels == 1) {
+                    std::memcpy(stream->staged, samples, static_cast<size_t>(framesPerChannel) * sizeof(int16_t));
+                } else {
+                    for (int i = 0; i < framesPerChannel; ++i) {
+                        stream->staged[i] = static_cast<int16_t>((samples[2 * i] + samples[2 * i + 1]) / 2);
+                    }
+                }
+                stream->stagedFrames = framesPerChannel;
+                stream->stagedRate = sampleRate;
+                stream->fresh = true;
+                stream->level = m_normalizing
+                    ? m_normalizer->Process(stream->channel, uid, stream->staged, framesPerChannel, sampleRate)
+                    : LoudnessGain{};
+
+                float power = m_kernels.sumSquares(stream->staged, static_cast<size_t>(framesPerChannel)) / framesPerChannel;
+                if (power >= m_activityPower) {
+                    // This frame and the hold after it, in frames of this length
+                    int64_t holdFrames = static_cast<int64_t>(m_duckHoldMs) * sampleRate / (1000ll * framesPerChannel);
+                    stream->activeFrames = 1 + static_cast<int>(holdFrames);
+                }
+            }
+        }
+        if (m_next) m_next->OnRemoteAudioFrame(channel, uid, samples, framesPerChannel, channels, sampleRate);
+    }
+
+    void RadioMixer::Resolve(const RadioMixerConfig& config, Stream& stream) const
+    {
+        if (!config.enabled) {
+            // Only levelling: every user as the SDK would have played them
+            stream.gain = 1.0f;
+            stream.pan = 0.0f;
+            stream.priority = 0;
+            stream.resolvedVersion = config.version;
+            return;
+        }
+
+        const RadioMix* radio = nullptr;
+        const RadioMix* user = nullptr;
+        for (const auto& mix : config.mixes) {
+            if (std::strncmp(mix.channelName.c_str(), stream.channel, kMaxChannelName - 1) != 0) continue;
+            if (mix.uid == 0) radio = &mix;
+            else if (mix.uid == stream.uid) user = &mix;
+        }
+
+        float gainDb = (radio ? radio->gainDb : 0.0f) + (user ? user->gainDb : 0.0f);
+        bool off = (radio && radio->gainDb <= kMinGainDb) || (user && user->gainDb <= kMinGainDb);
+        stream.gain = off ? 0.0f : DbToGain(std::max(kMinGainDb, std::min(kMaxGainDb, gainDb)));
+        stream.pan = user ? user->pan : (radio ? radio->pan : 0.0f);
+        stream.priority = radio ? radio->priority : 0;
+        stream.resolvedVersion = config.version;
+    }
+
+    void RadioMixer::Retarget(Stream& stream, int channels, bool ducked, int sampleRate)
+    {
+        float gain = stream.gain * (ducked ? m_duckGain : 1.0f);
+        float target[2];
+        if (channels == 2) {
+            // Balance law: centre plays at full level on both sides, a pan turns the far side down
+            target[0] = gain * std::min(1.0f, 1.0f - stream.pan);
+            target[1] = gain * std::min(1.0f, 1.0f + stream.pan);
+        } else {
+            target[0] = gain;
+            target[1] = 0.0f;
+        }
+
+        if (!stream.started) {
+            // A new talker starts from silence anyway: no fade-in
+            stream.started = true;
+            stream.rampLeft = 0;
+            for (int side = 0; side < 2; ++side) stream.current[side] = stream.target[side] = target[side];
+            return;
+        }
+        if (target[0] == stream.target[0] && target[1] == stream.target[1]) return;
+
+        // Ramps from wherever the last one got to, so a change mid-ramp doesn't jump
+        int rampSamples = std::max(1, sampleRate * m_rampMs / 1000);
+        for (int side = 0; side < 2; ++side) {
+            stream.target[side] = target[side];
+            stream.step[side] = (target[side] - stream.current[side]) / rampSamples;
+        }
+        stream.rampLeft = rampSamples;
+    }
+
+    void RadioMixer::MixStream(Stream& stream, int framesPerChannel, int channels)
+    {
+        int ramped = std::min(framesPerChannel, stream.rampLeft);
+        int rest = framesPerChannel - ramped;
+
+        // The normalizer's gain moves across the frame too: each segment ramps linearly between
+        // the products at its ends, which is within a rounding of the exact product
+        const LoudnessGain& level = stream.level;
+        float levelAtRamped = level.from + (level.to - level.from) * ramped / framesPerChannel;
+        for (int side = 0; side < channels; ++side) {
+            float* bus = m_bus[side];
+            if (ramped > 0) {
+                float from = stream.current[side] * level.from;
+                float to = (stream.current[side] + stream.step[side] * ramped) * levelAtRamped;
+                m_kernels.mixRamp(bus, stream.staged, static_cast<size_t>(ramped), from, (to - from) / ramped);
+            }
+            // Hard-panned away from this side: nothing to add
+            if (rest > 0 && stream.target[side] != 0.0f) {
+                float from = stream.target[side] * levelAtRamped;
+                float to = stream.target[side] * level.to;
+                m_kernels.mixRamp(bus + ramped, stream.staged + ramped, static_cast<size_t>(rest), from, (to - from) / rest);
+            }
+        }
+    }
+
+    bool RadioMixer::RenderInto(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        return static_cast<RadioMixer*>(context)->Render(samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool RadioMixer::Render(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        // Cheap when nothing changed: one reader count, a version compare per stream
+        m_config.Read([this](const RadioMixerConfig& config) {
+            if (config.version != m_preparedVersion) {
+                m_preparedVersion = config.version;
+                m_enabled = config.enabled;
+                m_duckGain = DbToGain(config.duckDb);
+                float threshold = std::pow(10.0f, config.activityDb / 20.0f) * kFullScale;
+                m_activityPower = threshold * threshold;
+                m_duckHoldMs = config.duckHoldMs;
+                m_rampMs = config.rampMs;
+            }
+            for (Stream& stream : m_streams) {
+                if (stream.used && stream.resolvedVersion != config.version) Resolve(config, stream);
+            }
+        });
+
+        m_normalizing = m_normalizer && m_normalizer->Prepare();
+        m_rebuild = m_enabled || m_normalizing;
+
+        bool usable = samples && framesPerChannel > 0 && framesPerChannel <= kMaxFrames && (channels == 1 || channels == 2) && sampleRate > 0;
+        if (!m_rebuild || !usable) {
+            for (Stream& stream : m_streams) {
+                stream.used = false;
+                stream.fresh = false;
+            }
+            m_activeStreams.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        int loudest = -1; // highest priority with someone speaking
+        for (const Stream& stream : m_streams) {
+            if (stream.used && stream.activeFrames > 0) loudest = std::max(loudest, stream.priority);
+        }
+
+        std::fill(m_bus[0], m_bus[0] + framesPerChannel, 0.0f);
+        if (channels == 2) std::fill(m_bus[1], m_bus[1] + framesPerChannel, 0.0f);
+
+        int mixed = 0;
+        int streams = 0;
+        bool ducking = false;
+        for (Stream& stream : m_streams) {
+            if (!stream.used) continue;
+
+            bool ducked = stream.priority < loudest;
+            Retarget(stream, channels, ducked, sampleRate);
+            if (stream.fresh && stream.stagedFrames == framesPerChannel && stream.stagedRate == sampleRate) {
+                MixStream(stream, framesPerChannel, channels);
+                ducking = ducking || ducked;
+                ++mixed;
+                stream.idleFrames = 0;
+            } else if (stream.fresh) {
+                // Not the output format: the SDK was asked for the same rate, so this is a misconfiguration
+                m_droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            } else if (++stream.idleFrames > kIdleFrames) {
+                stream.used = false;
+                continue;
+            }
+
+            // The ramp runs on the clock, heard or not
+            int advanced = std::min(framesPerChannel, stream.rampLeft);
+            stream.rampLeft -= advanced;
+            for (int side = 0; side < 2; ++side) {
+                stream.current[side] = stream.rampLeft == 0 ? stream.target[side] : stream.current[side] + stream.step[side] * advanced;
+            }
+            stream.fresh = false;
+            if (stream.activeFrames > 0) --stream.activeFrames;
+            ++streams;
+        }
+        m_activeStreams.store(streams, std::memory_order_relaxed);
+
+        // Nobody this frame: leave whatever the SDK mixed
+        if (mixed == 0) return false;
+
+        m_kernels.storeMix(samples, m_bus[0], channels == 2 ? m_bus[1] : nullptr, static_cast<size_t>(framesPerChannel));
+        m_renderedFrames.fetch_add(1, std::memory_order_relaxed);
+        if (ducking) m_duckedFrames.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
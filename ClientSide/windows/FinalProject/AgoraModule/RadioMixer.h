@@ -0,0 +1,144 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "AgoraState.h"
+#include "AudioDsp.h"
+#include "LoudnessNormalizer.h"
+#include "VoiceEngine.h"
+
+// Console playback mixer. Rebuilds what we hear from each radio user's own frames (taken before
+// the SDK mixes them) with a gain and stereo pan per radio and per user, so an operator can put
+// radios left and right and tell them apart by ear. While someone talks on a radio with a higher
+// priority, the other radios are ducked by a set amount. Every gain, pan and ducking change
+// ramps linearly, sample by sample, so nothing clicks. With a loudness normalizer attached and
+// enabled, each user is also levelled, and playback is rebuilt even with the mixer itself off
+// (every radio centred at unity, nobody ducked).
+//
+// OnRemoteAudioFrame stages each user's frame and Render mixes the staged frames over the
+// playback frame that follows; the engine calls both from its playback thread. Neither
+// allocates, locks or logs. Settings are published from any thread as snapshots.
+namespace winrt::FinalProject::implementation
+{
+    // One radio (uid 0) or one user on a radio
+    struct RadioMix
+    {
+        std::string channelName;
+        uint32_t uid = 0;     // 0 = the whole radio
+        float gainDb = 0.0f;  // a user's is added to the radio's
+        float pan = 0.0f;     // -1 left, 0 centre, +1 right; a user's replaces the radio's
+        int priority = 0;     // radio only: higher ducks lower while someone talks on it
+    };
+
+    struct RadioMixerConfig
+    {
+        uint64_t version = 0; // bumped by SnapshotCell
+
+        bool enabled = false;       // false: the SDK's own mix plays untouched
+        float duckDb = -12.0f;      // on every radio below the highest one with a speaker
+        float activityDb = -45.0f;  // frame RMS (dBFS) that counts as someone speaking
+        int duckHoldMs = 300;       // ducking stays this long after the priority speaker stops
+        int rampMs = 20;            // length of every gain or pan change
+        std::vector<RadioMix> mixes;
+    };
+
+    class RadioMixer : public IRemoteAudioSink
+    {
+    public:
+        static constexpr int kMaxStreams = 16;
+        static constexpr int kMaxFrames = 960;     // per channel: 10 ms at up to 96 kHz
+        static constexpr int kIdleFrames = 50;     // a user unheard for 500 ms gives up the slot
+        static constexpr size_t kMaxChannelName = 65;
+        static constexpr float kMinGainDb = -60.0f;
+        static constexpr float kMaxGainDb = 12.0f;
+        static constexpr int kMaxPriority = 9;
+
+        explicit RadioMixer(const DspKernels& kernels = GetDspKernels());
+
+        RadioMixer(const RadioMixer&) = delete;
+        RadioMixer& operator=(const RadioMixer&) = delete;
+
+        // Set once before frames start flowing: also gets every frame (the replay recorder)
+        void SetNext(IRemoteAudioSink* next) { m_next = next; }
+        void SetNormalizer(LoudnessNormalizer* normalizer) { m_normalizer = normalizer; }
+
+        // Any thread. SetMix replaces the entry for its channel and uid; values are clamped.
+        void SetConfig(const RadioMixerConfig& config);
+        void SetMix(const RadioMix& mix);
+        RadioMixerConfig GetConfig() const { return m_config.Load(); }
+
+        // Audio thread: stages the frame for the next Render (mono, downmixed if need be)
+        void OnRemoteAudioFrame(const char* channel, uint32_t uid, const int16_t* samples,
+                                int framesPerChannel, int channels, int sampleRate) override;
+
+        // Audio thread: overwrites the frame with the staged users' mix; false (frame untouched)
+        // when neither mixing nor levelling or nobody was staged. AudioPipeline frame source.
+        static bool RenderInto(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        bool Render(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        // Any thread
+        int GetActiveStreams() const { return m_activeStreams.load(std::memory_order_relaxed); }
+        uint64_t GetRenderedFrames() const { return m_renderedFrames.load(std::memory_order_relaxed); }
+        uint64_t GetDuckedFrames() const { return m_duckedFrames.load(std::memory_order_relaxed); }
+        uint64_t GetDroppedFrames() const { return m_droppedFrames.load(std::memory_order_relaxed); }
+        DspIsa GetIsa() const { return m_kernels.isa; }
+
+    private:
+        struct Stream
+        {
+            bool used = false;
+            char channel[kMaxChannelName] = {};
+            uint32_t uid = 0;
+
+            int16_t staged[kMaxFrames] = {};
+            int stagedFrames = 0;
+            int stagedRate = 0;
+            bool fresh = false;   // staged since the last Render
+            int idleFrames = 0;
+            int activeFrames = 0; // > 0 while speaking, counting down the hold
+            LoudnessGain level;   // the normalizer's gain across the staged frame
+
+            uint64_t resolvedVersion = ~0ull;
+            float gain = 1.0f;    // linear, radio and user
+            float pan = 0.0f;
+            int priority = 0;
+
+            // Per output side, what is applied now and where the ramp is heading
+            float current[2] = { 1.0f, 0.0f };
+            float target[2] = { 1.0f, 0.0f };
+            float step[2] = {};
+            int rampLeft = 0;
+            bool started = false; // first Render jumps straight to the target
+        };
+
+        Stream* FindStream(const char* channel, uint32_t uid);
+        Stream* ClaimStream(const char* channel, uint32_t uid);
+        void Resolve(const RadioMixerConfig& config, Stream& stream) const;
+        void Retarget(Stream& stream, int channels, bool ducked, int sampleRate);
+        void MixStream(Stream& stream, int framesPerChannel, int channels);
+
+        const DspKernels& m_kernels;
+        SnapshotCell<RadioMixerConfig> m_config;
+        IRemoteAudioSink* m_next = nullptr;
+        LoudnessNormalizer* m_normalizer = nullptr;
+
+        // Audio-thread state
+        Stream m_streams[kMaxStreams];
+        uint64_t m_preparedVersion = ~0ull;
+        bool m_enabled = false;       // pans, gains and ducking
+        bool m_normalizing = false;
+        bool m_rebuild = false;       // either of them: stage users and render playback
+        float m_duckGain = 1.0f;
+        float m_activityPower = 0.0f; // mean square per sample that counts as speaking
+        int m_duckHoldMs = 0;
+        int m_rampMs = 0;
+        alignas(32) float m_bus[2][kMaxFrames] = {};
+
+        std::atomic<int> m_activeStreams{ 0 };
+        std::atomic<uint64_t> m_renderedFrames{ 0 };
+        std::atomic<uint64_t> m_duckedFrames{ 0 };
+        std::atomic<uint64_t> m_droppedFrames{ 0 };
+    };
+}
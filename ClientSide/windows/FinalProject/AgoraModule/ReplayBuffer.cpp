@@ -0,0 +1,389 @@
+#include "ReplayBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr int kSamplesPerMs = ReplayBlock::kSampleRate / 1000;
+        // Frames of one talker this close to where the previous one ended are butted together
+        constexpr size_t kJoinToleranceSamples = 3 * ReplayBlock::kSamples;
+
+        inline int16_t Saturate(int32_t value)
+        {
+            return static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+        }
+    }
+
+    // ReplayRing implementation
+    ReplayRing::ReplayRing(const std::string& channelName, size_t blockCount)
+        : m_channelName(channelName), m_capacity(std::max<size_t>(1, blockCount)), m_slots(new Slot[m_capacity])
+    {
+    }
+
+    ReplayRing::Talker& ReplayRing::TalkerFor(uint32_t uid)
+    {
+        Talker* oldest = &m_talkers[0];
+        for (auto& talker : m_talkers) {
+            if (talker.uid == uid && talker.endMs != 0) return talker;
+            if (talker.endMs < oldest->endMs) oldest = &talker;
+        }
+        // New talker takes the least recently heard entry; a fresh state costs a few samples of accuracy
+        *oldest = Talker{ uid, 0, AdpcmState{} };
+        return *oldest;
+    }
+
+    void ReplayRing::Append(uint32_t uid, uint64_t timeMs, const int16_t* samples)
+    {
+        Talker& talker = TalkerFor(uid);
+        if (talker.endMs > timeMs && talker.endMs <= timeMs + kMaxLeadMs) {
+            timeMs = talker.endMs;
+        }
+        talker.endMs = timeMs + 10;
+
+        AdpcmState start = talker.state;
+        uint64_t packed[kWords] = {};
+        AdpcmEncode(samples, ReplayBlock::kSamples, reinterpret_cast<uint8_t*>(packed), talker.state);
+
+        uint64_t block = m_written.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[block % m_capacity];
+        slot.sequence.store(block * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.uid.store(uid, std::memory_order_relaxed);
+        slot.state.store(static_cast<uint32_t>(static_cast<uint16_t>(start.predictor)) << 8 | start.stepIndex, std::memory_order_relaxed);
+        slot.timeMs.store(timeMs, std::memory_order_relaxed);
+        for (size_t i = 0; i < kWords; ++i) {
+            slot.words[i].store(packed[i], std::memory_order_relaxed);
+        }
+        slot.sequence.store((block + 1) * 2, std::memory_order_release);
+        m_written.store(block + 1, std::memory_order_release);
+    }
+
+    void ReplayRing::Snapshot(uint64_t sinceMs, uint32_t uid, std::vector<ReplayBlock>& out) const
+    {
+        out.clear();
+        uint64_t written = m_written.load(std::memory_order_acquire);
+        uint64_t oldest = written > m_capacity ? written - m_capacity : 0;
+
+        // Newest first; once a slot has been overwritten everything older is gone too
+        for (uint64_t block = written; block > oldest; --block) {
+            const Slot& slot = m_slots[(block - 1) % m_capacity];
+            uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != block * 2) break;
+
+            ReplayBlock copy;
+            copy.uid = slot.uid.load(std::memory_order_relaxed);
+            uint32_t state = slot.state.load(std::memory_order_relaxed);
+            copy.timeMs = slot.timeMs.load(std::memory_order_relaxed);
+            uint64_t packed[kWords];
+            for (size_t i = 0; i < kWords; ++i) {
+                packed[i] = slot.words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) break;
+
+            if (copy.timeMs < sinceMs) break;
+            if (uid != 0 && copy.uid != uid) continue;
+            copy.state.predictor = static_cast<int16_t>(static_cast<uint16_t>(state >> 8));
+            copy.state.stepIndex = static_cast<uint8_t>(state & 0xFF);
+            std::memcpy(copy.data, packed, ReplayBlock::kBytes);
+            out.push_back(copy);
+        }
+        std::reverse(out.begin(), out.end());
+    }
+
+    // ReplayRecorder implementation
+    size_t ReplayRecorder::BytesPerSecond()
+    {
+        return ReplayRing(std::string(), 100).GetMemoryBytes() - sizeof(ReplayRing);
+    }
+
+    uint64_t ReplayRecorder::NowMs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    bool ReplayRecorder::SetCapacity(const std::string& channelName, int seconds)
+    {
+        seconds = std::min(seconds, kMaxSeconds);
+        std::atomic<ReplayRing*>* freeSlot = nullptr;
+        for (auto& slot : m_rings) {
+            ReplayRing* ring = slot.load(std::memory_order_acquire);
+            if (!ring) {
+                if (!freeSlot) freeSlot = &slot;
+                continue;
+            }
+            if (ring->GetChannelName() != channelName) continue;
+
+            if (seconds > 0 && ring->GetCapacity() == static_cast<size_t>(seconds) * 100) return true;
+            ReplayRing* replacement = seconds > 0 ? new ReplayRing(channelName, static_cast<size_t>(seconds) * 100) : nullptr;
+            Retire(slot.exchange(replacement, std::memory_order_acq_rel));
+            return true;
+        }
+
+        if (seconds <= 0) return true;
+        if (!freeSlot) return false;
+        freeSlot->store(new ReplayRing(channelName, static_cast<size_t>(seconds) * 100), std::memory_order_release);
+        return true;
+    }
+
+    void ReplayRecorder::Clear()
+    {
+        for (auto& slot : m_rings) {
+            Retire(slot.exchange(nullptr, std::memory_order_acq_rel));
+        }
+    }
+
+    ReplayRecorder::UseScope::UseScope(const ReplayRecorder& recorder)
+    {
+        // Re-check after counting in: a retire that flipped the epoch meanwhile isn't waiting on us
+        for (;;) {
+            uint32_t epoch = recorder.m_epoch.load();
+            m_users = &recorder.m_users[epoch & 1];
+            m_users->fetch_add(1);
+            if (recorder.m_epoch.load() == epoch) return;
+            m_users->fetch_sub(1);
+        }
+    }
+
+    // Unpublished already; wait out anyone who may have loaded it before the swap.
+    // Worker thread only, so retires never overlap.
+    void ReplayRecorder::Retire(ReplayRing* ring)
+    {
+        if (!ring) return;
+        uint32_t epoch = m_epoch.fetch_add(1);
+        while (m_users[epoch & 1].load() != 0) {
+            std::this_thread::yield();
+        }
+        delete ring;
+    }
+
+    ReplayRing* ReplayRecorder::Find(const char* channelName) const
+    {
+        for (const auto& slot : m_rings) {
+            ReplayRing* ring = slot.load(std::memory_order_acquire);
+            if (ring && std::strcmp(ring->GetChannelName().c_str(), channelName) == 0) return ring;
+        }
+        return nullptr;
+    }
+
+    void ReplayRecorder::OnRemoteAudioFrame(const char* channel, uint32_t uid, const int16_t* samples,
+                                            int framesPerChannel, int channels, int sampleRate)
+    {
+        Record(channel, uid, samples, framesPerChannel, channels, sampleRate, NowMs());
+    }
+
+    void ReplayRecorder::Record(const char* channel, uint32_t uid, const int16_t* samples,
+                                int framesPerChannel, int channels, int sampleRate, uint64_t nowMs)
+    {
+        if (!channel || !samples || framesPerChannel <= 0 || channels < 1 || channels > 2) return;
+        // Whole-number downsampling only (16, 32 and 48 kHz); the SDK delivers what we asked for
+        if (sampleRate < ReplayBlock::kSampleRate || sampleRate % ReplayBlock::kSampleRate != 0) return;
+        int ratio = sampleRate / ReplayBlock::kSampleRate;
+        int inputPerBlock = ReplayBlock::kSamples * ratio;
+
+        UseScope scope(*this);
+        ReplayRing* ring = Find(channel);
+        if (!ring) return;
+
+        int16_t block[ReplayBlock::kSamples];
+        int divisor = ratio * channels;
+        for (int start = 0; start + inputPerBlock <= framesPerChannel; start += inputPerBlock) {
+            const int16_t* input = samples + static_cast<size_t>(start) * channels;
+            int peak = 0;
+            for (int i = 0; i < ReplayBlock::kSamples; ++i) {
+                int32_t sum = 0;
+                for (int j = 0; j < divisor; ++j) sum += input[i * divisor + j];
+                block[i] = static_cast<int16_t>(sum / divisor);
+                peak = std::max(peak, std::abs(static_cast<int>(block[i])));
+            }
+            if (peak < kSilencePeak) continue;
+            ring->Append(uid, nowMs + static_cast<uint64_t>(start / (inputPerBlock / 10)), block);
+        }
+    }
+
+    bool ReplayRecorder::Snapshot(const std::string& channelName, int seconds, uint32_t uid, uint64_t nowMs,
+                                  std::vector<ReplayBlock>& blocks) const
+    {
+        blocks.clear();
+        uint64_t windowMs = static_cast<uint64_t>(std::max(0, std::min(seconds, kMaxSeconds))) * 1000;
+        uint64_t sinceMs = nowMs > windowMs ? nowMs - windowMs : 0;
+
+        UseScope scope(*this);
+        ReplayRing* ring = Find(channelName.c_str());
+        if (!ring) return false;
+        ring->Snapshot(sinceMs, uid, blocks);
+        // Ring order is arrival order; a talker stamped ahead of the clock can be out of time order
+        std::stable_sort(blocks.begin(), blocks.end(),
+            [](const ReplayBlock& a, const ReplayBlock& b) { return a.timeMs < b.timeMs; });
+        return !blocks.empty();
+    }
+
+    bool ReplayRecorder::BuildClip(const std::string& channelName, int seconds, uint32_t uid, uint64_t nowMs,
+                                   std::vector<int16_t>& pcm) const
+    {
+        pcm.clear();
+        std::vector<ReplayBlock> blocks;
+        if (!Snapshot(channelName, seconds, uid, nowMs, blocks)) return false;
+
+        // Timeline from the block times: talkers overlap where they overlapped on air,
+        // long silences shrink to kMaxGapMs
+        struct Cursor { uint32_t uid; size_t next; };
+        std::vector<Cursor> cursors;
+        uint64_t startMs = blocks.front().timeMs;
+        uint64_t lastEndMs = startMs;
+        uint64_t skippedMs = 0;
+        int16_t decoded[ReplayBlock::kSamples];
+
+        for (const auto& block : blocks) {
+            if (block.timeMs > lastEndMs + kMaxGapMs) {
+                skippedMs += block.timeMs - lastEndMs - kMaxGapMs;
+            }
+            lastEndMs = std::max(lastEndMs, block.timeMs + 10);
+            size_t position = static_cast<size_t>(block.timeMs - startMs - skippedMs) * kSamplesPerMs;
+
+            // The audio thread stamps frames in bursts; consecutive frames of a talker stay back to back
+            auto cursor = std::find_if(cursors.begin(), cursors.end(), [&block](const Cursor& c) { return c.uid == block.uid; });
+            if (cursor == cursors.end()) {
+                cursors.push_back({ block.uid, position });
+                cursor = cursors.end() - 1;
+            } else if (position + kJoinToleranceSamples >= cursor->next && position <= cursor->next + kJoinToleranceSamples) {
+                position = cursor->next;
+            }
+            cursor->next = position + ReplayBlock::kSamples;
+
+            AdpcmState state = block.state;
+            AdpcmDecode(block.data, ReplayBlock::kSamples, decoded, state);
+            if (pcm.size() < position + ReplayBlock::kSamples) pcm.resize(position + ReplayBlock::kSamples, 0);
+            for (int i = 0; i < ReplayBlock::kSamples; ++i) {
+                pcm[position + i] = Saturate(pcm[position + i] + decoded[i]);
+            }
+        }
+        return true;
+    }
+
+    std::vector<ReplaySpurt> ReplayRecorder::GetIndex(const std::string& channelName, int seconds, uint64_t nowMs) const
+    {
+        std::vector<ReplaySpurt> spurts;
+        std::vector<ReplayBlock> blocks;
+        if (!Snapshot(channelName, seconds, 0, nowMs, blocks)) return spurts;
+
+        std::vector<size_t> open; // index into spurts of each uid's latest spurt
+        for (const auto& block : blocks) {
+            auto it = std::find_if(open.begin(), open.end(), [&](size_t i) { return spurts[i].uid == block.uid; });
+            if (it != open.end() && block.timeMs <= spurts[*it].endMs + kSpurtGapMs) {
+                spurts[*it].endMs = std::max(spurts[*it].endMs, block.timeMs + 10);
+                continue;
+            }
+            spurts.push_back({ block.uid, block.timeMs, block.timeMs + 10 });
+            if (it != open.end()) *it = spurts.size() - 1;
+            else open.push_back(spurts.size() - 1);
+        }
+        return spurts;
+    }
+
+    int ReplayRecorder::GetCapacitySeconds(const std::string& channelName) const
+    {
+        UseScope scope(*this);
+        ReplayRing* ring = Find(channelName.c_str());
+        return ring ? static_cast<int>(ring->GetCapacity() / 100) : 0;
+    }
+
+    size_t ReplayRecorder::GetMemoryBytes() const
+    {
+        UseScope scope(*this);
+        size_t bytes = 0;
+        for (const auto& slot : m_rings) {
+            if (ReplayRing* ring = slot.load(std::memory_order_acquire)) bytes += ring->GetMemoryBytes();
+        }
+        return bytes;
+    }
+
+    // ReplayPlayer implementation
+    ReplayPlayer::~ReplayPlayer()
+    {
+        // The pipeline is detached by now; nothing on the audio thread holds a clip
+        m_pending.store(nullptr);
+        m_current = nullptr;
+    }
+
+    void ReplayPlayer::Play(std::vector<int16_t> pcm, int sampleRate)
+    {
+        CollectFinished();
+
+        auto clip = std::make_unique<Clip>();
+        clip->samples = std::move(pcm);
+        clip->sampleRate = std::max(1, sampleRate);
+        Clip* published = clip.get();
+        m_clips.push_back(std::move(clip));
+
+        // Replaced before the audio thread ever saw it
+        if (Clip* stale = m_pending.exchange(published, std::memory_order_acq_rel)) {
+            stale->finished.store(true, std::memory_order_release);
+        }
+    }
+
+    bool ReplayPlayer::IsPlaying() const
+    {
+        Clip* pending = m_pending.load(std::memory_order_acquire);
+        return m_playing.load(std::memory_order_acquire) || (pending && !pending->samples.empty());
+    }
+
+    void ReplayPlayer::CollectFinished()
+    {
+        m_clips.erase(std::remove_if(m_clips.begin(), m_clips.end(),
+            [](const std::unique_ptr<Clip>& clip) { return clip->finished.load(std::memory_order_acquire); }),
+            m_clips.end());
+    }
+
+    bool ReplayPlayer::MixInto(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        return static_cast<ReplayPlayer*>(context)->Mix(samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool ReplayPlayer::Mix(int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        if (Clip* next = m_pending.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (m_current) m_current->finished.store(true, std::memory_order_release);
+            m_current = next;
+            m_playing.store(!next->samples.empty(), std::memory_order_release);
+        }
+        if (!m_current || sampleRate <= 0) return false;
+
+        Clip& clip = *m_current;
+        const size_t count = clip.samples.size();
+        const uint64_t step = (static_cast<uint64_t>(clip.sampleRate) << 16) / static_cast<uint64_t>(sampleRate);
+        bool done = count == 0;
+
+        // Linear interpolation is plenty for narrowband speech going up to the playback rate
+        for (int frame = 0; frame < framesPerChannel && !done; ++frame) {
+            size_t index = static_cast<size_t>(clip.positionQ16 >> 16);
+            if (index >= count) {
+                done = true;
+                break;
+            }
+            int32_t a = clip.samples[index];
+            int32_t b = index + 1 < count ? clip.samples[index + 1] : a;
+            int32_t fraction = static_cast<int32_t>(clip.positionQ16 & 0xFFFF);
+            int32_t value = a + (((b - a) * fraction) >> 16);
+
+            int16_t* out = samples + static_cast<size_t>(frame) * channels;
+            for (int channel = 0; channel < channels; ++channel) {
+                out[channel] = Saturate(out[channel] + value);
+            }
+            clip.positionQ16 += step;
+        }
+
+        if (done || (clip.positionQ16 >> 16) >= count) {
+            m_playing.store(false, std::memory_order_release);
+            clip.finished.store(true, std::memory_order_release);
+            m_current = nullptr;
+        }
+        return count != 0;
+    }
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ImaAdpcm.h"
+#include "VoiceEngine.h"
+
+// Instant replay for monitored radios. Every remote user's audio (before mixing) is
+// reduced to 16 kHz mono, ADPCM-coded in 10 ms blocks and written into a fixed ring per
+// channel, tagged with the talker's uid and time. Replays are decoded on the worker and
+// mixed into local playback by ReplayPlayer; nothing goes back out to the network.
+namespace winrt::FinalProject::implementation
+{
+    struct ReplayBlock
+    {
+        static constexpr int kSampleRate = 16000; // narrowband is plenty for a replay
+        static constexpr int kSamples = kSampleRate / 100; // 10 ms
+        static constexpr size_t kBytes = AdpcmBytes(kSamples);
+
+        uint32_t uid = 0;
+        uint64_t timeMs = 0;
+        AdpcmState state;  // encoder state at the block start, so every block decodes on its own
+        uint8_t data[kBytes] = {};
+    };
+
+    // One talk spurt: uid was heard from startMs to endMs (recorder clock)
+    struct ReplaySpurt
+    {
+        uint32_t uid = 0;
+        uint64_t startMs = 0;
+        uint64_t endMs = 0;
+    };
+
+    // Fixed ring of coded blocks for one channel. One writer (the audio thread), any number
+    // of lock-free readers: each slot is a seqlock, so a reader skips what was overwritten.
+    class ReplayRing
+    {
+    public:
+        static constexpr size_t kMaxTalkers = 16; // encoder states kept per ring
+        static constexpr uint64_t kMaxLeadMs = 2000; // how far a burst of frames may run ahead of the clock
+
+        ReplayRing(const std::string& channelName, size_t blockCount);
+
+        ReplayRing(const ReplayRing&) = delete;
+        ReplayRing& operator=(const ReplayRing&) = delete;
+
+        const std::string& GetChannelName() const { return m_channelName; }
+        size_t GetCapacity() const { return m_capacity; }
+        size_t GetMemoryBytes() const { return sizeof(*this) + m_capacity * sizeof(Slot); }
+
+        // Audio thread: codes one block of ReplayBlock::kSamples samples. A talker's blocks are
+        // contiguous, so a block that arrives early is stamped where the previous one ended.
+        void Append(uint32_t uid, uint64_t timeMs, const int16_t* samples);
+
+        // Any thread: blocks at or after sinceMs (uid 0 = everyone), in write order
+        void Snapshot(uint64_t sinceMs, uint32_t uid, std::vector<ReplayBlock>& out) const;
+
+    private:
+        static constexpr size_t kWords = (ReplayBlock::kBytes + 7) / 8;
+
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence{ 0 }; // odd while written, else 2 * (block number + 1)
+            std::atomic<uint32_t> uid{ 0 };
+            std::atomic<uint32_t> state{ 0 };    // predictor << 8 | step index
+            std::atomic<uint64_t> timeMs{ 0 };
+            std::array<std::atomic<uint64_t>, kWords> words{};
+        };
+
+        struct Talker
+        {
+            uint32_t uid = 0;
+            uint64_t endMs = 0; // end of the last block; 0 = unused
+            AdpcmState state;
+        };
+
+        Talker& TalkerFor(uint32_t uid);
+
+        const std::string m_channelName;
+        const size_t m_capacity;
+        std::unique_ptr<Slot[]> m_slots;
+        std::atomic<uint64_t> m_written{ 0 };
+        std::array<Talker, kMaxTalkers> m_talkers{}; // audio thread only
+    };
+
+    // Rings for up to kMaxChannels channels, fed with per-user frames by the engine
+    class ReplayRecorder : public IRemoteAudioSink
+    {
+    public:
+        static constexpr size_t kMaxChannels = 16;
+        static constexpr int kDefaultSeconds = 60;
+        static constexpr int kMaxSeconds = 600;
+        static constexpr int kSilencePeak = 64;  // about -54 dBFS; quieter blocks are not stored
+        static constexpr int kMaxGapMs = 500;    // longer silences are shortened in a replay
+        static constexpr int kSpurtGapMs = 300;  // index: pauses shorter than this stay in one spurt
+
+        ReplayRecorder() = default;
+        ~ReplayRecorder() override { Clear(); }
+
+        ReplayRecorder(const ReplayRecorder&) = delete;
+        ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+        // Ring memory per second of stored audio (silence is not stored)
+        static size_t BytesPerSecond();
+        static uint64_t NowMs();
+
+        // Worker thread. seconds <= 0 drops the channel's ring; false if every slot is taken.
+        // A resize starts an empty ring.
+        bool SetCapacity(const std::string& channelName, int seconds);
+        void Remove(const std::string& channelName) { SetCapacity(channelName, 0); }
+        void Clear();
+
+        // Audio thread
+        void OnRemoteAudioFrame(const char* channel, uint32_t uid, const int16_t* samples,
+                                int framesPerChannel, int channels, int sampleRate) override;
+        void Record(const char* channel, uint32_t uid, const int16_t* samples,
+                    int framesPerChannel, int channels, int sampleRate, uint64_t nowMs);
+
+        // Any thread. The last seconds of the channel as 16 kHz mono PCM (uid 0 = everyone);
+        // false when nothing was heard.
+        bool BuildClip(const std::string& channelName, int seconds, uint32_t uid, uint64_t nowMs,
+                       std::vector<int16_t>& pcm) const;
+        std::vector<ReplaySpurt> GetIndex(const std::string& channelName, int seconds, uint64_t nowMs) const;
+        int GetCapacitySeconds(const std::string& channelName) const;
+        size_t GetMemoryBytes() const;
+
+    private:
+        // Holds off ring deletion while the audio thread or a reader is inside. Users count
+        // under the current epoch, so a retire only waits for those who came in before it.
+        class UseScope
+        {
+        public:
+            explicit UseScope(const ReplayRecorder& recorder);
+            ~UseScope() { m_users->fetch_sub(1); }
+        private:
+            std::atomic<int>* m_users;
+        };
+
+        ReplayRing* Find(const char* channelName) const;
+        bool Snapshot(const std::string& channelName, int seconds, uint32_t uid, uint64_t nowMs,
+                      std::vector<ReplayBlock>& blocks) const;
+        void Retire(ReplayRing* ring);
+
+        std::array<std::atomic<ReplayRing*>, kMaxChannels> m_rings{};
+        mutable std::array<std::atomic<int>, 2> m_users{}; // per epoch parity
+        std::atomic<uint32_t> m_epoch{ 0 };
+    };
+
+    // Plays one clip at a time into the playback pipeline (AudioPipeline mix source)
+    class ReplayPlayer
+    {
+    public:
+        ReplayPlayer() = default;
+        ~ReplayPlayer();
+
+        ReplayPlayer(const ReplayPlayer&) = delete;
+        ReplayPlayer& operator=(const ReplayPlayer&) = delete;
+
+        // Worker thread: replaces whatever is playing
+        void Play(std::vector<int16_t> pcm, int sampleRate);
+        void Stop() { Play({}, ReplayBlock::kSampleRate); }
+        bool IsPlaying() const;
+
+        // Audio thread: resamples and adds the clip to the frame
+        static bool MixInto(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        bool Mix(int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+    private:
+        struct Clip
+        {
+            std::vector<int16_t> samples;
+            int sampleRate = ReplayBlock::kSampleRate;
+            uint64_t positionQ16 = 0;          // audio thread only
+            std::atomic<bool> finished{ false }; // set once the audio thread let go of it
+        };
+
+        void CollectFinished();
+
+        std::atomic<Clip*> m_pending{ nullptr };
+        Clip* m_current = nullptr;                // audio thread only
+        std::atomic<bool> m_playing{ false };
+        std::vector<std::unique_ptr<Clip>> m_clips; // worker thread only
+    };
+}
@@ -0,0 +1,305 @@
+#include "ToneEngine.h"
+#include "AudioDsp.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr double kPi = 3.14159265358979323846;
+        constexpr int kRampMs = 5; // raised-cosine fade at both ends of every burst, so nothing clicks
+        constexpr size_t kAlignSamples = ToneBank::kAlignment / sizeof(int16_t);
+
+        // One burst: a single tone, or two summed (highHz != 0) like a telephone ring
+        struct Burst
+        {
+            int startMs;
+            int lengthMs;
+            double lowHz;
+            double highHz;
+        };
+
+        struct CueSpec
+        {
+            const char* name;
+            Burst bursts[2];
+            int burstCount;
+            int durationMs;
+            int periodMs;
+        };
+
+        const CueSpec kCues[kToneCueCount] = {
+            { "talkStart", { { 0, 40, 1000.0, 0.0 }, { 60, 40, 1400.0, 0.0 } }, 2, 100, 0 },
+            { "talkEnd", { { 0, 40, 1400.0, 0.0 }, { 60, 40, 1000.0, 0.0 } }, 2, 100, 0 },
+            { "roger", { { 0, 70, 1200.0, 0.0 }, { 70, 70, 1800.0, 0.0 } }, 2, 140, 0 },
+            { "ring", { { 0, 400, 400.0, 450.0 }, { 600, 400, 400.0, 450.0 } }, 2, 1000, 3000 },
+            { "ringback", { { 0, 1000, 440.0, 480.0 }, {} }, 1, 1000, 4000 },
+        };
+
+        size_t SamplesFor(int ms, int sampleRate)
+        {
+            return static_cast<size_t>(ms) * static_cast<size_t>(sampleRate) / 1000;
+        }
+
+        size_t Padded(size_t count)
+        {
+            return (count + kAlignSamples - 1) / kAlignSamples * kAlignSamples;
+        }
+
+        void Synthesize(const CueSpec& spec, int sampleRate, int16_t* out)
+        {
+            const size_t ramp = std::max<size_t>(1, SamplesFor(kRampMs, sampleRate));
+            for (int b = 0; b < spec.burstCount; ++b) {
+                const Burst& burst = spec.bursts[b];
+                const size_t start = SamplesFor(burst.startMs, sampleRate);
+                const size_t length = SamplesFor(burst.lengthMs, sampleRate);
+                const double amplitude = burst.highHz > 0.0 ? 16383.0 : 32767.0;
+                for (size_t i = 0; i < length; ++i) {
+                    double t = static_cast<double>(i) / sampleRate;
+                    double value = std::sin(2.0 * kPi * burst.lowHz * t);
+                    if (burst.highHz > 0.0) value += std::sin(2.0 * kPi * burst.highHz * t);
+
+                    size_t edge = std::min(i, length - 1 - i);
+                    double envelope = edge < ramp ? 0.5 - 0.5 * std::cos(kPi * static_cast<double>(edge) / ramp) : 1.0;
+                    long sample = std::lround(amplitude * envelope * value);
+                    out[start + i] = static_cast<int16_t>(std::max(-32767L, std::min(32767L, sample)));
+                }
+            }
+        }
+
+        inline int16_t Saturate(int32_t value)
+        {
+            return static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+        }
+
+        // Adds count tone samples, scaled by gainQ12, to every channel of count frames
+        void AddScaled(int16_t* frames, int channels, const int16_t* tone, size_t count, int32_t gainQ12)
+        {
+            if (channels == 1) {
+                for (size_t i = 0; i < count; ++i) {
+                    frames[i] = Saturate(frames[i] + ((tone[i] * gainQ12 + 2048) >> 12));
+                }
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                int32_t value = (tone[i] * gainQ12 + 2048) >> 12;
+                int16_t* out = frames + i * channels;
+                for (int channel = 0; channel < channels; ++channel) out[channel] = Saturate(out[channel] + value);
+            }
+        }
+    }
+
+    const char* ToneCueName(ToneCue cue)
+    {
+        size_t index = static_cast<size_t>(cue);
+        return index < kToneCueCount ? kCues[index].name : "unknown";
+    }
+
+    bool ParseToneCue(const char* name, ToneCue& cue)
+    {
+        if (!name) return false;
+        for (size_t i = 0; i < kToneCueCount; ++i) {
+            if (std::strcmp(name, kCues[i].name) == 0) {
+                cue = static_cast<ToneCue>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ToneBank
+
+    ToneBank::ToneBank()
+    {
+        // One block for everything, each tone starting on a kAlignment boundary
+        size_t total = 0;
+        for (int rate : kRates) {
+            for (const CueSpec& spec : kCues) total += Padded(SamplesFor(spec.durationMs, rate));
+        }
+        m_storage = std::make_unique<int16_t[]>(total + kAlignSamples);
+        m_storageBytes = (total + kAlignSamples) * sizeof(int16_t);
+
+        auto address = reinterpret_cast<uintptr_t>(m_storage.get());
+        auto* next = reinterpret_cast<int16_t*>((address + kAlignment - 1) / kAlignment * kAlignment);
+
+        for (size_t r = 0; r < kRateCount; ++r) {
+            for (size_t c = 0; c < kToneCueCount; ++c) {
+                const CueSpec& spec = kCues[c];
+                Tone& tone = m_tones[r][c];
+                tone.samples = next;
+                tone.count = SamplesFor(spec.durationMs, kRates[r]);
+                tone.period = SamplesFor(spec.periodMs, kRates[r]);
+                Synthesize(spec, kRates[r], next);
+                next += Padded(tone.count);
+            }
+        }
+    }
+
+    const ToneBank::Tone* ToneBank::Find(ToneCue cue, int sampleRate) const
+    {
+        size_t index = static_cast<size_t>(cue);
+        if (index >= kToneCueCount) return nullptr;
+        for (size_t r = 0; r < kRateCount; ++r) {
+            if (kRates[r] == sampleRate) return &m_tones[r][index];
+        }
+        return nullptr;
+    }
+
+    int ToneBank::DurationMs(ToneCue cue)
+    {
+        size_t index = static_cast<size_t>(cue);
+        return index < kToneCueCount ? kCues[index].durationMs : 0;
+    }
+
+    int ToneBank::PeriodMs(ToneCue cue)
+    {
+        size_t index = static_cast<size_t>(cue);
+        return index < kToneCueCount ? kCues[index].periodMs : 0;
+    }
+
+    // ToneEngine
+
+    uint64_t ToneEngine::SteadyClockUs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    ToneEngine::ToneEngine(ClockUs clock) : m_clock(clock)
+    {
+        SetConfig(ToneConfig{});
+    }
+
+    void ToneEngine::SetConfig(const ToneConfig& config)
+    {
+        float levelDb = std::max(kMinLevelDb, std::min(0.0f, config.levelDb));
+        m_levelDb.store(levelDb, std::memory_order_relaxed);
+        m_gainQ12.store(GainDbToQ12(levelDb), std::memory_order_relaxed);
+        m_talkChirps.store(config.talkChirps, std::memory_order_relaxed);
+    }
+
+    ToneConfig ToneEngine::GetConfig() const
+    {
+        ToneConfig config;
+        config.levelDb = m_levelDb.load(std::memory_order_relaxed);
+        config.talkChirps = m_talkChirps.load(std::memory_order_relaxed);
+        return config;
+    }
+
+    void ToneEngine::Play(ToneCue cue, bool uplink)
+    {
+        Command(cue, true, uplink);
+    }
+
+    void ToneEngine::Stop(ToneCue cue)
+    {
+        Command(cue, false, false);
+    }
+
+    void ToneEngine::StopAll()
+    {
+        for (size_t i = 0; i < kToneCueCount; ++i) Command(static_cast<ToneCue>(i), false, false);
+    }
+
+    void ToneEngine::Command(ToneCue cue, bool play, bool uplink)
+    {
+        size_t index = static_cast<size_t>(cue);
+        if (index >= kToneCueCount) return;
+
+        // The latest command per cue wins; the audio threads compare it with the one they saw
+        Request& request = m_requests[index];
+        uint32_t sequence = m_sequence.fetch_add(1, std::memory_order_relaxed) + 1;
+        request.uplink.store(uplink, std::memory_order_relaxed);
+        request.requestedUs.store(m_clock(), std::memory_order_relaxed);
+        request.command.store(sequence << 1 | (play ? 1u : 0u), std::memory_order_release);
+        m_published.fetch_add(1, std::memory_order_release);
+    }
+
+    bool ToneEngine::IsPlaying(ToneCue cue) const
+    {
+        size_t index = static_cast<size_t>(cue);
+        return index < kToneCueCount && (m_playing.load(std::memory_order_relaxed) & (1u << index)) != 0;
+    }
+
+    bool ToneEngine::MixCapture(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        auto* engine = static_cast<ToneEngine*>(context);
+        return engine->Mix(engine->m_captureSide, true, samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool ToneEngine::MixPlayback(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        auto* engine = static_cast<ToneEngine*>(context);
+        return engine->Mix(engine->m_playbackSide, false, samples, framesPerChannel, channels, sampleRate);
+    }
+
+    bool ToneEngine::Mix(Side& side, bool capture, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        if (!samples || framesPerChannel <= 0 || channels < 1 || sampleRate <= 0) return false;
+
+        // New commands since the last frame: one acquire load when there are none
+        uint32_t published = m_published.load(std::memory_order_acquire);
+        if (published != side.seenPublished) {
+            side.seenPublished = published;
+            uint64_t nowUs = 0;
+            for (size_t i = 0; i < kToneCueCount; ++i) {
+                Request& request = m_requests[i];
+                Voice& voice = side.voices[i];
+                uint32_t command = request.command.load(std::memory_order_acquire);
+                if (command == voice.seen) continue;
+                voice.seen = command;
+                voice.position = 0;
+                voice.active = (command & 1) != 0 && (!capture || request.uplink.load(std::memory_order_relaxed));
+                if (!voice.active || capture) continue;
+
+                if (nowUs == 0) nowUs = m_clock();
+                uint64_t requestedUs = request.requestedUs.load(std::memory_order_relaxed);
+                uint64_t startUs = nowUs > requestedUs ? nowUs - requestedUs : 0;
+                m_lastStartUs.store(startUs, std::memory_order_relaxed);
+                if (startUs > m_maxStartUs.load(std::memory_order_relaxed)) m_maxStartUs.store(startUs, std::memory_order_relaxed);
+                m_started.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        const int32_t gainQ12 = m_gainQ12.load(std::memory_order_relaxed);
+        const size_t frames = static_cast<size_t>(framesPerChannel);
+        bool wrote = false;
+        uint32_t playing = 0;
+        for (size_t i = 0; i < kToneCueCount; ++i) {
+            Voice& voice = side.voices[i];
+            if (!voice.active) continue;
+            const ToneBank::Tone* tone = m_bank.Find(static_cast<ToneCue>(i), sampleRate);
+            if (!tone) {
+                voice.active = false;
+                m_unsupported.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            // Straight copies out of the bank: the sounding part, then the silence up to the next ring
+            size_t frame = 0;
+            while (frame < frames) {
+                if (voice.position < tone->count) {
+                    size_t run = std::min(frames - frame, tone->count - voice.position);
+                    AddScaled(samples + frame * channels, channels, tone->samples + voice.position, run, gainQ12);
+                    frame += run;
+                    voice.position += run;
+                    wrote = true;
+                } else if (tone->period > tone->count) {
+                    size_t run = std::min(frames - frame, tone->period - voice.position);
+                    frame += run;
+                    voice.position += run;
+                    if (voice.position >= tone->period) voice.position = 0;
+                } else {
+                    break;
+                }
+            }
+            if (tone->period == 0 && voice.position >= tone->count) voice.active = false;
+            if (voice.active) playing |= 1u << i;
+        }
+        if (!capture) m_playing.store(playing, std::memory_order_relaxed);
+        return wrote;
+    }
+}
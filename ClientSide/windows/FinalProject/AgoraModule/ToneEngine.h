@@ -0,0 +1,153 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Audio cues for keying up, keying down and ringing, played from memory. Every cue is
+// synthesized once, when the engine is built, into 32-byte aligned 16-bit PCM at each rate the
+// pipelines run at. Play and Stop only store an atomic command - no file I/O, no allocation, no
+// lock - and the next frame on the audio thread starts the cue at its first sample, so a cue is
+// in the buffer within one 10 ms frame of the trigger. Local playback always gets it; the capture
+// side (what goes out on the talk channel) only when the trigger asks. Both sides are
+// AudioPipeline mix sources, mixed in before the limiter.
+namespace winrt::FinalProject::implementation
+{
+    enum class ToneCue : uint8_t
+    {
+        TalkStart,  // rising double chirp: the microphone is open
+        TalkEnd,    // falling double chirp: the microphone is closed
+        Roger,      // two-tone end-of-transmission beep
+        Ring,       // incoming call: 400 + 450 Hz double ring every 3 s, until stopped
+        Ringback,   // our call is ringing: 440 + 480 Hz for 1 s every 4 s, until stopped
+    };
+
+    constexpr size_t kToneCueCount = 5;
+
+    const char* ToneCueName(ToneCue cue);
+    bool ParseToneCue(const char* name, ToneCue& cue);
+
+    // Every cue at every supported rate, immutable once built
+    class ToneBank
+    {
+    public:
+        static constexpr int kRates[] = { 16000, 32000, 44100, 48000 };
+        static constexpr size_t kRateCount = sizeof(kRates) / sizeof(kRates[0]);
+        static constexpr size_t kAlignment = 32; // bytes, the widest DSP kernel's loads
+
+        struct Tone
+        {
+            const int16_t* samples = nullptr; // peak at full scale
+            size_t count = 0;
+            size_t period = 0;                // samples per repeat (silence after count); 0 = once
+        };
+
+        ToneBank();
+
+        ToneBank(const ToneBank&) = delete;
+        ToneBank& operator=(const ToneBank&) = delete;
+
+        // nullptr when the rate is not one of kRates
+        const Tone* Find(ToneCue cue, int sampleRate) const;
+
+        // Sounding length, and the repeat period of the ringing cues (0 for the others)
+        static int DurationMs(ToneCue cue);
+        static int PeriodMs(ToneCue cue);
+
+        size_t GetMemoryBytes() const { return m_storageBytes; }
+
+    private:
+        std::unique_ptr<int16_t[]> m_storage;
+        size_t m_storageBytes = 0;
+        Tone m_tones[kRateCount][kToneCueCount];
+    };
+
+    struct ToneConfig
+    {
+        float levelDb = -12.0f;  // dBFS peak of every cue, -40..0
+        bool talkChirps = false; // TalkStart on every key-up, TalkEnd on every key-down
+    };
+
+    class ToneEngine
+    {
+    public:
+        // Microseconds on a steady clock, for the trigger-to-frame latency
+        using ClockUs = uint64_t (*)();
+        static uint64_t SteadyClockUs();
+
+        static constexpr float kMinLevelDb = -40.0f;
+
+        explicit ToneEngine(ClockUs clock = &SteadyClockUs);
+
+        ToneEngine(const ToneEngine&) = delete;
+        ToneEngine& operator=(const ToneEngine&) = delete;
+
+        // Any thread; the level is clamped and applies from the next frame
+        void SetConfig(const ToneConfig& config);
+        ToneConfig GetConfig() const;
+
+        // Any thread, lock-free and allocation-free. Play restarts a cue that is already
+        // playing; uplink also mixes it into capture. Stop silences it on both sides.
+        void Play(ToneCue cue, bool uplink = false);
+        void Stop(ToneCue cue);
+        void StopAll();
+
+        // Any thread: the cue is sounding (or between rings) on the playback side
+        bool IsPlaying(ToneCue cue) const;
+        const ToneBank& GetBank() const { return m_bank; }
+
+        // Mix sources, one per pipeline
+        static bool MixCapture(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+        static bool MixPlayback(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        // Any thread
+        uint64_t GetStarted() const { return m_started.load(std::memory_order_relaxed); }
+        uint64_t GetLastStartUs() const { return m_lastStartUs.load(std::memory_order_relaxed); }
+        uint64_t GetMaxStartUs() const { return m_maxStartUs.load(std::memory_order_relaxed); }
+        uint64_t GetUnsupportedFrames() const { return m_unsupported.load(std::memory_order_relaxed); }
+
+    private:
+        // One per cue, written by Play and Stop. command = sequence << 1 | play.
+        struct Request
+        {
+            std::atomic<uint32_t> command{ 0 };
+            std::atomic<bool> uplink{ false };
+            std::atomic<uint64_t> requestedUs{ 0 };
+        };
+
+        // Audio-thread state of one cue on one side
+        struct Voice
+        {
+            uint32_t seen = 0;
+            bool active = false;
+            size_t position = 0;
+        };
+
+        struct Side
+        {
+            uint32_t seenPublished = 0;
+            Voice voices[kToneCueCount];
+        };
+
+        void Command(ToneCue cue, bool play, bool uplink);
+        bool Mix(Side& side, bool capture, int16_t* samples, int framesPerChannel, int channels, int sampleRate);
+
+        ToneBank m_bank;
+        ClockUs m_clock;
+        Request m_requests[kToneCueCount];
+        std::atomic<uint32_t> m_sequence{ 0 };
+        std::atomic<uint32_t> m_published{ 0 }; // bumped after each command is stored
+        std::atomic<float> m_levelDb;
+        std::atomic<int32_t> m_gainQ12;
+        std::atomic<bool> m_talkChirps{ false };
+
+        Side m_captureSide;   // capture thread only
+        Side m_playbackSide;  // playback thread only
+        std::atomic<uint32_t> m_playing{ 0 }; // playback side, one bit per cue
+
+        std::atomic<uint64_t> m_started{ 0 };
+        std::atomic<uint64_t> m_lastStartUs{ 0 };
+        std::atomic<uint64_t> m_maxStartUs{ 0 };
+        std::atomic<uint64_t> m_unsupported{ 0 };
+    };
+}
@@ -0,0 +1,73 @@
+#include "VoiceActivityDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace winrt::FinalProject::implementation
+{
+    namespace
+    {
+        constexpr float kSilenceDb = -96.0f;
+        constexpr float kFullScalePower = 32767.0f * 32767.0f;
+        constexpr float kNoiseRiseDbPerSecond = 3.0f; // background creeps up slowly, drops at once
+    }
+
+    VoiceActivityDetector::VoiceActivityDetector(const DspKernels& kernels) : m_kernels(kernels)
+    {
+    }
+
+    void VoiceActivityDetector::Configure(const VadConfig& config, int sampleRate)
+    {
+        m_config = config;
+        m_sampleRate = std::max(1, sampleRate);
+    }
+
+    void VoiceActivityDetector::Reset()
+    {
+        m_active = false;
+        m_speechMs = 0.0f;
+        m_silenceMs = 0.0f;
+        m_noiseFloorDb = -90.0f;
+        m_lastEnergyDb = kSilenceDb;
+        m_lastZcr = 0.0f;
+    }
+
+    bool VoiceActivityDetector::Process(const int16_t* samples, int frames)
+    {
+        if (!samples || frames <= 1) return m_active;
+
+        const size_t count = static_cast<size_t>(frames);
+        const float frameMs = 1000.0f * frames / m_sampleRate;
+
+        float power = m_kernels.sumSquares(samples, count) / static_cast<float>(count);
+        m_lastEnergyDb = power > 0.0f ? std::max(kSilenceDb, 10.0f * std::log10(power / kFullScalePower)) : kSilenceDb;
+        m_lastZcr = static_cast<float>(m_kernels.zeroCrossings(samples, count)) / static_cast<float>(count - 1);
+
+        bool loud = m_lastEnergyDb >= m_config.thresholdDb &&
+                    m_lastEnergyDb >= m_noiseFloorDb + m_config.noiseMarginDb;
+        bool voiceLike = m_lastZcr >= m_config.minZcr && m_lastZcr <= m_config.maxZcr;
+        bool speech = loud && voiceLike;
+
+        // Minimum tracking: pauses between words pull the floor down at once, while a
+        // steady fan or engine above the threshold slowly stops counting as speech
+        if (m_lastEnergyDb < m_noiseFloorDb) {
+            m_noiseFloorDb = m_lastEnergyDb;
+        } else {
+            m_noiseFloorDb = std::min(m_lastEnergyDb, m_noiseFloorDb + kNoiseRiseDbPerSecond * frameMs / 1000.0f);
+        }
+
+        if (m_active) {
+            m_silenceMs = speech ? 0.0f : m_silenceMs + frameMs;
+            if (m_silenceMs > static_cast<float>(m_config.hangoverMs)) {
+                m_active = false;
+                m_speechMs = 0.0f;
+            }
+        } else {
+            m_speechMs = speech ? m_speechMs + frameMs : 0.0f;
+            if (speech && m_speechMs >= static_cast<float>(m_config.attackMs)) {
+                m_active = true;
+                m_silenceMs = 0.0f;
+            }
+        }
+        return m_active;
+    }
+}
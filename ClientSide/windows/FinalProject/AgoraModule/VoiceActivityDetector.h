@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+
+#include "AudioDsp.h"
+
+// Energy + zero-crossing-rate voice activity detector for VOX transmit.
+// A frame counts as speech when it is loud enough (above both an absolute floor and
+// the tracked background noise) and its zero-crossing rate looks like voice rather
+// than hiss or hum. Attack ignores clicks shorter than attackMs; hangover keeps the
+// gate open between words. Allocation free, so it can run on the audio thread.
+namespace winrt::FinalProject::implementation
+{
+    struct VadConfig
+    {
+        float thresholdDb = -45.0f;   // dBFS RMS, absolute floor
+        float noiseMarginDb = 9.0f;   // must also be this far above the background
+        float minZcr = 0.003f;        // crossings per sample; below = 50/60 Hz hum or DC (a 100 Hz voice is ~0.004)
+        float maxZcr = 0.30f;         // above = broadband hiss
+        int attackMs = 30;            // speech must last this long to open
+        int hangoverMs = 400;         // stay open this long after the last speech frame
+    };
+
+    class VoiceActivityDetector
+    {
+    public:
+        explicit VoiceActivityDetector(const DspKernels& kernels = GetDspKernels());
+
+        void Configure(const VadConfig& config, int sampleRate);
+        void Reset();
+
+        // One frame (typically 10 ms) of mono samples; returns the gate state after it
+        bool Process(const int16_t* samples, int frames);
+
+        bool IsActive() const { return m_active; }
+        float GetLastEnergyDb() const { return m_lastEnergyDb; }
+        float GetLastZcr() const { return m_lastZcr; }
+        float GetNoiseFloorDb() const { return m_noiseFloorDb; }
+
+    private:
+        const DspKernels& m_kernels;
+        VadConfig m_config;
+        int m_sampleRate = 48000;
+
+        bool m_active = false;
+        float m_speechMs = 0.0f;    // consecutive speech-like time while closed
+        float m_silenceMs = 0.0f;   // time since the last speech-like frame while open
+        float m_noiseFloorDb = -90.0f;
+        float m_lastEnergyDb = -96.0f;
+        float m_lastZcr = 0.0f;
+    };
+}
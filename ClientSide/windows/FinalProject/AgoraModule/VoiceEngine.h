@@ -0,0 +1,179 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Metrics.h"
+
+// The slice of IRtcEngineEx that the manager core uses, in plain C++ types. On Windows
+// AgoraRtcEngine forwards each call to the Agora SDK one-to-one; on Linux FakeVoiceEngine
+// simulates it, so join/mute/radio/volume logic can be tested and benchmarked headless.
+// Return codes follow the SDK convention (0 = success, negative = error).
+namespace winrt::FinalProject::implementation
+{
+    class AudioPipeline;
+
+    struct ConnectionOptions
+    {
+        static constexpr int kAudienceLowLatency = 1;      // AUDIENCE_LATENCY_LEVEL_LOW_LATENCY
+        static constexpr int kAudienceUltraLowLatency = 2; // AUDIENCE_LATENCY_LEVEL_ULTRA_LOW_LATENCY
+
+        bool publishMicrophone = true;
+        bool autoSubscribeAudio = true;
+        // Listen only: audience role, so no capture, no audio processing and no publisher
+        // slot on the server. publishMicrophone is ignored while set.
+        bool audience = false;
+        int audienceLatency = kAudienceLowLatency;
+    };
+
+    struct VolumeSample
+    {
+        uint32_t uid = 0; // 0 = local user
+        uint8_t volume = 0;
+    };
+
+    // LastmileProbeResult, flattened. Loss in percent, bandwidth estimated for the link (0 when
+    // the probe could not measure it).
+    struct LastmileLinkReport
+    {
+        uint32_t packetLossRate = 0;
+        uint32_t jitterMs = 0;
+        uint32_t availableBandwidthKbps = 0;
+    };
+
+    struct LastmileProbeResult
+    {
+        static constexpr int kComplete = 1;           // LASTMILE_PROBE_RESULT_COMPLETE
+        static constexpr int kIncompleteNoBwe = 2;    // LASTMILE_PROBE_RESULT_INCOMPLETE_NO_BWE
+        static constexpr int kUnavailable = 3;        // LASTMILE_PROBE_RESULT_UNAVAILABLE
+
+        int state = kUnavailable;
+        LastmileLinkReport uplink;
+        LastmileLinkReport downlink;
+        uint32_t rttMs = 0;
+    };
+
+    // MEDIA_DEVICE_TYPE values
+    enum class AudioDeviceKind : uint8_t
+    {
+        Playback = 0,
+        Recording = 1,
+    };
+
+    struct AudioDeviceInfo
+    {
+        std::string id;   // stable across sessions, opaque
+        std::string name; // what the OS shows
+    };
+
+    // Callbacks for one connection (the default channel or an Ex connection), on SDK threads.
+    // Same contract as IRtcEngineEventHandler: return quickly, never call back into the engine.
+    class IVoiceEngineEvents
+    {
+    public:
+        virtual ~IVoiceEngineEvents() = default;
+
+        virtual void onJoinChannelSuccess(const char* channel, uint32_t uid, int elapsed) = 0;
+        virtual void onLeaveChannel(const ChannelStatsSample& stats) = 0;
+        virtual void onUserJoined(uint32_t uid, int elapsed) = 0;
+        virtual void onUserOffline(uint32_t uid, int reason) = 0; // 0 = quit, 1 = dropped, 2 = became audience
+        virtual void onError(int err, const char* msg) = 0;
+        virtual void onAudioVolumeIndication(const VolumeSample* speakers, unsigned int speakerNumber, int totalVolume) = 0;
+        virtual void onActiveSpeaker(uint32_t uid) = 0;
+        virtual void onRtcStats(const ChannelStatsSample& stats) = 0;
+        virtual void onNetworkQuality(uint32_t uid, int txQuality, int rxQuality) = 0;
+        virtual void onRemoteAudioStats(uint32_t uid, const RemoteAudioSample& stats) = 0;
+        // Link health: CONNECTION_STATE_TYPE and CONNECTION_CHANGED_REASON_TYPE values
+        virtual void onConnectionStateChanged(int state, int reason) = 0;
+        virtual void onConnectionLost() = 0; // no link for 10 s, the SDK keeps retrying in place
+        virtual void onRejoinChannelSuccess(const char* channel, uint32_t uid, int elapsed) = 0;
+        // A data stream message from uid; data is only valid during the call
+        virtual void onStreamMessage(uint32_t uid, int streamId, const char* data, size_t length) = 0;
+        // Default handler only: a device came, went or was disabled. deviceType is MEDIA_DEVICE_TYPE,
+        // deviceState MEDIA_DEVICE_STATE_TYPE; deviceId is only valid during the call.
+        virtual void onAudioDeviceStateChanged(const char* deviceId, int deviceType, int deviceState) = 0;
+        // Default handler only: the last-mile probe finished (about 30 s after it started)
+        virtual void onLastmileProbeResult(const LastmileProbeResult& result) = 0;
+    };
+
+    // Each remote user's decoded audio before mixing, per connection, on the engine's audio
+    // thread. Same rules as the pipelines: no blocking, no allocation.
+    class IRemoteAudioSink
+    {
+    public:
+        virtual ~IRemoteAudioSink() = default;
+
+        virtual void OnRemoteAudioFrame(const char* channel, uint32_t uid, const int16_t* samples,
+                                        int framesPerChannel, int channels, int sampleRate) = 0;
+    };
+
+    class IVoiceEngine
+    {
+    public:
+        virtual ~IVoiceEngine() = default;
+
+        // Creates the SDK engine; events serve the default channel
+        virtual int Initialize(const std::string& appId, IVoiceEngineEvents* events) = 0;
+        virtual void Release() = 0;
+
+        // Pipelines run on the engine's audio thread for every 10 ms frame; remote gets every
+        // user's frames before mixing, at kRemoteSampleRate mono (nullptr = none), just before
+        // the playback frame they are mixed into
+        static constexpr int kRemoteSampleRate = 48000;
+        virtual int SetAudioProcessors(AudioPipeline* capture, AudioPipeline* playback, IRemoteAudioSink* remote) = 0;
+
+        // Default channel
+        virtual int JoinChannel(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) = 0;
+        virtual int UpdateChannel(const ConnectionOptions& options) = 0; // role/publish switch in-channel
+        virtual int LeaveChannel() = 0;
+        virtual int MuteLocalAudio(bool mute) = 0;
+        virtual int EnableVolumeIndication(int intervalMs, int smooth) = 0; // intervalMs <= 0 turns it off
+
+        // Ex connections: one per channel, all with the same local uid. events must outlive the connection.
+        virtual int JoinConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options,
+                                   IVoiceEngineEvents* events) = 0;
+        virtual int UpdateConnection(const std::string& channelName, uint32_t uid, const ConnectionOptions& options) = 0;
+        virtual int LeaveConnection(const std::string& channelName, uint32_t uid) = 0;
+        virtual int MuteConnectionAudio(const std::string& channelName, uint32_t uid, bool mute) = 0;
+        virtual int EnableConnectionVolumeIndication(const std::string& channelName, uint32_t uid, int intervalMs, int smooth) = 0;
+        // Data streams on a joined Ex connection: ordered, at most 1 KB per message and 30 messages/s.
+        // Sending needs the broadcaster role; publishing audio is not required.
+        virtual int CreateDataStream(const std::string& channelName, uint32_t uid, int* streamId) = 0;
+        virtual int SendStreamMessage(const std::string& channelName, uint32_t uid, int streamId, const char* data, size_t length) = 0;
+
+        // Engine-wide audio settings (SDK enum values are passed through unchanged)
+        virtual int EnableLocalAudio(bool enabled) = 0;
+        virtual int MuteRemoteAudio(uint32_t uid, bool mute) = 0;
+        virtual int SetRecordingVolume(int volume) = 0;  // 0-400, 100 = original
+        virtual int SetPlaybackVolume(int volume) = 0;   // 0-400
+        virtual int SetVoiceEqualization(int band, int gainDb) = 0; // AUDIO_EQUALIZATION_BAND_FREQUENCY
+        virtual int SetNoiseSuppression(bool enabled, int mode) = 0; // 0 balanced, 1 aggressive, 2 ultra low latency
+        virtual int SetAudioScenario(int scenario) = 0; // AUDIO_SCENARIO_TYPE
+        virtual int SetClientRole(int role) = 0;        // CLIENT_ROLE_TYPE
+        virtual int SetAudioProfile(int profile) = 0;   // AUDIO_PROFILE_TYPE; resets a custom bitrate
+        virtual int SetParameters(const std::string& json) = 0; // private SDK parameters, one JSON object
+        virtual int StartEchoTest(int intervalMs) = 0;
+        virtual int StopEchoTest() = 0;
+
+        // Last-mile probe: our uplink and downlink to the nearest edge, measured before joining.
+        // Runs only outside audio channels; the result arrives as onLastmileProbeResult.
+        virtual int StartLastmileProbe(int expectedUplinkKbps, int expectedDownlinkKbps) = 0;
+        virtual int StopLastmileProbe() = 0;
+
+        // Audio devices, engine-wide and in-session: a switch takes effect in every joined channel
+        // without a restart. Enumeration walks the OS device list and is slow; cache it.
+        virtual int EnumerateAudioDevices(AudioDeviceKind kind, std::vector<AudioDeviceInfo>& devices) = 0;
+        virtual int GetAudioDevice(AudioDeviceKind kind, std::string& deviceId) = 0; // the one in use
+        virtual int SetAudioDevice(AudioDeviceKind kind, const std::string& deviceId) = 0; // "" = follow the system default
+
+        // External audio (see ExternalAudio.h): our own capture and renderer instead of the SDK's
+        // devices. While on, publishing connections send pushed frames instead of the microphone
+        // and playout is pulled instead of played; switch it only outside channels. Push and Pull
+        // run on the external audio pump, not the command worker, with 10 ms frames in the format
+        // set here. The frame observer never sees these frames: the pump runs the pipelines.
+        virtual int SetExternalAudio(bool enabled, int sampleRate, int captureChannels, int playbackChannels) = 0;
+        virtual int PushAudioFrame(const int16_t* samples, int framesPerChannel, int channels, int sampleRate) = 0;
+        virtual int PullAudioFrame(int16_t* samples, int framesPerChannel, int channels, int sampleRate) = 0;
+    };
+}
@@ -0,0 +1,233 @@
+#include "VolumeMeter.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace winrt::FinalProject::implementation
+{
+    VolumeMeter::VolumeMeter()
+    {
+        for (size_t i = 0; i < kSlots; ++i) {
+            m_keys[i].store(kEmpty, std::memory_order_relaxed);
+            m_levels[i].store(0, std::memory_order_relaxed);
+            m_lastSeen[i].store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < kMaxChannels; ++i) {
+            m_activeSpeaker[i].store(kNoSpeaker, std::memory_order_relaxed);
+            m_reportedSpeaker[i] = kNoSpeaker;
+        }
+        m_update.levels.reserve(kSlots);
+        m_update.activeSpeakers.reserve(kMaxChannels);
+    }
+
+    VolumeMeter::~VolumeMeter()
+    {
+        Stop();
+    }
+
+    void VolumeMeter::Start(int intervalMs, Sink sink)
+    {
+        m_intervalMs.store(std::max(10, std::min(5000, intervalMs)));
+        {
+            std::lock_guard<std::mutex> lock(m_collectMutex);
+            m_sink = std::move(sink);
+        }
+        // Already running: the new interval applies from the next wait
+        if (m_running.exchange(true)) return;
+        m_reporter = std::thread([this]() { ReportLoop(); });
+    }
+
+    void VolumeMeter::Stop()
+    {
+        if (!m_running.exchange(false)) return;
+        {
+            std::lock_guard<std::mutex> lock(m_timerMutex);
+        }
+        m_timer.notify_one();
+        if (m_reporter.joinable()) m_reporter.join();
+    }
+
+    uint8_t VolumeMeter::RegisterChannel(const std::string& channelName)
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        auto it = std::find(m_channelNames.begin(), m_channelNames.end(), channelName);
+        if (it != m_channelNames.end()) {
+            return static_cast<uint8_t>(it - m_channelNames.begin());
+        }
+        if (m_channelNames.size() >= kMaxChannels) return kNoChannel;
+        m_channelNames.push_back(channelName);
+        return static_cast<uint8_t>(m_channelNames.size() - 1);
+    }
+
+    uint8_t VolumeMeter::FindChannel(const std::string& channelName) const
+    {
+        std::lock_guard<std::mutex> lock(m_channelMutex);
+        auto it = std::find(m_channelNames.begin(), m_channelNames.end(), channelName);
+        return it != m_channelNames.end() ? static_cast<uint8_t>(it - m_channelNames.begin()) : kNoChannel;
+    }
+
+    void VolumeMeter::Report(uint8_t channel, uint32_t uid, uint8_t level)
+    {
+        if (channel >= kMaxChannels) return;
+
+        // Each key is only ever written by its own connection's callback, so a key
+        // cannot be claimed twice; only the claim itself races with other keys.
+        const uint64_t key = MakeKey(channel, uid);
+        const uint32_t tick = m_tick.load(std::memory_order_relaxed);
+        const size_t start = static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 58) & (kSlots - 1);
+
+        size_t freeSlot = kSlots;
+        for (size_t probe = 0; probe < kSlots; ++probe) {
+            size_t index = (start + probe) & (kSlots - 1);
+            uint64_t current = m_keys[index].load(std::memory_order_acquire);
+            if (current == key) {
+                m_levels[index].store(level, std::memory_order_relaxed);
+                m_lastSeen[index].store(tick, std::memory_order_release);
+                return;
+            }
+            if (current == kTombstone && freeSlot == kSlots) freeSlot = index;
+            if (current == kEmpty) {
+                if (freeSlot == kSlots) freeSlot = index;
+                break;
+            }
+        }
+
+        // Not present: claim the first free slot on the probe path, or any later one
+        for (size_t probe = 0; probe < kSlots; ++probe) {
+            size_t index = freeSlot < kSlots ? freeSlot : (start + probe) & (kSlots - 1);
+            freeSlot = kSlots;
+            uint64_t current = m_keys[index].load(std::memory_order_relaxed);
+            if (current != kEmpty && current != kTombstone) continue;
+            if (m_keys[index].compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+                m_levels[index].store(level, std::memory_order_relaxed);
+                m_lastSeen[index].store(tick, std::memory_order_release);
+                return;
+            }
+        }
+        m_overflow.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void VolumeMeter::ReportActiveSpeaker(uint8_t channel, uint32_t uid)
+    {
+        if (channel >= kMaxChannels) return;
+        m_activeSpeaker[channel].store(uid, std::memory_order_relaxed);
+    }
+
+    void VolumeMeter::Collect(VolumeUpdate& update)
+    {
+        std::lock_guard<std::mutex> lock(m_collectMutex);
+        CollectLocked(update);
+    }
+
+    void VolumeMeter::CollectLocked(VolumeUpdate& update)
+    {
+        update.levels.clear();
+        update.activeSpeakers.clear();
+
+        const uint32_t tick = m_tick.fetch_add(1, std::memory_order_relaxed) + 1;
+
+        for (size_t index = 0; index < kSlots; ++index) {
+            uint64_t key = m_keys[index].load(std::memory_order_acquire);
+            if (key == kEmpty || key == kTombstone) continue;
+
+            // Slot was (re)claimed by a new uid since the last report
+            if (m_reportedKey[index] != key) {
+                m_reportedKey[index] = key;
+                m_reported[index] = 0;
+            }
+
+            VolumeChange change;
+            change.channel = static_cast<uint8_t>((key >> 32) & 0xFF);
+            change.uid = static_cast<uint32_t>(key);
+
+            uint32_t lastSeen = m_lastSeen[index].load(std::memory_order_acquire);
+            if (tick - lastSeen > kStaleTicks) {
+                // Speaker stopped being reported: turn the light off once, then free the slot
+                if (m_reported[index] != 0) {
+                    change.level = 0;
+                    update.levels.push_back(change);
+                }
+                m_reported[index] = 0;
+                m_reportedKey[index] = kEmpty;
+                m_keys[index].compare_exchange_strong(key, kTombstone, std::memory_order_acq_rel);
+                continue;
+            }
+
+            uint8_t level = m_levels[index].load(std::memory_order_relaxed);
+            uint8_t reported = m_reported[index];
+            int difference = static_cast<int>(level) - static_cast<int>(reported);
+            bool changed = std::abs(difference) >= kChangeThreshold ||
+                           (level == 0 && reported != 0) ||
+                           (level != 0 && reported == 0);
+            if (!changed) continue;
+
+            change.level = level;
+            update.levels.push_back(change);
+            m_reported[index] = level;
+        }
+
+        for (size_t channel = 0; channel < kMaxChannels; ++channel) {
+            uint32_t speaker = m_activeSpeaker[channel].load(std::memory_order_relaxed);
+            if (speaker == m_reportedSpeaker[channel]) continue;
+            m_reportedSpeaker[channel] = speaker;
+            if (speaker == kNoSpeaker) continue;
+            update.activeSpeakers.push_back({ static_cast<uint8_t>(channel), speaker });
+        }
+
+        if (!update.Empty()) {
+            std::lock_guard<std::mutex> lock(m_channelMutex);
+            update.channels = m_channelNames;
+        }
+    }
+
+    size_t VolumeMeter::ReadLevels(uint8_t channel, VolumeChange* out, size_t capacity) const
+    {
+        if (channel >= kMaxChannels || !out) return 0;
+
+        // Same staleness rule as Collect, without advancing the clock or freeing anything
+        const uint32_t tick = m_tick.load(std::memory_order_relaxed);
+        size_t count = 0;
+        for (size_t index = 0; index < kSlots && count < capacity; ++index) {
+            uint64_t key = m_keys[index].load(std::memory_order_acquire);
+            if (key == kEmpty || key == kTombstone || static_cast<uint8_t>(key >> 32) != channel) continue;
+            if (tick - m_lastSeen[index].load(std::memory_order_acquire) > kStaleTicks) continue;
+
+            VolumeChange& entry = out[count++];
+            entry.channel = channel;
+            entry.uid = static_cast<uint32_t>(key);
+            entry.level = m_levels[index].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    void VolumeMeter::Reset()
+    {
+        std::lock_guard<std::mutex> lock(m_collectMutex);
+        for (size_t index = 0; index < kSlots; ++index) {
+            m_keys[index].store(kEmpty, std::memory_order_release);
+            m_levels[index].store(0, std::memory_order_relaxed);
+            m_reportedKey[index] = kEmpty;
+            m_reported[index] = 0;
+        }
+        for (size_t channel = 0; channel < kMaxChannels; ++channel) {
+            m_activeSpeaker[channel].store(kNoSpeaker, std::memory_order_relaxed);
+            m_reportedSpeaker[channel] = kNoSpeaker;
+        }
+    }
+
+    void VolumeMeter::ReportLoop()
+    {
+        while (m_running.load()) {
+            {
+                std::unique_lock<std::mutex> lock(m_timerMutex);
+                m_timer.wait_for(lock, std::chrono::milliseconds(m_intervalMs.load()),
+                    [this]() { return !m_running.load(); });
+            }
+            if (!m_running.load()) break;
+
+            std::lock_guard<std::mutex> lock(m_collectMutex);
+            CollectLocked(m_update);
+            if (!m_update.Empty() && m_sink) m_sink(m_update);
+        }
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Per-uid talk levels for every monitored radio. SDK volume callbacks write into a
+// fixed open-addressed table (no allocation, no locks); once per interval the
+// reporter diffs it against what JS last saw and sends only the changed entries.
+namespace winrt::FinalProject::implementation
+{
+    struct VolumeChange
+    {
+        uint8_t channel = 0; // index into the names passed with the update
+        uint32_t uid = 0;    // 0 = local user
+        uint8_t level = 0;   // 0-255 as reported by the SDK
+    };
+
+    struct ActiveSpeakerChange
+    {
+        uint8_t channel = 0;
+        uint32_t uid = 0;
+    };
+
+    struct VolumeUpdate
+    {
+        std::vector<std::string> channels;
+        std::vector<VolumeChange> levels;
+        std::vector<ActiveSpeakerChange> activeSpeakers;
+
+        bool Empty() const { return levels.empty() && activeSpeakers.empty(); }
+    };
+
+    class VolumeMeter
+    {
+    public:
+        static constexpr size_t kSlots = 64;          // 8 radios x 8 speakers, power of two
+        static constexpr size_t kMaxChannels = 16;
+        static constexpr uint8_t kChangeThreshold = 8; // of 255, smaller moves are not sent
+        static constexpr uint32_t kStaleTicks = 2;     // intervals without a report before a uid drops to 0
+        static constexpr uint8_t kNoChannel = 0xFF;
+
+        using Sink = std::function<void(const VolumeUpdate&)>;
+
+        VolumeMeter();
+        ~VolumeMeter();
+
+        VolumeMeter(const VolumeMeter&) = delete;
+        VolumeMeter& operator=(const VolumeMeter&) = delete;
+
+        void Start(int intervalMs, Sink sink);
+        void Stop();
+        bool IsRunning() const { return m_running.load(std::memory_order_relaxed); }
+
+        // Gives a channel a small stable index; called on the command worker when a handler is set up
+        uint8_t RegisterChannel(const std::string& channelName);
+        uint8_t FindChannel(const std::string& channelName) const; // kNoChannel if never registered
+
+        // Safe from any SDK thread, never blocks or allocates
+        void Report(uint8_t channel, uint32_t uid, uint8_t level);
+        void ReportActiveSpeaker(uint8_t channel, uint32_t uid);
+
+        // Builds the delta since the previous call and advances the staleness clock.
+        // Only one thread may collect at a time (the reporter, or a test).
+        void Collect(VolumeUpdate& update);
+
+        // Any thread, lock-free: the current level of every uid still heard on channel, up to
+        // capacity of them, for readers that poll instead of waiting for the next delta
+        size_t ReadLevels(uint8_t channel, VolumeChange* out, size_t capacity) const;
+
+        // Forgets every level, e.g. after leaving all channels
+        void Reset();
+
+        uint64_t GetOverflowCount() const { return m_overflow.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint64_t kEmpty = 0;
+        static constexpr uint64_t kTombstone = 1; // freed slot, probing continues past it
+        static constexpr uint32_t kNoSpeaker = 0xFFFFFFFFu;
+
+        static uint64_t MakeKey(uint8_t channel, uint32_t uid)
+        {
+            // Bit 40 keeps uid 0 on channel 0 distinct from an empty slot
+            return (1ull << 40) | (static_cast<uint64_t>(channel) << 32) | uid;
+        }
+
+        void CollectLocked(VolumeUpdate& update);
+        void ReportLoop();
+
+        // Structure of arrays: the reporter scans keys and levels linearly
+        std::array<std::atomic<uint64_t>, kSlots> m_keys;
+        std::array<std::atomic<uint8_t>, kSlots> m_levels;
+        std::array<std::atomic<uint32_t>, kSlots> m_lastSeen;
+        std::array<uint64_t, kSlots> m_reportedKey{}; // reporter only
+        std::array<uint8_t, kSlots> m_reported{};      // reporter only
+        std::array<std::atomic<uint32_t>, kMaxChannels> m_activeSpeaker;
+        std::array<uint32_t, kMaxChannels> m_reportedSpeaker{}; // reporter only
+
+        std::atomic<uint32_t> m_tick{ 0 };
+        std::atomic<uint64_t> m_overflow{ 0 };
+
+        mutable std::mutex m_channelMutex; // never taken by SDK threads
+        std::vector<std::string> m_channelNames;
+
+        std::mutex m_collectMutex; // serializes collectors and guards the sink, never taken by SDK threads
+        VolumeUpdate m_update;
+        Sink m_sink;
+
+        std::atomic<int> m_intervalMs{ 200 };
+        std::atomic<bool> m_running{ false };
+        std::mutex m_timerMutex;
+        std::condition_variable m_timer;
+        std::thread m_reporter;
+    };
+}
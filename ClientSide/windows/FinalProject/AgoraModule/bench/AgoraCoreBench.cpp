@@ -0,0 +1,336 @@
+// AgoraCore on FakeVoiceEngine: how many commands the worker gets through, how long an SDK
+// callback takes to reach the listener, how many heap allocations each operation costs, and
+// what a status poll costs natively through the bridge-era readers versus the hot reads the
+// JSI host object uses (the bridge's own queue hop and JSON marshaling come on top on Windows).
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   ./build/AgoraCoreBench
+#include "../AgoraCore.h"
+#include "../FakeVoiceEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+// Every allocation in the process, so an operation's cost can be read as a counter delta
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kCommands = 200000;
+    constexpr int kLatencySamples = 200;
+    constexpr int kAllocationRounds = 1000;
+    constexpr int kReadRounds = 200000;
+
+    // Wakes the bench when a given remote uid shows up in a batch
+    class LatencyListener : public IAgoraCoreListener
+    {
+    public:
+        void Expect(uint32_t uid)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_expected = uid;
+            m_seen = false;
+        }
+
+        bool WaitSeen(Clock::time_point& at)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            bool seen = m_changed.wait_for(lock, std::chrono::seconds(2), [this]() { return m_seen; });
+            at = m_seenAt;
+            return seen;
+        }
+
+        void OnEventBatch(const std::vector<AgoraEvent>& events, const EventBatchStats&) override
+        {
+            auto now = Clock::now();
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& event : events) {
+                if (event.type == AgoraEventType::UserJoined && event.uid == m_expected && !m_seen) {
+                    m_seen = true;
+                    m_seenAt = now;
+                    m_changed.notify_all();
+                }
+            }
+        }
+
+        void OnVolumeUpdate(const VolumeUpdate&) override {}
+        void OnTalkStateChanged(bool, bool) override {}
+        void OnCallLatency(const std::string&, bool, double) override {}
+        void OnConnectionStateChanged(const std::string&, const ConnectionTransition&) override {}
+        void OnCallSignal(const CallSignal&) override {}
+        void OnCallSignalStatus(const CallSignal&, bool) override {}
+        void OnFloorChanged(const FloorChange&) override {}
+        void OnLatencyProbeFinished(const LatencyReport&) override {}
+        void OnAudioDevicesChanged(const AudioDeviceList&) override {}
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_changed;
+        uint32_t m_expected = 0;
+        bool m_seen = false;
+        Clock::time_point m_seenAt;
+    };
+
+    class NullListener : public IAgoraCoreListener
+    {
+    public:
+        void OnEventBatch(const std::vector<AgoraEvent>&, const EventBatchStats&) override {}
+        void OnVolumeUpdate(const VolumeUpdate&) override {}
+        void OnTalkStateChanged(bool, bool) override {}
+        void OnCallLatency(const std::string&, bool, double) override {}
+        void OnConnectionStateChanged(const std::string&, const ConnectionTransition&) override {}
+        void OnCallSignal(const CallSignal&) override {}
+        void OnCallSignalStatus(const CallSignal&, bool) override {}
+        void OnFloorChanged(const FloorChange&) override {}
+        void OnLatencyProbeFinished(const LatencyReport&) override {}
+        void OnAudioDevicesChanged(const AudioDeviceList&) override {}
+    };
+
+    void RunAndWait(AgoraCore& core, std::function<void()> fn)
+    {
+        std::promise<void> done;
+        core.Post(Command{ "", std::move(fn), [&done]() { done.set_value(); } });
+        done.get_future().wait();
+    }
+
+    double Percentile(std::vector<double> values, double p)
+    {
+        if (values.empty()) return 0.0;
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    // Posts from one producer as fast as it can; keyed commands coalesce like repeated mute taps
+    void BenchCommandThroughput(int callCostUs)
+    {
+        for (bool keyed : { false, true }) {
+            FakeEngineConfig config;
+            config.manualClock = true;
+            config.callCostUs = callCostUs;
+            AgoraCore core([config]() { return std::make_unique<FakeVoiceEngine>(config); });
+            RunAndWait(core, [&core]() { core.InitializeEngine("bench"); });
+            RunAndWait(core, [&core]() { core.JoinChannel("bench"); });
+
+            uint64_t executedBefore = core.GetCommandQueue().GetExecutedCount();
+            uint64_t coalescedBefore = core.GetCommandQueue().GetCoalescedCount();
+            auto start = Clock::now();
+            for (int i = 0; i < kCommands; ++i) {
+                bool mute = (i & 1) != 0;
+                core.Post(Command{ keyed ? "MuteLocalAudio" : "", [&core, mute]() { core.MuteLocalAudio(mute); }, nullptr });
+            }
+            double postSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            RunAndWait(core, []() {});
+            double totalSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            uint64_t executed = core.GetCommandQueue().GetExecutedCount() - executedBefore - 1;
+            uint64_t coalesced = core.GetCommandQueue().GetCoalescedCount() - coalescedBefore;
+            std::printf("  %-8s cost %3d us  %8.0f posts/s  %8.0f commands/s  (%llu run, %llu coalesced)\n",
+                        keyed ? "keyed" : "barrier", callCostUs, kCommands / postSeconds, kCommands / totalSeconds,
+                        static_cast<unsigned long long>(executed), static_cast<unsigned long long>(coalesced));
+        }
+    }
+
+    // Time from the fake raising onUserJoined on its callback thread to the listener's batch
+    void BenchCallbackLatency(int flushIntervalMs)
+    {
+        FakeEngineConfig config;
+        config.joinDelayMs = 0;
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core([config, &fake]() {
+            auto engine = std::make_unique<FakeVoiceEngine>(config);
+            fake = engine.get();
+            return engine;
+        });
+        LatencyListener listener;
+        core.SetListener(&listener);
+        core.SetEventFlushInterval(flushIntervalMs);
+        RunAndWait(core, [&core]() { core.InitializeEngine("bench"); });
+        RunAndWait(core, [&core]() { core.JoinChannel("bench"); });
+        FakeVoiceEngine::ConnectionInfo info;
+        while (!fake->FindConnection("bench", info) || !info.joined) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        std::vector<double> latenciesUs;
+        for (int i = 0; i < kLatencySamples; ++i) {
+            uint32_t uid = 1000 + i;
+            listener.Expect(uid);
+            auto start = Clock::now();
+            fake->AddRemoteUser("bench", uid);
+            Clock::time_point seenAt;
+            if (!listener.WaitSeen(seenAt)) {
+                std::printf("  uid %u never arrived\n", uid);
+                break;
+            }
+            latenciesUs.push_back(std::chrono::duration<double, std::micro>(seenAt - start).count());
+        }
+        core.SetListener(nullptr);
+
+        std::printf("  flush %2d ms  p50 %8.0f us  p90 %8.0f us  p99 %8.0f us  max %8.0f us\n", flushIntervalMs,
+                    Percentile(latenciesUs, 0.50), Percentile(latenciesUs, 0.90), Percentile(latenciesUs, 0.99),
+                    Percentile(latenciesUs, 1.0));
+    }
+
+    // Allocation counter delta over many rounds of one operation, run on the worker
+    void ReportAllocations(AgoraCore& core, const char* name, const std::function<void(int)>& operation)
+    {
+        uint64_t allocations = 0;
+        RunAndWait(core, [&]() {
+            uint64_t before = g_allocations.load(std::memory_order_relaxed);
+            for (int i = 0; i < kAllocationRounds; ++i) operation(i);
+            allocations = g_allocations.load(std::memory_order_relaxed) - before;
+        });
+        std::printf("  %-36s %8.2f allocations/op\n", name, static_cast<double>(allocations) / kAllocationRounds);
+    }
+
+    void BenchAllocations()
+    {
+        FakeEngineConfig config;
+        config.manualClock = true;
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core([config, &fake]() {
+            auto engine = std::make_unique<FakeVoiceEngine>(config);
+            fake = engine.get();
+            return engine;
+        });
+        NullListener listener;
+        core.SetListener(&listener);
+        RunAndWait(core, [&core]() { core.InitializeEngine("bench"); });
+        RunAndWait(core, [&core]() {
+            core.JoinRadioChannel("alpha", true);
+            core.JoinRadioChannel("bravo", false);
+        });
+        fake->AdvanceBy(100);
+
+        ReportAllocations(core, "MuteLocalAudio", [&core](int i) { core.MuteLocalAudio((i & 1) != 0); });
+        ReportAllocations(core, "SetTalkChannel (alpha <-> bravo)", [&core](int i) {
+            core.SetTalkChannel((i & 1) != 0 ? "alpha" : "bravo");
+        });
+        ReportAllocations(core, "AdjustRecordingVolume", [&core](int i) { core.AdjustRecordingVolume(i % 400); });
+        ReportAllocations(core, "GetState (snapshot copy)", [&core](int) { (void)core.GetState(); });
+        ReportAllocations(core, "GetMetrics (JSON snapshot)", [&core](int) { (void)core.GetMetrics(); });
+
+        // Caller side: building and posting one command
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        for (int i = 0; i < kAllocationRounds; ++i) {
+            core.Post(Command{ "MuteLocalAudio", [&core, i]() { core.MuteLocalAudio((i & 1) != 0); }, nullptr });
+        }
+        uint64_t posted = g_allocations.load(std::memory_order_relaxed) - before;
+        RunAndWait(core, []() {});
+        std::printf("  %-36s %8.2f allocations/op\n", "Post (keyed command)", static_cast<double>(posted) / kAllocationRounds);
+
+        core.SetListener(nullptr);
+    }
+
+    // ns and allocations per call of one reader, on the calling (JS) thread like the host object
+    void ReportRead(const char* name, const std::function<void()>& read)
+    {
+        for (int i = 0; i < 1000; ++i) read(); // warm up
+        uint64_t before = g_allocations.load(std::memory_order_relaxed);
+        auto start = Clock::now();
+        for (int i = 0; i < kReadRounds; ++i) read();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / kReadRounds;
+        uint64_t allocations = g_allocations.load(std::memory_order_relaxed) - before;
+        std::printf("  %-36s %8.0f ns/call %8.2f allocations/call\n", name, ns,
+                    static_cast<double>(allocations) / kReadRounds);
+    }
+
+    void BenchStatusReads()
+    {
+        FakeEngineConfig config;
+        config.manualClock = true;
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core([config, &fake]() {
+            auto engine = std::make_unique<FakeVoiceEngine>(config);
+            fake = engine.get();
+            return engine;
+        });
+        NullListener listener;
+        core.SetListener(&listener);
+        RunAndWait(core, [&core]() { core.InitializeEngine("bench"); });
+        RunAndWait(core, [&core]() {
+            core.JoinChannel("ops");
+            core.JoinRadioChannel("alpha", true);
+            core.JoinRadioChannel("bravo", false);
+            core.EnableVolumeIndication(1000, 3);
+        });
+        fake->AdvanceBy(100);
+        fake->ReportVolumes("alpha", { { 11, 180 }, { 12, 60 }, { 13, 20 } });
+        fake->AdvanceBy(0);
+
+        std::printf(" before: bridge-era readers\n");
+        ReportRead("GetStatus (status text)", [&core]() { (void)core.GetStatus(); });
+        ReportRead("IsLocalAudioMuted", [&core]() { (void)core.IsLocalAudioMuted(); });
+        ReportRead("GetMetrics (JSON snapshot)", [&core]() { (void)core.GetMetrics(); });
+
+        std::printf(" after: hot reads\n");
+        ReportRead("ReadState (muted)", [&core]() {
+            (void)core.ReadState([](const AgoraState& state) { return state.isLocalAudioMuted; });
+        });
+        ReportRead("GetConnectionState (alpha)", [&core]() { (void)core.GetConnectionState("alpha"); });
+        VolumeChange levels[16];
+        ReportRead("ReadLevels (alpha, 3 uids)", [&core, &levels]() { (void)core.ReadLevels("alpha", levels, 16); });
+        int executed = AgoraCore::FindCounter("commands.executed");
+        int joins = AgoraCore::FindCounter("join.p50Us");
+        ReportRead("ReadCounter (commands.executed)", [&core, executed]() { (void)core.ReadCounter(executed); });
+        ReportRead("ReadCounter (join.p50Us)", [&core, joins]() { (void)core.ReadCounter(joins); });
+
+        // What a call screen asks each refresh: mute, link, talkers and one latency
+        std::printf(" one status poll\n");
+        ReportRead("before: status + mute + metrics", [&core]() {
+            (void)core.GetStatus();
+            (void)core.IsLocalAudioMuted();
+            (void)core.GetMetrics();
+        });
+        ReportRead("after: mute + link + levels + p50", [&core, &levels, joins]() {
+            (void)core.ReadState([](const AgoraState& state) { return state.isLocalAudioMuted; });
+            (void)core.GetConnectionState("alpha");
+            (void)core.ReadLevels("alpha", levels, 16);
+            (void)core.ReadCounter(joins);
+        });
+
+        RunAndWait(core, [&core]() { core.EnableVolumeIndication(0, 3); });
+        core.SetListener(nullptr);
+    }
+}
+
+int main()
+{
+    std::printf("Command throughput (%d mute commands, one producer)\n", kCommands);
+    BenchCommandThroughput(0);
+    BenchCommandThroughput(5);
+
+    std::printf("\nCallback-to-listener latency (%d onUserJoined, threaded fake)\n", kLatencySamples);
+    BenchCallbackLatency(EventBatcher::kDefaultFlushIntervalMs);
+    BenchCallbackLatency(1);
+
+    std::printf("\nHeap allocations per operation (worker side unless noted)\n");
+    BenchAllocations();
+
+    std::printf("\nStatus reads (%d calls each, caller thread)\n", kReadRounds);
+    BenchStatusReads();
+    return 0;
+}
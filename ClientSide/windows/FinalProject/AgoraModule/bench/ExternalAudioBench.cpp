@@ -0,0 +1,167 @@
+// External audio benchmark: the whole external path as fast as it will go - capture device
+// chunks into the ring, the pump through the capture pipeline, FakeVoiceEngine's loopback, the
+// playback pipeline and the ring back out to the renderer - driven from a WAV file.
+//
+//   g++ -std=c++17 -O2 -pthread -I.. ExternalAudioBench.cpp ../*.cpp -o ExternalAudioBench
+//   ./ExternalAudioBench [input.wav [output.wav]]
+//
+// Takes a 16-bit PCM WAV (8-48 kHz, mono or stereo); without arguments it runs on 60 s of a
+// synthesized voice. Device periods vary from chunk to chunk the way real drivers do, and the
+// pump is stepped directly instead of every 10 ms, so the output and its checksum are the same
+// on every run and machine. Realtime factor is audio time over wall time for the whole path.
+#include "../AgoraCore.h"
+#include "../AudioPipeline.h"
+#include "../ExternalAudio.h"
+#include "../FakeVoiceEngine.h"
+#include "WavFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    constexpr int kRuns = 5;
+    constexpr int kPlaybackChannels = 2;
+    // Capture and render periods in frames, cycled: none of them a multiple of 10 ms
+    constexpr int kCapturePeriods[] = { 441, 97, 613, 480, 256 };
+    constexpr int kRenderPeriods[] = { 333, 512, 128, 480, 701 };
+
+    wav::WavData MakeVoice()
+    {
+        constexpr int kRate = 48000;
+        wav::WavData data{ kRate, 1, std::vector<int16_t>(static_cast<size_t>(kRate) * 60) };
+        uint32_t noise = 1;
+        for (size_t i = 0; i < data.samples.size(); ++i) {
+            float t = static_cast<float>(i) / kRate;
+            float envelope = 0.5f + 0.5f * std::sin(2.0f * 3.14159265f * 3.0f * t);
+            noise = noise * 1664525u + 1013904223u;
+            float value = envelope * (9000.0f * std::sin(2.0f * 3.14159265f * 180.0f * t) +
+                                      4000.0f * std::sin(2.0f * 3.14159265f * 720.0f * t)) +
+                          static_cast<float>(static_cast<int32_t>(noise >> 22) - 512);
+            data.samples[i] = static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, value)));
+        }
+        return data;
+    }
+
+    struct RunResult
+    {
+        double wallMs = 0.0;
+        uint64_t steps = 0;
+        uint64_t checksum = 0;
+        ExternalAudioStats stats;
+    };
+
+    RunResult Run(const wav::WavData& input, std::vector<int16_t>* output)
+    {
+        AgoraEventHandler events;
+        FakeVoiceEngine engine;
+        engine.Initialize("bench", &events);
+        engine.SetExternalAudio(true, input.sampleRate, input.channels, kPlaybackChannels);
+
+        AudioPipeline capture, playback;
+        ExternalAudio audio;
+        ExternalAudioConfig config;
+        config.sampleRate = input.sampleRate;
+        config.captureChannels = input.channels;
+        config.playbackChannels = kPlaybackChannels;
+        config.paced = false;
+        audio.Configure(config);
+        audio.Start(&engine, &capture, &playback);
+
+        const int frame = audio.GetFramesPerChannel();
+        const size_t totalFrames = input.samples.size() / static_cast<size_t>(input.channels);
+        std::vector<int16_t> rendered(static_cast<size_t>(*std::max_element(std::begin(kRenderPeriods), std::end(kRenderPeriods))) *
+                                      kPlaybackChannels);
+        if (output) output->clear();
+
+        RunResult result;
+        result.checksum = 1469598103934665603ull; // FNV-1a over everything rendered
+        size_t captured = 0, capturePeriod = 0, renderPeriod = 0;
+        int64_t renderable = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t step = 0; (step + 1) * static_cast<size_t>(frame) <= totalFrames; ++step) {
+            // The capture device delivers whole periods until it is at least a frame ahead
+            while (captured < (step + 1) * static_cast<size_t>(frame)) {
+                size_t period = std::min<size_t>(kCapturePeriods[capturePeriod++ % std::size(kCapturePeriods)], totalFrames - captured);
+                audio.WriteCapture(input.samples.data() + captured * input.channels, static_cast<int>(period));
+                captured += period;
+            }
+            audio.Pump();
+            ++result.steps;
+
+            // The renderer takes whole periods of what has been pulled so far
+            renderable += frame;
+            for (;;) {
+                int period = kRenderPeriods[renderPeriod % std::size(kRenderPeriods)];
+                if (renderable < period) break;
+                ++renderPeriod;
+                audio.ReadPlayback(rendered.data(), period);
+                renderable -= period;
+                const size_t count = static_cast<size_t>(period) * kPlaybackChannels;
+                for (size_t i = 0; i < count; ++i) {
+                    result.checksum = (result.checksum ^ static_cast<uint16_t>(rendered[i])) * 1099511628211ull;
+                }
+                if (output) output->insert(output->end(), rendered.begin(), rendered.begin() + count);
+            }
+        }
+        result.wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.stats = audio.GetStats();
+        audio.Stop();
+        return result;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    wav::WavData input;
+    std::string name = "synthesized voice";
+    if (argc >= 2) {
+        name = argv[1];
+        if (!wav::Read(argv[1], input) || input.sampleRate < 8000 || input.sampleRate > 48000 ||
+            input.channels < 1 || input.channels > 2) {
+            std::printf("ExternalAudioBench: %s is not 8-48 kHz mono or stereo PCM16\n", argv[1]);
+            return 1;
+        }
+    } else {
+        input = MakeVoice();
+    }
+
+    const double audioMs = 1000.0 * static_cast<double>(input.samples.size() / input.channels) / input.sampleRate;
+    std::printf("ExternalAudioBench: %s, %.1f s at %d Hz, %d ch in, %d ch out, best of %d\n",
+                name.c_str(), audioMs / 1000.0, input.sampleRate, input.channels, kPlaybackChannels, kRuns);
+
+    std::vector<int16_t> output;
+    RunResult best;
+    bool deterministic = true;
+    for (int run = 0; run < kRuns; ++run) {
+        RunResult result = Run(input, run == 0 ? &output : nullptr);
+        if (run == 0) {
+            best = result;
+            continue;
+        }
+        deterministic = deterministic && result.checksum == best.checksum;
+        if (result.wallMs < best.wallMs) best.wallMs = result.wallMs;
+    }
+
+    const double nsPerStep = best.wallMs * 1e6 / static_cast<double>(std::max<uint64_t>(1, best.steps));
+    std::printf("%-14s %10s %14s %12s %18s\n", "steps", "wall ms", "ns/10 ms step", "realtime x", "checksum");
+    std::printf("%-14llu %10.1f %14.0f %12.0f %18llx%s\n", static_cast<unsigned long long>(best.steps), best.wallMs,
+                nsPerStep, audioMs / best.wallMs, static_cast<unsigned long long>(best.checksum),
+                deterministic ? "" : " (differs between runs!)");
+    std::printf("pushed %llu, pulled %llu, capture overruns %llu / underruns %llu, playback overruns %llu / underruns %llu\n",
+                static_cast<unsigned long long>(best.stats.pushedFrames), static_cast<unsigned long long>(best.stats.pulledFrames),
+                static_cast<unsigned long long>(best.stats.captureOverruns), static_cast<unsigned long long>(best.stats.captureUnderruns),
+                static_cast<unsigned long long>(best.stats.playbackOverruns), static_cast<unsigned long long>(best.stats.playbackUnderruns));
+
+    if (argc >= 3) {
+        wav::WavData rendered{ input.sampleRate, kPlaybackChannels, std::move(output) };
+        std::printf("%s %s\n", wav::Write(argv[2], rendered) ? "wrote" : "FAILED", argv[2]);
+    }
+    return deterministic ? 0 : 1;
+}
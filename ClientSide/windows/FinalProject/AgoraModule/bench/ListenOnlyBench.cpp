@@ -0,0 +1,120 @@
+// Many idle listeners on one channel, joined the old way (broadcaster, muted) and as audience.
+// Reports the audio-thread time spent per listener, the modeled uplink and how many
+// publishers the server sees. CPU is measured for real on our capture pipeline; the SDK's own
+// capture work and the bitrates are the FakeEngineConfig model, printed with the results.
+//
+//   cmake -S .. -B build -DCMAKE_BUILD_TYPE=Release && cmake --build build
+//   ./build/ListenOnlyBench
+#include "../AgoraCore.h"
+#include "../FakeVoiceEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int kListeners = 32;
+    constexpr int kAudioSeconds = 10;
+
+    struct Listener
+    {
+        explicit Listener(const FakeEngineConfig& config)
+            : core([this, config]() {
+                  auto engine = std::make_unique<FakeVoiceEngine>(config);
+                  fake = engine.get();
+                  return engine;
+              })
+        {
+        }
+
+        void Run(std::function<void()> fn)
+        {
+            std::promise<void> done;
+            core.Post(Command{ "", std::move(fn), [&done]() { done.set_value(); } });
+            done.get_future().wait();
+        }
+
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core;
+    };
+
+    struct Result
+    {
+        double cpuUsPerListenerSecond = 0.0;
+        double uplinkKbps = 0.0;
+        int publishers = 0;
+        uint64_t capturedFrames = 0;
+    };
+
+    Result RunIdle(bool listenOnly, const FakeEngineConfig& model)
+    {
+        FakeEngineConfig config = model;
+        config.manualClock = true;
+
+        std::vector<std::unique_ptr<Listener>> listeners;
+        for (int i = 0; i < kListeners; ++i) {
+            auto listener = std::make_unique<Listener>(config);
+            Listener& l = *listener;
+            l.Run([&l]() { l.core.InitializeEngine("bench"); });
+            l.Run([&l, listenOnly]() { l.core.JoinChannel("dispatch", listenOnly); });
+            // The old ListenOnly: a broadcaster that never unmutes
+            if (!listenOnly) l.Run([&l]() { l.core.MuteLocalAudio(true); });
+            l.fake->AdvanceBy(config.joinDelayMs);
+            listeners.push_back(std::move(listener));
+        }
+
+        Result result;
+        auto start = Clock::now();
+        for (int second = 0; second < kAudioSeconds; ++second) {
+            for (auto& listener : listeners) listener->fake->PumpAudio(1000);
+        }
+        double elapsedUs = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+
+        uint64_t uplinkBytes = 0;
+        for (auto& listener : listeners) {
+            uplinkBytes += listener->fake->GetUplinkBytes();
+            result.capturedFrames += listener->fake->GetCapturedFrames();
+            result.publishers += listener->fake->GetPublisherCount();
+        }
+        result.cpuUsPerListenerSecond = elapsedUs / (kListeners * kAudioSeconds);
+        result.uplinkKbps = uplinkBytes * 8.0 / 1000.0 / (kListeners * kAudioSeconds);
+        return result;
+    }
+
+    void Compare(const char* label, const FakeEngineConfig& model)
+    {
+        Result muted = RunIdle(false, model);
+        Result audience = RunIdle(true, model);
+
+        std::printf("%s\n", label);
+        std::printf("  %-22s %14s %14s %12s %14s\n", "", "audio us/s", "uplink kbps", "publishers", "frames");
+        std::printf("  %-22s %14.1f %14.2f %12d %14llu\n", "muted broadcaster", muted.cpuUsPerListenerSecond,
+                    muted.uplinkKbps, muted.publishers, static_cast<unsigned long long>(muted.capturedFrames));
+        std::printf("  %-22s %14.1f %14.2f %12d %14llu\n", "audience", audience.cpuUsPerListenerSecond,
+                    audience.uplinkKbps, audience.publishers, static_cast<unsigned long long>(audience.capturedFrames));
+        double cpuSaved = muted.cpuUsPerListenerSecond > 0.0
+            ? 100.0 * (1.0 - audience.cpuUsPerListenerSecond / muted.cpuUsPerListenerSecond) : 0.0;
+        double uplinkSaved = muted.uplinkKbps > 0.0 ? 100.0 * (1.0 - audience.uplinkKbps / muted.uplinkKbps) : 0.0;
+        std::printf("  saved per listener: %.0f%% audio-thread time, %.0f%% uplink\n\n", cpuSaved, uplinkSaved);
+    }
+}
+
+int main()
+{
+    std::printf("%d idle listeners, %d s of audio each\n\n", kListeners, kAudioSeconds);
+
+    FakeEngineConfig pipelineOnly;
+    Compare("Our capture pipeline only (captureCostUs 0)", pipelineOnly);
+
+    FakeEngineConfig withSdk;
+    withSdk.captureCostUs = 50;
+    std::printf("Uplink model: %d kbps muted publisher, %d kbps listener\n", withSdk.mutedKbps, withSdk.listenerKbps);
+    Compare("Plus 50 us per captured frame for the SDK's capture and 3A (model)", withSdk);
+    return 0;
+}
@@ -0,0 +1,86 @@
+// Metrics overhead: what a recorder pays per call, alone and with other threads hammering
+// the same histogram, and what a GetMetrics snapshot costs.
+//
+//   g++ -std=c++17 -O2 -pthread MetricsBench.cpp ../Metrics.cpp -o MetricsBench
+//   ./MetricsBench
+#include "../Metrics.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    constexpr int kRecords = 2000000;
+    constexpr int kSnapshots = 2000;
+
+    // Every thread records into the same op, the worst case for cache-line sharing
+    double RecordNs(int threads)
+    {
+        Metrics metrics;
+        std::vector<std::thread> workers;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&metrics, t]() {
+                uint64_t micros = 1000 + t;
+                for (int i = 0; i < kRecords; ++i) {
+                    metrics.RecordLatency(MetricOp::Mute, micros);
+                    micros = (micros * 1103515245 + 12345) & 0xFFFFF;
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kRecords;
+    }
+
+    double StatsNs()
+    {
+        Metrics metrics;
+        RemoteAudioSample sample;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kRecords; ++i) {
+            sample.networkDelayMs = i & 0xFF;
+            metrics.RecordRemoteAudio(static_cast<uint8_t>(i & 7), static_cast<uint32_t>(i & 31), sample);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration<double, std::nano>(elapsed).count() / kRecords;
+    }
+
+    void Snapshot()
+    {
+        Metrics metrics;
+        for (int op = 0; op < static_cast<int>(MetricOp::Count); ++op) {
+            for (uint64_t i = 1; i < 1000; ++i) metrics.RecordLatency(static_cast<MetricOp>(op), i * 997);
+        }
+        ChannelStatsSample stats;
+        RemoteAudioSample sample;
+        for (uint8_t channel = 0; channel < 8; ++channel) {
+            metrics.SetChannelName(channel, "radio-" + std::to_string(channel));
+            metrics.RecordChannelStats(channel, stats);
+            for (uint32_t uid = 1; uid <= 6; ++uid) metrics.RecordRemoteAudio(channel, uid, sample);
+        }
+
+        size_t bytes = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kSnapshots; ++i) bytes = metrics.SnapshotJson().size();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        std::printf("snapshot (9 ops, 8 channels, 48 uids): %.1f us, %zu bytes\n",
+                    std::chrono::duration<double, std::micro>(elapsed).count() / kSnapshots, bytes);
+    }
+}
+
+int main()
+{
+    std::printf("MetricsBench: %d records per thread\n", kRecords);
+    const int hardware = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= std::min(8, hardware); threads *= 2) {
+        std::printf("RecordLatency, %d thread(s): %6.1f ns/call (wall per thread)\n", threads, RecordNs(threads));
+    }
+    std::printf("RecordRemoteAudio (8 channels x 32 uids): %6.1f ns/call\n", StatsNs());
+    Snapshot();
+    return 0;
+}
@@ -0,0 +1,178 @@
+// VOX detector benchmark: cost per 10 ms frame and how much of each fixture would be sent.
+//
+//   g++ -std=c++17 -O2 VoiceActivityDetectorBench.cpp ../VoiceActivityDetector.cpp ../AudioDsp.cpp -o VoiceActivityDetectorBench
+//   ./VoiceActivityDetectorBench [recording.wav ...]
+//   ./VoiceActivityDetectorBench --write-fixtures <dir>
+//
+// Takes 16-bit PCM WAV recordings (any rate, stereo is downmixed). Without arguments it
+// runs on synthesized fixtures; --write-fixtures saves those as WAVs to compare against
+// real recordings of the same situations. "sent" is the fraction of time the uplink
+// would be unmuted, "switches" the number of gate transitions.
+#include "../AudioDsp.h"
+#include "../VoiceActivityDetector.h"
+#include "WavFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    constexpr int kSampleRate = 48000;
+    constexpr int kRuns = 5;
+    constexpr float kPi = 3.14159265f;
+
+    struct Fixture
+    {
+        std::string name;
+        wav::WavData audio; // mono after Load
+    };
+
+    int16_t Clamp(float value)
+    {
+        return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, value)));
+    }
+
+    // 20 s of talk spurts (0.4-2.5 s) with pauses, over a quiet room
+    wav::WavData MakeConversation(float noiseAmplitude)
+    {
+        std::mt19937 random(11);
+        std::normal_distribution<float> noise(0.0f, noiseAmplitude);
+        std::uniform_real_distribution<float> spurt(0.4f, 2.5f), pause(0.3f, 1.5f), pitch(95.0f, 220.0f);
+
+        wav::WavData data{ kSampleRate, 1, std::vector<int16_t>(static_cast<size_t>(kSampleRate) * 20) };
+        size_t position = 0;
+        bool talking = false;
+        while (position < data.samples.size()) {
+            size_t length = static_cast<size_t>((talking ? spurt(random) : pause(random)) * kSampleRate);
+            float f0 = pitch(random);
+            for (size_t i = 0; i < length && position < data.samples.size(); ++i, ++position) {
+                float t = static_cast<float>(i) / kSampleRate;
+                float value = noise(random);
+                if (talking) {
+                    // Syllable-rate envelope over a voiced harmonic stack
+                    float envelope = 0.55f + 0.45f * std::sin(2.0f * kPi * 4.0f * t);
+                    value += envelope * (5000.0f * std::sin(2.0f * kPi * f0 * t) + 2500.0f * std::sin(2.0f * kPi * 3.0f * f0 * t) +
+                                         900.0f * std::sin(2.0f * kPi * 9.0f * f0 * t));
+                }
+                data.samples[position] = Clamp(value);
+            }
+            talking = !talking;
+        }
+        return data;
+    }
+
+    wav::WavData MakeHiss(float amplitude)
+    {
+        std::mt19937 random(5);
+        std::normal_distribution<float> noise(0.0f, amplitude);
+        wav::WavData data{ kSampleRate, 1, std::vector<int16_t>(static_cast<size_t>(kSampleRate) * 10) };
+        for (auto& sample : data.samples) sample = Clamp(noise(random));
+        return data;
+    }
+
+    wav::WavData MakeHum(float hz, float amplitude)
+    {
+        wav::WavData data{ kSampleRate, 1, std::vector<int16_t>(static_cast<size_t>(kSampleRate) * 10) };
+        for (size_t i = 0; i < data.samples.size(); ++i) {
+            data.samples[i] = Clamp(amplitude * std::sin(2.0f * kPi * hz * static_cast<float>(i) / kSampleRate));
+        }
+        return data;
+    }
+
+    std::vector<Fixture> SynthesizedFixtures()
+    {
+        return {
+            { "conversation-quiet-room", MakeConversation(60.0f) },
+            { "conversation-noisy-room", MakeConversation(600.0f) },
+            { "radio-hiss", MakeHiss(3000.0f) },
+            { "mains-hum-50hz", MakeHum(50.0f, 8000.0f) },
+        };
+    }
+
+    void DownmixToMono(wav::WavData& data)
+    {
+        if (data.channels <= 1) return;
+        size_t frames = data.samples.size() / data.channels;
+        for (size_t i = 0; i < frames; ++i) {
+            int32_t sum = 0;
+            for (int c = 0; c < data.channels; ++c) sum += data.samples[i * data.channels + c];
+            data.samples[i] = static_cast<int16_t>(sum / data.channels);
+        }
+        data.samples.resize(frames);
+        data.channels = 1;
+    }
+
+    void Run(const Fixture& fixture, DspIsa isa)
+    {
+        const int frameSize = fixture.audio.sampleRate / 100;
+        const size_t frames = fixture.audio.samples.size() / frameSize;
+        if (frames == 0) return;
+
+        double bestNs = 1e30;
+        size_t activeFrames = 0;
+        int transitions = 0;
+        for (int run = 0; run < kRuns; ++run) {
+            VoiceActivityDetector detector(GetDspKernels(isa));
+            detector.Configure(VadConfig{}, fixture.audio.sampleRate);
+            detector.Reset();
+
+            activeFrames = 0;
+            transitions = 0;
+            bool previous = false;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < frames; ++i) {
+                bool active = detector.Process(fixture.audio.samples.data() + i * frameSize, frameSize);
+                activeFrames += active ? 1 : 0;
+                transitions += active != previous ? 1 : 0;
+                previous = active;
+            }
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            bestNs = std::min(bestNs, std::chrono::duration<double, std::nano>(elapsed).count() / frames);
+        }
+
+        std::printf("%-28s %-7s %8.0f %8.1f%% %9d\n", fixture.name.c_str(), DspIsaName(isa), bestNs,
+                    100.0 * activeFrames / frames, transitions);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<Fixture> fixtures;
+
+    if (argc == 3 && std::string(argv[1]) == "--write-fixtures") {
+        for (const auto& fixture : SynthesizedFixtures()) {
+            std::string path = std::string(argv[2]) + "/" + fixture.name + ".wav";
+            std::printf("%s %s\n", wav::Write(path, fixture.audio) ? "wrote" : "FAILED", path.c_str());
+        }
+        return 0;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        Fixture fixture{ argv[i], {} };
+        if (!wav::Read(argv[i], fixture.audio) || fixture.audio.sampleRate < 100) {
+            std::printf("skipping %s: not a 16-bit PCM WAV\n", argv[i]);
+            continue;
+        }
+        DownmixToMono(fixture.audio);
+        fixtures.push_back(std::move(fixture));
+    }
+    if (argc == 1) fixtures = SynthesizedFixtures();
+
+    std::printf("VoiceActivityDetectorBench: 10 ms frames, best of %d runs\n", kRuns);
+    std::printf("%-28s %-7s %8s %9s %9s\n", "fixture", "isa", "ns/frame", "sent", "switches");
+
+    std::vector<DspIsa> isas{ DspIsa::Scalar };
+    if (DetectDspIsa() >= DspIsa::Sse2) isas.push_back(DspIsa::Sse2);
+    if (DetectDspIsa() >= DspIsa::Avx2) isas.push_back(DspIsa::Avx2);
+
+    for (const auto& fixture : fixtures) {
+        for (DspIsa isa : isas) Run(fixture, isa);
+    }
+    return 0;
+}
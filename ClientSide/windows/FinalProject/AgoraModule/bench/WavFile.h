@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Minimal RIFF/WAVE reader and writer for bench fixtures: 16-bit PCM only.
+// Header-only so every bench can pull it in without a build step.
+namespace wav
+{
+    struct WavData
+    {
+        int sampleRate = 0;
+        int channels = 0;
+        std::vector<int16_t> samples; // interleaved
+    };
+
+    inline uint32_t ReadLe32(const unsigned char* bytes)
+    {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    inline uint16_t ReadLe16(const unsigned char* bytes)
+    {
+        return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+    }
+
+    // Returns false (and leaves data empty) for anything but PCM16
+    inline bool Read(const std::string& path, WavData& data)
+    {
+        data = WavData{};
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) return false;
+
+        unsigned char riff[12];
+        bool ok = std::fread(riff, 1, sizeof(riff), file) == sizeof(riff) &&
+                  std::memcmp(riff, "RIFF", 4) == 0 && std::memcmp(riff + 8, "WAVE", 4) == 0;
+
+        int bitsPerSample = 0;
+        while (ok) {
+            unsigned char chunk[8];
+            if (std::fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk)) {
+                ok = false;
+                break;
+            }
+            uint32_t size = ReadLe32(chunk + 4);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0) {
+                unsigned char format[16];
+                if (size < sizeof(format) || std::fread(format, 1, sizeof(format), file) != sizeof(format)) {
+                    ok = false;
+                    break;
+                }
+                ok = ReadLe16(format) == 1; // WAVE_FORMAT_PCM
+                data.channels = ReadLe16(format + 2);
+                data.sampleRate = static_cast<int>(ReadLe32(format + 4));
+                bitsPerSample = ReadLe16(format + 14);
+                std::fseek(file, static_cast<long>(size - sizeof(format) + (size & 1)), SEEK_CUR);
+            } else if (std::memcmp(chunk, "data", 4) == 0) {
+                ok = bitsPerSample == 16 && data.channels > 0;
+                if (ok) {
+                    data.samples.resize(size / sizeof(int16_t));
+                    data.samples.resize(std::fread(data.samples.data(), sizeof(int16_t), data.samples.size(), file));
+                }
+                break;
+            } else {
+                std::fseek(file, static_cast<long>(size + (size & 1)), SEEK_CUR);
+            }
+        }
+
+        std::fclose(file);
+        if (!ok) data = WavData{};
+        return ok;
+    }
+
+    inline bool Write(const std::string& path, const WavData& data)
+    {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) return false;
+
+        auto le32 = [file](uint32_t value) {
+            unsigned char bytes[4] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8),
+                                       static_cast<unsigned char>(value >> 16), static_cast<unsigned char>(value >> 24) };
+            std::fwrite(bytes, 1, 4, file);
+        };
+        auto le16 = [file](uint16_t value) {
+            unsigned char bytes[2] = { static_cast<unsigned char>(value), static_cast<unsigned char>(value >> 8) };
+            std::fwrite(bytes, 1, 2, file);
+        };
+
+        uint32_t dataBytes = static_cast<uint32_t>(data.samples.size() * sizeof(int16_t));
+        std::fwrite("RIFF", 1, 4, file);
+        le32(36 + dataBytes);
+        std::fwrite("WAVEfmt ", 1, 8, file);
+        le32(16);
+        le16(1);
+        le16(static_cast<uint16_t>(data.channels));
+        le32(static_cast<uint32_t>(data.sampleRate));
+        le32(static_cast<uint32_t>(data.sampleRate * data.channels * 2));
+        le16(static_cast<uint16_t>(data.channels * 2));
+        le16(16);
+        std::fwrite("data", 1, 4, file);
+        le32(dataBytes);
+        bool ok = std::fwrite(data.samples.data(), sizeof(int16_t), data.samples.size(), file) == data.samples.size();
+        std::fclose(file);
+        return ok;
+    }
+}
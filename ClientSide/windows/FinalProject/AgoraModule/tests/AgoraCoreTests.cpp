@@ -0,0 +1,1256 @@
+// End-to-end tests for AgoraCore on FakeVoiceEngine - no Agora SDK or WinRT required.
+// Commands run on the core's worker like they do behind the React methods; SDK callbacks
+// fire from the fake's manual clock, so every scenario plays out the same way each run.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/AgoraCoreTests
+#include "../AgoraCore.h"
+#include "../FakeVoiceEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // Records everything the core hands to the bridge
+    class RecordingListener : public IAgoraCoreListener
+    {
+    public:
+        void OnEventBatch(const std::vector<AgoraEvent>& events, const EventBatchStats&) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_events.insert(m_events.end(), events.begin(), events.end());
+        }
+
+        void OnVolumeUpdate(const VolumeUpdate& update) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& change : update.levels) {
+                m_levels.push_back({ update.channels[change.channel], change.uid, change.level });
+            }
+        }
+
+        void OnTalkStateChanged(bool talking, bool vox) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_talkStates.push_back({ talking, vox });
+        }
+
+        void OnCallLatency(const std::string& channelName, bool warm, double acceptMs) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_calls.push_back({ channelName, warm, acceptMs });
+        }
+
+        void OnConnectionStateChanged(const std::string& channelName, const ConnectionTransition& transition) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_connections.push_back({ channelName, transition });
+        }
+
+        void OnCallSignal(const CallSignal&) override {}
+        void OnCallSignalStatus(const CallSignal&, bool) override {}
+        void OnFloorChanged(const FloorChange&) override {}
+
+        void OnLatencyProbeFinished(const LatencyReport& report) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_probeReports.push_back(report);
+        }
+
+        void OnAudioDevicesChanged(const AudioDeviceList& list) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_deviceLists.push_back(list);
+        }
+
+        size_t CountEvents(AgoraEventType type, const std::string& channel) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            size_t count = 0;
+            for (const auto& event : m_events) {
+                if (event.type == type && channel == event.channel) ++count;
+            }
+            return count;
+        }
+
+        bool HasLevel(const std::string& channel, uint32_t uid, uint8_t level) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            for (const auto& entry : m_levels) {
+                if (entry.channel == channel && entry.uid == uid && entry.level == level) return true;
+            }
+            return false;
+        }
+
+        struct TalkState { bool talking; bool vox; };
+        struct Call { std::string channel; bool warm; double acceptMs; };
+        struct Level { std::string channel; uint32_t uid; uint8_t level; };
+        struct Link { std::string channel; ConnectionTransition transition; };
+
+        std::vector<TalkState> TalkStates() const { std::lock_guard<std::mutex> lock(m_mutex); return m_talkStates; }
+        std::vector<Call> Calls() const { std::lock_guard<std::mutex> lock(m_mutex); return m_calls; }
+        std::vector<LatencyReport> ProbeReports() const { std::lock_guard<std::mutex> lock(m_mutex); return m_probeReports; }
+        std::vector<AudioDeviceList> DeviceLists() const { std::lock_guard<std::mutex> lock(m_mutex); return m_deviceLists; }
+
+        std::vector<ConnectionTransition> Links(const std::string& channel) const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::vector<ConnectionTransition> links;
+            for (const auto& entry : m_connections) {
+                if (entry.channel == channel) links.push_back(entry.transition);
+            }
+            return links;
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<AgoraEvent> m_events;
+        std::vector<Level> m_levels;
+        std::vector<TalkState> m_talkStates;
+        std::vector<Call> m_calls;
+        std::vector<Link> m_connections;
+        std::vector<LatencyReport> m_probeReports;
+        std::vector<AudioDeviceList> m_deviceLists;
+    };
+
+    // A core whose engine is a manual-clock fake the test can reach
+    struct Fixture
+    {
+        explicit Fixture(FakeEngineConfig config = {})
+            : core([this, config]() {
+                  FakeEngineConfig manual = config;
+                  manual.manualClock = true;
+                  auto engine = std::make_unique<FakeVoiceEngine>(manual);
+                  fake = engine.get();
+                  return engine;
+              })
+        {
+            core.SetListener(&listener);
+        }
+
+        ~Fixture() { core.SetListener(nullptr); }
+
+        // Runs fn on the command worker and waits, like an awaited React method
+        void Run(std::function<void()> fn)
+        {
+            std::promise<void> done;
+            core.Post(Command{ "", std::move(fn), [&done]() { done.set_value(); } });
+            done.get_future().wait();
+        }
+
+        // Fires due SDK callbacks, delivers the batch and lets the worker apply what it posted
+        void Advance(int milliseconds)
+        {
+            fake->AdvanceBy(milliseconds);
+            core.FlushEvents();
+            Run([]() {});
+        }
+
+        RecordingListener listener;
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition, int timeoutMs = 2000)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return true;
+    }
+
+    bool MetricsContain(const AgoraCore& core, const std::string& part)
+    {
+        return core.GetMetrics().find(part) != std::string::npos;
+    }
+
+    // One number from the "ops" section of GetMetrics, e.g. OpField(core, "join", "fail"); -1 if absent
+    long long OpField(const AgoraCore& core, const std::string& op, const std::string& field)
+    {
+        std::string json = core.GetMetrics();
+        size_t at = json.find("\"" + op + "\":{");
+        if (at == std::string::npos) return -1;
+        size_t end = json.find('}', at);
+        size_t key = json.find("\"" + field + "\":", at);
+        if (key == std::string::npos || key > end) return -1;
+        return std::stoll(json.substr(key + field.size() + 3));
+    }
+
+    void TestInitializeConfiguresEngine()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+
+        CHECK(f.fake != nullptr);
+        CHECK(f.fake->IsInitialized());
+        CHECK(f.fake->GetClientRole() == AgoraCore::kRoleBroadcaster);
+        CHECK(f.fake->GetAudioScenario() == AgoraCore::kScenarioMeeting);
+        CHECK(f.fake->HasAudioProcessors());
+        CHECK(f.core.GetState().isInitialized);
+
+        // Same app id again: the warm engine is kept
+        FakeVoiceEngine* first = f.fake;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        CHECK(f.fake == first);
+        CHECK(f.fake->GetCallCount(FakeCall::Initialize) == 1);
+
+        f.Run([&]() { f.core.ReleaseEngine(); });
+        CHECK(!f.core.GetState().isInitialized);
+    }
+
+    void TestInitializeFailure()
+    {
+        // The fake only exists once the factory runs, so fail through the config
+        FakeEngineConfig config;
+        config.failureRate = 1.0;
+        Fixture failing(config);
+        failing.Run([&]() { failing.core.InitializeEngine("app"); });
+        CHECK(!failing.core.GetState().isInitialized);
+        CHECK(OpField(failing.core, "init", "fail") == 1);
+
+        // Commands after a failed init are refused, not crashed
+        failing.Run([&]() { failing.core.JoinChannel("ops"); });
+        CHECK(failing.core.GetState().currentChannel.empty());
+    }
+
+    void TestJoinDeliversEventAndMetrics()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("ops", info));
+        CHECK(!info.joined);
+        CHECK(info.publishing);
+        CHECK(f.core.GetState().currentChannel == "ops");
+
+        // Nothing until the SDK's join time has passed
+        f.Advance(29);
+        CHECK(f.listener.CountEvents(AgoraEventType::JoinChannelSuccess, "ops") == 0);
+        f.Advance(1);
+        CHECK(f.listener.CountEvents(AgoraEventType::JoinChannelSuccess, "ops") == 1);
+        CHECK(f.fake->FindConnection("ops", info) && info.joined);
+        CHECK(OpField(f.core, "joinToSuccess", "n") == 1);
+
+        // Users already in the channel, then one arriving later
+        f.fake->AddRemoteUser("ops", 42);
+        f.Advance(0);
+        CHECK(f.listener.CountEvents(AgoraEventType::UserJoined, "") == 1);
+
+        f.Run([&]() { f.core.LeaveChannel(); });
+        CHECK(f.core.GetState().currentChannel.empty());
+        f.Advance(5);
+        CHECK(f.listener.CountEvents(AgoraEventType::LeaveChannel, "") == 1);
+        CHECK(!f.fake->FindConnection("ops", info));
+    }
+
+    void TestJoinFailureIsCounted()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.fake->FailNext(FakeCall::JoinChannel, FakeVoiceEngine::kErrAlreadyJoined);
+
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        CHECK(f.core.GetState().currentChannel.empty());
+        CHECK(OpField(f.core, "join", "fail") == 1);
+
+        // The fault was one-shot
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        CHECK(f.core.GetState().currentChannel == "ops");
+        CHECK(f.fake->GetInjectedFailureCount() == 1);
+    }
+
+    void TestLeaveBeforeJoinCompletesDropsCallback()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Run([&]() { f.core.LeaveChannel(); });
+        f.Advance(100);
+
+        CHECK(f.listener.CountEvents(AgoraEventType::JoinChannelSuccess, "ops") == 0);
+        CHECK(f.fake->GetPendingCallbackCount() == 0);
+    }
+
+    void TestMuteAndRandomFaults()
+    {
+        FakeEngineConfig config;
+        config.seed = 7;
+        Fixture f(config);
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        CHECK(f.fake->IsLocalAudioMuted());
+        CHECK(f.core.IsLocalAudioMuted());
+
+        // Every injected failure surfaces as a failed mute, and the state follows the last success
+        uint64_t before = f.fake->GetInjectedFailureCount();
+        f.fake->SetFailureRate(0.25);
+        for (int i = 0; i < 200; ++i) {
+            bool mute = (i % 2) == 0;
+            f.Run([&f, mute]() { f.core.MuteLocalAudio(mute); });
+            CHECK(f.core.IsLocalAudioMuted() == f.fake->IsLocalAudioMuted());
+        }
+        f.fake->SetFailureRate(0.0);
+        uint64_t injected = f.fake->GetInjectedFailureCount() - before;
+        CHECK(injected > 20 && injected < 90);
+        CHECK(OpField(f.core, "mute", "fail") == static_cast<long long>(injected));
+    }
+
+    void TestRadiosTalkSwitchAndVox()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Run([&]() { f.core.JoinRadioChannel("ems", false); });
+        f.Advance(30);
+
+        FakeVoiceEngine::ConnectionInfo fire, ems;
+        CHECK(f.fake->FindConnection("fire", fire) && fire.joined && fire.publishing);
+        CHECK(f.fake->FindConnection("ems", ems) && ems.joined && !ems.publishing);
+        CHECK(f.listener.CountEvents(AgoraEventType::JoinChannelSuccess, "ems") == 1);
+
+        // Switching the talk radio only flips publishing
+        f.Run([&]() { f.core.SetTalkChannel("ems"); });
+        CHECK(f.fake->FindConnection("fire", fire) && !fire.publishing);
+        CHECK(f.fake->FindConnection("ems", ems) && ems.publishing);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinConnection) == 2);
+        CHECK(f.core.GetState().talkChannel == "ems");
+
+        // VOX: a second of silence through the capture pipeline closes the gate, the talk radio goes quiet
+        f.Run([&]() { f.core.SetVoxMode(true); });
+        std::vector<int16_t> silence(480, 0);
+        for (int frame = 0; frame < 100; ++frame) {
+            CHECK(f.fake->ProcessCapture(silence.data(), 480, 1, 48000));
+        }
+        f.Advance(0);
+        CHECK(!f.core.IsVoxGateOpen());
+        CHECK(f.fake->FindConnection("ems", ems) && ems.muted);
+        auto talkStates = f.listener.TalkStates();
+        CHECK(!talkStates.empty() && !talkStates.back().talking && talkStates.back().vox);
+
+        f.Run([&]() { f.core.SetVoxMode(false); });
+        CHECK(f.fake->FindConnection("ems", ems) && !ems.muted);
+
+        f.Run([&]() { f.core.LeaveRadioChannel("fire"); });
+        CHECK(f.fake->GetConnectionNames() == std::vector<std::string>{ "ems" });
+    }
+
+    void TestWarmAccept()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.PrepareChannel("call-1"); });
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("call-1", info) && !info.publishing && !info.subscribed);
+        f.Advance(30);
+
+        f.Run([&]() { f.core.AcceptCall("call-1"); });
+        CHECK(f.fake->FindConnection("call-1", info) && info.publishing && info.subscribed);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinChannel) == 0);
+        auto calls = f.listener.Calls();
+        CHECK(calls.size() == 1 && calls[0].channel == "call-1" && calls[0].warm);
+        CHECK(f.core.GetState().currentChannel == "call-1");
+
+        // Hanging up leaves the Ex connection, not the default channel
+        f.Run([&]() { f.core.LeaveChannel(); });
+        CHECK(!f.fake->FindConnection("call-1", info));
+        CHECK(f.fake->GetCallCount(FakeCall::LeaveChannel) == 0);
+    }
+
+    void TestAcceptBeforePreparedJoinCompletes()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.PrepareChannel("call-2"); });
+        f.Run([&]() { f.core.AcceptCall("call-2"); });
+        CHECK(f.listener.Calls().empty());
+
+        f.Advance(30);
+        auto calls = f.listener.Calls();
+        CHECK(calls.size() == 1 && calls[0].warm);
+    }
+
+    void TestVolumeLevelsReachListener()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Advance(30);
+        f.Run([&]() { f.core.EnableVolumeIndication(100, 3); });
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("fire", info) && info.volumeIntervalMs == 100);
+
+        f.fake->ReportVolumes("fire", { { 5, 200 }, { 0, 40 } });
+        f.fake->AdvanceBy(0);
+        CHECK(WaitFor([&]() { return f.listener.HasLevel("fire", 5, 200); }));
+        CHECK(f.listener.HasLevel("fire", 0, 40));
+
+        f.Run([&]() { f.core.EnableVolumeIndication(0, 3); });
+        CHECK(f.fake->FindConnection("fire", info) && info.volumeIntervalMs == 0);
+    }
+
+    void TestHotReadsFromNativeMemory()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        CHECK(f.core.GetConnectionState("ops") == ConnectionState::Disconnected);
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Advance(30);
+
+        // Connection state by channel name, the default channel also as ""
+        CHECK(f.core.GetConnectionState("ops") == ConnectionState::Connected);
+        CHECK(f.core.GetConnectionState("") == ConnectionState::Connected);
+        CHECK(f.core.GetConnectionState("fire") == ConnectionState::Connected);
+        f.fake->DropConnection("fire");
+        f.Advance(0);
+        CHECK(f.core.GetConnectionState("fire") == ConnectionState::Reconnecting);
+        f.Run([&]() { f.core.LeaveRadioChannel("fire"); });
+        CHECK(f.core.GetConnectionState("fire") == ConnectionState::Disconnected);
+        CHECK(f.core.GetState().connections.count("fire") == 0);
+
+        // Current levels without waiting for the next delta
+        f.Run([&]() { f.core.EnableVolumeIndication(100, 3); });
+        f.fake->ReportVolumes("ops", { { 5, 200 }, { 7, 90 } });
+        f.fake->AdvanceBy(0);
+        VolumeChange levels[8];
+        size_t count = f.core.ReadLevels("ops", levels, 8);
+        CHECK(count == 2);
+        for (size_t i = 0; i < count; ++i) {
+            CHECK((levels[i].uid == 5 && levels[i].level == 200) || (levels[i].uid == 7 && levels[i].level == 90));
+        }
+        CHECK(f.core.ReadLevels("ops", levels, 1) == 1);
+        CHECK(f.core.ReadLevels("police", levels, 8) == 0);
+
+        // Counters by name, the same numbers GetMetrics serializes
+        int joins = AgoraCore::FindCounter("join.count");
+        CHECK(joins >= 0 && f.core.ReadCounter(joins) == static_cast<double>(OpField(f.core, "join", "n")));
+        CHECK(f.core.ReadCounter(AgoraCore::FindCounter("commands.executed")) > 0.0);
+        CHECK(AgoraCore::FindCounter("nope") == -1 && f.core.ReadCounter(-1) == 0.0);
+        const auto& names = AgoraCore::GetCounterNames();
+        CHECK(std::find(names.begin(), names.end(), "reconnect.p99Us") != names.end());
+        f.Run([&]() { f.core.EnableVolumeIndication(0, 3); });
+    }
+
+    uint64_t EngineCalls(const FakeVoiceEngine& fake)
+    {
+        uint64_t total = 0;
+        for (size_t call = 0; call < static_cast<size_t>(FakeCall::Count); ++call) total += fake.GetCallCount(static_cast<FakeCall>(call));
+        return total;
+    }
+
+    void TestApplyAudioStateSkipsWhatMatches()
+    {
+        Fixture f;
+        DesiredAudioState desired;
+        desired.channel = "call-7";
+        desired.muted = false;
+        desired.localAudioEnabled = true;
+        desired.playbackVolume = 900; // clamped to 400 like AdjustPlaybackVolume
+        desired.scenario = 8;
+
+        // No engine: nothing tried
+        AudioStateReport report;
+        f.Run([&]() { report = f.core.ApplyAudioState(desired); });
+        CHECK(!report.ready && report.applied.empty());
+
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Advance(30);
+        f.Run([&]() { report = f.core.ApplyAudioState(desired); });
+        f.Advance(30);
+        CHECK(report.ready && report.pending.empty());
+        CHECK(report.applied.size() == 2 && report.applied[0].step == AudioStep::JoinChannel &&
+              report.applied[1].step == AudioStep::PlaybackVolume && report.applied[1].value == 400);
+        CHECK(report.unchanged == 3); // the engine came up in the meeting scenario, unmuted and enabled
+        CHECK(f.fake->GetPlaybackVolume() == 400 && f.core.GetState().currentChannel == "call-7");
+
+        // The same state again costs no engine call at all
+        uint64_t before = EngineCalls(*f.fake);
+        f.Run([&]() { report = f.core.ApplyAudioState(desired); });
+        CHECK(report.applied.empty() && report.unchanged == 5 && EngineCalls(*f.fake) == before);
+
+        // Move to a radio console, keyed down: the default channel goes, radios come
+        DesiredAudioState console;
+        console.channel = "";
+        console.radios = std::vector<std::string>{ "fire", "ems" };
+        console.talkChannel = "fire";
+        console.muted = true;
+        f.Run([&]() { report = f.core.ApplyAudioState(console); });
+        f.Advance(30);
+        CHECK(report.pending.empty() && !report.applied.empty() && report.applied.front().step == AudioStep::Mute);
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("fire", info) && info.joined && info.publishing && info.muted);
+        CHECK(f.fake->FindConnection("ems", info) && info.joined && !info.publishing);
+        AgoraState state = f.core.GetState();
+        CHECK(state.currentChannel.empty() && state.talkChannel == "fire" && state.isLocalAudioMuted);
+    }
+
+    void TestJoinsKeepTheAppRecordingVolume()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.AdjustRecordingVolume(60); });
+        CHECK(f.fake->GetRecordingVolume() == 60);
+
+        // Every join re-tunes the voice; the app's volume goes back on top
+        DesiredAudioState desired;
+        desired.channel = "ops";
+        desired.recordingVolume = 60;
+        AudioStateReport report;
+        f.Run([&]() { report = f.core.ApplyAudioState(desired); });
+        f.Advance(30);
+        CHECK(report.pending.empty() && report.unchanged == 1);
+        CHECK(f.fake->GetRecordingVolume() == 60);
+
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        CHECK(f.fake->GetRecordingVolume() == 60);
+
+        // What the reconciler compares against is what the engine has
+        desired.recordingVolume = 100;
+        f.Run([&]() { report = f.core.ApplyAudioState(desired); });
+        CHECK(report.applied.size() == 1 && report.applied[0].step == AudioStep::RecordingVolume);
+        CHECK(f.fake->GetRecordingVolume() == 100);
+    }
+
+    void TestTalkChirpsAndCueTones()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        std::vector<int16_t> out(480 * 2), mic(480);
+        auto playbackPeak = [&]() {
+            std::fill(out.begin(), out.end(), static_cast<int16_t>(0));
+            f.fake->ProcessPlayback(out.data(), 480, 2, 48000);
+            return *std::max_element(out.begin(), out.end());
+        };
+        auto capturePeak = [&]() {
+            std::fill(mic.begin(), mic.end(), static_cast<int16_t>(0));
+            f.fake->ProcessCapture(mic.data(), 480, 1, 48000);
+            return *std::max_element(mic.begin(), mic.end());
+        };
+
+        // Off by default: keying makes no sound
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        CHECK(playbackPeak() == 0);
+
+        ToneConfig config;
+        config.talkChirps = true;
+        f.Run([&]() { f.core.ConfigureTones(config); });
+        f.Run([&]() { f.core.MuteLocalAudio(false); });
+        CHECK(playbackPeak() > 1000 && f.core.IsTonePlaying(ToneCue::TalkStart));
+        CHECK(capturePeak() == 0); // the chirp is ours, not the channel's
+        for (int i = 0; i < 10; ++i) playbackPeak();
+        CHECK(!f.core.IsTonePlaying(ToneCue::TalkStart));
+
+        // Only a real change chirps
+        f.Run([&]() { f.core.MuteLocalAudio(false); });
+        CHECK(playbackPeak() == 0);
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        CHECK(f.core.ReadCounter(AgoraCore::FindCounter("tones.started")) == 1.0);
+        CHECK(playbackPeak() > 1000 && f.core.IsTonePlaying(ToneCue::TalkEnd));
+        CHECK(f.core.ReadCounter(AgoraCore::FindCounter("tones.started")) == 2.0);
+
+        // A roger beep on the uplink, and a ring straight from the caller's thread
+        f.core.PlayTone(ToneCue::Roger, true);
+        CHECK(capturePeak() > 1000);
+        f.core.PlayTone(ToneCue::Ring);
+        playbackPeak();
+        CHECK(f.core.IsTonePlaying(ToneCue::Ring));
+        CHECK(f.core.ReadCounter(AgoraCore::FindCounter("tones.maxStartUs")) < 10000.0);
+
+        // Releasing the engine silences it: the next engine's first frame does not ring
+        f.Run([&]() { f.core.ReleaseEngine(); });
+        std::fill(out.begin(), out.end(), static_cast<int16_t>(0));
+        f.core.GetPlaybackPipeline().Process(out.data(), 480, 2, 48000);
+        CHECK(*std::max_element(out.begin(), out.end()) == 0 && !f.core.IsTonePlaying(ToneCue::Ring));
+    }
+
+    void TestStatsAndErrors()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Advance(30);
+
+        ChannelStatsSample stats;
+        stats.txKbps = 24;
+        stats.userCount = 3;
+        f.fake->ReportStats("ops", stats);
+        f.fake->RaiseError("", 110);
+        f.Advance(0);
+
+        CHECK(MetricsContain(f.core, "[\"\",0,24,"));
+        CHECK(f.listener.CountEvents(AgoraEventType::Error, "") == 1);
+    }
+
+    void TestListenOnlyJoinsAsAudience()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops", true); });
+        f.Advance(30);
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("ops", info) && info.joined && info.audience && !info.publishing);
+        CHECK(info.audienceLatency == ConnectionOptions::kAudienceLowLatency);
+        CHECK(f.core.GetState().isListenOnly && f.core.IsLocalAudioMuted());
+        CHECK(!f.fake->IsCapturing() && f.fake->GetPublisherCount() == 0);
+        CHECK(f.fake->PumpAudio(100) == 0);
+
+        // Key up: broadcaster and unmuted in-channel, no rejoin
+        f.Run([&]() { f.core.MuteLocalAudio(false); });
+        CHECK(f.fake->FindConnection("ops", info) && !info.audience && info.publishing && !info.muted);
+        CHECK(f.fake->IsCapturing() && f.fake->PumpAudio(100) == 10);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinChannel) == 1);
+
+        // Key down: muted first, then back to audience
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        CHECK(f.fake->FindConnection("ops", info) && info.audience && info.muted);
+        CHECK(!f.fake->IsCapturing());
+
+        // ListenAndTalk on the same channel: broadcaster, still muted until the app unmutes
+        f.Run([&]() { f.core.SetListenOnly(false); });
+        CHECK(f.fake->FindConnection("ops", info) && !info.audience && info.publishing && info.muted);
+        CHECK(!f.core.GetState().isListenOnly && f.core.IsLocalAudioMuted());
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        CHECK(f.fake->FindConnection("ops", info) && !info.audience); // no role change outside listen-only
+
+        f.Run([&]() { f.core.LeaveChannel(); });
+        CHECK(!f.core.GetState().isListenOnly);
+    }
+
+    void TestIdleRadiosListenAsAudience()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Run([&]() { f.core.JoinRadioChannel("ems", false); });
+        f.Advance(30);
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("fire", info) && !info.audience && info.publishing);
+        CHECK(f.fake->FindConnection("ems", info) && info.audience && !info.publishing);
+        CHECK(f.fake->GetPublisherCount() == 1);
+
+        f.Run([&]() { f.core.SetTalkChannel("ems"); });
+        CHECK(f.fake->FindConnection("fire", info) && info.audience);
+        CHECK(f.fake->FindConnection("ems", info) && !info.audience && info.publishing);
+        f.Run([&]() { f.core.SetTalkChannel(""); });
+        CHECK(f.fake->GetPublisherCount() == 0 && !f.fake->IsCapturing());
+    }
+
+    void TestReplayLastPlaysRadioTraffic()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.SetReplayBuffer("fire", 5); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", false); });
+        f.Run([&]() { f.core.JoinRadioChannel("ems", false); });
+        f.Advance(30);
+
+        // Half a second of uid 42 on fire, delivered in one burst like a catching-up audio thread
+        std::vector<int16_t> frame(480);
+        for (int i = 0; i < 480; ++i) frame[i] = static_cast<int16_t>(i % 48 < 24 ? 6000 : -6000);
+        for (int i = 0; i < 50; ++i) {
+            CHECK(f.fake->ProcessRemote("fire", 42, frame.data(), 480, 1, 48000));
+        }
+        CHECK(f.core.GetReplayIndex("fire", 60).find("[42,") == 1);
+        CHECK(f.core.GetReplayIndex("ems", 60) == "[]");
+
+        f.Run([&]() { f.core.ReplayLast("ems", 10); });
+        CHECK(!f.core.IsReplaying());
+        CHECK(OpField(f.core, "replay", "fail") == 1);
+
+        f.Run([&]() { f.core.ReplayLast("fire", 10, 42); });
+        CHECK(f.core.IsReplaying());
+
+        // The clip comes out of local playback, 48 kHz stereo, for about 500 ms
+        std::vector<int16_t> out(480 * 2);
+        int audible = 0;
+        for (int i = 0; i < 80; ++i) {
+            std::fill(out.begin(), out.end(), static_cast<int16_t>(0));
+            f.fake->ProcessPlayback(out.data(), 480, 2, 48000);
+            if (*std::max_element(out.begin(), out.end()) > 1000) ++audible;
+        }
+        CHECK(audible >= 49 && audible <= 51);
+        CHECK(!f.core.IsReplaying());
+
+        f.Run([&]() { f.core.ReplayLast("fire", 10); });
+        f.Run([&]() { f.core.StopReplay(); });
+        std::fill(out.begin(), out.end(), static_cast<int16_t>(0));
+        f.fake->ProcessPlayback(out.data(), 480, 2, 48000);
+        CHECK(*std::max_element(out.begin(), out.end()) == 0);
+
+        // Leaving the radio frees its ring
+        f.Run([&]() { f.core.LeaveRadioChannel("fire"); });
+        CHECK(f.core.GetReplayIndex("fire", 60) == "[]");
+    }
+
+    void TestRadioMixerPansAndDucks()
+    {
+        Fixture f;
+        AudioPipelineConfig passThrough;
+        passThrough.enabled = false;
+        f.Run([&]() { f.core.ConfigureAudioProcessing(AudioPipelineConfig{}, passThrough); });
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", false); });
+        f.Run([&]() { f.core.JoinRadioChannel("police", false); });
+        f.Advance(30);
+
+        std::vector<int16_t> voice(480);
+        for (int i = 0; i < 480; ++i) voice[i] = static_cast<int16_t>(i % 48 < 24 ? 6000 : -6000);
+        std::vector<int16_t> out(480 * 2);
+        int16_t left = 0, right = 0;
+        auto render = [&](bool police) {
+            f.fake->ProcessRemote("fire", 42, voice.data(), 480, 1, 48000);
+            if (police) f.fake->ProcessRemote("police", 7, voice.data(), 480, 1, 48000);
+            std::fill(out.begin(), out.end(), static_cast<int16_t>(1234)); // the SDK's own mix
+            f.fake->ProcessPlayback(out.data(), 480, 2, 48000);
+            left = out[0];
+            right = out[1];
+        };
+
+        // Off: the SDK's mix plays untouched
+        render(false);
+        CHECK(left == 1234 && right == 1234);
+
+        // Fire hard left, police hard right with priority
+        RadioMixerConfig mixer;
+        mixer.enabled = true;
+        f.Run([&]() { f.core.ConfigureRadioMixer(mixer); });
+        f.Run([&]() { f.core.SetRadioMix("fire", 0.0f, -1.0f, 0); });
+        f.Run([&]() { f.core.SetRadioMix("police", 0.0f, 1.0f, 5); });
+        render(false); // picks the settings up
+        render(false);
+        CHECK(left == 6000 && right == 0);
+
+        // Someone on police: fire ducks 12 dB within the ramp
+        for (int i = 0; i < 3; ++i) render(true);
+        CHECK(std::abs(left - 1507) <= 2 && right == 6000);
+        CHECK(f.core.GetRadioMixer().mixes.size() == 2);
+
+        // Ducking holds over short pauses, then lets go
+        for (int i = 0; i < 10; ++i) render(false);
+        CHECK(std::abs(left - 1507) <= 2 && right == 0);
+        for (int i = 0; i < 30; ++i) render(false);
+        CHECK(left == 6000);
+
+        // One user turned down and centred
+        f.Run([&]() { f.core.SetUserMix("fire", 42, -6.0f, 0.0f); });
+        for (int i = 0; i < 3; ++i) render(false);
+        CHECK(std::abs(left - 3007) <= 2 && std::abs(right - 3007) <= 2);
+        CHECK(f.core.GetStatus().find("Radio Mixer: ON") != std::string::npos);
+    }
+
+    void TestLoudnessLevelsEachSpeaker()
+    {
+        Fixture f;
+        AudioPipelineConfig passThrough;
+        passThrough.enabled = false;
+        f.Run([&]() { f.core.ConfigureAudioProcessing(AudioPipelineConfig{}, passThrough); });
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", false); });
+        f.Advance(30);
+
+        // Two units on fire, one 20 dB quieter than the other
+        std::vector<int16_t> loud(480), quiet(480);
+        for (int i = 0; i < 480; ++i) {
+            double phase = std::sin(2.0 * 3.14159265358979 * 1000.0 * i / 48000.0);
+            loud[i] = static_cast<int16_t>(std::lround(14000.0 * phase));
+            quiet[i] = static_cast<int16_t>(std::lround(1400.0 * phase));
+        }
+        std::vector<int16_t> out(480 * 2);
+        auto render = [&]() {
+            f.fake->ProcessRemote("fire", 1, loud.data(), 480, 1, 48000);
+            f.fake->ProcessRemote("fire", 2, quiet.data(), 480, 1, 48000);
+            f.fake->ProcessPlayback(out.data(), 480, 2, 48000);
+        };
+
+        LoudnessConfig loudness;
+        loudness.enabled = true;
+        f.Run([&]() { f.core.ConfigureLoudness(loudness); });
+        for (int i = 0; i < 20; ++i) render();
+
+        std::vector<LoudnessStats> stats = f.core.GetLoudnessStats();
+        CHECK(stats.size() == 2);
+        float gainLoud = 0.0f, gainQuiet = 0.0f;
+        for (const auto& entry : stats) {
+            CHECK(entry.channelName == "fire" && entry.speaking);
+            (entry.uid == 1 ? gainLoud : gainQuiet) = entry.gainDb;
+        }
+        // Both brought to the target: 20 dB apart in gain, each within the limits
+        CHECK(std::fabs(gainQuiet - gainLoud - 20.0f) < 0.2f && gainLoud < 0.0f && gainQuiet > 0.0f);
+        CHECK(f.core.GetLoudnessConfig().enabled);
+        CHECK(f.core.GetStatus().find("Loudness: ON (2 speakers)") != std::string::npos);
+    }
+
+    void TestLatencyProbeMeasuresTheDeviceLoop()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+
+        // Nothing to send a channel probe over yet
+        LatencyProbeConfig channel;
+        channel.path = ProbePath::Channel;
+        f.Run([&]() { f.core.StartLatencyProbe(channel); });
+        CHECK(!f.core.IsLatencyProbeRunning());
+
+        // Outside a channel the device probe keeps the devices open with the loopback test
+        LatencyProbeConfig config;
+        config.probes = 3;
+        config.windowMs = 400;
+        config.gapMs = 50;
+        f.Run([&]() { f.core.StartLatencyProbe(config); });
+        CHECK(f.core.IsLatencyProbeRunning());
+        CHECK(f.fake->IsEchoTestRunning());
+
+        // Speaker to microphone: 60 ms and a bit through a delay line, a quarter as loud, in real time
+        const size_t delay = 48 * 60 + 17;
+        std::deque<int16_t> air(delay, 0);
+        std::vector<int16_t> speaker(480 * 2), microphone(480);
+        for (int i = 0; i < 500 && f.listener.ProbeReports().empty(); ++i) {
+            std::fill(speaker.begin(), speaker.end(), static_cast<int16_t>(0));
+            f.fake->ProcessPlayback(speaker.data(), 480, 2, 48000);
+            for (int n = 0; n < 480; ++n) air.push_back(static_cast<int16_t>(speaker[n * 2] / 4));
+            for (int n = 0; n < 480; ++n) {
+                microphone[n] = air.front();
+                air.pop_front();
+            }
+            f.fake->ProcessCapture(microphone.data(), 480, 1, 48000);
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        std::vector<LatencyReport> reports = f.listener.ProbeReports();
+        CHECK(reports.size() == 1);
+        if (reports.size() != 1) return;
+        const LatencyReport& report = reports[0];
+        CHECK(!report.cancelled);
+        CHECK(report.probes == 3 && report.found == 3);
+        CHECK(std::fabs(report.p50Ms - 60.354) < 1.0);
+        CHECK(report.jitterMs < 0.5);
+        CHECK(report.audioScenario == AgoraCore::kScenarioMeeting);
+        CHECK(report.noiseSuppressionMode == AgoraCore::kNoiseSuppressionAggressive);
+        CHECK(OpField(f.core, "probeDevice", "n") == 3);
+        CHECK(!f.core.IsLatencyProbeRunning());
+        CHECK(!f.fake->IsEchoTestRunning());
+
+        // Stopping a run reports what it had, cancelled
+        f.Run([&]() { f.core.StartLatencyProbe(config); });
+        f.Run([&]() { f.core.StopLatencyProbe(); });
+        reports = f.listener.ProbeReports();
+        CHECK(reports.size() == 2 && reports.back().cancelled && reports.back().probes == 0);
+        CHECK(!f.fake->IsEchoTestRunning());
+    }
+
+    void TestExternalAudioSwitchesOutsideChannels()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Advance(50);
+
+        // A joined connection keeps the source it was joined with
+        f.Run([&]() { f.core.SetExternalAudio(true); });
+        CHECK(!f.core.GetState().isExternalAudio);
+        CHECK(!f.fake->IsExternalAudio());
+
+        f.Run([&]() { f.core.LeaveChannel(); });
+        f.Advance(50);
+        ExternalAudioConfig config;
+        config.captureChannels = 2;
+        f.Run([&]() { f.core.SetExternalAudio(true, config); });
+        CHECK(f.core.GetState().isExternalAudio);
+        CHECK(f.fake->IsExternalAudio());
+        CHECK(f.core.GetExternalAudio().IsRunning());
+        CHECK(!f.fake->HasAudioProcessors()); // the pump runs the pipelines, not the frame hook
+
+        // The paced pump pushes and pulls every 10 ms whether or not the devices keep up
+        CHECK(WaitFor([&]() { return f.fake->GetPushedFrames() >= 5 && f.fake->GetPulledFrames() >= 5; }));
+        CHECK(f.core.GetCapturePipeline().GetProcessedFrames() >= 5);
+        CHECK(f.core.GetExternalAudio().GetStats().captureUnderruns >= 5);
+
+        f.Run([&]() { f.core.SetExternalAudio(false); });
+        CHECK(!f.core.GetState().isExternalAudio);
+        CHECK(!f.fake->IsExternalAudio());
+        CHECK(!f.core.GetExternalAudio().IsRunning());
+        CHECK(f.fake->HasAudioProcessors());
+
+        // Released with the engine
+        f.Run([&]() { f.core.SetExternalAudio(true); });
+        CHECK(f.core.GetExternalAudio().IsRunning());
+        f.Run([&]() { f.core.ReleaseEngine(); });
+        CHECK(!f.core.GetExternalAudio().IsRunning());
+        CHECK(!f.core.GetState().isExternalAudio);
+    }
+
+    void TestAudioDevicesHotSwapInSession()
+    {
+        Fixture f;
+        const std::string builtIn = "{0.0.1.00000000}.{realtek-microphone}";
+        const AudioDeviceInfo headset{ "{0.0.1.00000000}.{usb-jabra}", "Headset Microphone (Jabra Evolve2 65)" };
+
+        // A policy set before the engine exists waits for it
+        f.Run([&]() { f.core.SetPreferredDevices(AudioDeviceKind::Recording, { "jabra", "" }); });
+        CHECK(f.core.GetAudioDevices(AudioDeviceKind::Recording).preferred == std::vector<std::string>{ "jabra" });
+
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Advance(50);
+        CHECK(f.fake->GetEnumerationCount() == 2);
+        AudioDeviceList recording = f.core.GetAudioDevices(AudioDeviceKind::Recording);
+        CHECK(recording.devices.size() == 1 && recording.activeId == builtIn);
+        CHECK(f.core.GetAudioDevices(AudioDeviceKind::Playback).devices.size() == 1);
+        CHECK(OpField(f.core, "deviceSwitch", "n") <= 0);
+
+        // Plugged in mid-call: only that kind is listed again, and the preferred headset takes over
+        f.fake->PlugAudioDevice(AudioDeviceKind::Recording, headset, 5);
+        f.Advance(10);
+        CHECK(f.fake->GetEnumerationCount() == 3);
+        CHECK(f.fake->GetActiveAudioDevice(AudioDeviceKind::Recording) == headset.id);
+        recording = f.core.GetAudioDevices(AudioDeviceKind::Recording);
+        CHECK(recording.devices.size() == 2 && recording.activeId == headset.id);
+        CHECK(OpField(f.core, "deviceSwitch", "n") == 1);
+        std::vector<AudioDeviceList> lists = f.listener.DeviceLists();
+        CHECK(!lists.empty() && lists.back().kind == AudioDeviceKind::Recording && lists.back().activeId == headset.id);
+
+        // No restart: the same engine and channel carried on
+        CHECK(f.fake->GetCallCount(FakeCall::Initialize) == 1);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinChannel) == 1);
+        CHECK(f.core.GetState().currentChannel == "ops");
+
+        // Unplugged: dropped from the cache without listing again, back on the system default
+        f.fake->UnplugAudioDevice(AudioDeviceKind::Recording, headset.id, 5);
+        f.Advance(10);
+        CHECK(f.fake->GetEnumerationCount() == 3);
+        recording = f.core.GetAudioDevices(AudioDeviceKind::Recording);
+        CHECK(recording.devices.size() == 1 && recording.activeId == builtIn);
+
+        // Dropping the preference hands a pinned device back to the system default
+        f.fake->PlugAudioDevice(AudioDeviceKind::Recording, headset);
+        f.Advance(10);
+        CHECK(f.core.GetAudioDevices(AudioDeviceKind::Recording).activeId == headset.id);
+        f.Run([&]() { f.core.SetPreferredDevices(AudioDeviceKind::Recording, {}); });
+        CHECK(f.fake->GetActiveAudioDevice(AudioDeviceKind::Recording) == builtIn);
+        CHECK(f.core.GetAudioDevices(AudioDeviceKind::Recording).activeId == builtIn);
+        CHECK(OpField(f.core, "deviceSwitch", "n") == 3);
+
+        // A preference naming a present device by id switches right away
+        f.Run([&]() { f.core.SetPreferredDevices(AudioDeviceKind::Recording, { headset.id }); });
+        CHECK(f.fake->GetActiveAudioDevice(AudioDeviceKind::Recording) == headset.id);
+
+        f.Run([&]() { f.core.ReleaseEngine(); });
+        recording = f.core.GetAudioDevices(AudioDeviceKind::Recording);
+        CHECK(recording.devices.empty() && recording.activeId.empty());
+        CHECK(recording.preferred == std::vector<std::string>{ headset.id });
+    }
+
+    void TestLinkProfileChosenBeforeJoin()
+    {
+        Fixture f;
+        LastmileProbeResult lossy;
+        lossy.state = LastmileProbeResult::kComplete;
+        lossy.uplink = { 14, 40, 300 };
+        lossy.downlink = { 2, 10, 800 };
+        lossy.rttMs = 180;
+
+        // Known before the engine: the probe starts with it
+        f.Run([&]() { f.core.SetNetworkIdentity("wifi:office|{adapter-1}"); });
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        CHECK(f.fake->IsLastmileProbing());
+        CHECK(f.core.GetState().isLastmileProbing);
+        CHECK(f.core.GetLinkProfile().networkId == "wifi:office|{adapter-1}");
+
+        f.fake->SetLastmileLink(lossy);
+        f.Advance(30000);
+        LinkDecision decision = f.core.GetLinkProfile();
+        CHECK(decision.profile.tier == LinkTier::Poor && !decision.fromCache);
+        CHECK(decision.measured.uplink.packetLossRate == 14);
+        CHECK(!f.core.GetState().isLastmileProbing);
+        CHECK(f.fake->GetAudioProfile() == AudioLinkProfile::kProfileSpeechStandard);
+        CHECK(f.fake->GetParameters().find("\"che.audio.enable.fec\":true") != std::string::npos);
+        CHECK(OpField(f.core, "lastmileProbe", "n") == 1);
+
+        // Same network on a new engine: the cached profile goes in, no second probe
+        f.Run([&]() { f.core.ReleaseEngine(); });
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        CHECK(f.fake->GetLastmileProbeCount() == 0);
+        CHECK(f.core.GetLinkProfile().fromCache && f.core.GetLinkProfile().profile.tier == LinkTier::Poor);
+        CHECK(f.fake->GetAudioProfile() == AudioLinkProfile::kProfileSpeechStandard);
+
+        // A new network starts on defaults and is measured
+        f.Run([&]() { f.core.SetNetworkIdentity("wifi:cafe|{adapter-1}"); });
+        CHECK(f.fake->GetLastmileProbeCount() == 1);
+        CHECK(f.core.GetLinkProfile().profile.tier == LinkTier::Unknown);
+        CHECK(f.fake->GetAudioProfile() == AudioLinkProfile::kProfileDefault);
+
+        // Joining doesn't wait for it: the probe stops and its result never lands
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        CHECK(!f.fake->IsLastmileProbing());
+        CHECK(!f.core.GetState().isLastmileProbing);
+        f.Advance(30000);
+        CHECK(f.core.GetState().currentChannel == "ops");
+        CHECK(f.core.GetLinkProfile().profile.tier == LinkTier::Unknown);
+        CHECK(OpField(f.core, "lastmileProbe", "n") == 1);
+
+        // Back on a cached network mid-call: no probe, and the call keeps its settings until the next join
+        f.Run([&]() { f.core.SetNetworkIdentity("wifi:office|{adapter-1}"); });
+        CHECK(f.fake->GetLastmileProbeCount() == 1);
+        CHECK(f.core.GetLinkProfile().profile.tier == LinkTier::Poor);
+        CHECK(f.fake->GetAudioProfile() == AudioLinkProfile::kProfileDefault);
+        f.Run([&]() { f.core.LeaveChannel(); });
+        f.Advance(50);
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        CHECK(f.fake->GetAudioProfile() == AudioLinkProfile::kProfileSpeechStandard);
+        CHECK(f.fake->GetLastmileProbeCount() == 1);
+    }
+
+    void TestSdkRejoinRestoresSessionState()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinChannel("ops", true); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Advance(30);
+        f.Run([&]() { f.core.AdjustRecordingVolume(60); });
+
+        // Keyed up on ops when both links drop
+        f.Run([&]() { f.core.MuteLocalAudio(false); });
+        f.fake->DropConnection("ops");
+        f.fake->DropConnection("fire");
+        f.Advance(0);
+        CHECK(f.listener.Links("ops").back().state == ConnectionState::Reconnecting);
+
+        // The SDK rejoins on its own, back to join-time options: audience and unmuted
+        f.fake->RestoreConnection("ops", 400);
+        f.fake->RestoreConnection("fire", 400);
+        f.Advance(400);
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(f.fake->FindConnection("ops", info) && info.joined && !info.audience && info.publishing && !info.muted);
+        CHECK(f.fake->GetRecordingVolume() == 60);
+        auto links = f.listener.Links("ops");
+        CHECK(links.size() == 3 && links.back().state == ConnectionState::Connected && links.back().restore); // joined, dropped, back
+
+        // Dropped again while keyed down: comes back muted and as audience
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+        f.fake->DropConnection("ops");
+        f.fake->RestoreConnection("ops", 100);
+        f.Advance(100);
+        CHECK(f.fake->FindConnection("ops", info) && info.audience && info.muted);
+
+        // The talk radio keeps the app's mute too
+        CHECK(f.fake->FindConnection("fire", info) && info.joined && info.publishing && info.muted);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinChannel) == 1);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinConnection) == 1);
+        CHECK(OpField(f.core, "reconnect", "n") == 3);
+    }
+
+    void TestFailedRadioRejoinsWithBackoff()
+    {
+        Fixture f;
+        ReconnectPolicy policy;
+        policy.baseDelayMs = 10;
+        policy.maxDelayMs = 40;
+        policy.jitter = 0.0;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.SetReconnectPolicy(policy); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Run([&]() { f.core.JoinRadioChannel("ems", false); });
+        f.Advance(30);
+        f.Run([&]() { f.core.MuteLocalAudio(true); });
+
+        // The SDK gives up on fire and the network stays down for the first rejoins
+        f.fake->SetNetworkDown(true);
+        f.fake->FailConnection("fire", ConnectionMonitor::kReasonInterrupted);
+        f.Advance(0);
+        CHECK(WaitFor([&]() {
+            f.Advance(30);
+            return f.listener.Links("fire").size() >= 4; // connected, then retries 1-3 announced
+        }));
+        f.fake->SetNetworkDown(false);
+
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(WaitFor([&]() {
+            f.Advance(30);
+            return f.fake->FindConnection("fire", info) && info.joined;
+        }));
+        f.Advance(0);
+
+        auto links = f.listener.Links("fire");
+        CHECK(links.size() >= 5);
+        for (size_t i = 1; i + 1 < links.size(); ++i) {
+            CHECK(links[i].state == ConnectionState::Reconnecting && links[i].retry);
+            CHECK(links[i].attempt == static_cast<int>(i));
+            CHECK(links[i].retryDelayMs == std::min(40, 10 << (i - 1)));
+        }
+        CHECK(links.back().state == ConnectionState::Connected && links.back().restore);
+
+        // Rejoined as the talk radio, still muted; ems was never touched
+        CHECK(f.fake->FindConnection("fire", info) && info.publishing && !info.audience && info.muted);
+        CHECK(f.fake->FindConnection("ems", info) && info.joined && info.audience);
+        CHECK(f.listener.Links("ems").size() == 1); // just the join
+        CHECK(f.core.GetState().talkChannel == "fire");
+        CHECK(OpField(f.core, "reconnect", "n") == 1);
+    }
+
+    void TestFatalFailureAndLeaveStopRecovery()
+    {
+        Fixture f;
+        ReconnectPolicy policy;
+        policy.baseDelayMs = 20;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.SetReconnectPolicy(policy); });
+        f.Run([&]() { f.core.JoinChannel("ops"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", false); });
+        f.Advance(30);
+
+        // Bad token: nothing a retry can fix
+        f.fake->FailConnection("ops", 8);
+        f.Advance(0);
+        auto links = f.listener.Links("ops");
+        CHECK(!links.empty() && links.back().state == ConnectionState::Failed && !links.back().retry);
+        CHECK(OpField(f.core, "reconnect", "fail") == 1);
+
+        // Radio left while its retry is queued: the timer finds nothing to do
+        f.fake->FailConnection("fire", ConnectionMonitor::kReasonInterrupted);
+        f.Advance(0);
+        CHECK(f.listener.Links("fire").back().retry);
+        f.Run([&]() { f.core.LeaveRadioChannel("fire"); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        f.Advance(30);
+
+        CHECK(f.fake->GetCallCount(FakeCall::JoinChannel) == 1);
+        CHECK(f.fake->GetCallCount(FakeCall::JoinConnection) == 1);
+        CHECK(f.core.GetRadioChannels().empty());
+    }
+
+    void TestReinitializeWithNewAppIdStartsClean()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        f.Advance(30);
+        f.Run([&]() { f.core.EnableVolumeIndication(100, 3); });
+        f.fake->ReportVolumes("fire", { { 5, 200 } });
+        f.fake->AdvanceBy(0);
+        VolumeChange levels[4];
+        CHECK(f.core.ReadLevels("fire", levels, 4) == 1);
+
+        // VOX closes the gate on the old engine
+        f.Run([&]() { f.core.SetVoxMode(true); });
+        std::vector<int16_t> silence(480, 0);
+        for (int frame = 0; frame < 100; ++frame) f.fake->ProcessCapture(silence.data(), 480, 1, 48000);
+        f.Advance(0);
+        CHECK(!f.core.IsVoxGateOpen());
+
+        // Another app id: a new engine, and none of the old one's levels carry over
+        f.Run([&]() { f.core.InitializeEngine("other"); });
+        CHECK(f.fake->IsInitialized() && f.fake->GetConnectionNames().empty());
+        CHECK(f.fake->GetCallCount(FakeCall::Initialize) == 1);
+        CHECK(f.core.GetState().appId == "other");
+        CHECK(f.core.GetState().radioChannels.empty());
+        CHECK(f.core.ReadLevels("fire", levels, 4) == 0);
+
+        // VOX is still on and the gate still closed: the new engine's uplink is closed too
+        CHECK(!f.core.IsVoxGateOpen() && f.fake->IsLocalAudioMuted());
+        auto talkStates = f.listener.TalkStates();
+        CHECK(talkStates.size() >= 2 && !talkStates.back().talking);
+
+        // The default channel keeps its volume slot; radios get theirs on the new engine
+        f.Run([&]() { f.core.JoinRadioChannel("ems", true); });
+        f.Advance(30);
+        FakeVoiceEngine::ConnectionInfo ems;
+        CHECK(f.fake->FindConnection("ems", ems) && ems.publishing);
+        CHECK(ems.volumeIntervalMs == 100);
+        f.fake->ReportVolumes("ems", { { 9, 120 } });
+        f.fake->AdvanceBy(0);
+        CHECK(f.core.ReadLevels("ems", levels, 4) == 1 && levels[0].uid == 9);
+
+        f.Run([&]() { f.core.SetVoxMode(false); });
+        f.Run([&]() { f.core.EnableVolumeIndication(0, 3); });
+    }
+
+    void TestReleaseDropsPendingCallbacks()
+    {
+        Fixture f;
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        f.Run([&]() { f.core.JoinRadioChannel("fire", true); });
+        CHECK(f.fake->GetPendingCallbackCount() == 1);
+        f.Run([&]() { f.core.ReleaseEngine(); });
+
+        // The core destroyed the engine; a re-init builds a fresh one
+        f.Run([&]() { f.core.InitializeEngine("app"); });
+        CHECK(f.fake != nullptr);
+        // Nothing of the old engine's; only the new one's background last-mile probe
+        CHECK(f.fake->IsLastmileProbing());
+        CHECK(f.fake->GetPendingCallbackCount() == 1);
+        CHECK(f.core.GetState().radioChannels.empty());
+    }
+}
+
+int main()
+{
+    TestInitializeConfiguresEngine();
+    TestInitializeFailure();
+    TestJoinDeliversEventAndMetrics();
+    TestJoinFailureIsCounted();
+    TestLeaveBeforeJoinCompletesDropsCallback();
+    TestMuteAndRandomFaults();
+    TestRadiosTalkSwitchAndVox();
+    TestWarmAccept();
+    TestAcceptBeforePreparedJoinCompletes();
+    TestVolumeLevelsReachListener();
+    TestHotReadsFromNativeMemory();
+    TestApplyAudioStateSkipsWhatMatches();
+    TestJoinsKeepTheAppRecordingVolume();
+    TestTalkChirpsAndCueTones();
+    TestStatsAndErrors();
+    TestListenOnlyJoinsAsAudience();
+    TestIdleRadiosListenAsAudience();
+    TestReplayLastPlaysRadioTraffic();
+    TestRadioMixerPansAndDucks();
+    TestLoudnessLevelsEachSpeaker();
+    TestLatencyProbeMeasuresTheDeviceLoop();
+    TestExternalAudioSwitchesOutsideChannels();
+    TestAudioDevicesHotSwapInSession();
+    TestLinkProfileChosenBeforeJoin();
+    TestSdkRejoinRestoresSessionState();
+    TestFailedRadioRejoinsWithBackoff();
+    TestFatalFailureAndLeaveStopRecovery();
+    TestReleaseDropsPendingCallbacks();
+    TestReinitializeWithNewAppIdStartsClean();
+
+    if (g_failures == 0) {
+        std::printf("All AgoraCore tests passed\n");
+        return 0;
+    }
+    std::printf("%d check(s) failed\n", g_failures);
+    return 1;
+}
@@ -0,0 +1,216 @@
+// Multithreaded stress test for the snapshot state - no Agora SDK or WinRT required.
+// Readers hammer the snapshot while a writer drives radio joins/leaves on a fake engine,
+// the same way the JS thread reads status while the command worker changes it.
+#include "../AgoraState.h"
+#include "../MultiChannelSession.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <future>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    std::atomic<int> g_failures{ 0 };
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // Accepts every call, nothing else to fake for this test
+    class FakeConnectionEngine : public IConnectionEngine
+    {
+    public:
+        int JoinConnection(const std::string&, bool) override { return 0; }
+        int UpdateConnection(const std::string&, bool) override { return 0; }
+        int LeaveConnection(const std::string&) override { return 0; }
+    };
+
+    // Writer-side invariants every published snapshot must satisfy
+    bool IsConsistent(const AgoraState& state)
+    {
+        if (!state.talkChannel.empty() &&
+            std::find(state.radioChannels.begin(), state.radioChannels.end(), state.talkChannel) == state.radioChannels.end()) {
+            return false;
+        }
+        if (state.isInitialized && state.currentChannel.rfind("channel_", 0) != 0) return false;
+        return state.radioChannels.size() <= MultiChannelSession::kMaxConnections;
+    }
+
+    void TestReadersSeeConsistentSnapshots()
+    {
+        constexpr int kReaders = 6;
+        constexpr int kWrites = 20000;
+
+        SnapshotCell<AgoraState> cell;
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+        std::atomic<bool> done{ false };
+        std::atomic<uint64_t> reads{ 0 };
+        size_t leastRetired = SIZE_MAX;
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < kReaders; ++r) {
+            readers.emplace_back([&]() {
+                uint64_t lastVersion = 0;
+                while (!done.load()) {
+                    cell.Read([&](const AgoraState& state) {
+                        CHECK(state.version >= lastVersion); // never goes back in time
+                        CHECK(IsConsistent(state));
+                        // Torn write check: both fields are set from the same counter
+                        CHECK(state.isLocalAudioMuted == (state.appId == "muted"));
+                        lastVersion = state.version;
+                    });
+                    ++reads;
+                }
+            });
+        }
+
+        for (int i = 0; i < kWrites; ++i) {
+            std::string radio = "radio_channel_" + std::to_string(i % 12);
+            if (session.IsJoined(radio)) {
+                session.Leave(radio);
+            } else {
+                session.Join(radio, i % 3 == 0);
+            }
+
+            auto radioChannels = session.GetChannels();
+            auto talkChannel = session.GetTalkChannel();
+            bool muted = i % 2 == 0;
+            cell.Update([&](AgoraState& state) {
+                state.isInitialized = true;
+                state.radioChannels = std::move(radioChannels);
+                state.talkChannel = std::move(talkChannel);
+                state.isLocalAudioMuted = muted;
+                state.appId = muted ? "muted" : "live";
+                state.currentChannel = "channel_" + std::to_string(i % 2);
+            });
+            if (i >= kWrites / 2) leastRetired = std::min(leastRetired, cell.GetRetiredCount());
+        }
+
+        // Reads overlapped nearly every write, yet old snapshots kept being freed as readers moved
+        // on. A reader descheduled mid-read holds newer generations back for a while, so the
+        // count rises and falls; it must not keep climbing with every write.
+        CHECK(cell.GetRetiredCount() - leastRetired < static_cast<size_t>(kWrites) / 4);
+        done.store(true);
+        for (auto& reader : readers) reader.join();
+
+        AgoraState last = cell.Load();
+        CHECK(last.version == static_cast<uint64_t>(kWrites));
+        cell.Update([](AgoraState&) {});
+        CHECK(cell.GetRetiredCount() == 0);
+        CHECK(last.radioChannels == session.GetChannels());
+        CHECK(last.talkChannel == session.GetTalkChannel());
+        CHECK(reads.load() > 0);
+    }
+
+    void TestConcurrentWritersSerialize()
+    {
+        constexpr int kWriters = 4;
+        constexpr int kWritesEach = 5000;
+
+        SnapshotCell<AgoraState> cell;
+        std::vector<std::thread> writers;
+        for (int w = 0; w < kWriters; ++w) {
+            writers.emplace_back([&cell, w]() {
+                for (int i = 0; i < kWritesEach; ++i) {
+                    cell.Update([w](AgoraState& state) {
+                        state.radioChannels.push_back("radio_channel_" + std::to_string(w));
+                        if (state.radioChannels.size() > 4) state.radioChannels.erase(state.radioChannels.begin());
+                    });
+                    // Mixed-in readers keep the grace period busy
+                    cell.Read([](const AgoraState& state) { return state.radioChannels.size(); });
+                }
+            });
+        }
+        for (auto& writer : writers) writer.join();
+
+        CHECK(cell.Load().version == static_cast<uint64_t>(kWriters * kWritesEach));
+        CHECK(cell.Load().radioChannels.size() == 4);
+    }
+
+    void TestRetiredSnapshotsAreReclaimed()
+    {
+        SnapshotCell<AgoraState> cell;
+        for (int i = 0; i < 100; ++i) {
+            cell.Update([](AgoraState& state) { state.isEchoTestRunning = !state.isEchoTestRunning; });
+        }
+        // No reader was active, so every old snapshot was freed right away
+        CHECK(cell.GetRetiredCount() == 0);
+        CHECK(!cell.Load().isEchoTestRunning);
+    }
+
+    // Parks a thread inside Read() until Release()
+    class HeldRead
+    {
+    public:
+        explicit HeldRead(SnapshotCell<AgoraState>& cell)
+        {
+            std::shared_future<void> release = m_release.get_future().share();
+            m_thread = std::thread([this, &cell, release]() {
+                cell.Read([&](const AgoraState&) {
+                    m_entered.set_value();
+                    release.wait();
+                });
+            });
+            m_entered.get_future().wait();
+        }
+
+        void Release()
+        {
+            m_release.set_value();
+            m_thread.join();
+        }
+
+    private:
+        std::promise<void> m_entered;
+        std::promise<void> m_release;
+        std::thread m_thread;
+    };
+
+    void TestOverlappingReadsDoNotPinRetired()
+    {
+        constexpr int kWrites = 200;
+
+        // A reader is inside Read() at every write, but each one spans a single write:
+        // there is never a moment without readers, yet every generation gets released
+        SnapshotCell<AgoraState> cell;
+        auto held = std::make_unique<HeldRead>(cell);
+        size_t mostRetired = 0;
+        for (int i = 0; i < kWrites; ++i) {
+            cell.Update([i](AgoraState& state) { state.appId = std::to_string(i); });
+            auto next = std::make_unique<HeldRead>(cell);
+            held->Release();
+            held = std::move(next);
+            mostRetired = std::max(mostRetired, cell.GetRetiredCount());
+        }
+        CHECK(mostRetired <= 2);
+        held->Release();
+
+        // Once the last reader is out, the next write frees the rest
+        cell.Update([](AgoraState&) {});
+        CHECK(cell.GetRetiredCount() == 0);
+        CHECK(cell.Load().appId == std::to_string(kWrites - 1));
+    }
+}
+
+int main()
+{
+    TestReadersSeeConsistentSnapshots();
+    TestConcurrentWritersSerialize();
+    TestRetiredSnapshotsAreReclaimed();
+    TestOverlappingReadsDoNotPinRetired();
+
+    if (g_failures == 0) std::printf("AgoraStateStressTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
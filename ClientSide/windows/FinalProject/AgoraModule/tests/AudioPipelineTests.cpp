@@ -0,0 +1,287 @@
+// Headless tests for the PCM kernels and AudioPipeline - no Agora SDK or WinRT required.
+// Every SIMD kernel is checked against the scalar reference on the same input.
+#include "../AudioDsp.h"
+#include "../AudioPipeline.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kSampleRate = 48000;
+    constexpr int kFrame = 480; // 10 ms
+
+    std::vector<int16_t> RandomSamples(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> value(-32768, 32767);
+        std::vector<int16_t> samples(count);
+        for (auto& sample : samples) sample = static_cast<int16_t>(value(random));
+        // Edge values, including the one that has no positive twin
+        if (count > 3) {
+            samples[0] = -32768;
+            samples[1] = 32767;
+            samples[2] = 0;
+        }
+        return samples;
+    }
+
+    std::vector<int16_t> Sine(int frames, int channels, float hz, float amplitude, float offset = 0.0f)
+    {
+        std::vector<int16_t> samples(static_cast<size_t>(frames) * channels);
+        for (int i = 0; i < frames; ++i) {
+            float value = offset + amplitude * std::sin(2.0f * 3.14159265f * hz * i / kSampleRate);
+            for (int c = 0; c < channels; ++c) samples[static_cast<size_t>(i) * channels + c] = static_cast<int16_t>(value);
+        }
+        return samples;
+    }
+
+    double Rms(const int16_t* samples, size_t count)
+    {
+        double sum = 0.0;
+        for (size_t i = 0; i < count; ++i) sum += static_cast<double>(samples[i]) * samples[i];
+        return std::sqrt(sum / count);
+    }
+
+    void TestKernelsMatchScalar()
+    {
+        const DspKernels& scalar = GetDspKernels(DspIsa::Scalar);
+        for (DspIsa isa : { DspIsa::Sse2, DspIsa::Avx2 }) {
+            const DspKernels& simd = GetDspKernels(isa);
+            // Odd lengths exercise the scalar tails
+            for (size_t count : { size_t(1), size_t(7), size_t(15), size_t(480), size_t(961) }) {
+                for (int32_t gain : { 0, 1024, 3251, 4096, 8192, 32767 }) {
+                    auto expected = RandomSamples(count, static_cast<uint32_t>(count + gain));
+                    auto actual = expected;
+                    scalar.applyGain(expected.data(), count, gain);
+                    simd.applyGain(actual.data(), count, gain);
+                    CHECK(expected == actual);
+                }
+
+                auto samples = RandomSamples(count, static_cast<uint32_t>(count));
+                CHECK(scalar.peakAbs(samples.data(), count) == simd.peakAbs(samples.data(), count));
+
+                float reference = scalar.sumSquares(samples.data(), count);
+                float measured = simd.sumSquares(samples.data(), count);
+                CHECK(std::fabs(reference - measured) <= reference * 1e-5f + 1.0f);
+
+                // Mix bus: a ramp up, a ramp down and a constant gain stacked on one bus,
+                // then stored past full scale both ways
+                std::vector<float> busExpected(count, 0.0f), busActual(count, 0.0f);
+                for (float step : { 0.0009f, -0.0004f, 0.0f }) {
+                    scalar.mixRamp(busExpected.data(), samples.data(), count, 0.7f, step);
+                    simd.mixRamp(busActual.data(), samples.data(), count, 0.7f, step);
+                }
+                CHECK(busExpected == busActual);
+                for (size_t i = 0; i < count; i += 3) busExpected[i] *= 3.0f;
+                std::vector<float> right(busExpected.rbegin(), busExpected.rend());
+                std::vector<int16_t> monoExpected(count), monoActual(count);
+                scalar.storeMix(monoExpected.data(), busExpected.data(), nullptr, count);
+                simd.storeMix(monoActual.data(), busExpected.data(), nullptr, count);
+                CHECK(monoExpected == monoActual);
+                std::vector<int16_t> stereoExpected(count * 2), stereoActual(count * 2);
+                scalar.storeMix(stereoExpected.data(), busExpected.data(), right.data(), count);
+                simd.storeMix(stereoActual.data(), busExpected.data(), right.data(), count);
+                CHECK(stereoExpected == stereoActual);
+            }
+        }
+
+        std::vector<int16_t> minimum(64, -32768);
+        CHECK(GetDspKernels().peakAbs(minimum.data(), minimum.size()) == 32767);
+
+        float loud[3] = { 40000.0f, -40000.0f, 2.5f };
+        int16_t stored[3];
+        GetDspKernels().storeMix(stored, loud, nullptr, 3);
+        CHECK(stored[0] == 32767 && stored[1] == -32768 && stored[2] == 2); // round half to even
+    }
+
+    void TestHighPassRemovesRumble()
+    {
+        AudioPipeline pipeline;
+        AudioPipelineConfig config;
+        config.gainDb = 0.0f;
+        config.limiterEnabled = false;
+        pipeline.SetConfig(config);
+
+        // 50 Hz hum plus DC offset: mostly gone after settling
+        auto hum = Sine(kFrame * 50, 1, 50.0f, 8000.0f, 2000.0f);
+        for (int i = 0; i < 50; ++i) pipeline.Process(hum.data() + i * kFrame, kFrame, 1, kSampleRate);
+        CHECK(Rms(hum.data() + 40 * kFrame, kFrame * 10) < 8000.0 / std::sqrt(2.0) * 0.2);
+
+        // 1 kHz voice band passes nearly unchanged
+        AudioPipeline voicePipeline;
+        voicePipeline.SetConfig(config);
+        auto tone = Sine(kFrame * 20, 2, 1000.0f, 8000.0f);
+        double before = Rms(tone.data() + 10 * kFrame * 2, kFrame * 2 * 10);
+        for (int i = 0; i < 20; ++i) voicePipeline.Process(tone.data() + i * kFrame * 2, kFrame, 2, kSampleRate);
+        double after = Rms(tone.data() + 10 * kFrame * 2, kFrame * 2 * 10);
+        CHECK(std::fabs(after - before) < before * 0.05);
+    }
+
+    void TestLimiterCapsPeaks()
+    {
+        AudioPipeline pipeline;
+        AudioPipelineConfig config;
+        config.gainDb = 12.0f; // drive it hard
+        config.highPassEnabled = false;
+        config.limiterThresholdDb = -6.0f;
+        pipeline.SetConfig(config);
+
+        auto tone = Sine(kFrame * 10, 1, 440.0f, 12000.0f);
+        for (int i = 0; i < 10; ++i) pipeline.Process(tone.data() + i * kFrame, kFrame, 1, kSampleRate);
+
+        // Gain saturates some samples before the limiter, but the limiter output stays under -6 dBFS
+        int32_t limit = static_cast<int32_t>(32767.0f * std::pow(10.0f, -6.0f / 20.0f));
+        CHECK(GetDspKernels().peakAbs(tone.data(), tone.size()) <= limit + 1);
+    }
+
+    void TestVoxGate()
+    {
+        AudioPipeline pipeline;
+        AudioPipelineConfig config;
+        config.gainDb = 0.0f;
+        config.highPassEnabled = false;
+        config.limiterEnabled = false;
+        config.voxEnabled = true;
+        config.voxThresholdDb = -40.0f;
+        config.voxHangoverMs = 100;
+        pipeline.SetConfig(config);
+
+        // Opens on the third 10 ms frame of speech (30 ms attack); earlier frames are muted
+        for (int i = 0; i < 3; ++i) {
+            auto speech = Sine(kFrame, 1, 300.0f, 6000.0f);
+            CHECK(pipeline.Process(speech.data(), kFrame, 1, kSampleRate));
+            CHECK(pipeline.IsGateOpen() == (i == 2));
+            CHECK((Rms(speech.data(), kFrame) > 1000.0) == (i == 2));
+        }
+
+        // Low hiss: still open during the 100 ms hangover, closed (and zeroed) after it
+        std::vector<int16_t> hiss(kFrame);
+        int openFrames = 0;
+        for (int i = 0; i < 20; ++i) {
+            for (int n = 0; n < kFrame; ++n) hiss[n] = static_cast<int16_t>((n % 7) - 3);
+            pipeline.Process(hiss.data(), kFrame, 1, kSampleRate);
+            if (pipeline.IsGateOpen()) ++openFrames;
+        }
+        CHECK(openFrames >= 9 && openFrames <= 11);
+        CHECK(!pipeline.IsGateOpen());
+        CHECK(Rms(hiss.data(), kFrame) == 0.0);
+    }
+
+    void TestDisabledAndUnsupportedFramesPassThrough()
+    {
+        AudioPipeline pipeline;
+        AudioPipelineConfig config;
+        config.enabled = false;
+        pipeline.SetConfig(config);
+
+        auto original = Sine(kFrame, 1, 440.0f, 30000.0f);
+        auto frame = original;
+        CHECK(!pipeline.Process(frame.data(), kFrame, 1, kSampleRate));
+        CHECK(frame == original);
+
+        config.enabled = true;
+        pipeline.SetConfig(config);
+        std::vector<int16_t> surround(kFrame * 6, 1000);
+        CHECK(!pipeline.Process(surround.data(), kFrame, 6, kSampleRate));
+        CHECK(pipeline.Process(frame.data(), kFrame, 1, kSampleRate));
+        CHECK(pipeline.GetProcessedFrames() == 1);
+    }
+
+    bool AddConstant(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        (void)sampleRate;
+        int16_t value = *static_cast<int16_t*>(context);
+        for (int i = 0; i < framesPerChannel * channels; ++i) samples[i] = static_cast<int16_t>(samples[i] + value);
+        return value != 0;
+    }
+
+    void TestMixSources()
+    {
+        AudioPipeline pipeline;
+        int16_t first = 100, second = 20, silent = 0;
+        CHECK(pipeline.AddMixSource(&AddConstant, &first));
+        CHECK(pipeline.AddMixSource(&AddConstant, &second));
+        CHECK(pipeline.AddMixSource(&AddConstant, &silent));
+        CHECK(pipeline.AddMixSource(&AddConstant, &silent));
+        CHECK(!pipeline.AddMixSource(&AddConstant, &silent)); // kMaxMixSources
+        CHECK(!pipeline.AddMixSource(nullptr, nullptr));
+
+        AudioPipelineConfig config;
+        config.highPassEnabled = false;
+        pipeline.SetConfig(config);
+        std::vector<int16_t> frame(kFrame * 2, 0);
+        CHECK(pipeline.Process(frame.data(), kFrame, 2, kSampleRate));
+        CHECK(frame[0] == 120 && frame[kFrame * 2 - 1] == 120);
+
+        // Disabled pipeline: sources still play, and report whether they touched the frame
+        config.enabled = false;
+        pipeline.SetConfig(config);
+        std::fill(frame.begin(), frame.end(), static_cast<int16_t>(0));
+        CHECK(pipeline.Process(frame.data(), kFrame, 2, kSampleRate));
+        CHECK(frame[1] == 120);
+        first = second = 0;
+        CHECK(!pipeline.Process(frame.data(), kFrame, 2, kSampleRate));
+    }
+
+    // Writes a fixed value over the whole frame, like the radio mixer rebuilding playback
+    bool FillWith(void* context, int16_t* samples, int framesPerChannel, int channels, int sampleRate)
+    {
+        (void)sampleRate;
+        int16_t value = *static_cast<int16_t*>(context);
+        if (value == 0) return false;
+        std::fill(samples, samples + static_cast<size_t>(framesPerChannel) * channels, value);
+        return true;
+    }
+
+    void TestFrameSourceRunsFirst()
+    {
+        AudioPipeline pipeline;
+        int16_t fill = 500, added = 20;
+        pipeline.SetFrameSource(&FillWith, &fill);
+        CHECK(pipeline.AddMixSource(&AddConstant, &added));
+
+        AudioPipelineConfig config;
+        config.enabled = false;
+        pipeline.SetConfig(config);
+        std::vector<int16_t> frame(kFrame * 2, 7);
+        CHECK(pipeline.Process(frame.data(), kFrame, 2, kSampleRate));
+        CHECK(frame[0] == 520 && frame[kFrame * 2 - 1] == 520);
+
+        // Nothing from either: the frame is the caller's as it was
+        fill = added = 0;
+        std::fill(frame.begin(), frame.end(), static_cast<int16_t>(7));
+        CHECK(!pipeline.Process(frame.data(), kFrame, 2, kSampleRate));
+        CHECK(frame[0] == 7);
+    }
+}
+
+int main()
+{
+    std::printf("DSP kernels: %s\n", DspIsaName(DetectDspIsa()));
+
+    TestKernelsMatchScalar();
+    TestHighPassRemovesRumble();
+    TestLimiterCapsPeaks();
+    TestVoxGate();
+    TestDisabledAndUnsupportedFramesPassThrough();
+    TestMixSources();
+    TestFrameSourceRunsFirst();
+
+    if (g_failures == 0) std::printf("AudioPipelineTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+// Tests for the desired-state audio planner: only what differs becomes an action, actions come
+// in a safe order (mute first, joins after leaves, unmute last), and the side effects of each
+// step (a join resets mute, a leave drops the talk radio) are accounted for.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/AudioStatePlannerTests
+#include "../AudioStatePlanner.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // "joinChannel:ops:1 mute::0" - compact enough to compare whole plans
+    std::string Describe(const AudioPlan& plan)
+    {
+        std::string out;
+        for (const auto& action : plan.actions) {
+            if (!out.empty()) out += " ";
+            out += std::string(AudioStepName(action.step)) + ":" + action.channel + ":" + std::to_string(action.value);
+        }
+        return out;
+    }
+
+    // What the core would look like once the plan ran (the planner's own simulation, replayed)
+    CurrentAudioState Applied(CurrentAudioState state, const AudioPlan& plan)
+    {
+        for (const auto& action : plan.actions) {
+            switch (action.step) {
+                case AudioStep::Mute: state.muted = action.value != 0; break;
+                case AudioStep::SetScenario: state.scenario = action.value; break;
+                case AudioStep::SetNoiseSuppression: state.noiseSuppressionMode = action.value; break;
+                case AudioStep::LeaveRadio:
+                    for (auto it = state.radios.begin(); it != state.radios.end(); ++it) {
+                        if (*it == action.channel) { state.radios.erase(it); break; }
+                    }
+                    if (state.talkChannel == action.channel) state.talkChannel.clear();
+                    break;
+                case AudioStep::LeaveChannel: state.channel.clear(); state.listenOnly = false; state.muted = false; break;
+                case AudioStep::JoinChannel: state.channel = action.channel; state.listenOnly = state.muted = action.value != 0; break;
+                case AudioStep::JoinRadio:
+                    state.radios.push_back(action.channel);
+                    if (action.value != 0) state.talkChannel = action.channel;
+                    break;
+                case AudioStep::SetTalkChannel: state.talkChannel = action.channel; break;
+                case AudioStep::SetListenOnly: state.listenOnly = action.value != 0; state.muted = true; break;
+                case AudioStep::SetClientRole: state.clientRole = action.value; break;
+                case AudioStep::EnableLocalAudio: state.localAudioEnabled = action.value != 0; break;
+                case AudioStep::RecordingVolume: state.recordingVolume = action.value; break;
+                case AudioStep::PlaybackVolume: state.playbackVolume = action.value; break;
+            }
+        }
+        return state;
+    }
+
+    void TestNothingAskedNothingDone()
+    {
+        CurrentAudioState current;
+        current.channel = "ops";
+        AudioPlan plan = PlanAudioState(current, DesiredAudioState{});
+        CHECK(plan.actions.empty() && plan.unchanged == 0);
+    }
+
+    void TestFirstJoinThenRepeatIsFree()
+    {
+        // The call screen's burst: audio settings, join, unmute, enable, volume
+        DesiredAudioState desired;
+        desired.channel = "call-42";
+        desired.listenOnly = false;
+        desired.muted = false;
+        desired.localAudioEnabled = true;
+        desired.playbackVolume = 200;
+        desired.noiseSuppressionMode = 1;
+        desired.scenario = 8;
+
+        CurrentAudioState current;
+        AudioPlan plan = PlanAudioState(current, desired);
+        CHECK(Describe(plan) == "scenario::8 noiseSuppression::1 joinChannel:call-42:0 playbackVolume::200");
+        CHECK(plan.unchanged == 2); // already unmuted and enabled
+
+        // Asking again changes nothing
+        AudioPlan again = PlanAudioState(Applied(current, plan), desired);
+        CHECK(again.actions.empty() && again.unchanged == 7);
+    }
+
+    void TestMuteFirstAndAfterTheJoin()
+    {
+        // Keyed up on ops, told to go to fire muted: key down before leaving, and again after
+        // the join (a talker joins unmuted)
+        CurrentAudioState current;
+        current.channel = "ops";
+        DesiredAudioState desired;
+        desired.channel = "fire";
+        desired.muted = true;
+        AudioPlan plan = PlanAudioState(current, desired);
+        CHECK(Describe(plan) == "mute::1 leaveChannel::0 joinChannel:fire:0 mute::1");
+        CHECK(Applied(current, plan).muted);
+
+        // Joined as a listener it is muted by the join itself
+        desired.listenOnly = true;
+        CHECK(Describe(PlanAudioState(current, desired)) == "mute::1 leaveChannel::0 joinChannel:fire:1");
+
+        // Nothing moves: one mute, at the end
+        DesiredAudioState muteOnly;
+        muteOnly.muted = true;
+        muteOnly.playbackVolume = 100;
+        CHECK(Describe(PlanAudioState(current, muteOnly)) == "playbackVolume::100 mute::1");
+    }
+
+    void TestUnmuteGoesLast()
+    {
+        CurrentAudioState current;
+        current.channel = "ops";
+        current.listenOnly = true;
+        current.muted = true;
+        DesiredAudioState desired;
+        desired.muted = false;
+        desired.listenOnly = false;
+        desired.recordingVolume = 150;
+        CHECK(Describe(PlanAudioState(current, desired)) == "listenOnly::0 recordingVolume::150 mute::0");
+    }
+
+    void TestRadioSetAndTalkRadio()
+    {
+        CurrentAudioState current;
+        current.radios = { "fire", "ems" };
+        current.talkChannel = "fire";
+
+        // Swap fire for police and talk there: leave first, the join takes the talk key
+        DesiredAudioState desired;
+        desired.radios = std::vector<std::string>{ "ems", "police" };
+        desired.talkChannel = "police";
+        desired.muted = true;
+        AudioPlan plan = PlanAudioState(current, desired);
+        CHECK(Describe(plan) == "mute::1 leaveRadio:fire:0 joinRadio:police:1");
+        CurrentAudioState after = Applied(current, plan);
+        CHECK(after.talkChannel == "police" && after.radios.size() == 2 && after.muted);
+        CHECK(PlanAudioState(after, desired).actions.empty());
+
+        // A talk radio that isn't monitored yet is joined, order of the list does not matter
+        DesiredAudioState talkOnly;
+        talkOnly.talkChannel = "police";
+        CHECK(Describe(PlanAudioState(current, talkOnly)) == "joinRadio:police:1");
+        DesiredAudioState reordered;
+        reordered.radios = std::vector<std::string>{ "ems", "fire" };
+        AudioPlan same = PlanAudioState(current, reordered);
+        CHECK(same.actions.empty() && same.unchanged == 1);
+
+        // Nobody talks: the radios stay, only the publish switch moves
+        DesiredAudioState nobody;
+        nobody.talkChannel = "";
+        CHECK(Describe(PlanAudioState(current, nobody)) == "talkChannel::0");
+    }
+
+    void TestLeaveEverything()
+    {
+        CurrentAudioState current;
+        current.channel = "ops";
+        current.radios = { "fire" };
+        current.talkChannel = "fire";
+        current.muted = true;
+        DesiredAudioState desired;
+        desired.channel = "";
+        desired.radios = std::vector<std::string>{};
+        desired.talkChannel = "";
+        desired.muted = true;
+        desired.listenOnly = true; // meaningless without a channel
+
+        AudioPlan plan = PlanAudioState(current, desired);
+        CHECK(Describe(plan) == "leaveRadio:fire:0 leaveChannel::0 mute::1");
+        CurrentAudioState after = Applied(current, plan);
+        CHECK(after.channel.empty() && after.radios.empty() && after.talkChannel.empty() && after.muted);
+    }
+}
+
+int main()
+{
+    TestNothingAskedNothingDone();
+    TestFirstJoinThenRepeatIsFree();
+    TestMuteFirstAndAfterTheJoin();
+    TestUnmuteGoesLast();
+    TestRadioSetAndTalkRadio();
+    TestLeaveEverything();
+
+    if (g_failures == 0) std::printf("AudioStatePlannerTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
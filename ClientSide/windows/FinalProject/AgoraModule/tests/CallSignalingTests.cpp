@@ -0,0 +1,505 @@
+// Tests for call signaling: the CallSignaling codec, acks and retries on their own, then two
+// AgoraCores talking through a FakeStreamRelay the way two signed-in clients use the lobby -
+// for calls, and for the push-to-talk floor riding on it (FloorControlTests covers the rest).
+//
+//   cmake -S .. -B build && cmake --build build && ./build/CallSignalingTests
+#include "../AgoraCore.h"
+#include "../CallSignaling.h"
+#include "../FakeVoiceEngine.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    using Clock = std::chrono::steady_clock;
+
+    CallSignal Invite(const std::string& toUser, const std::string& invitationId)
+    {
+        CallSignal signal;
+        signal.type = CallSignalType::Invite;
+        signal.toUser = toUser;
+        signal.invitationId = invitationId;
+        signal.channelName = invitationId;
+        signal.callerName = "Dispatch 1";
+        return signal;
+    }
+
+    SignalReceive Deliver(CallSignaling& to, const std::string& message, uint64_t nowMs = 0)
+    {
+        return to.OnMessage(message.data(), message.size(), nowMs);
+    }
+
+    void TestEncodeDecodeRoundTrip()
+    {
+        CallSignal signal = Invite("17", "call_42");
+        signal.seq = 123456;
+        signal.fromUser = "5";
+        signal.callerName = "Ops | 100% \xD7\x93\xD7\xA0\xD7\x94"; // separator, escape char and UTF-8
+
+        std::string message = CallSignaling::Encode(signal);
+        CHECK(message.rfind("cs1|invite|123456|5|17|call_42|call_42|", 0) == 0);
+
+        CallSignal decoded;
+        CHECK(CallSignaling::Decode(message.data(), message.size(), decoded));
+        CHECK(decoded.type == CallSignalType::Invite && decoded.seq == 123456);
+        CHECK(decoded.fromUser == "5" && decoded.toUser == "17");
+        CHECK(decoded.invitationId == "call_42" && decoded.channelName == "call_42");
+        CHECK(decoded.callerName == signal.callerName);
+    }
+
+    void TestMalformedMessagesAreRejected()
+    {
+        CallSignal decoded;
+        const char* bad[] = {
+            "",
+            "cs2|invite|1|a|b|||",         // unknown version
+            "cs1|ring|1|a|b|||",           // unknown type
+            "cs1|invite|0|a|b|||",         // seq 0 is never sent
+            "cs1|invite|x1|a|b|||",
+            "cs1|invite|99999999999|a|b|||",
+            "cs1|invite|1|a|b||",          // a field short
+            "cs1|invite|1|a|b||||",        // a field too many
+            "cs1|invite|1||b|||",          // no sender
+            "cs1|invite|1|a|b|%zz||",      // bad escape
+        };
+        for (const char* message : bad) {
+            CHECK(!CallSignaling::Decode(message, std::string(message).size(), decoded));
+        }
+
+        std::string huge = "cs1|invite|1|a|b|||" + std::string(CallSignaling::kMaxMessageBytes, 'x');
+        CHECK(!CallSignaling::Decode(huge.data(), huge.size(), decoded));
+    }
+
+    void TestAckCompletesAndDuplicatesAreDeliveredOnce()
+    {
+        CallSignaling caller(1);
+        CallSignaling callee(2);
+        CallSignaling bystander(3);
+        caller.SetLocalUser("5");
+        callee.SetLocalUser("17");
+        bystander.SetLocalUser("99");
+
+        CallSignal signal = Invite("17", "call_42");
+        uint32_t seq = caller.Enqueue(signal, 1000);
+        CHECK(seq != 0 && signal.seq == seq && signal.fromUser == "5");
+        SignalSend first = caller.Poll(seq, 1000);
+        CHECK(first.send && first.nextCheckMs == CallSignaling::kFirstRetryMs);
+
+        // The lobby shows it to everyone; only the addressee takes it
+        CHECK(!Deliver(bystander, first.message).deliver);
+        CHECK(Deliver(bystander, first.message).ack.empty());
+
+        SignalReceive received = Deliver(callee, first.message);
+        CHECK(received.deliver && received.signal.invitationId == "call_42" && received.signal.callerName == "Dispatch 1");
+        CHECK(!received.ack.empty());
+
+        // The ack was lost and the caller sent it again: acked again, not delivered again
+        SignalSend retry = caller.Poll(seq, 1200);
+        CHECK(retry.send && retry.message == first.message);
+        SignalReceive again = Deliver(callee, retry.message);
+        CHECK(!again.deliver && !again.ack.empty());
+
+        SignalReceive acked = Deliver(caller, again.ack, 1250);
+        CHECK(acked.acked && acked.ackedSignal.seq == seq && acked.ackedAfterMs == 250);
+        CHECK(caller.GetPendingCount() == 0);
+        CHECK(!caller.Poll(seq, 1400).send);
+
+        // Late duplicate ack, and an ack from someone the signal was not for
+        CHECK(!Deliver(caller, received.ack).acked);
+        uint32_t other = caller.Enqueue(signal, 2000);
+        CallSignal forged;
+        forged.type = CallSignalType::Ack;
+        forged.seq = other;
+        forged.fromUser = "99";
+        forged.toUser = "5";
+        CHECK(!Deliver(caller, CallSignaling::Encode(forged)).acked);
+        CHECK(caller.GetPendingCount() == 1);
+    }
+
+    void TestRetriesBackOffThenExpire()
+    {
+        CallSignaling caller(1);
+        caller.SetLocalUser("5");
+        CallSignal signal = Invite("17", "call_42");
+        uint32_t seq = caller.Enqueue(signal, 0);
+
+        const int delays[] = { 200, 400, 800, 1600, 1600, 1600, 1600, 1600 };
+        for (int i = 0; i < CallSignaling::kMaxSends; ++i) {
+            SignalSend step = caller.Poll(seq, 0);
+            CHECK(step.send && step.nextCheckMs == delays[i]);
+        }
+        SignalSend last = caller.Poll(seq, 0);
+        CHECK(!last.send && last.expired && last.signal.seq == seq && last.signal.toUser == "17");
+        CHECK(caller.GetPendingCount() == 0);
+    }
+
+    void TestEnqueueRefusesWhatCannotBeSent()
+    {
+        CallSignaling signaling(1);
+        CallSignal signal = Invite("17", "call_42");
+        CHECK(signaling.Enqueue(signal, 0) == 0); // nobody signed in
+
+        signaling.SetLocalUser("5");
+        CallSignal nobody = Invite("", "call_42");
+        CHECK(signaling.Enqueue(nobody, 0) == 0);
+        CallSignal big = Invite("17", std::string(CallSignaling::kMaxMessageBytes, 'x'));
+        CHECK(signaling.Enqueue(big, 0) == 0);
+
+        // Signing out (or in as someone else) drops what was pending
+        CHECK(signaling.Enqueue(signal, 0) != 0 && signaling.Enqueue(signal, 0) != 0);
+        CHECK(signaling.PendingMessages().size() == 2);
+        signaling.SetLocalUser("6");
+        CHECK(signaling.GetPendingCount() == 0);
+    }
+
+    // What one client's app sees
+    class SignalListener : public IAgoraCoreListener
+    {
+    public:
+        void OnEventBatch(const std::vector<AgoraEvent>&, const EventBatchStats&) override {}
+        void OnVolumeUpdate(const VolumeUpdate&) override {}
+        void OnTalkStateChanged(bool, bool) override {}
+        void OnCallLatency(const std::string&, bool, double) override {}
+        void OnConnectionStateChanged(const std::string&, const ConnectionTransition&) override {}
+
+        void OnCallSignal(const CallSignal& signal) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_signals.push_back(signal);
+            m_receivedAt.push_back(Clock::now());
+        }
+
+        void OnCallSignalStatus(const CallSignal& signal, bool delivered) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_statuses.push_back({ signal, delivered });
+        }
+
+        void OnFloorChanged(const FloorChange& change) override
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_floorChanges.push_back(change);
+        }
+
+        void OnLatencyProbeFinished(const LatencyReport&) override {}
+        void OnAudioDevicesChanged(const AudioDeviceList&) override {}
+
+        struct Status { CallSignal signal; bool delivered; };
+
+        std::vector<CallSignal> Signals() const { std::lock_guard<std::mutex> lock(m_mutex); return m_signals; }
+        std::vector<Status> Statuses() const { std::lock_guard<std::mutex> lock(m_mutex); return m_statuses; }
+        Clock::time_point ReceivedAt(size_t i) const { std::lock_guard<std::mutex> lock(m_mutex); return m_receivedAt.at(i); }
+        std::vector<FloorChange> FloorChanges() const { std::lock_guard<std::mutex> lock(m_mutex); return m_floorChanges; }
+
+    private:
+        mutable std::mutex m_mutex;
+        std::vector<CallSignal> m_signals;
+        std::vector<Clock::time_point> m_receivedAt;
+        std::vector<Status> m_statuses;
+        std::vector<FloorChange> m_floorChanges;
+    };
+
+    // One signed-in client: a core on a fake that shares the relay with the other clients
+    struct Client
+    {
+        Client(FakeStreamRelay& relay, bool manualClock)
+            : core([this, &relay, manualClock]() {
+                  FakeEngineConfig config;
+                  config.manualClock = manualClock;
+                  config.relay = &relay;
+                  auto engine = std::make_unique<FakeVoiceEngine>(config);
+                  fake = engine.get();
+                  return engine;
+              })
+        {
+            core.SetListener(&listener);
+        }
+
+        ~Client() { core.SetListener(nullptr); }
+
+        void Run(std::function<void()> fn)
+        {
+            std::promise<void> done;
+            core.Post(Command{ "", std::move(fn), [&done]() { done.set_value(); } });
+            done.get_future().wait();
+        }
+
+        void Advance(int milliseconds)
+        {
+            fake->AdvanceBy(milliseconds);
+            core.FlushEvents();
+            Run([]() {});
+        }
+
+        void SignIn(const std::string& userId)
+        {
+            Run([&]() { core.InitializeEngine("app"); });
+            Run([&]() { core.StartSignaling("lobby", userId); });
+        }
+
+        bool Ready()
+        {
+            bool ready = false;
+            Run([&]() { ready = core.IsSignalingConnected(); });
+            return ready;
+        }
+
+        SignalListener listener;
+        FakeVoiceEngine* fake = nullptr;
+        AgoraCore core;
+    };
+
+    bool WaitFor(const std::function<bool()>& condition, int timeoutMs = 3000)
+    {
+        auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (!condition()) {
+            if (Clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        return true;
+    }
+
+    // Manual clocks: both sides move in step
+    void AdvanceBoth(Client& a, Client& b, int milliseconds)
+    {
+        a.Advance(milliseconds);
+        b.Advance(milliseconds);
+    }
+
+    void TestInviteRoundTripBetweenClients()
+    {
+        FakeStreamRelay relay(20);
+        Client caller(relay, true);
+        Client callee(relay, true);
+        caller.SignIn("5");
+        callee.SignIn("17");
+        AdvanceBoth(caller, callee, 30);
+        CHECK(caller.Ready() && callee.Ready());
+
+        // The lobby sends, but carries no audio
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(caller.fake->FindConnection("lobby", info) && info.joined && !info.audience && !info.publishing && !info.subscribed);
+        CHECK(caller.fake->GetPublisherCount() == 0);
+
+        caller.Run([&]() { caller.core.SendCallSignal(Invite("17", "call_42")); });
+        callee.Advance(20);
+        auto signals = callee.listener.Signals();
+        CHECK(signals.size() == 1);
+        CHECK(!signals.empty() && signals[0].type == CallSignalType::Invite && signals[0].fromUser == "5" &&
+              signals[0].invitationId == "call_42" && signals[0].callerName == "Dispatch 1");
+
+        caller.Advance(20);
+        auto statuses = caller.listener.Statuses();
+        CHECK(statuses.size() == 1 && statuses[0].delivered && statuses[0].signal.type == CallSignalType::Invite);
+
+        // And the answer back the same way
+        CallSignal accept;
+        accept.type = CallSignalType::Accept;
+        accept.toUser = "5";
+        accept.invitationId = "call_42";
+        callee.Run([&]() { callee.core.SendCallSignal(accept); });
+        caller.Advance(20);
+        signals = caller.listener.Signals();
+        CHECK(signals.size() == 1 && signals[0].type == CallSignalType::Accept && signals[0].fromUser == "17");
+        CHECK(caller.core.GetMetrics().find("\"callSignal\":{\"n\":1") != std::string::npos);
+    }
+
+    void TestSignalsGetThroughOutagesAndLostAcks()
+    {
+        FakeStreamRelay relay(20);
+        Client caller(relay, true);
+        Client callee(relay, true);
+        caller.SignIn("5");
+        callee.SignIn("17");
+        AdvanceBoth(caller, callee, 30);
+
+        // The caller's network is out when the invite goes: retries carry it once it is back
+        caller.fake->SetNetworkDown(true);
+        caller.Run([&]() { caller.core.SendCallSignal(Invite("17", "call_1")); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(450));
+        AdvanceBoth(caller, callee, 20);
+        CHECK(callee.listener.Signals().empty());
+        caller.fake->SetNetworkDown(false);
+        CHECK(WaitFor([&]() {
+            AdvanceBoth(caller, callee, 20);
+            return !caller.listener.Statuses().empty();
+        }));
+        CHECK(callee.listener.Signals().size() == 1);
+
+        // The callee's first ack fails: the caller resends, the callee acks again, the app sees it once
+        callee.fake->FailNext(FakeCall::SendStreamMessage, FakeVoiceEngine::kErrFailed);
+        caller.Run([&]() { caller.core.SendCallSignal(Invite("17", "call_2")); });
+        CHECK(WaitFor([&]() {
+            AdvanceBoth(caller, callee, 20);
+            return caller.listener.Statuses().size() == 2;
+        }));
+        CHECK(callee.listener.Signals().size() == 2);
+        CHECK(callee.fake->GetStreamMessagesReceived() >= 3); // call_1 once, call_2 at least twice
+        auto statuses = caller.listener.Statuses();
+        CHECK(statuses.size() == 2 && statuses[1].delivered && statuses[1].signal.invitationId == "call_2");
+    }
+
+    void TestLobbyRejoinFlushesPendingSignals()
+    {
+        FakeStreamRelay relay(20);
+        Client caller(relay, true);
+        Client callee(relay, true);
+        ReconnectPolicy policy;
+        policy.baseDelayMs = 10;
+        policy.jitter = 0.0;
+        caller.Run([&]() { caller.core.SetReconnectPolicy(policy); });
+        caller.SignIn("5");
+        callee.SignIn("17");
+        AdvanceBoth(caller, callee, 30);
+
+        // The SDK gives up on the caller's lobby; the cancel is sent while it is being rejoined
+        caller.fake->FailConnection("lobby", FakeVoiceEngine::kReasonInterrupted);
+        caller.Advance(0);
+        CallSignal cancel;
+        cancel.type = CallSignalType::Cancel;
+        cancel.toUser = "17";
+        cancel.invitationId = "call_42";
+        caller.Run([&]() { caller.core.SendCallSignal(cancel); });
+
+        CHECK(WaitFor([&]() {
+            AdvanceBoth(caller, callee, 10);
+            return !callee.listener.Signals().empty();
+        }));
+        auto signals = callee.listener.Signals();
+        CHECK(signals.size() == 1 && signals[0].type == CallSignalType::Cancel);
+        CHECK(caller.Ready());
+        CHECK(caller.fake->GetCallCount(FakeCall::CreateDataStream) == 2);
+
+        // Signing out leaves the lobby; nothing reaches a client that is gone
+        callee.Run([&]() { callee.core.StopSignaling(); });
+        callee.Advance(10);
+        FakeVoiceEngine::ConnectionInfo info;
+        CHECK(!callee.fake->FindConnection("lobby", info));
+        caller.Run([&]() { caller.core.SendCallSignal(Invite("17", "call_43")); });
+        AdvanceBoth(caller, callee, 20);
+        CHECK(callee.listener.Signals().size() == 1);
+    }
+
+    // Real time on the fakes' callback threads: how long a push takes with a 20 ms relay,
+    // against the 3 s polling interval it replaces (1.5 s on average, plus the request)
+    void TestPushLatencyIsMilliseconds()
+    {
+        FakeStreamRelay relay(20);
+        Client caller(relay, false);
+        Client callee(relay, false);
+        caller.SignIn("5");
+        callee.SignIn("17");
+        CHECK(WaitFor([&]() { return caller.Ready() && callee.Ready(); }));
+
+        constexpr int kInvites = 20;
+        double totalMs = 0.0;
+        double worstMs = 0.0;
+        for (int i = 0; i < kInvites; ++i) {
+            auto sent = Clock::now();
+            caller.core.Post(Command{ "", [&caller, i]() { caller.core.SendCallSignal(Invite("17", "call_" + std::to_string(i))); }, nullptr });
+            CHECK(WaitFor([&]() { return callee.listener.Signals().size() == static_cast<size_t>(i + 1); }));
+            if (callee.listener.Signals().size() != static_cast<size_t>(i + 1)) break;
+            double ms = std::chrono::duration<double, std::milli>(callee.listener.ReceivedAt(i) - sent).count();
+            totalMs += ms;
+            worstMs = ms > worstMs ? ms : worstMs;
+        }
+        CHECK(worstMs < 250.0);
+        CHECK(WaitFor([&]() { return caller.listener.Statuses().size() == static_cast<size_t>(kInvites); }));
+        std::printf("invite push over a 20 ms relay: mean %.1f ms, worst %.1f ms (%d invites)\n",
+                    totalMs / kInvites, worstMs, kInvites);
+    }
+
+    void TestFloorGatesTheMicrophone()
+    {
+        FakeStreamRelay relay(10);
+        Client a(relay, false);
+        Client b(relay, false);
+        a.SignIn("1");
+        b.SignIn("2");
+        CHECK(WaitFor([&]() { return a.Ready() && b.Ready(); }));
+
+        for (Client* client : { &a, &b }) {
+            client->Run([client]() {
+                client->core.SetFloorControl("radio_1", true);
+                client->core.JoinRadioChannel("radio_1", true);
+            });
+        }
+        auto muted = [](Client& client) {
+            bool result = false;
+            client.Run([&]() { result = client.core.IsLocalAudioMuted(); });
+            return result;
+        };
+        auto lastFloor = [](Client& client) {
+            auto changes = client.listener.FloorChanges();
+            return changes.empty() ? FloorChange{} : changes.back();
+        };
+        CHECK(muted(a) && muted(b)); // nobody holds the floor yet
+
+        // No floor, no microphone
+        b.Run([&]() { b.core.MuteLocalAudio(false); });
+        CHECK(muted(b));
+
+        // Key up once the arbiter has settled: the grant opens the microphone, the other console
+        // sees who talks and stays shut
+        std::this_thread::sleep_for(std::chrono::milliseconds(FloorPolicy{}.settleMs + 100));
+        auto keyed = Clock::now();
+        b.Run([&]() { b.core.RequestFloor("radio_1", 0); });
+        CHECK(WaitFor([&]() { return lastFloor(b).state == FloorState::Granted; }));
+        double grantMs = std::chrono::duration<double, std::milli>(Clock::now() - keyed).count();
+        CHECK(grantMs < 200.0);
+        CHECK(!muted(b));
+        CHECK(WaitFor([&]() { return lastFloor(a).state == FloorState::Taken && lastFloor(a).holder == "2"; }));
+        a.Run([&]() { a.core.MuteLocalAudio(false); });
+        CHECK(muted(a));
+        a.Run([&]() { a.core.RequestFloor("radio_1", 0); });
+        CHECK(WaitFor([&]() { return lastFloor(a).reason == FloorReason::Busy; }));
+        CHECK(muted(a));
+
+        // Key down: muted at once, the floor is free again for everyone
+        b.Run([&]() { b.core.ReleaseFloor("radio_1"); });
+        CHECK(muted(b));
+        CHECK(WaitFor([&]() { return lastFloor(a).state == FloorState::Idle; }));
+
+        // Leaving the lobby leaves floor control inert: a plain key-up again
+        a.Run([&]() { a.core.StopSignaling(); });
+        a.Run([&]() { a.core.RequestFloor("radio_1", 0); });
+        CHECK(!muted(a));
+        std::printf("floor grant over a 10 ms relay: %.1f ms\n", grantMs);
+    }
+}
+
+int main()
+{
+    TestEncodeDecodeRoundTrip();
+    TestMalformedMessagesAreRejected();
+    TestAckCompletesAndDuplicatesAreDeliveredOnce();
+    TestRetriesBackOffThenExpire();
+    TestEnqueueRefusesWhatCannotBeSent();
+    TestInviteRoundTripBetweenClients();
+    TestSignalsGetThroughOutagesAndLostAcks();
+    TestLobbyRejoinFlushesPendingSignals();
+    TestPushLatencyIsMilliseconds();
+    TestFloorGatesTheMicrophone();
+
+    if (g_failures == 0) std::printf("CallSignalingTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+// Tests for the command worker: coalescing only between neighbours with the same key, barriers,
+// completions forwarded from superseded commands, delayed posts in deadline order and Stop
+// running whatever is still queued. A gate command holds the worker so each scenario is queued
+// as one batch before the worker sees any of it.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/CommandQueueTests
+#include "../CommandQueue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // What ran and what completed, in order; "run:x" / "done:x"
+    struct Journal
+    {
+        std::mutex mutex;
+        std::vector<std::string> entries;
+
+        void Add(const std::string& entry)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            entries.push_back(entry);
+        }
+
+        std::vector<std::string> Get()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries;
+        }
+    };
+
+    Command Logged(Journal& journal, std::string key, const std::string& name)
+    {
+        return Command{ std::move(key),
+                        [&journal, name]() { journal.Add("run:" + name); },
+                        [&journal, name]() { journal.Add("done:" + name); } };
+    }
+
+    // Parks the worker inside a command until Release(), so what is posted meanwhile forms one batch
+    class Gate
+    {
+    public:
+        explicit Gate(CommandQueue& queue)
+        {
+            std::shared_future<void> open = m_open.get_future().share();
+            queue.Post(Command{ "", [this, open]() { m_entered.set_value(); open.wait(); }, nullptr });
+            m_entered.get_future().wait();
+        }
+
+        void Release() { m_open.set_value(); }
+
+    private:
+        std::promise<void> m_entered;
+        std::promise<void> m_open;
+    };
+
+    void WaitIdle(CommandQueue& queue)
+    {
+        std::promise<void> done;
+        queue.Post(Command{ "", []() {}, [&done]() { done.set_value(); } });
+        done.get_future().wait();
+    }
+
+    void TestNeighboursCoalesce()
+    {
+        CommandQueue queue;
+        queue.Start();
+        Journal journal;
+
+        Gate gate(queue);
+        queue.Post(Logged(journal, "volume", "a"));
+        queue.Post(Logged(journal, "volume", "b"));
+        queue.Post(Logged(journal, "volume", "c"));
+        gate.Release();
+        WaitIdle(queue);
+
+        // Only the last one runs; every caller still hears back, after it
+        CHECK((journal.Get() == std::vector<std::string>{ "run:c", "done:c", "done:b", "done:a" }));
+        CHECK(queue.GetCoalescedCount() == 2);
+        queue.Stop();
+    }
+
+    void TestOtherKeysKeepOrder()
+    {
+        CommandQueue queue;
+        queue.Start();
+        Journal journal;
+
+        // A different key in between: nothing merges, nothing moves
+        Gate gate(queue);
+        queue.Post(Logged(journal, "talk", "fire"));
+        queue.Post(Logged(journal, "mute", "unmute"));
+        queue.Post(Logged(journal, "talk", "ems"));
+        gate.Release();
+        WaitIdle(queue);
+
+        CHECK((journal.Get() == std::vector<std::string>{
+            "run:fire", "done:fire", "run:unmute", "done:unmute", "run:ems", "done:ems" }));
+        CHECK(queue.GetCoalescedCount() == 0);
+        queue.Stop();
+    }
+
+    void TestBarriersAreNeverCoalesced()
+    {
+        CommandQueue queue;
+        queue.Start();
+        Journal journal;
+
+        Gate gate(queue);
+        queue.Post(Logged(journal, "volume", "before"));
+        queue.Post(Logged(journal, "", "join"));
+        queue.Post(Logged(journal, "", "leave"));
+        queue.Post(Logged(journal, "volume", "after"));
+        gate.Release();
+        WaitIdle(queue);
+
+        CHECK((journal.Get() == std::vector<std::string>{
+            "run:before", "done:before", "run:join", "done:join", "run:leave", "done:leave", "run:after", "done:after" }));
+        CHECK(queue.GetCoalescedCount() == 0);
+        queue.Stop();
+    }
+
+    void TestWorkerThread()
+    {
+        CommandQueue queue;
+        queue.Start();
+        std::atomic<bool> inside{ false };
+        std::atomic<bool> completion{ false };
+        std::promise<void> done;
+        queue.Post(Command{ "", [&]() { inside = queue.IsWorkerThread(); },
+                            [&]() { completion = queue.IsWorkerThread(); done.set_value(); } });
+        done.get_future().wait();
+        CHECK(inside.load() && completion.load());
+        CHECK(!queue.IsWorkerThread());
+        queue.Stop();
+        CHECK(!queue.IsWorkerThread());
+    }
+
+    void TestPostAfterRunsInDeadlineOrder()
+    {
+        CommandQueue queue;
+        queue.Start();
+        Journal journal;
+
+        auto start = std::chrono::steady_clock::now();
+        std::promise<void> last;
+        queue.PostAfter(60, Command{ "", [&journal]() { journal.Add("run:late"); }, [&last]() { last.set_value(); } });
+        queue.PostAfter(20, Logged(journal, "", "early"));
+        queue.Post(Logged(journal, "", "now"));
+        last.get_future().wait();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        CHECK((journal.Get() == std::vector<std::string>{ "run:now", "done:now", "run:early", "done:early", "run:late" }));
+        CHECK(elapsed >= std::chrono::milliseconds(60));
+        CHECK(queue.GetExecutedCount() == 3);
+        queue.Stop();
+    }
+
+    void TestStopRunsWhatIsQueued()
+    {
+        CommandQueue queue;
+        queue.Start();
+        Journal journal;
+        std::atomic<int> completions{ 0 };
+
+        Gate gate(queue);
+        for (int i = 0; i < 100; ++i) {
+            queue.Post(Command{ "", []() {}, [&completions]() { ++completions; } });
+        }
+        // Timers are not waited for: dropped unrun
+        queue.PostAfter(10000, Logged(journal, "", "timer"));
+        std::thread releaser([&gate]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            gate.Release();
+        });
+        queue.Stop();
+        releaser.join();
+
+        CHECK(completions.load() == 100);
+        CHECK(journal.Get().empty());
+        CHECK(queue.GetExecutedCount() == 101); // the gate and the 100
+    }
+
+    void TestManyProducers()
+    {
+        CommandQueue queue;
+        queue.Start();
+        constexpr int kProducers = 4;
+        constexpr int kPerProducer = 5000;
+        std::atomic<int> ran{ 0 };
+        std::atomic<int> completed{ 0 };
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < kProducers; ++p) {
+            producers.emplace_back([&]() {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    queue.Post(Command{ "", [&ran]() { ++ran; }, [&completed]() { ++completed; } });
+                }
+            });
+        }
+        for (auto& producer : producers) producer.join();
+        WaitIdle(queue);
+
+        CHECK(ran.load() == kProducers * kPerProducer);
+        CHECK(completed.load() == kProducers * kPerProducer);
+        queue.Stop();
+    }
+}
+
+int main()
+{
+    TestNeighboursCoalesce();
+    TestOtherKeysKeepOrder();
+    TestBarriersAreNeverCoalesced();
+    TestWorkerThread();
+    TestPostAfterRunsInDeadlineOrder();
+    TestStopRunsWhatIsQueued();
+    TestManyProducers();
+
+    if (g_failures == 0) std::printf("CommandQueueTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
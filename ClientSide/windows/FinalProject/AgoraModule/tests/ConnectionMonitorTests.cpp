@@ -0,0 +1,226 @@
+// Headless tests for ConnectionMonitor - no Agora SDK or WinRT required.
+#include "../ConnectionMonitor.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kConnected = static_cast<int>(ConnectionState::Connected);
+    constexpr int kConnecting = static_cast<int>(ConnectionState::Connecting);
+    constexpr int kReconnecting = static_cast<int>(ConnectionState::Reconnecting);
+    constexpr int kFailed = static_cast<int>(ConnectionState::Failed);
+    constexpr int kDisconnected = static_cast<int>(ConnectionState::Disconnected);
+
+    void TestBackoffDoublesUpToCapWithJitter()
+    {
+        ConnectionMonitor monitor(7);
+        ReconnectPolicy policy;
+        policy.baseDelayMs = 100;
+        policy.maxDelayMs = 1000;
+        policy.jitter = 0.5;
+        monitor.SetPolicy(policy);
+
+        // Attempt n waits between half and all of min(base * 2^(n-1), max)
+        const int ceilings[] = { 100, 200, 400, 800, 1000, 1000 };
+        for (int attempt = 1; attempt <= 6; ++attempt) {
+            int low = ceilings[attempt - 1];
+            int high = low;
+            for (int i = 0; i < 200; ++i) {
+                int delay = monitor.RetryDelayMs(attempt);
+                CHECK(delay >= ceilings[attempt - 1] / 2 && delay <= ceilings[attempt - 1]);
+                low = delay < low ? delay : low;
+                high = delay > high ? delay : high;
+            }
+            // Actually spread out, not one fixed value
+            CHECK(high - low > ceilings[attempt - 1] / 4);
+        }
+
+        policy.jitter = 0.0;
+        monitor.SetPolicy(policy);
+        CHECK(monitor.RetryDelayMs(3) == 400);
+    }
+
+    void TestInterruptionRestoresWithoutRetry()
+    {
+        ConnectionMonitor monitor(1);
+        monitor.Track("");
+
+        ConnectionTransition up = monitor.OnStateChanged("", kConnected, 1, 1000);
+        CHECK(up.notify && up.state == ConnectionState::Connected && !up.restore && !up.retry);
+
+        // The SDK repairs this one itself: report it, don't retry
+        ConnectionTransition down = monitor.OnStateChanged("", kReconnecting, ConnectionMonitor::kReasonInterrupted, 2000);
+        CHECK(down.notify && down.state == ConnectionState::Reconnecting && !down.retry);
+
+        ConnectionTransition back = monitor.OnRejoined("", 2750);
+        CHECK(back.notify && back.restore && back.outageMs == 750);
+        CHECK(monitor.GetState("") == ConnectionState::Connected);
+
+        // CONNECTED right after onRejoinChannelSuccess restores nothing twice
+        ConnectionTransition again = monitor.OnStateChanged("", kConnected, ConnectionMonitor::kReasonRejoinSuccess, 2760);
+        CHECK(!again.notify && !again.restore);
+    }
+
+    void TestHardFailureRetriesUntilConnected()
+    {
+        ConnectionMonitor monitor(1);
+        monitor.Track("fire");
+        monitor.OnStateChanged("fire", kConnected, 1, 0);
+
+        ConnectionTransition failed = monitor.OnStateChanged("fire", kFailed, ConnectionMonitor::kReasonJoinFailed, 100);
+        CHECK(failed.retry && failed.attempt == 1 && failed.notify);
+        CHECK(failed.state == ConnectionState::Reconnecting);
+
+        // Disconnected and lost in the same outage ride on the retry already queued
+        CHECK(!monitor.OnStateChanged("fire", kDisconnected, ConnectionMonitor::kReasonInterrupted, 110).retry);
+        CHECK(!monitor.OnConnectionLost("fire", 120).retry);
+
+        // Our own leave + join: the leave is ignored, connecting still reads as reconnecting
+        CHECK(monitor.BeginRetry("fire", failed.generation));
+        CHECK(!monitor.BeginRetry("fire", failed.generation));
+        CHECK(!monitor.OnStateChanged("fire", kDisconnected, ConnectionMonitor::kReasonLeaveChannel, 700).notify);
+        ConnectionTransition connecting = monitor.OnStateChanged("fire", kConnecting, 0, 700);
+        CHECK(!connecting.notify && connecting.state == ConnectionState::Reconnecting);
+
+        // Still no network: the next retry backs off further
+        ConnectionTransition second = monitor.OnStateChanged("fire", kFailed, ConnectionMonitor::kReasonJoinFailed, 800);
+        CHECK(second.retry && second.attempt == 2);
+        CHECK(second.generation != failed.generation);
+
+        CHECK(monitor.BeginRetry("fire", second.generation));
+        ConnectionTransition third = monitor.OnRetryFailed("fire", 900);
+        CHECK(third.retry && third.attempt == 3);
+
+        CHECK(monitor.BeginRetry("fire", third.generation));
+        ConnectionTransition back = monitor.OnStateChanged("fire", kConnected, 1, 1100);
+        CHECK(back.restore && back.outageMs == 1000 && back.attempt == 3);
+        CHECK(monitor.GetAttempts("fire") == 0);
+    }
+
+    void TestSdkRecoveryCancelsQueuedRetry()
+    {
+        ConnectionMonitor monitor(1);
+        monitor.Track("");
+        monitor.OnStateChanged("", kConnected, 1, 0);
+
+        ConnectionTransition lost = monitor.OnConnectionLost("", 10000);
+        CHECK(lost.retry && lost.reason == ConnectionMonitor::kReasonLost);
+
+        // The SDK got there before our timer did
+        CHECK(monitor.OnRejoined("", 10100).restore);
+        CHECK(!monitor.BeginRetry("", lost.generation));
+    }
+
+    void TestFatalReasonsGiveUp()
+    {
+        CHECK(ConnectionMonitor::IsFatalReason(8));  // invalid token
+        CHECK(ConnectionMonitor::IsFatalReason(3));  // banned
+        CHECK(!ConnectionMonitor::IsFatalReason(ConnectionMonitor::kReasonJoinFailed));
+        CHECK(!ConnectionMonitor::IsFatalReason(ConnectionMonitor::kReasonInterrupted));
+
+        ConnectionMonitor monitor(1);
+        monitor.Track("ops");
+        ConnectionTransition banned = monitor.OnStateChanged("ops", kFailed, 3, 0);
+        CHECK(banned.notify && !banned.retry && banned.state == ConnectionState::Failed);
+        CHECK(monitor.GetState("ops") == ConnectionState::Failed);
+    }
+
+    void TestMaxAttempts()
+    {
+        ConnectionMonitor monitor(1);
+        ReconnectPolicy policy;
+        policy.maxAttempts = 2;
+        monitor.SetPolicy(policy);
+        monitor.Track("ops");
+
+        ConnectionTransition first = monitor.OnStateChanged("ops", kFailed, ConnectionMonitor::kReasonJoinFailed, 0);
+        CHECK(first.retry && monitor.BeginRetry("ops", first.generation));
+        ConnectionTransition second = monitor.OnRetryFailed("ops", 10);
+        CHECK(second.retry && monitor.BeginRetry("ops", second.generation));
+
+        ConnectionTransition done = monitor.OnRetryFailed("ops", 20);
+        CHECK(!done.retry && done.notify && done.state == ConnectionState::Failed && done.attempt == 2);
+    }
+
+    void TestUntrackedAndForgottenAreIgnored()
+    {
+        ConnectionMonitor monitor(1);
+        CHECK(!monitor.OnStateChanged("ghost", kFailed, ConnectionMonitor::kReasonJoinFailed, 0).notify);
+        CHECK(!monitor.OnConnectionLost("ghost", 0).retry);
+
+        monitor.Track("ops");
+        ConnectionTransition failed = monitor.OnStateChanged("ops", kFailed, ConnectionMonitor::kReasonJoinFailed, 0);
+        CHECK(failed.retry);
+
+        // Left while the retry was queued: it must not rejoin
+        monitor.Forget("ops");
+        CHECK(!monitor.BeginRetry("ops", failed.generation));
+
+        // Joined again: the old timer still does nothing
+        monitor.Track("ops");
+        CHECK(!monitor.BeginRetry("ops", failed.generation));
+        CHECK(monitor.GetState("ops") == ConnectionState::Connecting);
+    }
+
+    void TestObserverSeesEveryChange()
+    {
+        struct Change { std::string key; ConnectionState state; bool tracked; };
+        std::vector<Change> changes;
+        ConnectionMonitor monitor(1);
+        monitor.SetObserver([&changes](const std::string& key, ConnectionState state, bool tracked) {
+            changes.push_back({ key, state, tracked });
+        });
+
+        monitor.Track("");
+        monitor.OnStateChanged("", kConnected, 1, 0);
+        monitor.OnStateChanged("", kConnected, 1, 10); // no change, no call
+        monitor.OnStateChanged("", kReconnecting, ConnectionMonitor::kReasonInterrupted, 20);
+        CHECK(changes.size() == 3);
+        CHECK(changes[1].key.empty() && changes[1].state == ConnectionState::Connected && changes[1].tracked);
+        CHECK(changes[2].state == ConnectionState::Reconnecting);
+
+        // A retry announces itself as reconnecting, the final give-up as failed
+        monitor.Track("fire", ConnectionState::Connected);
+        ConnectionTransition failed = monitor.OnStateChanged("fire", kFailed, ConnectionMonitor::kReasonJoinFailed, 0);
+        CHECK(failed.retry && changes.back().key == "fire" && changes.back().state == ConnectionState::Reconnecting);
+        monitor.OnStateChanged("fire", kFailed, 8, 0);
+        CHECK(changes.back().state == ConnectionState::Failed);
+
+        // Forgotten links are reported once, untracked ones never
+        size_t before = changes.size();
+        monitor.Forget("fire");
+        monitor.Forget("fire");
+        monitor.OnStateChanged("ghost", kConnected, 1, 0);
+        CHECK(changes.size() == before + 1 && !changes.back().tracked);
+        monitor.Clear();
+        CHECK(changes.size() == before + 2 && changes.back().key.empty() && !changes.back().tracked);
+    }
+}
+
+int main()
+{
+    TestBackoffDoublesUpToCapWithJitter();
+    TestInterruptionRestoresWithoutRetry();
+    TestHardFailureRetriesUntilConnected();
+    TestSdkRecoveryCancelsQueuedRetry();
+    TestFatalReasonsGiveUp();
+    TestMaxAttempts();
+    TestUntrackedAndForgottenAreIgnored();
+    TestObserverSeesEveryChange();
+
+    if (g_failures == 0) std::printf("ConnectionMonitorTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
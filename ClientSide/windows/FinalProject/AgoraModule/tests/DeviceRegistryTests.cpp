@@ -0,0 +1,120 @@
+// Tests for the audio device registry: the cache under enumerations, arrivals and removals,
+// and the preference policy (ids, name fragments, order, nothing present).
+//
+//   cmake -S .. -B build && cmake --build build && ./build/DeviceRegistryTests
+#include "../DeviceRegistry.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    const AudioDeviceInfo kBuiltIn{ "{0.0.1}.{realtek}", "Microphone Array (Realtek(R) Audio)" };
+    const AudioDeviceInfo kJabra{ "{0.0.1}.{jabra}", "Headset Microphone (Jabra Evolve2 65)" };
+    const AudioDeviceInfo kDesk{ "{0.0.1}.{shure}", "Desk Microphone (Shure MV7)" };
+
+    void TestCacheFollowsEnumerationAndEvents()
+    {
+        DeviceRegistry registry;
+        CHECK(!registry.IsEnumerated(AudioDeviceKind::Recording));
+
+        registry.SetDevices(AudioDeviceKind::Recording, { kBuiltIn, kJabra });
+        registry.SetActive(AudioDeviceKind::Recording, kJabra.id);
+        CHECK(registry.IsEnumerated(AudioDeviceKind::Recording));
+        CHECK(!registry.IsEnumerated(AudioDeviceKind::Playback));
+        CHECK(registry.Contains(AudioDeviceKind::Recording, kJabra.id));
+        CHECK(!registry.Contains(AudioDeviceKind::Playback, kJabra.id));
+        CHECK(!registry.Contains(AudioDeviceKind::Recording, ""));
+
+        // Removing the device in use leaves the active id unknown until the engine says
+        CHECK(registry.Remove(AudioDeviceKind::Recording, kJabra.id));
+        CHECK(!registry.Remove(AudioDeviceKind::Recording, kJabra.id));
+        CHECK(registry.GetActive(AudioDeviceKind::Recording).empty());
+        CHECK(registry.GetList(AudioDeviceKind::Recording).devices.size() == 1);
+
+        // A new enumeration keeps the active id only if that device is still there
+        registry.SetActive(AudioDeviceKind::Recording, kBuiltIn.id);
+        registry.SetDevices(AudioDeviceKind::Recording, { kBuiltIn, kDesk });
+        CHECK(registry.GetActive(AudioDeviceKind::Recording) == kBuiltIn.id);
+        registry.SetDevices(AudioDeviceKind::Recording, { kDesk });
+        CHECK(registry.GetActive(AudioDeviceKind::Recording).empty());
+    }
+
+    void TestPreferencePolicy()
+    {
+        DeviceRegistry registry;
+        registry.SetDevices(AudioDeviceKind::Recording, { kBuiltIn, kJabra, kDesk });
+
+        // No policy: leave the choice to the engine
+        CHECK(registry.Choose(AudioDeviceKind::Recording).empty());
+
+        // Name fragments, any case; the first preference present wins
+        registry.SetPreferences(AudioDeviceKind::Recording, { "evolve2", "shure" });
+        CHECK(registry.Choose(AudioDeviceKind::Recording) == kJabra.id);
+        registry.SetPreferences(AudioDeviceKind::Recording, { "Logitech", "SHURE", "jabra" });
+        CHECK(registry.Choose(AudioDeviceKind::Recording) == kDesk.id);
+
+        // An id matches exactly
+        registry.SetPreferences(AudioDeviceKind::Recording, { kBuiltIn.id });
+        CHECK(registry.Choose(AudioDeviceKind::Recording) == kBuiltIn.id);
+
+        // Nothing preferred is present
+        registry.SetPreferences(AudioDeviceKind::Recording, { "Logitech" });
+        CHECK(registry.Choose(AudioDeviceKind::Recording).empty());
+        CHECK(registry.Choose(AudioDeviceKind::Playback).empty());
+
+        // Blank entries are dropped, long lists cut
+        registry.SetPreferences(AudioDeviceKind::Recording, { "", "jabra", "" });
+        CHECK(registry.GetList(AudioDeviceKind::Recording).preferred == std::vector<std::string>{ "jabra" });
+        registry.SetPreferences(AudioDeviceKind::Recording, std::vector<std::string>(20, "x"));
+        CHECK(registry.GetList(AudioDeviceKind::Recording).preferred.size() == DeviceRegistry::kMaxPreferences);
+    }
+
+    void TestClearKeepsPreferences()
+    {
+        DeviceRegistry registry;
+        registry.SetDevices(AudioDeviceKind::Playback, { { "hdmi", "LG HDR 4K (NVIDIA High Definition Audio)" } });
+        registry.SetActive(AudioDeviceKind::Playback, "hdmi");
+        registry.SetPreferences(AudioDeviceKind::Playback, { "hdmi" });
+
+        registry.Clear();
+        AudioDeviceList list = registry.GetList(AudioDeviceKind::Playback);
+        CHECK(list.kind == AudioDeviceKind::Playback);
+        CHECK(list.devices.empty() && list.activeId.empty());
+        CHECK(list.preferred == std::vector<std::string>{ "hdmi" });
+        CHECK(!registry.IsEnumerated(AudioDeviceKind::Playback));
+    }
+
+    void TestKindNames()
+    {
+        AudioDeviceKind kind = AudioDeviceKind::Recording;
+        CHECK(ParseAudioDeviceKind("playback", kind) && kind == AudioDeviceKind::Playback);
+        CHECK(ParseAudioDeviceKind("recording", kind) && kind == AudioDeviceKind::Recording);
+        CHECK(!ParseAudioDeviceKind("speaker", kind) && kind == AudioDeviceKind::Recording);
+        CHECK(!ParseAudioDeviceKind(nullptr, kind));
+        CHECK(std::string(AudioDeviceKindName(AudioDeviceKind::Playback)) == "playback");
+    }
+}
+
+int main()
+{
+    TestCacheFollowsEnumerationAndEvents();
+    TestPreferencePolicy();
+    TestClearKeepsPreferences();
+    TestKindNames();
+
+    if (g_failures == 0) std::printf("DeviceRegistryTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Tests for the callback batcher: join/offline pairs cancelling in either order, duplicates
+// merged, keys scoped to channel + uid so other channels and other event types pass through, and
+// events past a full ring counted as dropped in the next batch instead of blocking the pusher.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/EventBatcherTests
+#include "../EventBatcher.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    AgoraEvent Event(AgoraEventType type, uint32_t uid, const char* channel = "ops", int32_t value = 0)
+    {
+        AgoraEvent event;
+        event.type = type;
+        event.uid = uid;
+        event.value = value;
+        event.SetChannel(channel);
+        return event;
+    }
+
+    AgoraEvent Joined(uint32_t uid, const char* channel = "ops") { return Event(AgoraEventType::UserJoined, uid, channel); }
+    AgoraEvent Offline(uint32_t uid, const char* channel = "ops") { return Event(AgoraEventType::UserOffline, uid, channel); }
+
+    // "J5@ops" / "O5@ops" for presence events, the type number otherwise
+    std::vector<std::string> Describe(const std::vector<AgoraEvent>& events)
+    {
+        std::vector<std::string> described;
+        for (const auto& event : events) {
+            std::string prefix = event.type == AgoraEventType::UserJoined ? "J"
+                               : event.type == AgoraEventType::UserOffline ? "O"
+                               : "#" + std::to_string(static_cast<int>(event.type)) + ":";
+            described.push_back(prefix + std::to_string(event.uid) + "@" + event.channel);
+        }
+        return described;
+    }
+
+    void TestJoinAndOfflineCancel()
+    {
+        std::vector<AgoraEvent> events{ Joined(5), Offline(5) };
+        CHECK(EventBatcher::Coalesce(events) == 2 && events.empty());
+
+        // Left and came back: also nothing to tell
+        events = { Offline(5), Joined(5) };
+        CHECK(EventBatcher::Coalesce(events) == 2 && events.empty());
+
+        // Joined, left, joined: the pair cancels, the last join stands
+        events = { Joined(5), Offline(5), Joined(5) };
+        CHECK(EventBatcher::Coalesce(events) == 2);
+        CHECK((Describe(events) == std::vector<std::string>{ "J5@ops" }));
+
+        // Other uids in between keep their order
+        events = { Joined(5), Joined(6), Offline(5), Offline(7) };
+        CHECK(EventBatcher::Coalesce(events) == 2);
+        CHECK((Describe(events) == std::vector<std::string>{ "J6@ops", "O7@ops" }));
+    }
+
+    void TestDuplicatesMerge()
+    {
+        std::vector<AgoraEvent> events{ Joined(5), Joined(5), Joined(5) };
+        CHECK(EventBatcher::Coalesce(events) == 2);
+        CHECK((Describe(events) == std::vector<std::string>{ "J5@ops" }));
+
+        events = { Offline(5), Offline(5) };
+        CHECK(EventBatcher::Coalesce(events) == 1);
+        CHECK((Describe(events) == std::vector<std::string>{ "O5@ops" }));
+
+        // The duplicate goes first, then the offline cancels the join that is left
+        events = { Joined(5), Joined(5), Offline(5) };
+        CHECK(EventBatcher::Coalesce(events) == 3 && events.empty());
+
+        std::vector<AgoraEvent> none;
+        CHECK(EventBatcher::Coalesce(none) == 0 && none.empty());
+    }
+
+    void TestKeysAreScopedToChannel()
+    {
+        // Same uid in two radio channels: each channel cancels its own pair
+        std::vector<AgoraEvent> events{ Joined(5, "fire"), Offline(5, "ems"), Joined(5, "ems"), Offline(5, "fire") };
+        CHECK(EventBatcher::Coalesce(events) == 4 && events.empty());
+
+        events = { Joined(5, "fire"), Offline(5, "ems") };
+        CHECK(EventBatcher::Coalesce(events) == 0);
+        CHECK((Describe(events) == std::vector<std::string>{ "J5@fire", "O5@ems" }));
+
+        // Channel names cut at 64 bytes still key the same channel
+        std::string longName(100, 'c');
+        events = { Joined(5, longName.c_str()), Offline(5, longName.substr(0, 80).c_str()) };
+        CHECK(EventBatcher::Coalesce(events) == 2 && events.empty());
+
+        // Other event types are never merged, even for the same uid
+        events = { Event(AgoraEventType::TalkStateChanged, 0, "ops", 1), Joined(5),
+                   Event(AgoraEventType::TalkStateChanged, 0, "ops", 1), Event(AgoraEventType::Error, 5), Offline(5) };
+        CHECK(EventBatcher::Coalesce(events) == 2);
+        CHECK(events.size() == 3 && events[0].type == AgoraEventType::TalkStateChanged &&
+              events[1].type == AgoraEventType::TalkStateChanged && events[2].type == AgoraEventType::Error);
+    }
+
+    void TestFullRingCountsDrops()
+    {
+        EventBatcher batcher;
+        std::vector<std::vector<AgoraEvent>> batches;
+        std::vector<EventBatchStats> stats;
+        // Start hands over the sink; stopping the flusher again leaves flushing to the test
+        batcher.Start([&](const std::vector<AgoraEvent>& events, const EventBatchStats& batchStats) {
+            batches.push_back(events);
+            stats.push_back(batchStats);
+        });
+        batcher.Stop();
+
+        for (uint32_t i = 0; i < EventBatcher::kCapacity + 5; ++i) {
+            batcher.Push(Event(AgoraEventType::Error, i));
+        }
+        CHECK(batcher.GetDroppedCount() == 5);
+
+        batcher.Flush();
+        CHECK(batches.size() == 1 && stats.size() == 1);
+        if (batches.size() == 1) {
+            CHECK(batches[0].size() == EventBatcher::kCapacity);
+            CHECK(batches[0].front().uid == 0 && batches[0].back().uid == EventBatcher::kCapacity - 1);
+            CHECK(stats[0].dropped == 5 && stats[0].merged == 0);
+        }
+
+        // The ring has room again; the drop count was reported once
+        batcher.Push(Joined(5));
+        batcher.Push(Offline(5));
+        batcher.Push(Joined(6));
+        batcher.Flush();
+        CHECK(batches.size() == 2);
+        if (batches.size() == 2) {
+            CHECK((Describe(batches[1]) == std::vector<std::string>{ "J6@ops" }));
+            CHECK(stats[1].dropped == 0 && stats[1].merged == 2);
+        }
+        CHECK(batcher.GetDroppedCount() == 5 && batcher.GetMergedCount() == 2);
+
+        // Everything cancelled and nothing dropped: no batch at all
+        batcher.Push(Joined(7));
+        batcher.Push(Offline(7));
+        batcher.Flush();
+        batcher.Flush();
+        CHECK(batches.size() == 2 && batcher.GetMergedCount() == 4);
+
+        // A full ring of duplicates: merged down to one, the drop still reported
+        for (uint32_t i = 0; i < EventBatcher::kCapacity; ++i) batcher.Push(Joined(7));
+        batcher.Push(Joined(8));
+        batcher.Flush();
+        CHECK(batches.size() == 3);
+        if (batches.size() == 3) {
+            CHECK((Describe(batches[2]) == std::vector<std::string>{ "J7@ops" }));
+            CHECK(stats[2].dropped == 1 && stats[2].merged == EventBatcher::kCapacity - 1);
+        }
+    }
+}
+
+int main()
+{
+    TestJoinAndOfflineCancel();
+    TestDuplicatesMerge();
+    TestKeysAreScopedToChannel();
+    TestFullRingCountsDrops();
+
+    if (g_failures == 0) std::printf("EventBatcherTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
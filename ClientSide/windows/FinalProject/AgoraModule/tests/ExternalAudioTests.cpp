@@ -0,0 +1,287 @@
+// Tests for external audio mode: the SPSC frame ring (full, empty, wrap-around, a producer and a
+// consumer on two threads), and the pump between our device sides and FakeVoiceEngine, whose
+// loopback hands pulled frames back from what was pushed - device chunks that don't line up
+// with 10 ms frames, silence and drops when a side falls behind, the pipelines in the path.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/ExternalAudioTests
+#include "../AgoraCore.h"
+#include "../AudioFrameRing.h"
+#include "../AudioPipeline.h"
+#include "../ExternalAudio.h"
+#include "../FakeVoiceEngine.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kRate = 48000;
+    constexpr int kFrame = kRate / 100;
+
+    // An initialized fake in external mode (mono capture, stereo playback unless told otherwise)
+    struct Engine
+    {
+        explicit Engine(int captureChannels = 1, int playbackChannels = 2)
+        {
+            fake.Initialize("app", &events);
+            fake.SetExternalAudio(true, kRate, captureChannels, playbackChannels);
+        }
+
+        AgoraEventHandler events;
+        FakeVoiceEngine fake;
+    };
+
+    ExternalAudioConfig Unpaced(int ringFrames = 8)
+    {
+        ExternalAudioConfig config;
+        config.ringFrames = ringFrames;
+        config.paced = false;
+        return config;
+    }
+
+    void TestRingFullEmptyAndWrap()
+    {
+        AudioFrameRing ring(3, 4);
+        CHECK(ring.GetCapacity() == 3 && ring.GetSamplesPerFrame() == 4);
+
+        int16_t frame[4] = {};
+        CHECK(!ring.Read(frame));
+        CHECK(ring.GetUnderruns() == 1);
+
+        for (int16_t i = 0; i < 3; ++i) {
+            std::fill(frame, frame + 4, i);
+            CHECK(ring.Write(frame));
+        }
+        CHECK(ring.GetFill() == 3);
+        CHECK(!ring.Write(frame));
+        CHECK(ring.BeginWrite() == nullptr);
+        CHECK(ring.GetOverruns() == 2);
+
+        // Many times around: every frame comes out once, in order, whole
+        int16_t next = 0, expected = 0;
+        for (int round = 0; round < 100; ++round) {
+            CHECK(ring.Read(frame));
+            CHECK(frame[0] == expected && frame[3] == expected);
+            ++expected;
+            std::fill(frame, frame + 4, static_cast<int16_t>(next + 3));
+            CHECK(ring.Write(frame));
+            ++next;
+        }
+        CHECK(ring.GetFill() == 3);
+        CHECK(ring.GetWritten() == 103);
+
+        // In place: a slot stays the reader's until released
+        const int16_t* slot = ring.BeginRead();
+        CHECK(slot && slot[0] == expected);
+        CHECK(ring.GetFill() == 3);
+        ring.ReleaseRead();
+        CHECK(ring.GetFill() == 2);
+
+        ring.Reset();
+        CHECK(ring.GetFill() == 0 && ring.GetOverruns() == 0 && ring.GetUnderruns() == 0);
+    }
+
+    void TestRingAcrossThreads()
+    {
+        // Each frame carries its sequence number in every sample; the consumer sees all of them,
+        // in order and never torn, while the producer retries whenever the ring is full
+        constexpr int kFrames = 200000;
+        constexpr size_t kSamples = 64;
+        AudioFrameRing ring(4, kSamples);
+
+        std::thread producer([&ring]() {
+            for (int sequence = 0; sequence < kFrames;) {
+                int16_t* slot = ring.BeginWrite();
+                if (!slot) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::fill(slot, slot + kSamples, static_cast<int16_t>(sequence & 0x7FFF));
+                ring.CommitWrite();
+                ++sequence;
+            }
+        });
+
+        int received = 0;
+        bool ordered = true, whole = true;
+        while (received < kFrames) {
+            const int16_t* slot = ring.BeginRead();
+            if (!slot) {
+                std::this_thread::yield();
+                continue;
+            }
+            const int16_t expected = static_cast<int16_t>(received & 0x7FFF);
+            ordered = ordered && slot[0] == expected;
+            whole = whole && std::all_of(slot, slot + kSamples, [expected](int16_t s) { return s == expected; });
+            ring.ReleaseRead();
+            ++received;
+        }
+        producer.join();
+
+        CHECK(ordered);
+        CHECK(whole);
+        CHECK(ring.GetWritten() == static_cast<uint64_t>(kFrames));
+        CHECK(ring.GetFill() == 0);
+    }
+
+    void TestDeviceChunksComeBackBitExact()
+    {
+        Engine engine;
+        ExternalAudio audio;
+        audio.Configure(Unpaced());
+        audio.Start(&engine.fake, nullptr, nullptr);
+        CHECK(audio.IsRunning());
+
+        // A capture device with 137-frame periods and a renderer with 91-frame ones, both running
+        // at the pump's pace on average; the loopback turns every pushed frame around in the same step
+        constexpr int kSteps = 200;
+        std::vector<int16_t> input(kSteps * kFrame);
+        for (size_t i = 0; i < input.size(); ++i) input[i] = static_cast<int16_t>((i * 7919) % 20000 - 10000);
+
+        std::vector<int16_t> output;
+        std::vector<int16_t> chunk(91 * 2);
+        size_t written = 0;
+        int readable = 0;
+        for (int step = 0; step < kSteps; ++step) {
+            while (written < static_cast<size_t>(step + 1) * kFrame) {
+                int frames = static_cast<int>(std::min<size_t>(137, input.size() - written));
+                CHECK(audio.WriteCapture(input.data() + written, frames) == frames);
+                written += static_cast<size_t>(frames);
+            }
+            audio.Pump();
+            readable += kFrame;
+            while (readable >= 91) {
+                CHECK(audio.ReadPlayback(chunk.data(), 91) == 91);
+                output.insert(output.end(), chunk.begin(), chunk.end());
+                readable -= 91;
+            }
+        }
+
+        // Mono in, stereo out: both channels carry the input, sample for sample
+        bool exact = true;
+        const size_t frames = output.size() / 2;
+        for (size_t i = 0; i < frames; ++i) {
+            exact = exact && output[2 * i] == input[i] && output[2 * i + 1] == input[i];
+        }
+        CHECK(frames > static_cast<size_t>((kSteps - 1) * kFrame));
+        CHECK(exact);
+
+        ExternalAudioStats stats = audio.GetStats();
+        CHECK(stats.pushedFrames == kSteps && stats.pulledFrames == kSteps);
+        CHECK(stats.captureOverruns == 0 && stats.playbackOverruns == 0);
+        CHECK(engine.fake.GetPushedFrames() == kSteps);
+        audio.Stop();
+        CHECK(!audio.IsRunning());
+    }
+
+    void TestSidesFallingBehind()
+    {
+        Engine engine;
+        ExternalAudio audio;
+        audio.Configure(Unpaced(4));
+        audio.Start(&engine.fake, nullptr, nullptr);
+
+        // Nothing captured: silence goes out anyway, so the far side keeps hearing a steady stream
+        std::vector<int16_t> stereo(kFrame * 2, 123);
+        audio.Pump();
+        CHECK(audio.GetStats().captureUnderruns == 1 && audio.GetStats().pushedFrames == 1);
+        CHECK(audio.ReadPlayback(stereo.data(), kFrame) == kFrame);
+        CHECK(std::all_of(stereo.begin(), stereo.end(), [](int16_t s) { return s == 0; }));
+
+        // The renderer stops reading: the ring fills, then pulled frames are dropped, never queued
+        for (int i = 0; i < 10; ++i) audio.Pump();
+        ExternalAudioStats stats = audio.GetStats();
+        CHECK(stats.pulledFrames == 11);
+        CHECK(stats.playbackOverruns == 6);
+
+        // ...and drains back to silence, which still fills the renderer's whole period
+        for (int i = 0; i < 4; ++i) CHECK(audio.ReadPlayback(stereo.data(), kFrame) == kFrame);
+        std::fill(stereo.begin(), stereo.end(), static_cast<int16_t>(123));
+        CHECK(audio.ReadPlayback(stereo.data(), kFrame) == 0);
+        CHECK(std::all_of(stereo.begin(), stereo.end(), [](int16_t s) { return s == 0; }));
+        CHECK(audio.GetStats().playbackUnderruns >= 1);
+
+        // A capture device running ahead loses what doesn't fit, not what is queued
+        std::vector<int16_t> mono(kFrame * 6, 1000);
+        CHECK(audio.WriteCapture(mono.data(), kFrame * 6) == kFrame * 4);
+        CHECK(audio.GetStats().captureOverruns == 1);
+    }
+
+    void TestPipelinesRunInThePump()
+    {
+        Engine engine(1, 1);
+        AudioPipelineConfig halve;
+        halve.gainDb = -6.0206f;
+        halve.highPassEnabled = false;
+        halve.limiterEnabled = false;
+        AudioPipelineConfig neutral = halve;
+        neutral.gainDb = 0.0f;
+        AudioPipeline capture, playback;
+        capture.SetConfig(halve);
+        playback.SetConfig(neutral);
+
+        ExternalAudio audio;
+        ExternalAudioConfig config = Unpaced();
+        config.playbackChannels = 1;
+        audio.Configure(config);
+        audio.Start(&engine.fake, &capture, &playback);
+
+        std::vector<int16_t> frame(kFrame, 8000);
+        audio.WriteCapture(frame.data(), kFrame);
+        audio.Pump();
+        CHECK(audio.ReadPlayback(frame.data(), kFrame) == kFrame);
+        CHECK(std::abs(frame[kFrame / 2] - 4000) <= 2);
+        CHECK(capture.GetProcessedFrames() == 1 && playback.GetProcessedFrames() == 1);
+    }
+
+    void TestEngineChecksTheFormat()
+    {
+        AgoraEventHandler events;
+        FakeVoiceEngine fake;
+        std::vector<int16_t> frame(kFrame * 2, 0);
+        CHECK(fake.SetExternalAudio(true, kRate, 1, 2) == FakeVoiceEngine::kErrNotInitialized);
+
+        fake.Initialize("app", &events);
+        CHECK(fake.PushAudioFrame(frame.data(), kFrame, 1, kRate) == FakeVoiceEngine::kErrNotInitialized);
+        CHECK(fake.SetExternalAudio(true, 96000, 1, 2) == FakeVoiceEngine::kErrInvalidArgument);
+        CHECK(fake.SetExternalAudio(true, kRate, 1, 2) == 0);
+        CHECK(fake.IsExternalAudio());
+        CHECK(!fake.IsCapturing());
+
+        CHECK(fake.PushAudioFrame(frame.data(), kFrame, 2, kRate) == FakeVoiceEngine::kErrInvalidArgument);
+        CHECK(fake.PushAudioFrame(frame.data(), kFrame / 2, 1, kRate) == FakeVoiceEngine::kErrInvalidArgument);
+        CHECK(fake.PullAudioFrame(frame.data(), kFrame, 2, 16000) == FakeVoiceEngine::kErrInvalidArgument);
+        CHECK(fake.PushAudioFrame(frame.data(), kFrame, 1, kRate) == 0);
+        CHECK(fake.PullAudioFrame(frame.data(), kFrame, 2, kRate) == 0);
+
+        CHECK(fake.SetExternalAudio(false, 0, 0, 0) == 0);
+        CHECK(!fake.IsExternalAudio());
+        CHECK(fake.PullAudioFrame(frame.data(), kFrame, 2, kRate) == FakeVoiceEngine::kErrNotInitialized);
+    }
+}
+
+int main()
+{
+    TestRingFullEmptyAndWrap();
+    TestRingAcrossThreads();
+    TestDeviceChunksComeBackBitExact();
+    TestSidesFallingBehind();
+    TestPipelinesRunInThePump();
+    TestEngineChecksTheFormat();
+
+    if (g_failures == 0) std::printf("ExternalAudioTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,570 @@
+// Tests for push-to-talk floor control: the FloorControl codec, then clients exchanging floor
+// messages over a simulated lobby (ordered per sender, random latency, simulated time) - busy
+// denials, preemption, leases, lost holders and a contention run that checks after every
+// single delivery that no radio ever has two holders.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/FloorControlTests
+#include "../FloorControl.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kTickMs = 20;
+
+    // Every client on one lobby: a message reaches every other client, in order per sender
+    class Lobby
+    {
+    public:
+        struct Client
+        {
+            std::string user;
+            FloorControl floor;
+            std::vector<FloorChange> changes;
+            uint64_t nextTickMs = 0;
+            bool dead = false; // crashed: neither hears nor says anything any more
+        };
+
+        Lobby(int minLatencyMs, int maxLatencyMs, uint32_t seed = 1)
+            : m_minLatencyMs(minLatencyMs), m_maxLatencyMs(maxLatencyMs), m_random(seed)
+        {
+        }
+
+        size_t Add(const std::string& user, const FloorPolicy& policy = FloorPolicy{})
+        {
+            auto client = std::make_unique<Client>();
+            client->user = user;
+            client->floor.SetPolicy(policy);
+            client->nextTickMs = m_nowMs + kTickMs;
+            FloorOutput out;
+            client->floor.SetLocalUser(user, m_nowMs, out);
+            m_clients.push_back(std::move(client));
+            Apply(m_clients.size() - 1, out);
+            return m_clients.size() - 1;
+        }
+
+        Client& operator[](size_t index) { return *m_clients[index]; }
+        size_t Size() const { return m_clients.size(); }
+        uint64_t Now() const { return m_nowMs; }
+
+        void Join(size_t index, const std::string& channel) { Do(index, [&](FloorOutput& out) { m_clients[index]->floor.Join(channel, m_nowMs, out); }); }
+        void Leave(size_t index, const std::string& channel) { Do(index, [&](FloorOutput& out) { m_clients[index]->floor.Leave(channel, m_nowMs, out); }); }
+        void Request(size_t index, const std::string& channel, int priority) { Do(index, [&](FloorOutput& out) { m_clients[index]->floor.Request(channel, priority, m_nowMs, out); }); }
+        void Release(size_t index, const std::string& channel) { Do(index, [&](FloorOutput& out) { m_clients[index]->floor.Release(channel, m_nowMs, out); }); }
+
+        // Runs deliveries and ticks in time order; the check runs after each of them
+        void RunFor(int milliseconds, const std::function<void()>& check = nullptr)
+        {
+            uint64_t endMs = m_nowMs + static_cast<uint64_t>(milliseconds);
+            for (;;) {
+                size_t ticker = m_clients.size();
+                uint64_t nextMs = endMs + 1;
+                for (size_t i = 0; i < m_clients.size(); ++i) {
+                    if (!m_clients[i]->dead && m_clients[i]->nextTickMs < nextMs) {
+                        nextMs = m_clients[i]->nextTickMs;
+                        ticker = i;
+                    }
+                }
+                bool delivery = !m_deliveries.empty() && m_deliveries.top().atMs <= nextMs;
+                if (delivery) nextMs = m_deliveries.top().atMs;
+                if (nextMs > endMs) break;
+
+                m_nowMs = nextMs;
+                if (delivery) {
+                    Delivery next = m_deliveries.top();
+                    m_deliveries.pop();
+                    Client& client = *m_clients[next.to];
+                    if (client.dead) continue;
+                    FloorOutput out;
+                    client.floor.OnMessage(next.message.data(), next.message.size(), m_nowMs, out);
+                    Apply(next.to, out);
+                } else {
+                    Client& client = *m_clients[ticker];
+                    client.nextTickMs += kTickMs;
+                    FloorOutput out;
+                    client.floor.Tick(m_nowMs, out);
+                    Apply(ticker, out);
+                }
+                if (check) check();
+            }
+            m_nowMs = endMs;
+        }
+
+        int Holders(const std::string& channel) const
+        {
+            int holders = 0;
+            for (const auto& client : m_clients) {
+                if (!client->dead && client->floor.Holds(channel)) ++holders;
+            }
+            return holders;
+        }
+
+        size_t MessagesSent() const { return m_messagesSent; }
+
+    private:
+        struct Delivery
+        {
+            uint64_t atMs;
+            uint64_t order;
+            size_t to;
+            std::string message;
+            bool operator>(const Delivery& other) const { return atMs != other.atMs ? atMs > other.atMs : order > other.order; }
+        };
+
+        template <typename Fn>
+        void Do(size_t index, Fn fn)
+        {
+            FloorOutput out;
+            fn(out);
+            Apply(index, out);
+        }
+
+        void Apply(size_t from, const FloorOutput& out)
+        {
+            Client& sender = *m_clients[from];
+            sender.changes.insert(sender.changes.end(), out.changes.begin(), out.changes.end());
+            std::uniform_int_distribution<int> latency(m_minLatencyMs, m_maxLatencyMs);
+            for (const std::string& message : out.messages) {
+                ++m_messagesSent;
+                for (size_t to = 0; to < m_clients.size(); ++to) {
+                    if (to == from) continue;
+                    // An ordered stream: never ahead of the sender's previous message to the same client
+                    uint64_t& last = m_lastDelivery[{ from, to }];
+                    last = std::max(last, m_nowMs + static_cast<uint64_t>(latency(m_random)));
+                    m_deliveries.push(Delivery{ last, m_order++, to, message });
+                }
+            }
+        }
+
+        int m_minLatencyMs;
+        int m_maxLatencyMs;
+        std::mt19937 m_random;
+        uint64_t m_nowMs = 1000;
+        uint64_t m_order = 0;
+        size_t m_messagesSent = 0;
+        std::vector<std::unique_ptr<Client>> m_clients;
+        std::map<std::pair<size_t, size_t>, uint64_t> m_lastDelivery;
+        std::priority_queue<Delivery, std::vector<Delivery>, std::greater<Delivery>> m_deliveries;
+    };
+
+    bool HasChange(const Lobby::Client& client, FloorState state, FloorReason reason)
+    {
+        return std::any_of(client.changes.begin(), client.changes.end(), [&](const FloorChange& change) {
+            return change.state == state && change.reason == reason;
+        });
+    }
+
+    void TestEncodeDecodeRoundTrip()
+    {
+        FloorMessage message;
+        message.type = FloorMessageType::Grant;
+        message.channelName = "radio|1 100%";
+        message.fromUser = "12";
+        message.holder = "7";
+        message.priority = 2;
+        message.epoch = 18446744073709551615ull;
+        message.requestId = 4000000000u;
+
+        std::string encoded = FloorControl::Encode(message);
+        CHECK(encoded.rfind("fl1|grant|", 0) == 0);
+        CHECK(FloorControl::IsFloorMessage(encoded.data(), encoded.size()));
+
+        FloorMessage decoded;
+        CHECK(FloorControl::Decode(encoded.data(), encoded.size(), decoded));
+        CHECK(decoded.type == FloorMessageType::Grant);
+        CHECK(decoded.channelName == message.channelName);
+        CHECK(decoded.fromUser == "12");
+        CHECK(decoded.toUser.empty());
+        CHECK(decoded.holder == "7");
+        CHECK(decoded.priority == 2);
+        CHECK(decoded.epoch == message.epoch);
+        CHECK(decoded.requestId == message.requestId);
+    }
+
+    void TestMalformedMessagesAreRejected()
+    {
+        const char* bad[] = {
+            "",
+            "cs1|invite|1|5|17|a|b|c",               // a call signal, not ours
+            "fl1|grant|r1|12||7|2|1",                // a field short
+            "fl1|grant|r1|12||7|2|1|1|extra",        // one too many
+            "fl1|shout|r1|12||7|2|1|1",              // unknown type
+            "fl1|grant||12||7|2|1|1",                // no channel
+            "fl1|grant|r1|||7|2|1|1",                // no sender
+            "fl1|grant|r1|12||7|10|1|1",             // priority out of range
+            "fl1|grant|r1|12||7|2|18446744073709551616|1", // epoch overflows
+            "fl1|grant|r1|12||7|2|1|4294967296",     // request id overflows
+            "fl1|grant|r1|12||7|-1|1|1",
+            "fl1|grant|r%zz|12||7|2|1|1",            // broken escape
+        };
+        for (const char* message : bad) {
+            FloorMessage decoded;
+            CHECK(!FloorControl::Decode(message, std::string(message).size(), decoded));
+        }
+
+        std::string huge = "fl1|hello|" + std::string(FloorControl::kMaxMessageBytes, 'x') + "|1||||0|0|0";
+        FloorMessage decoded;
+        CHECK(!FloorControl::Decode(huge.data(), huge.size(), decoded));
+
+        // Garbage never changes anything
+        FloorControl floor;
+        FloorOutput out;
+        floor.SetLocalUser("1", 0, out);
+        floor.Join("r1", 0, out);
+        out = FloorOutput{};
+        for (const char* message : bad) floor.OnMessage(message, std::string(message).size(), 10, out);
+        CHECK(out.messages.empty() && out.changes.empty());
+    }
+
+    void TestLoneClientGrantsItselfOnceSettled()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        lobby.Join(a, "r1");
+        lobby.Request(a, "r1", 0);
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Requesting); // still listening for the others
+
+        lobby.RunFor(400);
+        CHECK(lobby[a].floor.Holds("r1"));
+        CHECK(HasChange(lobby[a], FloorState::Granted, FloorReason::Granted));
+        CHECK(lobby[a].changes.back().waitedMs >= 300);
+
+        // A second press while holding just confirms it
+        lobby.Request(a, "r1", 0);
+        CHECK(lobby[a].changes.back().state == FloorState::Granted);
+
+        lobby.Release(a, "r1");
+        CHECK(!lobby[a].floor.Holds("r1"));
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle);
+    }
+
+    void TestSecondTalkerIsToldBusy()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        lobby.Join(a, "r1");
+        lobby.Join(b, "r1");
+        lobby.RunFor(500);
+        CHECK(lobby[a].floor.GetArbiter("r1") == "1");
+        CHECK(lobby[b].floor.GetArbiter("r1") == "1");
+
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(lobby[b].floor.Holds("r1"));
+        CHECK(lobby[b].changes.back().waitedMs == 20); // to the arbiter and back
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Taken);
+        CHECK(lobby[a].floor.GetHolder("r1") == "2");
+
+        // Same priority: the arbiter itself is turned away too
+        lobby.Request(a, "r1", 0);
+        CHECK(HasChange(lobby[a], FloorState::Taken, FloorReason::Busy));
+        CHECK(lobby[b].floor.Holds("r1"));
+
+        lobby.Release(b, "r1");
+        lobby.RunFor(100);
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle);
+        CHECK(lobby[b].floor.GetState("r1") == FloorState::Idle);
+        CHECK(HasChange(lobby[a], FloorState::Idle, FloorReason::Released));
+    }
+
+    void TestHigherPriorityPreemptsAfterTheHolderLetsGo()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        size_t c = lobby.Add("3");
+        for (size_t i : { a, b, c }) lobby.Join(i, "r1");
+        lobby.RunFor(500);
+
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(lobby[b].floor.Holds("r1"));
+
+        // Never two holders, not even for one delivery
+        bool overlapped = false;
+        lobby.Request(c, "r1", 2);
+        lobby.RunFor(200, [&]() { overlapped = overlapped || lobby.Holders("r1") > 1; });
+        CHECK(!overlapped);
+        CHECK(lobby[c].floor.Holds("r1"));
+        CHECK(!lobby[b].floor.Holds("r1"));
+        CHECK(HasChange(lobby[b], FloorState::Idle, FloorReason::Preempted));
+        CHECK(lobby[c].changes.back().waitedMs == 40); // request, revoke, release, grant
+        CHECK(lobby[a].floor.GetHolder("r1") == "3");
+
+        // Lower priority than the new holder: busy
+        lobby.Request(b, "r1", 1);
+        lobby.RunFor(100);
+        CHECK(HasChange(lobby[b], FloorState::Taken, FloorReason::Busy));
+
+        // The arbiter preempts itself without a revoke round trip
+        lobby.Release(c, "r1");
+        lobby.RunFor(50);
+        lobby.Request(a, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(lobby[a].floor.Holds("r1"));
+        lobby.Request(c, "r1", 1);
+        lobby.RunFor(100, [&]() { overlapped = overlapped || lobby.Holders("r1") > 1; });
+        CHECK(!overlapped);
+        CHECK(lobby[c].floor.Holds("r1"));
+        CHECK(HasChange(lobby[a], FloorState::Idle, FloorReason::Preempted));
+        CHECK(lobby[a].floor.GetHolder("r1") == "3");
+    }
+
+    void TestLeaseRunsOut()
+    {
+        FloorPolicy policy;
+        policy.maxTalkMs = 1000;
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1", policy);
+        size_t b = lobby.Add("2", policy);
+        lobby.Join(a, "r1");
+        lobby.Join(b, "r1");
+        lobby.RunFor(500);
+
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(900);
+        CHECK(lobby[b].floor.Holds("r1"));
+        lobby.RunFor(200);
+        CHECK(!lobby[b].floor.Holds("r1"));
+        CHECK(HasChange(lobby[b], FloorState::Idle, FloorReason::Expired));
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle); // the holder's release got there first
+
+        lobby.Request(a, "r1", 0);
+        lobby.RunFor(50);
+        CHECK(lobby[a].floor.Holds("r1"));
+    }
+
+    void TestLostHolderFreesTheFloor()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        size_t c = lobby.Add("3");
+        for (size_t i : { a, b, c }) lobby.Join(i, "r1");
+        lobby.RunFor(500);
+
+        // Leaving says bye: the floor is free at once
+        lobby.Request(c, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(lobby[c].floor.Holds("r1"));
+        lobby.Leave(c, "r1");
+        lobby.RunFor(50);
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle);
+        CHECK(lobby[b].floor.GetState("r1") == FloorState::Idle);
+
+        // Crashing says nothing: the floor is free after the member timeout
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(lobby[b].floor.Holds("r1"));
+        lobby[b].dead = true;
+        lobby.RunFor(3000);
+        CHECK(lobby[a].floor.GetHolder("r1") == "2");
+        lobby.RunFor(1000);
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle);
+        CHECK(HasChange(lobby[a], FloorState::Idle, FloorReason::HolderLost));
+    }
+
+    void TestRequestToAVanishedArbiterGivesUp()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        lobby.Join(a, "r1");
+        lobby.Join(b, "r1");
+        lobby.RunFor(500);
+
+        lobby[a].dead = true;
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(1400);
+        CHECK(lobby[b].floor.GetState("r1") == FloorState::Requesting);
+        lobby.RunFor(200);
+        CHECK(HasChange(lobby[b], FloorState::Idle, FloorReason::NoAnswer));
+
+        // Once the arbiter has timed out, the next one in line takes over
+        lobby.RunFor(3000);
+        CHECK(lobby[b].floor.GetArbiter("r1") == "2");
+        lobby.Request(b, "r1", 0);
+        CHECK(lobby[b].floor.Holds("r1"));
+    }
+
+    void TestTapEndsReleased()
+    {
+        Lobby lobby(30, 30);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        lobby.Join(a, "r1");
+        lobby.Join(b, "r1");
+        lobby.RunFor(500);
+
+        // Released while the grant is on its way: handed straight back
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(40);
+        lobby.Release(b, "r1");
+        lobby.RunFor(200);
+        CHECK(!lobby[b].floor.Holds("r1"));
+        CHECK(lobby[a].floor.GetState("r1") == FloorState::Idle);
+        CHECK(lobby[b].floor.GetState("r1") == FloorState::Idle);
+        CHECK(!HasChange(lobby[b], FloorState::Granted, FloorReason::Granted));
+    }
+
+    void TestLateJoinerLearnsTheHolder()
+    {
+        Lobby lobby(10, 10);
+        size_t a = lobby.Add("1");
+        size_t b = lobby.Add("2");
+        lobby.Join(a, "r1");
+        lobby.Join(b, "r1");
+        lobby.RunFor(500);
+        lobby.Request(b, "r1", 0);
+        lobby.RunFor(100);
+
+        // A new member with the lowest id hears hellos before it arbitrates anything
+        size_t z = lobby.Add("0");
+        lobby.Join(z, "r1");
+        lobby.RunFor(100);
+        CHECK(lobby[z].floor.GetState("r1") == FloorState::Taken);
+        CHECK(lobby[z].floor.GetHolder("r1") == "2");
+        lobby.RunFor(400);
+        CHECK(lobby[a].floor.GetArbiter("r1") == "0");
+
+        lobby.Request(z, "r1", 0);
+        lobby.RunFor(100);
+        CHECK(!lobby[z].floor.Holds("r1"));
+        CHECK(HasChange(lobby[z], FloorState::Taken, FloorReason::Busy));
+        CHECK(lobby[b].floor.Holds("r1"));
+    }
+
+    void TestSignOutLetsEveryRadioGo()
+    {
+        FloorControl floor;
+        FloorOutput out;
+        floor.SetLocalUser("1", 0, out);
+        floor.Join("r1", 0, out);
+        floor.Join("r2", 0, out);
+        floor.Request("r1", 0, 400, out);
+        floor.Tick(400, out);
+        CHECK(floor.Holds("r1"));
+
+        out = FloorOutput{};
+        floor.SetLocalUser("9", 500, out);
+        CHECK(floor.GetChannels().empty());
+        CHECK(!floor.Holds("r1"));
+        CHECK(out.changes.size() == 1 && out.changes[0].reason == FloorReason::Released);
+        size_t byes = std::count_if(out.messages.begin(), out.messages.end(),
+                                    [](const std::string& message) { return message.rfind("fl1|bye|", 0) == 0; });
+        size_t releases = std::count_if(out.messages.begin(), out.messages.end(),
+                                        [](const std::string& message) { return message.rfind("fl1|release|", 0) == 0; });
+        CHECK(byes == 2);
+        CHECK(releases == 1);
+    }
+
+    // Six consoles keying two radios at random, priorities 0-2, 5-60 ms one-way latency
+    void TestContentionNeverGrantsTwice()
+    {
+        const char* radios[] = { "r1", "r2" };
+        Lobby lobby(5, 60, 7);
+        std::mt19937 random(11);
+        for (int i = 0; i < 6; ++i) {
+            size_t client = lobby.Add(std::to_string(i + 1));
+            lobby.Join(client, "r1");
+            if (i % 2 == 0) lobby.Join(client, "r2");
+        }
+        lobby.RunFor(1000);
+
+        struct Console { std::string radio; uint64_t releaseAtMs = 0; uint64_t nextPressMs = 0; };
+        std::vector<Console> consoles(lobby.Size());
+        std::exponential_distribution<double> pause(1.0 / 700.0);
+        std::uniform_int_distribution<int> talk(200, 1500);
+        std::uniform_int_distribution<int> priority(0, 2);
+        for (auto& console : consoles) console.nextPressMs = lobby.Now() + static_cast<uint64_t>(pause(random));
+
+        bool overlapped = false;
+        auto check = [&]() {
+            for (const char* radio : radios) overlapped = overlapped || lobby.Holders(radio) > 1;
+        };
+
+        const int kRunMs = 120000;
+        for (int elapsed = 0; elapsed < kRunMs; elapsed += 10) {
+            for (size_t i = 0; i < consoles.size(); ++i) {
+                Console& console = consoles[i];
+                if (!console.radio.empty() && lobby.Now() >= console.releaseAtMs) {
+                    lobby.Release(i, console.radio);
+                    console.radio.clear();
+                    console.nextPressMs = lobby.Now() + static_cast<uint64_t>(pause(random));
+                } else if (console.radio.empty() && lobby.Now() >= console.nextPressMs) {
+                    console.radio = (i % 2 == 0 && random() % 2) ? "r2" : "r1";
+                    console.releaseAtMs = lobby.Now() + static_cast<uint64_t>(talk(random));
+                    lobby.Request(i, console.radio, priority(random));
+                }
+                check();
+            }
+            lobby.RunFor(10, check);
+        }
+        CHECK(!overlapped);
+
+        std::vector<uint64_t> waits;
+        size_t busy = 0, preempted = 0, noAnswer = 0, anonymous = 0;
+        for (size_t i = 0; i < lobby.Size(); ++i) {
+            for (const FloorChange& change : lobby[i].changes) {
+                if (change.reason == FloorReason::Granted && change.state == FloorState::Granted) waits.push_back(change.waitedMs);
+                if (change.reason == FloorReason::Busy) ++busy;
+                if (change.reason == FloorReason::Preempted) ++preempted;
+                if (change.reason == FloorReason::NoAnswer) ++noAnswer;
+                if (change.state == FloorState::Taken && change.holder.empty()) ++anonymous;
+            }
+        }
+        CHECK(waits.size() > 100);
+        CHECK(busy > 0);      // it really was contended
+        CHECK(preempted > 0);
+        CHECK(noAnswer == 0); // nothing lost, so the arbiter always answers
+        CHECK(anonymous == 0);
+
+        std::sort(waits.begin(), waits.end());
+        uint64_t p50 = waits.empty() ? 0 : waits[waits.size() / 2];
+        uint64_t p95 = waits.empty() ? 0 : waits[waits.size() * 95 / 100];
+        CHECK(p95 < 500);
+        std::printf("contention: %zu grants, %zu busy, %zu preempted, %zu messages, grant wait p50 %llu ms p95 %llu ms\n",
+                    waits.size(), busy, preempted, lobby.MessagesSent(),
+                    static_cast<unsigned long long>(p50), static_cast<unsigned long long>(p95));
+    }
+}
+
+int main()
+{
+    TestEncodeDecodeRoundTrip();
+    TestMalformedMessagesAreRejected();
+    TestLoneClientGrantsItselfOnceSettled();
+    TestSecondTalkerIsToldBusy();
+    TestHigherPriorityPreemptsAfterTheHolderLetsGo();
+    TestLeaseRunsOut();
+    TestLostHolderFreesTheFloor();
+    TestRequestToAVanishedArbiterGivesUp();
+    TestTapEndsReleased();
+    TestLateJoinerLearnsTheHolder();
+    TestSignOutLetsEveryRadioGo();
+    TestContentionNeverGrantsTwice();
+
+    if (g_failures == 0) std::printf("FloorControlTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
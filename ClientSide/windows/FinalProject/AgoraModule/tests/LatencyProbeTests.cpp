@@ -0,0 +1,323 @@
+// Tests for the latency probe: the correlation detector on synthetic recordings (known delays,
+// fractional delays, noise, inverted polarity, reflections, nothing there at all), the test
+// signals themselves, and whole probes through a simulated audio loop - 48 kHz frames, a delay
+// line between the inject and listen sides and a clock that moves 10 ms per frame.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/LatencyProbeTests
+#include "../LatencyProbe.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kRate = CorrelationDetector::kSampleRate;
+
+    // reference scaled by gain, starting delay samples into length samples of gaussian noise
+    std::vector<float> Recording(const std::vector<float>& reference, size_t length, double delay, float gain,
+                                 float noiseRms, uint32_t seed = 7)
+    {
+        std::mt19937 random(seed);
+        std::normal_distribution<float> noise(0.0f, noiseRms);
+        std::vector<float> recording(length);
+        for (float& sample : recording) sample = noiseRms > 0.0f ? noise(random) : 0.0f;
+
+        // Linear interpolation puts the copy between samples for fractional delays
+        for (size_t i = 0; i < length; ++i) {
+            double position = static_cast<double>(i) - delay;
+            if (position < 0.0 || position > static_cast<double>(reference.size() - 1)) continue;
+            size_t index = static_cast<size_t>(position);
+            double fraction = position - static_cast<double>(index);
+            float next = index + 1 < reference.size() ? reference[index + 1] : 0.0f;
+            recording[i] += gain * static_cast<float>(reference[index] * (1.0 - fraction) + next * fraction);
+        }
+        return recording;
+    }
+
+    void TestMlsIsMaximumLength()
+    {
+        for (int order : { 4, 7, 10, 12 }) {
+            std::vector<float> mls = CorrelationDetector::MakeMls(order, 1);
+            const size_t chips = (size_t{ 1 } << order) - 1;
+            CHECK(mls.size() == chips);
+
+            // One more +1 than -1, and a periodic autocorrelation of -1 at every shift
+            double sum = 0.0;
+            for (float chip : mls) sum += chip;
+            CHECK(sum == 1.0);
+            bool flat = true;
+            for (size_t shift = 1; shift < chips && flat; ++shift) {
+                double correlation = 0.0;
+                for (size_t i = 0; i < chips; ++i) correlation += mls[i] * mls[(i + shift) % chips];
+                flat = correlation == -1.0;
+            }
+            CHECK(flat);
+        }
+        CHECK(CorrelationDetector::MakeMls(10, 2).size() == 2046);
+    }
+
+    void TestChirpIsTaperedAndBounded()
+    {
+        std::vector<float> chirp = CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f);
+        CHECK(chirp.size() == 1600);
+        float peak = 0.0f;
+        for (float sample : chirp) peak = std::max(peak, std::fabs(sample));
+        CHECK(peak <= 1.0f && peak > 0.99f);
+        CHECK(std::fabs(chirp.front()) < 1e-6f && std::fabs(chirp.back()) < 0.01f);
+    }
+
+    void TestFindsKnownDelay()
+    {
+        for (bool mls : { false, true }) {
+            std::vector<float> reference = mls ? CorrelationDetector::MakeMls(10, 2)
+                                               : CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f);
+            CorrelationDetector detector(reference);
+            for (size_t delay : { size_t{ 0 }, size_t{ 1 }, size_t{ 4321 }, size_t{ 16000 - 2046 - 1 } }) {
+                std::vector<float> recording = Recording(reference, 16000, static_cast<double>(delay), 0.3f, 0.01f);
+                CorrelationDetector::Match match = detector.Find(recording.data(), recording.size());
+                CHECK(match.found);
+                CHECK(std::fabs(match.offset - static_cast<double>(delay)) < 0.2);
+                CHECK(match.score > 0.9f);
+            }
+        }
+    }
+
+    void TestFractionalDelay()
+    {
+        std::vector<float> reference = CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f);
+        CorrelationDetector detector(reference);
+        double worst = 0.0;
+        for (double delay : { 800.25, 800.5, 800.75, 1234.4 }) {
+            std::vector<float> recording = Recording(reference, 8000, delay, 0.5f, 0.0f);
+            CorrelationDetector::Match match = detector.Find(recording.data(), recording.size());
+            CHECK(match.found);
+            worst = std::max(worst, std::fabs(match.offset - delay));
+        }
+        // A quarter sample is 16 microseconds
+        CHECK(worst < 0.25);
+        std::printf("fractional delays: worst error %.3f samples\n", worst);
+    }
+
+    void TestNoisyAndInverted()
+    {
+        // Same power as the noise in the band the signal covers, upside down
+        for (bool mls : { false, true }) {
+            std::vector<float> reference = mls ? CorrelationDetector::MakeMls(10, 2)
+                                               : CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f);
+            CorrelationDetector detector(reference);
+            std::vector<float> recording = Recording(reference, 16000, 5000.0, -0.1f, 0.1f, 11);
+            CorrelationDetector::Match match = detector.Find(recording.data(), recording.size());
+            CHECK(match.found);
+            CHECK(std::fabs(match.offset - 5000.0) < 1.0);
+            std::printf("%s at 0 dB SNR, inverted: score %.2f, peak/sidelobe %.1f\n", mls ? "mls" : "chirp",
+                        match.score, match.peakToSidelobe);
+        }
+    }
+
+    void TestNothingThereIsNotFound()
+    {
+        CorrelationDetector detector(CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f));
+
+        std::vector<float> silence(16000, 0.0f);
+        CHECK(!detector.Find(silence.data(), silence.size()).found);
+
+        std::vector<float> noise = Recording({ 0.0f }, 16000, 0.0, 0.0f, 0.2f, 3);
+        CorrelationDetector::Match match = detector.Find(noise.data(), noise.size());
+        CHECK(!match.found);
+        CHECK(match.score < 0.2f);
+
+        // A steady tone inside the sweep's band is not the sweep either
+        std::vector<float> tone(16000);
+        for (size_t i = 0; i < tone.size(); ++i) tone[i] = 0.5f * static_cast<float>(std::sin(2.0 * 3.14159265 * 1000.0 * i / kRate));
+        CHECK(!detector.Find(tone.data(), tone.size()).found);
+
+        // Too short to hold the signal
+        CHECK(!detector.Find(silence.data(), 1000).found);
+    }
+
+    void TestStrongerArrivalWins()
+    {
+        // Direct sound at 2000, a reflection 600 samples later at half the level
+        std::vector<float> reference = CorrelationDetector::MakeChirp(100, 300.0f, 3400.0f);
+        CorrelationDetector detector(reference);
+        std::vector<float> recording = Recording(reference, 12000, 2000.0, 0.4f, 0.01f);
+        std::vector<float> reflection = Recording(reference, 12000, 2600.0, 0.2f, 0.0f);
+        for (size_t i = 0; i < recording.size(); ++i) recording[i] += reflection[i];
+
+        CorrelationDetector::Match match = detector.Find(recording.data(), recording.size());
+        CHECK(match.found);
+        CHECK(std::fabs(match.offset - 2000.0) < 0.5);
+        CHECK(match.peakToSidelobe > 1.4f);
+
+        // Two copies at the same level: nothing to tell them apart, so no answer
+        std::vector<float> twin = Recording(reference, 12000, 2600.0, 0.4f, 0.0f);
+        for (size_t i = 0; i < recording.size(); ++i) recording[i] += twin[i] - reflection[i];
+        CHECK(!detector.Find(recording.data(), recording.size()).found);
+    }
+
+    void TestSummary()
+    {
+        LatencyReport report;
+        for (double latency : { 50.0, 40.0, 60.0, 55.0, 45.0 }) report.samples.push_back({ true, latency, 0.8f });
+        report.samples.push_back({ false, 0.0, 0.1f });
+        SummarizeLatency(report);
+        CHECK(report.probes == 6 && report.found == 5);
+        CHECK(report.minMs == 40.0 && report.maxMs == 60.0);
+        CHECK(report.p50Ms == 50.0 && report.p95Ms == 60.0);
+        CHECK(report.meanMs == 50.0);
+        CHECK(std::fabs(report.jitterMs - std::sqrt(50.0)) < 1e-9);
+        CHECK(std::fabs(report.meanScore - 0.8f) < 1e-6f);
+
+        LatencyReport empty;
+        SummarizeLatency(empty);
+        CHECK(empty.probes == 0 && empty.found == 0 && empty.p50Ms == 0.0);
+    }
+
+    // The clock both audio "threads" stamp frames with
+    uint64_t g_nowUs = 1000000;
+    uint64_t TestClock() { return g_nowUs; }
+
+    struct LoopResult
+    {
+        std::vector<LatencySample> samples;
+        int framesIdle = 0; // frames the inject side left untouched
+    };
+
+    // Injects on one side and plays the result through `delay` samples at 48 kHz into the other,
+    // 10 ms per step: the inject side's frame first, the listen side's in the same step
+    LoopResult RunLoop(ProbePath path, ProbeSignal signal, size_t delay, int probes, float gain, int outChannels)
+    {
+        LatencyProbe probe(&TestClock);
+        LatencyProbeConfig config;
+        config.path = path;
+        config.signal = signal;
+        config.windowMs = 500;
+        probe.Start(config);
+
+        const bool injectOnCapture = path == ProbePath::Channel;
+        auto injectMix = injectOnCapture ? &LatencyProbe::MixCapture : &LatencyProbe::MixPlayback;
+        auto listenMix = injectOnCapture ? &LatencyProbe::MixPlayback : &LatencyProbe::MixCapture;
+        const int injectChannels = injectOnCapture ? 1 : outChannels;
+        const int listenChannels = injectOnCapture ? outChannels : 1;
+
+        std::mt19937 random(5);
+        std::uniform_int_distribution<int> noise(-300, 300);
+        std::deque<int16_t> line(delay, 0);
+        std::vector<int16_t> injectFrame(480 * injectChannels), listenFrame(480 * listenChannels);
+
+        LoopResult result;
+        auto step = [&]() {
+            g_nowUs += 10000;
+            for (int16_t& sample : injectFrame) sample = static_cast<int16_t>(noise(random));
+            if (!injectMix(&probe, injectFrame.data(), 480, injectChannels, 48000)) ++result.framesIdle;
+            for (int i = 0; i < 480; ++i) {
+                line.push_back(static_cast<int16_t>(injectFrame[static_cast<size_t>(i) * injectChannels] * gain));
+            }
+            for (int i = 0; i < 480; ++i) {
+                for (int channel = 0; channel < listenChannels; ++channel) {
+                    listenFrame[static_cast<size_t>(i) * listenChannels + channel] = line.front();
+                }
+                line.pop_front();
+            }
+            // The listen side never changes what it hears
+            std::vector<int16_t> before = listenFrame;
+            CHECK(!listenMix(&probe, listenFrame.data(), 480, listenChannels, 48000));
+            CHECK(before == listenFrame);
+        };
+
+        for (int n = 1; n <= probes; ++n) {
+            probe.Arm(static_cast<uint32_t>(n));
+            for (int frames = 0; frames < 100 && !probe.IsCaptured(static_cast<uint32_t>(n)); ++frames) step();
+            CHECK(probe.IsCaptured(static_cast<uint32_t>(n)));
+            result.samples.push_back(probe.Analyze(static_cast<uint32_t>(n)));
+            // The gap the core leaves between probes
+            for (int frames = 0; frames < config.gapMs / 10; ++frames) step();
+        }
+        probe.Stop();
+        CHECK(!probe.IsRunning());
+        return result;
+    }
+
+    void TestProbeThroughDeviceLoop()
+    {
+        // 87 ms and a third of a millisecond, an eighth as loud as sent
+        LoopResult result = RunLoop(ProbePath::Device, ProbeSignal::Chirp, 48 * 87 + 16, 4, 0.125f, 2);
+        double expected = (48.0 * 87 + 16) / 48.0;
+        for (const LatencySample& sample : result.samples) {
+            CHECK(sample.found);
+            CHECK(std::fabs(sample.latencyMs - expected) < 0.1);
+        }
+        std::printf("device loop %.3f ms: measured %.3f ms, score %.2f\n", expected,
+                    result.samples.empty() ? 0.0 : result.samples[0].latencyMs,
+                    result.samples.empty() ? 0.0f : result.samples[0].score);
+    }
+
+    void TestProbeThroughChannelLoop()
+    {
+        LoopResult result = RunLoop(ProbePath::Channel, ProbeSignal::Mls, 48 * 230, 3, 0.5f, 2);
+        for (const LatencySample& sample : result.samples) {
+            CHECK(sample.found);
+            CHECK(std::fabs(sample.latencyMs - 230.0) < 0.1);
+        }
+    }
+
+    void TestLatencyBeyondTheWindowIsAMiss()
+    {
+        // 600 ms of delay with a 500 ms window: the signal never lands in it
+        LoopResult result = RunLoop(ProbePath::Device, ProbeSignal::Chirp, 48 * 600, 2, 0.5f, 1);
+        for (const LatencySample& sample : result.samples) CHECK(!sample.found);
+    }
+
+    void TestWindowIsClampedToHoldTheSignal()
+    {
+        LatencyProbe probe(&TestClock);
+        LatencyProbeConfig config;
+        config.windowMs = 10;
+        probe.Start(config);
+        CHECK(probe.GetConfig().windowMs == LatencyProbe::kMinWindowMs);
+        config.windowMs = 60000;
+        probe.Start(config);
+        CHECK(probe.GetConfig().windowMs == LatencyProbe::kMaxWindowMs);
+
+        // Idle until armed: frames go through untouched on both sides
+        std::vector<int16_t> frame(480, 100);
+        CHECK(!LatencyProbe::MixPlayback(&probe, frame.data(), 480, 1, 48000));
+        CHECK(!LatencyProbe::MixCapture(&probe, frame.data(), 480, 1, 48000));
+        CHECK(std::all_of(frame.begin(), frame.end(), [](int16_t sample) { return sample == 100; }));
+        CHECK(!probe.IsCaptured(1));
+    }
+}
+
+int main()
+{
+    TestMlsIsMaximumLength();
+    TestChirpIsTaperedAndBounded();
+    TestFindsKnownDelay();
+    TestFractionalDelay();
+    TestNoisyAndInverted();
+    TestNothingThereIsNotFound();
+    TestStrongerArrivalWins();
+    TestSummary();
+    TestProbeThroughDeviceLoop();
+    TestProbeThroughChannelLoop();
+    TestLatencyBeyondTheWindowIsAMiss();
+    TestWindowIsClampedToHoldTheSignal();
+
+    if (g_failures == 0) std::printf("LatencyProbeTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
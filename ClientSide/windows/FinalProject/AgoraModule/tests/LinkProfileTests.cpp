@@ -0,0 +1,147 @@
+// Tests for the link profile: which tier a last-mile probe result lands in (the worse direction
+// decides, bandwidth only when it was measured), the parameters each tier sets, and the
+// per-network cache (TTL, replacement, eviction of the oldest network).
+//
+//   cmake -S .. -B build && cmake --build build && ./build/LinkProfileTests
+#include "../LinkProfile.h"
+#include <cstdio>
+#include <string>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    LastmileProbeResult Link(uint32_t lossPercent, uint32_t jitterMs, uint32_t rttMs, uint32_t bandwidthKbps)
+    {
+        LastmileProbeResult result;
+        result.state = LastmileProbeResult::kComplete;
+        result.uplink = { lossPercent, jitterMs, bandwidthKbps };
+        result.downlink = { 0, 2, 10000 };
+        result.rttMs = rttMs;
+        return result;
+    }
+
+    bool Contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    void TestTiers()
+    {
+        AudioLinkProfile good = ChooseLinkProfile(Link(1, 10, 40, 3000));
+        CHECK(good.tier == LinkTier::Good);
+        CHECK(good.audioProfile == AudioLinkProfile::kProfileDefault && !good.fec && good.bitrateKbps == 0);
+
+        // Each limit on its own is enough to drop a tier
+        CHECK(ChooseLinkProfile(Link(5, 10, 40, 3000)).tier == LinkTier::Fair);
+        CHECK(ChooseLinkProfile(Link(1, 45, 40, 3000)).tier == LinkTier::Fair);
+        CHECK(ChooseLinkProfile(Link(1, 10, 250, 3000)).tier == LinkTier::Fair);
+        CHECK(ChooseLinkProfile(Link(1, 10, 40, 90)).tier == LinkTier::Fair);
+        CHECK(ChooseLinkProfile(Link(15, 10, 40, 3000)).tier == LinkTier::Poor);
+        CHECK(ChooseLinkProfile(Link(1, 10, 40, 30)).tier == LinkTier::Poor);
+
+        // A bad downlink counts as much as a bad uplink
+        LastmileProbeResult downlink = Link(0, 2, 40, 3000);
+        downlink.downlink.packetLossRate = 12;
+        CHECK(ChooseLinkProfile(downlink).tier == LinkTier::Poor);
+
+        AudioLinkProfile fair = ChooseLinkProfile(Link(5, 10, 40, 3000));
+        AudioLinkProfile poor = ChooseLinkProfile(Link(15, 10, 40, 3000));
+        CHECK(fair.audioProfile == AudioLinkProfile::kProfileSpeechStandard && fair.fec);
+        CHECK(poor.fec && poor.bitrateKbps < fair.bitrateKbps && poor.jitterBufferMs > fair.jitterBufferMs);
+        CHECK(!fair.SameSettings(poor) && !good.SameSettings(fair));
+        CHECK(good.SameSettings(AudioLinkProfile{}));
+    }
+
+    void TestProbeStates()
+    {
+        // No bandwidth estimate: judged on loss, jitter and RTT alone
+        LastmileProbeResult noBwe = Link(1, 10, 40, 0);
+        noBwe.state = LastmileProbeResult::kIncompleteNoBwe;
+        noBwe.downlink.availableBandwidthKbps = 0;
+        CHECK(ChooseLinkProfile(noBwe).tier == LinkTier::Good);
+
+        LastmileProbeResult unavailable = Link(50, 500, 900, 10);
+        unavailable.state = LastmileProbeResult::kUnavailable;
+        CHECK(ChooseLinkProfile(unavailable).tier == LinkTier::Unknown);
+        CHECK(ChooseLinkProfile(unavailable).SameSettings(AudioLinkProfile{}));
+    }
+
+    void TestParameters()
+    {
+        std::string poor = LinkProfileParameters(ChooseLinkProfile(Link(15, 10, 40, 3000)));
+        CHECK(poor.front() == '{' && poor.back() == '}');
+        CHECK(Contains(poor, "\"che.audio.custom_bitrate\":16000"));
+        CHECK(Contains(poor, "\"che.audio.enable.fec\":true"));
+        CHECK(Contains(poor, "\"che.audio.neteq.min_delay\":160"));
+
+        // Defaults: the profile's bitrate, FEC off, adaptive jitter buffer
+        std::string good = LinkProfileParameters(AudioLinkProfile{});
+        CHECK(!Contains(good, "custom_bitrate"));
+        CHECK(Contains(good, "\"che.audio.enable.fec\":false"));
+        CHECK(Contains(good, "\"che.audio.neteq.min_delay\":0"));
+    }
+
+    void TestCache()
+    {
+        LinkProfileCache cache;
+        cache.SetTtl(60000);
+        LinkDecision decision;
+        CHECK(!cache.Lookup("wifi:office", 0, decision));
+
+        LinkDecision stored = cache.Store("wifi:office", Link(15, 10, 40, 3000), 1000);
+        CHECK(stored.profile.tier == LinkTier::Poor && !stored.fromCache);
+        CHECK(cache.Lookup("wifi:office", 60999, decision));
+        CHECK(decision.fromCache && decision.networkId == "wifi:office" && decision.profile.tier == LinkTier::Poor);
+        CHECK(decision.measured.uplink.packetLossRate == 15);
+        CHECK(!cache.Lookup("wifi:office", 61000, decision));
+        CHECK(!cache.Lookup("wifi:home", 2000, decision));
+
+        // A new measurement replaces the old one
+        cache.Store("wifi:office", Link(0, 2, 20, 5000), 70000);
+        CHECK(cache.Lookup("wifi:office", 70000, decision) && decision.profile.tier == LinkTier::Good);
+        CHECK(cache.GetSize() == 1);
+
+        // Full: the network measured longest ago goes
+        for (size_t i = 1; i < LinkProfileCache::kMaxNetworks; ++i) {
+            cache.Store("net" + std::to_string(i), Link(0, 2, 20, 5000), 80000 + i);
+        }
+        CHECK(cache.GetSize() == LinkProfileCache::kMaxNetworks);
+        cache.Store("wifi:cafe", Link(5, 10, 40, 3000), 90000);
+        CHECK(cache.GetSize() == LinkProfileCache::kMaxNetworks);
+        CHECK(!cache.Lookup("wifi:office", 90000, decision));
+        CHECK(cache.Lookup("net1", 90000, decision));
+        CHECK(cache.Lookup("wifi:cafe", 90000, decision) && decision.profile.tier == LinkTier::Fair);
+
+        cache.Clear();
+        CHECK(cache.GetSize() == 0);
+    }
+
+    void TestTierNames()
+    {
+        CHECK(std::string(LinkTierName(LinkTier::Unknown)) == "unknown");
+        CHECK(std::string(LinkTierName(LinkTier::Poor)) == "poor");
+    }
+}
+
+int main()
+{
+    TestTiers();
+    TestProbeStates();
+    TestParameters();
+    TestCache();
+    TestTierNames();
+
+    if (g_failures == 0) std::printf("LinkProfileTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,225 @@
+// Tests for the structured logger: "{}" substitution (missing and extra arguments, every argument
+// kind, truncation of the inline text), records dropped when a thread's ring is full instead of
+// blocking, and the rotating file sink keeping agora.log, .1 and .2.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/LoggingTests
+#include "../Logging.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    enum class Color : int { Red = 3 };
+
+    template <typename... Args>
+    std::string Formatted(const char* format, const Args&... args)
+    {
+        LogRecord record;
+        record.format = format;
+        (record.Add(args), ...);
+        return Log::Format(record);
+    }
+
+    // Lines handed to the mirror sink, message part only (after the "[thread] " prefix)
+    std::mutex g_mirrorMutex;
+    std::vector<std::string> g_mirrored;
+
+    void Mirror(const char* line)
+    {
+        std::string text(line);
+        size_t at = text.find("] ", text.find("] ") + 2);
+        std::lock_guard<std::mutex> lock(g_mirrorMutex);
+        g_mirrored.push_back(at == std::string::npos ? text : text.substr(at + 2));
+    }
+
+    std::vector<std::string> ReadLines(const std::filesystem::path& path)
+    {
+        std::vector<std::string> lines;
+        std::ifstream file(path);
+        for (std::string line; std::getline(file, line);) lines.push_back(line);
+        return lines;
+    }
+
+    // The n of "... entry n" at the end of a logged line
+    int EntryNumber(const std::string& line)
+    {
+        size_t at = line.rfind("entry ");
+        return at == std::string::npos ? -1 : std::stoi(line.substr(at + 6));
+    }
+
+    void TestSubstitution()
+    {
+        CHECK(Formatted("Joined {} as uid {} in {} ms", std::string("ops"), 42u, 12.5) == "Joined ops as uid 42 in 12.500 ms");
+        CHECK(Formatted("{} {} {}", -7, true, false) == "-7 true false");
+        CHECK(Formatted("{} / {}", static_cast<uint64_t>(18446744073709551615ull), static_cast<int64_t>(-9000000000ll)) ==
+              "18446744073709551615 / -9000000000");
+        CHECK(Formatted("color {}", Color::Red) == "color 3");
+        CHECK(Formatted("{}", std::string_view("view")) == "view");
+
+        // Missing arguments stay as "{}", extra ones are ignored; a lone brace is text
+        CHECK(Formatted("a {} b {} c {}", 1) == "a 1 b {} c {}");
+        CHECK(Formatted("only {}", 1, 2, 3) == "only 1");
+        CHECK(Formatted("{ {x} }", 5) == "{ {x} }");
+        CHECK(Formatted("no arguments") == "no arguments");
+
+        // String literals, char buffers and null pointers
+        char buffer[16] = "buffer";
+        const char* missing = nullptr;
+        CHECK(Formatted("{} {} {}", "literal", buffer, missing) == "literal buffer (null)");
+
+        // More than kMaxArgs: the rest are dropped, not overrun
+        CHECK(Formatted("{}{}{}{}{}{}{}{}{}", 1, 2, 3, 4, 5, 6, 7, 8, 9) == "12345678{}");
+
+        LogRecord empty;
+        CHECK(Log::Format(empty).empty());
+    }
+
+    void TestTextTruncation()
+    {
+        // Text is copied inline: past kTextBytes it is cut, later text arguments come out empty
+        std::string longText(LogRecord::kTextBytes + 50, 'x');
+        std::string formatted = Formatted("[{}] [{}] [{}]", longText, std::string("tail"), 7);
+        CHECK(formatted == "[" + std::string(LogRecord::kTextBytes, 'x') + "] [] [7]");
+
+        std::string half(LogRecord::kTextBytes / 2, 'y');
+        CHECK(Formatted("{}{}", half, half + "zz") == half + half);
+    }
+
+    void TestFullRingDrops()
+    {
+        LogConfig config;
+        config.drainIntervalMs = 60000; // only Flush drains
+        config.mirror = &Mirror;
+        Log::Start(config);
+        CHECK(Log::IsRunning());
+
+        uint64_t droppedBefore = Log::GetDroppedCount();
+        const size_t total = Log::kRingCapacity + 10;
+        for (size_t i = 0; i < total; ++i) AGORA_LOG_WARN("ring entry {}", i);
+        CHECK(Log::GetDroppedCount() - droppedBefore == 10);
+
+        // The oldest kRingCapacity made it, in order; after a drain there is room again
+        Log::Flush();
+        {
+            std::lock_guard<std::mutex> lock(g_mirrorMutex);
+            CHECK(g_mirrored.size() == Log::kRingCapacity);
+            CHECK(!g_mirrored.empty() && g_mirrored.front() == "ring entry 0\n");
+            CHECK(!g_mirrored.empty() && EntryNumber(g_mirrored.back()) == static_cast<int>(Log::kRingCapacity - 1));
+            g_mirrored.clear();
+        }
+        AGORA_LOG_WARN("after {}", "drain");
+        Log::Flush();
+        CHECK(Log::GetDroppedCount() - droppedBefore == 10);
+        {
+            std::lock_guard<std::mutex> lock(g_mirrorMutex);
+            CHECK((g_mirrored == std::vector<std::string>{ "after drain\n" }));
+            g_mirrored.clear();
+        }
+        Log::Stop();
+        CHECK(!Log::IsRunning());
+
+        // Stopped: calls are ignored, nothing counts as dropped
+        AGORA_LOG_ERROR("ignored {}", 1);
+        CHECK(Log::GetDroppedCount() - droppedBefore == 10);
+    }
+
+    void TestRotation(const std::filesystem::path& directory)
+    {
+        const std::filesystem::path path = directory / "agora.log";
+        LogConfig config;
+        config.filePath = path.string();
+        config.maxFileBytes = 400;
+        config.maxFiles = 3;
+        config.drainIntervalMs = 60000;
+        Log::Start(config);
+        for (int i = 0; i < 40; ++i) {
+            AGORA_LOG_INFO("rotating entry {}", i);
+            if (i % 8 == 7) Log::Flush();
+        }
+        Log::Stop();
+
+        CHECK(std::filesystem::exists(path));
+        CHECK(std::filesystem::exists(directory / "agora.log.1"));
+        CHECK(std::filesystem::exists(directory / "agora.log.2"));
+        CHECK(!std::filesystem::exists(directory / "agora.log.3"));
+
+        // Newest in agora.log, older in .1, oldest kept in .2; every file within the limit
+        std::vector<std::string> current = ReadLines(path);
+        std::vector<std::string> first = ReadLines(directory / "agora.log.1");
+        std::vector<std::string> second = ReadLines(directory / "agora.log.2");
+        CHECK(!current.empty() && !first.empty() && !second.empty());
+        if (!current.empty() && !first.empty() && !second.empty()) {
+            CHECK(EntryNumber(current.back()) == 39);
+            CHECK(EntryNumber(first.back()) + 1 == EntryNumber(current.front()));
+            CHECK(EntryNumber(second.back()) + 1 == EntryNumber(first.front()));
+            CHECK(current.front().find("[INFO ]") != std::string::npos);
+        }
+        for (const char* name : { "agora.log", "agora.log.1", "agora.log.2" }) {
+            CHECK(std::filesystem::file_size(directory / name) <= config.maxFileBytes);
+        }
+
+        // A restart appends to agora.log instead of truncating it
+        size_t before = ReadLines(path).size();
+        config.maxFileBytes = 1 << 20;
+        Log::Start(config);
+        AGORA_LOG_INFO("rotating entry {}", 40);
+        Log::Stop();
+        std::vector<std::string> appended = ReadLines(path);
+        CHECK(appended.size() == before + 1 && EntryNumber(appended.back()) == 40);
+    }
+
+    void TestSingleFile(const std::filesystem::path& directory)
+    {
+        // maxFiles 1: a full file starts over, nothing is kept beside it
+        const std::filesystem::path path = directory / "single.log";
+        LogConfig config;
+        config.filePath = path.string();
+        config.maxFileBytes = 300;
+        config.maxFiles = 1;
+        config.drainIntervalMs = 60000;
+        Log::Start(config);
+        for (int i = 0; i < 30; ++i) {
+            AGORA_LOG_INFO("single entry {}", i);
+            Log::Flush();
+        }
+        Log::Stop();
+
+        CHECK(!std::filesystem::exists(directory / "single.log.1"));
+        std::vector<std::string> lines = ReadLines(path);
+        CHECK(!lines.empty() && EntryNumber(lines.back()) == 29);
+        CHECK(std::filesystem::file_size(path) <= config.maxFileBytes);
+    }
+}
+
+int main()
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "agora_logging_tests";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    TestSubstitution();
+    TestTextTruncation();
+    TestFullRingDrops();
+    TestRotation(directory);
+    TestSingleFile(directory);
+
+    std::filesystem::remove_all(directory);
+    if (g_failures == 0) std::printf("LoggingTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
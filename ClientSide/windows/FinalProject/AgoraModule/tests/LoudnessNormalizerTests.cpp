@@ -0,0 +1,206 @@
+// Tests for the loudness normalizer: BS.1770 calibration of the K-weighting, the gain each
+// speaker gets (towards the target, within the limits), fast attack and slow release, the
+// gate holding through silence, and the slot table (independent users, overflow, idle reuse).
+//
+//   cmake -S .. -B build && cmake --build build && ./build/LoudnessNormalizerTests
+#include "../LoudnessNormalizer.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kSampleRate = 48000;
+    constexpr int kFrame = 480; // 10 ms
+
+    // A continuous tone per speaker, one 10 ms frame at a time
+    struct Tone
+    {
+        explicit Tone(float levelDbfs, double hz = 997.0) : amplitude(32767.0 * std::pow(10.0, levelDbfs / 20.0)), hz(hz) {}
+
+        const int16_t* Next()
+        {
+            for (int i = 0; i < kFrame; ++i, ++position) {
+                frame[i] = static_cast<int16_t>(std::lround(amplitude * std::sin(2.0 * 3.14159265358979 * hz * position / kSampleRate)));
+            }
+            return frame;
+        }
+
+        double amplitude;
+        double hz;
+        long long position = 0;
+        int16_t frame[kFrame] = {};
+    };
+
+    LoudnessConfig Enabled()
+    {
+        LoudnessConfig config;
+        config.enabled = true;
+        return config;
+    }
+
+    LoudnessGain Feed(LoudnessNormalizer& normalizer, Tone& tone, int frames, const char* channel = "fire", uint32_t uid = 1)
+    {
+        LoudnessGain level;
+        for (int i = 0; i < frames; ++i) {
+            normalizer.Prepare();
+            level = normalizer.Process(channel, uid, tone.Next(), kFrame, kSampleRate);
+        }
+        return level;
+    }
+
+    float GainDb(const LoudnessGain& level)
+    {
+        return 20.0f * std::log10(level.to);
+    }
+
+    LoudnessStats StatsFor(const LoudnessNormalizer& normalizer, const char* channel, uint32_t uid)
+    {
+        for (const auto& entry : normalizer.GetStats()) {
+            if (entry.channelKey == LoudnessNormalizer::ChannelKey(channel) && entry.uid == uid) return entry;
+        }
+        return LoudnessStats{};
+    }
+
+    void TestCalibration()
+    {
+        // BS.1770: a full-scale 997 Hz sine reads -3.01 LUFS, and 20 dB down reads 20 dB less
+        LoudnessNormalizer normalizer;
+        normalizer.SetConfig(Enabled());
+        Tone full(0.0f);
+        Feed(normalizer, full, 100);
+        CHECK(std::fabs(StatsFor(normalizer, "fire", 1).loudnessLufs + 3.01f) < 0.1f);
+
+        Tone quieter(-20.0f);
+        Feed(normalizer, quieter, 100, "fire", 2);
+        CHECK(std::fabs(StatsFor(normalizer, "fire", 2).loudnessLufs + 23.01f) < 0.1f);
+
+        // The shelf: over 3 dB more weight up high than at 1 kHz, the high-pass: less down low
+        Tone high(-20.0f, 6000.0);
+        Tone low(-20.0f, 40.0);
+        Feed(normalizer, high, 100, "fire", 3);
+        Feed(normalizer, low, 100, "fire", 4);
+        CHECK(std::fabs(StatsFor(normalizer, "fire", 3).loudnessLufs + 19.67f) < 0.1f);
+        CHECK(StatsFor(normalizer, "fire", 4).loudnessLufs < -25.0f);
+    }
+
+    void TestTowardsTarget()
+    {
+        LoudnessNormalizer normalizer;
+        normalizer.SetConfig(Enabled()); // -20 LUFS, +-15 dB
+        Tone loud(-7.0f);   // about -10 LUFS
+        Tone quiet(-27.0f); // about -30 LUFS
+        Tone whisper(-47.0f);
+
+        CHECK(std::fabs(GainDb(Feed(normalizer, loud, 50, "fire", 1)) + 9.99f) < 0.1f);
+        CHECK(std::fabs(GainDb(Feed(normalizer, quiet, 50, "fire", 2)) - 10.01f) < 0.1f);
+        CHECK(std::fabs(GainDb(Feed(normalizer, whisper, 50, "fire", 3)) - 15.0f) < 0.01f); // boost limit
+
+        LoudnessStats stats = StatsFor(normalizer, "fire", 2);
+        CHECK(stats.speaking && std::fabs(stats.gainDb - 10.01f) < 0.1f);
+
+        // A new target takes effect at the next frame
+        LoudnessConfig config = Enabled();
+        config.targetLufs = -16.0f;
+        normalizer.SetConfig(config);
+        CHECK(std::fabs(GainDb(Feed(normalizer, quiet, 1, "fire", 2)) - 14.01f) < 0.1f);
+    }
+
+    void TestAttackAndRelease()
+    {
+        LoudnessNormalizer normalizer;
+        normalizer.SetConfig(Enabled()); // 40 ms attack, 2 s release
+        Tone quiet(-27.0f);
+        Tone loud(-7.0f);
+        Feed(normalizer, quiet, 100);
+
+        // 20 dB louder: within 2 dB of the new gain after 100 ms, and never a jump within a frame
+        normalizer.Prepare();
+        LoudnessGain first = normalizer.Process("fire", 1, loud.Next(), kFrame, kSampleRate);
+        CHECK(first.from > first.to && std::fabs(20.0f * std::log10(first.from) - 10.01f) < 0.1f);
+        CHECK(GainDb(Feed(normalizer, loud, 9)) < -8.0f);
+        CHECK(std::fabs(GainDb(Feed(normalizer, loud, 40)) + 9.99f) < 0.1f);
+
+        // 20 dB quieter again: still turned down after 100 ms, back after 8 s
+        CHECK(GainDb(Feed(normalizer, quiet, 10)) < -8.0f);
+        CHECK(std::fabs(GainDb(Feed(normalizer, quiet, 790)) - 10.0f) < 0.5f);
+    }
+
+    void TestGateHolds()
+    {
+        LoudnessNormalizer normalizer;
+        normalizer.SetConfig(Enabled());
+        Tone quiet(-27.0f);
+        Tone hiss(-70.0f);
+        float levelled = GainDb(Feed(normalizer, quiet, 50));
+
+        // Pauses between overs: the gain neither creeps up nor lets go
+        LoudnessGain held = Feed(normalizer, hiss, 150);
+        CHECK(held.from == held.to && std::fabs(GainDb(held) - levelled) < 0.001f);
+        CHECK(!StatsFor(normalizer, "fire", 1).speaking);
+
+        // Nobody has spoken yet: unity
+        LoudnessGain unheard = Feed(normalizer, hiss, 10, "fire", 9);
+        CHECK(unheard.from == 1.0f && unheard.to == 1.0f);
+        CHECK(StatsFor(normalizer, "fire", 9).loudnessLufs == LoudnessNormalizer::kSilenceLufs);
+    }
+
+    void TestSlots()
+    {
+        LoudnessNormalizer normalizer;
+
+        // Off: unity, nothing measured
+        Tone tone(-10.0f);
+        LoudnessGain off = Feed(normalizer, tone, 5);
+        CHECK(off.from == 1.0f && off.to == 1.0f && normalizer.GetStats().empty());
+
+        // Same uid on two radios is two speakers
+        normalizer.SetConfig(Enabled());
+        std::vector<Tone> tones;
+        for (int i = 0; i < static_cast<int>(LoudnessNormalizer::kSlots) + 2; ++i) tones.emplace_back(-10.0f - i);
+        for (int frame = 0; frame < 20; ++frame) {
+            normalizer.Prepare();
+            for (size_t i = 0; i < LoudnessNormalizer::kSlots; ++i) {
+                normalizer.Process(i % 2 ? "ems" : "fire", static_cast<uint32_t>(i / 2), tones[i].Next(), kFrame, kSampleRate);
+            }
+        }
+        CHECK(normalizer.GetStats().size() == LoudnessNormalizer::kSlots);
+        CHECK(StatsFor(normalizer, "fire", 3).loudnessLufs > StatsFor(normalizer, "ems", 3).loudnessLufs);
+
+        // Full: the next speaker is played as is and counted
+        normalizer.Prepare();
+        LoudnessGain overflow = normalizer.Process("police", 1, tones[LoudnessNormalizer::kSlots].Next(), kFrame, kSampleRate);
+        CHECK(overflow.to == 1.0f && normalizer.GetOverflowCount() == 1);
+
+        // Two seconds unheard: out of the stats, and the slots are free again
+        for (uint32_t i = 0; i <= LoudnessNormalizer::kIdleFrames; ++i) normalizer.Prepare();
+        CHECK(normalizer.GetStats().empty());
+        Feed(normalizer, tones[LoudnessNormalizer::kSlots + 1], 5, "police", 1);
+        CHECK(normalizer.GetStats().size() == 1 && normalizer.GetOverflowCount() == 1);
+        CHECK(LoudnessNormalizer::ChannelKey("fire") != LoudnessNormalizer::ChannelKey("ems"));
+    }
+}
+
+int main()
+{
+    TestCalibration();
+    TestTowardsTarget();
+    TestAttackAndRelease();
+    TestGateHolds();
+    TestSlots();
+
+    if (g_failures == 0) std::printf("LoudnessNormalizerTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
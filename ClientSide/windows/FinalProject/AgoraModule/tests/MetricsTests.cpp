@@ -0,0 +1,183 @@
+// Tests for the metrics subsystem - no Agora SDK or WinRT required.
+//
+//   g++ -std=c++17 -O2 -pthread MetricsTests.cpp ../Metrics.cpp -o MetricsTests
+#include "../Metrics.h"
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    bool Contains(const std::string& text, const std::string& part)
+    {
+        return text.find(part) != std::string::npos;
+    }
+
+    void TestBucketsCoverEveryValue()
+    {
+        // Each value falls inside its bucket, buckets are contiguous and relative error is bounded
+        size_t previous = 0;
+        for (uint64_t value = 0; value < (1ull << 20); value += 1 + value / 64) {
+            size_t index = LatencyHistogram::BucketIndex(value);
+            CHECK(index >= previous);
+            CHECK(index < LatencyHistogram::kBuckets);
+            CHECK(LatencyHistogram::BucketUpperBound(index) >= value);
+            CHECK(index == 0 || LatencyHistogram::BucketUpperBound(index - 1) < value);
+            CHECK(LatencyHistogram::BucketUpperBound(index) - value <= value / 8 + 1);
+            previous = index;
+        }
+        for (size_t index = 1; index < LatencyHistogram::kBuckets; ++index) {
+            CHECK(LatencyHistogram::BucketIndex(LatencyHistogram::BucketUpperBound(index)) == index);
+            CHECK(LatencyHistogram::BucketIndex(LatencyHistogram::BucketUpperBound(index - 1) + 1) == index);
+        }
+        CHECK(LatencyHistogram::BucketIndex(~0ull) == LatencyHistogram::kBuckets - 1);
+    }
+
+    void TestPercentiles()
+    {
+        LatencyHistogram histogram;
+        CHECK(histogram.Summarize().count == 0);
+
+        // 1..1000 ms in microseconds
+        for (uint64_t ms = 1; ms <= 1000; ++ms) histogram.Record(ms * 1000);
+        LatencyHistogram::Summary summary = histogram.Summarize();
+        CHECK(summary.count == 1000);
+        CHECK(summary.maxUs == 1000000);
+        CHECK(summary.meanUs == 500500);
+        CHECK(summary.p50Us >= 500000 && summary.p50Us <= 500000 * 9 / 8);
+        CHECK(summary.p90Us >= 900000 && summary.p90Us <= 900000 * 9 / 8);
+        CHECK(summary.p99Us >= 990000 && summary.p99Us <= 1000000);
+
+        histogram.Reset();
+        histogram.Record(7);
+        summary = histogram.Summarize();
+        CHECK(summary.p50Us == 7 && summary.p99Us == 7 && summary.maxUs == 7);
+    }
+
+    void TestConcurrentRecordingLosesNothing()
+    {
+        Metrics metrics;
+        constexpr int kThreads = 8;
+        constexpr int kPerThread = 100000;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&metrics, t]() {
+                std::mt19937 random(t);
+                std::uniform_int_distribution<uint64_t> micros(1, 5000000);
+                for (int i = 0; i < kPerThread; ++i) {
+                    metrics.RecordLatency(MetricOp::Mute, micros(random), i % 100 != 0);
+                    metrics.RecordNetworkQuality(static_cast<uint8_t>(t), static_cast<uint32_t>(i % 4), i % 6, i % 6);
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        CHECK(metrics.GetSummary(MetricOp::Mute).count == uint64_t(kThreads) * kPerThread);
+        CHECK(metrics.GetFailures(MetricOp::Mute) == uint64_t(kThreads) * kPerThread / 100);
+        CHECK(metrics.GetSummary(MetricOp::Mute).maxUs <= 5000000);
+        CHECK(metrics.GetUidOverflowCount() == 0);
+    }
+
+    void TestUidSlotsOverflowAndReuse()
+    {
+        Metrics metrics;
+        RemoteAudioSample sample;
+        sample.networkDelayMs = 42;
+
+        for (uint32_t uid = 1; uid <= Metrics::kUidSlots; ++uid) metrics.RecordRemoteAudio(0, uid, sample);
+        CHECK(metrics.GetUidOverflowCount() == 0);
+
+        metrics.RecordRemoteAudio(0, 1000, sample);
+        CHECK(metrics.GetUidOverflowCount() == 1);
+
+        // A user leaving frees their slot for the next one
+        metrics.ForgetUid(0, 5);
+        metrics.RecordRemoteAudio(0, 1000, sample);
+        CHECK(metrics.GetUidOverflowCount() == 1);
+        CHECK(Contains(metrics.SnapshotJson(), "[0,1000,0,42,"));
+        CHECK(!Contains(metrics.SnapshotJson(), "[0,5,"));
+
+        // Out-of-range channels are ignored rather than corrupting a slot
+        metrics.RecordRemoteAudio(Metrics::kNoChannel, 7, sample);
+        CHECK(metrics.GetUidOverflowCount() == 1);
+    }
+
+    void TestSnapshotJson()
+    {
+        Metrics metrics;
+        std::string empty = metrics.SnapshotJson();
+        CHECK(Contains(empty, "\"ops\":{}"));
+        CHECK(Contains(empty, "\"channels\":[]"));
+        CHECK(Contains(empty, "\"uids\":[]"));
+
+        metrics.RecordLatency(MetricOp::JoinToSuccess, 250000);
+        metrics.RecordFailure(MetricOp::Leave);
+        metrics.SetChannelName(1, "radio \"A\"");
+        ChannelStatsSample stats;
+        stats.durationS = 12;
+        stats.txKbps = 24;
+        stats.userCount = 3;
+        metrics.RecordChannelStats(1, stats);
+        metrics.RecordNetworkQuality(1, 0, 1, 2);
+
+        std::string json = metrics.SnapshotJson();
+        CHECK(Contains(json, "\"joinToSuccess\":{\"n\":1,\"fail\":0,\"mean\":250000,"));
+        CHECK(Contains(json, "\"leave\":{\"n\":0,\"fail\":1,"));
+        CHECK(!Contains(json, "\"mute\""));
+        CHECK(Contains(json, "[\"radio \\\"A\\\"\",12,24,0,0,0,0,3,0]"));
+        CHECK(Contains(json, "[1,0,0,0,0,0,0,0,0,1,2]"));
+        CHECK(json.front() == '{' && json.back() == '}');
+        CHECK(!Contains(json, ",}") && !Contains(json, ",]"));
+
+        metrics.ResetConnections();
+        json = metrics.SnapshotJson();
+        CHECK(Contains(json, "joinToSuccess") && Contains(json, "\"channels\":[]") && Contains(json, "\"uids\":[]"));
+
+        metrics.Reset();
+        CHECK(!Contains(metrics.SnapshotJson(), "joinToSuccess"));
+    }
+
+    void TestScopedLatency()
+    {
+        Metrics metrics;
+        {
+            ScopedLatency timing(metrics, MetricOp::Init);
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        {
+            ScopedLatency timing(metrics, MetricOp::Init);
+            timing.Fail();
+        }
+        CHECK(metrics.GetSummary(MetricOp::Init).count == 2);
+        CHECK(metrics.GetSummary(MetricOp::Init).maxUs >= 2000);
+        CHECK(metrics.GetFailures(MetricOp::Init) == 1);
+    }
+}
+
+int main()
+{
+    TestBucketsCoverEveryValue();
+    TestPercentiles();
+    TestConcurrentRecordingLosesNothing();
+    TestUidSlotsOverflowAndReuse();
+    TestSnapshotJson();
+    TestScopedLatency();
+
+    if (g_failures == 0) std::printf("MetricsTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+// Headless tests for MultiChannelSession - no Agora SDK or WinRT required.
+#include "../AgoraCore.h"
+#include "../FakeVoiceEngine.h"
+#include "../MultiChannelSession.h"
+#include <cstdio>
+#include <map>
+#include <string>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // Records every call and the publish state per connection
+    class FakeConnectionEngine : public IConnectionEngine
+    {
+    public:
+        int JoinConnection(const std::string& channelName, bool publishMicrophone) override
+        {
+            ++joins;
+            if (failJoin) return -1;
+            publishing[channelName] = publishMicrophone;
+            return 0;
+        }
+
+        int UpdateConnection(const std::string& channelName, bool publishMicrophone) override
+        {
+            ++updates;
+            publishing[channelName] = publishMicrophone;
+            return 0;
+        }
+
+        int LeaveConnection(const std::string& channelName) override
+        {
+            ++leaves;
+            publishing.erase(channelName);
+            return 0;
+        }
+
+        int Publishers() const
+        {
+            int count = 0;
+            for (const auto& entry : publishing) count += entry.second ? 1 : 0;
+            return count;
+        }
+
+        int joins = 0;
+        int updates = 0;
+        int leaves = 0;
+        bool failJoin = false;
+        std::map<std::string, bool> publishing;
+    };
+
+    // The session over FakeVoiceEngine's connection calls, so engine failures can be injected
+    class FakeVoiceConnections : public IConnectionEngine
+    {
+    public:
+        static constexpr uint32_t kUid = 7;
+
+        explicit FakeVoiceConnections(FakeVoiceEngine& engine) : m_engine(engine) {}
+
+        int JoinConnection(const std::string& channelName, bool publishMicrophone) override
+        {
+            return m_engine.JoinConnection(channelName, kUid, Options(publishMicrophone), &m_events);
+        }
+
+        int UpdateConnection(const std::string& channelName, bool publishMicrophone) override
+        {
+            return m_engine.UpdateConnection(channelName, kUid, Options(publishMicrophone));
+        }
+
+        int LeaveConnection(const std::string& channelName) override
+        {
+            return m_engine.LeaveConnection(channelName, kUid);
+        }
+
+        bool Publishing(const std::string& channelName) const
+        {
+            FakeVoiceEngine::ConnectionInfo info;
+            return m_engine.FindConnection(channelName, info) && info.publishing;
+        }
+
+    private:
+        static ConnectionOptions Options(bool publishMicrophone)
+        {
+            ConnectionOptions options;
+            options.publishMicrophone = publishMicrophone;
+            options.audience = !publishMicrophone;
+            return options;
+        }
+
+        FakeVoiceEngine& m_engine;
+        AgoraEventHandler m_events; // callbacks never fire: the clock is never advanced
+    };
+
+    void TestMonitorEightRadios()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        for (int i = 0; i < 8; ++i) {
+            CHECK(session.Join("radio_channel_" + std::to_string(i), false) == 0);
+        }
+        CHECK(engine.joins == 8);
+        CHECK(engine.leaves == 0);
+        CHECK(session.GetConnectionCount() == 8);
+        CHECK(engine.Publishers() == 0);
+
+        CHECK(session.Join("radio_channel_8", false) == MultiChannelSession::kErrTooManyConnections);
+        CHECK(engine.joins == 8);
+    }
+
+    void TestRejoinIsNoOp()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        CHECK(session.Join("radio_channel_1", false) == 0);
+        CHECK(session.Join("radio_channel_1", false) == 0);
+        CHECK(engine.joins == 1);
+
+        // Joining an existing radio with talk only switches publish state
+        CHECK(session.Join("radio_channel_1", true) == 0);
+        CHECK(engine.joins == 1);
+        CHECK(engine.updates == 1);
+        CHECK(session.GetTalkChannel() == "radio_channel_1");
+    }
+
+    void TestTalkSwitchDoesNotRejoin()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        CHECK(session.Join("radio_channel_1", true) == 0);
+        CHECK(session.Join("radio_channel_2", false) == 0);
+        CHECK(session.Join("radio_channel_3", false) == 0);
+        CHECK(engine.Publishers() == 1);
+
+        for (int i = 0; i < 100; ++i) {
+            CHECK(session.SetTalkChannel(i % 2 ? "radio_channel_2" : "radio_channel_3") == 0);
+            CHECK(engine.Publishers() == 1);
+        }
+        CHECK(engine.joins == 3);
+        CHECK(engine.leaves == 0);
+
+        CHECK(session.SetTalkChannel("") == 0);
+        CHECK(engine.Publishers() == 0);
+        CHECK(session.SetTalkChannel("radio_channel_9") == MultiChannelSession::kErrInvalidArgument);
+    }
+
+    void TestJoinWithTalkReleasesPreviousTalker()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        CHECK(session.Join("radio_channel_1", true) == 0);
+        CHECK(session.Join("radio_channel_2", true) == 0);
+        CHECK(engine.Publishers() == 1);
+        CHECK(engine.publishing["radio_channel_2"]);
+        CHECK(session.GetTalkChannel() == "radio_channel_2");
+    }
+
+    void TestFailedKeyUpRestoresPreviousTalker()
+    {
+        FakeEngineConfig config;
+        config.manualClock = true;
+        FakeVoiceEngine fake(config);
+        AgoraEventHandler events;
+        CHECK(fake.Initialize("app", &events) == 0);
+        FakeVoiceConnections engine(fake);
+        MultiChannelSession session(engine);
+
+        CHECK(session.Join("fire", true) == 0);
+        CHECK(session.Join("ems", false) == 0);
+
+        // The new talker's join fails: fire is keyed again and stays the talk channel
+        fake.FailNext(FakeCall::JoinConnection, FakeVoiceEngine::kErrFailed);
+        CHECK(session.Join("police", true) == FakeVoiceEngine::kErrFailed);
+        CHECK(!session.IsJoined("police"));
+        CHECK(session.GetTalkChannel() == "fire");
+        CHECK(engine.Publishing("fire"));
+
+        // The new talker can't be keyed (its connection went away underneath): same
+        fake.LeaveConnection("ems", FakeVoiceConnections::kUid);
+        CHECK(session.SetTalkChannel("ems") != 0);
+        CHECK(session.GetTalkChannel() == "fire");
+        CHECK(engine.Publishing("fire"));
+
+        // Un-publishing the old talker fails: nothing else is touched
+        fake.FailNext(FakeCall::UpdateConnection, FakeVoiceEngine::kErrFailed);
+        CHECK(session.Join("police", true) == FakeVoiceEngine::kErrFailed);
+        CHECK(!session.IsJoined("police"));
+        CHECK(session.GetTalkChannel() == "fire" && engine.Publishing("fire"));
+
+        session.LeaveAll();
+        fake.Release();
+    }
+
+    void TestLeave()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        CHECK(session.Join("radio_channel_1", true) == 0);
+        CHECK(session.Join("radio_channel_2", false) == 0);
+        CHECK(session.Leave("radio_channel_1") == 0);
+        CHECK(session.GetTalkChannel().empty());
+        CHECK(session.Leave("radio_channel_1") == 0);
+        CHECK(engine.leaves == 1);
+
+        session.LeaveAll();
+        CHECK(engine.leaves == 2);
+        CHECK(session.GetConnectionCount() == 0);
+    }
+
+    void TestFailedJoinIsNotTracked()
+    {
+        FakeConnectionEngine engine;
+        MultiChannelSession session(engine);
+
+        engine.failJoin = true;
+        CHECK(session.Join("radio_channel_1", false) != 0);
+        CHECK(!session.IsJoined("radio_channel_1"));
+        CHECK(session.Join("", false) == MultiChannelSession::kErrInvalidArgument);
+    }
+}
+
+int main()
+{
+    TestMonitorEightRadios();
+    TestRejoinIsNoOp();
+    TestTalkSwitchDoesNotRejoin();
+    TestJoinWithTalkReleasesPreviousTalker();
+    TestFailedKeyUpRestoresPreviousTalker();
+    TestLeave();
+    TestFailedJoinIsNotTracked();
+
+    if (g_failures == 0) std::printf("MultiChannelSessionTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,292 @@
+// Tests for the radio mixer: pan and gain per radio and per user, sample-accurate ramps,
+// priority ducking with its hold, the loudness normalizer's gain, and the frames it leaves
+// alone (disabled, nobody staged, another format). Runs on every ISA the machine has, since the mix loops are SIMD.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/RadioMixerTests
+#include "../RadioMixer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kSampleRate = 48000;
+    constexpr int kFrame = 480; // 10 ms
+
+    struct CountingSink : IRemoteAudioSink
+    {
+        int frames = 0;
+        void OnRemoteAudioFrame(const char*, uint32_t, const int16_t*, int, int, int) override { ++frames; }
+    };
+
+    RadioMix Mix(const std::string& channel, uint32_t uid, float gainDb, float pan, int priority = 0)
+    {
+        RadioMix mix;
+        mix.channelName = channel;
+        mix.uid = uid;
+        mix.gainDb = gainDb;
+        mix.pan = pan;
+        mix.priority = priority;
+        return mix;
+    }
+
+    RadioMixerConfig Enabled(int rampMs = 20)
+    {
+        RadioMixerConfig config;
+        config.enabled = true;
+        config.rampMs = rampMs;
+        return config;
+    }
+
+    // One stereo frame of the users given, all sending a constant level
+    struct Bench
+    {
+        explicit Bench(const DspKernels& kernels = GetDspKernels()) : mixer(kernels) {}
+
+        bool Render(std::initializer_list<std::pair<const char*, uint32_t>> talkers, int16_t level = 10000, int channels = 2)
+        {
+            std::vector<int16_t> voice(kFrame, level);
+            for (const auto& talker : talkers) {
+                mixer.OnRemoteAudioFrame(talker.first, talker.second, voice.data(), kFrame, 1, kSampleRate);
+            }
+            out.assign(static_cast<size_t>(kFrame) * channels, static_cast<int16_t>(-1));
+            return mixer.Render(out.data(), kFrame, channels, kSampleRate);
+        }
+
+        int16_t Left() const { return out[0]; }
+        int16_t Right() const { return out[1]; }
+        int16_t LastLeft() const { return out[out.size() - 2]; }
+
+        RadioMixer mixer;
+        std::vector<int16_t> out;
+    };
+
+    void TestPanAndGain(const DspKernels& kernels)
+    {
+        Bench bench(kernels);
+        bench.mixer.SetConfig(Enabled());
+        bench.mixer.SetMix(Mix("fire", 0, -6.0f, -0.5f));
+        bench.mixer.SetMix(Mix("ems", 0, 0.0f, 1.0f));
+
+        // The settings are picked up by the first Render; frames count from the next
+        CHECK(!bench.Render({ { "fire", 1 } }));
+        CHECK(bench.Render({ { "fire", 1 } }));
+        // Balance law: the near side stays at the radio's gain, the far side turns down
+        CHECK(bench.Left() == 5012 && bench.Right() == 2506);
+
+        CHECK(bench.Render({ { "ems", 2 } }));
+        CHECK(bench.Left() == 0 && bench.Right() == 10000);
+
+        // Both at once, summed and saturated
+        CHECK(bench.Render({ { "fire", 1 }, { "ems", 2 }, { "ems", 3 } }, 20000));
+        CHECK(bench.Left() == 10024 && bench.Right() == 32767);
+        CHECK(bench.mixer.GetActiveStreams() == 3);
+
+        // Mono output: gain only
+        CHECK(bench.Render({ { "fire", 1 } }, 10000, 1));
+        CHECK(bench.out[0] == 5012 && bench.out[kFrame - 1] == 5012);
+    }
+
+    void TestRampIsSampleAccurate(const DspKernels& kernels)
+    {
+        Bench bench(kernels);
+        bench.mixer.SetConfig(Enabled(5)); // 240 samples
+        bench.Render({ { "fire", 1 } });
+        CHECK(bench.Render({ { "fire", 1 } }) && bench.Left() == 10000);
+
+        // Off: down in a straight line over exactly 240 samples, then silence
+        bench.mixer.SetMix(Mix("fire", 0, RadioMixer::kMinGainDb, 0.0f));
+        CHECK(bench.Render({ { "fire", 1 } }));
+        CHECK(bench.Left() == 10000);
+        CHECK(std::abs(bench.out[2 * 120] - 5000) <= 1);
+        CHECK(std::abs(bench.out[2 * 239] - 42) <= 1);
+        CHECK(bench.out[2 * 240] == 0 && bench.LastLeft() == 0);
+        bool smooth = true;
+        for (int i = 1; i < kFrame; ++i) {
+            smooth = smooth && bench.out[2 * (i - 1)] - bench.out[2 * i] <= 10000 / 240 + 1 && bench.out[2 * i] <= bench.out[2 * (i - 1)];
+        }
+        CHECK(smooth);
+
+        // A ramp longer than a frame carries on into the next one where it left off
+        bench.mixer.SetConfig(Enabled(15)); // 720 samples; clears the mixes
+        CHECK(bench.Render({ { "fire", 1 } }));
+        CHECK(bench.Left() == 0 && std::abs(bench.LastLeft() - 6653) <= 2);
+        CHECK(bench.Render({ { "fire", 1 } }));
+        CHECK(std::abs(bench.Left() - 6667) <= 2 && bench.out[2 * 240] == 10000);
+    }
+
+    void TestDuckingByPriority(const DspKernels& kernels)
+    {
+        Bench bench(kernels);
+        RadioMixerConfig config = Enabled(1);
+        config.duckDb = -20.0f;
+        config.duckHoldMs = 100;
+        bench.mixer.SetConfig(config);
+        bench.mixer.SetMix(Mix("fire", 0, 0.0f, -1.0f));
+        bench.mixer.SetMix(Mix("ems", 0, 0.0f, -1.0f));
+        bench.mixer.SetMix(Mix("police", 0, 0.0f, 1.0f, 2));
+        bench.mixer.SetMix(Mix("dispatch", 0, 0.0f, 1.0f, 1));
+        bench.Render({});
+
+        // Equal priorities never duck each other
+        CHECK(bench.Render({ { "fire", 1 }, { "ems", 2 } }, 5000));
+        CHECK(bench.Left() == 10000);
+
+        // Someone on police: fire and ems drop 20 dB within the ramp, police stays
+        bench.Render({ { "fire", 1 }, { "ems", 2 }, { "police", 3 } }, 5000);
+        CHECK(bench.LastLeft() == 1000 && bench.Right() == 5000);
+        CHECK(bench.mixer.GetDuckedFrames() == 1);
+
+        // Background hiss on police is not a speaker: once the hold runs out, nothing is ducked
+        for (int i = 0; i < 12; ++i) bench.Render({ { "fire", 1 }, { "police", 3 } }, 20);
+        CHECK(bench.LastLeft() == 20);
+
+        // A lower priority speaker only ducks what is below it
+        bench.Render({ { "fire", 1 }, { "dispatch", 4 } }, 5000);
+        CHECK(bench.LastLeft() == 500 && bench.Right() == 5000);
+
+        // The hold: ducked for 100 ms after the last loud frame, then back up
+        for (int i = 0; i < 10; ++i) bench.Render({ { "fire", 1 } }, 5000);
+        CHECK(bench.LastLeft() == 500);
+        bench.Render({ { "fire", 1 } }, 5000);
+        CHECK(bench.LastLeft() == 5000);
+    }
+
+    void TestUserOverrides()
+    {
+        Bench bench;
+        bench.mixer.SetConfig(Enabled(1));
+        bench.mixer.SetMix(Mix("fire", 0, -6.0f, -1.0f, 3));
+        bench.mixer.SetMix(Mix("fire", 42, -6.0f, 1.0f, 7)); // a user's priority is ignored
+        bench.Render({});
+
+        // The user's gain stacks on the radio's, its pan replaces it
+        CHECK(bench.Render({ { "fire", 42 } }));
+        CHECK(bench.Left() == 0 && std::abs(bench.Right() - 2512) <= 1);
+        CHECK(bench.Render({ { "fire", 7 } }));
+        CHECK(bench.Left() == 5012 && bench.Right() == 0);
+
+        RadioMixerConfig config = bench.mixer.GetConfig();
+        CHECK(config.mixes.size() == 2 && config.mixes[1].priority == 0);
+
+        // Neutral settings drop the entry, values are clamped
+        bench.mixer.SetMix(Mix("fire", 42, 0.0f, 0.0f));
+        bench.mixer.SetMix(Mix("ems", 0, 40.0f, -3.0f, 20));
+        config = bench.mixer.GetConfig();
+        CHECK(config.mixes.size() == 2 && config.mixes[1].channelName == "ems");
+        CHECK(config.mixes[1].gainDb == RadioMixer::kMaxGainDb && config.mixes[1].pan == -1.0f &&
+              config.mixes[1].priority == RadioMixer::kMaxPriority);
+    }
+
+    void TestNormalizerLevelsUsers()
+    {
+        LoudnessNormalizer normalizer;
+        LoudnessConfig loudness;
+        loudness.enabled = true;
+        normalizer.SetConfig(loudness);
+        RadioMixer mixer;
+        mixer.SetNormalizer(&normalizer);
+
+        // A 997 Hz tone at -27 dBFS is about -30 LUFS, 10 dB under the target
+        std::vector<int16_t> voice(kFrame);
+        std::vector<int16_t> out(kFrame * 2);
+        long long position = 0;
+        auto render = [&]() {
+            for (int i = 0; i < kFrame; ++i, ++position) {
+                voice[i] = static_cast<int16_t>(std::lround(1460.0 * std::sin(2.0 * 3.14159265358979 * 997.0 * position / kSampleRate)));
+            }
+            mixer.OnRemoteAudioFrame("fire", 1, voice.data(), kFrame, 1, kSampleRate);
+            return mixer.Render(out.data(), kFrame, 2, kSampleRate);
+        };
+
+        // Levelling alone rebuilds playback, centred at unity apart from the leveller's gain
+        CHECK(!render());
+        for (int i = 0; i < 50; ++i) render();
+        CHECK(render());
+        int16_t peak = *std::max_element(out.begin(), out.end());
+        CHECK(std::abs(peak - 4630) < 50);
+        CHECK(out[100] == out[101] && !mixer.GetConfig().enabled);
+
+        loudness.enabled = false;
+        normalizer.SetConfig(loudness);
+        render();
+        CHECK(!render());
+    }
+
+    void TestFramesLeftAlone()
+    {
+        Bench bench;
+        CountingSink next;
+        bench.mixer.SetNext(&next);
+
+        // Disabled: the SDK's mix stays, the recorder still gets every frame
+        CHECK(!bench.Render({ { "fire", 1 } }));
+        CHECK(bench.Left() == -1 && next.frames == 1);
+
+        bench.mixer.SetConfig(Enabled());
+        bench.Render({});
+        CHECK(!bench.Render({}));
+        CHECK(bench.Left() == -1);
+
+        // Another rate than the output's is dropped, not resampled
+        std::vector<int16_t> voice(160, 1000);
+        bench.mixer.OnRemoteAudioFrame("fire", 1, voice.data(), 160, 1, 16000);
+        std::vector<int16_t> out(kFrame * 2, -1);
+        CHECK(!bench.mixer.Render(out.data(), kFrame, 2, kSampleRate));
+        CHECK(bench.mixer.GetDroppedFrames() == 1);
+
+        // Stereo users are folded to mono
+        std::vector<int16_t> stereo(kFrame * 2);
+        for (int i = 0; i < kFrame; ++i) {
+            stereo[2 * i] = 3000;
+            stereo[2 * i + 1] = 1000;
+        }
+        bench.mixer.OnRemoteAudioFrame("fire", 1, stereo.data(), kFrame, 2, kSampleRate);
+        CHECK(bench.mixer.Render(out.data(), kFrame, 2, kSampleRate) && out[0] == 2000 && out[1] == 2000);
+
+        // More users than slots: the extra ones are dropped and counted
+        for (uint32_t uid = 100; uid < 100 + RadioMixer::kMaxStreams + 2; ++uid) {
+            bench.mixer.OnRemoteAudioFrame("ems", uid, voice.data(), 160, 1, kSampleRate);
+        }
+        CHECK(bench.mixer.GetDroppedFrames() == 4);
+
+        // Idle users give their slots back
+        for (int i = 0; i < RadioMixer::kIdleFrames + 2; ++i) bench.Render({});
+        CHECK(bench.mixer.GetActiveStreams() == 0);
+        CHECK(bench.Render({ { "ems", 500 } }));
+        CHECK(bench.mixer.GetActiveStreams() == 1);
+    }
+}
+
+int main()
+{
+    std::vector<DspIsa> isas{ DspIsa::Scalar };
+    if (DetectDspIsa() >= DspIsa::Sse2) isas.push_back(DspIsa::Sse2);
+    if (DetectDspIsa() >= DspIsa::Avx2) isas.push_back(DspIsa::Avx2);
+    for (DspIsa isa : isas) {
+        TestPanAndGain(GetDspKernels(isa));
+        TestRampIsSampleAccurate(GetDspKernels(isa));
+        TestDuckingByPriority(GetDspKernels(isa));
+    }
+    TestUserOverrides();
+    TestNormalizerLevelsUsers();
+    TestFramesLeftAlone();
+
+    if (g_failures == 0) std::printf("RadioMixerTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
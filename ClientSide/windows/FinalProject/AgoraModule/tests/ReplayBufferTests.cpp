@@ -0,0 +1,259 @@
+// Headless tests for the instant-replay rings, ADPCM codec and replay player.
+// Build: g++ -std=c++17 -O2 -pthread -I.. ReplayBufferTests.cpp ../ReplayBuffer.cpp ../ImaAdpcm.cpp -o ReplayBufferTests
+#include "../ReplayBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kRate = ReplayBlock::kSampleRate;
+    constexpr int kBlock = ReplayBlock::kSamples;
+
+    // frames at rate, same value in every channel; phase counts frames already produced
+    std::vector<int16_t> Tone(int frames, int channels, int rate, float hz, float amplitude, int phase = 0)
+    {
+        std::vector<int16_t> samples(static_cast<size_t>(frames) * channels);
+        for (int i = 0; i < frames; ++i) {
+            auto value = static_cast<int16_t>(amplitude * std::sin(2.0 * 3.14159265358979 * hz * (i + phase) / rate));
+            for (int c = 0; c < channels; ++c) samples[static_cast<size_t>(i) * channels + c] = value;
+        }
+        return samples;
+    }
+
+    // Records ms of tone for uid starting at startMs, one 10 ms frame at a time
+    void Talk(ReplayRecorder& recorder, const char* channel, uint32_t uid, uint64_t startMs, int ms, float hz = 400.0f)
+    {
+        for (int t = 0; t < ms; t += 10) {
+            auto frame = Tone(kBlock, 1, kRate, hz, 8000.0f, t * kRate / 1000);
+            recorder.Record(channel, uid, frame.data(), kBlock, 1, kRate, startMs + t);
+        }
+    }
+
+    void TestAdpcmRoundTrip()
+    {
+        auto pcm = Tone(kRate, 1, kRate, 440.0f, 12000.0f);
+        std::vector<uint8_t> coded(AdpcmBytes(pcm.size()));
+        std::vector<int16_t> decoded(pcm.size());
+        AdpcmState encoder, decoder;
+        AdpcmEncode(pcm.data(), pcm.size(), coded.data(), encoder);
+        AdpcmDecode(coded.data(), coded.size() * 2, decoded.data(), decoder);
+        CHECK(encoder.predictor == decoder.predictor && encoder.stepIndex == decoder.stepIndex);
+
+        double signal = 0.0, noise = 0.0;
+        for (size_t i = 0; i < pcm.size(); ++i) {
+            signal += static_cast<double>(pcm[i]) * pcm[i];
+            noise += static_cast<double>(pcm[i] - decoded[i]) * (pcm[i] - decoded[i]);
+        }
+        double snrDb = 10.0 * std::log10(signal / noise);
+        std::printf("ADPCM SNR at 440 Hz: %.1f dB\n", snrDb);
+        CHECK(snrDb > 20.0);
+    }
+
+    void TestRingKeepsNewestBlocks()
+    {
+        ReplayRing ring("alpha", 8);
+        std::vector<int16_t> block(kBlock, 1000);
+        for (uint64_t i = 0; i < 20; ++i) {
+            ring.Append(static_cast<uint32_t>(i % 2 + 1), i * 10, block.data());
+        }
+
+        std::vector<ReplayBlock> blocks;
+        ring.Snapshot(0, 0, blocks);
+        CHECK(blocks.size() == 8);
+        CHECK(!blocks.empty() && blocks.front().timeMs == 120 && blocks.back().timeMs == 190);
+
+        ring.Snapshot(150, 0, blocks);
+        CHECK(blocks.size() == 5);
+        ring.Snapshot(0, 2, blocks);
+        CHECK(blocks.size() == 4);
+        for (const auto& b : blocks) CHECK(b.uid == 2);
+
+        // Every block decodes on its own from its stored state
+        int16_t decoded[kBlock];
+        AdpcmState state = blocks.back().state;
+        AdpcmDecode(blocks.back().data, kBlock, decoded, state);
+        CHECK(std::abs(decoded[kBlock - 1] - 1000) < 50);
+    }
+
+    void TestRecorderCapacityAndSilence()
+    {
+        ReplayRecorder recorder;
+        CHECK(recorder.GetMemoryBytes() == 0);
+        CHECK(recorder.SetCapacity("alpha", 2));
+        CHECK(recorder.GetCapacitySeconds("alpha") == 2);
+        CHECK(recorder.GetMemoryBytes() >= 2 * ReplayRecorder::BytesPerSecond());
+        CHECK(recorder.GetMemoryBytes() < 2 * ReplayRecorder::BytesPerSecond() + 1024);
+        CHECK(recorder.SetCapacity("bravo", ReplayRecorder::kMaxSeconds * 10));
+        CHECK(recorder.GetCapacitySeconds("bravo") == ReplayRecorder::kMaxSeconds);
+        recorder.Remove("bravo");
+        CHECK(recorder.GetCapacitySeconds("bravo") == 0);
+
+        // Silence and unknown channels are not stored; 48 kHz stereo is reduced to 16 kHz mono
+        std::vector<int16_t> quiet(480 * 2, 20);
+        recorder.Record("alpha", 7, quiet.data(), 480, 2, 48000, 1000);
+        auto loud = Tone(480, 2, 48000, 400.0f, 8000.0f);
+        recorder.Record("charlie", 7, loud.data(), 480, 2, 48000, 1000);
+        std::vector<int16_t> pcm;
+        CHECK(!recorder.BuildClip("alpha", 10, 0, 1010, pcm));
+        recorder.Record("alpha", 7, loud.data(), 480, 2, 48000, 1000);
+        CHECK(recorder.BuildClip("alpha", 10, 0, 1010, pcm));
+        CHECK(pcm.size() == static_cast<size_t>(kBlock));
+
+        // 44.1 kHz can't be decimated by a whole number and is dropped
+        recorder.Record("alpha", 8, loud.data(), 441, 1, 44100, 1010);
+        CHECK(recorder.GetIndex("alpha", 10, 1020).size() == 1);
+
+        // Two seconds of ring: older traffic falls out
+        Talk(recorder, "alpha", 7, 2000, 3000);
+        CHECK(recorder.BuildClip("alpha", 60, 0, 5000, pcm));
+        CHECK(pcm.size() == static_cast<size_t>(2 * kRate));
+        CHECK(recorder.SetCapacity("alpha", 3));
+        CHECK(!recorder.BuildClip("alpha", 60, 0, 5000, pcm)); // a resize starts empty
+
+        for (int i = 0; i < static_cast<int>(ReplayRecorder::kMaxChannels); ++i) {
+            recorder.SetCapacity("radio" + std::to_string(i), 1);
+        }
+        CHECK(!recorder.SetCapacity("onetoomany", 1));
+        recorder.Clear();
+        CHECK(recorder.GetMemoryBytes() == 0);
+    }
+
+    void TestClipTimelineAndIndex()
+    {
+        ReplayRecorder recorder;
+        recorder.SetCapacity("alpha", 60);
+
+        // uid 1 talks 1 s, 5 s of silence, uid 2 talks 0.5 s while uid 1 answers over the end of it
+        Talk(recorder, "alpha", 1, 10000, 1000, 300.0f);
+        Talk(recorder, "alpha", 2, 16000, 500, 500.0f);
+        Talk(recorder, "alpha", 1, 16400, 200, 300.0f);
+
+        std::vector<int16_t> pcm;
+        CHECK(recorder.BuildClip("alpha", 60, 0, 17000, pcm));
+        // 1 s + 0.5 s collapsed gap + 0.6 s of overlapping second exchange
+        size_t expected = static_cast<size_t>((1000 + ReplayRecorder::kMaxGapMs + 600) * kRate / 1000);
+        CHECK(pcm.size() == expected);
+
+        CHECK(recorder.BuildClip("alpha", 60, 2, 17000, pcm));
+        CHECK(pcm.size() == static_cast<size_t>(kRate / 2));
+        CHECK(recorder.BuildClip("alpha", 2, 1, 17000, pcm));
+        CHECK(pcm.size() == static_cast<size_t>(kRate / 5)); // only the answer is in the last 2 s
+        CHECK(!recorder.BuildClip("alpha", 60, 99, 17000, pcm));
+
+        auto index = recorder.GetIndex("alpha", 60, 17000);
+        CHECK(index.size() == 3);
+        if (index.size() == 3) {
+            CHECK(index[0].uid == 1 && index[0].startMs == 10000 && index[0].endMs == 11000);
+            CHECK(index[1].uid == 2 && index[1].startMs == 16000 && index[1].endMs == 16500);
+            CHECK(index[2].uid == 1 && index[2].startMs == 16400 && index[2].endMs == 16600);
+        }
+
+        // A short pause stays within one spurt
+        Talk(recorder, "alpha", 2, 16700, 300);
+        index = recorder.GetIndex("alpha", 60, 17000);
+        CHECK(index.size() == 3 && index[1].uid == 2 && index[1].endMs == 17000);
+    }
+
+    void TestPlayerResamplesAndFinishes()
+    {
+        ReplayPlayer player;
+        CHECK(!player.IsPlaying());
+
+        std::vector<int16_t> output(480 * 2, 0);
+        CHECK(!ReplayPlayer::MixInto(&player, output.data(), 480, 2, 48000));
+
+        // 100 ms at 16 kHz -> ten 10 ms frames at 48 kHz stereo
+        player.Play(std::vector<int16_t>(1600, 4000), kRate);
+        CHECK(player.IsPlaying());
+        int frames = 0;
+        while (ReplayPlayer::MixInto(&player, output.data(), 480, 2, 48000) && frames < 100) {
+            CHECK(output[0] == 4000 && output[1] == 4000);
+            std::fill(output.begin(), output.end(), static_cast<int16_t>(0));
+            ++frames;
+        }
+        CHECK(frames >= 10 && frames <= 11); // the last frame may carry a rounding tail
+        CHECK(!player.IsPlaying());
+
+        // Mixing adds with saturation; Stop cuts the clip off at the next frame
+        player.Play(std::vector<int16_t>(16000, 30000), kRate);
+        std::fill(output.begin(), output.end(), static_cast<int16_t>(10000));
+        CHECK(player.Mix(output.data(), 480, 2, 48000));
+        CHECK(output[5] == 32767);
+        player.Stop();
+        CHECK(!player.Mix(output.data(), 480, 2, 48000));
+        CHECK(!player.IsPlaying());
+
+        // Replaced before the audio thread picked it up: the newer clip wins
+        player.Play(std::vector<int16_t>(1600, 100), kRate);
+        player.Play(std::vector<int16_t>(1600, 200), kRate);
+        std::fill(output.begin(), output.end(), static_cast<int16_t>(0));
+        CHECK(player.Mix(output.data(), 480, 1, 48000));
+        CHECK(output[0] == 200);
+    }
+
+    // Audio thread writing while the worker resizes and readers snapshot (run under TSan too)
+    void TestConcurrentRecordAndRead()
+    {
+        ReplayRecorder recorder;
+        recorder.SetCapacity("alpha", 1);
+        std::atomic<bool> stop{ false };
+        std::atomic<int> clips{ 0 };
+
+        std::thread audio([&]() {
+            auto frame = Tone(480, 1, 48000, 400.0f, 8000.0f);
+            uint64_t nowMs = 0;
+            while (!stop.load()) {
+                recorder.Record("alpha", static_cast<uint32_t>(nowMs / 100 % 3 + 1), frame.data(), 480, 1, 48000, nowMs);
+                nowMs += 10;
+            }
+        });
+        std::thread reader([&]() {
+            std::vector<int16_t> pcm;
+            while (!stop.load()) {
+                // nowMs 0: the window reaches back to the start of the recorder clock
+                if (recorder.BuildClip("alpha", 600, 0, 0, pcm)) clips.fetch_add(1);
+                recorder.GetIndex("alpha", 600, 0);
+            }
+        });
+
+        for (int i = 0; i < 200; ++i) {
+            recorder.SetCapacity("alpha", i % 3 + 1);
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        stop.store(true);
+        audio.join();
+        reader.join();
+        CHECK(clips.load() > 0);
+    }
+}
+
+int main()
+{
+    TestAdpcmRoundTrip();
+    TestRingKeepsNewestBlocks();
+    TestRecorderCapacityAndSilence();
+    TestClipTimelineAndIndex();
+    TestPlayerResamplesAndFinishes();
+    TestConcurrentRecordAndRead();
+
+    if (g_failures == 0) std::printf("ReplayBufferTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+// Tests for the cue tones: the bank (every cue at every rate, aligned, the right length), timing
+// (a cue starts at the first sample of the next frame, ringing repeats on its period and stops
+// on the frame after Stop), mixing (exact scaled copies on every channel, uplink only when asked,
+// saturation and the limiter with the playback pipeline) and triggers that never allocate.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/ToneEngineTests
+#include "../AudioPipeline.h"
+#include "../ToneEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+// Every allocation in the process, so a trigger's cost can be read as a counter delta
+static std::atomic<uint64_t> g_allocations{ 0 };
+
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* block = std::malloc(size ? size : 1)) return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept { std::free(block); }
+void operator delete(void* block, std::size_t) noexcept { std::free(block); }
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kRate = 48000;
+    constexpr int kFrame = kRate / 100; // 10 ms per channel
+
+    // Manual clock in microseconds
+    uint64_t g_nowUs = 1000000;
+    uint64_t TestClock() { return g_nowUs; }
+
+    struct Frames
+    {
+        std::vector<int16_t> samples;
+        int channels;
+        explicit Frames(int channelCount) : samples(static_cast<size_t>(kFrame) * channelCount), channels(channelCount) {}
+        void Clear() { std::fill(samples.begin(), samples.end(), static_cast<int16_t>(0)); }
+        bool Silent() const { return std::all_of(samples.begin(), samples.end(), [](int16_t s) { return s == 0; }); }
+    };
+
+    bool Playback(ToneEngine& tones, Frames& frames)
+    {
+        frames.Clear();
+        return ToneEngine::MixPlayback(&tones, frames.samples.data(), kFrame, frames.channels, kRate);
+    }
+
+    bool Capture(ToneEngine& tones, Frames& frames)
+    {
+        frames.Clear();
+        return ToneEngine::MixCapture(&tones, frames.samples.data(), kFrame, frames.channels, kRate);
+    }
+
+    int32_t Scaled(int16_t sample, float levelDb)
+    {
+        return (sample * GainDbToQ12(levelDb) + 2048) >> 12;
+    }
+
+    void TestBankHasEveryCue()
+    {
+        ToneEngine tones;
+        const ToneBank& bank = tones.GetBank();
+        for (int rate : ToneBank::kRates) {
+            for (size_t c = 0; c < kToneCueCount; ++c) {
+                auto cue = static_cast<ToneCue>(c);
+                const ToneBank::Tone* tone = bank.Find(cue, rate);
+                CHECK(tone != nullptr);
+                if (!tone) continue;
+                CHECK(reinterpret_cast<uintptr_t>(tone->samples) % ToneBank::kAlignment == 0);
+                CHECK(tone->count == static_cast<size_t>(ToneBank::DurationMs(cue)) * rate / 1000);
+                CHECK(tone->period == static_cast<size_t>(ToneBank::PeriodMs(cue)) * rate / 1000);
+
+                // Loud, fading in from silence and out to it
+                int32_t peak = 0;
+                for (size_t i = 0; i < tone->count; ++i) peak = std::max(peak, std::abs(static_cast<int32_t>(tone->samples[i])));
+                CHECK(peak > 29000);
+                CHECK(tone->samples[0] == 0 && std::abs(tone->samples[tone->count - 1]) < 2000);
+            }
+        }
+        CHECK(bank.Find(ToneCue::Ring, 22050) == nullptr);
+
+        ToneCue parsed = ToneCue::Ring;
+        CHECK(ParseToneCue("talkStart", parsed) && parsed == ToneCue::TalkStart);
+        CHECK(ParseToneCue(ToneCueName(ToneCue::Ringback), parsed) && parsed == ToneCue::Ringback);
+        CHECK(!ParseToneCue("siren", parsed) && !ParseToneCue(nullptr, parsed));
+    }
+
+    void TestStartsOnTheNextFrame()
+    {
+        ToneEngine tones(&TestClock);
+        Frames stereo(2), mono(1);
+        CHECK(!Playback(tones, stereo) && stereo.Silent());
+
+        // Triggered 3 ms before the playback callback: in that frame, from its first sample
+        tones.Play(ToneCue::TalkStart);
+        CHECK(!tones.IsPlaying(ToneCue::TalkStart));
+        g_nowUs += 3000;
+        CHECK(Playback(tones, stereo));
+        CHECK(tones.IsPlaying(ToneCue::TalkStart));
+        CHECK(tones.GetLastStartUs() == 3000 && tones.GetStarted() == 1);
+
+        const ToneBank::Tone* tone = tones.GetBank().Find(ToneCue::TalkStart, kRate);
+        bool exact = true;
+        for (int i = 0; i < kFrame; ++i) {
+            int32_t expected = Scaled(tone->samples[i], tones.GetConfig().levelDb);
+            exact = exact && stereo.samples[i * 2] == expected && stereo.samples[i * 2 + 1] == expected;
+        }
+        CHECK(exact);
+        CHECK(*std::max_element(stereo.samples.begin(), stereo.samples.end()) > 0);
+
+        // Local only: nothing went out
+        CHECK(!Capture(tones, mono) && mono.Silent());
+
+        // 100 ms = 10 frames, then done
+        for (int frame = 1; frame < 10; ++frame) CHECK(Playback(tones, stereo));
+        CHECK(!tones.IsPlaying(ToneCue::TalkStart));
+        CHECK(!Playback(tones, stereo) && stereo.Silent());
+        CHECK(tones.GetMaxStartUs() < 10000);
+    }
+
+    void TestUplinkAndRestart()
+    {
+        ToneEngine tones(&TestClock);
+        Frames mono(1), first(1);
+
+        tones.Play(ToneCue::Roger, true);
+        CHECK(Capture(tones, first));
+        CHECK(Capture(tones, mono));
+        CHECK(mono.samples != first.samples);
+
+        // Play again mid-cue: back to the first sample on both sides
+        tones.Play(ToneCue::Roger, true);
+        CHECK(Capture(tones, mono));
+        CHECK(mono.samples == first.samples);
+        Frames playback(1);
+        CHECK(Playback(tones, playback) && playback.samples == first.samples);
+
+        // A local-only trigger drops it from the uplink
+        tones.Play(ToneCue::Roger);
+        CHECK(!Capture(tones, mono) && mono.Silent());
+    }
+
+    void TestRingRepeatsUntilStopped()
+    {
+        ToneEngine tones(&TestClock);
+        Frames stereo(2), first(2);
+
+        tones.Play(ToneCue::Ring);
+        CHECK(Playback(tones, first));
+        // Double ring: 1 s of sound, 2 s of silence, then again from the top
+        int sounding = 1;
+        for (int frame = 1; frame < 300; ++frame) sounding += Playback(tones, stereo) ? 1 : 0;
+        CHECK(sounding == 100);
+        CHECK(tones.IsPlaying(ToneCue::Ring));
+        CHECK(Playback(tones, stereo) && stereo.samples == first.samples);
+
+        tones.Stop(ToneCue::Ring);
+        CHECK(!Playback(tones, stereo) && stereo.Silent());
+        CHECK(!tones.IsPlaying(ToneCue::Ring));
+
+        // A rate the bank has no buffers for skips the cue instead of playing it wrong
+        tones.Play(ToneCue::Ring);
+        std::vector<int16_t> odd(441, 0);
+        CHECK(!ToneEngine::MixPlayback(&tones, odd.data(), 441, 1, 44000));
+        CHECK(tones.GetUnsupportedFrames() == 1 && !tones.IsPlaying(ToneCue::Ring));
+    }
+
+    void TestLevelAndOverlap()
+    {
+        ToneEngine tones(&TestClock);
+        Frames quiet(1), loud(1), both(1);
+
+        ToneConfig config;
+        config.levelDb = -30.0f;
+        tones.SetConfig(config);
+        tones.Play(ToneCue::Ringback);
+        Playback(tones, quiet);
+
+        config.levelDb = 6.0f; // clamped to full scale
+        tones.SetConfig(config);
+        CHECK(tones.GetConfig().levelDb == 0.0f);
+        tones.Play(ToneCue::Ringback);
+        Playback(tones, loud);
+        int16_t quietPeak = *std::max_element(quiet.samples.begin(), quiet.samples.end());
+        int16_t loudPeak = *std::max_element(loud.samples.begin(), loud.samples.end());
+        CHECK(quietPeak > 0 && loudPeak > quietPeak * 25);
+
+        // Two cues at once add up and saturate instead of wrapping
+        tones.Play(ToneCue::Ringback);
+        tones.Play(ToneCue::Ring);
+        Playback(tones, both);
+        bool saturated = true;
+        for (int i = 0; i < kFrame; ++i) {
+            int32_t sum = Scaled(tones.GetBank().Find(ToneCue::Ringback, kRate)->samples[i], 0.0f) +
+                          Scaled(tones.GetBank().Find(ToneCue::Ring, kRate)->samples[i], 0.0f);
+            saturated = saturated && both.samples[i] == std::max(-32768, std::min(32767, sum));
+        }
+        CHECK(saturated);
+    }
+
+    void TestThroughPlaybackPipeline()
+    {
+        // Near full-scale traffic plus a full-scale cue: the limiter still holds the ceiling
+        ToneEngine tones(&TestClock);
+        ToneConfig config;
+        config.levelDb = 0.0f;
+        tones.SetConfig(config);
+
+        AudioPipeline playback;
+        CHECK(playback.AddMixSource(&ToneEngine::MixPlayback, &tones));
+        AudioPipelineConfig pipeline;
+        pipeline.highPassEnabled = false;
+        pipeline.gainDb = 0.0f;
+        playback.SetConfig(pipeline);
+
+        tones.Play(ToneCue::TalkEnd);
+        const int32_t ceiling = static_cast<int32_t>(32767.0f * std::pow(10.0f, pipeline.limiterThresholdDb / 20.0f)) + 1;
+        int32_t peak = 0;
+        std::vector<int16_t> frame(static_cast<size_t>(kFrame) * 2);
+        for (int n = 0; n < 10; ++n) {
+            for (int i = 0; i < kFrame; ++i) {
+                auto value = static_cast<int16_t>(30000.0 * std::sin(2.0 * 3.14159265 * 300.0 * (n * kFrame + i) / kRate));
+                frame[i * 2] = frame[i * 2 + 1] = value;
+            }
+            CHECK(playback.Process(frame.data(), kFrame, 2, kRate));
+            for (int16_t s : frame) peak = std::max(peak, std::abs(static_cast<int32_t>(s)));
+        }
+        CHECK(peak <= ceiling);
+        CHECK(tones.GetStarted() == 1 && !tones.IsPlaying(ToneCue::TalkEnd));
+    }
+
+    void TestTriggersNeverAllocate()
+    {
+        ToneEngine tones(&TestClock);
+        Frames stereo(2), mono(1);
+        Playback(tones, stereo);
+        Capture(tones, mono);
+
+        uint64_t before = g_allocations.load();
+        for (int i = 0; i < 1000; ++i) {
+            auto cue = static_cast<ToneCue>(i % kToneCueCount);
+            tones.Play(cue, (i & 1) != 0);
+            Playback(tones, stereo);
+            Capture(tones, mono);
+            if (i % 7 == 0) tones.StopAll();
+        }
+        CHECK(g_allocations.load() == before);
+    }
+}
+
+int main()
+{
+    TestBankHasEveryCue();
+    TestStartsOnTheNextFrame();
+    TestUplinkAndRestart();
+    TestRingRepeatsUntilStopped();
+    TestLevelAndOverlap();
+    TestThroughPlaybackPipeline();
+    TestTriggersNeverAllocate();
+
+    if (g_failures == 0) std::printf("ToneEngineTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+// Headless tests for the VOX voice activity detector - no Agora SDK or WinRT required.
+//
+//   g++ -std=c++17 -O2 VoiceActivityDetectorTests.cpp ../VoiceActivityDetector.cpp ../AudioDsp.cpp -o VoiceActivityDetectorTests
+#include "../AudioDsp.h"
+#include "../VoiceActivityDetector.h"
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    constexpr int kSampleRate = 48000;
+    constexpr int kFrame = 480; // 10 ms
+    constexpr float kPi = 3.14159265f;
+
+    // Voiced speech stand-in: 150 Hz fundamental with a couple of formant-ish harmonics
+    struct VoiceSource
+    {
+        float amplitude;
+        int position = 0;
+
+        void Fill(std::vector<int16_t>& frame)
+        {
+            for (auto& sample : frame) {
+                float t = static_cast<float>(position++) / kSampleRate;
+                float value = std::sin(2.0f * kPi * 150.0f * t) + 0.6f * std::sin(2.0f * kPi * 450.0f * t) +
+                              0.3f * std::sin(2.0f * kPi * 1200.0f * t);
+                sample = static_cast<int16_t>(amplitude * value / 1.9f);
+            }
+        }
+    };
+
+    void FillSine(std::vector<int16_t>& frame, int& position, float hz, float amplitude)
+    {
+        for (auto& sample : frame) {
+            sample = static_cast<int16_t>(amplitude * std::sin(2.0f * kPi * hz * static_cast<float>(position++) / kSampleRate));
+        }
+    }
+
+    void FillNoise(std::vector<int16_t>& frame, std::mt19937& random, int amplitude)
+    {
+        std::uniform_int_distribution<int> value(-amplitude, amplitude);
+        for (auto& sample : frame) sample = static_cast<int16_t>(value(random));
+    }
+
+    VoiceActivityDetector MakeDetector(VadConfig config = VadConfig{})
+    {
+        VoiceActivityDetector detector;
+        detector.Configure(config, kSampleRate);
+        detector.Reset();
+        return detector;
+    }
+
+    void TestZeroCrossingKernelsMatchScalar()
+    {
+        const DspKernels& scalar = GetDspKernels(DspIsa::Scalar);
+        std::mt19937 random(7);
+        std::uniform_int_distribution<int> value(-32768, 32767);
+
+        // 40000 samples runs past the SIMD lane counters' drain interval
+        for (size_t count : { size_t(1), size_t(2), size_t(17), size_t(480), size_t(961), size_t(40000) }) {
+            std::vector<int16_t> samples(count);
+            for (auto& sample : samples) sample = static_cast<int16_t>(value(random));
+            for (DspIsa isa : { DspIsa::Sse2, DspIsa::Avx2 }) {
+                CHECK(GetDspKernels(isa).zeroCrossings(samples.data(), count) == scalar.zeroCrossings(samples.data(), count));
+            }
+        }
+
+        // Zero counts as positive, so only a real sign change is a crossing
+        std::vector<int16_t> steps{ 0, 5, -1, -1, 0, 3, -32768, 32767 };
+        CHECK(scalar.zeroCrossings(steps.data(), steps.size()) == 4);
+    }
+
+    void TestSpeechOpensAfterAttack()
+    {
+        VoiceActivityDetector detector = MakeDetector();
+        VoiceSource voice{ 8000.0f };
+        std::vector<int16_t> frame(kFrame);
+
+        // 30 ms attack = the third speech frame
+        for (int i = 0; i < 3; ++i) {
+            voice.Fill(frame);
+            CHECK(detector.Process(frame.data(), kFrame) == (i == 2));
+        }
+        CHECK(detector.GetLastZcr() > 0.003f && detector.GetLastZcr() < 0.30f);
+    }
+
+    void TestClicksAreIgnored()
+    {
+        VoiceActivityDetector detector = MakeDetector();
+        VoiceSource voice{ 8000.0f };
+        std::vector<int16_t> frame(kFrame);
+        std::vector<int16_t> silence(kFrame, 0);
+
+        // 20 ms bursts (a key click, a cough) separated by silence never reach the 30 ms attack
+        for (int burst = 0; burst < 10; ++burst) {
+            for (int i = 0; i < 2; ++i) {
+                voice.Fill(frame);
+                CHECK(!detector.Process(frame.data(), kFrame));
+            }
+            CHECK(!detector.Process(silence.data(), kFrame));
+        }
+    }
+
+    void TestHissAndHumAreRejected()
+    {
+        // Loud broadband hiss: well above threshold but crosses zero on about every other sample
+        VoiceActivityDetector hissDetector = MakeDetector();
+        std::mt19937 random(3);
+        std::vector<int16_t> frame(kFrame);
+        for (int i = 0; i < 100; ++i) {
+            FillNoise(frame, random, 6000);
+            CHECK(!hissDetector.Process(frame.data(), kFrame));
+        }
+        CHECK(hissDetector.GetLastZcr() > 0.30f);
+
+        // Mains hum: loud, but only 100 crossings per second
+        VoiceActivityDetector humDetector = MakeDetector();
+        int position = 0;
+        for (int i = 0; i < 100; ++i) {
+            FillSine(frame, position, 50.0f, 10000.0f);
+            CHECK(!humDetector.Process(frame.data(), kFrame));
+        }
+        CHECK(humDetector.GetLastZcr() < 0.003f);
+    }
+
+    void TestHangoverBridgesPauses()
+    {
+        VadConfig config;
+        config.hangoverMs = 200;
+        VoiceActivityDetector detector = MakeDetector(config);
+        VoiceSource voice{ 8000.0f };
+        std::vector<int16_t> frame(kFrame);
+        std::vector<int16_t> silence(kFrame, 0);
+
+        for (int i = 0; i < 10; ++i) {
+            voice.Fill(frame);
+            detector.Process(frame.data(), kFrame);
+        }
+        CHECK(detector.IsActive());
+
+        // A 150 ms pause between words keeps the gate open
+        for (int i = 0; i < 15; ++i) CHECK(detector.Process(silence.data(), kFrame));
+        voice.Fill(frame);
+        CHECK(detector.Process(frame.data(), kFrame));
+
+        // A longer one closes it right after the hangover
+        int openFrames = 0;
+        for (int i = 0; i < 40; ++i) {
+            if (detector.Process(silence.data(), kFrame)) ++openFrames;
+        }
+        CHECK(openFrames == 20);
+        CHECK(!detector.IsActive());
+    }
+
+    void TestQuietSpeechStaysClosed()
+    {
+        VoiceActivityDetector detector = MakeDetector();
+        VoiceSource voice{ 100.0f }; // about -53 dBFS RMS, under the -45 dB threshold
+        std::vector<int16_t> frame(kFrame);
+        for (int i = 0; i < 50; ++i) {
+            voice.Fill(frame);
+            CHECK(!detector.Process(frame.data(), kFrame));
+        }
+        CHECK(detector.GetLastEnergyDb() < -45.0f);
+    }
+
+    void TestSteadyBackgroundIsLearned()
+    {
+        // Low threshold so a steady in-band whine initially counts as speech
+        VadConfig config;
+        config.thresholdDb = -70.0f;
+        VoiceActivityDetector detector = MakeDetector(config);
+        std::vector<int16_t> frame(kFrame);
+        int position = 0;
+
+        for (int i = 0; i < 300; ++i) {
+            FillSine(frame, position, 400.0f, 300.0f); // about -44 dBFS RMS
+            detector.Process(frame.data(), kFrame);
+        }
+        CHECK(detector.IsActive());
+
+        // The floor creeps up until the whine sits within the margin and the gate lets go
+        for (int i = 0; i < 2000; ++i) {
+            FillSine(frame, position, 400.0f, 300.0f);
+            detector.Process(frame.data(), kFrame);
+        }
+        CHECK(!detector.IsActive());
+        CHECK(std::fabs(detector.GetNoiseFloorDb() - detector.GetLastEnergyDb()) < 1.0f);
+
+        // Talking over it still opens the gate
+        VoiceSource voice{ 8000.0f };
+        for (int i = 0; i < 3; ++i) {
+            voice.Fill(frame);
+            detector.Process(frame.data(), kFrame);
+        }
+        CHECK(detector.IsActive());
+    }
+}
+
+int main()
+{
+    std::printf("DSP kernels: %s\n", DspIsaName(DetectDspIsa()));
+
+    TestZeroCrossingKernelsMatchScalar();
+    TestSpeechOpensAfterAttack();
+    TestClicksAreIgnored();
+    TestHissAndHumAreRejected();
+    TestHangoverBridgesPauses();
+    TestQuietSpeechStaysClosed();
+    TestSteadyBackgroundIsLearned();
+
+    if (g_failures == 0) std::printf("VoiceActivityDetectorTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Tests for the per-uid volume table, driven through Collect directly: the change threshold, the
+// staleness clock (one "level 0" before a slot is freed), tombstones reused once all 64 slots
+// were taken and the overflow count past that, ReadLevels per channel, the channel limit and the
+// reporter thread handing deltas to its sink.
+//
+//   cmake -S .. -B build && cmake --build build && ./build/VolumeMeterTests
+#include "../VolumeMeter.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace winrt::FinalProject::implementation;
+
+namespace
+{
+    int g_failures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::printf("FAILED %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures; \
+        } \
+    } while (0)
+
+    // The level Collect sent for uid on channel, or -1 when it sent none
+    int Sent(const VolumeUpdate& update, uint8_t channel, uint32_t uid)
+    {
+        for (const auto& change : update.levels) {
+            if (change.channel == channel && change.uid == uid) return change.level;
+        }
+        return -1;
+    }
+
+    VolumeUpdate Collected(VolumeMeter& meter)
+    {
+        VolumeUpdate update;
+        meter.Collect(update);
+        return update;
+    }
+
+    void TestChangeThreshold()
+    {
+        VolumeMeter meter;
+        meter.RegisterChannel("fire");
+
+        meter.Report(0, 5, 100);
+        VolumeUpdate update = Collected(meter);
+        CHECK(update.levels.size() == 1 && Sent(update, 0, 5) == 100);
+        CHECK((update.channels == std::vector<std::string>{ "fire" }));
+
+        // Below kChangeThreshold: nothing to send
+        meter.Report(0, 5, static_cast<uint8_t>(100 + VolumeMeter::kChangeThreshold - 1));
+        CHECK(Collected(meter).Empty());
+        meter.Report(0, 5, static_cast<uint8_t>(100 - VolumeMeter::kChangeThreshold + 1));
+        CHECK(Collected(meter).Empty());
+
+        // At the threshold, measured from what was last sent
+        meter.Report(0, 5, static_cast<uint8_t>(100 + VolumeMeter::kChangeThreshold));
+        CHECK(Sent(Collected(meter), 0, 5) == 100 + VolumeMeter::kChangeThreshold);
+
+        // Going silent and coming back always count, however small the step
+        meter.Report(0, 5, 0);
+        CHECK(Sent(Collected(meter), 0, 5) == 0);
+        meter.Report(0, 5, 3);
+        CHECK(Sent(Collected(meter), 0, 5) == 3);
+
+        // An empty delta carries no channel names
+        meter.Report(0, 5, 4);
+        update = Collected(meter);
+        CHECK(update.Empty() && update.channels.empty());
+    }
+
+    void TestStaleSpeakerTurnsOffOnce()
+    {
+        VolumeMeter meter;
+        meter.Report(0, 9, 80);
+        CHECK(Sent(Collected(meter), 0, 9) == 80);
+
+        VolumeChange levels[4];
+        for (uint32_t tick = 1; tick < VolumeMeter::kStaleTicks; ++tick) {
+            CHECK(Collected(meter).Empty());
+            CHECK(meter.ReadLevels(0, levels, 4) == 1 && levels[0].uid == 9 && levels[0].level == 80);
+        }
+
+        // kStaleTicks intervals without a report: one "level 0", and the slot is free
+        VolumeUpdate update = Collected(meter);
+        CHECK(update.levels.size() == 1 && Sent(update, 0, 9) == 0);
+        CHECK(meter.ReadLevels(0, levels, 4) == 0);
+        CHECK(Collected(meter).Empty());
+
+        // Back again: a fresh entry, sent like the first time
+        meter.Report(0, 9, 60);
+        CHECK(Sent(Collected(meter), 0, 9) == 60);
+
+        // A uid last sent as silent goes stale without another "level 0"
+        meter.Report(0, 11, 0);
+        meter.Report(0, 9, 0);
+        update = Collected(meter);
+        CHECK(Sent(update, 0, 11) == -1 && Sent(update, 0, 9) == 0);
+        for (uint32_t tick = 0; tick <= VolumeMeter::kStaleTicks; ++tick) {
+            CHECK(Collected(meter).Empty());
+        }
+    }
+
+    void TestTombstonesAreReusedAndOverflowCounted()
+    {
+        VolumeMeter meter;
+        for (uint32_t uid = 1; uid <= VolumeMeter::kSlots; ++uid) meter.Report(0, uid, 50);
+        CHECK(meter.GetOverflowCount() == 0);
+        CHECK(Collected(meter).levels.size() == VolumeMeter::kSlots);
+
+        // Every slot taken: one more uid has nowhere to go, the ones present still update
+        meter.Report(0, 1000, 50);
+        CHECK(meter.GetOverflowCount() == 1);
+        meter.Report(0, 1, 200);
+        CHECK(meter.GetOverflowCount() == 1);
+
+        // All of them go stale; the tombstones take a whole new set without overflowing
+        for (uint32_t tick = 0; tick <= VolumeMeter::kStaleTicks; ++tick) Collected(meter);
+        std::vector<VolumeChange> levels(VolumeMeter::kSlots + 8);
+        CHECK(meter.ReadLevels(0, levels.data(), levels.size()) == 0);
+
+        for (uint32_t uid = 5000; uid < 5000 + VolumeMeter::kSlots; ++uid) meter.Report(0, uid, 90);
+        CHECK(meter.GetOverflowCount() == 1);
+        CHECK(meter.ReadLevels(0, levels.data(), levels.size()) == VolumeMeter::kSlots);
+        VolumeUpdate update = Collected(meter);
+        CHECK(update.levels.size() == VolumeMeter::kSlots);
+        CHECK(std::all_of(update.levels.begin(), update.levels.end(),
+                          [](const VolumeChange& change) { return change.uid >= 5000 && change.level == 90; }));
+
+        // Reset forgets everything; a report after it is new again
+        meter.Reset();
+        CHECK(meter.ReadLevels(0, levels.data(), levels.size()) == 0);
+        meter.Report(0, 5000, 90);
+        CHECK(Sent(Collected(meter), 0, 5000) == 90);
+    }
+
+    void TestReadLevelsPerChannel()
+    {
+        VolumeMeter meter;
+        meter.Report(0, 5, 10);
+        meter.Report(1, 5, 20);
+        meter.Report(1, 6, 30);
+        meter.Report(1, 0, 40); // the local user
+
+        VolumeChange levels[8];
+        CHECK(meter.ReadLevels(0, levels, 8) == 1 && levels[0].uid == 5 && levels[0].level == 10);
+        size_t count = meter.ReadLevels(1, levels, 8);
+        CHECK(count == 3);
+        int sum = 0;
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(levels[i].channel == 1);
+            sum += levels[i].level;
+        }
+        CHECK(sum == 90);
+
+        // Capacity, unknown channels and a missing buffer
+        CHECK(meter.ReadLevels(1, levels, 2) == 2);
+        CHECK(meter.ReadLevels(2, levels, 8) == 0);
+        CHECK(meter.ReadLevels(VolumeMeter::kMaxChannels, levels, 8) == 0);
+        CHECK(meter.ReadLevels(1, nullptr, 8) == 0);
+
+        // Reports for channels past the limit are ignored
+        meter.Report(VolumeMeter::kMaxChannels, 5, 100);
+        meter.ReportActiveSpeaker(VolumeMeter::kMaxChannels, 5);
+        CHECK(Collected(meter).levels.size() == 4);
+    }
+
+    void TestChannelLimitAndActiveSpeakers()
+    {
+        VolumeMeter meter;
+        for (size_t i = 0; i < VolumeMeter::kMaxChannels; ++i) {
+            CHECK(meter.RegisterChannel("radio" + std::to_string(i)) == i);
+        }
+        CHECK(meter.RegisterChannel("radio3") == 3);
+        CHECK(meter.RegisterChannel("one too many") == VolumeMeter::kNoChannel);
+        CHECK(meter.FindChannel("radio15") == 15);
+        CHECK(meter.FindChannel("one too many") == VolumeMeter::kNoChannel);
+
+        // Active speaker changes are sent once each
+        meter.ReportActiveSpeaker(2, 7);
+        VolumeUpdate update = Collected(meter);
+        CHECK(update.activeSpeakers.size() == 1 && update.activeSpeakers[0].channel == 2 && update.activeSpeakers[0].uid == 7);
+        CHECK(update.channels.size() == VolumeMeter::kMaxChannels && update.channels[2] == "radio2");
+        meter.ReportActiveSpeaker(2, 7);
+        CHECK(Collected(meter).Empty());
+        meter.ReportActiveSpeaker(2, 8);
+        CHECK(Collected(meter).activeSpeakers.size() == 1);
+    }
+
+    void TestReporterSendsDeltas()
+    {
+        VolumeMeter meter;
+        meter.RegisterChannel("ops");
+        std::atomic<int> updates{ 0 };
+        std::atomic<int> level{ -1 };
+        meter.Start(10, [&](const VolumeUpdate& update) {
+            int sent = Sent(update, 0, 5);
+            if (sent >= 0) level = sent;
+            ++updates;
+        });
+        CHECK(meter.IsRunning());
+
+        meter.Report(0, 5, 120);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (level.load() != 120 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        CHECK(level.load() == 120);
+
+        // Quiet table: the sink is not called with empty deltas (the stale "level 0" is one more)
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        meter.Stop();
+        CHECK(!meter.IsRunning());
+        CHECK(updates.load() == 2 && level.load() == 0);
+    }
+}
+
+int main()
+{
+    TestChangeThreshold();
+    TestStaleSpeakerTurnsOffOnce();
+    TestTombstonesAreReusedAndOverflowCounted();
+    TestReadLevelsPerChannel();
+    TestChannelLimitAndActiveSpeakers();
+    TestReporterSendsDeltas();
+
+    if (g_failures == 0) std::printf("VolumeMeterTests: all passed\n");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 
 #include "AutolinkedNativeModules.g.h"
 #include "ReactPackageProvider.h"
+#include "AgoraModule/AgoraModule.h"
 
 using namespace winrt;
 using namespace xaml;
@@ -13,6 +14,9 @@ using namespace xaml::Navigation;
 using namespace Windows::ApplicationModel;
 namespace winrt::FinalProject::implementation
 {
+// Same app id VoiceContext.js initializes with; a matching InitializeAgoraEngine is then a no-op
+static constexpr char kAgoraAppId[] = "e5631d55e8a24b08b067bb73f8797fe3";
+
 /// <summary>
 /// Initializes the singleton application object.  This is the first line of
 /// authored code executed, and as such is the logical equivalent of main() or
@@ -40,6 +44,9 @@ App::App() noexcept
 
     PackageProviders().Append(make<ReactPackageProvider>()); // Includes all modules in this project
 
+    // Warm start: create and configure the RTC engine on the Agora worker while the JS bundle loads
+    AgoraManager::GetInstance()->WarmStart(kAgoraAppId);
+
     InitializeComponent();
 }
 